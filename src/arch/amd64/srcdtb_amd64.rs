@@ -25,6 +25,12 @@ static mut IDT: x86_64::structures::idt::InterruptDescriptorTable =
  use spin::Mutex;
  static WRITER: Mutex<Option<SerialPort>> = Mutex::new(None); // Örnek Seri Port çıktısı
 
+extern "C" {
+    fn x86_64_cpu_set_id(cpu: u32); // srctask_amd64.rs
+    fn low_level_ipi_init(); // srcinterrupt_amd64.rs
+    fn x86_64_power_init(); // srctask_amd64.rs
+}
+
 // --- Kernel Giriş Noktası ---
 // Önyükleyici (bootloader) tarafından çağrılan ana fonksiyon
 // Genellikle 'C' ABI'si kullanılır ve isim düzenlemesi yapılmaz.
@@ -33,6 +39,8 @@ pub extern "C" fn kernel_main(boot_info: *const ()) -> ! { // 'boot_info' önyü
     // --- 1. Başlangıç Güvenlik ve Kurulum ---
     // Donanım kesmelerini devre dışı bırak (kurulum sırasında rahatsız edilmemek için)
     x86_64::instructions::interrupts::disable();
+    // Önyükleme CPU'su mantıksal CPU 0'dır (low_level_cpu_id, srctask_amd64.rs)
+    unsafe { x86_64_cpu_set_id(0) };
 
     // TODO: Temel bellek yönetimi kurulumu
     // - Boot_info'dan bellek haritasını oku
@@ -46,6 +54,11 @@ pub extern "C" fn kernel_main(boot_info: *const ()) -> ! { // 'boot_info' önyü
 
     // --- 2. Kesme Sistemi ve Hata İşleyicileri Kurulumu ---
     init_idt(); // IDT'yi kur
+    // Ortak IDT'yi (zamanlayıcı, MSI ve IPI vektörleri; srcinterrupt_amd64.rs) yükler ve yerel APIC'i açar.
+    // İkincil CPU'lar aynı çağrıyı kendi açılış yollarında yapar.
+    unsafe { low_level_ipi_init() };
+    // HWP ve MWAIT boşta durumları (karnal_init'teki DVFS düzenleyicisinden önce)
+    unsafe { x86_64_power_init() };
 
     // TODO: PIC (Programmable Interrupt Controller) veya APIC (Advanced PIC) başlatma
     // Eğer PIC kullanılıyorsa, kesmeleri yeniden eşle (remap) ve devre dışı bırak/maskele
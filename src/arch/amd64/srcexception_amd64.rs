@@ -180,20 +180,10 @@ pub extern "C" fn common_interrupt_handler(stack_frame: InterruptStackFrame, vec
     match vector {
         PAGE_FAULT_VECTOR => {
             // Hata kodu ve Faulting Virtual Address (CR2 yazmacında) gereklidir.
-            // let cr2: u64 = unsafe { core::arch::x86_64::_read_cr2() }; // CR2 okuma
+            let cr2: u64 = unsafe { core::arch::x86_64::_read_cr2() }; // CR2 okuma
             let error_code = maybe_error_code.expect("Page Fault should have an error code");
-            // handle_page_fault(stack_frame, error_code, cr2);
-            klog::error!("PAGE FAULT: addr={:#x}, code={:#x}, RIP={:#x}",
-                        unsafe { core::arch::x86_64::_read_cr2() }, error_code, stack_frame.instruction_pointer);
-            // Bellek yöneticisine danış, sayfayı eşle veya hatayı işle.
-            // match kmemory::handle_page_fault(unsafe { core::arch::x86_64::_read_cr2() }, error_code) {
-                 Ok(_) => { /* Başarılı şekilde sayfa eşlendi, devam et */ }
-                 Err(_) => { /* Kritik hata, görevi sonlandır veya panik yap */
-                            // ktask::terminate_current_task(KError::BadAddress); // Kavramsal
-                             kkernel::panic("Page Fault: Cannot handle"); // Kavramsal
-                         }
-             }
-             kkernel::panic("PAGE FAULT - UNHANDLED"); // Yer Tutucu Panik
+            // Tembel/COW sayfaları çözülürse döner; çözülemezse görev sonlanır veya panik
+            handle_page_fault(&stack_frame, error_code, cr2);
         }
         GENERAL_PROTECTION_FAULT_VECTOR => {
              let error_code = maybe_error_code.expect("General Protection Fault should have an error code");
@@ -271,29 +261,31 @@ pub extern "C" fn common_interrupt_handler(stack_frame: InterruptStackFrame, vec
 /// Page Fault işleyicisinin yüksek seviye mantığı.
 #[allow(unused_variables)]
 fn handle_page_fault(stack_frame: &InterruptStackFrame, error_code: u64, faulting_address: u64) {
+    // Tembel sıfır doldurma ve yazmada kopyalama (srcpager.rs): kullanıcı yarısındaki haritalanmamış
+    // sayfalar ve paylaşılan salt okunur sayfalara yazmalar burada çözülür; dönüşte CPU erişimi yeniden dener.
+    // Çekirdek modundaki hatalar da (kullanıcı tamponuna kopyalama) aynı yoldan çözülür.
+    crate::ktrace::record(crate::ktrace::EV_PAGE_FAULT, faulting_address, error_code);
+    let pf_error = PageFaultErrorCode(error_code);
+    let error = match kmemory::handle_page_fault(faulting_address, error_code) {
+        Ok(()) => return,
+        Err(e) => e,
+    };
+    if pf_error.user() {
+        // Bölge dışı adres veya izin hatası: yalnızca görev sonlanır
+        ktask::terminate_current_task(error);
+        return;
+    }
+
     klog::error!("PAGE FAULT [{:#x}] at {:#x} during access from {:#x}",
                 error_code, faulting_address, stack_frame.instruction_pointer);
 
     use PageFaultErrorCode; // Tanımlanacak bir enum varsayımı
 
-    let pf_error = PageFaultErrorCode(error_code);
-
     klog::error!("Error Code Flags: Present={}, Write={}, User={}, Reserved={}",
                 pf_error.present(), pf_error.write(), pf_error.user(), pf_error.reserved());
     // Daha fazla bayrak olabilir (Instruction Fetch, Protection Key, SGX)
 
-    // Örnek Mantık:
-    // 1. Hatanın türünü belirle (sayfa yok, izin hatası vb.)
-    // 2. Faulting Address (CR2) hangi bellek bölgesinde? (Kernel, User, Heap, Stack, Mapped File vb.)
-    // 3. Eğer sayfa yoksa ve bu adres geçerli bir sanal bellek bölgesindeyse:
-    //    - kmemory::handle_page_fault(faulting_address, error_code) çağrısı yap.
-    //    - Bellek yöneticisi, fiziksel bir sayfa bulup eşlemeyi deneyebilir.
-    //    - Başarılı olursa fonksiyondan normal dönülür, CPU eşlenen sayfaya erişmeyi tekrar dener.
-    // 4. Eğer sayfa yoksa ve adres geçersizse veya izin hatasıysa:
-    //    - Bu genellikle ölümcül bir hata. İlgili görevi sonlandır.
-        ktask::terminate_current_task(KError::BadAddress); // Kavramsal
-
-    // Yer Tutucu: Şimdilik sadece panik yapıyoruz.
+    // Çekirdek kendi adres alanında çözülemeyen bir hataya düştü: kurtarılamaz.
     kkernel::panic("UNHANDLED PAGE FAULT");
 }
 
@@ -501,6 +493,7 @@ pub fn init() {
         IDT[DIVIDE_ERROR_VECTOR as usize].set_handler_fn(divide_error_handler as u64, KERNEL_CODE_SELECTOR, None);
         IDT[BREAKPOINT_VECTOR as usize].set_handler_fn(breakpoint_handler as u64, KERNEL_CODE_SELECTOR, None);
         IDT[INVALID_OPCODE_VECTOR as usize].set_handler_fn(invalid_opcode_handler as u64, KERNEL_CODE_SELECTOR, None);
+        IDT[DEVICE_NOT_AVAILABLE_VECTOR as usize].set_handler_fn(device_not_available_handler as u64, KERNEL_CODE_SELECTOR, None);
         IDT[GENERAL_PROTECTION_FAULT_VECTOR as usize].set_handler_fn(gp_fault_handler as u64, KERNEL_CODE_SELECTOR, None);
         IDT[PAGE_FAULT_VECTOR as usize].set_handler_fn(page_fault_handler as u64, KERNEL_CODE_SELECTOR, None);
 
@@ -564,6 +557,15 @@ extern "x86-interrupt" fn invalid_opcode_handler(stack_frame: InterruptStackFram
      kkernel::panic("Invalid Opcode");
 }
 
+// CR0.TS açıkken ilk x87/SSE/AVX komutu: tembel FPU (srcsched.rs) durumu yükleyip TS'i temizler,
+// dönüşte komut yeniden çalışır.
+extern "x86-interrupt" fn device_not_available_handler(_stack_frame: InterruptStackFrame) {
+    extern "C" {
+        fn ksched_fpu_trap();
+    }
+    unsafe { ksched_fpu_trap() };
+}
+
 extern "x86-interrupt" fn gp_fault_handler(stack_frame: InterruptStackFrame, error_code: u64) {
     handle_gp_fault(&stack_frame, error_code); // Yüksek seviye handler'ı çağır
 }
@@ -662,11 +664,18 @@ mod kkernel {
 #[allow(dead_code)]
 mod kmemory {
      use super::*; // karnal64.rs scope'undaki tipleri kullan
-     // Kavramsal sayfa hatası işleyici
+     extern "C" {
+         // srcmmu_amd64.rs: pager ile tembel/COW sayfa hatası çözümü (0 başarı, negatif KError)
+         fn x86_handle_user_page_fault(fault_addr: u64, error_code: u64) -> i64;
+     }
+
      pub fn handle_page_fault(address: u64, error_code: u64) -> Result<(), KError> {
-         klog::debug!("kmemory::handle_page_fault(addr={:#x}, code={:#x}) - Placeholder", address, error_code);
-         // Gerçek implementasyon: sayfa tablosunu kontrol et, yeni sayfa ayır/eşle vb.
-         Err(KError::BadAddress) // Şimdilik başarısız olduğunu varsayalım
+         match unsafe { x86_handle_user_page_fault(address, error_code) } {
+             0 => Ok(()),
+             -1 => Err(KError::PermissionDenied),
+             -12 => Err(KError::OutOfMemory),
+             _ => Err(KError::BadAddress),
+         }
      }
 }
 
@@ -1,6 +1,8 @@
 use x86_64::structures::idt::{InterruptDescriptorTable, InterruptStackFrame, PageFaultErrorCode};
+use x86_64::instructions::port::Port;
 use lazy_static::lazy_static;
 use spin::Mutex;
+use core::sync::atomic::{AtomicBool, AtomicU32, Ordering};
 
 // Karnal64 çekirdek API'sını ve diğer modülleri dışarıdan import ediyoruz.
 // Bu modüllerin src/ dizininde veya başka bir yerde tanımlı olduğunu varsayıyoruz.
@@ -24,6 +26,51 @@ const PIC_2_OFFSET: u8 = PIC_1_OFFSET + 8;
 // Kullanacağımız sistem çağrısı kesme numarası (genel bir seçenektir)
 const SYSCALL_INT_VECTOR: u8 = 0x80; // Vektör 128
 
+// MSI/MSI-X için ayrılan vektörler (0x30-0xEF). 0x80 sistem çağrısına ayrıldığından aralık dışında tutulur.
+// amd64'te çekirdeğe verilen mantıksal kesme numarası IDT vektörünün kendisidir (bkz. srcirq.rs).
+const MSI_FIRST_VECTOR: u32 = 0x30;
+const MSI_VECTOR_COUNT: u32 = 0xF0 - 0x30;
+
+// Yerel APIC MMIO penceresi (önyükleme haritasında kimlik eşlemeli varsayılır)
+const LAPIC_BASE: u64 = 0xFEE0_0000;
+const LAPIC_ID: u64 = LAPIC_BASE + 0x20;
+const LAPIC_EOI: u64 = LAPIC_BASE + 0xB0;
+const LAPIC_SVR: u64 = LAPIC_BASE + 0xF0;      // Sahte kesme vektörü ve APIC yazılım etkinleştirme (bit 8)
+const LAPIC_LVT_TIMER: u64 = LAPIC_BASE + 0x320; // Zamanlayıcı kipi (bit 18:17), maske (bit 16), vektör
+const LVT_TIMER_TSC_DEADLINE: u32 = 0b10 << 17;
+const LVT_MASKED: u32 = 1 << 16;
+const LAPIC_ICR_LOW: u64 = LAPIC_BASE + 0x300;  // Yazılması IPI'ı gönderir
+const LAPIC_ICR_HIGH: u64 = LAPIC_BASE + 0x310; // Hedef APIC ID (bit 31:24)
+const ICR_DELIVERY_PENDING: u32 = 1 << 12;
+const ICR_LEVEL_ASSERT: u32 = 1 << 14;          // Sabit teslim, fiziksel hedef, kenar tetiklemeli
+
+// İşlemciler arası kesme vektörleri: MSI aralığının (0x30-0xEF) üstünde, sahte vektörün altında
+const TLB_SHOOTDOWN_VECTOR: u8 = 0xF0;
+const RESCHEDULE_VECTOR: u8 = 0xF1;
+const PERFORMANCE_VECTOR: u8 = 0xF2; // HWP seviye isteği (srctask_amd64.rs)
+const SPURIOUS_VECTOR: u8 = 0xFF;
+
+const MAX_CPUS: usize = 32; // ksched::MAX_CPUS
+const NO_APIC_ID: u32 = u32::MAX;
+// MSI adres biçimi: 0xFEE0_0000 | (hedef APIC ID << 12); veri: vektör (kenar tetiklemeli, sabit teslim)
+const MSI_ADDRESS_BASE: u64 = 0xFEE0_0000;
+
+// Eski ISA IRQ hatları IOAPIC'ten PIC vektör aralığına (32-47) yönlendirilir: vektör = PIC_1_OFFSET + hat.
+// ISA -> GSI geçersiz kılmaları (MADT) yok varsayılır. IOAPIC kimlik eşlemeli varsayılır.
+const IOAPIC_BASE: u64 = 0xFEC0_0000; // IOREGSEL; IOWIN = +0x10
+const IOAPIC_REDTBL: u32 = 0x10;      // Giriş n: 0x10 + 2n (vektör, maske bit 16), 0x11 + 2n (hedef APIC ID bit 31:24)
+const IOAPIC_MASKED: u32 = 1 << 16;
+const ISA_IRQ_COUNT: u32 = 16;
+
+// Çekirdek konsolu: COM1 (16550A), ISA IRQ4
+const COM1_PORT: u16 = 0x3F8;
+const UART_IER: u16 = 1; // bit 1: verici boş kesmesi (ETBEI)
+const UART_MCR: u16 = 4; // bit 3: OUT2 (kesme hattını bağlar)
+const UART_LSR: u16 = 5; // bit 5: verici tutucu ve FIFO boş (THRE)
+const UART_FIFO_SIZE: u32 = 16;
+const COM1_ISA_IRQ: u32 = 4;
+const COM1_VECTOR: u8 = PIC_1_OFFSET + COM1_ISA_IRQ as u8;
+
 // --- Kesme Tanımlayıcı Tablosu (IDT) ---
 
 // IDT'yi statik olarak tanımlıyoruz ve erişimini Mutex ile koruyoruz.
@@ -34,6 +81,33 @@ lazy_static! {
 
 // --- Kesme İşleyicileri (Handler) ---
 
+// x86-interrupt girişleri swapgs yapmaz. Ring 3'ten gelinen her işleyici ilk iş KernelGs::enter ile GS
+// tabanını çekirdeğin CPU alanına çevirir ve dönüşte (değer düşürülünce, iretq'dan önce) kullanıcı tabanını
+// geri takar. Böylece iş parçacığı hangi yoldan girmiş olursa olsun çekirdekteyken GS tutarlıdır; işleyici
+// içinde başka bir iş parçacığına geçilip o iş parçacığının SYSCALL yolundan dönülmesi de GS'yi bozmaz
+// (bkz. srctask_amd64.rs).
+struct KernelGs(bool);
+
+impl KernelGs {
+    #[inline(always)]
+    fn enter(stack_frame: &InterruptStackFrame) -> Self {
+        let from_user = stack_frame.code_segment & 3 == 3;
+        if from_user {
+            unsafe { core::arch::asm!("swapgs", options(nomem, nostack, preserves_flags)) };
+        }
+        KernelGs(from_user)
+    }
+}
+
+impl Drop for KernelGs {
+    #[inline(always)]
+    fn drop(&mut self) {
+        if self.0 {
+            unsafe { core::arch::asm!("swapgs", options(nomem, nostack, preserves_flags)) };
+        }
+    }
+}
+
 // Bu fonksiyonlar, assembly stubs (yardımcı montaj kodları) tarafından çağrılır.
 // Assembly stub'lar, kesme sırasında CPU'nun kaydettiği durumu (InterruptStackFrame) hazırlar,
 // ek bilgileri (hata kodu gibi) yığına koyar ve bu Rust fonksiyonlarını çağırır.
@@ -42,6 +116,7 @@ lazy_static! {
 // Assembly stubs için extern tanımlamalar.
 // Bu fonksiyonların gövdesi Rust'ta değil, assembly dilinde yazılacaktır.
 extern "x86-interrupt" fn exception_handler(stack_frame: InterruptStackFrame, vector: u8, error_code: Option<u64>) {
+    let _gs = KernelGs::enter(&stack_frame);
     // Genel istisna işleyicisi
     println!("KERNEL PANIC: EXCEPTION: {}! Error Code: {:?} Stack Frame: {:#?}", vector, error_code, stack_frame);
     // Gerçek bir çekirdekte burada hata ayıklama bilgileri loglanır veya bir çökme ekranı gösterilir.
@@ -49,26 +124,25 @@ extern "x86-interrupt" fn exception_handler(stack_frame: InterruptStackFrame, ve
     loop { x86_64::instructions::hlt(); }
 }
 
-extern "x86-interrupt" fn timer_interrupt_handler(_stack_frame: InterruptStackFrame) {
-    // Zamanlayıcı kesme işleyicisi (IRQ0 / Vektör 32)
-    // Bu kesme, işletim sisteminin zamanlayıcısı (scheduler) tarafından kullanılır.
-    // Genellikle bir görev değişimi (context switch) burada tetiklenir.
+extern "x86-interrupt" fn timer_interrupt_handler(stack_frame: InterruptStackFrame) {
+    let _gs = KernelGs::enter(&stack_frame);
+    // Zamanlayıcı kesme işleyicisi (yerel APIC TSC-deadline / Vektör 32)
+    // Periyodik tik yoktur: kesme yalnızca çekirdeğin kurduğu bir sonraki son tarihte gelir.
+    // ktimer_interrupt dolan uykuları uyandırır, zaman dilimini denetler ve zamanlayıcıyı yeniden kurar.
+    crate::ktimer::ktimer_interrupt();
 
-    // TODO: Karnal64'ün görev yöneticisini (ktask) çağırarak zamanlayıcıyı çalıştır.
-     ktask::schedule();
+    // Yerel APIC'e kesmenin işlendiğini bildir (TSC-deadline kesmesi PIC'ten gelmez).
+    // Onay geçişten önce yazılır: yeni iş parçacığı bu CPU'nun sonraki zamanlayıcı kesmesini kaçırmamalı.
+    unsafe { core::ptr::write_volatile(LAPIC_EOI as *mut u32, 0) };
 
-    // PIC'e (Programlanabilir Kesme Denetleyicisi) sinyal gönder: Kesmeyi işledik.
-    // Bu, PIC'in aynı kesmeyi tekrar göndermesini engeller.
-    // Bu PIC yönetimi src/pic.rs gibi ayrı bir modülde olabilir.
-    unsafe {
-         pic::notify_end_of_interrupt(PIC_1_OFFSET); // PIC1'den geldi
-         // Yer tutucu PIC sinyali
-        print!("."); // Zamanlayıcının çalıştığını göstermek için basit bir çıktı
+    // Zaman dilimi dolduysa kullanıcı moduna dönüşte iş parçacığı değiştirilir (CS.RPL = 3: ring 3'ten gelindi).
+    if stack_frame.code_segment & 3 == 3 {
+        crate::ksched::ksched_preempt_point();
     }
-    // Zamanlayıcı kesmesi oldukça sık gerçekleşebilir, dikkatli loglama yapılmalı.
 }
 
-extern "x86-interrupt" fn keyboard_interrupt_handler(_stack_frame: InterruptStackFrame) {
+extern "x86-interrupt" fn keyboard_interrupt_handler(stack_frame: InterruptStackFrame) {
+    let _gs = KernelGs::enter(&stack_frame);
     // Klavye kesme işleyicisi (IRQ1 / Vektör 33)
     // Klavye denetleyicisinden gelen tuş basma/bırakma olaylarını işler.
 
@@ -84,6 +158,7 @@ extern "x86-interrupt" fn keyboard_interrupt_handler(_stack_frame: InterruptStac
 }
 
 extern "x86-interrupt" fn page_fault_handler(stack_frame: InterruptStackFrame, error_code: PageFaultErrorCode) {
+    let _gs = KernelGs::enter(&stack_frame);
     // Sayfa Hatası işleyicisi (Exception 14)
     // Bellek yönetiminde (virtüel bellek) önemli bir istisnadır.
     // Erişilmek istenen sayfa bellekte değilse, sayfa koruma ihlali olursa tetiklenir.
@@ -108,6 +183,7 @@ extern "x86-interrupt" fn page_fault_handler(stack_frame: InterruptStackFrame, e
 }
 
 extern "x86-interrupt" fn general_protection_fault_handler(stack_frame: InterruptStackFrame, error_code: u64) {
+    let _gs = KernelGs::enter(&stack_frame);
     // Genel Koruma Hatası işleyicisi (Exception 13)
     // Segmentasyon ihlalleri, yetkisiz bellek erişimleri, geçersiz komutlar gibi birçok hatada tetiklenir.
 
@@ -123,12 +199,451 @@ extern "x86-interrupt" fn general_protection_fault_handler(stack_frame: Interrup
 }
 
 
+// --- Genel Kesme Vektörleri (MSI/MSI-X) ---
+
+// Her vektör için ayrı bir giriş: x86-interrupt çağrı kuralı vektör numarasını vermediğinden numara
+// const parametre olarak gömülür. İşin kendisi çekirdeğin genel dağıtıcısındadır.
+extern "x86-interrupt" fn vector_stub<const V: u8>(stack_frame: InterruptStackFrame) {
+    let _gs = KernelGs::enter(&stack_frame);
+    crate::kirq::kirq_dispatch(V as u32);
+    // MSI kesmeleri her zaman yerel APIC'e gelir; onay yerel APIC'e yazılır.
+    unsafe { core::ptr::write_volatile(LAPIC_EOI as *mut u32, 0) };
+}
+
+// IDT girişlerini 16'lık satırlar halinde kurar: satır `hi`, vektörler hi*16 .. hi*16+15
+macro_rules! set_vector_stubs {
+    ($idt:ident; $($hi:literal),*) => {
+        $( set_vector_stubs!(@row $idt, $hi, 0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15); )*
+    };
+    (@row $idt:ident, $hi:literal, $($lo:literal)*) => {
+        $( if $hi * 16 + $lo != SYSCALL_INT_VECTOR {
+            $idt[$hi * 16 + $lo].set_handler_fn(vector_stub::<{ $hi * 16 + $lo }>);
+        } )*
+    };
+}
+
+// --- İşlemciler Arası Kesmeler (IPI) ---
+
+extern "C" {
+    fn low_level_cpu_id() -> u32; // srctask_amd64.rs
+    fn x86_64_performance_apply(); // srctask_amd64.rs
+}
+
+// Mantıksal CPU -> yerel APIC ID. Her CPU low_level_ipi_init'te kendi girdisini yazar.
+static CPU_APIC_IDS: [AtomicU32; MAX_CPUS] = [const { AtomicU32::new(NO_APIC_ID) }; MAX_CPUS];
+// Ortak IDT ilk low_level_ipi_init'te (önyükleme CPU'su) kurulur; sonrakiler yalnızca yükler.
+static IDT_BUILT: AtomicBool = AtomicBool::new(false);
+
+extern "x86-interrupt" fn tlb_shootdown_ipi_handler(stack_frame: InterruptStackFrame) {
+    let _gs = KernelGs::enter(&stack_frame);
+    crate::ktlb::ktlb_handle_shootdown_ipi();
+    unsafe { core::ptr::write_volatile(LAPIC_EOI as *mut u32, 0) };
+}
+
+extern "x86-interrupt" fn reschedule_ipi_handler(stack_frame: InterruptStackFrame) {
+    let _gs = KernelGs::enter(&stack_frame);
+    crate::ksched::ksched_handle_reschedule_ipi();
+    // Onay geçişten önce yazılır: yeni iş parçacığı bu CPU'nun sonraki IPI'larını kaçırmamalı.
+    unsafe { core::ptr::write_volatile(LAPIC_EOI as *mut u32, 0) };
+    if stack_frame.code_segment & 3 == 3 {
+        crate::ksched::ksched_preempt_point();
+    }
+}
+
+extern "x86-interrupt" fn performance_ipi_handler(stack_frame: InterruptStackFrame) {
+    let _gs = KernelGs::enter(&stack_frame);
+    unsafe { x86_64_performance_apply() };
+    unsafe { core::ptr::write_volatile(LAPIC_EOI as *mut u32, 0) };
+}
+
+// ICR'ye iki yazmalık gönderim; aynı CPU'da araya bir kesme işleyicisinin IPI'ı girmemeli.
+fn send_ipi(cpu: u32, vector: u8) {
+    let apic_id = match CPU_APIC_IDS.get(cpu as usize) {
+        Some(id) => id.load(Ordering::Acquire),
+        None => return,
+    };
+    if apic_id == NO_APIC_ID {
+        return; // CPU henüz IPI almaya hazır değil
+    }
+    x86_64::instructions::interrupts::without_interrupts(|| unsafe {
+        while core::ptr::read_volatile(LAPIC_ICR_LOW as *const u32) & ICR_DELIVERY_PENDING != 0 {
+            core::hint::spin_loop();
+        }
+        core::ptr::write_volatile(LAPIC_ICR_HIGH as *mut u32, apic_id << 24);
+        core::ptr::write_volatile(LAPIC_ICR_LOW as *mut u32, vector as u32 | ICR_LEVEL_ASSERT);
+    });
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_ipi_init() {
+    if IDT_BUILT.swap(true, Ordering::AcqRel) {
+        unsafe { IDT.lock().load_unsafe() };
+    } else {
+        init_idt();
+        // IPI ve sahte kesme vektörleri kirq'e uğramaz; sürücüler bu numaraları kaydedemez
+        for vector in [TLB_SHOOTDOWN_VECTOR, RESCHEDULE_VECTOR, PERFORMANCE_VECTOR, SPURIOUS_VECTOR] {
+            let _ = crate::kirq::reserve(vector as u32);
+        }
+    }
+    unsafe {
+        // Yerel APIC'i yazılımla aç; sahte kesmeler SPURIOUS_VECTOR'e gelir (EOI gerektirmez).
+        core::ptr::write_volatile(LAPIC_SVR as *mut u32, (1 << 8) | SPURIOUS_VECTOR as u32);
+        // Zamanlayıcı TSC-deadline kipinde (vektör 32): kesme yalnızca low_level_timer_program'ın
+        // IA32_TSC_DEADLINE'a yazdığı anda gelir (srctime_amd64.rs). Kip yoksa LVT maskeli kalır.
+        let lvt = if core::arch::x86_64::__cpuid(1).ecx & (1 << 24) != 0 {
+            LVT_TIMER_TSC_DEADLINE | PIC_1_OFFSET as u32
+        } else {
+            println!("Karnal64: TSC-deadline zamanlayıcısı desteklenmiyor; CPU {} zamanlayıcısız", low_level_cpu_id());
+            LVT_MASKED | PIC_1_OFFSET as u32
+        };
+        core::ptr::write_volatile(LAPIC_LVT_TIMER as *mut u32, lvt);
+        // LVT yazması sonraki IA32_TSC_DEADLINE WRMSR'ından önce tamamlanmalı (SDM: MFENCE)
+        core::sync::atomic::fence(Ordering::SeqCst);
+        let apic_id = core::ptr::read_volatile(LAPIC_ID as *const u32) >> 24;
+        if let Some(slot) = CPU_APIC_IDS.get(low_level_cpu_id() as usize) {
+            slot.store(apic_id, Ordering::Release);
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_send_tlb_shootdown_ipi(cpu: u32) {
+    send_ipi(cpu, TLB_SHOOTDOWN_VECTOR);
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_send_reschedule_ipi(cpu: u32) {
+    send_ipi(cpu, RESCHEDULE_VECTOR);
+}
+
+#[no_mangle]
+pub extern "C" fn x86_64_send_performance_ipi(cpu: u32) {
+    send_ipi(cpu, PERFORMANCE_VECTOR);
+}
+
+// --- SMP Açılışı (INIT-SIPI-SIPI, hardware_specific.h) ---
+// CPU listesi (ACPI MADT) okunmadığından INIT ve SIPI "kendisi hariç hepsi" kısayoluyla yayınlanır. Uyanan her
+// AP aynı başlatma kodunu çalıştırır: parametre alanındaki sayaçtan atomik olarak sıra alır ve önyükleme
+// CPU'sunun hazırladığı yığıtlardan kendisininkine geçer; sırası yığıt sayısını aşan AP durur.
+// Kod 1MB altındaki AP_TRAMPOLINE'e kopyalanır (SIPI vektörü sayfa numarasıdır); bu sayfanın fiziksel bellek
+// ayırıcısına verilmediği ve önyükleme sayfa tablolarında kimlik eşlemeli olduğu varsayılır. AP gerçek kipten
+// önyükleme CPU'sunun CR0/CR4/EFER değerleriyle doğrudan uzun kipe geçer; CR4.PCIDE'yi low_level_mmu_cpu_init
+// açar. 16 bitlik kip CR3'ün yalnızca alt 32 bitini yükler: PML4 4GB altında olmalıdır.
+
+const AP_TRAMPOLINE: u64 = 0x8000;
+const AP_STACK_ORDER: u32 = 2; // 16KB
+const PAGE_SIZE: u64 = 4096;
+const ICR_INIT: u32 = 0b101 << 8;
+const ICR_STARTUP: u32 = 0b110 << 8;
+const ICR_ALL_EXCLUDING_SELF: u32 = 0b11 << 18;
+const IA32_EFER: u32 = 0xC000_0080;
+const EFER_LMA: u64 = 1 << 10; // Salt okunur
+const CR4_PCIDE: u64 = 1 << 17;
+
+// Başlatma kodunun parametre alanı (ap_tr_params; ofsetler aşağıdaki kodla EŞLEŞMELİDİR)
+#[repr(C)]
+struct ApBoot {
+    cr3: u64,    // 0
+    cr4: u64,    // 8
+    cr0: u64,    // 16
+    efer: u64,   // 24
+    entry: u64,  // 32: extern "C" fn(cpu: u32) -> !
+    next: u32,   // 40: sonraki AP'nin sırası
+    count: u32,  // 44: hazırlanan yığıt sayısı
+    stacks: [u64; MAX_CPUS], // 48: yığıt tepeleri
+}
+
+core::arch::global_asm!(
+    ".global ap_trampoline_start",
+    ".global ap_tr_params",
+    ".global ap_trampoline_end",
+    ".code16",
+    "ap_trampoline_start:",
+    "cli",
+    "cld",
+    // SIPI CS = AP_TRAMPOLINE >> 4, IP = 0: veri erişimleri koda göre
+    "mov %cs, %ax",
+    "mov %ax, %ds",
+    "lgdt (ap_tr_gdtr - ap_trampoline_start)",
+    "movl (ap_tr_params - ap_trampoline_start + 8), %eax",
+    "mov %eax, %cr4",
+    "movl (ap_tr_params - ap_trampoline_start), %eax",
+    "mov %eax, %cr3",
+    "mov $0xC0000080, %ecx",
+    "movl (ap_tr_params - ap_trampoline_start + 24), %eax",
+    "xor %edx, %edx",
+    "wrmsr",
+    "movl (ap_tr_params - ap_trampoline_start + 16), %eax",
+    "mov %eax, %cr0",
+    "ljmpl $0x08, ${base} + (ap_tr_long - ap_trampoline_start)",
+    ".code64",
+    "ap_tr_long:",
+    "mov $0x10, %ax",
+    "mov %ax, %ds",
+    "mov %ax, %es",
+    "mov %ax, %ss",
+    "xor %eax, %eax",
+    "mov %ax, %fs",
+    "mov %ax, %gs",
+    "mov ${base} + (ap_tr_params - ap_trampoline_start), %ebx",
+    "mov $1, %eax",
+    "lock xaddl %eax, 40(%rbx)",
+    "cmpl 44(%rbx), %eax",
+    "jae 2f",
+    "mov 48(%rbx, %rax, 8), %rsp",
+    "lea 1(%rax), %edi",
+    "call *32(%rbx)",
+    "2:",
+    "cli",
+    "hlt",
+    "jmp 2b",
+    // Geçici GDT: 0x08 64 bit kod, 0x10 veri (çekirdek GDT'siyle aynı seçiciler); low_level_syscall_init
+    // CPU'nun kendi GDT'sini yükler
+    ".balign 8",
+    "ap_tr_gdt:",
+    ".quad 0",
+    ".quad 0x00AF9A000000FFFF",
+    ".quad 0x00CF92000000FFFF",
+    "ap_tr_gdtr:",
+    ".word 23",
+    ".long {base} + (ap_tr_gdt - ap_trampoline_start)",
+    ".balign 8",
+    "ap_tr_params:",
+    ".space {params}",
+    "ap_trampoline_end:",
+    base = const AP_TRAMPOLINE,
+    params = const core::mem::size_of::<ApBoot>(),
+    options(att_syntax),
+);
+
+extern "C" {
+    static ap_trampoline_start: u8;
+    static ap_tr_params: u8;
+    static ap_trampoline_end: u8;
+    fn kmem_phys_alloc_frames(order: u32) -> u64;
+    fn x86_64_cpu_set_id(cpu: u32); // srctask_amd64.rs
+    fn karnal_secondary_start(cpu: u32) -> !;
+}
+
+// Başlatma kodunun uzun kipte çağırdığı giriş; yığıt ve adres alanı önyükleme CPU'sunun hazırladığıdır
+extern "C" fn ap_main(cpu: u32) -> ! {
+    unsafe {
+        x86_64_cpu_set_id(cpu);
+        karnal_secondary_start(cpu)
+    }
+}
+
+fn send_ipi_all(command: u32) {
+    unsafe {
+        while core::ptr::read_volatile(LAPIC_ICR_LOW as *const u32) & ICR_DELIVERY_PENDING != 0 {
+            core::hint::spin_loop();
+        }
+        core::ptr::write_volatile(LAPIC_ICR_LOW as *mut u32, command | ICR_ALL_EXCLUDING_SELF);
+    }
+}
+
+fn delay_us(us: u64) {
+    let end = crate::ktimer::now_ns() + us * 1000;
+    while crate::ktimer::now_ns() < end {
+        core::hint::spin_loop();
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_start_secondary_cpus() -> u32 {
+    use x86_64::registers::model_specific::Msr;
+    // CPUID.1:EBX[23:16] paketteki en fazla mantıksal işlemci sayısıdır (EDX.HTT yoksa 1)
+    let leaf1 = unsafe { core::arch::x86_64::__cpuid(1) };
+    let logical = if leaf1.edx & (1 << 28) != 0 { (leaf1.ebx >> 16) & 0xFF } else { 1 };
+    let wanted = logical.saturating_sub(1).min(MAX_CPUS as u32 - 1);
+    if wanted == 0 {
+        return 0;
+    }
+    let (cr0, cr3, cr4): (u64, u64, u64);
+    unsafe {
+        core::arch::asm!("mov {}, cr0", out(reg) cr0, options(nomem, nostack, preserves_flags));
+        core::arch::asm!("mov {}, cr3", out(reg) cr3, options(nomem, nostack, preserves_flags));
+        core::arch::asm!("mov {}, cr4", out(reg) cr4, options(nomem, nostack, preserves_flags));
+    }
+    // PCID açıkken CR3'ün alt 12 biti PCID'dir
+    let root = cr3 & !0xFFF & ((1 << 52) - 1);
+    if root >> 32 != 0 {
+        println!("Karnal64: PML4 4GB üstünde; ikincil CPU'lar açılmadı");
+        return 0;
+    }
+
+    unsafe {
+        let start = core::ptr::addr_of!(ap_trampoline_start) as u64;
+        let end = core::ptr::addr_of!(ap_trampoline_end) as u64;
+        let params_offset = core::ptr::addr_of!(ap_tr_params) as u64 - start;
+        core::ptr::copy_nonoverlapping(start as *const u8, AP_TRAMPOLINE as *mut u8, (end - start) as usize);
+        let params = &mut *((AP_TRAMPOLINE + params_offset) as *mut ApBoot);
+
+        let mut count = 0;
+        while count < wanted {
+            let stack = kmem_phys_alloc_frames(AP_STACK_ORDER);
+            if stack == 0 {
+                break;
+            }
+            params.stacks[count as usize] = stack + (PAGE_SIZE << AP_STACK_ORDER);
+            count += 1;
+        }
+        if count == 0 {
+            return 0;
+        }
+        params.cr3 = root;
+        params.cr4 = cr4 & !CR4_PCIDE;
+        params.cr0 = cr0;
+        params.efer = Msr::new(IA32_EFER).read() & !EFER_LMA;
+        params.entry = ap_main as usize as u64;
+        params.next = 0;
+        params.count = count;
+        // Parametreler AP'lerin başlatma kodundan önce görünür
+        core::sync::atomic::fence(Ordering::SeqCst);
+
+        // SDM: INIT, 10ms bekleme, iki SIPI (aralarında 200us)
+        send_ipi_all(ICR_INIT | ICR_LEVEL_ASSERT);
+        delay_us(10_000);
+        for _ in 0..2 {
+            send_ipi_all(ICR_STARTUP | (AP_TRAMPOLINE >> 12) as u32);
+            delay_us(200);
+        }
+        count
+    }
+}
+
+// --- Kesme Denetleyicisi Kancaları (hardware_specific.h) ---
+
+#[no_mangle]
+pub extern "C" fn low_level_irq_msi_range(first: *mut u32, count: *mut u32) {
+    unsafe {
+        *first = MSI_FIRST_VECTOR;
+        *count = MSI_VECTOR_COUNT;
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_msi_compose(irq: u32, cpu: u32, address: *mut u64, data: *mut u32) -> i64 {
+    if irq < MSI_FIRST_VECTOR || irq >= MSI_FIRST_VECTOR + MSI_VECTOR_COUNT || irq == SYSCALL_INT_VECTOR as u32 {
+        return -3; // KERROR_INVALID_ARGUMENT
+    }
+    // APIC ID'si henüz kaydedilmemiş CPU'lar için mantıksal numaraya eşit varsayılır.
+    let apic_id = match CPU_APIC_IDS.get(cpu as usize).map(|id| id.load(Ordering::Acquire)) {
+        Some(id) if id != NO_APIC_ID => id as u64 & 0xFF,
+        _ => cpu as u64 & 0xFF,
+    };
+    unsafe {
+        *address = MSI_ADDRESS_BASE | (apic_id << 12);
+        *data = irq;
+    }
+    0
+}
+
+// IOREGSEL/IOWIN çifti paylaşılır: erişimler kesmeler kapalıyken bu kilit altında yapılır.
+static IOAPIC_LOCK: Mutex<()> = Mutex::new(());
+
+unsafe fn ioapic_read(reg: u32) -> u32 {
+    core::ptr::write_volatile(IOAPIC_BASE as *mut u32, reg);
+    core::ptr::read_volatile((IOAPIC_BASE + 0x10) as *const u32)
+}
+
+unsafe fn ioapic_write(reg: u32, value: u32) {
+    core::ptr::write_volatile(IOAPIC_BASE as *mut u32, reg);
+    core::ptr::write_volatile((IOAPIC_BASE + 0x10) as *mut u32, value);
+}
+
+// Eski IRQ vektörünün IOAPIC girişi (32-47 dışı numaralar None)
+fn isa_line(irq: u32) -> Option<u32> {
+    irq.checked_sub(PIC_1_OFFSET as u32).filter(|&line| line < ISA_IRQ_COUNT)
+}
+
+fn ioapic_set_masked(line: u32, masked: bool) {
+    let reg = IOAPIC_REDTBL + 2 * line;
+    x86_64::instructions::interrupts::without_interrupts(|| {
+        let _guard = IOAPIC_LOCK.lock();
+        unsafe {
+            let low = ioapic_read(reg);
+            ioapic_write(reg, if masked { low | IOAPIC_MASKED } else { low & !IOAPIC_MASKED });
+        }
+    });
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_irq_mask(irq: u32) {
+    // MSI vektörleri yerel APIC'te maskelenemez; cihaz tarafı maskesi sürücünün işidir. Tembel
+    // maskeleme sayesinde gelen kesme çekirdekte bekletilir. Eski IRQ hatları IOAPIC'te maskelenir.
+    if let Some(line) = isa_line(irq) {
+        ioapic_set_masked(line, true);
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_irq_unmask(irq: u32) {
+    if let Some(line) = isa_line(irq) {
+        ioapic_set_masked(line, false);
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_irq_set_affinity(_irq: u32, _cpu: u32) -> i64 {
+    // MSI vektörleri mesaj yeniden yazılarak yönlendirilir (low_level_msi_compose).
+    // TODO: IOAPIC yönlendirme girdisinin hedef alanı.
+    -38 // KERROR_NOT_SUPPORTED
+}
+
+// --- Çekirdek Konsolu UART'ı (hardware_specific.h, srcconsole.rs) ---
+
+fn uart_read(reg: u16) -> u8 {
+    unsafe { Port::<u8>::new(COM1_PORT + reg).read() }
+}
+
+fn uart_write(reg: u16, value: u8) {
+    unsafe { Port::<u8>::new(COM1_PORT + reg).write(value) }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_console_putc(c: u8) {
+    while uart_read(UART_LSR) & 0x20 == 0 {
+        core::hint::spin_loop();
+    }
+    uart_write(0, c);
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_console_tx_room() -> u32 {
+    // 16550A yalnızca "FIFO boş" bildirir; boşsa FIFO'nun tamamı yazılabilir
+    if uart_read(UART_LSR) & 0x20 != 0 { UART_FIFO_SIZE } else { 0 }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_console_tx_irq_enable(enable: u32) {
+    let ier = uart_read(UART_IER);
+    uart_write(UART_IER, if enable != 0 { ier | 0x02 } else { ier & !0x02 });
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_console_irq() -> u32 {
+    // IRQ4'ü bu CPU'ya, maskeli olarak yönlendir; kirq::request low_level_irq_unmask ile açar.
+    x86_64::instructions::interrupts::without_interrupts(|| {
+        let _guard = IOAPIC_LOCK.lock();
+        unsafe {
+            let apic_id = core::ptr::read_volatile(LAPIC_ID as *const u32) >> 24;
+            ioapic_write(IOAPIC_REDTBL + 2 * COM1_ISA_IRQ + 1, apic_id << 24);
+            ioapic_write(IOAPIC_REDTBL + 2 * COM1_ISA_IRQ, IOAPIC_MASKED | COM1_VECTOR as u32);
+        }
+    });
+    uart_write(UART_MCR, uart_read(UART_MCR) | 0x08);
+    COM1_VECTOR as u32
+}
+
+
 // --- Sistem Çağrısı İşleyicisi ---
 
 // `x86-interrupt` çağrı kuralı, CPU'nun kesme sırasındaki yığın düzenini ve
 // kaydettiği durumu (InterruptStackFrame) otomatik olarak argüman olarak sağlar.
 // Syscall kesmesi için hata kodu PUSH YAPMAZ, bu nedenle stack frame direkt gelir.
 extern "x86-interrupt" fn syscall_handler(stack_frame: InterruptStackFrame) {
+    let _gs = KernelGs::enter(&stack_frame);
     // Sistem Çağrısı (Syscall) işleyicisi (Vektör 128 - 0x80)
     // Kullanıcı alanından çekirdek hizmetlerini talep etmek için kullanılır.
 
@@ -202,8 +717,18 @@ pub fn init_idt() {
     idt[PIC_1_OFFSET].set_handler_fn(timer_interrupt_handler);
     // Vektör 33: Klavye (Keyboard - IRQ1)
     idt[PIC_1_OFFSET + 1].set_handler_fn(keyboard_interrupt_handler);
+    // Vektör 36: COM1 (IRQ4, çekirdek konsolu) kirq üzerinden
+    idt[COM1_VECTOR].set_handler_fn(vector_stub::<COM1_VECTOR>);
     // ... Diğer donanım kesmeleri ...
 
+    // Vektör 0x30-0xEF: MSI/MSI-X ve genel kesmeler (kirq_dispatch). 0x80 aşağıda syscall'a kurulur.
+    set_vector_stubs!(idt; 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14);
+
+    // Vektör 0xF0 ve üstü: işlemciler arası kesmeler (tüm CPU'lar bu IDT'yi low_level_ipi_init ile yükler)
+    idt[TLB_SHOOTDOWN_VECTOR].set_handler_fn(tlb_shootdown_ipi_handler);
+    idt[RESCHEDULE_VECTOR].set_handler_fn(reschedule_ipi_handler);
+    idt[PERFORMANCE_VECTOR].set_handler_fn(performance_ipi_handler);
+
     // Sistem Çağrısı işleyicisini kur
     // Vektör 128 (0x80) genellikle syscall için kullanılır
     idt[SYSCALL_INT_VECTOR]
@@ -242,5 +767,6 @@ pub fn enable_interrupts() {
 // --- Basit Breakpoint İstisnası İşleyicisi (Hata Ayıklama İçin Kullanışlı) ---
 // Bu handler, gdb gibi hata ayıklayıcılar için veya kodda kasıtlı durdurma noktaları için kullanışlıdır.
 extern "x86-interrupt" fn breakpoint_handler(stack_frame: InterruptStackFrame) {
+    let _gs = KernelGs::enter(&stack_frame);
     println!("EXCEPTION: BREAKPOINT\n{:#?}", stack_frame);
 }
@@ -6,6 +6,10 @@
 
 use core::ptr;
 use core::fmt;
+use crate::ktlb::{self, TlbBatch}; // Toplu TLB geçersiz kılma (srctlb.rs)
+use crate::kasid::{AsidAllocator, AddressSpaceTable}; // PCID dağıtımı (srcasid.rs)
+use crate::kpager; // Tembel sayfalar ve COW (srcpager.rs)
+use core::sync::atomic::{AtomicBool, Ordering};
 // İhtiyaç duyulursa x86_64 spesifik intrinsikler için:
  use core::arch::x86_64;
 
@@ -255,6 +259,102 @@ impl FrameAllocator for PlaceholderFrameAllocator {
 }
 
 
+/// Mevcut core'da tek bir sanal adresin TLB girişini geçersiz kılar (invlpg; büyük sayfaları da kapsar).
+#[inline]
+fn flush_tlb_page(virt_addr: VirtAddr) {
+    unsafe { core::arch::asm!("invlpg [{}]", in(reg) virt_addr, options(nostack, preserves_flags)); }
+}
+
+/// Mevcut core'da global olmayan tüm TLB girişlerini geçersiz kılar (CR3 yeniden yüklenir).
+#[inline]
+fn flush_tlb_all() {
+    unsafe {
+        core::arch::asm!(
+            "mov {tmp}, cr3",
+            "mov cr3, {tmp}",
+            tmp = out(reg) _,
+            options(nostack, preserves_flags),
+        );
+    }
+}
+
+// --- PCID (Process-Context Identifier) ---
+// CR4.PCIDE açıkken CR3'ün alt 12 biti TLB girdilerini etiketler; bit 63 set edilerek yüklenen
+// CR3 TLB'yi temizlemez. Her adres alanına srcasid.rs'deki nesil tabanlı dağıtıcıdan bir PCID verilir.
+// Başka bir PCID'nin girdilerini temizlemek INVPCID gerektirdiğinden PCID yalnızca INVPCID ile birlikte açılır.
+
+const CR3_NOFLUSH: u64 = 1 << 63;
+const CR4_PCIDE: u64 = 1 << 17;
+const PCID_BITS: u32 = 12;
+
+// INVPCID türleri
+const INVPCID_ADDRESS: u64 = 0;        // Tek adres, tek PCID
+const INVPCID_SINGLE_CONTEXT: u64 = 1; // Bir PCID'nin tüm global olmayan girdileri
+const INVPCID_ALL_GLOBAL: u64 = 2;     // Tüm PCID'ler, global girdiler dahil
+const INVPCID_ALL_NON_GLOBAL: u64 = 3; // Tüm PCID'ler, global girdiler hariç
+
+static PCID_ENABLED: AtomicBool = AtomicBool::new(false);
+static X86_PCIDS: AsidAllocator = AsidAllocator::new(0); // enable_pcid ile PCID_BITS'e ayarlanır
+static X86_ADDRESS_SPACES: AddressSpaceTable = AddressSpaceTable::new();
+
+extern "C" {
+    fn low_level_cpu_id() -> u32;
+}
+
+#[inline]
+fn invpcid(kind: u64, pcid: u16, addr: u64) {
+    let descriptor: [u64; 2] = [pcid as u64, addr];
+    unsafe {
+        core::arch::asm!("invpcid {}, [{}]", in(reg) kind, in(reg) descriptor.as_ptr(), options(nostack, preserves_flags));
+    }
+}
+
+// Kökün PCID'i (kayıtlı değilse veya PCID kapalıysa 0: etiketsiz)
+fn pcid_for_root(pml4_phys_addr: PhysAddr) -> u16 {
+    if !PCID_ENABLED.load(Ordering::Relaxed) {
+        return 0;
+    }
+    X86_ADDRESS_SPACES.lookup(pml4_phys_addr).map(|ctx| ctx.asid()).unwrap_or(0)
+}
+
+// Bir adres alanının sayfa tablosu değişiklikleri için TLB toplu işlemi
+fn tlb_batch_for(pml4_phys_addr: PhysAddr) -> TlbBatch {
+    TlbBatch::for_asid(ktlb::online_cpus(), pcid_for_root(pml4_phys_addr))
+}
+
+// ktlb'nin (srctlb.rs) kullandığı yerel TLB kancaları (hardware_specific.h)
+#[no_mangle]
+pub extern "C" fn low_level_tlb_flush_page(vaddr: u64, asid: u16) {
+    if !PCID_ENABLED.load(Ordering::Relaxed) {
+        flush_tlb_page(vaddr);
+    } else if asid == 0 {
+        // Etiketsiz adres alanları PCID 0'da çalışır: tek adres biçimi o PCID'nin girdisini atar.
+        // Çekirdek eşlemeleri global olduğundan (G) invlpg ile de atılır; mevcut PCID'nin girdisi de gider.
+        invpcid(INVPCID_ADDRESS, 0, vaddr);
+        flush_tlb_page(vaddr);
+    } else {
+        invpcid(INVPCID_ADDRESS, asid, vaddr);
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_tlb_flush_asid(asid: u16) {
+    if !PCID_ENABLED.load(Ordering::Relaxed) || asid == 0 {
+        low_level_tlb_flush_all();
+    } else {
+        invpcid(INVPCID_SINGLE_CONTEXT, asid, 0);
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_tlb_flush_all() {
+    if PCID_ENABLED.load(Ordering::Relaxed) {
+        invpcid(INVPCID_ALL_NON_GLOBAL, 0, 0);
+    } else {
+        flush_tlb_all();
+    }
+}
+
 // --- x86_64 MMU Yöneticisi ---
 /// x86_64 sayfa tablolarını yönetmek için fonksiyonlar sağlar.
 /// 64-bit long mode ve 4-level paging varsayar.
@@ -263,6 +363,11 @@ pub struct X86MmuManager {
     // MMU yöneticisi, fiziksel frame ayırıcısına bir referans veya sahip olabilir.
     // Genellikle kernel başlangıcında statik bir ayırıcı kurulur ve buraya geçirilir.
     // allocator: &'static mut dyn FrameAllocator, // Örnek alan
+
+    /// CPU 1GB sayfaları destekliyor mu (CPUID.80000001h:EDX.Page1GB[bit 26])
+    huge_1g_supported: bool,
+    /// CPU PCID ve INVPCID destekliyor mu (CPUID.01h:ECX[17], CPUID.(07h,0):EBX[10])
+    pcid_supported: bool,
 }
 
 impl X86MmuManager {
@@ -272,7 +377,42 @@ impl X86MmuManager {
     pub fn new(/* allocator: &'static mut dyn FrameAllocator */) -> Self {
         X86MmuManager {
             // allocator: allocator
+            huge_1g_supported: Self::cpu_supports_1g_pages(),
+            pcid_supported: Self::cpu_supports_pcid(),
+        }
+    }
+
+    /// CPUID ile PCID ve INVPCID desteğini sorgular.
+    fn cpu_supports_pcid() -> bool {
+        let ecx = unsafe { core::arch::x86_64::__cpuid(0x1).ecx };
+        let ebx = unsafe { core::arch::x86_64::__cpuid_count(0x7, 0).ebx };
+        ecx & (1 << 17) != 0 && ebx & (1 << 10) != 0
+    }
+
+    /// Mevcut core'da CR4.PCIDE'yi açar. Her core kendi başlangıcında (CR3'ün PCID alanı 0 iken) çağırmalıdır.
+    /// PCID desteklenmiyorsa hiçbir şey yapmaz; adres alanları etiketsiz çalışır.
+    /// # Güvenlik (Safety)
+    /// Tüm core'larda aynı sonuçla çağrılmalıdır; karışık PCIDE yapılandırması desteklenmez.
+    pub unsafe fn enable_pcid(&self) {
+        if !self.pcid_supported {
+            return;
         }
+        core::arch::asm!(
+            "mov {tmp}, cr4",
+            "or {tmp}, {bit}",
+            "mov cr4, {tmp}",
+            tmp = out(reg) _,
+            bit = in(reg) CR4_PCIDE,
+            options(nostack),
+        );
+        X86_PCIDS.set_bits(PCID_BITS);
+        PCID_ENABLED.store(true, Ordering::Relaxed);
+    }
+
+    /// CPUID ile 1GB sayfa desteğini sorgular. 2MB sayfalar tüm x86_64 işlemcilerde desteklenir.
+    fn cpu_supports_1g_pages() -> bool {
+        let edx = unsafe { core::arch::x86_64::__cpuid(0x8000_0001).edx };
+        edx & (1 << 26) != 0
     }
 
     /// Sayfa tablosu hiyerarşisinde belirtilen sanal adrese karşılık gelen
@@ -442,13 +582,34 @@ impl X86MmuManager {
          println!("MMU: Mapped V:0x{:x} to P:0x{:x} with flags 0x{:x}", virt_addr, phys_addr, flags.raw()); // Çekirdek içi print!
 
 
-        // TODO: Mevcut core'da bu sanal adres için TLB'yi invalidate et (invlpg talimatı veya eşdeğeri)
-        // Bu, CPU'nun önbelleğe alınmış çeviri bilgisini atmasını sağlar.
-         core::arch::x86_64::instructions::tlb::flush(virt_addr as usize); // `x86_64` crate veya intrinsik gerektirir
+        // x86_64 present olmayan girişleri TLB'de tutmaz: boş bir girişi doldurmak için
+        // geçersiz kılma (ve diğer core'lara IPI) gerekmez. Bu, map_range'i tamamen temizliksiz yapar.
 
         Ok(())
     }
 
+    /// Sayfa hatası çözümü için 4K yaprağı yazar; girdi zaten haritalıysa üzerine yazar.
+    /// Önceki girdi haritalıysa eski frame'i döner. Bu durumda eski girdinin TLB temizliği çağırana aittir.
+    ///
+    /// # Güvenlik (Safety)
+    /// `map_page` ile aynı koşullar geçerlidir.
+    pub unsafe fn set_page(
+        &self,
+        page_table_root_phys: PhysAddr,
+        virt_addr: VirtAddr,
+        phys_addr: PhysAddr,
+        flags: PageFlags,
+        allocator: &mut dyn FrameAllocator,
+    ) -> Result<Option<PhysAddr>, MmuError> {
+        if virt_addr % PAGE_SIZE_4K != 0 || phys_addr % PAGE_SIZE_4K != 0 {
+            return Err(MmuError::InvalidArgument);
+        }
+        let (pte, _pt_phys_addr) = self.walk_page_table_mut(page_table_root_phys, virt_addr, allocator, true)?;
+        let old = if pte.is_present() { Some(pte.physical_address(PAGE_SIZE_4K)) } else { None };
+        pte.set(PageTableEntry::new(phys_addr, flags.with(PageFlags::PRESENT)).raw());
+        Ok(old)
+    }
+
     /// Belirtilen sanal adresin haritalamasını kaldırır (unmapping).
     /// Eğer sayfa tablosu sayfası boş kalırsa (opsiyonel olarak) frame'i iade eder.
     /// `virt_addr` 4KB sayfa hizalı olmalıdır.
@@ -467,6 +628,24 @@ impl X86MmuManager {
         virt_addr: VirtAddr,
         allocator: &mut dyn FrameAllocator,
     ) -> Result<(), MmuError> {
+        let mut batch = tlb_batch_for(page_table_root_phys);
+        self.unmap_page_deferred(page_table_root_phys, virt_addr, allocator, &mut batch)?;
+        batch.flush();
+        Ok(())
+    }
+
+    /// `unmap_page` gibi, ancak TLB geçersiz kılmasını `batch`'e kuyruklar.
+    /// Haritası kaldırılan fiziksel adresi döner; bu frame ancak `batch.flush()` sonrasında iade edilmelidir.
+    ///
+    /// # Güvenlik (Safety)
+    /// `unmap_page` ile aynı koşullar geçerlidir.
+    pub unsafe fn unmap_page_deferred(
+        &self,
+        page_table_root_phys: PhysAddr,
+        virt_addr: VirtAddr,
+        allocator: &mut dyn FrameAllocator,
+        batch: &mut TlbBatch,
+    ) -> Result<PhysAddr, MmuError> {
          // Temel adres hizalama kontrolü
         if virt_addr % PAGE_SIZE_4K != 0 {
              println!("MMU: Unmap error - Invalid alignment V:0x{:x}", virt_addr); // Çekirdek içi print!
@@ -488,11 +667,12 @@ impl X86MmuManager {
         }
 
         // PTE'yi temizle (Present bayrağını kaldır)
+        let phys_addr = pte.physical_address(PAGE_SIZE_4K);
         pte.clear();
           println!("MMU: Unmapped V:0x{:x}", virt_addr); // Çekirdek içi print!
 
-        // TODO: Mevcut core'da bu sanal adres için TLB'yi invalidate et.
-          core::arch::x86_64::instructions::tlb::flush(virt_addr as usize); // `x86_64` crate veya intrinsik gerektirir
+        // TLB geçersiz kılması çağıranın toplu işleminde, tüm aralık için bir kez yapılır.
+        batch.add_page(virt_addr);
 
         // TODO: Sayfa tablosu sayfalarının iadesi (opsiyonel ve karmaşık)
         // Eğer bir sayfa tablosu sayfası (PT, PD, PDPT) haritalaması kaldırılan son
@@ -500,8 +680,9 @@ impl X86MmuManager {
         // Bu, yürüyüşü geri takip etmeyi ve her düzeyde tablonun boş olup olmadığını
         // kontrol etmeyi gerektirir. Basitlik için şimdilik bu adımı atlayabiliriz.
         // Implement edilirse, `allocator.deallocate_frame(tablo_phys_addr)` çağrılmalıdır.
+        // (Tablo frame'leri de ancak TLB toplu işlemi temizlendikten sonra iade edilebilir.)
 
-        Ok(())
+        Ok(phys_addr)
     }
 
      /// Sanal adresi karşılık gelen fiziksel adrese çevirir (translate).
@@ -526,12 +707,12 @@ impl X86MmuManager {
 
         let mut current_phys_table_addr = page_table_root_phys;
 
-        // İndeksler ve o düzeyde karşılaşılabilecek büyük sayfa boyutları
+        // İndeksler ve o düzeydeki girişin yaprak (PS biti set) olması halinde işaret ettiği sayfa boyutu
         let levels = [
-            (pml4_index, PAGE_SIZE_1G), // PML4 -> PDPT, ama PML4E 1GB sayfayı işaret edebilir
-            (pdpt_index, PAGE_SIZE_2M), // PDPT -> PD, ama PDPTE 2MB sayfayı işaret edebilir
-            (pd_index, PAGE_SIZE_4K),     // PD -> PT, ama PDE 2MB sayfayı işaret edebilir (HUGE_PAGE)
-            (pt_index, PAGE_SIZE_4K),     // PT -> 4KB Sayfa
+            (pml4_index, PAGE_SIZE_4K), // PML4E her zaman bir PDPT'ye işaret eder (PS biti ayrılmıştır)
+            (pdpt_index, PAGE_SIZE_1G), // PDPTE, PS set ise 1GB sayfayı işaret eder
+            (pd_index, PAGE_SIZE_2M),   // PDE, PS set ise 2MB sayfayı işaret eder
+            (pt_index, PAGE_SIZE_4K),   // PT -> 4KB Sayfa
         ];
 
 
@@ -542,12 +723,12 @@ impl X86MmuManager {
             let entry = &*entry_ptr;
 
             if !entry.is_present() {
-                 println!("MMU: Translate error - Not present at level {}", i); // Çekirdek içi print!
+                 // println!("MMU: Translate error - Not present at level {}", i); // Çekirdek içi print!
                 return Err(MmuError::NotMapped); // Sayfa veya ara tablo mevcut değil
             }
 
             if i < 3 { // Son düzey (PT) değilse
-                if entry.is_huge_page() {
+                if i > 0 && entry.is_huge_page() {
                     // Ara düzeyde büyük sayfa bulduk (2MB veya 1GB). Adres bu büyük sayfanın içinde.
                     let huge_page_phys_base = entry.physical_address(possible_huge_page_size);
                     let offset_within_huge_page = virt_addr & (possible_huge_page_size - 1);
@@ -561,7 +742,7 @@ impl X86MmuManager {
                 // 4KB PTE'yi bulduk. Son fiziksel adresi hesapla.
                 let page_phys_base = entry.physical_address(PAGE_SIZE_4K);
                 let offset_within_page = virt_addr & (PAGE_SIZE_4K - 1);
-                  println!("MMU: Translated V:0x{:x} to P:0x{:x} (4K Page)", virt_addr, page_phys_base + offset_within_page); // Çekirdek içi print!
+                  // println!("MMU: Translated V:0x{:x} to P:0x{:x} (4K Page)", virt_addr, page_phys_base + offset_within_page); // Çekirdek içi print!
                 return Ok(page_phys_base + offset_within_page);
             }
         }
@@ -570,6 +751,147 @@ impl X86MmuManager {
          Err(MmuError::InternalError)
     }
 
+    /// Büyük sayfa (yaprak) girişinin bulunacağı düzeye kadar yürür, gerekirse ara tabloları oluşturur.
+    /// `page_size` PAGE_SIZE_2M ise PDE'ye, PAGE_SIZE_1G ise PDPTE'ye mutable referans döner.
+    ///
+    /// # Güvenlik (Safety)
+    /// `walk_page_table_mut` ile aynı koşullar geçerlidir.
+    unsafe fn walk_to_huge_entry<'a>(
+        &self,
+        page_table_root_phys: PhysAddr,
+        virt_addr: VirtAddr,
+        page_size: u64,
+        allocator: &mut dyn FrameAllocator,
+        create_intermediate: bool,
+    ) -> Result<&'a mut PageTableEntry, MmuError> {
+        // Yaprağın üzerinde kaç ara tablo var: 1GB -> PML4, 2MB -> PML4 + PDPT
+        let (depth, shifts): (usize, [u64; 3]) = match page_size {
+            PAGE_SIZE_1G => (1, [39, 30, 0]),
+            PAGE_SIZE_2M => (2, [39, 30, 21]),
+            _ => return Err(MmuError::NotSupported),
+        };
+
+        let mut table_phys = page_table_root_phys;
+        for level in 0..depth {
+            let index = (virt_addr >> shifts[level]) & 0x1FF;
+            let entry = &mut *((table_phys + index * core::mem::size_of::<PageTableEntry>() as u64) as *mut PageTableEntry); // !!! Identity map varsayılıyor !!!
+
+            if entry.is_present() {
+                if level > 0 && entry.is_huge_page() {
+                    return Err(MmuError::AlreadyMapped); // Daha büyük bir sayfanın içinde
+                }
+                table_phys = entry.physical_address(PAGE_SIZE_4K);
+            } else if create_intermediate {
+                let new_table_phys = allocator.allocate_frame().ok_or(MmuError::OutOfMemory)?;
+                ptr::write_bytes(new_table_phys as *mut u8, 0, PAGE_SIZE_4K as usize); // !!! Identity map varsayılıyor !!!
+                entry.set(PageTableEntry::new(
+                    new_table_phys,
+                    PageFlags::PRESENT.with(PageFlags::WRITABLE).with(PageFlags::USER_ACCESSIBLE),
+                ).raw());
+                table_phys = new_table_phys;
+            } else {
+                return Err(MmuError::MissingPageTable);
+            }
+        }
+
+        let index = (virt_addr >> shifts[depth]) & 0x1FF;
+        Ok(&mut *((table_phys + index * core::mem::size_of::<PageTableEntry>() as u64) as *mut PageTableEntry))
+    }
+
+    /// 2MB veya 1GB'lık tek bir büyük sayfa haritalar (PDE/PDPTE'de PS biti set edilir).
+    /// `virt_addr` ve `phys_addr` `page_size`'a hizalı olmalıdır.
+    ///
+    /// # Güvenlik (Safety)
+    /// `map_page` ile aynı koşullar geçerlidir.
+    pub unsafe fn map_huge_page(
+        &self,
+        page_table_root_phys: PhysAddr,
+        virt_addr: VirtAddr,
+        phys_addr: PhysAddr,
+        page_size: u64,
+        flags: PageFlags,
+        allocator: &mut dyn FrameAllocator,
+    ) -> Result<(), MmuError> {
+        if page_size == PAGE_SIZE_1G && !self.huge_1g_supported {
+            return Err(MmuError::NotSupported);
+        }
+        if virt_addr % page_size != 0 || phys_addr % page_size != 0 {
+            return Err(MmuError::InvalidArgument);
+        }
+
+        let entry = self.walk_to_huge_entry(page_table_root_phys, virt_addr, page_size, allocator, true)?;
+        // Giriş boş olmalı: ya hiç haritalanmamış ya da altında 4K tablolar yok
+        if entry.is_present() {
+            return Err(MmuError::AlreadyMapped);
+        }
+        entry.set(PageTableEntry::new(phys_addr, flags.with(PageFlags::PRESENT).with(PageFlags::HUGE_PAGE)).raw());
+
+        // Giriş önceden boştu; `map_page`'deki gibi geçersiz kılma gerekmez.
+        Ok(())
+    }
+
+    /// Büyük sayfa haritalamasını kaldırır. Adreste `page_size` boyutunda bir büyük sayfa yoksa NotMapped döner.
+    ///
+    /// # Güvenlik (Safety)
+    /// `unmap_page` ile aynı koşullar geçerlidir.
+    pub unsafe fn unmap_huge_page(
+        &self,
+        page_table_root_phys: PhysAddr,
+        virt_addr: VirtAddr,
+        page_size: u64,
+        allocator: &mut dyn FrameAllocator,
+    ) -> Result<(), MmuError> {
+        let mut batch = tlb_batch_for(page_table_root_phys);
+        self.unmap_huge_page_deferred(page_table_root_phys, virt_addr, page_size, allocator, &mut batch)?;
+        batch.flush();
+        Ok(())
+    }
+
+    /// `unmap_huge_page` gibi, ancak TLB geçersiz kılmasını `batch`'e kuyruklar.
+    ///
+    /// # Güvenlik (Safety)
+    /// `unmap_page` ile aynı koşullar geçerlidir.
+    pub unsafe fn unmap_huge_page_deferred(
+        &self,
+        page_table_root_phys: PhysAddr,
+        virt_addr: VirtAddr,
+        page_size: u64,
+        allocator: &mut dyn FrameAllocator,
+        batch: &mut TlbBatch,
+    ) -> Result<(), MmuError> {
+        if virt_addr % page_size != 0 {
+            return Err(MmuError::InvalidArgument);
+        }
+        let entry = self.walk_to_huge_entry(page_table_root_phys, virt_addr, page_size, allocator, false)?;
+        if !entry.is_present() || !entry.is_huge_page() {
+            return Err(MmuError::NotMapped);
+        }
+        entry.clear();
+        batch.add_page(virt_addr); // invlpg büyük sayfanın tamamını kapsar
+        Ok(())
+    }
+
+    /// Aralığın `virt`/`phys` noktasından itibaren kullanılabilecek en büyük sayfa boyutu.
+    /// Hizalama ve kalan uzunluk izin verdiği sürece 1GB, sonra 2MB, değilse 4KB seçilir.
+    fn best_page_size(&self, virt: VirtAddr, phys: PhysAddr, remaining: u64) -> u64 {
+        if self.huge_1g_supported && remaining >= PAGE_SIZE_1G && (virt | phys) % PAGE_SIZE_1G == 0 {
+            PAGE_SIZE_1G
+        } else if remaining >= PAGE_SIZE_2M && (virt | phys) % PAGE_SIZE_2M == 0 {
+            PAGE_SIZE_2M
+        } else {
+            PAGE_SIZE_4K
+        }
+    }
+
+    // `page_size`'lık yaprağın yazılacağı giriş bir alt tabloyu gösteriyorsa true döner.
+    // Ara tablolar oluşturulmaz; yol yoksa veya daha büyük bir sayfa varsa false döner.
+    unsafe fn slot_has_table(&self, page_table_root_phys: PhysAddr, virt_addr: VirtAddr, page_size: u64, allocator: &mut dyn FrameAllocator) -> bool {
+        match self.walk_to_huge_entry(page_table_root_phys, virt_addr, page_size, allocator, false) {
+            Ok(entry) => entry.is_present() && !entry.is_huge_page(),
+            Err(_) => false,
+        }
+    }
+
     // --- Ek MMU Fonksiyonları (TODO) ---
     // İhtiyaç duyuldukça eklenecek fonksiyonlar:
 
@@ -592,10 +914,74 @@ impl X86MmuManager {
          let new_pml4_table_ptr = pml4_phys_addr as *mut PageTableEntry;
          (*new_pml4_table_ptr.add(511)).set(kernel_pml4e.raw());
 
+        // PCID bağlamını kaydet; tablo doluysa adres alanı etiketsiz (PCID 0) çalışır.
+        let _ = X86_ADDRESS_SPACES.register(pml4_phys_addr);
+
         Ok(pml4_phys_addr)
     }
 
-    /// Belirtilen sanal adres aralığını haritalar. Sayfa bazında `map_page` çağrısı yapar.
+    /// Bir görevin sayfa tablosu hiyerarşisini yok eder: kullanıcı yarısındaki (PML4 0..256)
+    /// tüm ara tablo frame'lerini ve PML4'ün kendisini iade eder. Pager bölgelerindeki (srcpager.rs)
+    /// yaprak frame'leri kpager::release_frame ile bırakılır (paylaşılanlar diğer sahiplerde yaşar).
+    /// Diğer yaprakların frame'leri iade edilmez; onların sahibi paylaşımlı bellek kayıtlarıdır.
+    ///
+    /// Sayfa başına TLB temizliği yapılmaz. Yıkılan adres alanı hiçbir core'da etkin olmamalıdır.
+    /// PCID etiketli adres alanlarında hiç temizlik gerekmez: PCID nesil dönene kadar yeniden
+    /// verilmez ve dönüşte tüm core'lar TLB'lerini temizler. Etiketsiz adres alanlarında `batch`
+    /// tek bir tam temizlik kuyruklar ve tablo frame'leri bu temizlikten sonra iade edilir.
+    ///
+    /// # Güvenlik (Safety)
+    /// `pml4_phys_addr` artık hiçbir görev tarafından kullanılmamalıdır.
+    pub unsafe fn destroy_page_table(
+        &self,
+        pml4_phys_addr: PhysAddr,
+        allocator: &mut dyn FrameAllocator,
+        batch: &mut TlbBatch,
+    ) {
+        if pcid_for_root(pml4_phys_addr) == 0 {
+            batch.add_all();
+            batch.flush();
+        }
+        X86_ADDRESS_SPACES.unregister(pml4_phys_addr);
+
+        let pml4 = pml4_phys_addr as *mut PageTableEntry;
+        for i in 0..256 {
+            let entry = &*pml4.add(i);
+            if entry.is_present() {
+                Self::free_table_level(pml4_phys_addr, entry.physical_address(PAGE_SIZE_4K), 3, i as u64 * (PAGE_SIZE_1G * 512), allocator);
+            }
+        }
+        kpager::release_space(pml4_phys_addr);
+        allocator.deallocate_frame(pml4_phys_addr);
+    }
+
+    // `table_phys` bir ara tablo; `level` 3 = PDPT, 2 = PD, 1 = PT. Alt tabloları özyinelemeli iade eder.
+    // `base` tablonun kapsadığı ilk sanal adrestir; PT düzeyinde pager yaprakları bırakılır.
+    unsafe fn free_table_level(root: PhysAddr, table_phys: PhysAddr, level: u32, base: VirtAddr, allocator: &mut dyn FrameAllocator) {
+        let table = table_phys as *mut PageTableEntry;
+        if level > 1 {
+            let span = if level == 3 { PAGE_SIZE_1G } else { PAGE_SIZE_2M };
+            for i in 0..512 {
+                let entry = &*table.add(i);
+                // Büyük sayfa yaprakları alt tablo değildir
+                if entry.is_present() && !entry.is_huge_page() {
+                    Self::free_table_level(root, entry.physical_address(PAGE_SIZE_4K), level - 1, base + i as u64 * span, allocator);
+                }
+            }
+        } else {
+            for i in 0..512 {
+                let entry = &*table.add(i);
+                if entry.is_present() && kpager::owns(root, base + i as u64 * PAGE_SIZE_4K) {
+                    kpager::release_frame(entry.physical_address(PAGE_SIZE_4K));
+                }
+            }
+        }
+        allocator.deallocate_frame(table_phys);
+    }
+
+    /// Belirtilen sanal adres aralığını haritalar.
+    /// Hizalama izin verdiği her noktada 1GB/2MB büyük sayfa, kalan kısımlarda 4KB sayfa kullanır.
+    /// Altında zaten bir tablo bulunan (kısmen dolu) büyük yuvalar 4KB sayfalarla doldurulur.
     /// # Güvenlik (Safety)
     /// Belirtilen aralığın ve bayrakların geçerli ve güvenli olduğundan emin olunmalıdır.
     pub unsafe fn map_range(
@@ -609,24 +995,29 @@ impl X86MmuManager {
     ) -> Result<(), MmuError> {
         let mut current_virt = virt_start;
         let mut current_phys = phys_start;
-        let size_pages = (size + PAGE_SIZE_4K as usize - 1) / PAGE_SIZE_4K as usize;
+        let end_virt = virt_start + ((size as u64 + PAGE_SIZE_4K - 1) & !(PAGE_SIZE_4K - 1));
 
-        for _i in 0..size_pages {
-            self.map_page(
-                page_table_root_phys,
-                current_virt,
-                current_phys,
-                flags,
-                allocator,
-            )?; // Hata durumunda işlemi durdur
+        while current_virt < end_virt {
+            let mut page_size = self.best_page_size(current_virt, current_phys, end_virt - current_virt);
+            // Yuvanın altında zaten bir tablo varsa (kısmen dolu) büyük sayfa kurulamaz; bir alt boyuta in.
+            while page_size != PAGE_SIZE_4K && self.slot_has_table(page_table_root_phys, current_virt, page_size, allocator) {
+                page_size = if page_size == PAGE_SIZE_1G { PAGE_SIZE_2M } else { PAGE_SIZE_4K };
+            }
+            if page_size == PAGE_SIZE_4K {
+                self.map_page(page_table_root_phys, current_virt, current_phys, flags, allocator)?; // Hata durumunda işlemi durdur
+            } else {
+                self.map_huge_page(page_table_root_phys, current_virt, current_phys, page_size, flags, allocator)?;
+            }
 
-            current_virt += PAGE_SIZE_4K;
-            current_phys += PAGE_SIZE_4K;
+            current_virt += page_size;
+            current_phys += page_size;
         }
         Ok(())
     }
 
-     /// Belirtilen sanal adres aralığının haritalamasını kaldırır. Sayfa bazında `unmap_page` çağrısı yapar.
+     /// Belirtilen sanal adres aralığının haritalamasını kaldırır.
+     /// Aralığın tamamen kapsadığı büyük sayfalar tek adımda kaldırılır; kısmen kapsanan büyük sayfa NotSupported döner.
+     /// TLB, sayfa başına değil aralık sonunda bir kez (tüm core'larda) temizlenir.
       /// # Güvenlik (Safety)
      /// Belirtilen aralığın geçerli ve güvenli olduğundan emin olunmalıdır.
      pub unsafe fn unmap_range(
@@ -636,17 +1027,44 @@ impl X86MmuManager {
         size: usize,
         allocator: &mut dyn FrameAllocator,
     ) -> Result<(), MmuError> {
-        let mut current_virt = virt_start;
-        let size_pages = (size + PAGE_SIZE_4K as usize - 1) / PAGE_SIZE_4K as usize;
+        let mut batch = tlb_batch_for(page_table_root_phys);
+        let result = self.unmap_range_deferred(page_table_root_phys, virt_start, size, allocator, &mut batch);
+        // Hata durumunda da o ana kadar kaldırılan girişler temizlenmelidir.
+        batch.flush();
+        result
+    }
 
-        for _i in 0..size_pages {
-            self.unmap_page(
-                page_table_root_phys,
-                current_virt,
-                allocator,
-            )?; // Hata durumunda işlemi durdur
+    /// `unmap_range` gibi, ancak TLB geçersiz kılmalarını çağıranın `batch`'ine kuyruklar.
+    /// Birden çok aralığı tek bir shootdown ile kaldırmak için kullanılır.
+    /// # Güvenlik (Safety)
+    /// `unmap_range` ile aynı koşullar geçerlidir.
+    pub unsafe fn unmap_range_deferred(
+        &self,
+        page_table_root_phys: PhysAddr,
+        virt_start: VirtAddr,
+        size: usize,
+        allocator: &mut dyn FrameAllocator,
+        batch: &mut TlbBatch,
+    ) -> Result<(), MmuError> {
+        let mut current_virt = virt_start;
+        let end_virt = virt_start + ((size as u64 + PAGE_SIZE_4K - 1) & !(PAGE_SIZE_4K - 1));
+
+        while current_virt < end_virt {
+            // Büyük sayfa mı? Önce 1GB, sonra 2MB yaprağı dene
+            let mut step = PAGE_SIZE_4K;
+            for &page_size in &[PAGE_SIZE_1G, PAGE_SIZE_2M] {
+                if current_virt % page_size == 0 && end_virt - current_virt >= page_size
+                    && self.unmap_huge_page_deferred(page_table_root_phys, current_virt, page_size, allocator, batch).is_ok() {
+                    step = page_size;
+                    break;
+                }
+            }
+            if step == PAGE_SIZE_4K {
+                // 4K PTE'ye yürüyüş büyük sayfaya çarparsa NotSupported döner (kısmi kaldırma)
+                self.unmap_page_deferred(page_table_root_phys, current_virt, allocator, batch)?; // Hata durumunda işlemi durdur
+            }
 
-            current_virt += PAGE_SIZE_4K;
+            current_virt += step;
         }
         Ok(())
      }
@@ -658,28 +1076,29 @@ impl X86MmuManager {
     /// güvenli bir sayfa tablosuna işaret ettiğinden emin olmalıdır. Çekirdek kodunun
     /// yeni haritada erişilebilir olması KRİTİKTİR!
     pub unsafe fn switch_page_table(&self, pml4_phys_addr: PhysAddr) {
-        // CR3 register'ına yeni PML4'ün fiziksel adresini yaz.
-        // Bu işlem mimariye özgüdür. `x86_64` crate veya intrinsik kullanın.
-        // `x86_64` crate kullanılıyorsa:
-         use x86_64::PhysAddr;
-         use x86_64::registers::control::{Cr3, Cr3Flags};
-         Cr3::write(PhysAddr::new(pml4_phys_addr), Cr3Flags::empty());
-
-        // Basitlik için doğrudan bellek yazma (CR3 adresi bilinmiyorsa bu sadece bir yer tutucudur!)
-        // Gerçek adresi bulmak için x86_64 mimarisi dokümantasyonuna veya crate'lere bakılmalıdır.
-         ptr::write_volatile(0xFFFFFFFF_80000000 as *mut u64, pml4_phys_addr); // Örnek/yer tutucu adres, DOĞRU ADRES DEĞİL!
-
-        // Doğrudan assembly kullanmak gerekebilir. Veya `x86_64` crate'indeki safe olmayan fonk.
-         asm!("mov %cr3, {}", in(reg) pml4_phys_addr, options(nostack, nomem)); // Örnek inline assembly
-
+        // PCID etiketli adres alanları TLB temizlenmeden yüklenir (CR3 bit 63).
+        // Etiketsiz adres alanları PCID 0 ile yüklenir; bu, PCID 0 girdilerini temizler.
+        let mut cr3 = pml4_phys_addr;
+        let mut flush_all = false;
+        if PCID_ENABLED.load(Ordering::Relaxed) {
+            if let Some(ctx) = X86_ADDRESS_SPACES.lookup(pml4_phys_addr) {
+                let switch = X86_PCIDS.switch_to(ctx, low_level_cpu_id() as usize);
+                cr3 |= switch.asid as u64;
+                if switch.asid != 0 && !switch.flush_all {
+                    cr3 |= CR3_NOFLUSH;
+                }
+                flush_all = switch.flush_all;
+            }
+        }
 
-         println!("MMU: Switched to page table at 0x{:x}", pml4_phys_addr); // Çekirdek içi print!
+        core::arch::asm!("mov cr3, {}", in(reg) cr3, options(nostack, preserves_flags));
+        // PCID nesli döndü: bu core'daki eski nesle ait tüm etiketli girdiler atılmalı.
+        if flush_all {
+            invpcid(INVPCID_ALL_NON_GLOBAL, 0, 0);
+        }
     }
 
-    // TODO: Sayfa tablosu hiyerarşisini yok etme (tüm sayfaları iade etme).
     // TODO: Sayfa tablosu hiyerarşisini kopyalama (fork için).
-    // TODO: Büyük sayfalar (2MB/1GB) için haritalama/kaldırma fonksiyonları (şu anki map_page sadece 4K'yı hedefliyor).
-    // TODO: TLB yönetimi fonksiyonları (global flush, specific address flush).
 }
 
 
@@ -690,6 +1109,7 @@ impl X86MmuManager {
 mod kmemory {
     use super::*; // karnal64.rs kapsamındaki tipleri kullan (KError, KHandle vb.)
     use crate::srcmmu_x86::{X86MmuManager, FrameAllocator, PhysAddr, VirtAddr, PageFlags, MmuError}; // srcmmu_x86.rs'dan import
+    use crate::kslab; // Küçük tahsisler için görevin dilim kümesi (srcslab.rs)
 
     // Kernel'ın global fiziksel frame ayırıcısı (başlangıçta initialize edilmeli)
     static mut GLOBAL_FRAME_ALLOCATOR: Option<MyKernelFrameAllocatorImpl> = None; // Çekirdeğinizin gerçek ayırıcısı
@@ -704,6 +1124,8 @@ mod kmemory {
 
             // MMU yöneticisini başlatın
             X86_MMU_MANAGER = Some(X86MmuManager::new());
+            // Önyükleme core'unda PCID'yi aç; diğer core'lar low_level_mmu_cpu_init ile açar.
+            X86_MMU_MANAGER.as_ref().unwrap().enable_pcid();
 
             // TODO: Kernel'ın kendi adres alanını ve ilk görev'in (örneğin bootstrapper) adres alanını kurun.
             // Bu, `create_new_page_table` ve `map_range` fonksiyonlarını kullanır.
@@ -722,8 +1144,77 @@ mod kmemory {
 
     // Karnal64 API fonksiyonlarının implementasyonu (srcmmu_x86'ı kullanarak)
 
+    /// Pager'ın (srcpager.rs) bir görevin adres alanındaki yaprak işlemleri.
+    pub struct UserFaultMmu {
+        pml4_phys: PhysAddr,
+    }
+
+    impl kpager::FaultMmu for UserFaultMmu {
+        fn lookup(&self, vaddr: u64) -> Option<(u64, bool)> {
+            let mmu = unsafe { X86_MMU_MANAGER.as_ref()? };
+            let allocator = unsafe { GLOBAL_FRAME_ALLOCATOR.as_mut()? };
+            let (pte, _) = unsafe { mmu.walk_page_table_mut(self.pml4_phys, vaddr, allocator, false).ok()? };
+            if !pte.is_present() {
+                return None;
+            }
+            Some((pte.physical_address(PAGE_SIZE_4K), pte.flags().contains(PageFlags::WRITABLE)))
+        }
+
+        fn install(&self, vaddr: u64, frame: u64, prot: u32, replace: bool) -> Result<(), KError> {
+            let mmu = unsafe { X86_MMU_MANAGER.as_ref().ok_or(KError::InternalError)? };
+            let allocator = unsafe { GLOBAL_FRAME_ALLOCATOR.as_mut().ok_or(KError::InternalError)? };
+            let old = unsafe { mmu.set_page(self.pml4_phys, vaddr, frame, page_flags_from_kmem(prot), allocator) }
+                .map_err(map_mmu_error)?;
+            // Yalnızca frame değiştiyse eski girdi temizlenir. Aynı frame'in yazılabilir yapılmasında
+            // diğer CPU'lardaki salt okunur girdiler en fazla sahte bir hataya yol açar.
+            if replace && old.map_or(false, |f| f != frame) {
+                let mut batch = tlb_batch_for(self.pml4_phys);
+                batch.add_page(vaddr);
+                batch.flush();
+            }
+            Ok(())
+        }
+    }
+
+    // Sayfa Hatası hata kodu bitleri (srcexception_amd64.rs'deki PageFaultErrorCode)
+    const PF_WRITE: u64 = 1 << 1;
+    const PF_RESERVED: u64 = 1 << 3;
+    const PF_INSTRUCTION_FETCH: u64 = 1 << 4;
+    const USER_SPACE_END: VirtAddr = 0x0000_8000_0000_0000;
+
+    /// Kullanıcı yarısındaki bir sayfa hatasını pager ile çözmeyi dener (bkz. srcexception_amd64.rs).
+    /// 0: erişim yeniden denenebilir, negatif: KError (görev sonlandırılmalı veya çekirdek hatası).
+    #[no_mangle]
+    pub extern "C" fn x86_handle_user_page_fault(fault_addr: u64, error_code: u64) -> i64 {
+        if error_code & PF_RESERVED != 0 || fault_addr >= USER_SPACE_END {
+            return KError::BadAddress as i64;
+        }
+        let access = if error_code & PF_INSTRUCTION_FETCH != 0 {
+            kpager::Access::Execute
+        } else if error_code & PF_WRITE != 0 {
+            kpager::Access::Write
+        } else {
+            kpager::Access::Read
+        };
+        // Hata anındaki adres alanı CR3'te (PCID bitleri maskelenir)
+        let cr3: u64;
+        unsafe { core::arch::asm!("mov {}, cr3", out(reg) cr3, options(nomem, nostack, preserves_flags)); }
+        let fault_mmu = UserFaultMmu { pml4_phys: cr3 & PHYSICAL_ADDRESS_MASK_4K };
+        match kpager::handle_fault(fault_mmu.pml4_phys, fault_addr, access, &fault_mmu) {
+            Ok(()) => 0,
+            Err(e) => e as i64,
+        }
+    }
+
     // Örnek: Kullanıcı alanı bellek tahsisi (bir görev için sanal alan bulma ve fiziksel frame haritalama)
     pub fn memory_allocate(size: usize) -> Result<*mut u8, KError> {
+        if size == 0 { return Err(KError::InvalidArgument); }
+
+        // Küçük tahsisler görevin dilim kümesinden karşılanır (CPU magazini -> depo -> dilim sayfası).
+        if size <= kslab::SLAB_MAX_SIZE {
+            return kslab::user_alloc(size).map(|addr| addr as *mut u8);
+        }
+
         // TODO: Mevcut görevin adres alanında yeterli boyutta boş sanal adres aralığı bul.
         // TODO: İstenen `size` kadar fiziksel frame tahsis et (GLOBAL_FRAME_ALLOCATOR kullanarak).
         // TODO: Bulunan sanal aralığı tahsis edilen fiziksel frame'lere haritala (`X86_MMU_MANAGER.map_range` kullanarak).
@@ -733,6 +1224,54 @@ mod kmemory {
          Err(KError::NotSupported) // Implemente edilmediği için
     }
 
+    // Örnek: memory_allocate ile alınmış belleği serbest bırakma
+    pub fn memory_release(ptr: *mut u8, size: usize) -> Result<(), KError> {
+        if ptr.is_null() || size == 0 { return Err(KError::InvalidArgument); }
+
+        // Küçük tahsisler dilim kümesine döner; sayfa haritası değişmez.
+        if size <= kslab::SLAB_MAX_SIZE {
+            return kslab::user_free(ptr as u64, size);
+        }
+
+        // Büyük tahsisler: sayfaların haritası tek bir TLB toplu işlemi içinde kaldırılır.
+        // Frame'ler ancak temizlik tamamlandıktan sonra iade edilir; bu yüzden RELEASE_CHUNK
+        // sayfada bir temizlik yapılır (sayfa başına bir IPI yerine).
+        const RELEASE_CHUNK: usize = 256;
+
+        let mmu = unsafe { X86_MMU_MANAGER.as_ref().ok_or(KError::InternalError)? };
+        let allocator = unsafe { GLOBAL_FRAME_ALLOCATOR.as_mut().ok_or(KError::InternalError)? };
+        let current_task_pml4_phys = get_current_task_pml4_phys(); // TODO: Task yöneticisinden al
+
+        let start = ptr as VirtAddr;
+        if start % PAGE_SIZE_4K != 0 { return Err(KError::InvalidArgument); }
+        let pages = (size as u64 + PAGE_SIZE_4K - 1) / PAGE_SIZE_4K;
+
+        let mut batch = tlb_batch_for(current_task_pml4_phys);
+        let mut frames = [0 as PhysAddr; RELEASE_CHUNK];
+        let mut pending = 0;
+        let mut result = Ok(());
+        for i in 0..pages {
+            match unsafe { mmu.unmap_page_deferred(current_task_pml4_phys, start + i * PAGE_SIZE_4K, allocator, &mut batch) } {
+                Ok(frame) => {
+                    frames[pending] = frame;
+                    pending += 1;
+                }
+                Err(mmu_err) => {
+                    result = Err(map_mmu_error(mmu_err));
+                    break;
+                }
+            }
+            if pending == RELEASE_CHUNK {
+                batch.flush();
+                for &frame in &frames[..pending] { unsafe { allocator.deallocate_frame(frame); } }
+                pending = 0;
+            }
+        }
+        batch.flush();
+        for &frame in &frames[..pending] { unsafe { allocator.deallocate_frame(frame); } }
+        result
+    }
+
     // Örnek: Haritalanmış paylaşımlı belleği kaldırma (unmap)
     pub fn shared_mem_unmap(ptr: *mut u8, size: usize) -> Result<(), KError> {
         // TODO: `ptr`'nin geçerli bir kullanıcı alanı pointer'ı ve görev'in adres alanında olduğunu doğrula.
@@ -751,6 +1290,111 @@ mod kmemory {
     }
 
 
+    // kernel_memory.h'deki KMEM_PAGE_* bayrakları
+    const KMEM_PAGE_WRITE: u32 = 1 << 1;
+    const KMEM_PAGE_EXEC: u32 = 1 << 2;
+    const KMEM_PAGE_USER: u32 = 1 << 3;
+    const KMEM_PAGE_NOCACHE: u32 = 1 << 4;
+
+    // Mimariden bağımsız KMEM_PAGE_* bayraklarını x86_64 sayfa bayraklarına çevirir.
+    fn page_flags_from_kmem(flags: u32) -> PageFlags {
+        let mut page_flags = PageFlags::new(0);
+        if flags & KMEM_PAGE_WRITE != 0 { page_flags = page_flags.with(PageFlags::WRITABLE); }
+        if flags & KMEM_PAGE_USER != 0 { page_flags = page_flags.with(PageFlags::USER_ACCESSIBLE); }
+        if flags & KMEM_PAGE_NOCACHE != 0 { page_flags = page_flags.with(PageFlags::CACHE_DISABLED); }
+        if flags & KMEM_PAGE_EXEC == 0 { page_flags = page_flags.with(PageFlags::NO_EXECUTE); }
+        page_flags
+    }
+
+    /// İkincil core'un MMU kurulumu (hardware_specific.h): CR4.PCIDE'yi bu core'da da açar.
+    /// Önyükleme core'u init_manager'da açar; karışık PCIDE yapılandırması desteklenmez.
+    #[no_mangle]
+    pub extern "C" fn low_level_mmu_cpu_init() {
+        if let Some(mmu) = unsafe { X86_MMU_MANAGER.as_ref() } {
+            unsafe { mmu.enable_pcid() };
+        }
+    }
+
+    /// Fiziksel olarak bitişik bir aralığı mevcut adres alanına haritalar (bkz. kernel_memory.h).
+    /// Hizalama izin verdiğinde X86MmuManager::map_range 1GB/2MB büyük sayfalar seçer.
+    #[no_mangle]
+    pub extern "C" fn kmem_virt_map_range(vaddr: u64, paddr: u64, size: usize, flags: u32) -> i64 {
+        if vaddr % PAGE_SIZE_4K != 0 || paddr % PAGE_SIZE_4K != 0 || size as u64 % PAGE_SIZE_4K != 0 {
+            return KError::InvalidArgument as i64;
+        }
+        let mmu = match unsafe { X86_MMU_MANAGER.as_ref() } { Some(m) => m, None => return KError::InternalError as i64 };
+        let allocator = match unsafe { GLOBAL_FRAME_ALLOCATOR.as_mut() } { Some(a) => a, None => return KError::InternalError as i64 };
+        let current_task_pml4_phys = get_current_task_pml4_phys(); // TODO: Task yöneticisinden al
+
+        match unsafe { mmu.map_range(current_task_pml4_phys, vaddr, paddr, size, page_flags_from_kmem(flags), allocator) } {
+            Ok(()) => 0,
+            Err(mmu_err) => map_mmu_error(mmu_err) as i64,
+        }
+    }
+
+    /// Mevcut adres alanında (CR3) sanal adresin fiziksel karşılığı; büyük sayfalarda sayfa içi ofset dahil.
+    /// Haritalı değilse 0 (bkz. kernel_memory.h).
+    #[no_mangle]
+    pub extern "C" fn kmem_virt_translate(vaddr: u64) -> u64 {
+        let mmu = match unsafe { X86_MMU_MANAGER.as_ref() } { Some(m) => m, None => return 0 };
+        let cr3: u64;
+        unsafe { core::arch::asm!("mov {}, cr3", out(reg) cr3, options(nomem, nostack, preserves_flags)); }
+        unsafe { mmu.translate_address(cr3 & PHYSICAL_ADDRESS_MASK_4K, vaddr) }.unwrap_or(0)
+    }
+
+    /// Sayfayı pager ile önceden kurar; hata yolundakiyle aynı çözüm (bkz. x86_handle_user_page_fault).
+    #[no_mangle]
+    pub extern "C" fn kmem_virt_fault_in(vaddr: u64, write: u32) -> i64 {
+        x86_handle_user_page_fault(vaddr, if write != 0 { PF_WRITE } else { 0 })
+    }
+
+    /// kmem_virt_map_range ile kurulmuş aralığın haritasını kaldırır; fiziksel frame'ler iade edilmez.
+    /// TLB aralık sonunda tek bir toplu işlemle temizlenir.
+    #[no_mangle]
+    pub extern "C" fn kmem_virt_unmap_range(vaddr: u64, size: usize) -> i64 {
+        if vaddr % PAGE_SIZE_4K != 0 || size as u64 % PAGE_SIZE_4K != 0 {
+            return KError::InvalidArgument as i64;
+        }
+        let mmu = match unsafe { X86_MMU_MANAGER.as_ref() } { Some(m) => m, None => return KError::InternalError as i64 };
+        let allocator = match unsafe { GLOBAL_FRAME_ALLOCATOR.as_mut() } { Some(a) => a, None => return KError::InternalError as i64 };
+        let current_task_pml4_phys = get_current_task_pml4_phys(); // TODO: Task yöneticisinden al
+
+        match unsafe { mmu.unmap_range(current_task_pml4_phys, vaddr, size, allocator) } {
+            Ok(()) => 0,
+            Err(mmu_err) => map_mmu_error(mmu_err) as i64,
+        }
+    }
+
+    /// Bir adres alanını yok eder (bkz. X86MmuManager::destroy_page_table). Sayfa başına TLB temizliği yapılmaz.
+    #[no_mangle]
+    pub extern "C" fn kmem_virt_destroy_address_space(address_space_id: u64) {
+        let mmu = match unsafe { X86_MMU_MANAGER.as_ref() } { Some(m) => m, None => return };
+        let allocator = match unsafe { GLOBAL_FRAME_ALLOCATOR.as_mut() } { Some(a) => a, None => return };
+        if address_space_id == 0 || address_space_id % PAGE_SIZE_4K != 0 {
+            return;
+        }
+        let mut batch = TlbBatch::all_cpus();
+        unsafe { mmu.destroy_page_table(address_space_id, allocator, &mut batch) };
+    }
+
+    /// Yeni bir adres alanı oluşturur ve PCID bağlamını kaydeder. Hata durumunda 0 döner.
+    #[no_mangle]
+    pub extern "C" fn kmem_virt_create_address_space() -> u64 {
+        let mmu = match unsafe { X86_MMU_MANAGER.as_ref() } { Some(m) => m, None => return 0 };
+        let allocator = match unsafe { GLOBAL_FRAME_ALLOCATOR.as_mut() } { Some(a) => a, None => return 0 };
+        unsafe { mmu.create_new_page_table(allocator) }.unwrap_or(0)
+    }
+
+    /// Mevcut core'da adres alanına geçer. Etiketli adres alanlarında TLB temizlenmez.
+    #[no_mangle]
+    pub extern "C" fn kmem_virt_activate_address_space(address_space_id: u64) {
+        let mmu = match unsafe { X86_MMU_MANAGER.as_ref() } { Some(m) => m, None => return };
+        if address_space_id == 0 || address_space_id % PAGE_SIZE_4K != 0 {
+            return;
+        }
+        unsafe { mmu.switch_page_table(address_space_id) };
+    }
+
     // MMU Hatalarını Karnal64 Hatalarına Çeviren Yardımcı Fonksiyon
     fn map_mmu_error(mmu_err: MmuError) -> KError {
         match mmu_err {
@@ -763,7 +1407,7 @@ mod kmemory {
     }
 
     // Diğer kmemory API fonksiyonlarını implemente edin...
-    // memory_release, shared_mem_create, shared_mem_map vb.
+    // shared_mem_create, shared_mem_map vb.
     // Hepsi X86MmuManager'ı ve GLOBAL_FRAME_ALLOCATOR'ı kullanmalıdır.
 
 }
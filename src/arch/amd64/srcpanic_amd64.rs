@@ -15,31 +15,23 @@ use core::fmt::Write;
 
 // --- Panik Anı Çıktısı İçin Temel Seri Port Yazıcısı (Mimariden Bağımsız Olmayan Kısım) ---
 // Panik anında, kernelin daha yüksek seviye kaynak yöneticisi (kresource) veya sürücüleri
-// tutarsız bir durumda olabilir. Bu yüzden, panik çıktısı için en temel, doğrudan donanım
-// erişimi sağlayan bir yöntem tercih edilir. Burada COM1 seri portuna doğrudan yazma kullanılıyor.
-// Bu, Karnal64'ün ResourceProvider traitini implement eden bir konsol sürücüsünden DAHA GÜVENLİDİR
-// panik sırasında.
+// tutarsız bir durumda olabilir. Bu yüzden panik çıktısı çekirdek konsolunun acil yolundan
+// (karnal_console_emergency_write) geçer: ilk çağrı CPU halkalarında bekleyen çıktıyı COM1'e
+// boşaltır, sonra her şey kilitsiz ve eşzamanlı yazılır (low_level_console_putc). Böylece panikten
+// önceki satırlar kaybolmaz ve panik metniyle karışmaz.
 
-// Standart COM1 port adresleri
-const COM1_PORT: u16 = 0x3F8;
+extern "C" {
+    fn karnal_console_emergency_write(buffer: *const u8, size: usize); // srcconsole.rs
+}
 
 // Panik çıktısı için seri porta yazan basit bir yapı
 struct PanicSerialWriter;
 
 impl PanicSerialWriter {
     // Seri porta tek bir byte gönderir.
-    // GÜVENLİK NOTU: Bu fonksiyon, doğrudan I/O port erişimi yaptığı için güvensizdir (`unsafe`).
-    // Sadece panik işleyicisi gibi kontrollü ve kritik ortamlarda kullanılmalıdır.
     #[inline(always)] // Küçük ve kritik olduğu için inline yapabiliriz.
     unsafe fn send(&mut self, byte: u8) {
-        // Vericinin boşalmasını bekle (Transmit Holding Register Empty)
-        // Status Port (COM1_PORT + 5), Bit 5 (0x20) THR Boş ise 1'dir.
-        while x86_64::inb(COM1_PORT + 5) & 0x20 == 0 {
-            // Çok sık kontrol etmemek için kısa bir duraklama eklenebilir
-            // veya bu while döngüsü çok hızlı olacağı için gerek olmayabilir.
-        }
-        // Byte'ı Data Port'a gönder
-        x86_64::outb(COM1_PORT, byte);
+        karnal_console_emergency_write(&byte, 1);
     }
 }
 
@@ -118,6 +110,9 @@ fn panic(info: &PanicInfo) -> ! {
     // Bu, panik sırasında daha fazla kesme veya yarış durumu oluşmasını engeller.
     unsafe { x86_64::cli(); }
 
+    // Konsol halkalarını boşalt ve konsolu eşzamanlı kipe al (panik metni bekleyen çıktıdan sonra gelir)
+    unsafe { karnal_console_emergency_write(core::ptr::null(), 0) };
+
     // 2. Panik mesajını ve detaylarını panik-safe konsol çıktısına yaz.
     panic_println!("\n--- KERNEL PANIC ---");
 
@@ -149,3 +149,543 @@ pub unsafe extern "C" fn x86_64_context_switch(
     // Gerçek bir kernelde bu fonksiyonun içi assembly koduyla doldurulacaktır.
      println!("Karnal64/x86: Bağlam Değiştirme Simülasyonu"); // Çekirdek içi print! gerektirir
 }
+
+// --- Zamanlayıcı Kancaları (hardware_specific.h, srcsched.rs) ---
+// Bağlam yığıtta tutulur: SysV ABI'nin koruduğu yazmaçlar (rbp, rbx, r12-r15) yığıta itilir ve yalnızca
+// rsp kaydedilir. Yeni iş parçacığının yığıtı, ilk geçişte x86_64_thread_trampoline'a "dönecek" şekilde kurulur;
+// trampolin r13'teki giriş fonksiyonunu r12'deki argümanla çağırır.
+
+core::arch::global_asm!(
+    ".global low_level_context_switch",
+    "low_level_context_switch:",
+    "push rbp",
+    "push rbx",
+    "push r12",
+    "push r13",
+    "push r14",
+    "push r15",
+    "mov [rdi], rsp",
+    "mov rsp, rsi",
+    "pop r15",
+    "pop r14",
+    "pop r13",
+    "pop r12",
+    "pop rbx",
+    "pop rbp",
+    "ret",
+    "",
+    ".global x86_64_thread_trampoline",
+    "x86_64_thread_trampoline:",
+    "mov rdi, r12",
+    "call r13",
+    "ud2",
+);
+
+extern "C" {
+    fn x86_64_thread_trampoline();
+}
+
+/// Yeni iş parçacığı yığıtını low_level_context_switch'in açacağı çerçeveyle hazırlar:
+/// r15, r14, r13 (entry), r12 (arg), rbx, rbp ve dönüş adresi (trampolin). `ret` sonrası rsp = stack_top
+/// (16 hizalı) olur, böylece trampolindeki `call` giriş fonksiyonuna ABI'nin beklediği hizalamayı verir.
+#[no_mangle]
+pub unsafe extern "C" fn low_level_thread_stack_init(stack_top: u64, entry: u64, arg: u64) -> u64 {
+    let frame = ((stack_top & !0xF) - 7 * 8) as *mut u64;
+    let values = [0, 0, entry, arg, 0, 0, x86_64_thread_trampoline as usize as u64];
+    for (i, value) in values.iter().enumerate() {
+        core::ptr::write(frame.add(i), *value);
+    }
+    frame as u64
+}
+
+const RFLAGS_IF: u64 = 1 << 9;
+
+#[no_mangle]
+pub extern "C" fn low_level_interrupt_save() -> u64 {
+    let rflags: u64;
+    unsafe { core::arch::asm!("pushfq", "pop {}", "cli", out(reg) rflags, options(preserves_flags)) };
+    rflags
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_interrupt_restore(state: u64) {
+    if state & RFLAGS_IF != 0 {
+        unsafe { core::arch::asm!("sti", options(nomem, nostack)) };
+    }
+}
+
+/// `sti` bir komutluk kesme gölgesi bıraktığından `sti; hlt` arasına kesme giremez; bekleyen kesme hlt'yi uyandırır.
+#[no_mangle]
+pub extern "C" fn low_level_cpu_idle_wait() {
+    unsafe { core::arch::asm!("sti", "hlt", "cli", options(nomem, nostack)) };
+}
+
+// --- CPU Numarası (hardware_specific.h) ---
+// Mantıksal CPU numarası IA32_TSC_AUX'ta tutulur ve RDTSCP ile okunur. GS tabanından farklı olarak kullanıcı
+// modundan gelen girişte swapgs'e bağlı değildir ve low_level_syscall_init'ten önce de geçerlidir.
+// Önyükleme CPU'su kernel_main'in başında, ikincil CPU'lar açılış yolunda x86_64_cpu_set_id çağırır.
+
+const IA32_TSC_AUX: u32 = 0xC000_0103;
+
+#[no_mangle]
+pub extern "C" fn x86_64_cpu_set_id(cpu: u32) {
+    use x86_64::registers::model_specific::Msr;
+    unsafe { Msr::new(IA32_TSC_AUX).write(cpu as u64) };
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_cpu_id() -> u32 {
+    let cpu: u32;
+    unsafe {
+        core::arch::asm!("rdtscp", out("ecx") cpu, out("eax") _, out("edx") _, options(nomem, nostack, preserves_flags));
+    }
+    cpu
+}
+
+// --- Açılış Arşivi (hardware_specific.h, srcinitrdfs.rs) ---
+// srcboot_amd64.S, EAX'teki Multiboot2 sihirli değerini doğruladıktan sonra EBX'teki bilgi yapısı adresini
+// boot_multiboot_info'ya yazar. Arşiv, yapıdaki ilk modül etiketidir.
+
+extern "C" {
+    static boot_multiboot_info: u64;
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn low_level_boot_initrd(phys_base: *mut u64, size: *mut u64) -> i64 {
+    let info = core::ptr::read_volatile(core::ptr::addr_of!(boot_multiboot_info));
+    match crate::kinitrd::find_in_multiboot2(info) {
+        Some((base, len)) => {
+            *phys_base = base;
+            *size = len;
+            0
+        }
+        None => KError::NotFound as i64,
+    }
+}
+
+// --- Boşta Durumları ve Performans Seviyesi (hardware_specific.h, srcdvfs.rs) ---
+// Boşta durumu numarası doğrudan MWAIT ipucudur (örn. 0x20: C6). MONITOR edilen satıra kimse yazmaz;
+// uyanma kesmeyle olur. `sti` gölgesi sayesinde `sti; mwait` arasına kesme giremez.
+// Durum tablosu önyükleme CPU'sunda x86_64_power_init ile CPUID leaf 5'ten çıkarılır: EDX'in n. dörtlüsü
+// MWAIT C(n) alt durum sayısıdır, ipucu (n - 1) << 4. CPUID gecikme vermez; tablodaki değerler muhafazakâr
+// üst sınırlardır. TODO: ACPI _CST okununca gecikmeler oradan alınmalı.
+//
+// Performans seviyesi HWP ile istenir (CPUID.06H:EAX[7]): IA32_HWP_REQUEST'in istenen alanı 0-1024 seviyesinin
+// IA32_HWP_CAPABILITIES'in en düşük-en yüksek aralığındaki karşılığıdır (yukarı yuvarlanır). MSR CPU'ya
+// özeldir: düzenleyici başka CPU için istediğinde seviye o CPU'nun bekleyen girdisine yazılır ve
+// performans IPI'ı (srcinterrupt_amd64.rs) gönderilir; hedef CPU isteği kendi işleyicisinde uygular.
+
+static MWAIT_LINE: [u64; 8] = [0; 8];
+
+const IA32_PM_ENABLE: u32 = 0x770;
+const IA32_HWP_CAPABILITIES: u32 = 0x771;
+const IA32_HWP_REQUEST: u32 = 0x774;
+const HWP_MAX_CPUS: usize = 32; // ksched::MAX_CPUS
+const NO_LEVEL: u32 = u32::MAX;
+
+// MWAIT C1..C7 için (çıkış gecikmesi, hedef yerleşim) ns
+const MWAIT_LATENCIES: [(u64, u64); 7] = [
+    (2_000, 2_000),
+    (10_000, 20_000),
+    (85_000, 200_000),
+    (124_000, 800_000),
+    (200_000, 800_000),
+    (480_000, 5_000_000),
+    (890_000, 5_000_000),
+];
+
+static HWP_SUPPORTED: core::sync::atomic::AtomicBool = core::sync::atomic::AtomicBool::new(false);
+// CPU başına uygulanmayı bekleyen seviye (NO_LEVEL: yok) ve HWP'nin o CPU'da açılıp açılmadığı
+static PERF_PENDING: [core::sync::atomic::AtomicU32; HWP_MAX_CPUS] =
+    [const { core::sync::atomic::AtomicU32::new(NO_LEVEL) }; HWP_MAX_CPUS];
+static PERF_ENABLED: [core::sync::atomic::AtomicBool; HWP_MAX_CPUS] =
+    [const { core::sync::atomic::AtomicBool::new(false) }; HWP_MAX_CPUS];
+
+extern "C" {
+    fn x86_64_send_performance_ipi(cpu: u32); // srcinterrupt_amd64.rs
+}
+
+/// Önyükleme CPU'sunda bir kez çağrılır (kernel_main): HWP desteğini saptar ve MWAIT boşta durumlarını
+/// kaydeder. CPUID tüm CPU'larda aynı varsayılır.
+#[no_mangle]
+pub extern "C" fn x86_64_power_init() {
+    use core::arch::x86_64::__cpuid;
+    let max_leaf = unsafe { __cpuid(0) }.eax;
+    if max_leaf >= 6 && unsafe { __cpuid(6) }.eax & (1 << 7) != 0 {
+        HWP_SUPPORTED.store(true, core::sync::atomic::Ordering::Release);
+    }
+    // MONITOR/MWAIT (CPUID.01H:ECX[3]) ve leaf 5 alt durum listesi (ECX[0])
+    if max_leaf < 5 || unsafe { __cpuid(1) }.ecx & (1 << 3) == 0 {
+        return;
+    }
+    let leaf5 = unsafe { __cpuid(5) };
+    if leaf5.ecx & 1 == 0 {
+        return;
+    }
+    let mut states = [crate::kdvfs::IdleState { id: 0, reserved: 0, exit_latency_ns: 0, target_residency_ns: 0 }; 7];
+    let mut count = 0;
+    for (index, &(exit_latency_ns, target_residency_ns)) in MWAIT_LATENCIES.iter().enumerate() {
+        // C0 dörtlüsü atlanır; C(index + 1)
+        if (leaf5.edx >> (4 * (index + 1))) & 0xF == 0 {
+            continue;
+        }
+        states[count] = crate::kdvfs::IdleState { id: (index as u32) << 4, reserved: 0, exit_latency_ns, target_residency_ns };
+        count += 1;
+    }
+    let _ = crate::kdvfs::register_idle_states(&states[..count]);
+}
+
+/// Çalışan CPU'nun bekleyen seviye isteğini IA32_HWP_REQUEST'e yazar. Kesmeler kapalı çağrılır
+/// (performans IPI işleyicisi veya low_level_cpu_set_performance).
+#[no_mangle]
+pub extern "C" fn x86_64_performance_apply() {
+    use core::sync::atomic::Ordering;
+    use x86_64::registers::model_specific::Msr;
+    let cpu = low_level_cpu_id() as usize;
+    let Some(pending) = PERF_PENDING.get(cpu) else { return };
+    let level = pending.swap(NO_LEVEL, Ordering::AcqRel);
+    if level == NO_LEVEL {
+        return;
+    }
+    unsafe {
+        // HWP açılmadan IA32_HWP_REQUEST yazmak #GP verir; açılış sıfırlamaya kadar geri alınamaz
+        if !PERF_ENABLED[cpu].swap(true, Ordering::Relaxed) {
+            Msr::new(IA32_PM_ENABLE).write(1);
+        }
+        let caps = Msr::new(IA32_HWP_CAPABILITIES).read();
+        let highest = caps & 0xFF;
+        let lowest = (caps >> 24) & 0xFF;
+        let range = highest.saturating_sub(lowest);
+        let desired = lowest + (range * level as u64 + 1023) / 1024;
+        // En düşük/en yüksek tüm aralık, istenen seviye ipucu; enerji tercihi ve pencere korunur
+        let request = Msr::new(IA32_HWP_REQUEST).read() & !0xFF_FFFF;
+        Msr::new(IA32_HWP_REQUEST).write(request | lowest | (highest << 8) | (desired << 16));
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_cpu_idle_enter(state: u32) {
+    unsafe {
+        core::arch::asm!("monitor", in("rax") MWAIT_LINE.as_ptr(), in("ecx") 0u32, in("edx") 0u32, options(nostack));
+        core::arch::asm!("sti", "mwait", "cli", in("eax") state, in("ecx") 0u32, options(nomem, nostack));
+    }
+}
+
+/// HWP yoksa NOT_SUPPORTED (düzenleyici durur; ACPI _PSS henüz okunmuyor). Başka CPU için istek IPI ile
+/// gönderilir ve hedef CPU onu işleyene kadar uygulanmamış olabilir.
+#[no_mangle]
+pub extern "C" fn low_level_cpu_set_performance(cpu: u32, level: u32) -> i64 {
+    if !HWP_SUPPORTED.load(core::sync::atomic::Ordering::Acquire) {
+        return KError::NotSupported as i64;
+    }
+    let Some(pending) = PERF_PENDING.get(cpu as usize) else {
+        return KError::InvalidArgument as i64;
+    };
+    pending.store(level.min(1024), core::sync::atomic::Ordering::Release);
+    // İş parçacığı kontrol ile yazma arasında başka CPU'ya taşınmamalı
+    let irq = low_level_interrupt_save();
+    if low_level_cpu_id() == cpu {
+        x86_64_performance_apply();
+    } else {
+        unsafe { x86_64_send_performance_ipi(cpu) };
+    }
+    low_level_interrupt_restore(irq);
+    0
+}
+
+// --- Hızlı Sistem Çağrısı Girişi (SYSCALL/SYSRET, hardware_specific.h, srcsyscall.rs) ---
+// SYSCALL, RIP'i rcx'e, RFLAGS'ı r11'e koyar ve yığıtı değiştirmez. Giriş stub'ı swapgs ile CPU'nun
+// SyscallCpu alanına erişir, kullanıcı rsp'sini orada geçici tutup iş parçacığının çekirdek yığıtına geçer.
+// Yığıta yalnızca dönüş durumu (rip, rflags, kullanıcı rsp) ve C çağrısının bozabileceği argüman yazmaçları
+// (rdi, rsi, rdx, r8, r9, r10) yazılır; rbx, rbp, r12-r15'i karnal_syscall_fast'in kendisi korur.
+// Kullanıcıya rax (sonuç) dışında tüm yazmaçlar korunmuş döner (rcx/r11 SYSCALL tanımı gereği bozulur).
+// Kayıtlı rip çekirdekte değiştirilmediği için SYSCALL'ın verdiği kanonik adrestir; sysretq güvenlidir.
+//
+// GDT düzeni STAR'ın gerektirdiği sıradadır: 0x08 çekirdek kod, 0x10 çekirdek veri, 0x18 kullanıcı veri,
+// 0x20 kullanıcı kod, 0x28 CPU'nun TSS'i. GDT ve TSS CPU başınadır ve low_level_syscall_init'te yüklenir.
+// Kullanıcı modundan gelen kesmeler yığıtı TSS.RSP0'dan alır; low_level_set_kernel_stack onu SyscallCpu ile
+// birlikte günceller. Çekirdekteyken GS tabanı SyscallCpu'yu gösterir: kullanıcıdan gelen her giriş
+// (SYSCALL stub'ı ve kesme işleyicileri, bkz. srcinterrupt_amd64.rs) ve kullanıcıya geçen her yol swapgs yapar.
+
+use x86_64::structures::gdt::{Descriptor, GlobalDescriptorTable};
+use x86_64::structures::tss::TaskStateSegment;
+
+const IA32_EFER: u32 = 0xC000_0080;
+const IA32_STAR: u32 = 0xC000_0081;
+const IA32_LSTAR: u32 = 0xC000_0082;
+const IA32_FMASK: u32 = 0xC000_0084;
+const IA32_GS_BASE: u32 = 0xC000_0101;
+const IA32_KERNEL_GS_BASE: u32 = 0xC000_0102;
+
+const EFER_SCE: u64 = 1 << 0;
+const KERNEL_CS: u64 = 0x08;
+const USER_BASE_SELECTOR: u64 = 0x10; // sysretq: SS = +8 | 3 (0x1B), CS = +16 | 3 (0x23)
+// Girişte temizlenen RFLAGS bitleri: TF, IF, DF, AC
+const SYSCALL_RFLAGS_MASK: u64 = (1 << 8) | RFLAGS_IF | (1 << 10) | (1 << 18);
+
+const MAX_CPUS: usize = 32; // ksched::MAX_CPUS
+
+/// CPU başına giriş alanı; ofsetler aşağıdaki stub ve low_level_set_kernel_stack ile EŞLEŞMELİDİR.
+#[repr(C, align(64))]
+struct SyscallCpu {
+    kernel_rsp: u64, // gs:[0] çalışan iş parçacığının çekirdek yığıtının tepesi
+    user_rsp: u64,   // gs:[8] girişte kullanıcı rsp'si için geçici yer
+    tss_rsp0: u64,   // gs:[16] bu CPU'nun TSS.RSP0 alanının adresi
+}
+
+// Yalnızca sahibi CPU tarafından (GS üzerinden veya low_level_syscall_init'te) yazılır
+static mut SYSCALL_CPUS: [SyscallCpu; MAX_CPUS] =
+    [const { SyscallCpu { kernel_rsp: 0, user_rsp: 0, tss_rsp0: 0 } }; MAX_CPUS];
+static mut CPU_GDTS: [GlobalDescriptorTable; MAX_CPUS] = [const { GlobalDescriptorTable::new() }; MAX_CPUS];
+static mut CPU_TSSS: [TaskStateSegment; MAX_CPUS] = [const { TaskStateSegment::new() }; MAX_CPUS];
+// TSS'teki RSP0 ofseti (4 byte ayrılmış alandan sonra)
+const TSS_RSP0_OFFSET: u64 = 4;
+
+core::arch::global_asm!(
+    ".global x86_64_syscall_entry",
+    "x86_64_syscall_entry:",
+    "swapgs",
+    "mov qword ptr gs:[8], rsp",
+    "mov rsp, qword ptr gs:[0]",
+    "push qword ptr gs:[8]",
+    "push r11",
+    "push rcx",
+    "push rdi",
+    "push rsi",
+    "push rdx",
+    "push r8",
+    "push r9",
+    "push r10",
+    "sti",
+    // C ABI: rdi, rsi, rdx, rcx, r8 = arg1..arg5, r9 = numara. 9 push + 8 ile yığıt 16 hizalı olur.
+    "mov rcx, r10",
+    "mov r9, rax",
+    "sub rsp, 8",
+    "call karnal_syscall_fast",
+    "add rsp, 8",
+    "cli",
+    "pop r10",
+    "pop r9",
+    "pop r8",
+    "pop rdx",
+    "pop rsi",
+    "pop rdi",
+    "pop rcx",
+    "pop r11",
+    "pop rsp",
+    "swapgs",
+    "sysretq",
+);
+
+extern "C" {
+    fn x86_64_syscall_entry();
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_syscall_init() {
+    use x86_64::registers::model_specific::Msr;
+    let cpu = (low_level_cpu_id() as usize).min(MAX_CPUS - 1);
+    unsafe {
+        let area = core::ptr::addr_of_mut!(SYSCALL_CPUS[cpu]);
+        // Önyükleme bağlamı: ilk iş parçacığı geçişine kadar mevcut yığıt kullanılır
+        let rsp: u64;
+        core::arch::asm!("mov {}, rsp", out(reg) rsp, options(nomem, nostack, preserves_flags));
+        (*area).kernel_rsp = rsp & !0xF;
+        load_cpu_gdt(cpu, rsp & !0xF);
+        (*area).tss_rsp0 = core::ptr::addr_of!(CPU_TSSS[cpu]) as u64 + TSS_RSP0_OFFSET;
+        Msr::new(IA32_GS_BASE).write(area as u64);
+        Msr::new(IA32_KERNEL_GS_BASE).write(0);
+        Msr::new(IA32_STAR).write((USER_BASE_SELECTOR << 48) | (KERNEL_CS << 32));
+        Msr::new(IA32_LSTAR).write(x86_64_syscall_entry as usize as u64);
+        Msr::new(IA32_FMASK).write(SYSCALL_RFLAGS_MASK);
+        let mut efer = Msr::new(IA32_EFER);
+        let value = efer.read();
+        efer.write(value | EFER_SCE);
+    }
+}
+
+// CPU'nun GDT'sini (STAR düzeni + TSS) kurar ve yükler; segment yazmaçları yeni seçicilerle yeniden yüklenir.
+unsafe fn load_cpu_gdt(cpu: usize, rsp0: u64) {
+    use x86_64::instructions::segmentation::{Segment, CS, DS, ES, SS};
+    use x86_64::instructions::tables::load_tss;
+    (*core::ptr::addr_of_mut!(CPU_TSSS[cpu])).privilege_stack_table[0] = x86_64::VirtAddr::new(rsp0);
+    let tss: &'static TaskStateSegment = &*core::ptr::addr_of!(CPU_TSSS[cpu]);
+    let gdt = &mut *core::ptr::addr_of_mut!(CPU_GDTS[cpu]);
+    let kernel_code = gdt.add_entry(Descriptor::kernel_code_segment()); // 0x08
+    let kernel_data = gdt.add_entry(Descriptor::kernel_data_segment()); // 0x10
+    gdt.add_entry(Descriptor::user_data_segment()); // 0x18
+    gdt.add_entry(Descriptor::user_code_segment()); // 0x20
+    let tss_selector = gdt.add_entry(Descriptor::tss_segment(tss)); // 0x28
+    gdt.load_unsafe();
+    CS::set_reg(kernel_code);
+    SS::set_reg(kernel_data);
+    DS::set_reg(kernel_data);
+    ES::set_reg(kernel_data);
+    load_tss(tss_selector);
+}
+
+/// Zamanlayıcı, kesmeler kapalıyken çağırır; çekirdekte olduğumuzdan GS bu CPU'nun alanını gösterir.
+/// SYSCALL yolunun yığıtı (gs:[0]) ve kullanıcı modundan gelen kesmelerin yığıtı (TSS.RSP0) birlikte güncellenir.
+#[no_mangle]
+pub extern "C" fn low_level_set_kernel_stack(stack_top: u64) {
+    unsafe {
+        core::arch::asm!(
+            "mov qword ptr gs:[0], {top}",
+            "mov {rsp0}, qword ptr gs:[16]",
+            "mov qword ptr [{rsp0}], {top}",
+            top = in(reg) stack_top,
+            rsp0 = out(reg) _,
+            options(nostack, preserves_flags),
+        );
+    }
+}
+
+/// Kullanıcı moduna ilk geçiş (task_spawn). iretq çerçevesi STAR düzenindeki kullanıcı seçicileriyle kurulur;
+/// swapgs GS tabanını kullanıcınınkine döndürür, SYSCALL girişi ve KernelGs yeniden değiştirir.
+/// RFLAGS yalnızca IF ve ayrılmış bit 1'dir.
+#[no_mangle]
+pub unsafe extern "C" fn low_level_enter_user(entry: u64, user_sp: u64, arg0: u64, arg1: u64) -> ! {
+    core::arch::asm!(
+        "cli",
+        "push 0x1b", // SS: kullanıcı veri | RPL 3
+        "push rdx",
+        "push 0x202",
+        "push 0x23", // CS: kullanıcı kod | RPL 3
+        "push rcx",
+        "swapgs",
+        "xor eax, eax",
+        "xor ebx, ebx",
+        "xor ecx, ecx",
+        "xor edx, edx",
+        "xor ebp, ebp",
+        "xor r8d, r8d",
+        "xor r9d, r9d",
+        "xor r10d, r10d",
+        "xor r11d, r11d",
+        "xor r12d, r12d",
+        "xor r13d, r13d",
+        "xor r14d, r14d",
+        "xor r15d, r15d",
+        "iretq",
+        in("rcx") entry,
+        in("rdx") user_sp,
+        in("rdi") arg0,
+        in("rsi") arg1,
+        options(noreturn),
+    );
+}
+
+// --- Tembel FPU/SIMD (hardware_specific.h, srcsched.rs) ---
+// CR0.TS açıkken ilk x87/SSE/AVX komutu #NM verir (srcexception_amd64.rs -> ksched_fpu_trap).
+// XSAVE varsa XCR0'da x87, SSE, AVX ve AVX-512 (opmask, ZMM_Hi256, Hi16_ZMM) bileşenlerinden desteklenenler
+// açılır ve kayıt XSAVEOPT ile (yoksa XSAVE) yapılır: ilk durumdaki (hiç kullanılmamış AVX-512 gibi) ve
+// son XRSTOR'dan beri değişmemiş bileşenler belleğe yazılmaz. XSAVE yoksa FXSAVE/FXRSTOR (512 byte).
+// Yalnızca kullanıcı durumu bileşenleri yönetildiğinden sıkıştırılmış biçim (XSAVES, IA32_XSS) gerekmez.
+
+const CR0_MP: u64 = 1 << 1;
+const CR0_EM: u64 = 1 << 2;
+const CR0_TS: u64 = 1 << 3;
+const CR0_NE: u64 = 1 << 5;
+const CR4_OSFXSR: u64 = 1 << 9;
+const CR4_OSXMMEXCPT: u64 = 1 << 10;
+const CR4_OSXSAVE: u64 = 1 << 18;
+const CPUID1_ECX_XSAVE: u32 = 1 << 26;
+const CPUID_D1_EAX_XSAVEOPT: u32 = 1 << 0;
+// x87 | SSE | AVX | opmask | ZMM_Hi256 | Hi16_ZMM (AMX gibi izin gerektiren bileşenler açılmaz)
+const XCR0_MANAGED: u64 = 0b1110_0111;
+const FXSAVE_AREA_SIZE: u64 = 512;
+// İlk durum: tüm x87/SIMD istisnaları maskeli
+const FCW_DEFAULT: u16 = 0x037F;
+const MXCSR_DEFAULT: u32 = 0x1F80;
+
+const FPU_FXSAVE: u8 = 0;
+const FPU_XSAVE: u8 = 1;
+const FPU_XSAVEOPT: u8 = 2;
+
+static FPU_MODE: core::sync::atomic::AtomicU8 = core::sync::atomic::AtomicU8::new(FPU_FXSAVE);
+static FPU_XCR0: core::sync::atomic::AtomicU64 = core::sync::atomic::AtomicU64::new(0);
+
+#[no_mangle]
+pub extern "C" fn low_level_fpu_cpu_init() -> u64 {
+    use core::arch::x86_64::__cpuid_count;
+    use core::sync::atomic::Ordering;
+    unsafe {
+        let mut cr0: u64;
+        core::arch::asm!("mov {}, cr0", out(reg) cr0, options(nomem, nostack, preserves_flags));
+        cr0 = (cr0 & !(CR0_EM | CR0_TS)) | CR0_MP | CR0_NE;
+        core::arch::asm!("mov cr0, {}", in(reg) cr0, options(nostack, preserves_flags));
+
+        let xsave = __cpuid_count(1, 0).ecx & CPUID1_ECX_XSAVE != 0;
+        let mut cr4: u64;
+        core::arch::asm!("mov {}, cr4", out(reg) cr4, options(nomem, nostack, preserves_flags));
+        cr4 |= CR4_OSFXSR | CR4_OSXMMEXCPT;
+        if xsave {
+            cr4 |= CR4_OSXSAVE;
+        }
+        core::arch::asm!("mov cr4, {}", in(reg) cr4, options(nostack, preserves_flags));
+
+        let size = if xsave {
+            let leaf = __cpuid_count(0xD, 0);
+            let xcr0 = (((leaf.edx as u64) << 32) | leaf.eax as u64) & XCR0_MANAGED;
+            core::arch::asm!("xsetbv", in("ecx") 0u32, in("eax") xcr0 as u32, in("edx") (xcr0 >> 32) as u32,
+                             options(nomem, nostack, preserves_flags));
+            FPU_XCR0.store(xcr0, Ordering::Relaxed);
+            let optimized = __cpuid_count(0xD, 1).eax & CPUID_D1_EAX_XSAVEOPT != 0;
+            FPU_MODE.store(if optimized { FPU_XSAVEOPT } else { FPU_XSAVE }, Ordering::Relaxed);
+            // EBX: XCR0'da açık bileşenler için standart biçim boyutu (XCR0 yazıldıktan sonra okunur)
+            __cpuid_count(0xD, 0).ebx as u64
+        } else {
+            FPU_MODE.store(FPU_FXSAVE, Ordering::Relaxed);
+            FXSAVE_AREA_SIZE
+        };
+        core::arch::asm!("fninit", options(nomem, nostack, preserves_flags));
+        low_level_fpu_disable();
+        size
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_fpu_enable() {
+    unsafe { core::arch::asm!("clts", options(nomem, nostack, preserves_flags)) };
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_fpu_disable() {
+    unsafe {
+        let cr0: u64;
+        core::arch::asm!("mov {}, cr0", out(reg) cr0, options(nomem, nostack, preserves_flags));
+        core::arch::asm!("mov cr0, {}", in(reg) cr0 | CR0_TS, options(nostack, preserves_flags));
+    }
+}
+
+/// Sıfırlanmış alan XSAVE başlığında XSTATE_BV = 0 taşır: XRSTOR tüm bileşenleri ilk duruma getirir,
+/// yalnızca MXCSR bellekten okunur. FXRSTOR için FCW de yazılır.
+#[no_mangle]
+pub unsafe extern "C" fn low_level_fpu_area_init(area: u64) {
+    core::ptr::write(area as *mut u16, FCW_DEFAULT);
+    core::ptr::write((area + 24) as *mut u32, MXCSR_DEFAULT);
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn low_level_fpu_save(area: u64) {
+    use core::sync::atomic::Ordering;
+    let xcr0 = FPU_XCR0.load(Ordering::Relaxed);
+    match FPU_MODE.load(Ordering::Relaxed) {
+        FPU_XSAVEOPT => core::arch::asm!("xsaveopt64 [{}]", in(reg) area, in("eax") xcr0 as u32,
+                                         in("edx") (xcr0 >> 32) as u32, options(nostack, preserves_flags)),
+        FPU_XSAVE => core::arch::asm!("xsave64 [{}]", in(reg) area, in("eax") xcr0 as u32,
+                                      in("edx") (xcr0 >> 32) as u32, options(nostack, preserves_flags)),
+        _ => core::arch::asm!("fxsave64 [{}]", in(reg) area, options(nostack, preserves_flags)),
+    }
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn low_level_fpu_restore(area: u64) {
+    use core::sync::atomic::Ordering;
+    let xcr0 = FPU_XCR0.load(Ordering::Relaxed);
+    match FPU_MODE.load(Ordering::Relaxed) {
+        FPU_FXSAVE => core::arch::asm!("fxrstor64 [{}]", in(reg) area, options(nostack, preserves_flags)),
+        _ => core::arch::asm!("xrstor64 [{}]", in(reg) area, in("eax") xcr0 as u32,
+                              in("edx") (xcr0 >> 32) as u32, options(nostack, preserves_flags)),
+    }
+}
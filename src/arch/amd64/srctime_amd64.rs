@@ -23,12 +23,13 @@ struct SystemTimeState {
      last_time_ns: AtomicU64, // Monotonic time in ns based on TSC and freq
 }
 
-// Use a static Mutex for the global time state, typical in kernels
-static SYSTEM_TIME: Mutex<SystemTimeState> = Mutex::new(SystemTimeState {
+// Alanlar atomik olduğundan kilit gerekmez: saat zamanlayıcı kesmesinden de okunur ve kesilen kod
+// bir kilit tutuyor olabilir.
+static SYSTEM_TIME: SystemTimeState = SystemTimeState {
     tsc_freq_hz: AtomicU64::new(0), // Needs calibration!
      last_tsc_read: AtomicU64::new(0),
      last_time_ns: AtomicU64::new(0),
-});
+};
 
 
 // --- Time Source Initialization ---
@@ -44,7 +45,11 @@ pub fn init() {
     // karşılaştırarak TSC'nin saniye başına kaç tick yaptığını bulma işlemidir.
     // Şimdilik 1GHz (1_000_000_000 Hz) varsayalım (yaygın bir değer ama doğru olmayabilir!)
     let assumed_tsc_freq_hz = 1_000_000_000; // placeholder - needs real calibration
-    SYSTEM_TIME.lock().tsc_freq_hz.store(assumed_tsc_freq_hz, Ordering::SeqCst);
+    SYSTEM_TIME.tsc_freq_hz.store(assumed_tsc_freq_hz, Ordering::SeqCst);
+
+    // Periyodik PIT/APIC tiki kurulmaz. Yerel APIC zamanlayıcısı TSC-deadline kipinde kullanılır
+    // (LVT Timer bit 18, vektör 32); kesme yalnızca low_level_timer_program ile verilen anda gelir.
+    // LVT Timer kaydı her CPU'da low_level_ipi_init'te, CPUID.01H:ECX[24] denetlenerek kurulur (srcinterrupt_amd64.rs).
 
 
     // TODO: ResourceProvider olarak bir timer cihazı kaydetmek istenirse burada yapılabilir.
@@ -67,8 +72,7 @@ pub fn get_monotonic_time_ns() -> u64 {
     #[cfg(target_arch = "x86_64")]
     {
         let tsc_ticks = Tsc::read(); // TSC sayacını oku
-        let state = SYSTEM_TIME.lock();
-        let freq = state.tsc_freq_hz.load(Ordering::SeqCst);
+        let freq = SYSTEM_TIME.tsc_freq_hz.load(Ordering::SeqCst);
 
         if freq == 0 {
             // Kalibrasyon yapılmamışsa veya hata varsa
@@ -100,6 +104,49 @@ pub fn get_monotonic_time_ns() -> u64 {
     }
 }
 
+// --- Tek Atımlık Zamanlayıcı Kancaları (hardware_specific.h, srctimer.rs tarafından kullanılır) ---
+
+// TSC-deadline kipinde yerel APIC, TSC bu değere ulaştığında tek bir kesme üretir; 0 yazmak kapatır.
+const IA32_TSC_DEADLINE: u32 = 0x6E0;
+
+#[no_mangle]
+pub extern "C" fn low_level_timer_now_ns() -> u64 {
+    get_monotonic_time_ns()
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_timer_program(deadline_ns: u64) {
+    let freq = SYSTEM_TIME.tsc_freq_hz.load(Ordering::Relaxed);
+    let tsc_deadline = if deadline_ns == u64::MAX || freq == 0 {
+        0
+    } else {
+        // Geçmişteki son tarih de en az 1 olur: TSC onu çoktan geçtiğinden kesme hemen gelir
+        ((deadline_ns as u128 * freq as u128) / 1_000_000_000).max(1) as u64
+    };
+    unsafe { x86_64::registers::model_specific::Msr::new(IA32_TSC_DEADLINE).write(tsc_deadline) };
+}
+
+// --- Paylaşımlı Zaman Sayfası Kancaları (srctimepage.rs) ---
+// rdtsc CR4.TSD temizken kullanıcı modunda çalışır. Kalibrasyon yapılınca crate::ktimepage::publish()
+// çağrılmalıdır; aksi halde kullanıcı alanı varsayılan frekansla hesaplar.
+
+const KARNAL_CLOCK_TSC: u32 = 1;
+
+#[no_mangle]
+pub extern "C" fn low_level_clock_source() -> u32 {
+    KARNAL_CLOCK_TSC
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_clock_frequency() -> u64 {
+    SYSTEM_TIME.tsc_freq_hz.load(Ordering::Relaxed)
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_clock_read() -> u64 {
+    Tsc::read()
+}
+
 // --- İsteğe Bağlı: ResourceProvider Implementasyonu (Örn: Bir Timer Cihazı) ---
 // Eğer çekirdek, kullanıcı alanına "zaman" veya "timer" gibi bir kaynağı
 // handle üzerinden sunmak isterse bu trait implemente edilebilir.
@@ -207,6 +207,25 @@ pub fn initialize_karnal64_from_dtb(dtb_info: ParsedDtbInfo) -> Result<(), KErro
 }
 
 
+// --- Açılış Arşivi (hardware_specific.h, srcinitrdfs.rs) ---
+// initialize_dtb_and_karnal64 DTB adresini kaydeder; arşiv /chosen düğümündeki "linux,initrd-start/end"
+// özellikleridir.
+
+static BOOT_DTB: core::sync::atomic::AtomicU64 = core::sync::atomic::AtomicU64::new(0);
+
+#[no_mangle]
+pub unsafe extern "C" fn low_level_boot_initrd(phys_base: *mut u64, size: *mut u64) -> i64 {
+    let dtb = BOOT_DTB.load(core::sync::atomic::Ordering::Acquire);
+    match crate::kinitrd::find_in_fdt(dtb) {
+        Some((base, len)) => {
+            *phys_base = base;
+            *size = len;
+            0
+        }
+        None => KError::NotFound as i64,
+    }
+}
+
 // --- Ana Başlatma Noktası (Karnal64 init tarafından çağrılır) ---
 
 /// Bootloader tarafından sağlanan DTB'yi ayrıştırır ve Karnal64'ü donanım
@@ -227,6 +246,7 @@ pub extern "C" fn initialize_dtb_and_karnal64(dtb_physical_address: u64, dtb_max
     // Veya, eğer çekirdek identity mapping kullanıyorsa, doğrudan erişim mümkün olabilir.
     // UNSAFE: Doğrudan fiziksel adrese erişim veya haritalama burada simüle ediliyor.
     let dtb_virtual_address = dtb_physical_address; // Identity mapping varsayımı
+    BOOT_DTB.store(dtb_virtual_address, core::sync::atomic::Ordering::Release);
 
     let dtb_ptr = dtb_virtual_address as *const u8;
 
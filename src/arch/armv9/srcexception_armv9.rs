@@ -7,6 +7,8 @@
 
 // Varsayımsal olarak Karnal64 API'mızın path'i bu şekilde olsun
 use crate::karnal64::{handle_syscall, KError}; // Kernel crate'inizdeki Karnal64 modülünü kullanın
+use crate::srcmmu_armv9; // Sayfa hatası çözümü (tembel sayfalar, COW)
+use crate::kpager::Access;
 
 // ARM Cortex-A/R mimarileri için özel yazmaçlara (register) erişim sağlayan crate'ler.
 // Gerçek bir implementasyonda cpu/register erişimi için `cortex-a` veya benzeri crate'ler
@@ -109,6 +111,10 @@ fn handle_svc_exception(tf: &mut TrapFrame) {
                              // ARM ABI'sinde dönüş değerleri genellikle x0'a konur.
 }
 
+// FSC kodlamaları (ESR_ELx.ISS[5:0]); alt iki bit hatanın oluştuğu tablo seviyesidir.
+fn is_translation_fault(fsc: u64) -> bool { fsc & 0b111100 == 0b000100 }
+fn is_permission_fault(fsc: u64) -> bool { fsc & 0b111100 == 0b001100 }
+
 /// EL0'dan gelen bir Veri Abort (Data Abort) istisnasını işler.
 /// (Örn: Geçersiz bellek erişimi - sayfa hatası dahil)
 fn handle_data_abort_from_el0(tf: &mut TrapFrame, esr_el1_val: u64) {
@@ -116,15 +122,20 @@ fn handle_data_abort_from_el0(tf: &mut TrapFrame, esr_el1_val: u64) {
     unsafe {
         // FAR_EL1'i oku (Hatanın meydana geldiği bellek adresi)
          asm!("mrs {}, far_el1", out(reg) far_el1_val);
-        far_el1_val = 0; // Mock değer
     }
 
     // ESR'den Fault Status Code (FSC) ve diğer bilgileri çıkar.
     let fsc = esr_el1_val & 0b111111;
 
-    // TODO: FSC'ye göre hatayı daha detaylı işle.
-    // Örneğin: 0b111100 (TLB Miss - sayfa hatası) -> Bellek yöneticisine yönlendir.
-    // 0b001101 (Permission Fault) -> İzin hatası, genellikle görevi sonlandır.
+    // Çeviri hatası (haritalanmamış tembel sayfa) veya izin hatası (salt okunur paylaşılan sayfaya yazma):
+    // pager (srcpager.rs) çözerse ELR_EL1 değişmeden dönülür ve komut yeniden çalışır.
+    // ISS.WnR (bit 6) yazma erişimini gösterir.
+    if is_translation_fault(fsc) || is_permission_fault(fsc) {
+        let access = if esr_el1_val & (1 << 6) != 0 { Access::Write } else { Access::Read };
+        if srcmmu_armv9::handle_page_fault(far_el1_val, access).is_ok() {
+            return;
+        }
+    }
 
     // Çok temel durumda sadece panik yapalım
     panic!("Veri Abort EL0->EL1! ESR_EL1: {:#x}, FAR_EL1: {:#x}, ELR_EL1: {:#x}", esr_el1_val, far_el1_val, tf.elr_el1);
@@ -137,12 +148,14 @@ fn handle_instruction_abort_from_el0(tf: &mut TrapFrame, esr_el1_val: u64) {
      let far_el1_val: u64;
     unsafe {
          asm!("mrs {}, far_el1", out(reg) far_el1_val); // Eğer geçerliyse
-        far_el1_val = 0; // Mock değer
     }
 
     let fsc = esr_el1_val & 0b111111;
 
-     // TODO: FSC'ye göre hatayı işle.
+    // Henüz yüklenmemiş kod sayfası: pager imaj önbelleğinden (paylaşılan frame) haritalar.
+    if is_translation_fault(fsc) && srcmmu_armv9::handle_page_fault(far_el1_val, Access::Execute).is_ok() {
+        return;
+    }
 
     // Çok temel durumda sadece panik yapalım
     panic!("Komut Abort EL0->EL1! ESR_EL1: {:#x}, FAR_EL1: {:#x}, ELR_EL1: {:#x}", esr_el1_val, far_el1_val, tf.elr_el1);
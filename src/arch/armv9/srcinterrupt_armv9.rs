@@ -83,7 +83,7 @@ vector_table:
 
     // Lower EL, AArch64 (Kullanıcı Alanından İstisnalar, Sistem Çağrıları Buradan Gelir)
     .align 7
-    b handle_sync_lower_el_aarch64 // <--- Sistem Çağrıları (SVC) Buraya Gelir
+    b svc_fast_lower_el_aarch64 // <--- Sistem Çağrıları (SVC) hızlı yoldan, diğerleri handle_sync_lower_el_aarch64'e
     .align 7
     b handle_irq_lower_el_aarch64   // <--- Donanım Kesmeleri (IRQ) Buraya Gelir
     .align 7
@@ -240,6 +240,59 @@ handle_serror_curr_el_spx:
     push_and_call_rust_handler handle_serror_curr_el_spx_rust
 
 
+// --- Hızlı Sistem Çağrısı Yolu (SVC64) ---
+// TrapFrame kurulmaz: yalnızca ELR/SPSR, SP_EL0/TPIDR_EL0 (iş parçacığı değişirse başka bir dönüş bunları
+// ezer), x30 ve C çağrısının bozabileceği x1-x18 kaydedilir; x19-x29'u karnal_syscall_fast korur. Numara x8'de,
+// argümanlar x0-x4'te gelir ve C ABI'sine göre numara x5'e taşınır. Kullanıcıya x0 (sonuç) dışında tüm
+// yazmaçlar korunmuş döner. SVC dışındaki senkron istisnalar tam çerçeveli yola gider.
+svc_fast_lower_el_aarch64:
+    stp x16, x17, [sp, #-16]!
+    mrs x16, esr_el1
+    lsr x17, x16, #26
+    cmp x17, #0x15 // EC: SVC (AArch64)
+    b.ne 1f
+    sub sp, sp, #176
+    stp x1, x2, [sp, #0]
+    stp x3, x4, [sp, #16]
+    stp x5, x6, [sp, #32]
+    stp x7, x8, [sp, #48]
+    stp x9, x10, [sp, #64]
+    stp x11, x12, [sp, #80]
+    stp x13, x14, [sp, #96]
+    stp x15, x18, [sp, #112]
+    mrs x16, elr_el1
+    mrs x17, spsr_el1
+    stp x30, x16, [sp, #128]
+    mrs x16, sp_el0
+    stp x17, x16, [sp, #144]
+    mrs x16, tpidr_el0
+    str x16, [sp, #160]
+    mov x5, x8
+    msr daifclr, #2
+    bl karnal_syscall_fast
+    msr daifset, #2
+    ldr x16, [sp, #160]
+    msr tpidr_el0, x16
+    ldp x17, x16, [sp, #144]
+    msr sp_el0, x16
+    ldp x30, x16, [sp, #128]
+    msr elr_el1, x16
+    msr spsr_el1, x17
+    ldp x15, x18, [sp, #112]
+    ldp x13, x14, [sp, #96]
+    ldp x11, x12, [sp, #80]
+    ldp x9, x10, [sp, #64]
+    ldp x7, x8, [sp, #48]
+    ldp x5, x6, [sp, #32]
+    ldp x3, x4, [sp, #16]
+    ldp x1, x2, [sp, #0]
+    add sp, sp, #176
+    ldp x16, x17, [sp], #16
+    eret
+1:
+    ldp x16, x17, [sp], #16
+    b handle_sync_lower_el_aarch64
+
 handle_sync_lower_el_aarch64:
     // Kullanıcı alanından senkron istisna (SVC, Data Abort, etc.)
     push_and_call_rust_handler handle_sync_lower_el_aarch64_rust // <--- Sistem Çağrısı İşleyicimiz
@@ -382,6 +435,13 @@ extern "C" fn handle_sync_lower_el_aarch64_rust(frame: &mut TrapFrame) {
             frame.x[0] = result as u64; // i64'ü u64'e çevirirken dikkatli olun (negatif değerler için)
                                         // KError değerleri zaten negatif i64 olduğu için bu dönüşüm doğrudur.
         }
+        0b000111 | 0b011001 => { // EC: FP/ASIMD veya SVE erişimi CPACR_EL1 ile tuzağa düştü
+            // Tembel FPU (srcsched.rs): durum yüklenir ve FPU açılır; eret komutu yeniden çalıştırır.
+            extern "C" {
+                fn ksched_fpu_trap();
+            }
+            unsafe { ksched_fpu_trap() };
+        }
         0b100000 | 0b100001 => { // Instruction Abort from Lower EL
             // Kullanıcı alanında geçersiz talimat
              println!("Kullanıcı Alanı Hatası: Geçersiz talimat! ELR: {:#x}", frame.elr_el1);
@@ -14,6 +14,9 @@ use core::arch::asm;
 use alloc::vec::Vec;
 use alloc::boxed::Box; // SharedMemObject gibi yapıları heap'te tutmak için
 use core::sync::atomic::{AtomicU64, Ordering}; // Basit sayaçlar veya handle üretimi için
+use crate::kasid::{AsidAllocator, AddressSpaceTable}; // ASID dağıtımı (srcasid.rs)
+use crate::kpager::{self, Access, FaultMmu}; // Tembel sayfalar ve COW (srcpager.rs)
+use crate::karnal64::KError as KarnalError; // Pager arayüzünün hata tipi
 
 // Karnal64 core tiplerini burada yeniden tanımlıyoruz veya erişilebilir varsayıyoruz.
 // Gerçek projede 'use crate::karnal64::...' şeklinde dahil edilmelidir.
@@ -122,6 +125,10 @@ const L3_INDEX_SHIFT: usize = PAGE_SIZE_BITS;                              // 12
 
 const INDEX_MASK: usize = PAGE_TABLE_ENTRIES - 1; // 511 (0b111111111)
 
+// Blok tanımlayıcılarının kapsadığı boyutlar (4KB granül ile)
+const L1_BLOCK_SIZE: usize = 1 << L1_INDEX_SHIFT; // 1GB
+const L2_BLOCK_SIZE: usize = 1 << L2_INDEX_SHIFT; // 2MB
+
 // Bir sayfa tablosu seviyesini temsil eden yapı (sadece 64-bit girdilerin dizisi)
 #[repr(align(4096))] // Sayfa tabloları 4KB'ye hizalanmalıdır (ARMv8-A kısıtlaması)
 #[derive(Copy, Clone)] // Kopyalanabilir olması init gibi durumlar için pratik
@@ -180,6 +187,7 @@ mod pte_flags {
     pub const SH_INNER: u64   = 3 << 8; // İç Paylaşılabilir (eşevreli bellek için)
 
     pub const AF: u64         = 1 << 10; // Erişim Bayrağı (Donanım tarafından ilk erişimde ayarlanır)
+    pub const NG: u64         = 1 << 11; // Not Global (sayfa/blok için): TLB girdisi ASID ile etiketlenir
     pub const NSTABLE: u64    = 1 << 11; // Güvenli olmayan tablo (tablo tanımlayıcıları için)
 
     // Yürütme İzinleri (PXN, UXN)
@@ -187,9 +195,10 @@ mod pte_flags {
     pub const UXN: u64        = 1 << 54; // Unprivileged Execute Never (EL0'da asla yürütme)
 
     // Kullanıcı veri sayfaları için yaygın bayrakların kombinasyonu
-    pub const USER_DATA_FLAGS: u64 = VALID | PAGE | ATTR_INDEX_1_CACHED | AP_EL1_RW_EL0_RW | SH_INNER | AF | UXN;
+    // Kullanıcı sayfaları NG taşır: aksi halde global sayılır ve ASID'ler arasında paylaşılırdı.
+    pub const USER_DATA_FLAGS: u64 = VALID | PAGE | ATTR_INDEX_1_CACHED | AP_EL1_RW_EL0_RW | SH_INNER | AF | NG | UXN;
      // Kullanıcı yürütülebilir kod sayfaları için yaygın bayrakların kombinasyonu
-    pub const USER_CODE_FLAGS: u64 = VALID | PAGE | ATTR_INDEX_1_CACHED | AP_EL1_RW_EL0_RO | SH_INNER | AF | PXN; // EL0 Salt Okunur, EL1 Okuma/Yazma, PXN
+    pub const USER_CODE_FLAGS: u64 = VALID | PAGE | ATTR_INDEX_1_CACHED | AP_EL1_RW_EL0_RO | SH_INNER | AF | NG | PXN; // EL0 Salt Okunur, EL1 Okuma/Yazma, PXN
      // Cihaz belleği için yaygın bayrakların kombinasyonu
     pub const DEVICE_FLAGS: u64 = VALID | PAGE | ATTR_INDEX_0_NOCACHE | AP_EL1_RW_EL0_NO | SH_OUTER | AF | PXN | UXN; // EL1 R/W, EL0 No, önbelleklenemez, yürütülemez
 }
@@ -277,6 +286,54 @@ impl VmspaceAllocator {
 static mut SINGLE_USER_PAGE_TABLE: Option<*mut PageTable> = None;
 static mut SINGLE_USER_VA_ALLOCATOR: VmspaceAllocator = VmspaceAllocator::new_with_range(VmspaceAllocator::USER_VA_START, VmspaceAllocator::USER_VA_END);
 
+// Kullanıcı adres alanlarının ASID'leri. Genişlik init_manager'da ID_AA64MMFR0_EL1'den okunur.
+// ASID, TTBR0_EL1[63:48] alanında sayfa tablosu köküyle birlikte yüklenir (TCR_EL1.A1 = 0).
+static ARM_ASIDS: AsidAllocator = AsidAllocator::new(0);
+static ARM_ADDRESS_SPACES: AddressSpaceTable = AddressSpaceTable::new();
+const TTBR_ASID_SHIFT: u64 = 48;
+
+extern "C" {
+    fn low_level_cpu_id() -> u32;
+}
+
+// ktlb'nin (srctlb.rs) kullandığı yerel TLB kancaları (hardware_specific.h).
+// Yalnızca çalışan çekirdeği etkileyen (IS olmayan) biçimler: diğer çekirdekler ktlb IPI'ı ile temizlenir.
+// ASID 0: etiketsiz/çekirdek adresi, tüm ASID'lerde temizlenir.
+#[no_mangle]
+pub extern "C" fn low_level_tlb_flush_page(vaddr: u64, asid: u16) {
+    let page = (vaddr >> 12) & 0xFFF_FFFF_FFFF;
+    unsafe {
+        if asid == 0 {
+            asm!("dsb nshst", "tlbi vaae1, {}", "dsb nsh", "isb", in(reg) page, options(nostack, preserves_flags));
+        } else {
+            let operand = page | ((asid as u64) << TTBR_ASID_SHIFT);
+            asm!("dsb nshst", "tlbi vae1, {}", "dsb nsh", "isb", in(reg) operand, options(nostack, preserves_flags));
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_tlb_flush_asid(asid: u16) {
+    if asid == 0 {
+        low_level_tlb_flush_all();
+        return;
+    }
+    unsafe {
+        asm!("dsb nshst", "tlbi aside1, {}", "dsb nsh", "isb", in(reg) (asid as u64) << TTBR_ASID_SHIFT,
+             options(nostack, preserves_flags));
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_tlb_flush_all() {
+    unsafe { asm!("dsb nshst", "tlbi vmalle1", "dsb nsh", "isb", options(nostack, preserves_flags)); }
+}
+
+// CPU'ya özel MMU kurulumu (hardware_specific.h). ASID genişliği tüm çekirdeklerde aynıdır ve TCR_EL1
+// açılış yolunda yazılır; burada ek bir şey yapılmaz.
+#[no_mangle]
+pub extern "C" fn low_level_mmu_cpu_init() {}
+
 // ktask modülünün bir kısmıymış gibi davranan yer tutucu.
 mod ktask {
     use super::*;
@@ -291,6 +348,8 @@ mod ktask {
                      // volatile yazma kullanarak derleyicinin yazmayı optimize etmediğinden emin ol.
                      ptr::write_volatile(pt_ptr, PageTable::new()); // Sıfırlarla başlat
                      SINGLE_USER_PAGE_TABLE = Some(pt_ptr);
+                     // Tablo doluysa adres alanı etiketsiz (ASID 0) çalışır
+                     let _ = ARM_ADDRESS_SPACES.register(pt_ptr as u64);
                       println!("Allocated initial user page table at {:p}", pt_ptr);
                  } else {
                       println!("Failed to allocate initial user page table!");
@@ -317,13 +376,29 @@ mod ktask {
 
      // Başka bir görevin sayfa tablosuna geçiş yapan yer tutucu.
      // Zamanlayıcı bağlam değiştirirken çağırır.
+     // Kayıtlı adres alanları kendi ASID'leriyle yüklenir ve TLB temizlenmez; yalnızca ASID nesli
+     // döndüğünde bu CPU'nun TLB'si bir kez tamamen temizlenir. Etiketsiz adres alanları ASID 0'ı
+     // paylaştığından geçişte ASID 0 girdileri temizlenir.
      pub fn switch_to_task_page_table(l1_table_phys_addr: u64) {
+         let (asid, flush_all) = match ARM_ADDRESS_SPACES.lookup(l1_table_phys_addr) {
+             Some(ctx) => {
+                 let switch = ARM_ASIDS.switch_to(ctx, unsafe { low_level_cpu_id() } as usize);
+                 (switch.asid, switch.flush_all)
+             }
+             None => (0, false),
+         };
          unsafe {
-             // ARM sistem registerına (TTBR0_EL1) yeni L1 sayfa tablosunun fiziksel adresini yaz.
+             // ARM sistem registerına (TTBR0_EL1) yeni L1 sayfa tablosunun fiziksel adresini ve ASID'ini yaz.
              // Bu, CPU'nun bundan sonra bu sayfa tablosunu kullanmasını sağlar.
-              println!("Switching TTBR0_EL1 to {:x}", l1_table_phys_addr);
-              asm!("msr ttbr0_el1, {}", in(reg) l1_table_phys_addr);
+              let ttbr0 = l1_table_phys_addr | ((asid as u64) << TTBR_ASID_SHIFT);
+              asm!("msr ttbr0_el1, {}", in(reg) ttbr0);
               asm!("isb"); // Talimat Senkronizasyon Bariyeri
+              if flush_all {
+                  // Yeni ASID nesli: bu CPU'daki eski nesle ait tüm girdileri at (yalnızca yerel)
+                  asm!("tlbi vmalle1", "dsb nsh", "isb", options(nostack, preserves_flags));
+              } else if asid == 0 {
+                  asm!("tlbi aside1, {}", "dsb nsh", "isb", in(reg) 0u64, options(nostack, preserves_flags));
+              }
          }
      }
 }
@@ -410,6 +485,7 @@ fn walk_page_table_mut(l1_table_ptr: *mut PageTable, virt_addr: usize, create_if
 }
 
 // Belirtilen sanal adres için sayfa tablosunu yürür ve L3 girdi değerini döner (salt okunur).
+// Adres bir L1/L2 blok tanımlayıcısı ile kapsanıyorsa o blok girdisini döner.
 // Haritalı değilse KError::BadAddress döner.
 fn lookup_page(l1_table_ptr: *mut PageTable, virt_addr: usize) -> Result<u64, KError> {
     if virt_addr % PAGE_SIZE != 0 { return Err(KError::AddressNotPageAligned); }
@@ -426,8 +502,11 @@ fn lookup_page(l1_table_ptr: *mut PageTable, virt_addr: usize) -> Result<u64, KE
     let l1_entry = l1_table.entry(l1_index).copied().ok_or(KError::BadAddress)?; // L1 girdisini oku
 
     // L1 girdisi geçerli ve bir tabloya mı işaret ediyor?
-    if (l1_entry & pte_flags::VALID) == 0 || (l1_entry & pte_flags::TABLE) == 0 {
-        return Err(KError::BadAddress); // L1 girdisi geçersiz veya tablo değil
+    if (l1_entry & pte_flags::VALID) == 0 {
+        return Err(KError::BadAddress); // L1 girdisi geçersiz
+    }
+    if (l1_entry & pte_flags::TABLE) == 0 {
+        return Ok(l1_entry); // 1GB blok: adres haritalı
     }
 
     let l2_table_phys_addr = l1_entry & !((PAGE_SIZE as u64) - 1);
@@ -436,8 +515,11 @@ fn lookup_page(l1_table_ptr: *mut PageTable, virt_addr: usize) -> Result<u64, KE
     let l2_entry = l2_table.entry(l2_index).copied().ok_or(KError::BadAddress)?; // L2 girdisini oku
 
      // L2 girdisi geçerli ve bir tabloya mı işaret ediyor?
-     if (l2_entry & pte_flags::VALID) == 0 || (l2_entry & pte_flags::TABLE) == 0 {
-        return Err(KError::BadAddress); // L2 girdisi geçersiz veya tablo değil
+     if (l2_entry & pte_flags::VALID) == 0 {
+        return Err(KError::BadAddress); // L2 girdisi geçersiz
+    }
+    if (l2_entry & pte_flags::TABLE) == 0 {
+        return Ok(l2_entry); // 2MB blok: adres haritalı
     }
 
     let l3_table_phys_addr = l2_entry & !((PAGE_SIZE as u64) - 1);
@@ -532,6 +614,180 @@ fn unmap_page(l1_table_ptr: *mut PageTable, virt_addr: usize) -> Result<*mut u8,
 }
 
 
+// Blok tanımlayıcısının yazılacağı L1 (1GB) veya L2 (2MB) girdisine işaretçi döner.
+// `create_if_missing` true ise 2MB blok için eksik L2 tablosu oluşturulur.
+fn walk_to_block_entry(l1_table_ptr: *mut PageTable, virt_addr: usize, block_size: usize, create_if_missing: bool) -> Result<*mut u64, KError> {
+    let l1_index = (virt_addr >> L1_INDEX_SHIFT) & INDEX_MASK;
+    let l1_table = unsafe { &mut *l1_table_ptr };
+    let l1_entry_ptr = l1_table.entry_mut(l1_index).ok_or(KError::InternalError)? as *mut u64;
+    if block_size == L1_BLOCK_SIZE {
+        return Ok(l1_entry_ptr);
+    }
+
+    let l1_entry = unsafe { ptr::read_volatile(l1_entry_ptr) };
+    let l2_table_ptr: *mut PageTable;
+    if (l1_entry & pte_flags::VALID) == 0 {
+        if !create_if_missing { return Err(KError::BadAddress); }
+        let l2_table_frame = pfa::allocate_frame().ok_or(KError::OutOfMemory)?;
+        l2_table_ptr = l2_table_frame as *mut PageTable;
+        unsafe { ptr::write_volatile(l2_table_ptr, PageTable::new()); }
+        let new_l1_entry = (l2_table_frame as u64) | pte_flags::TABLE | pte_flags::VALID | pte_flags::NON_SECURE | pte_flags::NSTABLE;
+        unsafe { ptr::write_volatile(l1_entry_ptr, new_l1_entry); }
+        unsafe { asm!("dsb ishst", options(nostack, preserves_flags)); }
+    } else if (l1_entry & pte_flags::TABLE) == 0 {
+        // Adres zaten bir 1GB blok içinde
+        return Err(KError::AlreadyExists);
+    } else {
+        l2_table_ptr = (l1_entry & !((PAGE_SIZE as u64) - 1)) as *mut PageTable;
+    }
+
+    let l2_index = (virt_addr >> L2_INDEX_SHIFT) & INDEX_MASK;
+    let l2_table = unsafe { &mut *l2_table_ptr };
+    Ok(l2_table.entry_mut(l2_index).ok_or(KError::InternalError)? as *mut u64)
+}
+
+// Fiziksel olarak bitişik bir bölgeyi tek bir blok tanımlayıcısı ile haritalar.
+// `block_size` L1_BLOCK_SIZE (1GB) veya L2_BLOCK_SIZE (2MB) olmalı; adresler bu boyuta hizalı olmalıdır.
+// `flags` sayfa bayraklarıyla aynıdır (örn. USER_DATA_FLAGS); PAGE biti blok tanımlayıcısı için temizlenir.
+fn map_block(l1_table_ptr: *mut PageTable, virt_addr: usize, phys_addr: usize, block_size: usize, flags: u64) -> Result<(), KError> {
+    if block_size != L1_BLOCK_SIZE && block_size != L2_BLOCK_SIZE {
+        return Err(KError::InvalidArgument);
+    }
+    if virt_addr % block_size != 0 || phys_addr % block_size != 0 {
+        return Err(KError::AddressNotPageAligned);
+    }
+
+    let entry_ptr = walk_to_block_entry(l1_table_ptr, virt_addr, block_size, true)?;
+    // Geçerli bir girdi (blok ya da alt tablo) varsa üzerine yazmak "break-before-make" kuralını
+    // çiğner ve alt tablodaki eşlemeleri sızdırır.
+    if (unsafe { ptr::read_volatile(entry_ptr) } & pte_flags::VALID) != 0 {
+        return Err(KError::AlreadyExists);
+    }
+
+    let new_entry = (phys_addr as u64) | (flags & !pte_flags::TABLE) | pte_flags::VALID;
+    unsafe { ptr::write_volatile(entry_ptr, new_entry); }
+
+    unsafe { asm!("dsb ishst", options(nostack, preserves_flags)); }
+    unsafe { asm!("tlbi vaa, {}", in(reg) virt_addr, options(nostack, preserves_flags)); }
+    unsafe { asm!("dsb ish", options(nostack, preserves_flags)); }
+    unsafe { asm!("isb", options(nostack, preserves_flags)); }
+
+    Ok(())
+}
+
+// Bir blok tanımlayıcısını kaldırır. Fiziksel belleği serbest BIRAKMAZ, blok başlangıç adresini döner.
+fn unmap_block(l1_table_ptr: *mut PageTable, virt_addr: usize, block_size: usize) -> Result<*mut u8, KError> {
+    if block_size != L1_BLOCK_SIZE && block_size != L2_BLOCK_SIZE {
+        return Err(KError::InvalidArgument);
+    }
+    if virt_addr % block_size != 0 { return Err(KError::AddressNotPageAligned); }
+
+    let entry_ptr = walk_to_block_entry(l1_table_ptr, virt_addr, block_size, false)?;
+    let entry = unsafe { ptr::read_volatile(entry_ptr) };
+    if (entry & pte_flags::VALID) == 0 || (entry & pte_flags::TABLE) != 0 {
+        return Err(KError::BadAddress); // Bu seviyede blok yok
+    }
+
+    unsafe { ptr::write_volatile(entry_ptr, 0); }
+
+    unsafe { asm!("dsb ishst", options(nostack, preserves_flags)); }
+    unsafe { asm!("tlbi vaa, {}", in(reg) virt_addr, options(nostack, preserves_flags)); }
+    unsafe { asm!("dsb ish", options(nostack, preserves_flags)); }
+    unsafe { asm!("isb", options(nostack, preserves_flags)); }
+
+    Ok((entry & !((block_size as u64) - 1) & 0x0000_FFFF_FFFF_F000) as *mut u8)
+}
+
+// Hizalama ve kalan boyutun izin verdiği en büyük eşleme boyutunu seçer (1GB, 2MB veya 4KB).
+fn best_mapping_size(virt_addr: usize, phys_addr: usize, remaining: usize) -> usize {
+    for &size in &[L1_BLOCK_SIZE, L2_BLOCK_SIZE] {
+        if remaining >= size && virt_addr % size == 0 && phys_addr % size == 0 {
+            return size;
+        }
+    }
+    PAGE_SIZE
+}
+
+// `block_size`'lık blok tanımlayıcısının yazılacağı girdi bir alt tabloyu gösteriyorsa true döner.
+// Eksik tablolar oluşturulmaz.
+fn block_slot_is_table(l1_table_ptr: *mut PageTable, virt_addr: usize, block_size: usize) -> bool {
+    match walk_to_block_entry(l1_table_ptr, virt_addr, block_size, false) {
+        Ok(entry_ptr) => {
+            let entry = unsafe { ptr::read_volatile(entry_ptr) };
+            (entry & pte_flags::VALID) != 0 && (entry & pte_flags::TABLE) != 0
+        }
+        Err(_) => false,
+    }
+}
+
+// Fiziksel olarak bitişik bir aralığı (`phys_addr`..+`size`) sanal aralığa haritalar.
+// Mümkün olan her yerde blok tanımlayıcıları kullanılır; bu, büyük çekirdek ve aygıt
+// alanlarında TLB giriş sayısını ve sayfa tablosu yürüme derinliğini azaltır.
+// Altında zaten bir tablo bulunan (kısmen dolu) bloklar 4KB sayfalarla doldurulur.
+pub fn map_range(l1_table_ptr: *mut PageTable, virt_addr: usize, phys_addr: usize, size: usize, flags: u64) -> Result<(), KError> {
+    if virt_addr % PAGE_SIZE != 0 || phys_addr % PAGE_SIZE != 0 || size % PAGE_SIZE != 0 {
+        return Err(KError::AddressNotPageAligned);
+    }
+
+    let mut offset = 0;
+    while offset < size {
+        let va = virt_addr + offset;
+        let pa = phys_addr + offset;
+        let mut step = best_mapping_size(va, pa, size - offset);
+        // Altında zaten bir tablo olan (kısmen dolu) yuvaya blok yazılamaz; bir alt boyuta in.
+        while step != PAGE_SIZE && block_slot_is_table(l1_table_ptr, va, step) {
+            step = if step == L1_BLOCK_SIZE { L2_BLOCK_SIZE } else { PAGE_SIZE };
+        }
+        if step == PAGE_SIZE {
+            map_page(l1_table_ptr, va, pa as *mut u8, flags)?;
+        } else {
+            map_block(l1_table_ptr, va, pa, step, flags)?;
+        }
+        offset += step;
+    }
+    Ok(())
+}
+
+// `map_range` ile kurulmuş bir aralığın haritalamasını kaldırır. Fiziksel belleği serbest BIRAKMAZ.
+// Aralığın yalnızca bir kısmını kaplayan bloklar parçalanmaz; bu durumda InvalidArgument döner.
+pub fn unmap_range(l1_table_ptr: *mut PageTable, virt_addr: usize, size: usize) -> Result<(), KError> {
+    if virt_addr % PAGE_SIZE != 0 || size % PAGE_SIZE != 0 {
+        return Err(KError::AddressNotPageAligned);
+    }
+
+    let end = virt_addr + size;
+    let mut va = virt_addr;
+    while va < end {
+        let step = mapping_size_at(l1_table_ptr, va)?;
+        if step == PAGE_SIZE {
+            unmap_page(l1_table_ptr, va)?;
+        } else {
+            if va % step != 0 || end - va < step {
+                return Err(KError::InvalidArgument);
+            }
+            unmap_block(l1_table_ptr, va, step)?;
+        }
+        va += step;
+    }
+    Ok(())
+}
+
+// `virt_addr`'ı kapsayan eşlemenin boyutunu döner: 1GB/2MB blok veya L3 tablosu altında 4KB.
+fn mapping_size_at(l1_table_ptr: *mut PageTable, virt_addr: usize) -> Result<usize, KError> {
+    let l1_table = unsafe { &*l1_table_ptr };
+    let l1_entry = l1_table.entry((virt_addr >> L1_INDEX_SHIFT) & INDEX_MASK).copied().ok_or(KError::BadAddress)?;
+    if (l1_entry & pte_flags::VALID) == 0 { return Err(KError::BadAddress); }
+    if (l1_entry & pte_flags::TABLE) == 0 { return Ok(L1_BLOCK_SIZE); }
+
+    let l2_table = unsafe { &*((l1_entry & !((PAGE_SIZE as u64) - 1)) as *const PageTable) };
+    let l2_entry = l2_table.entry((virt_addr >> L2_INDEX_SHIFT) & INDEX_MASK).copied().ok_or(KError::BadAddress)?;
+    if (l2_entry & pte_flags::VALID) == 0 { return Err(KError::BadAddress); }
+    if (l2_entry & pte_flags::TABLE) == 0 { return Ok(L2_BLOCK_SIZE); }
+
+    Ok(PAGE_SIZE)
+}
+
+
 // --- Karnal64 kmemory API Implementasyonları (srcmmu_arm.rs içinde) ---
 
 // Bu `init_manager` fonksiyonu `karnal64::init()` tarafından çağrılacaktır.
@@ -568,6 +824,16 @@ pub fn init_manager(physical_memory_start: usize, physical_memory_size: usize) {
         // Tam bir TCR_EL1 değeri diğer alanları (T1SZ, EPD1, IPS, AS, TBI, vb.) ayarlamayı gerektirir.
         // Basitlik için demo VA aralığı için temel ayarların yeterli olduğunu varsayalım.
          TCR_EL1 = (25 << 0) | (1 << 8) | (1 << 10) | (3 << 12) | (0 << 14); // Kavramsal değer
+
+        // ASID genişliği: ID_AA64MMFR0_EL1.ASIDBits (bit [7:4]) 0b0010 ise 16 bit, değilse 8 bit.
+        // 16 bit için TCR_EL1.AS (bit 36) set edilmelidir. A1 = 0: ASID TTBR0_EL1'den alınır.
+        let mmfr0: u64;
+        asm!("mrs {}, id_aa64mmfr0_el1", out(reg) mmfr0, options(nomem, nostack, preserves_flags));
+        let asid_bits = if (mmfr0 >> 4) & 0xF == 0b0010 { 16 } else { 8 };
+        if asid_bits == 16 {
+            TCR_EL1 |= 1 << 36;
+        }
+        ARM_ASIDS.set_bits(asid_bits);
          asm!("msr tcr_el1, {}", in(reg) TCR_EL1, options(nostack, preserves_flags));
 
 
@@ -961,6 +1227,162 @@ pub fn shared_mem_unmap(ptr: *mut u8, size: usize) -> Result<(), KError> {
 }
 
 
+// --- Sayfa Hataları (srcpager.rs) ---
+
+// Pager'ın bir adres alanındaki L3 yaprak işlemleri
+struct ArmFaultMmu {
+    l1_table_ptr: *mut PageTable,
+}
+
+impl FaultMmu for ArmFaultMmu {
+    fn lookup(&self, vaddr: u64) -> Option<(u64, bool)> {
+        // Blok tanımlayıcıları pager'a ait olamaz: yürüyüş onlarda hata döner
+        let l3_entry_ptr = walk_page_table_mut(self.l1_table_ptr, vaddr as usize, false).ok()?;
+        let entry = unsafe { ptr::read_volatile(l3_entry_ptr) };
+        if (entry & pte_flags::VALID) == 0 || (entry & pte_flags::PAGE) == 0 {
+            return None;
+        }
+        let writable = (entry & (3 << 6)) == pte_flags::AP_EL1_RW_EL0_RW;
+        Some((entry & PHYS_ADDR_MASK, writable))
+    }
+
+    fn install(&self, vaddr: u64, frame: u64, prot: u32, replace: bool) -> Result<(), KarnalError> {
+        let mut flags = pte_flags::VALID | pte_flags::PAGE | pte_flags::ATTR_INDEX_1_CACHED | pte_flags::SH_INNER
+            | pte_flags::AF | pte_flags::NG | pte_flags::PXN;
+        flags |= if prot & kpager::PROT_WRITE != 0 { pte_flags::AP_EL1_RW_EL0_RW } else { pte_flags::AP_EL1_RO_EL0_RO };
+        if prot & kpager::PROT_EXEC == 0 { flags |= pte_flags::UXN; }
+
+        let l3_entry_ptr = walk_page_table_mut(self.l1_table_ptr, vaddr as usize, true).map_err(|e| match e {
+            KError::OutOfMemory => KarnalError::OutOfMemory,
+            _ => KarnalError::BadAddress,
+        })?;
+        let old = unsafe { ptr::read_volatile(l3_entry_ptr) };
+        unsafe {
+            if replace && (old & pte_flags::VALID) != 0 && (old & PHYS_ADDR_MASK) != frame {
+                // Çıktı adresi değişiyor: break-before-make. Eski girdi önce geçersiz yapılır ve
+                // Inner Shareable TLBI ile tüm çekirdeklerden atılır (IPI gerekmez).
+                ptr::write_volatile(l3_entry_ptr, 0);
+                asm!("dsb ishst", "tlbi vaae1is, {}", "dsb ish", in(reg) vaddr >> 12, options(nostack, preserves_flags));
+            }
+            ptr::write_volatile(l3_entry_ptr, frame | flags);
+            if (old & pte_flags::VALID) != 0 {
+                // Aynı frame'in izni değişti (salt okunur -> yazılabilir). İzin yükseltmesi TLB'deki eski
+                // girdiyi geçersiz kılmaz: atılmazsa komut aynı izin hatasıyla sonsuza dek yeniden çalışır.
+                // Son düzey girdi tüm çekirdeklerden atılır; diğerleri de eski girdiden hata alabilir.
+                asm!("dsb ishst", "tlbi vaale1is, {}", "dsb ish", "isb", in(reg) vaddr >> 12, options(nostack, preserves_flags));
+            } else {
+                // Geçersiz girdiler TLB'de tutulmaz; yalnızca yazmanın tablo yürüyüşüne görünmesi yeterli.
+                asm!("dsb ishst", "isb", options(nostack, preserves_flags));
+            }
+        }
+        Ok(())
+    }
+}
+
+// L3 girdisindeki çıktı adresi alanı (bit 47:12)
+const PHYS_ADDR_MASK: u64 = 0x0000_FFFF_FFFF_F000;
+
+/// EL0 adres alanındaki (TTBR0_EL1) bir çeviri veya izin hatasını pager ile çözmeyi dener.
+/// Ok dönerse istisnadan dönülür ve komut yeniden çalışır.
+pub fn handle_page_fault(fault_addr: u64, access: Access) -> Result<(), KarnalError> {
+    let ttbr0: u64;
+    unsafe { asm!("mrs {}, ttbr0_el1", out(reg) ttbr0, options(nomem, nostack, preserves_flags)); }
+    // ASID (bit 63:48) ve CnP (bit 0) alanları maskelenir
+    let root = ttbr0 & PHYS_ADDR_MASK;
+    kpager::handle_fault(root, fault_addr, access, &ArmFaultMmu { l1_table_ptr: root as *mut PageTable })
+}
+
+// --- Aralık Eşlemeleri (kernel_memory.h) ---
+
+// kernel_memory.h'deki KMEM_PAGE_* bayrakları
+const KMEM_PAGE_WRITE: u32 = 1 << 1;
+const KMEM_PAGE_EXEC: u32 = 1 << 2;
+const KMEM_PAGE_USER: u32 = 1 << 3;
+const KMEM_PAGE_NOCACHE: u32 = 1 << 4;
+
+// Mimariden bağımsız KMEM_PAGE_* bayraklarını L3/blok tanımlayıcı bayraklarına çevirir.
+fn pte_flags_from_kmem(flags: u32) -> u64 {
+    let mut pte = pte_flags::VALID | pte_flags::PAGE | pte_flags::AF;
+    pte |= if flags & KMEM_PAGE_NOCACHE != 0 {
+        pte_flags::ATTR_INDEX_0_NOCACHE | pte_flags::SH_OUTER
+    } else {
+        pte_flags::ATTR_INDEX_1_CACHED | pte_flags::SH_INNER
+    };
+    let writable = flags & KMEM_PAGE_WRITE != 0;
+    if flags & KMEM_PAGE_USER != 0 {
+        pte |= pte_flags::NG | pte_flags::PXN;
+        pte |= if writable { pte_flags::AP_EL1_RW_EL0_RW } else { pte_flags::AP_EL1_RO_EL0_RO };
+        if flags & KMEM_PAGE_EXEC == 0 { pte |= pte_flags::UXN; }
+    } else {
+        pte |= pte_flags::UXN;
+        pte |= if writable { pte_flags::AP_EL1_RW_EL0_NO } else { pte_flags::AP_EL1_RO_EL0_NO };
+        if flags & KMEM_PAGE_EXEC == 0 { pte |= pte_flags::PXN; }
+    }
+    pte
+}
+
+// Mevcut EL0 adres alanının (TTBR0_EL1) L1 tablosu; ASID ve CnP alanları maskelenir.
+fn current_l1_table() -> *mut PageTable {
+    let ttbr0: u64;
+    unsafe { asm!("mrs {}, ttbr0_el1", out(reg) ttbr0, options(nomem, nostack, preserves_flags)); }
+    (ttbr0 & PHYS_ADDR_MASK) as *mut PageTable
+}
+
+/// Fiziksel olarak bitişik bir aralığı mevcut adres alanına haritalar (bkz. kernel_memory.h).
+/// Hizalama izin verdiğinde `map_range` 1GB/2MB blok tanımlayıcıları seçer.
+#[no_mangle]
+pub extern "C" fn kmem_virt_map_range(vaddr: u64, paddr: u64, size: usize, flags: u32) -> i64 {
+    match map_range(current_l1_table(), vaddr as usize, paddr as usize, size, pte_flags_from_kmem(flags)) {
+        Ok(()) => 0,
+        Err(KError::AddressNotPageAligned) => KError::InvalidArgument as i64,
+        Err(e) => e as i64,
+    }
+}
+
+/// kmem_virt_map_range ile kurulmuş aralığın haritasını kaldırır; fiziksel bellek iade edilmez.
+#[no_mangle]
+pub extern "C" fn kmem_virt_unmap_range(vaddr: u64, size: usize) -> i64 {
+    match unmap_range(current_l1_table(), vaddr as usize, size) {
+        Ok(()) => 0,
+        Err(KError::AddressNotPageAligned) => KError::InvalidArgument as i64,
+        Err(e) => e as i64,
+    }
+}
+
+/// Mevcut EL0 adres alanında sanal adresin fiziksel karşılığı; blok tanımlayıcılarında blok içi ofset dahil.
+/// Haritalı değilse 0 (bkz. kernel_memory.h).
+#[no_mangle]
+pub extern "C" fn kmem_virt_translate(vaddr: u64) -> u64 {
+    let mut table = current_l1_table() as *const u64;
+    for shift in [L1_INDEX_SHIFT, L2_INDEX_SHIFT, L3_INDEX_SHIFT] {
+        let entry = unsafe { ptr::read_volatile(table.add((vaddr as usize >> shift) & INDEX_MASK)) };
+        if (entry & pte_flags::VALID) == 0 {
+            return 0;
+        }
+        // L1/L2'de TABLE biti temizse blok, L3'te ise (PAGE biti) sayfadır
+        let leaf = shift == L3_INDEX_SHIFT;
+        if leaf && (entry & pte_flags::PAGE) == 0 {
+            return 0;
+        }
+        if leaf || (entry & pte_flags::TABLE) == 0 {
+            let size = 1u64 << shift;
+            return (entry & PHYS_ADDR_MASK & !(size - 1)) | (vaddr & (size - 1));
+        }
+        table = (entry & PHYS_ADDR_MASK) as *const u64;
+    }
+    0
+}
+
+/// Sayfayı pager ile önceden kurar; hata yolundakiyle aynı çözüm (bkz. handle_page_fault).
+#[no_mangle]
+pub extern "C" fn kmem_virt_fault_in(vaddr: u64, write: u32) -> i64 {
+    let access = if write != 0 { Access::Write } else { Access::Read };
+    match handle_page_fault(vaddr, access) {
+        Ok(()) => 0,
+        Err(e) => e as i64,
+    }
+}
+
 // TODO: Çekirdek belleği haritalama fonksiyonları ekle (TTBR1_EL1 kullanarak)
  pub fn map_kernel_memory(...) -> Result<(), KError> { ... }
  pub fn unmap_kernel_memory(...) -> Result<(), KError> { ... }
@@ -12,57 +12,27 @@ use core::panic::PanicInfo;
  use super::cpu; // Assuming a sibling module 'cpu' exists for arch-specific functions
 // Or directly using assembly/intrinsics
 
-// --- Panic Console Output (Placeholder) ---
-// In a real kernel, this would interact with a minimal, panic-safe console driver.
-// It cannot rely on the full kresource system or task scheduling, as they might be
-// corrupted or the source of the panic.
-// We'll use a placeholder function that assumes a basic printing capability.
+// --- Panic Console Output ---
+// Panic output cannot rely on the full kresource system or task scheduling, as they might be
+// corrupted or the source of the panic. It goes through the kernel console's emergency path.
+extern "C" {
+    fn karnal_console_emergency_write(buffer: *const u8, size: usize); // srcconsole.rs
+}
+
 #[cfg(target_arch = "aarch64")] // Example: Define for 64-bit ARM
 mod panic_console {
     use core::fmt::{Write, Arguments};
 
     // A very basic, panic-safe writer struct
-    struct PanicWriter;
+    pub(crate) struct PanicWriter;
 
     // Implement the Write trait for formatting
     impl Write for PanicWriter {
         fn write_str(&mut self, s: &str) -> core::fmt::Result {
-            // Placeholder: In a real kernel, this would write directly to a UART
-            // or a pre-initialized framebuffer in a panic-safe manner.
-            // It MUST NOT allocate memory or rely on complex locks/syscalls.
-            #[cfg(debug_assertions)] // Optional: print in debug builds
-            {
-                // Example: A hypothetical low-level UART write function
-                 super::super::uart::uart_put_str(s); // Assuming uart driver exists
-                // For now, we'll just ignore it or use a dummy print if available
-                #[cfg(feature = "enable_panic_debug_print")] // A feature flag to enable this
-                {
-                    // A very basic (potentially platform-specific) raw byte output
-                    // Example: Assumes a global UART base address or specific function
-                    // unsafe { super::super::uart::write_bytes_raw(s.as_bytes()); }
-                    // In a simulator or QEMU, semi-hosting might be an option, but not for real hardware panic.
-                    // Let's use a dummy print marker for now.
-                    // print! is not available in no_std panic handler without a global _print!
-                    // Let's use a simple loop over bytes if we can assume a raw byte output function.
-                    #[cfg(all(target_arch = "aarch64", target_os = "none"))] // Only for bare-metal AArch64
-                    {
-                        // This is a highly simplified placeholder.
-                        // A real implementation needs a dedicated panic-safe UART driver.
-                        extern "C" {
-                            // Assume a minimal C function for raw output exists
-                            fn panic_put_byte(byte: u8);
-                        }
-                        for byte in s.as_bytes() {
-                             // Avoid printing non-ASCII in panic for simplicity
-                            if byte.is_ascii() || *byte == b'\n' || *byte == b'\r' {
-                                unsafe { panic_put_byte(*byte); }
-                            } else {
-                                unsafe { panic_put_byte(b'.'); } // Replace non-ascii
-                            }
-                        }
-                    }
-                }
-            }
+            // The kernel console's emergency path: the first call flushes the per-CPU rings to the
+            // UART, then every write goes out synchronously via low_level_console_putc. It takes no
+            // locks and does not allocate.
+            unsafe { super::karnal_console_emergency_write(s.as_ptr(), s.len()) };
             Ok(())
         }
     }
@@ -130,7 +100,9 @@ fn panic(info: &PanicInfo) -> ! {
 
 
     // 2. Print panic location and message.
-    // Use the panic-safe console output mechanism.
+    // Use the panic-safe console output mechanism. Output still buffered in the console rings is
+    // flushed first, so the panic text follows it instead of overtaking it.
+    unsafe { karnal_console_emergency_write(core::ptr::null(), 0) };
     panic_println!("--- KERNEL PANIC ---");
 
     if let Some(location) = info.location() {
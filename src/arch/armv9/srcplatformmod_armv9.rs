@@ -8,6 +8,7 @@
 // Bu modül, generic çekirdek operasyonlarını ve tiplerini sağlar.
 // Proje yapınıza göre 'crate::karnal64' veya sadece 'karnal64' kullanabilirsiniz.
 use karnal64;
+use core::sync::atomic::{AtomicU64, Ordering};
 
 // --- Platforma Özgü Yardımcı Fonksiyonlar ve Makrolar ---
 
@@ -43,6 +44,11 @@ macro_rules! platform_println {
 // Eğer src/main.rs veya lib.rs içindeyseniz use crate::platform_println; yapmanız gerekebilir.
 
 
+extern "C" {
+    fn arm_cpu_set_id(cpu: u32); // srctask_armv9.rs
+    fn low_level_cpu_id() -> u32; // srctask_armv9.rs
+}
+
 // --- ARM Platform Başlatma ---
 
 /// ARM platformuna özgü başlatma fonksiyonu.
@@ -51,6 +57,10 @@ macro_rules! platform_println {
 /// Daha sonra Karnal64'ün generic başlatma fonksiyonunu çağırır.
 #[no_mangle] // Dışarıdan (bootloader veya başlangıç assembly kodundan) çağrılabilmesi için
 pub extern "C" fn arm_platform_init() {
+    // Önyükleme CPU'su mantıksal CPU 0'dır (low_level_cpu_id, srctask_armv9.rs)
+    unsafe { arm_cpu_set_id(0) };
+    // SGI'ları bu CPU'nun yeniden dağıtıcısında aç; ikincil CPU'lar kendi açılış yollarında çağırır.
+    low_level_ipi_init();
     // TODO: ARM CPU'ya özgü başlangıç kurulumları:
     // - Çok erken donanım başlatma (eğer bootloader yapmıyorsa)
     // - MMU (Bellek Yönetim Birimi) temel kurulumu ve çekirdek sanal adres alanının haritalanması.
@@ -145,11 +155,422 @@ pub extern "C" fn arm_low_level_exception_handler(
 // ve Karnal64'ün ilgili iç olay işleme mekanizmalarını tetikler.
 
 
+// --- GICv3 Kesme Denetleyicisi ---
+// Mantıksal kesme numarası 1020'nin altında GIC INTID'nin kendisidir; LPI'lar (INTID 8192+n) mantıksal
+// 1024+n'ye eşlenir. Adresler QEMU `virt` makinesine göredir.
+// TODO: Taban adresleri aygıt ağacından (DTB) okunmalı.
+const GICD_BASE: u64 = 0x0800_0000;
+const GICD_ISENABLER: u64 = 0x0100; // Etkinleştirme, 32 INTID/kayıt
+const GICD_ICENABLER: u64 = 0x0180; // Devre dışı bırakma, 32 INTID/kayıt
+const GICD_IROUTER: u64 = 0x6000;   // SPI yönlendirme, 8 bayt/INTID
+const GICR_BASE: u64 = 0x080A_0000;
+const GICR_STRIDE: u64 = 0x2_0000;   // RD_base + SGI_base çerçeveleri (2 x 64 KiB)
+const GICR_TYPER: u64 = 0x0008;      // bit 63:32 afinite, bit 4 son yeniden dağıtıcı
+const GICR_SGI_ISENABLER0: u64 = 0x1_0100; // SGI_base + 0x100: SGI/PPI etkinleştirme
+const GITS_BASE: u64 = 0x0808_0000;
+const GITS_TRANSLATER: u64 = GITS_BASE + 0x1_0040; // MSI'ların yazıldığı ITS adresi
+
+const GIC_SPI_FIRST: u32 = 32;
+const GIC_SPI_END: u32 = 1020;
+const GIC_SPECIAL_FIRST: u32 = 1020; // 1020-1023: özel INTID'ler (1023 = bekleyen kesme yok)
+// MSI'lar ITS üzerinden LPI olarak gelir; LPI INTID'leri 8192'den başlar.
+const GIC_LPI_FIRST: u32 = 8192;
+const GIC_LPI_COUNT: u32 = 256;
+const LOGICAL_LPI_FIRST: u32 = 1024;
+
+fn gicd_write(offset: u64, value: u32) {
+    unsafe { core::ptr::write_volatile((GICD_BASE + offset) as *mut u32, value) };
+}
+
+fn is_spi(irq: u32) -> bool {
+    irq >= GIC_SPI_FIRST && irq < GIC_SPI_END
+}
+
+// --- İşlemciler Arası Kesmeler (SGI) ---
+// SGI INTID'leri (0-15) CPU'ya özeldir ve kirq'e gitmez; IPI işleyicileri doğrudan çağrılır.
+const SGI_TLB_SHOOTDOWN: u32 = 0;
+const SGI_RESCHEDULE: u32 = 1;
+
+const MAX_CPUS: usize = 32; // ksched::MAX_CPUS
+const NO_MPIDR: u64 = u64::MAX;
+
+// Mantıksal CPU -> MPIDR_EL1 afinitesi. Her CPU low_level_ipi_init'te kendi girdisini yazar.
+static CPU_MPIDRS: [AtomicU64; MAX_CPUS] = [const { AtomicU64::new(NO_MPIDR) }; MAX_CPUS];
+
+// MPIDR_EL1'in Aff3.Aff2.Aff1.Aff0 alanlarını GICR_TYPER'deki 32 bitlik biçime çevirir.
+fn packed_affinity(mpidr: u64) -> u64 {
+    ((mpidr >> 8) & 0xFF00_0000) | (mpidr & 0x00FF_FFFF)
+}
+
+// Bu CPU'nun yeniden dağıtıcısını afiniteye göre bulur.
+fn this_redistributor(mpidr: u64) -> Option<u64> {
+    let affinity = packed_affinity(mpidr);
+    let mut rd = GICR_BASE;
+    loop {
+        let typer = unsafe { core::ptr::read_volatile((rd + GICR_TYPER) as *const u64) };
+        if typer >> 32 == affinity {
+            return Some(rd);
+        }
+        if typer & (1 << 4) != 0 {
+            return None;
+        }
+        rd += GICR_STRIDE;
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_ipi_init() {
+    let mpidr: u64;
+    unsafe { core::arch::asm!("mrs {}, mpidr_el1", out(reg) mpidr, options(nomem, nostack, preserves_flags)) };
+    let mpidr = mpidr & 0xFF_00FF_FFFF;
+    // IPI SGI'leri arm_irq_handler_entry'de kirq'e uğramadan işlenir; sürücüler bu INTID'leri kaydedemez
+    for intid in [SGI_TLB_SHOOTDOWN, SGI_RESCHEDULE] {
+        let _ = crate::kirq::reserve(intid);
+    }
+    if let Some(rd) = this_redistributor(mpidr) {
+        unsafe { core::ptr::write_volatile((rd + GICR_SGI_ISENABLER0) as *mut u32, (1 << SGI_TLB_SHOOTDOWN) | (1 << SGI_RESCHEDULE)) };
+    }
+    if let Some(slot) = CPU_MPIDRS.get(unsafe { low_level_cpu_id() } as usize) {
+        slot.store(mpidr, Ordering::Release);
+    }
+}
+
+// ICC_SGI1R_EL1: Aff3[55:48], RS[47:44], Aff2[39:32], INTID[27:24], Aff1[23:16], TargetList[15:0]
+fn send_sgi(cpu: u32, intid: u32) {
+    let mpidr = match CPU_MPIDRS.get(cpu as usize) {
+        Some(m) => m.load(Ordering::Acquire),
+        None => return,
+    };
+    if mpidr == NO_MPIDR {
+        return; // CPU henüz IPI almaya hazır değil
+    }
+    let aff0 = mpidr & 0xFF;
+    let value = (((mpidr >> 32) & 0xFF) << 48)
+        | ((aff0 / 16) << 44)
+        | (((mpidr >> 16) & 0xFF) << 32)
+        | ((intid as u64 & 0xF) << 24)
+        | (((mpidr >> 8) & 0xFF) << 16)
+        | (1 << (aff0 % 16));
+    unsafe {
+        // Önceki bellek yazmaları (posta kutusu) SGI'dan önce görünür olmalı
+        core::arch::asm!("dsb ishst", "msr S3_0_C12_C11_5, {}", "isb", in(reg) value, options(nostack, preserves_flags));
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_send_tlb_shootdown_ipi(cpu: u32) {
+    send_sgi(cpu, SGI_TLB_SHOOTDOWN);
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_send_reschedule_ipi(cpu: u32) {
+    send_sgi(cpu, SGI_RESCHEDULE);
+}
+
+// --- SMP Açılışı (PSCI CPU_ON, hardware_specific.h) ---
+// İkincil CPU'lar yeniden dağıtıcı listesinden bulunur: her GICR çerçevesinin GICR_TYPER afinitesi bir CPU'nun
+// MPIDR'ıdır. CPU_ON'a verilen giriş adresi fizikseldir ve CPU EL1'de MMU kapalı başlar; çekirdek kimlik
+// eşlemeli olduğundan arm_secondary_entry önyükleme CPU'sunun MMU yazmaçlarını yükleyip aynı adreslerle devam
+// eder. Başlangıç bloğu önbellek kapalıyken okunduğundan önyükleme CPU'su onu PoC'ye temizler.
+// TODO: PSCI çağrı yöntemi (hvc/smc) aygıt ağacının /psci "method" özelliğinden okunmalı; QEMU virt
+// (EL3 yok) varsayılır.
+
+const PSCI_CPU_ON: u64 = 0xC400_0003; // SMC64
+const PSCI_SUCCESS: i64 = 0;
+const AP_STACK_ORDER: u32 = 2; // 16KB
+const PAGE_SIZE: u64 = 4096;
+const GICR_WAKER: u64 = 0x0014; // bit 1 ProcessorSleep, bit 2 ChildrenAsleep
+
+// arm_secondary_entry'nin okuduğu blok (ofsetler aşağıdaki kodla EŞLEŞMELİDİR); x0 ile gelir
+#[repr(C, align(64))]
+struct ApStart {
+    stack_top: u64, // 0
+    mair: u64,      // 8
+    tcr: u64,       // 16
+    ttbr0: u64,     // 24
+    ttbr1: u64,     // 32
+    vbar: u64,      // 40
+    sctlr: u64,     // 48
+    cpu: u64,       // 56
+}
+
+// Her blok yalnızca CPU_ON öncesinde önyükleme CPU'su tarafından yazılır
+static mut AP_STARTS: [ApStart; MAX_CPUS] = [const {
+    ApStart { stack_top: 0, mair: 0, tcr: 0, ttbr0: 0, ttbr1: 0, vbar: 0, sctlr: 0, cpu: 0 }
+}; MAX_CPUS];
+
+core::arch::global_asm!(
+    ".global arm_secondary_entry",
+    "arm_secondary_entry:",
+    "msr daifset, #0xf",
+    "ldr x1, [x0, #0]",
+    "mov sp, x1",
+    "ldr x1, [x0, #8]",
+    "msr mair_el1, x1",
+    "ldr x1, [x0, #16]",
+    "msr tcr_el1, x1",
+    "ldr x1, [x0, #24]",
+    "msr ttbr0_el1, x1",
+    "ldr x1, [x0, #32]",
+    "msr ttbr1_el1, x1",
+    "ldr x1, [x0, #40]",
+    "msr vbar_el1, x1",
+    "isb",
+    "tlbi vmalle1",
+    "dsb nsh",
+    "isb",
+    "ldr x1, [x0, #48]",
+    "msr sctlr_el1, x1",
+    "isb",
+    "ldr x0, [x0, #56]",
+    "bl arm_secondary_main",
+    "1:",
+    "wfi",
+    "b 1b",
+);
+
+extern "C" {
+    fn arm_secondary_entry();
+    fn kmem_phys_alloc_frames(order: u32) -> u64;
+    fn kmem_phys_free_frames(addr: u64, order: u32);
+    fn karnal_secondary_start(cpu: u32) -> !;
+}
+
+// Bu CPU'nun GIC CPU arayüzünü açar: yeniden dağıtıcıyı uyandırır, sistem yazmacı arayüzünü (ICC_SRE_EL1),
+// öncelik maskesini (ICC_PMR_EL1) ve grup 1 kesmelerini (ICC_IGRPEN1_EL1) etkinleştirir.
+fn gic_cpu_init(mpidr: u64) {
+    if let Some(rd) = this_redistributor(mpidr) {
+        let waker = (rd + GICR_WAKER) as *mut u32;
+        unsafe {
+            core::ptr::write_volatile(waker, core::ptr::read_volatile(waker) & !(1 << 1));
+            while core::ptr::read_volatile(waker) & (1 << 2) != 0 {
+                core::hint::spin_loop();
+            }
+        }
+    }
+    unsafe {
+        core::arch::asm!(
+            "mrs {tmp}, S3_0_C12_C12_5", // ICC_SRE_EL1
+            "orr {tmp}, {tmp}, #1",
+            "msr S3_0_C12_C12_5, {tmp}",
+            "isb",
+            "mov {tmp}, #0xff",
+            "msr S3_0_C4_C6_0, {tmp}",   // ICC_PMR_EL1
+            "mov {tmp}, #1",
+            "msr S3_0_C12_C12_7, {tmp}", // ICC_IGRPEN1_EL1
+            "isb",
+            tmp = out(reg) _,
+            options(nostack),
+        );
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn arm_secondary_main(cpu: u64) -> ! {
+    let cpu = cpu as u32;
+    unsafe { arm_cpu_set_id(cpu) };
+    let mpidr: u64;
+    unsafe { core::arch::asm!("mrs {}, mpidr_el1", out(reg) mpidr, options(nomem, nostack, preserves_flags)) };
+    gic_cpu_init(mpidr & 0xFF_00FF_FFFF);
+    unsafe { karnal_secondary_start(cpu) }
+}
+
+fn psci_cpu_on(mpidr: u64, entry: u64, context: u64) -> i64 {
+    let ret: i64;
+    unsafe {
+        core::arch::asm!("hvc #0",
+            inlateout("x0") PSCI_CPU_ON as i64 => ret, inlateout("x1") mpidr => _,
+            inlateout("x2") entry => _, inlateout("x3") context => _, options(nostack));
+    }
+    ret
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_start_secondary_cpus() -> u32 {
+    let (mpidr, mair, tcr, ttbr0, ttbr1, vbar, sctlr): (u64, u64, u64, u64, u64, u64, u64);
+    unsafe {
+        core::arch::asm!(
+            "mrs {0}, mpidr_el1",
+            "mrs {1}, mair_el1",
+            "mrs {2}, tcr_el1",
+            "mrs {3}, ttbr0_el1",
+            "mrs {4}, ttbr1_el1",
+            "mrs {5}, vbar_el1",
+            "mrs {6}, sctlr_el1",
+            out(reg) mpidr, out(reg) mair, out(reg) tcr, out(reg) ttbr0, out(reg) ttbr1, out(reg) vbar,
+            out(reg) sctlr, options(nomem, nostack, preserves_flags),
+        );
+    }
+    let own = packed_affinity(mpidr & 0xFF_00FF_FFFF);
+
+    let mut started = 0u32;
+    let mut rd = GICR_BASE;
+    loop {
+        let typer = unsafe { core::ptr::read_volatile((rd + GICR_TYPER) as *const u64) };
+        let affinity = typer >> 32;
+        let next = started as usize + 1;
+        if affinity != own && next < MAX_CPUS {
+            let stack = unsafe { kmem_phys_alloc_frames(AP_STACK_ORDER) };
+            if stack == 0 {
+                break;
+            }
+            let target = ((affinity & 0xFF00_0000) << 8) | (affinity & 0x00FF_FFFF);
+            let block = unsafe { core::ptr::addr_of_mut!(AP_STARTS[next]) };
+            unsafe {
+                block.write(ApStart {
+                    stack_top: stack + (PAGE_SIZE << AP_STACK_ORDER),
+                    mair, tcr, ttbr0, ttbr1, vbar, sctlr,
+                    cpu: next as u64,
+                });
+                // Blok tek önbellek satırında (64 bayt hizalı)
+                core::arch::asm!("dc cvac, {}", "dsb sy", in(reg) block as u64, options(nostack, preserves_flags));
+            }
+            if psci_cpu_on(target, arm_secondary_entry as usize as u64, block as u64) == PSCI_SUCCESS {
+                started += 1;
+            } else {
+                unsafe { kmem_phys_free_frames(stack, AP_STACK_ORDER) };
+            }
+        }
+        if typer & (1 << 4) != 0 {
+            break;
+        }
+        rd += GICR_STRIDE;
+    }
+    started
+}
+
+#[no_mangle]
+pub extern "C" fn arm_irq_handler_entry() {
+    // Kesmeyi onayla (ICC_IAR1_EL1) ve INTID'yi al; onay, kesmeyi bu CPU'da etkin duruma geçirir.
+    let intid: u64;
+    unsafe { core::arch::asm!("mrs {}, S3_0_C12_C12_0", out(reg) intid) }; // ICC_IAR1_EL1
+    let intid = (intid & 0xFF_FFFF) as u32;
+    if intid >= GIC_SPECIAL_FIRST && intid < GIC_LPI_FIRST {
+        return; // Sahte kesme: EOI yazılmaz
+    }
+    if intid == SGI_TLB_SHOOTDOWN {
+        crate::ktlb::ktlb_handle_shootdown_ipi();
+        unsafe { core::arch::asm!("msr S3_0_C12_C12_1, {}", in(reg) intid as u64) }; // ICC_EOIR1_EL1
+        return;
+    }
+    // SPSR_EL1 kesilen durumu tutar; geçişten önce okunmalı (M[3:0] = 0: EL0t'den gelindi).
+    let spsr: u64;
+    unsafe { core::arch::asm!("mrs {}, spsr_el1", out(reg) spsr, options(nomem, nostack, preserves_flags)) };
+    if intid == SGI_RESCHEDULE {
+        crate::ksched::ksched_handle_reschedule_ipi();
+    } else {
+        let irq = if intid >= GIC_LPI_FIRST { LOGICAL_LPI_FIRST + (intid - GIC_LPI_FIRST) } else { intid };
+        crate::kirq::kirq_dispatch(irq);
+    }
+    unsafe { core::arch::asm!("msr S3_0_C12_C12_1, {}", in(reg) intid as u64) }; // ICC_EOIR1_EL1
+    // Zaman dilimi dolduysa veya reschedule IPI geldiyse kullanıcı moduna dönüşte iş parçacığı değiştirilir.
+    if spsr & 0xF == 0 {
+        crate::ksched::ksched_preempt_point();
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_irq_mask(irq: u32) {
+    if is_spi(irq) {
+        gicd_write(GICD_ICENABLER + 4 * (irq / 32) as u64, 1 << (irq % 32));
+    }
+    // TODO: SGI/PPI için yeniden dağıtıcının (GICR) GICR_ICENABLER0'ı, LPI için yapılandırma tablosunun etkin biti.
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_irq_unmask(irq: u32) {
+    if is_spi(irq) {
+        gicd_write(GICD_ISENABLER + 4 * (irq / 32) as u64, 1 << (irq % 32));
+    }
+    // TODO: SGI/PPI ve LPI (bkz. low_level_irq_mask).
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_irq_set_affinity(irq: u32, cpu: u32) -> i64 {
+    if !is_spi(irq) {
+        return -38; // KERROR_NOT_SUPPORTED: SGI/PPI CPU'ya özeldir, LPI'lar ITS ile taşınır
+    }
+    // TODO: MPIDR afinite değerleri aygıt ağacından okunmalı; şimdilik Aff0 = mantıksal CPU varsayılır.
+    let route = (GICD_BASE + GICD_IROUTER + 8 * irq as u64) as *mut u64;
+    unsafe { core::ptr::write_volatile(route, cpu as u64 & 0xFF) };
+    0
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_irq_msi_range(first: *mut u32, count: *mut u32) {
+    unsafe {
+        *first = LOGICAL_LPI_FIRST;
+        *count = GIC_LPI_COUNT;
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_msi_compose(irq: u32, cpu: u32, address: *mut u64, data: *mut u32) -> i64 {
+    if irq < LOGICAL_LPI_FIRST || irq >= LOGICAL_LPI_FIRST + GIC_LPI_COUNT {
+        return -3; // KERROR_INVALID_ARGUMENT
+    }
+    // Cihaz olay numarasını GITS_TRANSLATER'a yazar; ITS bunu (DeviceID, EventID) -> LPI olarak çevirir.
+    // Hedef CPU mesajda değil ITS koleksiyonundadır: adres/veri CPU'dan bağımsızdır.
+    // TODO: ITS komut kuyruğu (MAPD/MAPTI ile eşleme, MOVI ile `cpu`nun koleksiyonuna taşıma).
+    unsafe {
+        *address = GITS_TRANSLATER;
+        *data = irq - LOGICAL_LPI_FIRST;
+    }
+    0
+}
+
+// --- Çekirdek Konsolu UART'ı (PL011; hardware_specific.h, srcconsole.rs) ---
+// TODO: Taban adres ve INTID aygıt ağacından ("arm,pl011") okunmalı; QEMU virt değerleri varsayılır.
+const PL011_BASE: u64 = 0x0900_0000;
+const PL011_DR: u64 = 0x000;
+const PL011_FR: u64 = 0x018;   // bit 5: TXFF (FIFO dolu), bit 7: TXFE (FIFO boş)
+const PL011_IMSC: u64 = 0x038; // bit 5: TXIM (verici kesmesi)
+const PL011_FR_TXFF: u32 = 1 << 5;
+const PL011_FR_TXFE: u32 = 1 << 7;
+const PL011_TXIM: u32 = 1 << 5;
+const PL011_FIFO_SIZE: u32 = 16;
+const PL011_INTID: u32 = GIC_SPI_FIRST + 1; // SPI 1
+
+fn pl011_read(offset: u64) -> u32 {
+    unsafe { core::ptr::read_volatile((PL011_BASE + offset) as *const u32) }
+}
+
+fn pl011_write(offset: u64, value: u32) {
+    unsafe { core::ptr::write_volatile((PL011_BASE + offset) as *mut u32, value) };
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_console_putc(c: u8) {
+    while pl011_read(PL011_FR) & PL011_FR_TXFF != 0 {
+        core::hint::spin_loop();
+    }
+    pl011_write(PL011_DR, c as u32);
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_console_tx_room() -> u32 {
+    // PL011 doluluk sayısı vermez: boşsa FIFO'nun tamamı, dolu değilse en az bir bayt yazılabilir
+    let fr = pl011_read(PL011_FR);
+    if fr & PL011_FR_TXFE != 0 {
+        PL011_FIFO_SIZE
+    } else if fr & PL011_FR_TXFF == 0 {
+        1
+    } else {
+        0
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_console_tx_irq_enable(enable: u32) {
+    let imsc = pl011_read(PL011_IMSC);
+    pl011_write(PL011_IMSC, if enable != 0 { imsc | PL011_TXIM } else { imsc & !PL011_TXIM });
+}
+
 #[no_mangle]
-pub extern "C" fn arm_irq_handler_entry(...) {
-    // TODO: Kesme kaynağını (hangi cihaz) belirle (ARM GIC veya benzeri)
-    // TODO: Karnal64'ün ilgili kesme/olay işleyicisini çağır (örn. ktask::handle_timer_tick(), kresource::handle_uart_interrupt())
-    // ...
+pub extern "C" fn low_level_console_irq() -> u32 {
+    // SPI'ı bu CPU'ya yönlendir; kirq::request low_level_irq_unmask ile açar.
+    low_level_irq_set_affinity(PL011_INTID, unsafe { low_level_cpu_id() });
+    PL011_INTID
 }
 
 
@@ -744,3 +744,403 @@ unsafe extern "C" fn task_exit_handler() {
     // Bu satırın altındaki kod unreachable olmalıdır.
      panic!("Karnal64 ARM: task_exit_handler returned!"); // Hata ayıklama için
 }
+
+// --- Zamanlayıcı Kancaları (hardware_specific.h, srcsched.rs) ---
+// Yukarıdaki TCB tabanlı arm_context_switch kullanıcı görevlerine `eret` ile döner. CPU başına zamanlayıcı
+// (srcsched.rs) ise çekirdek iş parçacıkları arasında EL1 içinde geçer: AAPCS64'ün koruduğu x19-x30 ve
+// iş parçacığının EL0 durumu (SP_EL0, TPIDR_EL0) yığıta yazılır, yalnızca sp kaydedilir. EL0 yazmaçları
+// tek kopya olduğundan, aksi halde sistem çağrısında bloklanan bir iş parçacığının yerine geçen iş parçacığı
+// kullanıcıya öncekinin yığıt ve TLS işaretçisiyle dönerdi. Çekirdek FP/SIMD kullanmadan derlendiğinden
+// d8-d15 kaydedilmez.
+// Yeni iş parçacığı ilk geçişte arm_thread_trampoline'a döner; trampolin x19'daki giriş fonksiyonunu
+// x20'deki argümanla çağırır.
+
+core::arch::global_asm!(
+    ".global low_level_context_switch",
+    "low_level_context_switch:",
+    "sub sp, sp, #112",
+    "stp x19, x20, [sp, #0]",
+    "stp x21, x22, [sp, #16]",
+    "stp x23, x24, [sp, #32]",
+    "stp x25, x26, [sp, #48]",
+    "stp x27, x28, [sp, #64]",
+    "stp x29, x30, [sp, #80]",
+    "mrs x9, sp_el0",
+    "mrs x10, tpidr_el0",
+    "stp x9, x10, [sp, #96]",
+    "mov x9, sp",
+    "str x9, [x0]",
+    "mov sp, x1",
+    "ldp x9, x10, [sp, #96]",
+    "msr sp_el0, x9",
+    "msr tpidr_el0, x10",
+    "ldp x19, x20, [sp, #0]",
+    "ldp x21, x22, [sp, #16]",
+    "ldp x23, x24, [sp, #32]",
+    "ldp x25, x26, [sp, #48]",
+    "ldp x27, x28, [sp, #64]",
+    "ldp x29, x30, [sp, #80]",
+    "add sp, sp, #112",
+    "ret",
+    "",
+    ".global arm_thread_trampoline",
+    "arm_thread_trampoline:",
+    "mov x0, x20",
+    "blr x19",
+    "brk #0",
+);
+
+extern "C" {
+    fn arm_thread_trampoline();
+}
+
+/// Yeni iş parçacığı yığıtını low_level_context_switch'in yükleyeceği 112 byte'lık çerçeveyle hazırlar:
+/// x19 = entry, x20 = arg, x30 (lr) = trampolin, x29 = 0 (çerçeve zinciri sonu), SP_EL0 = TPIDR_EL0 = 0.
+#[no_mangle]
+pub unsafe extern "C" fn low_level_thread_stack_init(stack_top: u64, entry: u64, arg: u64) -> u64 {
+    let frame = ((stack_top & !0xF) - 112) as *mut u64;
+    for i in 0..14 {
+        core::ptr::write(frame.add(i), 0);
+    }
+    core::ptr::write(frame.add(0), entry);
+    core::ptr::write(frame.add(1), arg);
+    core::ptr::write(frame.add(11), arm_thread_trampoline as usize as u64);
+    frame as u64
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_interrupt_save() -> u64 {
+    let daif: u64;
+    unsafe { core::arch::asm!("mrs {}, daif", "msr daifset, #2", out(reg) daif, options(nomem, nostack)) };
+    daif
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_interrupt_restore(state: u64) {
+    unsafe { core::arch::asm!("msr daif, {}", in(reg) state, options(nomem, nostack)) };
+}
+
+/// `wfi`, IRQ maskeliyken de bekleyen bir kesmeyle uyanır; kesme ardından kısa süre açılan maske ile alınır.
+#[no_mangle]
+pub extern "C" fn low_level_cpu_idle_wait() {
+    unsafe { core::arch::asm!("wfi", "msr daifclr, #2", "isb", "msr daifset, #2", options(nomem, nostack)) };
+}
+
+// --- CPU Numarası (hardware_specific.h) ---
+// Mantıksal CPU numarası TPIDR_EL1'de tutulur (EL0 erişemez, bağlam değişiminde korunur). Sıfırlama değeri
+// tanımsız olduğundan önyükleme CPU'su arm_platform_init'te, ikincil CPU'lar açılış yolunda arm_cpu_set_id çağırır.
+
+#[no_mangle]
+pub extern "C" fn arm_cpu_set_id(cpu: u32) {
+    unsafe { core::arch::asm!("msr tpidr_el1, {}", in(reg) cpu as u64, options(nomem, nostack)) };
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_cpu_id() -> u32 {
+    let cpu: u64;
+    unsafe { core::arch::asm!("mrs {}, tpidr_el1", out(reg) cpu, options(nomem, nostack, preserves_flags)) };
+    cpu as u32
+}
+
+// --- Boşta Durumları ve Performans Seviyesi (hardware_specific.h, srcdvfs.rs) ---
+// Desteklenmiyor: PSCI CPU_SUSPEND ve SCMI performans alanları için çağrı yolu (smc/hvc, DT/ACPI
+// keşfi) henüz yok. Durum kaydedilmediği için idle_enter çağrılmaz; çağrılırsa wfi ile bekler.
+
+#[no_mangle]
+pub extern "C" fn low_level_cpu_idle_enter(_state: u32) {
+    low_level_cpu_idle_wait();
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_cpu_set_performance(_cpu: u32, _level: u32) -> i64 {
+    KError::NotSupported as i64
+}
+
+// --- Hızlı Sistem Çağrısı Girişi (hardware_specific.h, srcsyscall.rs) ---
+// SVC hızlı yolu vektör tablosundadır (srcinterrupt_armv9.rs) ve VBAR_EL1 ile birlikte kurulur.
+// EL0'dan gelen istisnalar SP_EL1'e girer; SP_EL1, iş parçacığı eret ile kullanıcıya dönerken kendi
+// çekirdek yığıtında kaldığı için ayrıca ayarlanması gerekmez.
+
+#[no_mangle]
+pub extern "C" fn low_level_syscall_init() {}
+
+#[no_mangle]
+pub extern "C" fn low_level_set_kernel_stack(_stack_top: u64) {}
+
+/// Kullanıcı moduna ilk geçiş (task_spawn). SPSR_EL1 = 0: EL0t, DAIF açık. SP_EL1 eret anındaki çekirdek
+/// yığıtında kalır; EL0'dan gelen istisnalar oradan aşağı doğru kullanır.
+#[no_mangle]
+pub unsafe extern "C" fn low_level_enter_user(entry: u64, user_sp: u64, arg0: u64, arg1: u64) -> ! {
+    core::arch::asm!(
+        "msr daifset, #0xf",
+        "msr elr_el1, x2",
+        "msr sp_el0, x3",
+        "msr spsr_el1, xzr",
+        "msr tpidr_el0, xzr",
+        "mov x2, xzr", "mov x3, xzr", "mov x4, xzr", "mov x5, xzr", "mov x6, xzr", "mov x7, xzr",
+        "mov x8, xzr", "mov x9, xzr", "mov x10, xzr", "mov x11, xzr", "mov x12, xzr", "mov x13, xzr",
+        "mov x14, xzr", "mov x15, xzr", "mov x16, xzr", "mov x17, xzr", "mov x18, xzr", "mov x19, xzr",
+        "mov x20, xzr", "mov x21, xzr", "mov x22, xzr", "mov x23, xzr", "mov x24, xzr", "mov x25, xzr",
+        "mov x26, xzr", "mov x27, xzr", "mov x28, xzr", "mov x29, xzr", "mov x30, xzr",
+        "eret",
+        in("x0") arg0,
+        in("x1") arg1,
+        in("x2") entry,
+        in("x3") user_sp,
+        options(noreturn),
+    );
+}
+
+// --- Tembel FPU/SIMD (hardware_specific.h, srcsched.rs) ---
+// CPACR_EL1.FPEN ve ZEN = 0b00 iken EL0'ın ilk FP/ASIMD komutu EC 0x07, SVE komutu EC 0x19 ile tuzağa düşer
+// (srcinterrupt_armv9.rs -> ksched_fpu_trap). Alan düzeni: FPSR, FPCR, 64. bayttan itibaren yazmaçlar.
+// SVE varsa Z0-Z31, P0-P15 ve FFR o anki vektör uzunluğuyla (VL, tüm CPU'larda aynı varsayılır) kaydedilir;
+// V yazmaçları Z'nin alt 128 bitidir. SVE yoksa Q0-Q31 kaydedilir.
+// TODO: SVE durumu iş parçacığı başına ayrıca izlenebilir (yalnızca ASIMD kullananlar için Q kaydı).
+
+const CPACR_FPEN: u64 = 0b11 << 20;
+const CPACR_ZEN: u64 = 0b11 << 16;
+const FPU_AREA_HEADER: u64 = 64;
+
+static FPU_SVE: core::sync::atomic::AtomicBool = core::sync::atomic::AtomicBool::new(false);
+
+core::arch::global_asm!(
+    ".arch_extension sve",
+    ".global arm_fpu_save_sve",
+    "arm_fpu_save_sve:",
+    "mrs x9, fpsr",
+    "mrs x10, fpcr",
+    "stp x9, x10, [x0]",
+    "add x0, x0, #64",
+    "str z0, [x0, #0, mul vl]",
+    "str z1, [x0, #1, mul vl]",
+    "str z2, [x0, #2, mul vl]",
+    "str z3, [x0, #3, mul vl]",
+    "str z4, [x0, #4, mul vl]",
+    "str z5, [x0, #5, mul vl]",
+    "str z6, [x0, #6, mul vl]",
+    "str z7, [x0, #7, mul vl]",
+    "str z8, [x0, #8, mul vl]",
+    "str z9, [x0, #9, mul vl]",
+    "str z10, [x0, #10, mul vl]",
+    "str z11, [x0, #11, mul vl]",
+    "str z12, [x0, #12, mul vl]",
+    "str z13, [x0, #13, mul vl]",
+    "str z14, [x0, #14, mul vl]",
+    "str z15, [x0, #15, mul vl]",
+    "str z16, [x0, #16, mul vl]",
+    "str z17, [x0, #17, mul vl]",
+    "str z18, [x0, #18, mul vl]",
+    "str z19, [x0, #19, mul vl]",
+    "str z20, [x0, #20, mul vl]",
+    "str z21, [x0, #21, mul vl]",
+    "str z22, [x0, #22, mul vl]",
+    "str z23, [x0, #23, mul vl]",
+    "str z24, [x0, #24, mul vl]",
+    "str z25, [x0, #25, mul vl]",
+    "str z26, [x0, #26, mul vl]",
+    "str z27, [x0, #27, mul vl]",
+    "str z28, [x0, #28, mul vl]",
+    "str z29, [x0, #29, mul vl]",
+    "str z30, [x0, #30, mul vl]",
+    "str z31, [x0, #31, mul vl]",
+    "addvl x0, x0, #16",
+    "addvl x0, x0, #16",
+    "str p0, [x0, #0, mul vl]",
+    "str p1, [x0, #1, mul vl]",
+    "str p2, [x0, #2, mul vl]",
+    "str p3, [x0, #3, mul vl]",
+    "str p4, [x0, #4, mul vl]",
+    "str p5, [x0, #5, mul vl]",
+    "str p6, [x0, #6, mul vl]",
+    "str p7, [x0, #7, mul vl]",
+    "str p8, [x0, #8, mul vl]",
+    "str p9, [x0, #9, mul vl]",
+    "str p10, [x0, #10, mul vl]",
+    "str p11, [x0, #11, mul vl]",
+    "str p12, [x0, #12, mul vl]",
+    "str p13, [x0, #13, mul vl]",
+    "str p14, [x0, #14, mul vl]",
+    "str p15, [x0, #15, mul vl]",
+    "rdffr p0.b",
+    "str p0, [x0, #16, mul vl]",
+    "ldr p0, [x0, #0, mul vl]",
+    "ret",
+    "",
+    ".global arm_fpu_restore_sve",
+    "arm_fpu_restore_sve:",
+    "ldp x9, x10, [x0]",
+    "msr fpsr, x9",
+    "msr fpcr, x10",
+    "add x0, x0, #64",
+    "addvl x1, x0, #16",
+    "addvl x1, x1, #16",
+    "ldr p0, [x1, #16, mul vl]",
+    "wrffr p0.b",
+    "ldr p0, [x1, #0, mul vl]",
+    "ldr p1, [x1, #1, mul vl]",
+    "ldr p2, [x1, #2, mul vl]",
+    "ldr p3, [x1, #3, mul vl]",
+    "ldr p4, [x1, #4, mul vl]",
+    "ldr p5, [x1, #5, mul vl]",
+    "ldr p6, [x1, #6, mul vl]",
+    "ldr p7, [x1, #7, mul vl]",
+    "ldr p8, [x1, #8, mul vl]",
+    "ldr p9, [x1, #9, mul vl]",
+    "ldr p10, [x1, #10, mul vl]",
+    "ldr p11, [x1, #11, mul vl]",
+    "ldr p12, [x1, #12, mul vl]",
+    "ldr p13, [x1, #13, mul vl]",
+    "ldr p14, [x1, #14, mul vl]",
+    "ldr p15, [x1, #15, mul vl]",
+    "ldr z0, [x0, #0, mul vl]",
+    "ldr z1, [x0, #1, mul vl]",
+    "ldr z2, [x0, #2, mul vl]",
+    "ldr z3, [x0, #3, mul vl]",
+    "ldr z4, [x0, #4, mul vl]",
+    "ldr z5, [x0, #5, mul vl]",
+    "ldr z6, [x0, #6, mul vl]",
+    "ldr z7, [x0, #7, mul vl]",
+    "ldr z8, [x0, #8, mul vl]",
+    "ldr z9, [x0, #9, mul vl]",
+    "ldr z10, [x0, #10, mul vl]",
+    "ldr z11, [x0, #11, mul vl]",
+    "ldr z12, [x0, #12, mul vl]",
+    "ldr z13, [x0, #13, mul vl]",
+    "ldr z14, [x0, #14, mul vl]",
+    "ldr z15, [x0, #15, mul vl]",
+    "ldr z16, [x0, #16, mul vl]",
+    "ldr z17, [x0, #17, mul vl]",
+    "ldr z18, [x0, #18, mul vl]",
+    "ldr z19, [x0, #19, mul vl]",
+    "ldr z20, [x0, #20, mul vl]",
+    "ldr z21, [x0, #21, mul vl]",
+    "ldr z22, [x0, #22, mul vl]",
+    "ldr z23, [x0, #23, mul vl]",
+    "ldr z24, [x0, #24, mul vl]",
+    "ldr z25, [x0, #25, mul vl]",
+    "ldr z26, [x0, #26, mul vl]",
+    "ldr z27, [x0, #27, mul vl]",
+    "ldr z28, [x0, #28, mul vl]",
+    "ldr z29, [x0, #29, mul vl]",
+    "ldr z30, [x0, #30, mul vl]",
+    "ldr z31, [x0, #31, mul vl]",
+    "ret",
+    "",
+    ".global arm_fpu_save_fp",
+    "arm_fpu_save_fp:",
+    "mrs x9, fpsr",
+    "mrs x10, fpcr",
+    "stp x9, x10, [x0]",
+    "add x0, x0, #64",
+    "stp q0, q1, [x0, #0]",
+    "stp q2, q3, [x0, #32]",
+    "stp q4, q5, [x0, #64]",
+    "stp q6, q7, [x0, #96]",
+    "stp q8, q9, [x0, #128]",
+    "stp q10, q11, [x0, #160]",
+    "stp q12, q13, [x0, #192]",
+    "stp q14, q15, [x0, #224]",
+    "stp q16, q17, [x0, #256]",
+    "stp q18, q19, [x0, #288]",
+    "stp q20, q21, [x0, #320]",
+    "stp q22, q23, [x0, #352]",
+    "stp q24, q25, [x0, #384]",
+    "stp q26, q27, [x0, #416]",
+    "stp q28, q29, [x0, #448]",
+    "stp q30, q31, [x0, #480]",
+    "ret",
+    "",
+    ".global arm_fpu_restore_fp",
+    "arm_fpu_restore_fp:",
+    "ldp x9, x10, [x0]",
+    "msr fpsr, x9",
+    "msr fpcr, x10",
+    "add x0, x0, #64",
+    "ldp q0, q1, [x0, #0]",
+    "ldp q2, q3, [x0, #32]",
+    "ldp q4, q5, [x0, #64]",
+    "ldp q6, q7, [x0, #96]",
+    "ldp q8, q9, [x0, #128]",
+    "ldp q10, q11, [x0, #160]",
+    "ldp q12, q13, [x0, #192]",
+    "ldp q14, q15, [x0, #224]",
+    "ldp q16, q17, [x0, #256]",
+    "ldp q18, q19, [x0, #288]",
+    "ldp q20, q21, [x0, #320]",
+    "ldp q22, q23, [x0, #352]",
+    "ldp q24, q25, [x0, #384]",
+    "ldp q26, q27, [x0, #416]",
+    "ldp q28, q29, [x0, #448]",
+    "ldp q30, q31, [x0, #480]",
+    "ret",
+);
+
+extern "C" {
+    fn arm_fpu_save_sve(area: u64);
+    fn arm_fpu_restore_sve(area: u64);
+    fn arm_fpu_save_fp(area: u64);
+    fn arm_fpu_restore_fp(area: u64);
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_fpu_cpu_init() -> u64 {
+    let pfr0: u64;
+    unsafe { core::arch::asm!("mrs {}, id_aa64pfr0_el1", out(reg) pfr0, options(nomem, nostack)) };
+    if (pfr0 >> 16) & 0xF == 0xF {
+        return 0; // FP/ASIMD yok
+    }
+    let sve = (pfr0 >> 32) & 0xF != 0;
+    FPU_SVE.store(sve, core::sync::atomic::Ordering::Relaxed);
+    let size = if sve {
+        // RDVL için SVE erişimi geçici olarak açılır
+        low_level_fpu_enable();
+        let vl: u64;
+        unsafe { core::arch::asm!(".arch_extension sve", "rdvl {}, #1", out(reg) vl, options(nomem, nostack)) };
+        FPU_AREA_HEADER + 32 * vl + 17 * (vl / 8)
+    } else {
+        FPU_AREA_HEADER + 32 * 16
+    };
+    low_level_fpu_disable();
+    size
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_fpu_enable() {
+    unsafe {
+        let cpacr: u64;
+        core::arch::asm!("mrs {}, cpacr_el1", out(reg) cpacr, options(nomem, nostack));
+        core::arch::asm!("msr cpacr_el1, {}", "isb", in(reg) cpacr | CPACR_FPEN | CPACR_ZEN, options(nostack));
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_fpu_disable() {
+    unsafe {
+        let cpacr: u64;
+        core::arch::asm!("mrs {}, cpacr_el1", out(reg) cpacr, options(nomem, nostack));
+        core::arch::asm!("msr cpacr_el1, {}", "isb", in(reg) cpacr & !(CPACR_FPEN | CPACR_ZEN), options(nostack));
+    }
+}
+
+/// Sıfır alan ilk durumdur: FPCR = 0 (round-to-nearest, istisna tuzakları kapalı), yazmaçlar sıfır.
+#[no_mangle]
+pub unsafe extern "C" fn low_level_fpu_area_init(_area: u64) {}
+
+#[no_mangle]
+pub unsafe extern "C" fn low_level_fpu_save(area: u64) {
+    if FPU_SVE.load(core::sync::atomic::Ordering::Relaxed) {
+        arm_fpu_save_sve(area);
+    } else {
+        arm_fpu_save_fp(area);
+    }
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn low_level_fpu_restore(area: u64) {
+    if FPU_SVE.load(core::sync::atomic::Ordering::Relaxed) {
+        arm_fpu_restore_sve(area);
+    } else {
+        arm_fpu_restore_fp(area);
+    }
+}
@@ -15,6 +15,7 @@ const CNTV_CTL_EL0: usize = 0xC3FFE048; // Sanal Timer Control Register (örnek
 // Bu değer de platformun kesme haritasından alınmalıdır.
 const TIMER_INTERRUPT_NUMBER: usize = 30;
 
+// Zamanlayıcı kesmesi sayısı. Periyodik tik olmadığından zaman ölçmek için kullanılmaz (bkz. low_level_timer_now_ns).
 static TICKS: AtomicU64 = AtomicU64::new(0);
 
 // **Açıklama**: Zamanlayıcı kesme işleyicisi (handler) fonksiyonu.
@@ -22,19 +23,76 @@ static TICKS: AtomicU64 = AtomicU64::new(0);
 // dışarıdan (örn. kesme vektör tablosundan) erişilebilir olmasını sağlar.
 #[no_mangle]
 extern "C" fn timer_interrupt_handler() {
-    TICKS.fetch_add(1, Ordering::SeqCst); // Tick sayacını artır. `SeqCst` en güçlü hafıza sıralamasıdır.
+    TICKS.fetch_add(1, Ordering::Relaxed);
     clear_timer_interrupt(); // Kesme durumunu temizle (platforma özgü)
-    set_timer(10_000_000); // Zamanlayıcıyı yeniden ayarla (bir sonraki kesme için)
-                                  // **Dikkat**: 10_000_000 değeri frekansa bağlıdır.
-                                  // 10ms aralık için frekansa göre ayarlanmalıdır.
+    // Periyodik yeniden kurma yok: ktimer_interrupt bir sonraki son tarihi low_level_timer_program ile kurar
+    // (bekleyen zamanlayıcı yoksa kapatır).
+    crate::ktimer::ktimer_interrupt();
 }
 
 // **Açıklama**: Zamanlayıcı modülünü başlatma fonksiyonu.
 pub fn init() {
     set_interrupt_handler(TIMER_INTERRUPT_NUMBER, timer_interrupt_handler); // Kesme işleyicisini ayarla
     enable_timer_interrupt(); // Zamanlayıcı kesmesini etkinleştir (platforma özgü)
-    set_timer(10_000_000); // İlk kesmeyi ayarla
-    enable_timer(); // Zamanlayıcıyı başlat
+    // Tickless: ilk son tarih çekirdek tarafından kurulana kadar karşılaştırıcı kapalı kalır.
+    disable_timer();
+    // Paylaşımlı zaman sayfası için EL0'ın CNTVCT_EL0'ı okumasına izin ver (CNTKCTL_EL1.EL0VCTEN, bit 1).
+    // Kayıt CPU başınadır; her CPU bu fonksiyonu çalıştırmalıdır.
+    unsafe { asm!("mrs {tmp}, cntkctl_el1", "orr {tmp}, {tmp}, #2", "msr cntkctl_el1, {tmp}", tmp = out(reg) _) };
+}
+
+// --- Tek Atımlık Zamanlayıcı Kancaları (hardware_specific.h, srctimer.rs tarafından kullanılır) ---
+
+fn counter_frequency() -> u64 {
+    let frequency: u64;
+    unsafe { asm!("mrs {}, cntfrq_el0", out(reg) frequency) };
+    frequency
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_timer_now_ns() -> u64 {
+    let count: u64;
+    unsafe { asm!("isb", "mrs {}, cntpct_el0", out(reg) count) };
+    let frequency = counter_frequency();
+    if frequency == 0 {
+        return 0; // Önyükleyici CNTFRQ_EL0'ı ayarlamadı
+    }
+    (count as u128 * 1_000_000_000 / frequency as u128) as u64
+}
+
+// CNTP_CVAL_EL0 mutlak karşılaştırma değeridir: sayaç bu değere ulaşınca (veya zaten geçmişse) kesme gelir.
+#[no_mangle]
+pub extern "C" fn low_level_timer_program(deadline_ns: u64) {
+    if deadline_ns == u64::MAX {
+        disable_timer();
+        return;
+    }
+    let compare = (deadline_ns as u128 * counter_frequency() as u128 / 1_000_000_000).min(u64::MAX as u128) as u64;
+    unsafe { asm!("msr cntp_cval_el0, {}", in(reg) compare) };
+    enable_timer();
+}
+
+// --- Paylaşımlı Zaman Sayfası Kancaları (srctimepage.rs) ---
+// Kullanıcı alanı sanal sayacı (CNTVCT_EL0) okur; fiziksel sayaçtan CNTVOFF kadar farklı olabilir, bu
+// yüzden taban çekirdekte de sanal sayaçtan örneklenir.
+
+const KARNAL_CLOCK_ARM_CNTVCT: u32 = 2;
+
+#[no_mangle]
+pub extern "C" fn low_level_clock_source() -> u32 {
+    KARNAL_CLOCK_ARM_CNTVCT
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_clock_frequency() -> u64 {
+    counter_frequency()
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_clock_read() -> u64 {
+    let count: u64;
+    unsafe { asm!("isb", "mrs {}, cntvct_el0", out(reg) count) };
+    count
 }
 
 // **Açıklama**: Geçen tick sayısını döndüren fonksiyon.
@@ -44,10 +102,11 @@ pub fn ticks() -> u64 {
 
 // **Açıklama**: Belirtilen milisaniye kadar bekleyen (gecikme) fonksiyonu.
 pub fn delay(ms: u64) {
-    let target_ticks = ticks() + ms; // Hedef tick sayısını hesapla.
-    while ticks() < target_ticks {} // Hedef tick sayısına ulaşılana kadar bekle.
-                                     // **Dikkat**: Bu bloklayıcı (blocking) bir gecikmedir.
-                                     // Gerçek zamanlı sistemlerde dikkatli kullanılmalıdır.
+    let target = low_level_timer_now_ns().saturating_add(ms.saturating_mul(1_000_000)); // Hedef zamanı hesapla.
+    while low_level_timer_now_ns() < target {
+        core::hint::spin_loop();
+    }
+    // **Dikkat**: Bu bloklayıcı (blocking) bir gecikmedir; iş parçacıkları karnal_task_sleep kullanmalıdır.
 }
 
 // **Açıklama**: Zamanlayıcı değerini ayarlayan fonksiyon.
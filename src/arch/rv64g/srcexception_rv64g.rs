@@ -12,6 +12,8 @@ use riscv::register::scause::{Exception, Interrupt, Trap};
 // Örneğin, Karnal64 API'sı src/karnal64/api.rs içinde ise burası 'crate::karnal64::api' olabilir.
 // Şimdilik varsayımsal bir 'super' veya 'crate::karnal64' kullanıyoruz.
 use crate::karnal64::{self, KError}; // Karnal64'ün temel tipleri ve handle_syscall fonksiyonu için
+use crate::srcmmu_rv64g::RiscvMemoryManager; // Sayfa hatası çözümü (tembel sayfalar, COW)
+use crate::kpager::Access;
 
 // Kaydedilmiş kullanıcı bağlamını (registerları) temsil eden yapı.
 // Assembly kodu, trap anında tüm general-purpose registerları, sepc ve sstatus'ı bu yapıya kaydetmelidir.
@@ -99,13 +101,21 @@ pub extern "C" fn riscv_trap_handler(trap_cx: &mut TrapContext) {
                     trap_cx.sepc += 4;
                 }
                 Exception::LoadPageFault | Exception::StorePageFault | Exception::InstructionPageFault => {
-                    // Bellek sayfa hatası (page fault)
-                    println!("Load/Store/Instruction Page Fault: sepc = {:#x}, stval = {:#x}", trap_cx.sepc, stval);
-                    // TODO: Bellek yöneticisine (kmemory) page fault'u handle etmesi için çağrı yap
-                    // Örneğin: match kmemory::handle_page_fault(trap_cx.sepc, stval, exception) { ... }
-                    // Eğer bellek yöneticisi hatayı gideremezse (örn. geçersiz adres),
-                    // görevi sonlandırmamız veya paniklememiz gerekir.
-                    panic!("TODO: Implement Page Fault Handler!");
+                    // Bellek sayfa hatası (page fault): tembel sıfır doldurma ve yazmada kopyalama (srcpager.rs).
+                    // Çözülürse sepc değişmeden dönülür ve komut yeniden çalışır.
+                    let access = match exception {
+                        Exception::StorePageFault => Access::Write,
+                        Exception::InstructionPageFault => Access::Execute,
+                        _ => Access::Read,
+                    };
+                    if let Err(e) = RiscvMemoryManager::handle_page_fault(stval as u64, access) {
+                        println!("Load/Store/Instruction Page Fault: sepc = {:#x}, stval = {:#x}, {:?}", trap_cx.sepc, stval, e);
+                        // Kullanıcı modunun geçersiz erişimi çekirdeği durdurmaz: yalnızca iş parçacığı sonlanır.
+                        if trap_cx.sstatus.spp() == sstatus::SPP::User {
+                            crate::ksched::thread_exit(e as i32);
+                        }
+                        panic!("Unhandled Page Fault!");
+                    }
                 }
                 Exception::IllegalInstruction => {
                     // Geçersiz komut hatası
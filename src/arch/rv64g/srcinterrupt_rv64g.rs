@@ -7,6 +7,9 @@ use riscv::register::{
     scause::{self, Exception, Interrupt, Trap},
     sepc, stval, sstatus,
 };
+use core::sync::atomic::{AtomicBool, AtomicU32, AtomicU64, Ordering};
+use crate::srcmmu_rv64g::RiscvMemoryManager; // Sayfa hatası çözümü (tembel sayfalar, COW)
+use crate::kpager::Access;
 
 // Karnal64 API'sını kullanacağız
 #[allow(unused_imports)] // Henüz tam kullanılmıyor olabilir
@@ -124,17 +127,19 @@ pub extern "C" fn trap_handler(trap_frame: *mut TrapFrame) {
             // sepc kaydında hata oluşturan komutun adresi bulunur.
             let fault_pc = sepc_val;
 
-            // TODO: Bellek yöneticisini çağırarak sayfa hatasını çözmeye çalış.
-            // Karnal64'ün kmemory modülünü kullanın.
-            // Örnek: kmemory::handle_page_fault(fault_address, cause, trap_frame);
-            let handled = kmemory::handle_page_fault(fault_address, cause.bits(), trap_frame);
-
-            if !handled {
-                // Sayfa hatası çözülemedi, bu kritik bir hata.
-                // Görevi sonlandır veya panik yap.
-                println!("Page Fault: addr={:x}, pc={:x}, cause={:?}", fault_address, fault_pc, cause.cause());
-                // TODO: Karnal64'ün ktask modülünü kullanarak mevcut görevi sonlandır.
-                ktask::exit_current_task(KError::BadAddress as i64); // Örnek hata kodu
+            // Tembel sıfır doldurma, imaj sayfaları ve yazmada kopyalama pager'dadır (srcpager.rs).
+            let access = match cause.cause() {
+                Trap::Exception(Exception::StorePageFault) => Access::Write,
+                Trap::Exception(Exception::InstructionPageFault) => Access::Execute,
+                _ => Access::Read,
+            };
+            if let Err(e) = RiscvMemoryManager::handle_page_fault(fault_address as u64, access) {
+                println!("Page Fault: addr={:x}, pc={:x}, cause={:?}, {:?}", fault_address, fault_pc, cause.cause(), e);
+                // Kullanıcı modundan geldiyse (sstatus.SPP = 0) yalnızca iş parçacığı sonlanır.
+                if trap_frame.sstatus & (1 << 8) == 0 {
+                    crate::ksched::thread_exit(e as i32);
+                }
+                panic!("Unhandled kernel page fault");
             }
 
             // Sayfa hatası çözüldüyse (örneğin, sayfa eşlendi),
@@ -152,40 +157,35 @@ pub extern "C" fn trap_handler(trap_frame: *mut TrapFrame) {
         // --- Zaman Uyumsuz Kesmeler (Interrupts) ---
         Trap::Interrupt(Interrupt::SupervisorTimer) => {
             // Süpervizör Zamanlayıcı Kesmesi
-            // Bu kesme, zamanlayıcı (genellikle CLINT) tarafından periyodik olarak üretilir
-            // ve görev zamanlama için kullanılır.
-
-            // TODO: Zamanlayıcı kesmesini CLINT'te veya ilgili donanımda temizle.
-            // Bu çok önemli, yoksa kesme tekrar tekrar tetiklenir.
-             use riscv::register::mtimecmp; // CLINT için mtimecmp yazma
-             let next_timer = get_current_time() + TIMER_INTERVAL;
-             unsafe { mtimecmp::write(next_timer); }
-
-            // TODO: Zamanlayıcı tikini işle ve görev zamanlayıcıyı (scheduler) çalıştır.
-            // Karnal64'ün ktask modülünü kullanın.
-            ktask::timer_tick(trap_frame); // Scheduler bu fonksiyonda görev değiştirebilir
+            // Periyodik değildir: çekirdeğin low_level_timer_program ile kurduğu bir sonraki son tarihte gelir.
+            // ktimer_interrupt dolan uykuları uyandırır, zaman dilimini denetler ve karşılaştırıcıyı
+            // sbi_set_timer ile yeniden kurar (bu, bekleyen STIP bitini de temizler).
+            crate::ktimer::ktimer_interrupt();
+
+            // Zaman dilimi dolduysa kullanıcı moduna dönüşte iş parçacığı değiştirilir (sstatus.SPP = 0: U-mode'dan gelindi).
+            if trap_frame.sstatus & (1 << 8) == 0 {
+                crate::ksched::ksched_preempt_point();
+            }
 
             // Kesme işleyiciden geri döndüğümüzde sepc'nin ayarlanmasına gerek yok,
             // çünkü kesintiye uğrayan komutun kaldığı yerden devam etmesi gerekir.
         }
         Trap::Interrupt(Interrupt::SupervisorExternal) => {
-            // Süpervizör Harici Kesme
-            // Genellikle PLIC (Platform-Level Interrupt Controller) tarafından yönlendirilen
-            // harici cihazlardan (UART, disk, ağ kartı vb.) gelen kesmeler.
-
-            // TODO: PLIC'i sorgulayarak hangi cihazın kesme ürettiğini bul.
-            // TODO: İlgili cihaz sürücüsünün kesme işleyicisini çağır.
-            // Sürücüler Karnal64'ün ResourceProvider traitini implemente edebilir ve
-            // kesmeleri işlemek için özel bir mekanizmaya sahip olabilirler.
-            // Örnek: let interrupt_id = plic::claim();
-                    resource_manager::dispatch_interrupt(interrupt_id); // ResourceProvider traitinin parçası olabilir
-                    plic::complete(interrupt_id); // Kesmeyi PLIC'te tamamla
-
-            println!("Unhandled Supervisor External Interrupt");
-            // İşlenmeyen kesmeler genellikle bir hata değildir, sadece göz ardı edilebilir
-            // veya bir debug mesajı verilebilir.
+            // Süpervizör Harici Kesme: PLIC'e yönlendirilen cihazlar (UART, disk, ağ kartı vb.).
+            // Bekleyen kaynaklar talep edilir (claim), kirq'e dağıtılır ve tamamlanır (complete).
+            handle_external();
+            if trap_frame.sstatus & (1 << 8) == 0 {
+                crate::ksched::ksched_preempt_point();
+            }
+        }
+        Trap::Interrupt(Interrupt::SupervisorSoft) => {
+            // İşlemciler arası kesme (SBI IPI, sip.SSIP). Nedeni CPU'nun bekleyen IPI maskesindedir.
+            handle_ipi();
+            if trap_frame.sstatus & (1 << 8) == 0 {
+                crate::ksched::ksched_preempt_point();
+            }
         }
-        // TODO: Diğer kesme türlerini ekleyin (örn. yazılım kesmesi, makine kesmeleri)
+        // TODO: Diğer kesme türlerini ekleyin (örn. makine kesmeleri)
         Trap::Interrupt(_) => {
              // Bilinmeyen veya işlenmeyen kesme
              println!("Unhandled Interrupt: cause={:?}", cause.cause());
@@ -199,6 +199,323 @@ pub extern "C" fn trap_handler(trap_frame: *mut TrapFrame) {
     // assembly yeni görevin trap_frame'ini yükleyecektir.
 }
 
+// --- İşlemciler Arası Kesmeler (IPI) ---
+// Tek bir yazılım kesmesi (SSIP) vardır: gönderen hedefin bekleyen maskesine nedeni yazar, ardından
+// SBI IPI eklentisiyle hedef hart'ta SSIP'i kaldırır. SSIP ayrı bir scause türüdür ve kirq'in numara
+// uzayında (PLIC kaynakları) yer almaz; ayrılacak bir numara yoktur.
+
+const SBI_EXT_IPI: usize = 0x0073_5049; // "sPI"
+const SBI_IPI_SEND_IPI: usize = 0;
+
+const IPI_TLB_SHOOTDOWN: u32 = 1 << 0;
+const IPI_RESCHEDULE: u32 = 1 << 1;
+
+const MAX_CPUS: usize = 32; // ksched::MAX_CPUS
+const NO_HART: u64 = u64::MAX;
+
+extern "C" {
+    fn low_level_cpu_id() -> u32; // srctask_rv64g.rs
+    fn low_level_interrupt_save() -> u64;
+    fn low_level_interrupt_restore(state: u64);
+}
+
+static IPI_PENDING: [AtomicU32; MAX_CPUS] = [const { AtomicU32::new(0) }; MAX_CPUS];
+// Mantıksal CPU -> hartid. S modunda hartid okunamaz; açılış yolu (a0) riscv_cpu_set_hart ile bildirir.
+// Bildirilmemiş CPU'larda hartid mantıksal numaraya eşit varsayılır (QEMU virt).
+static CPU_HARTS: [AtomicU64; MAX_CPUS] = [const { AtomicU64::new(NO_HART) }; MAX_CPUS];
+
+#[no_mangle]
+pub extern "C" fn riscv_cpu_set_hart(cpu: u32, hartid: u64) {
+    if let Some(slot) = CPU_HARTS.get(cpu as usize) {
+        slot.store(hartid, Ordering::Release);
+    }
+}
+
+fn hart_of(cpu: u32) -> u64 {
+    match CPU_HARTS[cpu as usize].load(Ordering::Acquire) {
+        NO_HART => cpu as u64,
+        hart => hart,
+    }
+}
+
+fn send_ipi(cpu: u32, reason: u32) {
+    if cpu as usize >= MAX_CPUS {
+        return;
+    }
+    // Release: posta kutusu yazmaları hedefin maskeyi okumasından önce görünür
+    IPI_PENDING[cpu as usize].fetch_or(reason, Ordering::Release);
+    // sbi_send_ipi(hart_mask = 1, hart_mask_base = hartid)
+    unsafe {
+        core::arch::asm!("ecall",
+            in("a7") SBI_EXT_IPI, in("a6") SBI_IPI_SEND_IPI,
+            inlateout("a0") 1usize => _, inlateout("a1") hart_of(cpu) as usize => _);
+    }
+}
+
+fn handle_ipi() {
+    // SSIP, maske okunmadan önce temizlenir: arada gelen IPI yeniden kesme üretir, kaybolmaz.
+    unsafe { core::arch::asm!("csrc sip, {}", in(reg) 2usize, options(nostack)) };
+    let cpu = unsafe { low_level_cpu_id() } as usize;
+    if cpu >= MAX_CPUS {
+        return;
+    }
+    let reasons = IPI_PENDING[cpu].swap(0, Ordering::Acquire);
+    if reasons & IPI_TLB_SHOOTDOWN != 0 {
+        crate::ktlb::ktlb_handle_shootdown_ipi();
+    }
+    if reasons & IPI_RESCHEDULE != 0 {
+        crate::ksched::ksched_handle_reschedule_ipi();
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_ipi_init() {
+    // Süpervizör yazılım kesmesini aç (sie.SSIE, bit 1); genel kesme biti (sstatus.SIE) dokunulmaz.
+    unsafe { core::arch::asm!("csrs sie, {}", in(reg) 2usize, options(nostack)) };
+    // Harici kesmeler: bu hart'ın S bağlamında eşik 0 (tüm öncelikler geçer), sie.SEIE (bit 9)
+    let ctx = plic_context(unsafe { low_level_cpu_id() });
+    unsafe {
+        core::ptr::write_volatile((PLIC_BASE + PLIC_CONTEXT + PLIC_CONTEXT_STRIDE * ctx) as *mut u32, 0);
+        core::arch::asm!("csrs sie, {}", in(reg) 1usize << 9, options(nostack));
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_send_tlb_shootdown_ipi(cpu: u32) {
+    send_ipi(cpu, IPI_TLB_SHOOTDOWN);
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_send_reschedule_ipi(cpu: u32) {
+    send_ipi(cpu, IPI_RESCHEDULE);
+}
+
+// --- SMP Açılışı (SBI HSM hart_start, hardware_specific.h) ---
+// Hart listesi aygıt ağacından okunmadığından 0..MAX_CPUS hartid'leri denenir; SBI var olmayan hart için hata
+// döner. Hart S modunda, satp = 0 ile riscv_secondary_entry'de başlar (a0 = hartid, a1 = başlangıç bloğu);
+// çekirdek kimlik eşlemeli olduğundan önyükleme CPU'sunun satp ve stvec değerini yükleyip aynı adreslerle
+// devam eder. Önyükleme hart'ı platform_init'te riscv_cpu_set_hart(0, ...) ile bildirilir.
+// TODO: Hartid'ler aygıt ağacının /cpus düğümünden okunmalı.
+
+const SBI_EXT_HSM: usize = 0x0048_534D; // "HSM"
+const SBI_HSM_HART_START: usize = 0;
+const AP_STACK_ORDER: u32 = 2; // 16KB
+const PAGE_SIZE: u64 = 4096;
+
+// riscv_secondary_entry'nin okuduğu blok (ofsetler aşağıdaki kodla EŞLEŞMELİDİR)
+#[repr(C)]
+struct ApStart {
+    stack_top: u64, // 0
+    stvec: u64,     // 8
+    satp: u64,      // 16
+    cpu: u64,       // 24
+}
+
+// Her blok yalnızca hart_start öncesinde önyükleme CPU'su tarafından yazılır
+static mut AP_STARTS: [ApStart; MAX_CPUS] = [const { ApStart { stack_top: 0, stvec: 0, satp: 0, cpu: 0 } }; MAX_CPUS];
+
+core::arch::global_asm!(
+    ".global riscv_secondary_entry",
+    "riscv_secondary_entry:",
+    "ld sp, 0(a1)",
+    "ld t0, 8(a1)",
+    "csrw stvec, t0",
+    "ld t0, 16(a1)",
+    "sfence.vma",
+    "csrw satp, t0",
+    "sfence.vma",
+    "mv t1, a0",
+    "ld a0, 24(a1)",
+    "mv a1, t1",
+    "call riscv_secondary_main",
+    "1:",
+    "wfi",
+    "j 1b",
+);
+
+extern "C" {
+    fn riscv_secondary_entry();
+    fn riscv_cpu_set_id(cpu: u32); // srctask_rv64g.rs
+    fn kmem_phys_alloc_frames(order: u32) -> u64;
+    fn kmem_phys_free_frames(addr: u64, order: u32);
+    fn karnal_secondary_start(cpu: u32) -> !;
+}
+
+#[no_mangle]
+pub extern "C" fn riscv_secondary_main(cpu: u64, hartid: u64) -> ! {
+    let cpu = cpu as u32;
+    unsafe { riscv_cpu_set_id(cpu) };
+    riscv_cpu_set_hart(cpu, hartid);
+    unsafe { karnal_secondary_start(cpu) }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_start_secondary_cpus() -> u32 {
+    let (stvec, satp): (u64, u64);
+    unsafe { core::arch::asm!("csrr {}, stvec", "csrr {}, satp", out(reg) stvec, out(reg) satp, options(nomem, nostack)) };
+    let boot_hart = hart_of(0);
+
+    let mut started = 0u32;
+    for hartid in 0..MAX_CPUS as u64 {
+        let next = started as usize + 1;
+        if next == MAX_CPUS {
+            break;
+        }
+        if hartid == boot_hart {
+            continue;
+        }
+        let stack = unsafe { kmem_phys_alloc_frames(AP_STACK_ORDER) };
+        if stack == 0 {
+            break;
+        }
+        let block = unsafe { core::ptr::addr_of_mut!(AP_STARTS[next]) };
+        unsafe {
+            block.write(ApStart { stack_top: stack + (PAGE_SIZE << AP_STACK_ORDER), stvec, satp, cpu: next as u64 });
+            core::arch::asm!("fence rw, rw", options(nostack));
+        }
+        let error: isize;
+        unsafe {
+            core::arch::asm!("ecall",
+                in("a7") SBI_EXT_HSM, in("a6") SBI_HSM_HART_START,
+                inlateout("a0") hartid as usize => error, inlateout("a1") riscv_secondary_entry as usize => _,
+                in("a2") block as usize);
+        }
+        if error == 0 {
+            started += 1;
+        } else {
+            unsafe { kmem_phys_free_frames(stack, AP_STACK_ORDER) };
+        }
+    }
+    started
+}
+
+// --- Harici Kesmeler (PLIC; hardware_specific.h kesme denetleyicisi kancaları) ---
+// kirq numarası PLIC kaynak numarasıdır (1-1023; 0 "kaynak yok"). Kaynaklar önyükleme CPU'sunun S
+// bağlamında açılır. TODO: Taban adres aygıt ağacından ("riscv,plic0"); QEMU virt değerleri varsayılır.
+
+const PLIC_BASE: u64 = 0x0C00_0000;
+const PLIC_PRIORITY: u64 = 0x0;              // Kaynak başına 4 bayt
+const PLIC_ENABLE: u64 = 0x2000;             // Bağlam başına 0x80 bayt, kayıt başına 32 kaynak
+const PLIC_ENABLE_STRIDE: u64 = 0x80;
+const PLIC_CONTEXT: u64 = 0x20_0000;         // Bağlam başına: +0 eşik, +4 talep/tamamlama
+const PLIC_CONTEXT_STRIDE: u64 = 0x1000;
+const PLIC_SOURCES: u32 = 1024;
+
+// Etkinleştirme kayıtları 32 kaynağı paylaşır; oku-değiştir-yaz başka CPU'larla ve kesme bağlamındaki
+// tembel maskelemeyle (kirq) yarışmamalı.
+static PLIC_ENABLE_LOCK: AtomicBool = AtomicBool::new(false);
+
+// QEMU virt: hart h'nin M bağlamı 2h, S bağlamı 2h + 1
+fn plic_context(cpu: u32) -> u64 {
+    2 * hart_of(cpu.min(MAX_CPUS as u32 - 1)) + 1
+}
+
+fn plic_set_enabled(irq: u32, enabled: bool) {
+    if irq == 0 || irq >= PLIC_SOURCES {
+        return;
+    }
+    let reg = (PLIC_BASE + PLIC_ENABLE + PLIC_ENABLE_STRIDE * plic_context(0) + 4 * (irq / 32) as u64) as *mut u32;
+    let state = unsafe { low_level_interrupt_save() };
+    while PLIC_ENABLE_LOCK.swap(true, Ordering::Acquire) {
+        core::hint::spin_loop();
+    }
+    unsafe {
+        let bits = core::ptr::read_volatile(reg);
+        core::ptr::write_volatile(reg, if enabled { bits | 1 << (irq % 32) } else { bits & !(1 << (irq % 32)) });
+    }
+    PLIC_ENABLE_LOCK.store(false, Ordering::Release);
+    unsafe { low_level_interrupt_restore(state) };
+}
+
+fn handle_external() {
+    let claim = (PLIC_BASE + PLIC_CONTEXT + PLIC_CONTEXT_STRIDE * plic_context(unsafe { low_level_cpu_id() }) + 4) as *mut u32;
+    loop {
+        let irq = unsafe { core::ptr::read_volatile(claim) };
+        if irq == 0 {
+            return;
+        }
+        crate::kirq::kirq_dispatch(irq);
+        unsafe { core::ptr::write_volatile(claim, irq) };
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_irq_mask(irq: u32) {
+    plic_set_enabled(irq, false);
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_irq_unmask(irq: u32) {
+    if irq != 0 && irq < PLIC_SOURCES {
+        // Öncelik 0 kaynağı kapatır; tüm kaynaklar aynı (en düşük etkin) öncelikte
+        unsafe { core::ptr::write_volatile((PLIC_BASE + PLIC_PRIORITY + 4 * irq as u64) as *mut u32, 1) };
+    }
+    plic_set_enabled(irq, true);
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_irq_set_affinity(_irq: u32, _cpu: u32) -> i64 {
+    // TODO: Etkinleştirme bitini hedef CPU'nun bağlamına taşı.
+    -38 // KERROR_NOT_SUPPORTED
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_irq_msi_range(first: *mut u32, count: *mut u32) {
+    // TODO: AIA/IMSIC; PLIC MSI almaz
+    unsafe {
+        *first = 0;
+        *count = 0;
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_msi_compose(_irq: u32, _cpu: u32, _address: *mut u64, _data: *mut u32) -> i64 {
+    -38 // KERROR_NOT_SUPPORTED
+}
+
+// --- Çekirdek Konsolu UART'ı (16550A; hardware_specific.h, srcconsole.rs) ---
+// TODO: Taban adres ve PLIC kaynağı aygıt ağacından ("ns16550a"); QEMU virt değerleri varsayılır.
+const UART_BASE: u64 = 0x1000_0000;
+const UART_IER: u64 = 1; // bit 1: verici boş kesmesi (ETBEI)
+const UART_MCR: u64 = 4; // bit 3: OUT2
+const UART_LSR: u64 = 5; // bit 5: verici tutucu ve FIFO boş (THRE)
+const UART_FIFO_SIZE: u32 = 16;
+const UART_PLIC_SOURCE: u32 = 10;
+
+fn uart_read(reg: u64) -> u8 {
+    unsafe { core::ptr::read_volatile((UART_BASE + reg) as *const u8) }
+}
+
+fn uart_write(reg: u64, value: u8) {
+    unsafe { core::ptr::write_volatile((UART_BASE + reg) as *mut u8, value) };
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_console_putc(c: u8) {
+    while uart_read(UART_LSR) & 0x20 == 0 {
+        core::hint::spin_loop();
+    }
+    uart_write(0, c);
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_console_tx_room() -> u32 {
+    // 16550A yalnızca "FIFO boş" bildirir; boşsa FIFO'nun tamamı yazılabilir
+    if uart_read(UART_LSR) & 0x20 != 0 { UART_FIFO_SIZE } else { 0 }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_console_tx_irq_enable(enable: u32) {
+    let ier = uart_read(UART_IER);
+    uart_write(UART_IER, if enable != 0 { ier | 0x02 } else { ier & !0x02 });
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_console_irq() -> u32 {
+    uart_write(UART_MCR, uart_read(UART_MCR) | 0x08);
+    UART_PLIC_SOURCE
+}
+
 // --- Başlatma Fonksiyonu ---
 // Çekirdek başlangıcında (boot) çağrılarak tuzak işleyiciyi ayarlar.
 pub fn init() {
@@ -222,6 +539,8 @@ pub fn init() {
          riscv::register::stvec::write(trap_entry_address, stvec::TrapMode::Direct);
         // Alternatif olarak ham CSR yazma:
         core::arch::asm!("csrw stvec, {0}", in(reg) trap_entry_address, options(nostack));
+        // Paylaşımlı zaman sayfası: U-mode'un `time` CSR'ını (rdtime) okumasına izin ver (scounteren.TM, bit 1).
+        core::arch::asm!("csrs scounteren, {0}", in(reg) 2usize, options(nostack));
     }
 
     // Süpervizör Yazılım Kesmeleri (SSIP) için bir kesme kurabiliriz.
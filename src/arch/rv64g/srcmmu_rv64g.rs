@@ -4,6 +4,10 @@
 // (karnal64.rs dosyası içinde tanımlanmış olmaları gerekir)
 // use crate::karnal64::{KError, KHandle}; // Eğer karnal64 modülü crate kökünde ise
 use super::karnal64::{KError, KHandle}; // Eğer karnal64 modülü super modülde ise (yaygın kernel yapısı)
+use crate::kasid::{AsidAllocator, AddressSpaceTable}; // ASID dağıtımı (srcasid.rs)
+use crate::kpager::{self, Access, FaultMmu}; // Tembel sayfalar ve COW (srcpager.rs)
+use crate::ktlb::{self, TlbBatch}; // Toplu TLB geçersiz kılma (srctlb.rs)
+use core::arch::asm;
 
 // --- RISC-V MMU Sabitleri ---
 
@@ -14,13 +18,18 @@ const PAGE_SHIFT: usize = 12;
 
 /// Sanal adresin sayfa ofseti (VA[11:0])
 const VA_OFFSET_BITS: usize = 12;
-/// Sanal adresin 1. seviye dizini (VA[21:12])
-const VA_VPN0_BITS: usize = 10;
-/// Sanal adresin 2. seviye dizini (VA[30:22])
-const VA_VPN1_BITS: usize = 10;
-/// Sanal adresin 3. seviye dizini (VA[38:31]) - Sv39 için
+/// Sanal adresin 1. seviye dizini (VA[20:12])
+const VA_VPN0_BITS: usize = 9;
+/// Sanal adresin 2. seviye dizini (VA[29:21])
+const VA_VPN1_BITS: usize = 9;
+/// Sanal adresin 3. seviye dizini (VA[38:30]) - Sv39 için
 const VA_VPN2_BITS: usize = 9;
 
+/// Seviye 1 yaprak PTE'nin kapsadığı megasayfa boyutu (2MB)
+pub const MEGAPAGE_SIZE: usize = 1 << (PAGE_SHIFT + VA_VPN0_BITS);
+/// Seviye 2 yaprak PTE'nin kapsadığı gigasayfa boyutu (1GB)
+pub const GIGAPAGE_SIZE: usize = 1 << (PAGE_SHIFT + VA_VPN0_BITS + VA_VPN1_BITS);
+
 /// Sayfa tablosu girişlerinin bir tablodaki sayısı (PAGE_SIZE / 8 byte/PTE)
 const ENTRIES_PER_PAGE_TABLE: usize = PAGE_SIZE / core::mem::size_of::<PageTableEntry>(); // 512
 
@@ -285,9 +294,10 @@ impl RiscvMemoryManager {
                 // Yaprak PTE bulundu, fiziksel adresi hesapla
                 // Yaprak PTE'lerde PPN, fiziksel sayfanın (veya büyük sayfanın) başlangıcını gösterir.
                 // Sanal adresin ofset kısmı eklenmelidir.
-                let page_offset = current_vaddr & ((1 << PAGE_SHIFT) - 1); // vaddr & 0xFFF
-                let paddr = (pte.ppn() << PAGE_SHIFT) | page_offset;
-                // TODO: Büyük sayfa (superpage) haritalamaları için kontrol ve hesaplama ekle (Sv39'da 2MB, 1GB)
+                // Üst seviyelerdeki yapraklar süper sayfadır (seviye 1: 2MB, seviye 2: 1GB);
+                // ofset, yaprağın kapsadığı tüm alt VPN alanlarını içerir.
+                let page_offset = current_vaddr & (Self::leaf_size(level) as u64 - 1);
+                let paddr = ((pte.ppn() << PAGE_SHIFT) & !(Self::leaf_size(level) as u64 - 1)) | page_offset;
                 return Ok(paddr);
             } else {
                 // Tablo PTE bulundu, bir sonraki seviye sayfa tablosuna in
@@ -424,6 +434,248 @@ impl RiscvMemoryManager {
          Err(KError::InternalError)
     }
 
+    /// Verilen seviyedeki bir yaprak PTE'nin kapsadığı bayt sayısı (0: 4KB, 1: 2MB, 2: 1GB).
+    fn leaf_size(level: usize) -> usize {
+        match level {
+            0 => PAGE_SIZE,
+            1 => MEGAPAGE_SIZE,
+            _ => GIGAPAGE_SIZE,
+        }
+    }
+
+    /// Sv39 sanal adresinden verilen seviyenin VPN dizinini çıkarır.
+    fn vpn_index(vaddr: u64, level: usize) -> usize {
+        ((vaddr >> (PAGE_SHIFT + level * VA_VPN0_BITS)) & ((1 << VA_VPN0_BITS) - 1)) as usize
+    }
+
+    /// Bir süper sayfayı (megasayfa veya gigasayfa) tek bir yaprak PTE ile haritalar.
+    /// `level`: 1 ise 2MB, 2 ise 1GB. `vaddr` ve `paddr` bu boyuta hizalı olmalıdır.
+    /// Diğer parametreler `map_page_in_table` ile aynıdır.
+    pub fn map_superpage_in_table(
+        root_page_table_paddr: u64,
+        vaddr: u64,
+        paddr: u64,
+        level: usize,
+        mut flags: u64,
+        is_kernel: bool,
+    ) -> Result<(), KError> {
+        if level == 0 || level > 2 {
+            return Err(KError::InvalidArgument);
+        }
+        let size = Self::leaf_size(level) as u64;
+        if vaddr & (size - 1) != 0 || paddr & (size - 1) != 0 {
+            return Err(KError::InvalidArgument);
+        }
+        // Yaprak olabilmesi için R, W veya X bayraklarından en az biri gereklidir.
+        if flags & (PteFlags::R.bits() | PteFlags::W.bits() | PteFlags::X.bits()) == 0 {
+            return Err(KError::InvalidArgument);
+        }
+
+        if !is_kernel {
+            flags |= PteFlags::U.bits();
+        } else {
+            flags &= !PteFlags::U.bits();
+        }
+
+        let mut current_pt_paddr = root_page_table_paddr;
+        let mut current_level = 2;
+        loop {
+            let page_table = unsafe { &mut *(current_pt_paddr as *mut PageTable) };
+            let pte = page_table.entry(Self::vpn_index(vaddr, current_level));
+
+            if current_level == level {
+                // Mevcut bir yaprak veya alt tablo varsa çakışma; alt tabloyu sessizce ezmek
+                // altındaki eşlemeleri sızdırırdı.
+                if pte.is_valid() {
+                    return Err(KError::AlreadyExists);
+                }
+                *pte = PageTableEntry::new(paddr >> PAGE_SHIFT, flags | PteFlags::V.bits());
+                flush_tlb(Some(vaddr));
+                return Ok(());
+            }
+
+            if !pte.is_valid() {
+                let next_level_pt_paddr = allocate_physical_frame()?;
+                unsafe { core::ptr::write_bytes(next_level_pt_paddr as *mut u8, 0, PAGE_SIZE) };
+                *pte = PageTableEntry::new(next_level_pt_paddr >> PAGE_SHIFT, PteFlags::V.bits());
+                current_pt_paddr = next_level_pt_paddr;
+            } else if pte.is_leaf() {
+                // Daha büyük bir süper sayfa bu alanı zaten kapsıyor.
+                return Err(KError::AlreadyExists);
+            } else {
+                current_pt_paddr = pte.ppn() << PAGE_SHIFT;
+            }
+            current_level -= 1;
+        }
+    }
+
+    /// Bir süper sayfa eşlemesini kaldırır ve yaprağın gösterdiği fiziksel adresi döndürür.
+    /// Fiziksel bellek serbest bırakılmaz; süper sayfalar genellikle aygıt veya doğrudan
+    /// eşleme alanlarıdır ve sahibi çağırandır.
+    pub fn unmap_superpage_in_table(root_page_table_paddr: u64, vaddr: u64, level: usize) -> Result<u64, KError> {
+        if level == 0 || level > 2 {
+            return Err(KError::InvalidArgument);
+        }
+        if vaddr & (Self::leaf_size(level) as u64 - 1) != 0 {
+            return Err(KError::InvalidArgument);
+        }
+
+        let mut current_pt_paddr = root_page_table_paddr;
+        let mut current_level = 2;
+        loop {
+            let page_table = unsafe { &mut *(current_pt_paddr as *mut PageTable) };
+            let pte = page_table.entry(Self::vpn_index(vaddr, current_level));
+            if !pte.is_valid() {
+                return Err(KError::NotFound);
+            }
+            if current_level == level {
+                if !pte.is_leaf() {
+                    // Bu seviyede süper sayfa değil alt tablo var
+                    return Err(KError::InvalidArgument);
+                }
+                let paddr = pte.ppn() << PAGE_SHIFT;
+                *pte = PageTableEntry::empty();
+                flush_tlb(Some(vaddr));
+                return Ok(paddr);
+            }
+            if pte.is_leaf() {
+                // İstenenden daha büyük bir süper sayfa; parçalanması desteklenmiyor.
+                return Err(KError::InvalidArgument);
+            }
+            current_pt_paddr = pte.ppn() << PAGE_SHIFT;
+            current_level -= 1;
+        }
+    }
+
+    /// Bir sanal adres aralığını fiziksel aralığa haritalar.
+    /// Her adımda hizalamanın ve kalan boyutun izin verdiği en büyük yaprak (1GB, 2MB, 4KB) seçilir;
+    /// böylece büyük çekirdek/aygıt alanları TLB'de çok daha az giriş tüketir.
+    /// Altında zaten bir tablo bulunan (kısmen dolu) süper sayfa yuvaları 4KB sayfalarla doldurulur.
+    /// `vaddr`, `paddr` ve `size` sayfa hizalı olmalıdır.
+    pub fn map_range_in_table(
+        root_page_table_paddr: u64,
+        vaddr: u64,
+        paddr: u64,
+        size: usize,
+        flags: u64,
+        is_kernel: bool,
+    ) -> Result<(), KError> {
+        let page_mask = PAGE_SIZE as u64 - 1;
+        if vaddr & page_mask != 0 || paddr & page_mask != 0 || size as u64 & page_mask != 0 {
+            return Err(KError::InvalidArgument);
+        }
+
+        let mut offset = 0u64;
+        while offset < size as u64 {
+            let v = vaddr + offset;
+            let p = paddr + offset;
+            let remaining = size as u64 - offset;
+
+            let mut mapped = 0u64;
+            for level in [2usize, 1] {
+                let leaf = Self::leaf_size(level) as u64;
+                // Altında zaten bir tablo olan (kısmen dolu) yuvaya süper sayfa yazılamaz; bir alt boyuta in.
+                if remaining >= leaf && v & (leaf - 1) == 0 && p & (leaf - 1) == 0
+                    && !Self::slot_is_table(root_page_table_paddr, v, level)
+                {
+                    Self::map_superpage_in_table(root_page_table_paddr, v, p, level, flags, is_kernel)?;
+                    mapped = leaf;
+                    break;
+                }
+            }
+            if mapped == 0 {
+                Self::map_page_in_table(root_page_table_paddr, v, p, flags, is_kernel)?;
+                mapped = PAGE_SIZE as u64;
+            }
+            offset += mapped;
+        }
+        Ok(())
+    }
+
+    /// `map_range_in_table` ile kurulmuş bir aralığın eşlemesini kaldırır.
+    /// Aralığın tamamen kapsadığı süper sayfalar tek adımda kaldırılır. Fiziksel bellek serbest bırakılmaz.
+    pub fn unmap_range_in_table(root_page_table_paddr: u64, vaddr: u64, size: usize) -> Result<(), KError> {
+        let page_mask = PAGE_SIZE as u64 - 1;
+        if vaddr & page_mask != 0 || size as u64 & page_mask != 0 {
+            return Err(KError::InvalidArgument);
+        }
+
+        let end = vaddr + size as u64;
+        let mut v = vaddr;
+        while v < end {
+            let leaf = Self::leaf_level(root_page_table_paddr, v)?;
+            let leaf_bytes = Self::leaf_size(leaf) as u64;
+            if leaf == 0 {
+                Self::clear_leaf_in_table(root_page_table_paddr, v)?;
+            } else {
+                // Aralık süper sayfanın yalnızca bir kısmını kapsıyorsa parçalamak yerine reddet.
+                if v & (leaf_bytes - 1) != 0 || end - v < leaf_bytes {
+                    return Err(KError::InvalidArgument);
+                }
+                Self::unmap_superpage_in_table(root_page_table_paddr, v, leaf)?;
+            }
+            v += leaf_bytes;
+        }
+        Ok(())
+    }
+
+    /// `level` seviyesindeki yaprağın yazılacağı PTE bir alt tabloyu gösteriyorsa true döndürür.
+    /// Eksik tablolar oluşturulmaz.
+    fn slot_is_table(root_page_table_paddr: u64, vaddr: u64, level: usize) -> bool {
+        let mut current_pt_paddr = root_page_table_paddr;
+        for current_level in (level..3).rev() {
+            let page_table = unsafe { &*(current_pt_paddr as *const PageTable) };
+            let pte = page_table.entries[Self::vpn_index(vaddr, current_level)];
+            if !pte.is_valid() || pte.is_leaf() {
+                return false;
+            }
+            if current_level == level {
+                return true;
+            }
+            current_pt_paddr = pte.ppn() << PAGE_SHIFT;
+        }
+        false
+    }
+
+    /// `vaddr`'ı eşleyen yaprak PTE'nin seviyesini döndürür.
+    fn leaf_level(root_page_table_paddr: u64, vaddr: u64) -> Result<usize, KError> {
+        let mut current_pt_paddr = root_page_table_paddr;
+        for level in (0..3).rev() {
+            let page_table = unsafe { &*(current_pt_paddr as *const PageTable) };
+            let pte = page_table.entries[Self::vpn_index(vaddr, level)];
+            if !pte.is_valid() {
+                return Err(KError::NotFound);
+            }
+            if pte.is_leaf() {
+                return Ok(level);
+            }
+            current_pt_paddr = pte.ppn() << PAGE_SHIFT;
+        }
+        Err(KError::InternalError)
+    }
+
+    /// 4KB yaprak PTE'yi fiziksel sayfayı serbest bırakmadan geçersiz yapar.
+    /// `unmap_page_in_table`'dan farkı: aralık eşlemeleri çağıranın sahip olduğu belleği gösterir.
+    fn clear_leaf_in_table(root_page_table_paddr: u64, vaddr: u64) -> Result<(), KError> {
+        let mut current_pt_paddr = root_page_table_paddr;
+        for level in (1..3).rev() {
+            let page_table = unsafe { &*(current_pt_paddr as *const PageTable) };
+            let pte = page_table.entries[Self::vpn_index(vaddr, level)];
+            if !pte.is_table() {
+                return Err(KError::InternalError);
+            }
+            current_pt_paddr = pte.ppn() << PAGE_SHIFT;
+        }
+        let page_table = unsafe { &mut *(current_pt_paddr as *mut PageTable) };
+        let pte = page_table.entry(Self::vpn_index(vaddr, 0));
+        if !pte.is_leaf() {
+            return Err(KError::NotFound);
+        }
+        *pte = PageTableEntry::empty();
+        flush_tlb(Some(vaddr));
+        Ok(())
+    }
+
 
     // --- Karnal64 Memory API Karşılıkları ---
     // Bu fonksiyonlar, karnal64.rs'deki public `memory_*` fonksiyonları tarafından çağrılmak üzere tasarlanmıştır.
@@ -610,12 +862,133 @@ impl RiscvMemoryManager {
      }
 
 
+    // --- Adres Alanı Geçişi (ASID) ---
+
+    /// satp.ASID alanının donanımdaki genişliğini yoklar (tüm bitler yazılıp geri okunur)
+    /// ve ASID dağıtıcısını buna göre ayarlar. Önyükleme CPU'sunda, `init` sonrası bir kez çağrılır.
+    pub fn init_asids() {
+        let bits = unsafe {
+            let saved: u64;
+            asm!("csrr {}, satp", out(reg) saved);
+            let probe = saved | SATP_ASID_MASK;
+            asm!("csrw satp, {}", in(reg) probe);
+            let readback: u64;
+            asm!("csrr {}, satp", out(reg) readback);
+            asm!("csrw satp, {}", in(reg) saved);
+            ((readback & SATP_ASID_MASK) >> SATP_ASID_SHIFT).count_ones()
+        };
+        RV_ASIDS.set_bits(bits);
+    }
+
+    /// Yeni bir görev adres alanını ASID tablosuna kaydeder. Tablo doluysa adres alanı etiketsiz çalışır.
+    pub fn register_address_space(root_page_table_paddr: u64) {
+        let _ = RV_ADDRESS_SPACES.register(root_page_table_paddr);
+    }
+
+    /// Yıkılan adres alanının kaydını siler. ASID'i nesil dönene kadar yeniden verilmez,
+    /// bu yüzden TLB'deki eski girdileri için temizlik gerekmez.
+    /// Pager bölgelerindeki yaprak frame'leri de bırakılır (paylaşılanlar diğer sahiplerde yaşar).
+    pub fn release_address_space(root_page_table_paddr: u64) {
+        if RV_ADDRESS_SPACES.lookup(root_page_table_paddr).map_or(true, |ctx| ctx.asid() == 0) {
+            // Etiketsiz adres alanının girdileri frame'ler iade edilmeden önce her hart'tan atılmalı
+            let mut batch = TlbBatch::all_cpus();
+            batch.add_all();
+            batch.flush();
+        }
+        RV_ADDRESS_SPACES.unregister(root_page_table_paddr);
+        Self::release_pager_frames(root_page_table_paddr, root_page_table_paddr, 2, 0);
+        kpager::release_space(root_page_table_paddr);
+    }
+
+    // Tablonun (seviye 2/1/0) kapsadığı yapraklar içinde pager'a ait olanların frame'lerini bırakır.
+    // Kök seviyede yalnızca kullanıcı yarısı (ilk 256 girdi) taranır.
+    fn release_pager_frames(root: u64, table_paddr: u64, level: usize, base: u64) {
+        let page_table = unsafe { &mut *(table_paddr as *mut PageTable) };
+        let count = if level == 2 { ENTRIES_PER_PAGE_TABLE / 2 } else { ENTRIES_PER_PAGE_TABLE };
+        for i in 0..count {
+            let pte = *page_table.entry(i);
+            let vaddr = base + (i * Self::leaf_size(level)) as u64;
+            if pte.is_table() {
+                Self::release_pager_frames(root, pte.ppn() << PAGE_SHIFT, level - 1, vaddr);
+            } else if level == 0 && pte.is_leaf() && kpager::owns(root, vaddr) {
+                kpager::release_frame(pte.ppn() << PAGE_SHIFT);
+            }
+        }
+    }
+
+    // --- Sayfa Hataları (srcpager.rs) ---
+
+    /// `vaddr`'daki 4K yaprağı (frame, yazılabilir mi) olarak döner; yoksa veya süper sayfaysa None.
+    fn lookup_leaf(root_page_table_paddr: u64, vaddr: u64) -> Option<(u64, bool)> {
+        let mut current_pt_paddr = root_page_table_paddr;
+        for level in (0..3).rev() {
+            let page_table = unsafe { &mut *(current_pt_paddr as *mut PageTable) };
+            let pte = *page_table.entry(Self::vpn_index(vaddr, level));
+            if !pte.is_valid() || (level > 0 && pte.is_leaf()) {
+                return None;
+            }
+            if level == 0 {
+                return Some((pte.ppn() << PAGE_SHIFT, pte.0 & PteFlags::W.bits() != 0));
+            }
+            current_pt_paddr = pte.ppn() << PAGE_SHIFT;
+        }
+        None
+    }
+
+    /// 4K yaprağı yazar (ara tablolar gerekirse oluşturulur); mevcut yaprağın üzerine yazar ve eski frame'i döner.
+    fn set_leaf_in_table(root_page_table_paddr: u64, vaddr: u64, paddr: u64, flags: u64) -> Result<Option<u64>, KError> {
+        let mut current_pt_paddr = root_page_table_paddr;
+        for level in (1..3).rev() {
+            let page_table = unsafe { &mut *(current_pt_paddr as *mut PageTable) };
+            let pte = page_table.entry(Self::vpn_index(vaddr, level));
+            if !pte.is_valid() {
+                let next_level_pt_paddr = allocate_physical_frame()?;
+                unsafe { core::ptr::write_bytes(next_level_pt_paddr as *mut u8, 0, PAGE_SIZE) };
+                *pte = PageTableEntry::new(next_level_pt_paddr >> PAGE_SHIFT, PteFlags::V.bits());
+            } else if pte.is_leaf() {
+                return Err(KError::AlreadyExists); // Süper sayfanın içi
+            }
+            current_pt_paddr = pte.ppn() << PAGE_SHIFT;
+        }
+        let page_table = unsafe { &mut *(current_pt_paddr as *mut PageTable) };
+        let pte = page_table.entry(Self::vpn_index(vaddr, 0));
+        let old = if pte.is_leaf() { Some(pte.ppn() << PAGE_SHIFT) } else { None };
+        *pte = PageTableEntry::new(paddr >> PAGE_SHIFT, flags | PteFlags::V.bits());
+        Ok(old)
+    }
+
+    /// Mevcut adres alanındaki (satp) bir sayfa hatasını pager ile çözmeyi dener.
+    /// Ok dönerse trap'tan dönülür ve komut yeniden çalışır.
+    pub fn handle_page_fault(vaddr: u64, access: Access) -> Result<(), KError> {
+        let satp: u64;
+        unsafe { asm!("csrr {}, satp", out(reg) satp); }
+        let root = (satp & 0xFFF_FFFF_FFFF) << PAGE_SHIFT;
+        kpager::handle_fault(root, vaddr, access, &RvFaultMmu { root })
+    }
+
+    /// Mevcut hart'ta adres alanına geçer (satp'yi yazar).
+    /// Kayıtlı adres alanları kendi ASID'leriyle yüklenir ve TLB temizlenmez; yalnızca ASID nesli
+    /// döndüğünde tam bir `sfence.vma` yapılır. Etiketsiz adres alanları ASID 0'ı paylaştığından
+    /// her geçişte temizlik gerektirir.
+    pub fn switch_to_address_space(root_page_table_paddr: u64) {
+        let (asid, flush_all) = match RV_ADDRESS_SPACES.lookup(root_page_table_paddr) {
+            Some(ctx) => {
+                let switch = RV_ASIDS.switch_to(ctx, unsafe { low_level_cpu_id() } as usize);
+                (switch.asid, switch.flush_all || switch.asid == 0)
+            }
+            None => (0, true),
+        };
+        let satp = SATP_MODE_SV39 | ((asid as u64) << SATP_ASID_SHIFT) | (root_page_table_paddr >> PAGE_SHIFT);
+        unsafe {
+            asm!("csrw satp, {}", in(reg) satp);
+            if flush_all {
+                asm!("sfence.vma zero, zero");
+            }
+        }
+    }
+
     // TODO: Diğer MMU/Bellek Yönetimi ile ilgili fonksiyonlar:
-    // - Adres alanları arasında geçiş (switch_to_address_space) - SATP kaydı güncelleme
     // - Sanal adres aralığı ayırma/takip etme (VM Area management)
-    // - Copy-on-Write implementasyonu
-    // - Page fault işleme
-    // - Büyük sayfa (superpage) desteği
 }
 
 // TODO: Physical Frame Allocator implementasyonu (başka bir dosyada/modülde olmalı)
@@ -624,8 +997,139 @@ impl RiscvMemoryManager {
 
 extern "C" {
     fn set_satp_register(satp_value: u64);
+    fn low_level_cpu_id() -> u32;
+}
+
+// satp alanları (Sv39)
+const SATP_MODE_SV39: u64 = 8 << 60;
+const SATP_ASID_SHIFT: u64 = 44;
+const SATP_ASID_MASK: u64 = 0xFFFF << SATP_ASID_SHIFT;
+
+// ASID dağıtıcısı; genişlik init_asids ile yoklanır (0 ise etiketleme kapalıdır)
+static RV_ASIDS: AsidAllocator = AsidAllocator::new(0);
+static RV_ADDRESS_SPACES: AddressSpaceTable = AddressSpaceTable::new();
+
+
+// Pager'ın bir adres alanındaki yaprak işlemleri
+struct RvFaultMmu {
+    root: u64,
+}
+
+impl FaultMmu for RvFaultMmu {
+    fn lookup(&self, vaddr: u64) -> Option<(u64, bool)> {
+        RiscvMemoryManager::lookup_leaf(self.root, vaddr)
+    }
+
+    fn install(&self, vaddr: u64, frame: u64, prot: u32, replace: bool) -> Result<(), KError> {
+        // W, R gerektirir; A/D önceden set edilir ki donanım A/D güncellemesi için ayrıca hata üretmesin
+        let mut flags = PteFlags::R.bits() | PteFlags::A.bits();
+        if prot & kpager::PROT_WRITE != 0 { flags |= PteFlags::W.bits() | PteFlags::D.bits(); }
+        if prot & kpager::PROT_EXEC != 0 { flags |= PteFlags::X.bits(); }
+        if prot & kpager::PROT_USER != 0 { flags |= PteFlags::U.bits(); }
+        let old = RiscvMemoryManager::set_leaf_in_table(self.root, vaddr, frame, flags)?;
+        // RISC-V geçersiz girdileri de önbelleğe alabilir: yeni yaprak yerel olarak her durumda görünür kılınır.
+        // Frame değiştiyse eski girdi tüm hart'lardan atılır.
+        let asid = RV_ADDRESS_SPACES.lookup(self.root).map(|ctx| ctx.asid()).unwrap_or(0);
+        if replace && old.map_or(false, |f| f != frame) {
+            let mut batch = TlbBatch::for_asid(ktlb::online_cpus(), asid);
+            batch.add_page(vaddr);
+            batch.flush();
+        } else {
+            low_level_tlb_flush_page(vaddr, asid);
+        }
+        Ok(())
+    }
+}
+
+// --- Aralık Eşlemeleri (kernel_memory.h) ---
+
+// kernel_memory.h'deki KMEM_PAGE_* bayrakları
+const KMEM_PAGE_WRITE: u32 = 1 << 1;
+const KMEM_PAGE_EXEC: u32 = 1 << 2;
+const KMEM_PAGE_USER: u32 = 1 << 3;
+
+// Mevcut adres alanının (satp) kök tablosu
+fn current_root() -> u64 {
+    let satp: u64;
+    unsafe { asm!("csrr {}, satp", out(reg) satp); }
+    (satp & 0xFFF_FFFF_FFFF) << PAGE_SHIFT
+}
+
+/// Fiziksel olarak bitişik bir aralığı mevcut adres alanına haritalar (bkz. kernel_memory.h).
+/// Hizalama izin verdiğinde `map_range_in_table` 1GB/2MB süper sayfalar seçer.
+/// Sv39'da önbelleklenemezlik PTE'de değil PMA'da tanımlıdır; KMEM_PAGE_NOCACHE yok sayılır.
+#[no_mangle]
+pub extern "C" fn kmem_virt_map_range(vaddr: u64, paddr: u64, size: usize, flags: u32) -> i64 {
+    // A/D önceden set edilir ki donanım A/D güncellemesi için ayrıca hata üretmesin
+    let mut pte = PteFlags::R.bits() | PteFlags::A.bits();
+    if flags & KMEM_PAGE_WRITE != 0 { pte |= PteFlags::W.bits() | PteFlags::D.bits(); }
+    if flags & KMEM_PAGE_EXEC != 0 { pte |= PteFlags::X.bits(); }
+    let is_kernel = flags & KMEM_PAGE_USER == 0;
+    match RiscvMemoryManager::map_range_in_table(current_root(), vaddr, paddr, size, pte, is_kernel) {
+        Ok(()) => 0,
+        Err(e) => e as i64,
+    }
+}
+
+/// kmem_virt_map_range ile kurulmuş aralığın haritasını kaldırır; fiziksel bellek iade edilmez.
+#[no_mangle]
+pub extern "C" fn kmem_virt_unmap_range(vaddr: u64, size: usize) -> i64 {
+    match RiscvMemoryManager::unmap_range_in_table(current_root(), vaddr, size) {
+        Ok(()) => 0,
+        Err(e) => e as i64,
+    }
+}
+
+/// Mevcut adres alanında sanal adresin fiziksel karşılığı; süper sayfalarda sayfa içi ofset dahil.
+/// Haritalı değilse 0 (bkz. kernel_memory.h).
+#[no_mangle]
+pub extern "C" fn kmem_virt_translate(vaddr: u64) -> u64 {
+    RiscvMemoryManager::translate_address(current_root(), vaddr).unwrap_or(0)
+}
+
+/// Sayfayı pager ile önceden kurar; hata yolundakiyle aynı çözüm (bkz. RiscvMemoryManager::handle_page_fault).
+#[no_mangle]
+pub extern "C" fn kmem_virt_fault_in(vaddr: u64, write: u32) -> i64 {
+    let access = if write != 0 { Access::Write } else { Access::Read };
+    match RiscvMemoryManager::handle_page_fault(vaddr, access) {
+        Ok(()) => 0,
+        Err(e) => e as i64,
+    }
+}
+
+// ktlb'nin (srctlb.rs) kullandığı yerel TLB kancaları (hardware_specific.h).
+// ASID 0: etiketsiz/çekirdek adresi, tüm ASID'lerde temizlenir.
+#[no_mangle]
+pub extern "C" fn low_level_tlb_flush_page(vaddr: u64, asid: u16) {
+    unsafe {
+        if asid == 0 {
+            asm!("sfence.vma {}, zero", in(reg) vaddr);
+        } else {
+            asm!("sfence.vma {}, {}", in(reg) vaddr, in(reg) asid as u64);
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_tlb_flush_asid(asid: u16) {
+    unsafe {
+        if asid == 0 {
+            asm!("sfence.vma zero, zero");
+        } else {
+            asm!("sfence.vma zero, {}", in(reg) asid as u64);
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_tlb_flush_all() {
+    unsafe { asm!("sfence.vma zero, zero"); }
 }
 
+// CPU'ya özel MMU kurulumu (hardware_specific.h). ASID genişliği (init_asids) tüm hart'larda aynıdır;
+// satp ilk adres alanı geçişinde yazılır.
+#[no_mangle]
+pub extern "C" fn low_level_mmu_cpu_init() {}
 
 // TODO: SFENCE.VMA instruction'ı çağıran fonksiyon (yer tutucu)
 
@@ -6,11 +6,11 @@ use core::ptr; // Pointer işlemleri için
 
 // Karnal64 API fonksiyonlarını ve tiplerini kullanmak için karnal64 modülünü/crate'ini içe aktarın.
 // Bu, bu dosyanın `karnal64.rs` dosyasındaki public öğelere erişebilmesi gerektiğini varsayar.
-use karnal64::{
-    resource_acquire, resource_write, KError, KHandle,
-    // karnal64::kresource modülündeki MODE_WRITE sabiti public olmalı
-    kresource::MODE_WRITE,
-};
+use karnal64::{KError, KHandle};
+
+extern "C" {
+    fn karnal_console_emergency_write(buffer: *const u8, size: usize); // srcconsole.rs
+}
 
 // --- Sabit Boyutlu Tampon ve Yazıcı ---
 // Panik mesajını formatlamak için yığın ayırma (heap allocation) kullanamayız
@@ -112,37 +112,11 @@ pub extern "C" fn panic_handler(info: &PanicInfo) -> ! {
     // Formatlanmış mesajı byte slice olarak al
     let panic_message_bytes = writer.as_slice();
 
-    // --- Karnal64 API'sini Kullanarak Konsola Yaz ---
-
-    // Konsol kaynağının kimliği (bu, karnal64.rs'deki kresource modülünde
-    // kaydedilen kimlikle eşleşmeli).
-    let console_resource_id = b"karnal://device/console"; // Byte slice
-
-    // Konsol kaynağı için handle edinmeye çalışın (yazma modunda)
-    // Bu, karnal64.rs dosyasındaki `resource_acquire` public fonksiyonunu çağırır.
-    let console_handle_result = resource_acquire(
-        console_resource_id.as_ptr(), // Kaynak kimliği pointer'ı
-        console_resource_id.len(),    // Kaynak kimliği uzunluğu
-        MODE_WRITE,                    // Erişim modu (karnal64::kresource::MODE_WRITE)
-    );
-
-    if let Ok(console_handle) = console_handle_result {
-        // Handle başarıyla alındıysa, panik mesajını kaynağa yazmayı deneyin.
-        // Bu, karnal64.rs dosyasındaki `resource_write` public fonksiyonunu çağırır.
-        let write_result = resource_write(
-            console_handle.0,              // Karnal64 Handle değeri (u64)
-            panic_message_bytes.as_ptr(), // Yazılacak veri (tampondaki mesaj) pointer'ı
-            panic_message_bytes.len(),    // Yazılacak veri uzunluğu
-        );
-
-        // Panik anında yazma hatasıyla başa çıkmak zor. Hatayı görmezden gelin.
-        let _ = write_result;
-
-        // Handle'ı serbest bırakmak teorik olarak doğru olsa da, panik anında
-        // sistem zaten durmak üzere olduğu için bu gerekli veya güvenli olmayabilir.
-         kresource::resource_release(console_handle.0); // İsteğe bağlı, dikkatli kullanılmalı
-    }
-    // Handle edinilemezse, konsola yazamayız. Bu durumda mesaj sessizce kaybolur.
+    // --- Çekirdek Konsolunun Acil Yoluyla Yaz ---
+    // Kaynak yöneticisi (resource_acquire/resource_write) kilit alır ve panik anında tutarsız olabilir.
+    // Acil yol kesmeleri kapatır, CPU halkalarında bekleyen çıktıyı UART'a boşaltır ve mesajı kilitsiz,
+    // eşzamanlı yazar; sonraki tüm konsol yazmaları da eşzamanlıdır.
+    unsafe { karnal_console_emergency_write(panic_message_bytes.as_ptr(), panic_message_bytes.len()) };
 
     // --- Sistemi Durdur ---
     // Panikler kurtarılamaz hatalardır. İşleyici döndürmemelidir.
@@ -23,6 +23,13 @@ use riscv::register::{
 // Bu örnek S-mode varsayımıyla ilerleyebilir.
 use riscv::register::{sstatus, sepc, stvec, satp}; // Supervisor mode registerları
 
+extern "C" {
+    fn riscv_cpu_set_id(cpu: u32); // srctask_rv64g.rs
+    fn riscv_cpu_set_hart(cpu: u32, hartid: u64); // srcinterrupt_rv64g.rs
+    static boot_hartid: u64; // srcboot_rv64g.S
+    fn low_level_ipi_init(); // srcinterrupt_rv64g.rs
+}
+
 // --- RISC-V Platformuna Özgü Başlatma ---
 
 /// Çekirdeğin RISC-V platformuna özgü başlatma fonksiyonu.
@@ -35,6 +42,12 @@ pub extern "C" fn platform_init() {
     // Güvenlik: Bu fonksiyon çağrıldığında çok temel bir ortamın (S-mode'a geçilmiş,
     // stack pointer ayarlı vb.) bootloader tarafından kurulduğu varsayılır.
 
+    // Önyükleme CPU'su mantıksal CPU 0'dır (low_level_cpu_id, srctask_rv64g.rs)
+    unsafe { riscv_cpu_set_id(0) };
+    unsafe { riscv_cpu_set_hart(0, core::ptr::read_volatile(core::ptr::addr_of!(boot_hartid))) };
+    // Yazılım kesmesini (IPI) aç; ikincil CPU'lar kendi açılış yollarında çağırır.
+    unsafe { low_level_ipi_init() };
+
     // TODO: RISC-V mimarisine özgü erken donanım başlatma adımları
     // - S-mode'a geçiş ayarları (eğer M-mode'dan başlandıysa)
     // - sstatus registerını ayarlama (FS alanı vb.)
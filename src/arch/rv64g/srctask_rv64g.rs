@@ -237,3 +237,224 @@ extern "C" fn ktask_start_wrapper(entry_point: usize, arg_ptr: usize) {
     // Görev tamamlandı, task_exit'i çağır
     task_exit(exit_code);
 }
+
+// --- Zamanlayıcı Kancaları (hardware_specific.h, srcsched.rs) ---
+// Bağlam yığıtta tutulur: ra ve s0-s11 yığıta yazılır, yalnızca sp kaydedilir. Yeni iş parçacığının yığıtı
+// ilk geçişte riscv_thread_trampoline'a dönecek şekilde kurulur; trampolin s0'daki giriş fonksiyonunu
+// s1'deki argümanla çağırır. Çekirdek S modunda çalışır (sstatus.SIE).
+
+core::arch::global_asm!(
+    ".global low_level_context_switch",
+    "low_level_context_switch:",
+    "addi sp, sp, -112",
+    "sd ra, 0(sp)",
+    "sd s0, 8(sp)",
+    "sd s1, 16(sp)",
+    "sd s2, 24(sp)",
+    "sd s3, 32(sp)",
+    "sd s4, 40(sp)",
+    "sd s5, 48(sp)",
+    "sd s6, 56(sp)",
+    "sd s7, 64(sp)",
+    "sd s8, 72(sp)",
+    "sd s9, 80(sp)",
+    "sd s10, 88(sp)",
+    "sd s11, 96(sp)",
+    "sd sp, 0(a0)",
+    "mv sp, a1",
+    "ld ra, 0(sp)",
+    "ld s0, 8(sp)",
+    "ld s1, 16(sp)",
+    "ld s2, 24(sp)",
+    "ld s3, 32(sp)",
+    "ld s4, 40(sp)",
+    "ld s5, 48(sp)",
+    "ld s6, 56(sp)",
+    "ld s7, 64(sp)",
+    "ld s8, 72(sp)",
+    "ld s9, 80(sp)",
+    "ld s10, 88(sp)",
+    "ld s11, 96(sp)",
+    "addi sp, sp, 112",
+    "ret",
+    "",
+    ".global riscv_thread_trampoline",
+    "riscv_thread_trampoline:",
+    "mv a0, s1",
+    "jalr s0",
+    "unimp",
+);
+
+extern "C" {
+    fn riscv_thread_trampoline();
+}
+
+/// Yeni iş parçacığı yığıtını low_level_context_switch'in yükleyeceği 112 byte'lık çerçeveyle hazırlar:
+/// ra = trampolin, s0 = entry, s1 = arg, diğerleri 0.
+#[no_mangle]
+pub unsafe extern "C" fn low_level_thread_stack_init(stack_top: u64, entry: u64, arg: u64) -> u64 {
+    let frame = ((stack_top & !0xF) - 112) as *mut u64;
+    for i in 0..14 {
+        core::ptr::write(frame.add(i), 0);
+    }
+    core::ptr::write(frame.add(0), riscv_thread_trampoline as usize as u64);
+    core::ptr::write(frame.add(1), entry);
+    core::ptr::write(frame.add(2), arg);
+    frame as u64
+}
+
+const SSTATUS_SIE: u64 = 1 << 1;
+
+#[no_mangle]
+pub extern "C" fn low_level_interrupt_save() -> u64 {
+    let sstatus: u64;
+    unsafe { core::arch::asm!("csrrci {}, sstatus, 2", out(reg) sstatus, options(nomem, nostack)) };
+    sstatus & SSTATUS_SIE
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_interrupt_restore(state: u64) {
+    if state & SSTATUS_SIE != 0 {
+        unsafe { core::arch::asm!("csrsi sstatus, 2", options(nomem, nostack)) };
+    }
+}
+
+/// `wfi`, sstatus.SIE kapalıyken de bekleyen (sie'de etkin) bir kesmeyle uyanır; kesme ardından kısa süre
+/// açılan SIE ile alınır. Böylece kontrol ile bekleme arasında kesme kaçmaz.
+#[no_mangle]
+pub extern "C" fn low_level_cpu_idle_wait() {
+    unsafe { core::arch::asm!("wfi", "csrsi sstatus, 2", "csrci sstatus, 2", options(nomem, nostack)) };
+}
+
+// --- CPU Numarası (hardware_specific.h) ---
+// S modunda hartid okunamaz; CPU başına alanın adresi sscratch'te tutulur. Alanın ilk kelimesi mantıksal CPU
+// numarası, ikincisi kullanıcı modundan gelen tuzakta geçilecek çekirdek yığıtının tepesidir (ofsetler EŞLEŞMELİDİR).
+// Önyükleme CPU'su platform_init'te, ikincil CPU'lar açılış yolunda riscv_cpu_set_id çağırır.
+
+const MAX_CPUS: usize = 32; // ksched::MAX_CPUS
+
+#[repr(C, align(64))]
+struct RiscvCpu {
+    cpu: u64,       // 0(sscratch)
+    kernel_sp: u64, // 8(sscratch)
+}
+
+// Yalnızca sahibi CPU tarafından yazılır
+static mut RISCV_CPUS: [RiscvCpu; MAX_CPUS] = [const { RiscvCpu { cpu: 0, kernel_sp: 0 } }; MAX_CPUS];
+
+#[no_mangle]
+pub extern "C" fn riscv_cpu_set_id(cpu: u32) {
+    unsafe {
+        let area = core::ptr::addr_of_mut!(RISCV_CPUS[(cpu as usize).min(MAX_CPUS - 1)]);
+        (*area).cpu = cpu as u64;
+        core::arch::asm!("csrw sscratch, {}", in(reg) area as u64, options(nomem, nostack));
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_cpu_id() -> u32 {
+    let cpu: u64;
+    unsafe { core::arch::asm!("csrr {0}, sscratch", "ld {0}, 0({0})", out(reg) cpu, options(readonly, nostack)) };
+    cpu as u32
+}
+
+// --- Açılış Arşivi (hardware_specific.h, srcinitrdfs.rs) ---
+// srcboot_rv64g.S, önyükleyicinin a1'de bıraktığı DTB adresini boot_dtb'ye yazar; arşiv /chosen düğümündeki
+// "linux,initrd-start/end" özellikleridir.
+
+extern "C" {
+    static boot_dtb: u64;
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn low_level_boot_initrd(phys_base: *mut u64, size: *mut u64) -> i64 {
+    let dtb = core::ptr::read_volatile(core::ptr::addr_of!(boot_dtb));
+    match crate::kinitrd::find_in_fdt(dtb) {
+        Some((base, len)) => {
+            *phys_base = base;
+            *size = len;
+            0
+        }
+        None => KError::NotFound as i64,
+    }
+}
+
+// --- Boşta Durumları ve Performans Seviyesi (hardware_specific.h, srcdvfs.rs) ---
+// Desteklenmiyor: SBI HSM hart_suspend ve üretici frekans uzantıları için SBI çağrı yolu henüz yok.
+// Durum kaydedilmediği için idle_enter çağrılmaz; çağrılırsa wfi ile bekler.
+
+#[no_mangle]
+pub extern "C" fn low_level_cpu_idle_enter(_state: u32) {
+    low_level_cpu_idle_wait();
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_cpu_set_performance(_cpu: u32, _level: u32) -> i64 {
+    KError::NotSupported as i64
+}
+
+// --- Sistem Çağrısı Girişi (hardware_specific.h) ---
+// `ecall` genel tuzak vektöründen (stvec) handle_syscall'a gider; ayrı bir hızlı giriş yolu yoktur.
+// Çalışan iş parçacığının çekirdek yığıtı CPU alanının kernel_sp kelimesine yazılır.
+// TODO: Tuzak girişi kullanıcı modundan gelirken sp'yi 8(sscratch)'ten almalı.
+
+#[no_mangle]
+pub extern "C" fn low_level_syscall_init() {}
+
+#[no_mangle]
+pub extern "C" fn low_level_set_kernel_stack(stack_top: u64) {
+    unsafe {
+        core::arch::asm!("csrr {0}, sscratch", "sd {1}, 8({0})", out(reg) _, in(reg) stack_top, options(nostack));
+    }
+}
+
+/// Kullanıcı moduna ilk geçiş (task_spawn). sret öncesi SIE kapalıdır; SPP = U ve SPIE ile dönüşte kesmeler açılır.
+/// Kullanıcı modundan gelen tuzakların yığıtı 8(sscratch)'tedir (bkz. yukarıdaki TODO).
+#[no_mangle]
+pub unsafe extern "C" fn low_level_enter_user(entry: u64, user_sp: u64, arg0: u64, arg1: u64) -> ! {
+    core::arch::asm!(
+        "csrci sstatus, 0x2",
+        "csrw sepc, a2",
+        "li t0, 0x100",
+        "csrc sstatus, t0",
+        "li t0, 0x20",
+        "csrs sstatus, t0",
+        "mv sp, a3",
+        "li ra, 0", "li gp, 0", "li tp, 0", "li t0, 0", "li t1, 0", "li t2, 0",
+        "li s0, 0", "li s1, 0", "li a2, 0", "li a3, 0", "li a4, 0", "li a5, 0", "li a6, 0", "li a7, 0",
+        "li s2, 0", "li s3, 0", "li s4, 0", "li s5, 0", "li s6, 0", "li s7, 0", "li s8, 0", "li s9, 0",
+        "li s10, 0", "li s11, 0", "li t3, 0", "li t4, 0", "li t5, 0", "li t6, 0",
+        "sret",
+        in("a0") arg0,
+        in("a1") arg1,
+        in("a2") entry,
+        in("a3") user_sp,
+        options(noreturn),
+    );
+}
+
+// --- Tembel FPU/SIMD (hardware_specific.h, srcsched.rs) ---
+// Desteklenmiyor: low_level_fpu_cpu_init 0 döner ve zamanlayıcı FPU durumuna dokunmaz. sstatus.FS tuzak
+// çerçevesiyle birlikte kaydedilip sret öncesi geri yüklendiğinden, FS=Off iken yapılan geçiş tuzak dönüşünde
+// eski iş parçacığının FS değeriyle ezilir.
+// TODO: Tuzak dönüşü FS'yi CPU'nun FPU durumundan aldığında FS=Off tuzağı ve FS=Dirty izlemesiyle tembel kayıt.
+
+#[no_mangle]
+pub extern "C" fn low_level_fpu_cpu_init() -> u64 {
+    0
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_fpu_enable() {}
+
+#[no_mangle]
+pub extern "C" fn low_level_fpu_disable() {}
+
+#[no_mangle]
+pub unsafe extern "C" fn low_level_fpu_area_init(_area: u64) {}
+
+#[no_mangle]
+pub unsafe extern "C" fn low_level_fpu_save(_area: u64) {}
+
+#[no_mangle]
+pub unsafe extern "C" fn low_level_fpu_restore(_area: u64) {}
@@ -45,6 +45,63 @@ fn read_riscv_mtime() -> u64 {
     }
 }
 
+// --- Tek Atımlık Zamanlayıcı Kancaları (hardware_specific.h, srctimer.rs tarafından kullanılır) ---
+// S-mode'da `time` CSR'ı okunur ve karşılaştırıcı SBI TIME eklentisiyle kurulur; periyodik tik yoktur.
+
+// !! DİKKAT !! Zaman tabanı frekansı Device Tree'deki /cpus/timebase-frequency değeridir.
+// 10 MHz QEMU virt makinesi içindir; gerçek donanımda DTB'den okunmalıdır.
+const TIMEBASE_FREQUENCY_HZ: u64 = 10_000_000;
+
+// SBI TIME eklentisi ("TIME") ve sbi_set_timer fonksiyonu
+const SBI_EXT_TIME: usize = 0x5449_4D45;
+const SBI_TIME_SET_TIMER: usize = 0;
+
+#[inline]
+fn read_time_csr() -> u64 {
+    let time: u64;
+    unsafe { core::arch::asm!("rdtime {}", out(reg) time) };
+    time
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_timer_now_ns() -> u64 {
+    (read_time_csr() as u128 * 1_000_000_000 / TIMEBASE_FREQUENCY_HZ as u128) as u64
+}
+
+// sbi_set_timer bekleyen zamanlayıcı kesmesini (STIP) de temizler. u64::MAX pratikte hiç dolmaz.
+#[no_mangle]
+pub extern "C" fn low_level_timer_program(deadline_ns: u64) {
+    let compare = if deadline_ns == u64::MAX {
+        u64::MAX
+    } else {
+        (deadline_ns as u128 * TIMEBASE_FREQUENCY_HZ as u128 / 1_000_000_000) as u64
+    };
+    unsafe {
+        core::arch::asm!("ecall",
+            in("a7") SBI_EXT_TIME, in("a6") SBI_TIME_SET_TIMER, inlateout("a0") compare as usize => _, lateout("a1") _);
+    }
+}
+
+// --- Paylaşımlı Zaman Sayfası Kancaları (srctimepage.rs) ---
+// U-mode `rdtime` yalnızca scounteren.TM açıkken çalışır (bkz. srcinterrupt_rv64g.rs init).
+
+const KARNAL_CLOCK_RISCV_TIME: u32 = 3;
+
+#[no_mangle]
+pub extern "C" fn low_level_clock_source() -> u32 {
+    KARNAL_CLOCK_RISCV_TIME
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_clock_frequency() -> u64 {
+    TIMEBASE_FREQUENCY_HZ
+}
+
+#[no_mangle]
+pub extern "C" fn low_level_clock_read() -> u64 {
+    read_time_csr()
+}
+
 // RISC-V zaman kaynağı için ResourceProvider implementasyonu yapacak yapı (struct)
 pub struct RiscvTimeProvider;
 
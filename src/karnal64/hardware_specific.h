@@ -16,7 +16,8 @@ typedef uint64_t paddr_t;
 // Sanal adres tipi (Genellikle fiziksel adres ile aynı genişlikte)
 typedef uint64_t vaddr_t;
 
-// Kesme numarası tipi (Mimarinin desteklediği kesme sayısına göre)
+// Kesme numarası tipi (Mimarinin desteklediği kesme sayısına göre). Çekirdeğe verilen numara mantıksaldır:
+// amd64'te IDT vektörü, armv9'da GIC INTID (LPI'lar 1024'ten başlayarak yeniden numaralanır).
 typedef uint32_t interrupt_id_t;
 
 // --- Düşük Seviye Başlatma Fonksiyonları ---
@@ -29,16 +30,84 @@ typedef uint32_t interrupt_id_t;
  */
 void low_level_hardware_init(void);
 
+/**
+ * Önyükleyicinin belleğe yüklediği initrd arşivinin yerini verir (DTB /chosen "linux,initrd-start/end",
+ * multiboot modülü vb.). Mimari kod bu bölgeyi fiziksel bellek ayırıcısına eklememelidir; çekirdek
+ * arşivi yerinde kullanır (karnal_initrd_register).
+ * @return Arşiv varsa 0, yoksa KERROR_NOT_FOUND.
+ */
+int64_t low_level_boot_initrd(paddr_t* phys_base, uint64_t* size);
+
 /**
  * Kesme denetleyicisini ve temel kesme işleme mekanizmasını başlatır.
  */
 void low_level_interrupt_init(void);
 
 /**
- * Sistem timer'ını başlatır.
+ * Kesme hattını denetleyicide maskeler/maskesini kaldırır. Kesme bağlamından da çağrılabilir.
+ * @param irq Mantıksal kesme numarası.
+ */
+void low_level_irq_mask(interrupt_id_t irq);
+void low_level_irq_unmask(interrupt_id_t irq);
+
+/**
+ * Kesmeyi (MSI dışı hat) verilen CPU'ya yönlendirir.
+ * @return Başarı durumunda 0, denetleyici bu hat için yönlendirme yapamıyorsa negatif kerror_t.
+ */
+int64_t low_level_irq_set_affinity(interrupt_id_t irq, uint32_t cpu);
+
+/**
+ * MSI/MSI-X için ayrılmış mantıksal kesme numarası aralığını verir. MSI desteklenmiyorsa *count = 0.
+ */
+void low_level_irq_msi_range(uint32_t* first, uint32_t* count);
+
+/**
+ * MSI numarasını `cpu`ya yönlendiren mesajı (cihazın yazacağı adres ve veri) oluşturur.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t.
+ */
+int64_t low_level_msi_compose(interrupt_id_t irq, uint32_t cpu, uint64_t* address, uint32_t* data);
+
+/**
+ * Çekirdek tarafından sağlanır (srcirq.rs). Mimari kesme girişi, kesmenin mantıksal numarasıyla çağırır;
+ * kesmeyi onaylama (EOI) çağırandadır.
+ */
+void kirq_dispatch(interrupt_id_t irq);
+
+/**
+ * Sistem timer'ını başlatır: monoton saat kaynağını ve CPU başına tek atımlık (one-shot) karşılaştırıcıyı
+ * kurar. Periyodik tik kurulmaz; kesme yalnızca low_level_timer_program ile verilen son tarihte gelir.
  */
 void low_level_timer_init(void);
 
+/**
+ * Monoton saat: önyüklemeden beri geçen nanosaniye. Tüm CPU'larda tutarlı olmalıdır.
+ */
+uint64_t low_level_timer_now_ns(void);
+
+/**
+ * Çağıran CPU'nun tek atımlık zamanlayıcısını deadline_ns anına kurar (öncekinin yerine geçer).
+ * Geçmişteki bir son tarih hemen kesme üretmelidir. UINT64_MAX zamanlayıcıyı kapatır.
+ * Kesme geldiğinde işleyici ktimer_interrupt() çağırmalıdır.
+ */
+void low_level_timer_program(uint64_t deadline_ns);
+
+/**
+ * Paylaşımlı zaman sayfasının (srctimepage.rs) kullandığı, kullanıcı modunda okunabilen sayaç türü
+ * (karnal.h'deki KARNAL_CLOCK_*). Mimari böyle bir sayaç sunmuyorsa KARNAL_CLOCK_NONE.
+ * Sayacın kullanıcı erişimi (örn. armv9 CNTKCTL_EL1.EL0VCTEN, rv64g scounteren.TM) her CPU'da açılmalıdır.
+ */
+uint32_t low_level_clock_source(void);
+
+/**
+ * low_level_clock_source sayacının frekansı (Hz). Kalibrasyon değişirse mimari kod ktimepage::publish çağırır.
+ */
+uint64_t low_level_clock_frequency(void);
+
+/**
+ * low_level_clock_source sayacının çekirdekten okunan ham değeri (kullanıcının okuyacağı değerle aynı).
+ */
+uint64_t low_level_clock_read(void);
+
 // --- Temel Çıktı Fonksiyonu (Çekirdek Debug/Panik için) ---
 // Karnal64 konsol sürücüsü hazır olmadan önce kullanılır.
 
@@ -48,6 +117,23 @@ void low_level_timer_init(void);
  */
 void low_level_console_putc(char c);
 
+/**
+ * UART verici FIFO'sunda beklemeden yazılabilecek karakter sayısı (low_level_console_putc bu kadar
+ * çağrı için beklemez). 0: FIFO dolu.
+ */
+uint32_t low_level_console_tx_room(void);
+
+/**
+ * UART'ın "verici boş" kesmesini açar (enable != 0) veya kapatır. Kesme, FIFO'da yer açıldığında gelir.
+ */
+void low_level_console_tx_irq_enable(uint32_t enable);
+
+/**
+ * UART kesmesinin mantıksal numarası; kesmeyle sürülen UART yoksa 0xFFFFFFFF (çekirdek konsolu
+ * eşzamanlı yazar).
+ */
+interrupt_id_t low_level_console_irq(void);
+
 
 // --- CPU Kontrol/Özel Fonksiyonlar ---
 // Mimarinin özel komutları veya register erişimleri için.
@@ -62,13 +148,250 @@ void low_level_interrupt_enable(void);
  */
 void low_level_interrupt_disable(void);
 
+/**
+ * Mevcut CPU'da kesmeleri kapatır ve önceki kesme durumunu döner (iç içe kritik bölgeler için).
+ * @return low_level_interrupt_restore'a verilecek mimariye özel durum değeri.
+ */
+uint64_t low_level_interrupt_save(void);
+
+/**
+ * low_level_interrupt_save'in döndüğü kesme durumunu geri yükler.
+ * @param state Önceki kesme durumu.
+ */
+void low_level_interrupt_restore(uint64_t state);
+
 /**
  * CPU'yu bekletir (genellikle bir kesme olana kadar).
  */
 void low_level_cpu_halt(void);
 
+/**
+ * Kesmeler kapalıyken çağrılır. Kesmeleri açıp beklemeyi kesme kaçırmayacak şekilde atomik yapar
+ * (x86: sti; hlt, ARM/RISC-V: wfi) ve bir kesme işlendikten sonra kesmeler kapalı olarak döner.
+ */
+void low_level_cpu_idle_wait(void);
+
+/**
+ * low_level_cpu_idle_wait gibi çalışır ama CPU'yu karnal_power_register_idle_states ile kaydedilmiş
+ * derin boşta durumuna sokar (amd64: MWAIT C-state ipucu, armv9: PSCI CPU_SUSPEND, rv64g: SBI HSM
+ * hart_suspend). Durum bağlamı kaybettiriyorsa CPU'ya özel durumu geri yüklemek mimari koda aittir.
+ * Kesmeler kapalı çağrılır ve kapalı olarak döner.
+ * @param state KarnalIdleState_t.id.
+ */
+void low_level_cpu_idle_enter(uint32_t state);
+
+/**
+ * CPU'nun performans seviyesini ister (amd64: HWP/ACPI P-state, armv9: SCMI performans alanı, rv64g:
+ * SBI/üretici uzantısı). `level` 0-1024 ölçeğinde kapasitedir; mimari onu en yakın desteklenen noktaya
+ * (yukarı) yuvarlar. Düzenleyici iş parçacığından çağrılır (kesmeler açık, başka CPU için olabilir; başka
+ * CPU'nun isteği IPI ile gönderilip dönüşten sonra uygulanabilir).
+ * @return Başarı durumunda 0; frekans değiştirilemiyorsa KERROR_NOT_SUPPORTED (düzenleyici durur),
+ *         diğer hatalarda negatif kerror_t.
+ */
+int64_t low_level_cpu_set_performance(uint32_t cpu, uint32_t level);
+
+/**
+ * Çalışan CPU'nun mantıksal numarasını döner (0'dan başlar, boot CPU'su 0).
+ * CPU başına veri yapılarına (örn. dilim ayırıcı magazinleri) indeks olarak kullanılır.
+ * @return Mevcut CPU'nun mantıksal numarası.
+ */
+uint32_t low_level_cpu_id(void);
+
+// --- SMP Açılışı ---
+// karnal_init, alt sistem başlatma grafiğini (srcboot.rs) çalıştırmadan hemen önce ikincil CPU'ları açar;
+// açılan CPU'lar grafiğe yardım eder, sonra zamanlayıcıya katılır.
+
+/**
+ * Önyükleme CPU'su dışındaki CPU'ları başlatır (amd64: INIT-SIPI-SIPI, armv9: PSCI CPU_ON,
+ * rv64g: SBI HSM hart_start) ve beklemeden döner. Her ikincil CPU kendi yığıtını, MMU'sunu (amd64
+ * CR4.PCIDE dahil, önyükleme CPU'suyla aynı yapılandırma), kesme denetleyicisinin ve zamanlayıcının
+ * CPU'ya özel kısmını kurar, low_level_cpu_id'nin döneceği numarayı yazar (x86_64_cpu_set_id,
+ * arm_cpu_set_id, riscv_cpu_set_id/riscv_cpu_set_hart), ardından kesmeler kapalıyken
+ * karnal_secondary_start(cpu) çağırır.
+ * @return Başlatılması istenen ikincil CPU sayısı (tek CPU'lu sistemlerde 0).
+ */
+uint32_t low_level_start_secondary_cpus(void);
+
+/**
+ * İkincil CPU'da CPU'ya özel MMU kurulumunu yapar (amd64: CR4.PCIDE, önyükleme CPU'sundaki ayarla aynı).
+ * Önyükleme CPU'su bunu bellek yöneticisinin başlatılmasında yapar. Başlatma grafiğine katılmadan önce,
+ * CPU'nun ilk adres alanı geçişinden önce bir kez çağrılır.
+ */
+void low_level_mmu_cpu_init(void);
+
+/**
+ * Çalışan CPU'da işlemciler arası kesmelerin (TLB shootdown) alımını kurar: amd64'te ortak IDT'yi yükler,
+ * yerel APIC'i açar ve APIC ID'yi kaydeder; armv9'da MPIDR'ı kaydeder ve SGI'ları yeniden dağıtıcıda açar;
+ * rv64'te sie.SSIE'yi açar. Her CPU'da, kendini TLB shootdown'lar için açık işaretlemeden önce bir kez
+ * çağrılır. Kesmeleri genel olarak açmaz.
+ */
+void low_level_ipi_init(void);
+
+/**
+ * İkincil CPU girişi (çekirdek tarafından sağlanır, srcboot.rs). Sistem çağrısı girişini, FPU'yu
+ * (low_level_fpu_cpu_init) ve IPI alımını kurar, CPU'yu TLB shootdown'lar için açık işaretler, başlatma
+ * grafiğine katılır ve zamanlayıcıya girer. Geri dönmez.
+ * @param cpu Çalışan CPU'nun mantıksal numarası (low_level_cpu_id ile aynı).
+ */
+void karnal_secondary_start(uint32_t cpu);
+
+// --- TLB Yönetimi ---
+// Çekirdeğin toplu TLB geçersiz kılma katmanı (srctlb.rs) tarafından kullanılır.
+// Sayfa başına temizlik yerine değişiklikler toplanır ve işlem sonunda bir kez uygulanır.
+
+/**
+ * Mevcut CPU'da tek bir sanal adresin TLB girdisini geçersiz kılar (büyük sayfalar dahil).
+ * @param vaddr Geçersiz kılınacak sanal adres.
+ * @param asid Adres alanı etiketi (PCID/ASID). 0: etiketsiz/çekirdek eşlemesi, tüm etiketlerde geçersiz kılınır.
+ */
+void low_level_tlb_flush_page(vaddr_t vaddr, uint16_t asid);
+
+/**
+ * Mevcut CPU'da bir adres alanı etiketinin tüm (global olmayan) TLB girdilerini geçersiz kılar.
+ * Adres alanının o anda bu CPU'da etkin olması gerekmez.
+ * @param asid Adres alanı etiketi. 0 ise low_level_tlb_flush_all() ile aynıdır.
+ */
+void low_level_tlb_flush_asid(uint16_t asid);
+
+/**
+ * Mevcut CPU'da tüm adres alanlarının global olmayan TLB girdilerini geçersiz kılar.
+ */
+void low_level_tlb_flush_all(void);
+
+/**
+ * Hedef CPU'ya TLB shootdown IPI'ı gönderir. Hedefin kesme işleyicisi
+ * ktlb_handle_shootdown_ipi() fonksiyonunu çağırmalıdır.
+ * @param cpu Hedef CPU'nun mantıksal numarası.
+ */
+void low_level_send_tlb_shootdown_ipi(uint32_t cpu);
+
+/**
+ * TLB shootdown IPI işleyicisi (çekirdek tarafından sağlanır, srctlb.rs).
+ * Mimari kesme kodu IPI'ı aldığında çağırır; bekleyen tüm geçersiz kılmaları uygular.
+ */
+void ktlb_handle_shootdown_ipi(void);
+
+// --- Zamanlayıcı ve Bağlam Değiştirme ---
+// CPU başına çalışma kuyruklu zamanlayıcı (srcsched.rs) tarafından kullanılır.
+
+/**
+ * Yeni bir çekirdek iş parçacığının yığıtını, ilk low_level_context_switch ile entry(arg) çalışacak şekilde hazırlar.
+ * @param stack_top Yığıtın en yüksek adresi (16 byte hizalı).
+ * @param entry Geri dönmeyen başlangıç fonksiyonu, void entry(uint64_t arg).
+ * @param arg Başlangıç fonksiyonunun argümanı.
+ * @return low_level_context_switch'e next_sp olarak verilecek yığıt işaretçisi.
+ */
+uint64_t low_level_thread_stack_init(uint64_t stack_top, uint64_t entry, uint64_t arg);
+
+/**
+ * Çağrı kuralına göre korunan yazmaçları mevcut yığıta kaydeder, yığıt işaretçisini *prev_sp'ye yazar ve
+ * next_sp'deki bağlama geçer. Önceki bağlam yeniden seçildiğinde fonksiyon ondan döner.
+ * Kesmeler kapalı çağrılır.
+ * @param prev_sp Mevcut bağlamın yığıt işaretçisinin kaydedileceği yer.
+ * @param next_sp Geçilecek bağlamın kaydedilmiş yığıt işaretçisi.
+ */
+void low_level_context_switch(uint64_t* prev_sp, uint64_t next_sp);
+
+/**
+ * Kullanıcı modundan gelen sistem çağrılarının ve kesmelerin gireceği çekirdek yığıtını ayarlar.
+ * Zamanlayıcı, kendi yığıtı olan bir iş parçacığına geçmeden hemen önce (kesmeler kapalı) çağırır.
+ * Yığıtı donanımın kuvvetle değiştirdiği mimarilerde (armv9 SP_EL1) boştur.
+ * @param stack_top İş parçacığının çekirdek yığıtının en yüksek adresi.
+ */
+void low_level_set_kernel_stack(uint64_t stack_top);
+
+/**
+ * Çalışan iş parçacığını kullanıcı moduna geçirir; geri dönmez. Kullanıcı kodu entry'de, yığıtı user_sp'de ve
+ * ilk iki argüman yazmacında arg0/arg1 ile başlar; diğer genel yazmaçlar sıfırlanır ve kesmeler açılır.
+ * Görevin adres alanı yüklü, iş parçacığının çekirdek yığıtı low_level_set_kernel_stack ile kurulmuş olmalıdır.
+ * @param entry Kullanıcı giriş noktası.
+ * @param user_sp Kullanıcı yığıtı (16 byte hizalı).
+ */
+void low_level_enter_user(uint64_t entry, uint64_t user_sp, uint64_t arg0, uint64_t arg1) __attribute__((noreturn));
+
+// --- Sistem Çağrısı Girişi ---
+// Hızlı giriş yolu (amd64 SYSCALL/SYSRET, armv9 SVC) yalnızca dönüş durumunu ve caller-saved yazmaçları
+// kaydedip karnal_syscall_fast'i çağırır; tam çerçeveli tuzak yolu handle_syscall'a gider (srcsyscall.rs).
+
+/**
+ * Çalışan CPU'da hızlı sistem çağrısı girişini kurar (amd64: CPU başına GDT ve TSS, EFER.SCE,
+ * STAR/LSTAR/FMASK ve GS tabanı).
+ * Her CPU'da, kullanıcı moduna ilk geçişten önce bir kez çağrılır.
+ */
+void low_level_syscall_init(void);
+
+/**
+ * Hızlı yol dağıtıcısı (çekirdek tarafından sağlanır, srcsyscall.rs). Argümanlar C ABI'sinin ilk beş
+ * yazmacında, sistem çağrısı numarası altıncısındadır. Kesmeler açık, çekirdek yığıtında çağrılır.
+ * @return Kullanıcıya dönecek değer (başarı >= 0, hata negatif kerror_t).
+ */
+int64_t karnal_syscall_fast(uint64_t arg1, uint64_t arg2, uint64_t arg3, uint64_t arg4, uint64_t arg5, uint64_t number);
+
+/**
+ * Hedef CPU'ya reschedule IPI gönderir. Hedefin kesme işleyicisi ksched_handle_reschedule_ipi() çağırmalıdır.
+ * @param cpu Hedef CPU'nun mantıksal numarası.
+ */
+void low_level_send_reschedule_ipi(uint32_t cpu);
+
+/**
+ * Reschedule IPI işleyicisi (çekirdek tarafından sağlanır, srcsched.rs).
+ */
+void ksched_handle_reschedule_ipi(void);
+
+/**
+ * CPU başına zamanlayıcı kesmesi işleyicisi (çekirdek tarafından sağlanır, srctimer.rs).
+ * Dolan uyku/zaman aşımlarını uyandırır, zaman dilimini denetler ve zamanlayıcıyı bir sonraki
+ * son tarihe yeniden kurar.
+ */
+void ktimer_interrupt(void);
+
+/**
+ * Kesme/istisna kodu kullanıcı moduna dönmeden hemen önce çağırır (çekirdek tarafından sağlanır, srcsched.rs).
+ * Zaman dilimi dolmuş veya reschedule IPI gelmişse başka bir iş parçacığına geçer.
+ */
+void ksched_preempt_point(void);
+
+// --- FPU/SIMD Durumu (Tembel Kaydetme) ---
+// Zamanlayıcı (srcsched.rs) FPU/SIMD durumunu yalnızca onu kullanan iş parçacıkları için kaydeder:
+// geçişte FPU kapatılır (amd64 CR0.TS, armv9 CPACR_EL1.FPEN/ZEN), iş parçacığının ilk FPU/SIMD komutu
+// tuzağa düşer ve ksched_fpu_trap durumu geri yükleyip FPU'yu açar. Çekirdek FPU/SIMD kullanmaz.
+
+/**
+ * Çalışan CPU'da FPU/SIMD'yi kurar (amd64: CR4.OSFXSR/OSXSAVE, XCR0) ve kapalı (tuzaklı) bırakır.
+ * Her CPU'da zamanlayıcıya katılırken bir kez çağrılır.
+ * @return İş parçacığı başına durum alanı boyutu (byte, tüm CPU'larda aynı); 0: tembel kaydetme yok,
+ *         zamanlayıcı FPU durumuna dokunmaz.
+ */
+uint64_t low_level_fpu_cpu_init(void);
+
+/** Çalışan CPU'da FPU/SIMD komutlarını açar (tuzak kalkar). */
+void low_level_fpu_enable(void);
+
+/** Çalışan CPU'da FPU/SIMD komutlarını kapatır; sonraki kullanım ksched_fpu_trap'e düşer. */
+void low_level_fpu_disable(void);
+
+/**
+ * Sıfırlanmış yeni bir durum alanına ilk (init) durumun görüntüsünü yazar (amd64: MXCSR varsayılanı).
+ * @param area Sayfa hizalı, low_level_fpu_cpu_init'in döndüğü boyutta alan.
+ */
+void low_level_fpu_area_init(uint64_t area);
+
+/**
+ * FPU/SIMD durumunu alana kaydeder. FPU açıkken çağrılır. amd64'te XSAVEOPT, son geri yüklemeden beri
+ * değişmemiş veya ilk durumdaki bileşenleri (ör. hiç kullanılmamış AVX-512) yazmaz.
+ */
+void low_level_fpu_save(uint64_t area);
+
+/** FPU/SIMD durumunu alandan yükler. FPU açıkken çağrılır. */
+void low_level_fpu_restore(uint64_t area);
+
+/**
+ * FPU/SIMD erişim tuzağı işleyicisi (çekirdek tarafından sağlanır, srcsched.rs). Mimari istisna kodu
+ * (amd64 #NM, armv9 EC 0x07/0x19) çağırır; dönüşte tuzağa düşen komut yeniden çalıştırılır.
+ */
+void ksched_fpu_trap(void);
+
 // TODO: Mimariye özel register okuma/yazma fonksiyonları veya makroları
-// TODO: Bağlam değiştirme (context switching) ile ilgili assembly/intrinsics arayüzleri
 
 #ifdef __cplusplus
 } // extern "C"
@@ -31,6 +31,7 @@ typedef int64_t kerror_t;
 #define KERROR_ALREADY_EXISTS   -17
 #define KERROR_NOT_SUPPORTED    -38
 #define KERROR_NO_MESSAGE       -61
+#define KERROR_TIMED_OUT       -110
 #define KERROR_INTERNAL_ERROR  -255
 // ... Rust KError enum'undaki diğer hatalar buraya eklenmeli ...
 
@@ -43,6 +44,8 @@ typedef uint64_t kthread_id_t; // Varsayım: Thread ID'ler de u64
 
 // Dahili çekirdek Handle'ı. Rust KHandle'a karşılık gelir.
 // Kullanıcı alanından gelen ham handle değeridir, çekirdek içinde anlamlıdır.
+// Kaynak handle'ları görev başına tablodaki yuva indeksini ve yuvanın neslini taşır: kapatılmış bir
+// handle'ın değeri, yuva yeniden kullanılsa bile KERROR_BAD_HANDLE ile reddedilir.
 typedef uint64_t khandle_t;
 
 
@@ -54,7 +57,9 @@ typedef uint64_t khandle_t;
 // - Hata durumunda, KError değerinin i64'e dönüştürülmüş hali (negatif) döner.
 
 /**
- * Karnal64 çekirdek API'sını başlatır. Çekirdek boot sırasında çağrılmalıdır.
+ * Karnal64 çekirdek API'sını başlatır. Çekirdek boot sırasında, low_level_memory_init sonrasında çağrılmalıdır.
+ * İkincil CPU'ları açar ve alt sistemleri bağımlılık sırasıyla, açılan CPU'larda paralel başlatır;
+ * hepsi bitince döner.
  */
 void karnal_init(void);
 
@@ -63,16 +68,40 @@ void karnal_init(void);
 
 /**
  * Kullanıcı alanı için bellek tahsis eder.
+ * Bellek sıfırlanmıştır ve KARNAL_MEM_HINT_DEFAULT ile yerleştirilir (bkz. karnal_memory_allocate_placed).
  * @param size Tahsis edilecek bellek boyutu.
  * @return Başarı durumunda tahsis edilen bellek adresinin u64'e dönüştürülmüş hali (>=0), hata durumunda negatif kerror_t döner.
  */
 int64_t karnal_memory_allocate(size_t size);
 
+// Yerleşim ipuçları: hangi bellek katmanının (DDR/LPDDR/HBM/GDDR) önce deneneceğini belirler.
+#define KARNAL_MEM_HINT_DEFAULT    0u // Genel bellek, sonra DDR, LPDDR, GDDR, HBM
+#define KARNAL_MEM_HINT_BANDWIDTH  1u // HBM, GDDR, DDR, LPDDR (bant genişliğine bağlı iş yükleri)
+#define KARNAL_MEM_HINT_LATENCY    2u // DDR, LPDDR, HBM, GDDR; uzak düğümlere yalnızca tüm yerel katmanlar tükenince
+#define KARNAL_MEM_HINT_CAPACITY   3u // En çok boş belleği olan katmandan başlayarak
+#define KARNAL_MEM_HINT_LOW_POWER  4u // LPDDR, DDR, GDDR, HBM
+// İpucuyla OR'lanabilen bayraklar
+#define KARNAL_MEM_HINT_STRICT     (1u << 8) // Yalnızca ipucunun ilk katmanı (DEFAULT ile yalnızca genel bellek)
+#define KARNAL_MEM_HINT_LOCAL_NODE (1u << 9) // Yalnızca çalışan CPU'nun NUMA düğümü
+
+/**
+ * Kullanıcı alanı için yerleşim ipucuna göre bellek tahsis eder. Bellek, ipucunun katman sırasıyla
+ * ve çalışan CPU'nun NUMA düğümünden başlanarak ayrılır; STRICT/LOCAL_NODE yoksa diğer katman ve
+ * düğümlere düşülür (KARNAL_INFO_MEM_FALLBACKS, KARNAL_INFO_MEM_REMOTE). Bellek sıfırlanmıştır.
+ * karnal_memory_release ile aynı boyutla serbest bırakılır.
+ * @param size Tahsis edilecek bellek boyutu.
+ * @param hint KARNAL_MEM_HINT_* ipucu ve bayrakları.
+ * @return Başarı durumunda kullanıcı adresi (>=0); geçersiz ipucu için KERROR_INVALID_ARGUMENT,
+ *         uygun bellek yoksa KERROR_OUT_OF_MEMORY.
+ */
+int64_t karnal_memory_allocate_placed(size_t size, uint32_t hint);
+
 /**
  * Kullanıcı alanı için daha önce tahsis edilmiş belleği serbest bırakır.
  * @param ptr Serbest bırakılacak bellek adresinin u64'e dönüştürülmüş hali.
- * @param size Bellek boyutu.
- * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
+ * @param size Bellek boyutu (tahsisteki boyutla aynı olmalıdır).
+ * @return Başarı durumunda 0; (ptr, size) çağıran görevin canlı bir tahsisiyle eşleşmiyorsa
+ *         KERROR_INVALID_ARGUMENT, diğer hatalarda negatif kerror_t döner.
  */
 int64_t karnal_memory_release(uint64_t ptr, size_t size); // ptr artık u64 olarak alınıyor, doğrulama içeride yapılır
 
@@ -84,12 +113,15 @@ int64_t karnal_memory_release(uint64_t ptr, size_t size); // ptr artık u64 olar
  * @param code_handle_value Çalıştırılabilir kod kaynağının handle değeri.
  * @param args_ptr Kullanıcı alanındaki argüman verisi pointer'ı.
  * @param args_len Argüman verisi uzunluğu.
+ * Görevin segmentleri tembel eşlenir (kmem_virt_map_image, kmem_virt_reserve_zero): aynı code handle ile
+ * başlatılan görevler kod sayfalarını paylaşır, yazılabilir sayfalar ilk yazmada kopyalanır.
  * @return Başarı durumunda yeni görevin ktid_t değerinin i64'e dönüştürülmüş hali (>=0), hata durumunda negatif kerror_t döner.
  */
 int64_t karnal_task_spawn(khandle_t code_handle_value, const uint8_t* args_ptr, size_t args_len); // Pointerlar kullanıcı adresinde, içeride doğrulanmalı
 
 /**
- * Mevcut görevi belirtilen çıkış koduyla sonlandırır. Geri dönmez.
+ * Çağıran iş parçacığını belirtilen çıkış koduyla sonlandırır. Geri dönmez.
+ * Görevin son iş parçacığı çıktığında görev ve kaynakları bırakılır; diğer iş parçacıkları çalışmaya devam eder.
  * @param code Çıkış kodu.
  */
 void karnal_task_exit(int32_t code) __attribute__((noreturn));
@@ -110,7 +142,25 @@ int64_t karnal_task_current_id(void); // Karnal64 fns are called by handler, the
 int64_t karnal_task_sleep(uint64_t milliseconds);
 
 /**
- * Yeni bir iş parçacığı (thread) oluşturur.
+ * Mevcut iş parçacığını en az nanoseconds, en fazla yaklaşık nanoseconds + slack_ns süre uyutur.
+ * Esneklik yakın uyanmaların tek zamanlayıcı kesmesinde birleştirilmesine izin verir; gecikmeye
+ * duyarlı çağıranlar 0 verebilir. karnal_task_sleep süre/16 (en fazla 50 µs) esneklik kullanır.
+ * @param nanoseconds Uyutulacak süre (nanosaniye). 0 karnal_task_yield ile aynıdır.
+ * @param slack_ns İzin verilen gecikme (nanosaniye).
+ * @return Başarı durumunda 0, CPU'nun zamanlayıcı tablosu doluysa KERROR_BUSY, diğer hatalarda negatif kerror_t.
+ */
+int64_t karnal_task_sleep_ns(uint64_t nanoseconds, uint64_t slack_ns);
+
+/**
+ * Monoton saat: önyüklemeden beri geçen nanosaniye (uyku ve zaman aşımı son tarihleri bu saate göredir).
+ */
+uint64_t karnal_timer_now_ns(void);
+
+// karnal_thread_create_affine için: tüm CPU'lara izin veren ilgi maskesi.
+#define KARNAL_CPU_ANY UINT64_MAX
+
+/**
+ * Yeni bir iş parçacığı (thread) oluşturur. Herhangi bir CPU'da çalışabilir (bkz. karnal_thread_create_affine).
  * @param entry_point Yeni iş parçacığının başlangıç fonksiyon adresinin u64'e dönüştürülmüş hali.
  * @param stack_size Yeni iş parçacığı için ayrılacak yığın boyutu.
  * @param arg Başlangıç fonksiyonuna geçirilecek argümanın u64'e dönüştürülmüş hali.
@@ -118,6 +168,25 @@ int64_t karnal_task_sleep(uint64_t milliseconds);
  */
 int64_t karnal_thread_create(uint64_t entry_point, size_t stack_size, uint64_t arg);
 
+/**
+ * CPU ilgi ipucuyla yeni bir iş parçacığı oluşturur. İş parçacığı yalnızca maskedeki CPU'larda çalışır
+ * ve iş çalma ile bu CPU'lar dışına taşınmaz. Maskede açık CPU yoksa ipucu yok sayılır.
+ * @param entry_point Başlangıç fonksiyon adresi.
+ * @param stack_size Yığın boyutu (0: varsayılan).
+ * @param arg Başlangıç fonksiyonuna geçirilecek argüman.
+ * @param cpu_mask İzin verilen CPU'ların maskesi (bit n = CPU n), 0 veya KARNAL_CPU_ANY: hepsi.
+ * @return Başarı durumunda yeni iş parçacığının kthread_id_t değeri (>=0), hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_thread_create_affine(uint64_t entry_point, size_t stack_size, uint64_t arg, uint64_t cpu_mask);
+
+/**
+ * Bir iş parçacığının CPU ilgi maskesini değiştirir. Yeni maske iş parçacığı bir sonraki kez kuyruğa girdiğinde uygulanır.
+ * @param thread_id Hedef iş parçacığı.
+ * @param cpu_mask İzin verilen CPU'ların maskesi, 0 veya KARNAL_CPU_ANY: hepsi.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_thread_set_affinity(kthread_id_t thread_id, uint64_t cpu_mask);
+
 /**
  * Mevcut iş parçacığını belirtilen çıkış koduyla sonlandırır. Geri dönmez.
  * @param code Çıkış kodu.
@@ -130,14 +199,38 @@ void karnal_thread_exit(int32_t code) __attribute__((noreturn));
  */
 int64_t karnal_task_yield(void);
 
+/**
+ * Çağıran CPU'yu zamanlayıcıya katar ve onun boşta döngüsüne girer. Geri dönmez.
+ * Önyükleme CPU'su başlatmanın sonunda, ikincil CPU'lar kendi başlatmalarının sonunda birer kez çağırır.
+ * Kuyruğu boşalan CPU diğer CPU'lardan iş çeker; çekecek iş yoksa bir kesmeye kadar bekler.
+ */
+void karnal_scheduler_start(void) __attribute__((noreturn));
+
 
 // --- Kaynak Yönetimi ---
 
+// Vektörel (scatter/gather) G/Ç için tek bir segment tanımı.
+// karnal_resource_readv/writev ve provider'ların readv_fn/writev_fn slotları bu yapının dizisini alır.
+typedef struct KarnalIoVec {
+    uint8_t* base;   // Segment tamponu (kullanıcı alanındaysa içeride doğrulanmalı)
+    size_t len;      // Segment uzunluğu (byte)
+    uint64_t offset; // Bu segmentin kaynak içindeki ofseti (stream kaynaklarda yok sayılır)
+} KarnalIoVec_t;
+
+// Tek bir vektörel çağrıda kabul edilen en fazla segment sayısı.
+#define KARNAL_IOV_MAX 1024
+
+// karnal_resource_acquire modları (karnal64.rs kresource::MODE_* ile EŞLEŞMELİDİR)
+#define KARNAL_RESOURCE_MODE_READ   (1u << 0)
+#define KARNAL_RESOURCE_MODE_WRITE  (1u << 1)
+#define KARNAL_RESOURCE_MODE_CREATE (1u << 2)
+
 /**
  * Belirtilen ID'ye sahip bir kaynağa erişim handle'ı edinir.
  * @param resource_id_ptr Kullanıcı alanındaki kaynak ID pointer'ı (uint8_t dizisi).
  * @param resource_id_len Kaynak ID uzunluğu.
  * @param mode Talep edilen erişim modları bayrakları.
+ * Handle yalnızca edinen görevde geçerlidir; izinler (mode) ve okuma/yazma ofseti handle'a aittir.
  * @return Başarı durumunda edinilen khandle_t değerinin i64'e dönüştürülmüş hali (>=0), hata durumunda negatif kerror_t döner.
  */
 int64_t karnal_resource_acquire(const uint8_t* resource_id_ptr, size_t resource_id_len, uint32_t mode); // Pointerlar kullanıcı adresinde, içeride doğrulanmalı
@@ -162,7 +255,28 @@ int64_t karnal_resource_read(khandle_t handle_value, uint8_t* user_buffer_ptr, s
 int64_t karnal_resource_write(khandle_t handle_value, const uint8_t* user_buffer_ptr, size_t user_buffer_len); // Pointerlar kullanıcı adresinde, içeride doğrulanmalı
 
 /**
- * Belirtilen handle'ı serbest bırakır.
+ * Belirtilen handle ile temsil edilen kaynaktan birden çok segmente tek çağrıda veri okur (scatter).
+ * Segmentler sırayla işlenir; bir segment kısa okunursa işlem orada durur.
+ * @param handle_value Kaynak handle değeri.
+ * @param iov_ptr Kullanıcı alanındaki KarnalIoVec_t dizisi pointer'ı.
+ * @param iov_count Dizideki segment sayısı (en fazla KARNAL_IOV_MAX).
+ * @return Başarı durumunda tüm segmentlere okunan toplam byte sayısı (>=0), hiçbir byte okunamadan hata olursa negatif kerror_t döner.
+ */
+int64_t karnal_resource_readv(khandle_t handle_value, const KarnalIoVec_t* iov_ptr, size_t iov_count); // Pointerlar kullanıcı adresinde, içeride doğrulanmalı
+
+/**
+ * Birden çok segmentteki veriyi tek çağrıda belirtilen kaynağa yazar (gather).
+ * Segmentler sırayla işlenir; bir segment kısa yazılırsa işlem orada durur.
+ * @param handle_value Kaynak handle değeri.
+ * @param iov_ptr Kullanıcı alanındaki KarnalIoVec_t dizisi pointer'ı.
+ * @param iov_count Dizideki segment sayısı (en fazla KARNAL_IOV_MAX).
+ * @return Başarı durumunda yazılan toplam byte sayısı (>=0), hiçbir byte yazılamadan hata olursa negatif kerror_t döner.
+ */
+int64_t karnal_resource_writev(khandle_t handle_value, const KarnalIoVec_t* iov_ptr, size_t iov_count); // Pointerlar kullanıcı adresinde, içeride doğrulanmalı
+
+/**
+ * Belirtilen handle'ı serbest bırakır. Değer hemen geçersizleşir; aynı handle üzerinde başka bir iş
+ * parçacığında süren okuma/yazma güvenle tamamlanır.
  * @param handle_value Serbest bırakılacak handle değeri.
  * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
  */
@@ -177,6 +291,30 @@ int64_t karnal_resource_release(khandle_t handle_value);
  */
 int64_t karnal_resource_control(khandle_t handle_value, uint64_t request, uint64_t arg);
 
+// karnal_resource_map koruma bayrakları (srcresmap.rs kresmap::MAP_* ile EŞLEŞMELİDİR).
+// Yürütme izni verilmez; okuma her haritalamada açıktır.
+#define KARNAL_MAP_READ    (1u << 0)
+#define KARNAL_MAP_WRITE   (1u << 1) // Handle'ın KARNAL_RESOURCE_MODE_WRITE ile edinilmiş olması gerekir
+#define KARNAL_MAP_NOCACHE (1u << 4) // Cihaz belleği (çerçeve tamponu, MMIO) için önbelleksiz
+
+/**
+ * Kaynağın `[offset, offset + len)` aralığını kopyalamadan çalışan görevin adres alanına haritalar.
+ * Provider her sayfa için fiziksel frame'i verir (KarnalResourceProviderC_t::map_fn); frame'ler hemen
+ * haritalanır ve provider'a ait kalır. Handle kapatılsa da haritalama karnal_resource_unmap'e kadar durur.
+ * @param offset Sayfa hizalı olmalıdır.
+ * @param len Sayfaya yukarı yuvarlanır.
+ * @param prot KARNAL_MAP_* bayrakları.
+ * @return Başarı durumunda kullanıcı adresi (>=0), hata durumunda negatif kerror_t döner
+ *         (provider desteklemiyorsa KERROR_NOT_SUPPORTED).
+ */
+int64_t karnal_resource_map(khandle_t handle_value, uint64_t offset, uint64_t len, uint32_t prot);
+
+/**
+ * karnal_resource_map ile kurulmuş bir aralığı kaldırır. Frame'ler provider'a iade edilmez.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_resource_unmap(uint64_t addr, uint64_t len);
+
 
 // --- Çekirdek Bilgisi ---
 
@@ -187,14 +325,211 @@ int64_t karnal_resource_control(khandle_t handle_value, uint64_t request, uint64
  */
 int64_t karnal_kernel_get_info(uint32_t info_type);
 
+// karnal_kernel_get_info bilgi türleri: çekirdek dilim (slab) ayırıcı istatistikleri.
+// c: boyut sınıfı indeksi (0 .. KARNAL_INFO_SLAB_CLASS_COUNT sonucu - 1).
+#define KARNAL_INFO_SLAB_CLASS_COUNT   0x100u         // Boyut sınıfı sayısı
+#define KARNAL_INFO_SLAB_CLASS_SIZE(c) (0x110u + (c)) // Sınıfın nesne boyutu (byte)
+#define KARNAL_INFO_SLAB_HITS(c)       (0x120u + (c)) // CPU magazininden karşılanan tahsis/serbest bırakma sayısı
+#define KARNAL_INFO_SLAB_MISSES(c)     (0x130u + (c)) // Depoya veya dilim katmanına inen tahsis/serbest bırakma sayısı
+
+// karnal_kernel_get_info bilgi türleri: toplu TLB geçersiz kılma istatistikleri.
+#define KARNAL_INFO_TLB_PAGE_FLUSHES   0x200u // Tek tek geçersiz kılınan sayfa sayısı
+#define KARNAL_INFO_TLB_FULL_FLUSHES   0x201u // Tam TLB temizliğine dönüşen toplu işlem sayısı
+#define KARNAL_INFO_TLB_SHOOTDOWN_IPIS 0x202u // Gönderilen shootdown IPI sayısı (birleştirilenler hariç)
+
+// karnal_kernel_get_info bilgi türleri: talep üzerine sayfalama (tembel sıfır doldurma, copy-on-write).
+#define KARNAL_INFO_PAGER_ZERO_FILLS   0x300u // İlk yazmada ayrılan sıfırlanmış frame sayısı
+#define KARNAL_INFO_PAGER_COW_COPIES   0x301u // Paylaşılan sayfaya yazmada yapılan kopya sayısı
+#define KARNAL_INFO_PAGER_SHARED_MAPS  0x302u // Kopyalanmadan paylaşılarak eşlenen sayfa sayısı
+#define KARNAL_INFO_PAGER_IMAGE_READS  0x303u // Kod kaynağından okunan imaj sayfası sayısı
+#define KARNAL_INFO_PAGER_DIRECT_MAPS  0x304u // Kaynağın kendi frame'i (initrd arşivi) doğrudan eşlenen sayfa sayısı
+
+// karnal_kernel_get_info bilgi türleri: zamanlayıcı.
+#define KARNAL_INFO_SCHED_CONTEXT_SWITCHES 0x400u // Bağlam değiştirme sayısı
+#define KARNAL_INFO_SCHED_STOLEN_THREADS   0x401u // Başka bir CPU'nun kuyruğundan çalınan iş parçacığı sayısı
+#define KARNAL_INFO_SCHED_RESCHEDULE_IPIS  0x402u // Boştaki CPU'lara gönderilen reschedule IPI sayısı
+#define KARNAL_INFO_SCHED_DIRECT_HANDOFFS  0x403u // Çalışma kuyruğu atlanarak doğrudan yapılan geçiş (senkron IPC) sayısı
+#define KARNAL_INFO_SCHED_FPU_TRAPS        0x404u // FPU/SIMD ilk kullanım tuzağı sayısı (tembel FPU)
+#define KARNAL_INFO_SCHED_FPU_SAVES        0x405u // Geçişte kaydedilen FPU/SIMD durumu sayısı
+#define KARNAL_INFO_SCHED_FPU_RESTORES_SKIPPED 0x406u // Durum yazmaçlarda geçerli kaldığı için atlanan yükleme sayısı
+
+// karnal_kernel_get_info bilgi türleri: uyarlanabilir kilitler.
+#define KARNAL_INFO_LOCK_SPIN_ACQUIRES 0x500u // Çalışan sahibi bekleyerek (bloklanmadan) alınan kilit sayısı
+#define KARNAL_INFO_LOCK_BLOCKS        0x501u // Kilit veya futex beklerken bloklanma sayısı
+
+// RCU ve kaynak kaydı
+#define KARNAL_INFO_RCU_GRACE_PERIODS   0x600u // Tamamlanan RCU grace period sayısı
+#define KARNAL_INFO_REGISTRY_PROVIDERS  0x610u // Kayıtlı kaynak provider sayısı
+#define KARNAL_INFO_REGISTRY_REBUILDS   0x611u // Kayıt karma tablosunun yeniden kurulma sayısı
+
+// karnal_kernel_get_info bilgi türleri: kaynak handle tabloları.
+#define KARNAL_INFO_HANDLE_OPEN          0x700u // Tüm görevlerde açık kaynak handle sayısı
+#define KARNAL_INFO_HANDLE_STALE_REJECTS 0x701u // Kapatılmış/geçersiz olduğu için reddedilen handle kullanımı
+
+// karnal_kernel_get_info bilgi türleri: tek atımlık (tickless) zamanlayıcı.
+#define KARNAL_INFO_TIMER_INTERRUPTS 0x800u // İşlenen zamanlayıcı kesmesi sayısı
+#define KARNAL_INFO_TIMER_EXPIRED    0x801u // Dolan (uyandırma yapan) zamanlayıcı sayısı
+#define KARNAL_INFO_TIMER_COALESCED  0x802u // Esneklik aralığında başka bir son tarihle birleştirilen zamanlayıcı sayısı
+
+// karnal_kernel_get_info bilgi türleri: kesme dağıtımı.
+#define KARNAL_INFO_IRQ_HANDLED        0x900u // Bir işleyicinin üstlendiği kesme sayısı
+#define KARNAL_INFO_IRQ_THREAD_WAKEUPS 0x901u // Kesme iş parçacığına devredilen kesme sayısı
+#define KARNAL_INFO_IRQ_SPURIOUS       0x902u // İşleyicisi olmayan veya hiçbir işleyicinin üstlenmediği kesme sayısı
+
+// karnal_kernel_get_info bilgi türleri: tamponlu çekirdek konsolu.
+#define KARNAL_INFO_CONSOLE_BYTES   0xA00u // Konsola kabul edilen bayt sayısı
+#define KARNAL_INFO_CONSOLE_DROPPED 0xA01u // Halka dolu olduğu için atılan bayt sayısı
+
+// karnal_kernel_get_info bilgi türleri: çekirdek izleme (ktrace özelliğiyle derlenen çekirdeklerde).
+#define KARNAL_INFO_TRACE_RECORDS 0xB00u // İzleme halkalarına yazılan kayıt sayısı
+#define KARNAL_INFO_TRACE_LOST    0xB01u // Okunmadan ezilen kayıt sayısı
+// Sistem çağrısı `nr` (<128) için log2 gecikme histogramının `bucket` (<64) kovası: [2^bucket, 2^(bucket+1)) ns
+// süren çağrı sayısı.
+#define KARNAL_INFO_TRACE_SYSCALL_HIST(nr, bucket) (0x10000u | ((uint32_t)(nr) << 6) | (uint32_t)(bucket))
+
+// karnal_kernel_get_info bilgi türleri: bellek katmanları (`tier` KMEM_TIER_*, bkz. kernel_memory.h).
+// Yalnızca kmem_phys_add_tier_region ile eklenen bellek sayılır; genel zone'lar dahil değildir.
+#define KARNAL_INFO_MEM_TIER_TOTAL(tier) (0xC00u | (uint32_t)(tier)) // Katmanın toplam belleği (byte)
+#define KARNAL_INFO_MEM_TIER_USED(tier)  (0xC10u | (uint32_t)(tier)) // Katmandan tahsis edilmiş bellek (byte)
+#define KARNAL_INFO_MEM_FALLBACKS        0xC20u // İpucunun ilk katmanı dışından karşılanan tahsis sayısı
+#define KARNAL_INFO_MEM_REMOTE           0xC21u // Çalışan CPU'nun düğümü dışından karşılanan tahsis sayısı
+
+// karnal_kernel_get_info bilgi türleri: fiziksel frame ayırıcı (kmem_phys_*, genel zone'lar).
+#define KARNAL_INFO_PHYS_BAD_FREES     0xC30u // Reddedilen geçersiz veya çift serbest bırakma sayısı
+#define KARNAL_INFO_PHYS_LAST_BAD_FREE 0xC31u // Son reddedilen serbest bırakmanın fiziksel adresi
+
+// karnal_kernel_get_info bilgi türleri: açılış arşivi (karnal_initrd_register).
+#define KARNAL_INFO_INITRD_FILES 0xD00u // "karnal://bootfs/" altında kaydedilen dosya sayısı
+#define KARNAL_INFO_INITRD_BYTES 0xD01u // Kaydedilen dosyaların toplam boyutu (byte)
+
+// karnal_kernel_get_info bilgi türleri: açılış (karnal_init başlatma grafiği, ertelenmiş provider'lar).
+#define KARNAL_INFO_BOOT_GRAPH_NS     0xE00u // Başlatma grafiğinin toplam süresi (ns)
+#define KARNAL_INFO_BOOT_CPUS_JOINED  0xE01u // Grafiğe katılan CPU sayısı (önyükleme CPU'su dahil)
+#define KARNAL_INFO_BOOT_LAZY_INITS   0xE02u // İlk edinmede başlatılan ertelenmiş provider sayısı
+#define KARNAL_INFO_BOOT_STEP_NS(s)   (0xE40u + (s)) // Grafiğin `s`. adımının süresi (ns, s < 64)
+
+// karnal_kernel_get_info bilgi türleri: pil durumu (karnal_battery_publish, karnal://power/battery).
+#define KARNAL_INFO_BATTERY_UPDATES        0xF00u // Yayınlanan ölçüm sayısı
+#define KARNAL_INFO_BATTERY_NOTIFICATIONS  0xF01u // Abonelere gönderilen olay sayısı
+#define KARNAL_INFO_BATTERY_NOTIFY_DROPPED 0xF02u // Kuyruğu dolu olduğu için düşürülen olay sayısı
+
+// karnal_kernel_get_info bilgi türleri: frekans ve boşta durumu seçimi (srcdvfs.rs).
+#define KARNAL_INFO_DVFS_LEVEL_CHANGES     0xF10u // low_level_cpu_set_performance ile yapılan seviye değişimi
+#define KARNAL_INFO_DVFS_DEEP_IDLE_ENTRIES 0xF11u // Kayıtlı bir derin boşta durumuna giriş sayısı
+#define KARNAL_INFO_DVFS_CPU_LEVEL(cpu)    (0xF40u + (cpu)) // CPU'nun istenen seviyesi (0-1024, cpu < 32)
+#define KARNAL_INFO_DVFS_CPU_IDLE_NS(cpu)  (0xF60u + (cpu)) // CPU'nun toplam boşta süresi (ns, cpu < 32)
+
 /**
- * Sistem saatini (örneğin, epoch'tan beri geçen nanosaniye) alır.
+ * Sistem saatini (Unix epoch'tan beri geçen nanosaniye) alır. Sık çağıranlar aynı değeri
+ * karnal_time_page_realtime_ns ile sistem çağrısı yapmadan okuyabilir.
  * @return Başarı durumunda sistem zamanı değeri (uint64_t olarak, i64'e dönüştürülür >=0), hata durumunda negatif kerror_t döner.
  */
 int64_t karnal_kernel_get_time(void);
 
+// --- Paylaşımlı Zaman Sayfası ---
+// Çekirdek saat kaynağının kalibrasyonunu salt okunur bir sayfada yayınlar. Kullanıcı alanı donanım
+// sayacını kendisi okuyup nanosaniyeye çevirir; çekirdeğe girilmez:
+//     monoton ns = mono_base_ns + ((sayaç - counter_base) * mult) >> shift
+//     gerçek zaman ns = monoton ns + realtime_offset_ns
+// Sayfa seqlock ile korunur: seq tekse veya okuma sırasında değiştiyse okuma yinelenir.
+
+// KarnalTimePage_t.clock_source değerleri
+#define KARNAL_CLOCK_NONE        0 // Kullanıcı modunda okunabilir sayaç yok; sistem çağrısı kullanılır
+#define KARNAL_CLOCK_TSC         1 // amd64: rdtsc
+#define KARNAL_CLOCK_ARM_CNTVCT  2 // armv9: CNTVCT_EL0
+#define KARNAL_CLOCK_RISCV_TIME  3 // rv64g: time CSR (rdtime)
+
+typedef struct {
+    volatile uint32_t seq;          // Tek: çekirdek sayfayı güncelliyor
+    uint32_t clock_source;          // KARNAL_CLOCK_*
+    uint64_t counter_base;          // mono_base_ns anındaki sayaç değeri
+    uint64_t mono_base_ns;          // Önyüklemeden beri geçen süre (karnal_timer_now_ns ile aynı saat)
+    uint64_t mult;                  // Sayaç tikini ns'ye çeviren sabit noktalı katsayı
+    uint32_t shift;
+    uint32_t reserved;
+    uint64_t realtime_offset_ns;    // Gerçek zaman - monoton zaman
+} KarnalTimePage_t;
+
+/**
+ * Paylaşımlı zaman sayfasını mevcut görevin adres alanına salt okunur haritalar.
+ * Aynı görevde tekrar çağırmak aynı adresi döner.
+ * @return Başarı durumunda KarnalTimePage_t'nin kullanıcı alanı adresi (>=0), sayfa yoksa KERROR_NOT_SUPPORTED,
+ *         diğer hatalarda negatif kerror_t döner.
+ */
+int64_t karnal_time_page_map(void);
+
+// Saat kaynağının sayacını kullanıcı modunda okur. Bilinmeyen mimarilerde 0 döner (clock_source NONE olur).
+static inline uint64_t karnal_time_page_counter(uint32_t clock_source) {
+#if defined(__x86_64__)
+    uint32_t lo, hi;
+    (void)clock_source;
+    __asm__ __volatile__("lfence; rdtsc" : "=a"(lo), "=d"(hi)); // lfence: önceki yüklemelerden önce okunmasın
+    return ((uint64_t)hi << 32) | lo;
+#elif defined(__aarch64__)
+    uint64_t count;
+    (void)clock_source;
+    __asm__ __volatile__("isb; mrs %0, cntvct_el0" : "=r"(count));
+    return count;
+#elif defined(__riscv) && __riscv_xlen == 64
+    uint64_t count;
+    (void)clock_source;
+    __asm__ __volatile__("rdtime %0" : "=r"(count));
+    return count;
+#else
+    (void)clock_source;
+    return 0;
+#endif
+}
+
+// Monoton süreyi (ns) sayfadan okur. Sayfa kullanılamıyorsa *ok 0 yapılır ve 0 döner.
+static inline uint64_t karnal_time_page_read(const KarnalTimePage_t* page, uint64_t* realtime_offset_ns, int* ok) {
+    uint32_t seq, source, shift;
+    uint64_t counter_base, mono_base_ns, mult, offset, counter;
+    do {
+        seq = __atomic_load_n(&page->seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            continue; // Güncelleniyor
+        }
+        source = page->clock_source;
+        counter_base = page->counter_base;
+        mono_base_ns = page->mono_base_ns;
+        mult = page->mult;
+        shift = page->shift;
+        offset = page->realtime_offset_ns;
+        counter = karnal_time_page_counter(source);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) || __atomic_load_n(&page->seq, __ATOMIC_RELAXED) != seq);
+
+    if (source == KARNAL_CLOCK_NONE) {
+        *ok = 0;
+        return 0;
+    }
+    *ok = 1;
+    *realtime_offset_ns = offset;
+    return mono_base_ns + (uint64_t)(((unsigned __int128)(counter - counter_base) * mult) >> shift);
+}
+
+// Önyüklemeden beri geçen süre (ns). Sayfa kullanılamıyorsa karnal_timer_now_ns'e döner.
+static inline uint64_t karnal_time_page_monotonic_ns(const KarnalTimePage_t* page) {
+    uint64_t offset;
+    int ok;
+    uint64_t ns = karnal_time_page_read(page, &offset, &ok);
+    return ok ? ns : karnal_timer_now_ns();
+}
+
+// Unix epoch'tan beri geçen süre (ns). Sayfa kullanılamıyorsa karnal_kernel_get_time'a döner.
+static inline uint64_t karnal_time_page_realtime_ns(const KarnalTimePage_t* page) {
+    uint64_t offset;
+    int ok;
+    uint64_t ns = karnal_time_page_read(page, &offset, &ok);
+    return ok ? ns + offset : (uint64_t)karnal_kernel_get_time();
+}
+
 
 // --- Senkronizasyon ---
+// Kilit, rwlock ve koşul değişkeni handle'ları görev başına handle tablosundan verilir: yalnızca oluşturan
+// görevde geçerlidir ve karnal_resource_release ile kapatılır. Bırakma yalnızca kilidi tutan iş parçacığından
+// kabul edilir.
 
 /**
  * Yeni bir kilit (Lock) kaynağı oluşturur.
@@ -203,7 +538,9 @@ int64_t karnal_kernel_get_time(void);
 int64_t karnal_sync_lock_create(void);
 
 /**
- * Kilidi almaya çalışır. Başka bir görev/iş parçacığı tutuyorsa bloklar.
+ * Kilidi almaya çalışır. Başka bir görev/iş parçacığı tutuyorsa: sahip başka bir CPU'da çalışıyorsa
+ * kısa süre döner, çalışmıyorsa (veya bekleme uzarsa) bloklanır.
+ * Kullanıcı alanında yarışmasız durumda çekirdeğe girmeyen kilit için KarnalUserLock kullanın.
  * @param handle_value Kilit handle değeri.
  * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
  */
@@ -212,10 +549,141 @@ int64_t karnal_sync_lock_acquire(khandle_t handle_value);
 /**
  * Kilidi serbest bırakır. Çağıranın kilidi tutuyor olması gerekir.
  * @param handle_value Kilit handle değeri.
- * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
+ * @return Başarı durumunda 0, çağıran iş parçacığı kilidi tutmuyorsa KERROR_PERMISSION_DENIED,
+ *         diğer hatalarda negatif kerror_t döner.
  */
 int64_t karnal_sync_lock_release(khandle_t handle_value);
 
+/**
+ * Yeni bir okuyucu-yazıcı kilidi oluşturur. Yazıcı önceliklidir: bekleyen bir yazıcı varken yeni okuyucular
+ * bloklanır, böylece sürekli okuma yükü yazıcıları aç bırakmaz.
+ * Handle karnal_resource_release ile silinir (tutuluyorsa KERROR_BUSY).
+ * @return Başarı durumunda rwlock handle'ı (>=0), hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_sync_rwlock_create(void);
+
+/**
+ * Kilidi okuma için alır; başka okuyucularla birlikte tutulabilir. Bir iş parçacığı aynı kilidi aynı anda
+ * bir kez okuma için tutabilir.
+ * @param handle_value RwLock handle değeri.
+ * @return Başarı durumunda 0, çağıran kilidi zaten okuma için tutuyorsa KERROR_BUSY, diğer hatalarda negatif kerror_t döner.
+ */
+int64_t karnal_sync_rwlock_read_acquire(khandle_t handle_value);
+
+/**
+ * Okuma kilidini bırakır. Son okuyucu bekleyen bir yazıcıyı uyandırır.
+ * @param handle_value RwLock handle değeri.
+ * @return Başarı durumunda 0, çağıran iş parçacığı kilidi okuma için tutmuyorsa KERROR_PERMISSION_DENIED döner.
+ */
+int64_t karnal_sync_rwlock_read_release(khandle_t handle_value);
+
+/**
+ * Kilidi yazma için (tek başına) alır.
+ * @param handle_value RwLock handle değeri.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_sync_rwlock_write_acquire(khandle_t handle_value);
+
+/**
+ * Yazma kilidini bırakır. Bekleyen yazıcı varsa biri, yoksa bekleyen tüm okuyucular uyandırılır.
+ * @param handle_value RwLock handle değeri.
+ * @return Başarı durumunda 0, çağıran iş parçacığı kilidi yazma için tutmuyorsa KERROR_PERMISSION_DENIED döner.
+ */
+int64_t karnal_sync_rwlock_write_release(khandle_t handle_value);
+
+/**
+ * Yeni bir koşul değişkeni oluşturur. karnal_sync_lock_create ile oluşturulan kilitlerle kullanılır.
+ * @return Başarı durumunda koşul değişkeni handle'ı (>=0), hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_sync_cond_create(void);
+
+/**
+ * Tutulan kilidi bırakır ve bildirim gelene kadar bekler; dönmeden önce kilidi yeniden alır.
+ * Kilidin bırakılmasıyla bekleme arasında gelen bildirim kaybolmaz. Uyanma koşulun sağlandığı anlamına
+ * gelmez; koşulu döngü içinde yeniden kontrol edin.
+ * @param cond_handle Koşul değişkeni handle değeri.
+ * @param lock_handle Çağıranın tuttuğu kilit handle değeri.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_sync_cond_wait(khandle_t cond_handle, khandle_t lock_handle);
+
+/**
+ * Koşul değişkeninde bekleyen bir iş parçacığını uyandırır.
+ * @param cond_handle Koşul değişkeni handle değeri.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_sync_cond_notify_one(khandle_t cond_handle);
+
+/**
+ * Koşul değişkeninde bekleyen tüm iş parçacıklarını uyandırır.
+ * @param cond_handle Koşul değişkeni handle değeri.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_sync_cond_notify_all(khandle_t cond_handle);
+
+/**
+ * *addr hâlâ expected ise çağıranı karnal_futex_wake gelene kadar bloklar. Kelime fiziksel adresiyle
+ * eşleştirilir; paylaşılan bellekteki bir kelime farklı görevlerden beklenebilir.
+ * @param addr 4 byte hizalı bekleme kelimesi.
+ * @param expected Beklenen değer.
+ * @return Uyandırıldıysa 0, değer zaten farklıysa KERROR_BUSY (yeniden okuyup deneyin), diğer hatalarda negatif kerror_t.
+ */
+int64_t karnal_futex_wait(const uint32_t* addr, uint32_t expected);
+
+/**
+ * karnal_futex_wait gibi, ancak en fazla timeout_ns bekler.
+ * @param addr 4 byte hizalı bekleme kelimesi.
+ * @param expected Beklenen değer.
+ * @param timeout_ns En uzun bekleme süresi (nanosaniye).
+ * @return Uyandırıldıysa 0, süre dolduysa KERROR_TIMED_OUT, değer zaten farklıysa KERROR_BUSY, diğer hatalarda negatif kerror_t.
+ */
+int64_t karnal_futex_wait_timeout(const uint32_t* addr, uint32_t expected, uint64_t timeout_ns);
+
+/**
+ * addr üzerinde bekleyen en fazla count iş parçacığını uyandırır.
+ * @param addr Bekleme kelimesi.
+ * @param count Uyandırılacak en fazla iş parçacığı (UINT32_MAX: hepsi).
+ * @return Uyandırılan iş parçacığı sayısı (>=0), hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_futex_wake(const uint32_t* addr, uint32_t count);
+
+// Yarışmasız durumda çekirdeğe girmeyen kullanıcı alanı kilidi (futex üzerine).
+// state: 0 boş, 1 tutuluyor, 2 tutuluyor ve bekleyen olabilir. Bekleme ve uyandırma yalnızca 2 durumunda çekirdeğe girer.
+typedef struct KarnalUserLock {
+    uint32_t state;
+} KarnalUserLock;
+
+#define KARNAL_USER_LOCK_INIT { 0 }
+#define KARNAL_USER_LOCK_SPINS 100 // Bloklanmadan önce boş kalmasını bekleyen dönme turu
+
+static inline void karnal_user_lock_acquire(KarnalUserLock* lock) {
+    uint32_t c = 0;
+    if (__atomic_compare_exchange_n(&lock->state, &c, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return; // Hızlı yol: sistem çağrısı yok
+    }
+    // Kısa kritik bölgeler için bekleyen yokken dön
+    for (int i = 0; i < KARNAL_USER_LOCK_SPINS && c == 1; i++) {
+        c = 0;
+        if (__atomic_compare_exchange_n(&lock->state, &c, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return;
+        }
+    }
+    // Bekleyen var olarak işaretle ve kelime 0 görülene kadar bloklan
+    if (c != 2) {
+        c = __atomic_exchange_n(&lock->state, 2, __ATOMIC_ACQUIRE);
+    }
+    while (c != 0) {
+        karnal_futex_wait(&lock->state, 2);
+        c = __atomic_exchange_n(&lock->state, 2, __ATOMIC_ACQUIRE);
+    }
+}
+
+static inline void karnal_user_lock_release(KarnalUserLock* lock) {
+    if (__atomic_exchange_n(&lock->state, 0, __ATOMIC_RELEASE) == 2) {
+        karnal_futex_wake(&lock->state, 1); // Yalnızca bekleyen olabilirse çekirdeğe gir
+    }
+}
+
 
 // --- Mesajlaşma / IPC ---
 
@@ -229,12 +697,192 @@ int64_t karnal_sync_lock_release(khandle_t handle_value);
 int64_t karnal_messaging_send(ktid_t target_task_id_value, const uint8_t* message_ptr, size_t message_len); // Pointerlar kullanıcı adresinde, içeride doğrulanmalı
 
 /**
- * Mevcut görev için gelen bir mesajı alır.
+ * Bir kanaldan gelen mesajı alır; kuyruk boşsa mesaj gelene kadar bloklar.
+ * @param channel_handle Mesajın alınacağı kanalın handle'ı.
  * @param user_buffer_ptr Kullanıcı alanındaki tampon pointer'ı.
  * @param user_buffer_len Kullanıcı tamponunun uzunluğu.
- * @return Başarı durumunda alınan mesajın boyutu (size_t olarak, i64'e dönüştürülür >=0), mesaj yoksa KERROR_NO_MESSAGE veya başka bir negatif kerror_t döner.
+ * @return Başarı durumunda alınan mesajın boyutu (size_t olarak, i64'e dönüştürülür >=0), geçersiz handle için KERROR_BAD_HANDLE veya başka bir negatif kerror_t döner.
+ */
+int64_t karnal_messaging_receive(khandle_t channel_handle, uint8_t* user_buffer_ptr, size_t user_buffer_len); // Pointer kullanıcı adresinde, içeride doğrulanmalı
+
+/**
+ * Mesajı kopyalamadan, sayfa devri (page transfer) ile gönderir.
+ * Mesajın fiziksel frame'leri gönderenin adres alanından kaldırılır ve alıcıya devredilir;
+ * çağrı başarılı olduktan sonra gönderen bu aralığa erişmemeli (aralık artık haritalı değildir).
+ * Alıcı karnal_messaging_receive'i KERNEL_PAGE_SIZE hizalı ve yeterince büyük bir tamponla
+ * çağırırsa frame'ler doğrudan o tampona haritalanır; aksi halde veri kopyalanır.
+ * Küçük mesajlar için karnal_messaging_send (kopyalama yolu) daha ucuzdur.
+ * @param target_task_id_value Hedef görevin Task ID değeri.
+ * @param message_ptr Kullanıcı alanındaki mesaj verisi pointer'ı (KERNEL_PAGE_SIZE hizalı olmalı).
+ * @param message_len Mesaj verisi uzunluğu (son sayfa kısmi olabilir, sayfanın tamamı devredilir).
+ * @return Başarı durumunda 0, hizalama uygun değilse KERROR_INVALID_ARGUMENT veya başka bir negatif kerror_t döner.
+ */
+int64_t karnal_messaging_send_pages(ktid_t target_task_id_value, const uint8_t* message_ptr, size_t message_len); // Pointer kullanıcı adresinde, içeride doğrulanmalı
+
+// Kanal türleri (karnal_messaging_channel_create flags). Her kanalın tek bir alıcısı vardır.
+#define KARNAL_CHANNEL_SPSC 0 // Tek gönderen: gönderim tarafı CAS yerine düz store kullanır
+#define KARNAL_CHANNEL_MPSC 1 // Çok gönderen: gönderenler kuyruk konumunu CAS ile talep eder
+
+/**
+ * Önceden ayrılmış, sınırlı kapasiteli ve kilitsiz bir mesaj kanalı oluşturur.
+ * Mesaj yuvaları burada bir kez ayrılır; gönderme/alma hızlı yolda kilit almaz ve bellek ayırmaz
+ * (büyük mesajların verisi hariç). Kuyruk doluysa gönderen, boşsa alıcı bloklanır.
+ * Aynı kanalda eşzamanlı ikinci bir alıcı (veya SPSC kanalda ikinci bir gönderen) KERROR_BUSY alır.
+ * @param capacity Mesaj yuvası sayısı (ikinin kuvvetine yuvarlanır, en fazla 65536).
+ * @param flags KARNAL_CHANNEL_SPSC veya KARNAL_CHANNEL_MPSC.
+ * @return Başarı durumunda kanal handle değeri (khandle_t olarak, >=0), hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_messaging_channel_create(uint32_t capacity, uint32_t flags);
+
+// Senkron çağrı/yanıt (karnal_messaging_call / karnal_messaging_reply_and_wait) ile taşınabilen en büyük
+// istek veya yanıt. Daha büyük veriler için karnal_messaging_send_pages kullanılmalıdır.
+#define KARNAL_IPC_CALL_MAX_SIZE 128
+// Uç noktanın kayıt defterinde yayımlanabileceği en uzun isim
+#define KARNAL_IPC_ENDPOINT_NAME_MAX 64
+
+/**
+ * Senkron çağrı/yanıt uç noktası oluşturur. Sunucu uç noktada karnal_messaging_reply_and_wait ile
+ * bekler, istemciler karnal_messaging_call ile çağırır. Mesajlar kuyruğa girmez: karşı taraf bekliyorsa
+ * CPU doğrudan ona devredilir (çalışma kuyruğu atlanır).
+ * Handle, çağıran görevin handle tablosunda açılır ve başka görevde geçersizdir. İsim verilirse uç nokta
+ * kaynak kayıt defterinde de yayımlanır; diğer görevler kendi handle'larını karnal_resource_acquire ile alır.
+ * Uç nokta karnal_messaging_endpoint_destroy ile veya sahibi olan görev sonlandığında kapanır.
+ * @param name Kayıt ismi (kullanıcı alanı) veya isimsiz uç nokta için NULL.
+ * @param name_len İsim uzunluğu (en fazla KARNAL_IPC_ENDPOINT_NAME_MAX; 0 = isimsiz).
+ * @return Başarı durumunda uç nokta handle değeri (>=0), isim kayıtlıysa KERROR_ALREADY_EXISTS,
+ *         diğer hatalarda negatif kerror_t döner.
+ */
+int64_t karnal_messaging_endpoint_create(const uint8_t* name, size_t name_len);
+
+/**
+ * Çağıran görevin oluşturduğu uç noktayı kapatır ve handle'ı serbest bırakır. Bekleyen ve sonraki
+ * karnal_messaging_call çağrıları ile bekleyen sunucu KERROR_BAD_HANDLE döner; isim kayıttan silinir.
+ * @return Başarı durumunda 0, uç noktanın sahibi değilse KERROR_PERMISSION_DENIED, diğer hatalarda
+ *         negatif kerror_t döner.
+ */
+int64_t karnal_messaging_endpoint_destroy(khandle_t endpoint);
+
+/**
+ * Uç noktanın sunucusuna istek gönderir ve yanıt gelene kadar bloklanır. Sunucu meşgulse istemciler
+ * geliş sırasıyla bekler.
+ * @param endpoint karnal_messaging_endpoint_create ile alınmış handle.
+ * @param request_ptr İstek verisi (kullanıcı alanı).
+ * @param request_len İstek uzunluğu (en fazla KARNAL_IPC_CALL_MAX_SIZE).
+ * @param reply_buf Yanıtın yazılacağı tampon (kullanıcı alanı).
+ * @param reply_cap Tampon boyutu; daha uzun yanıt kırpılır.
+ * @return Başarı durumunda kopyalanan yanıt uzunluğu (>=0), uç nokta yanıttan önce kapatıldıysa
+ *         KERROR_BAD_HANDLE, diğer hatalarda negatif kerror_t döner.
+ */
+int64_t karnal_messaging_call(khandle_t endpoint, const uint8_t* request_ptr, size_t request_len, uint8_t* reply_buf, size_t reply_cap); // Pointerlar kullanıcı adresinde, içeride doğrulanmalı
+
+/**
+ * Sunucu tarafı: bir önceki isteğin yanıtını verir ve aynı çağrıda sıradaki isteği bekler. Sunucunun ilk
+ * çağrısı boş yanıtla (reply_len 0) yapılır. Bir uç noktada aynı anda tek sunucu iş parçacığı bekleyebilir.
+ * @param endpoint Uç nokta handle'ı.
+ * @param reply_ptr Önceki isteğin yanıtı (kullanıcı alanı).
+ * @param reply_len Yanıt uzunluğu (en fazla KARNAL_IPC_CALL_MAX_SIZE).
+ * @param recv_buf Sıradaki isteğin yazılacağı tampon (kullanıcı alanı).
+ * @param recv_cap Tampon boyutu; daha uzun istek kırpılır.
+ * @return Başarı durumunda kopyalanan istek uzunluğu (>=0), başka bir sunucu bekliyorsa KERROR_BUSY,
+ *         uç nokta kapatıldıysa KERROR_BAD_HANDLE, diğer hatalarda negatif kerror_t döner.
+ */
+int64_t karnal_messaging_reply_and_wait(khandle_t endpoint, const uint8_t* reply_ptr, size_t reply_len, uint8_t* recv_buf, size_t recv_cap); // Pointerlar kullanıcı adresinde, içeride doğrulanmalı
+
+
+// --- Asenkron Çağrı Halkası (Submission/Completion Ring) ---
+// Her görev, kullanıcı alanına haritalanmış paylaşımlı bir halka çifti kurabilir.
+// Görev, gönderim halkasına (SQ) işlem kayıtları yazar ve SQ tail'ini ilerletir;
+// çekirdek işlemleri yürütüp sonuçları tamamlama halkasına (CQ) yazar.
+// Tek bir karnal_ring_enter çağrısı birçok işlemi birden gönderir/toplar.
+// KARNAL_RING_SETUP_SQPOLL ile kurulan halkalarda çekirdek SQ'yu kendisi yoklar, enter gerekmez.
+
+// Halka işlem kodları (KarnalSqe_t.opcode)
+#define KARNAL_OP_NOP               0
+#define KARNAL_OP_RESOURCE_READ     1  // handle, addr=buffer, len, offset
+#define KARNAL_OP_RESOURCE_WRITE    2  // handle, addr=buffer, len, offset
+#define KARNAL_OP_RESOURCE_READV    3  // handle, addr=KarnalIoVec_t dizisi, len=segment sayısı
+#define KARNAL_OP_RESOURCE_WRITEV   4  // handle, addr=KarnalIoVec_t dizisi, len=segment sayısı
+#define KARNAL_OP_RESOURCE_CONTROL  5  // handle, addr=request, offset=arg
+#define KARNAL_OP_MESSAGING_SEND    6  // handle=hedef ktid_t, addr=mesaj, len
+#define KARNAL_OP_TASK_SLEEP        7  // offset=milisaniye; süre dolunca tamamlanır
+
+// karnal_ring_setup bayrakları
+#define KARNAL_RING_SETUP_SQPOLL    (1u << 0) // Çekirdek SQ'yu yoklar (enter çağrısı gerekmez)
+
+// KarnalRingHeader_t.sq_flags bayrakları
+#define KARNAL_RING_SQ_NEED_WAKEUP  (1u << 0) // Yoklayıcı uykuda, KARNAL_RING_ENTER_SQ_WAKEUP ile uyandırılmalı
+
+// karnal_ring_enter bayrakları
+#define KARNAL_RING_ENTER_GETEVENTS  (1u << 0) // min_complete kadar tamamlanma olana kadar bekle
+#define KARNAL_RING_ENTER_SQ_WAKEUP  (1u << 1) // SQPOLL yoklayıcısını uyandır
+
+// En fazla halka girdisi (2'nin kuvveti olmalı)
+#define KARNAL_RING_MAX_ENTRIES 4096
+
+// Gönderim halkası girdisi (Submission Queue Entry), 48 byte.
+typedef struct KarnalSqe {
+    uint8_t opcode;      // KARNAL_OP_*
+    uint8_t flags;       // İleride kullanım için ayrılmış, 0 olmalı
+    uint16_t reserved0;
+    uint32_t reserved1;
+    uint64_t handle;     // Kaynak handle'ı veya hedef görev ID'si
+    uint64_t addr;       // Tampon / iovec dizisi adresi veya control request
+    uint64_t len;        // Tampon uzunluğu veya segment sayısı
+    uint64_t offset;     // Kaynak ofseti, control argümanı veya uyku süresi
+    uint64_t user_data;  // Tamamlanma girdisine olduğu gibi kopyalanır
+} KarnalSqe_t;
+
+// Tamamlanma halkası girdisi (Completion Queue Entry), 16 byte.
+typedef struct KarnalCqe {
+    uint64_t user_data;  // İlgili KarnalSqe_t.user_data
+    int64_t result;      // İlgili senkron çağrının dönüş değeri (>=0 başarı, <0 kerror_t)
+} KarnalCqe_t;
+
+// Paylaşımlı halka başlığı. Haritalanan bölgenin başında yer alır;
+// SQE dizisi sqe_off, CQE dizisi cqe_off ofsetindedir.
+// head/tail değerleri serbestçe artan sayaçlardır; indeks = değer & mask.
+typedef struct KarnalRingHeader {
+    volatile uint32_t sq_head;  // Çekirdek ilerletir
+    volatile uint32_t sq_tail;  // Kullanıcı ilerletir
+    uint32_t sq_mask;
+    uint32_t sq_entries;
+    volatile uint32_t sq_flags; // KARNAL_RING_SQ_*
+    uint32_t sqe_off;
+    volatile uint32_t cq_head;  // Kullanıcı ilerletir
+    volatile uint32_t cq_tail;  // Çekirdek ilerletir
+    uint32_t cq_mask;
+    uint32_t cq_entries;
+    volatile uint32_t cq_overflow; // CQ doluyken düşürülen tamamlanma sayısı
+    uint32_t cqe_off;
+} KarnalRingHeader_t;
+
+/**
+ * Mevcut görev için bir gönderim/tamamlanma halkası kurar ve kullanıcı alanına haritalar.
+ * @param entries SQ girdi sayısı (2'nin kuvvetine yuvarlanır, en fazla KARNAL_RING_MAX_ENTRIES). CQ bunun iki katıdır.
+ * @param flags KARNAL_RING_SETUP_* bayrakları.
+ * @param ring_addr_out Başarı durumunda haritalanan KarnalRingHeader_t'nin kullanıcı alanı adresi buraya yazılır.
+ * @return Başarı durumunda halka handle'ı (>=0), hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_ring_setup(uint32_t entries, uint32_t flags, uint64_t* ring_addr_out); // Pointer kullanıcı adresinde, içeride doğrulanmalı
+
+/**
+ * Halkadaki bekleyen gönderimleri işler ve isteğe bağlı olarak tamamlanmaları bekler.
+ * @param ring_handle karnal_ring_setup'tan dönen handle.
+ * @param to_submit İşlenecek en fazla SQE sayısı.
+ * @param min_complete KARNAL_RING_ENTER_GETEVENTS verilmişse beklenecek en az tamamlanma sayısı.
+ *        Bekleyen iş parçacığı bloklanır; tamamlanma yazılınca veya bir KARNAL_OP_TASK_SLEEP dolunca uyandırılır.
+ * @param flags KARNAL_RING_ENTER_* bayrakları.
+ * @return Başarı durumunda işlenen SQE sayısı (>=0), halkada çok fazla bekleyen varsa KERROR_BUSY,
+ *         diğer hatalarda negatif kerror_t döner.
+ */
+int64_t karnal_ring_enter(khandle_t ring_handle, uint32_t to_submit, uint32_t min_complete, uint32_t flags);
+
+/**
+ * Halkayı kullanıcı alanından kaldırır ve kaynaklarını serbest bırakır.
+ * @param ring_handle Halka handle'ı.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
  */
-int64_t karnal_messaging_receive(uint8_t* user_buffer_ptr, size_t user_buffer_len); // Pointer kullanıcı adresinde, içeride doğrulanmalı
+int64_t karnal_ring_destroy(khandle_t ring_handle);
 
 
 // --- Çekirdek Bileşenleri Kayıt API'sı (Örnek) ---
@@ -250,6 +898,14 @@ typedef struct KarnalResourceProviderC {
     int64_t (*read_fn)(void* provider_data, uint8_t* buffer, size_t size, uint64_t offset);
     int64_t (*write_fn)(void* provider_data, const uint8_t* buffer, size_t size, uint64_t offset);
     int64_t (*control_fn)(void* provider_data, uint64_t request, uint64_t arg);
+    // Opsiyonel vektörel G/Ç slotları. NULL bırakılırsa Karnal64 segmentler üzerinde
+    // read_fn/write_fn'i döngüyle çağırarak aynı sonucu üretir.
+    int64_t (*readv_fn)(void* provider_data, const KarnalIoVec_t* iov, size_t iov_count);
+    int64_t (*writev_fn)(void* provider_data, const KarnalIoVec_t* iov, size_t iov_count);
+    // Opsiyonel kopyasız haritalama slotu: sayfa hizalı `offset`'i tutan fiziksel frame'i (>=0) veya
+    // negatif kerror_t döner. `prot` KARNAL_MAP_* bayraklarıdır; desteklenmeyen izin için
+    // KERROR_PERMISSION_DENIED dönülmelidir. NULL ise karnal_resource_map KERROR_NOT_SUPPORTED döner.
+    int64_t (*map_fn)(void* provider_data, uint64_t offset, uint32_t prot);
     // ... diğer trait fonksiyonları ...
     void* provider_data;
 } KarnalResourceProviderC_t;
@@ -264,6 +920,289 @@ typedef struct KarnalResourceProviderC {
  */
 int64_t karnal_resource_register_c_provider(const uint8_t* id_ptr, size_t id_len, const KarnalResourceProviderC_t* provider_c_fns);
 
+/**
+ * karnal_resource_register_c_provider ile yapılan kaydı siler (örneğin sürücü kaldırılırken).
+ * Devam eden aramalar bitene kadar bekler; dönüşte ID artık karnal_resource_acquire ile bulunamaz.
+ * Önceden edinilmiş handle'lar provider'ı kullanmaya devam edebilir; provider_data bu handle'lar
+ * serbest bırakılana kadar geçerli kalmalıdır.
+ * @param id_ptr Kayıtta kullanılan kaynak ID pointer'ı.
+ * @param id_len Kaynak ID uzunluğu.
+ * @return Başarı durumunda 0, ID kayıtlı değilse KERROR_NOT_FOUND, diğer hatalarda negatif kerror_t döner.
+ */
+int64_t karnal_resource_unregister_provider(const uint8_t* id_ptr, size_t id_len);
+
+/**
+ * Önyükleyicinin yüklediği cpio "newc" arşivini yerinde tarar ve her normal dosyayı
+ * "karnal://bootfs/<yol>" adıyla salt okunur bir kaynak olarak kaydeder. Dosyalar kopyalanmaz: okumalar
+ * arşivden yapılır, verisi sayfa hizalı dosyaların sayfaları görevlere doğrudan eşlenir.
+ * Arşiv belleği fiziksel bellek ayırıcısına verilmemiş olmalıdır ve bu çağrıdan sonra çekirdeğe aittir.
+ * Yalnızca bir kez, karnal_init sonrasında çağrılır.
+ * @param phys_base Arşivin fiziksel başlangıç adresi.
+ * @param size Arşiv boyutu (byte).
+ * @return Başarı durumunda kaydedilen dosya sayısı (>=0), arşiv bozuksa KERROR_INVALID_ARGUMENT,
+ *         daha önce çağrıldıysa KERROR_ALREADY_EXISTS döner.
+ */
+int64_t karnal_initrd_register(uint64_t phys_base, uint64_t size);
+
+/**
+ * Açılışta gerekmeyen bir provider'ın kaydını ilk karnal_resource_acquire'a erteler. ID kayıt defterinde
+ * bulunamadığında init_fn(data) bir kez çağrılır ve provider'ı aynı ID ile
+ * karnal_resource_register_c_provider kullanarak kaydetmelidir; aynı anda edinmeye çalışanlar bekler.
+ * init_fn negatif dönerse edinme hatayla döner, sonraki edinme yeniden dener.
+ * @param id_ptr Kaynak ID pointer'ı; çekirdek ömrü boyunca geçerli kalmalıdır (statik string).
+ * @param id_len Kaynak ID uzunluğu.
+ * @param init_fn Provider'ı kaydeden fonksiyon. İş parçacığı bağlamında çağrılır, uyuyabilir.
+ * @param data init_fn'e verilecek değer.
+ * @return Başarı durumunda 0, ID zaten kayıtlı veya ertelenmişse KERROR_ALREADY_EXISTS,
+ *         tablo doluysa KERROR_OUT_OF_MEMORY döner.
+ */
+int64_t karnal_resource_register_lazy(const uint8_t* id_ptr, size_t id_len, int64_t (*init_fn)(void* data), void* data);
+
+
+// --- Kesmeler (Sürücüler İçin) ---
+// Kesme numaraları mantıksaldır: mimari katman (hardware_specific.h) bunları IDT vektörüne, GIC INTID'ye
+// veya PLIC kaynağına eşler. Her numaraya bir birincil işleyici (kesme bağlamında, kısa) ve bir iş
+// parçacığı işlevi (iş parçacığı bağlamında, uyuyabilir) bağlanabilir. Birincil işleyici işi
+// KARNAL_IRQ_WAKE_THREAD dönerek kesmenin iş parçacığına devreder.
+
+// Birincil işleyici dönüş değerleri
+#define KARNAL_IRQ_NONE        0u // Kesme bu cihazdan değil
+#define KARNAL_IRQ_HANDLED     1u // Kesme tamamen işlendi
+#define KARNAL_IRQ_WAKE_THREAD 2u // Kalan iş kesme iş parçacığında yapılacak
+
+// karnal_irq_request bayrakları
+#define KARNAL_IRQ_FLAG_ONESHOT (1u << 0) // Hat, iş parçacığı işlevi dönene kadar maskeli kalır (seviye tetiklemeli hatlar)
+
+// Birincil işleyici: kesme bağlamında, kesmeler kapalıyken çalışır; uyuyamaz.
+typedef uint32_t (*karnal_irq_handler_t)(uint32_t irq, uint64_t context);
+// İş parçacığı işlevi: kesmeye ayrılmış çekirdek iş parçacığında çalışır; uyuyabilir, kilit alabilir.
+typedef void (*karnal_irq_thread_fn_t)(uint32_t irq, uint64_t context);
+// MSI/MSI-X mesajını cihaza yazar (sürücü, PCI yapılandırma alanına veya MSI-X tablosuna).
+typedef void (*karnal_msi_write_fn_t)(uint32_t irq, uint64_t context, uint64_t address, uint32_t data);
+
+/**
+ * Kesme numarasına işleyici bağlar ve hattın maskesini kaldırır.
+ * Yalnızca thread_fn verilirse her kesme doğrudan iş parçacığına devredilir.
+ * @param irq Mantıksal kesme numarası.
+ * @param handler Birincil işleyici veya NULL.
+ * @param thread_fn İş parçacığı işlevi veya NULL. KARNAL_IRQ_FLAG_ONESHOT için zorunludur.
+ * @param context İşleyicilere aynen geçirilen değer.
+ * @param flags KARNAL_IRQ_FLAG_* bayrakları.
+ * @return Başarı durumunda 0, numara kullanımdaysa KERROR_ALREADY_EXISTS, numara mimariye ayrılmışsa
+ *         (IPI vektörü, SGI) KERROR_PERMISSION_DENIED, diğer hatalarda negatif kerror_t döner.
+ */
+int64_t karnal_irq_request(uint32_t irq, karnal_irq_handler_t handler, karnal_irq_thread_fn_t thread_fn, uint64_t context, uint32_t flags);
+
+/**
+ * İşleyiciyi kaldırır ve hattı maskeler. Çalışmakta olan işleyiciler ve iş parçacığı bitene kadar bekler;
+ * dönüşte context artık kullanılmaz. karnal_irq_msi_alloc ile ayrılıp hiç kaydedilmemiş numarada
+ * yalnızca ayırmayı geri verir.
+ * @param irq Mantıksal kesme numarası.
+ * @return Başarı durumunda 0, işleyici veya ayırma yoksa KERROR_NOT_FOUND döner.
+ */
+int64_t karnal_irq_free(uint32_t irq);
+
+/**
+ * Kesmeyi devre dışı bırakır. Donanım hattı hemen maskelenmez: bu arada gelen kesme bekletilir ve
+ * hat o anda maskelenir; karnal_irq_unmask bekleyen kesmeyi yeniden çalıştırır.
+ * Dönüşte çalışmakta olan birincil işleyiciler bitmiştir.
+ * @param irq Mantıksal kesme numarası.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_irq_mask(uint32_t irq);
+
+/**
+ * karnal_irq_mask ile devre dışı bırakılan kesmeyi yeniden etkinleştirir.
+ * @param irq Mantıksal kesme numarası.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_irq_unmask(uint32_t irq);
+
+/**
+ * Kesmeyi bir CPU'ya yönlendirir. MSI kesmelerinde mesaj yeniden oluşturulup cihaza yazılır; kesmenin
+ * iş parçacığı da aynı CPU'ya taşınır.
+ * @param irq Mantıksal kesme numarası.
+ * @param cpu Hedef CPU (çevrimiçi olmalı).
+ * @return Başarı durumunda 0, denetleyici yönlendirmeyi desteklemiyorsa KERROR_NOT_SUPPORTED döner.
+ */
+int64_t karnal_irq_set_affinity(uint32_t irq, uint32_t cpu);
+
+/**
+ * MSI/MSI-X için boş bir kesme numarası ayırır ve en az kesme atanmış çevrimiçi CPU'ya yönlendirir.
+ * Ardından karnal_irq_msi_setup ve karnal_irq_request çağrılmalıdır.
+ * @return Başarı durumunda kesme numarası (>=0), boş numara kalmadıysa KERROR_BUSY döner.
+ */
+int64_t karnal_irq_msi_alloc(void);
+
+/**
+ * MSI numarasının mesajını oluşturur ve write ile cihaza yazdırır. write, karnal_irq_set_affinity
+ * sonrasında da (yeni adres/veri ile) çağrılır; karnal_irq_free'ye kadar geçerli kalmalıdır.
+ * @param irq karnal_irq_msi_alloc ile alınmış kesme numarası.
+ * @param write Mesajı cihaza yazan işlev.
+ * @param context write'a aynen geçirilen değer.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t döner.
+ */
+int64_t karnal_irq_msi_setup(uint32_t irq, karnal_msi_write_fn_t write, uint64_t context);
+
+
+// --- Çekirdek Konsolu (Sürücüler İçin) ---
+// Konsol provider'ları çıktıyı UART'a doğrudan yazmak yerine buraya bırakır. Her CPU'nun kilitsiz bir
+// halkası vardır; UART arka planda TX kesmesiyle boşaltılır. Mimari UART kesmesi sunmuyorsa yazma
+// low_level_console_putc ile eşzamanlı yapılır.
+
+/**
+ * Mesajı bütün olarak çalışan CPU'nun konsol halkasına ekler; UART'ı hiçbir durumda beklemez. Kesme
+ * bağlamından da çağrılabilir. Halkanın boş yerine sığmayan mesaj eklenmeden atılır ve baytları
+ * KARNAL_INFO_CONSOLE_DROPPED'a sayılır.
+ * @param buffer Yazılacak baytlar.
+ * @param size Bayt sayısı.
+ * @return Eklenen bayt sayısı (size veya atıldıysa 0), buffer NULL ise KERROR_INVALID_ARGUMENT döner.
+ */
+int64_t karnal_console_write(const uint8_t* buffer, size_t size);
+
+/**
+ * Panik yolu: kesmeleri kapatır, halkalarda bekleyen çıktıyı ve buffer'ı doğrudan UART'a yazar.
+ * Bu çağrıdan sonra tüm konsol yazmaları eşzamanlıdır. buffer NULL ise yalnızca halkalar boşaltılır.
+ * Mimarilerin panik işleyicileri bunu ilk iş olarak çağırır.
+ */
+void karnal_console_emergency_write(const uint8_t* buffer, size_t size);
+
+/**
+ * Halkalar UART'a tamamen yazılana kadar bekler (kapanış veya yeniden başlatma öncesi).
+ */
+void karnal_console_flush(void);
+
+
+// --- Çekirdek İzleme (karnal://trace) ---
+// `ktrace` özelliğiyle derlenen çekirdekler "karnal://trace" kaynağını kaydeder. Kaynaktan okuma, CPU
+// başına halkalarda bekleyen KarnalTraceRecord_t kayıtlarını tüketir (ofset yok sayılır; tampon en az
+// bir kayıt almalıdır). Hangi olayların kaydedileceği çalışma anında kontrol komutlarıyla seçilir.
+
+// Olay türleri (KarnalTraceRecord_t.kind)
+#define KARNAL_TRACE_SYSCALL_ENTER 1 // arg0: çağrı numarası, arg1: ilk argüman
+#define KARNAL_TRACE_SYSCALL_EXIT  2 // arg0: çağrı numarası, arg1: sonuç
+#define KARNAL_TRACE_SWITCH        3 // arg0: önceki iş parçacığı yuvası, arg1: sonraki
+#define KARNAL_TRACE_PAGE_FAULT    4 // arg0: hata adresi, arg1: mimariye özel hata kodu
+#define KARNAL_TRACE_IRQ_ENTER     5 // arg0: kesme numarası
+#define KARNAL_TRACE_IRQ_EXIT      6 // arg0: kesme numarası
+
+// Olay maskesi: bit 0 sistem çağrısı histogramları, bit (1 << tür) ilgili olay. Varsayılan yalnızca histogram.
+#define KARNAL_TRACE_MASK_HISTOGRAM (1ull << 0)
+#define KARNAL_TRACE_MASK(kind)     (1ull << (kind))
+
+// karnal_resource_control istekleri
+#define KARNAL_TRACE_CTL_SET_MASK         1 // arg: yeni maske; önceki maskeyi döner
+#define KARNAL_TRACE_CTL_GET_MASK         2
+#define KARNAL_TRACE_CTL_RESET_HISTOGRAMS 3
+
+typedef struct KarnalTraceRecord {
+    uint64_t timestamp_ns; // Monoton zaman
+    uint16_t kind;         // KARNAL_TRACE_*
+    uint16_t cpu;
+    uint32_t thread;       // İş parçacığı yuvası; boşta/önyükleme bağlamında 0xFFFFFFFF
+    uint64_t arg0;
+    uint64_t arg1;
+} KarnalTraceRecord_t;
+
+/**
+ * Mimari kodun veya sürücülerin çalışan CPU'nun izleme halkasına olay eklemesi için. Olay türü maskede
+ * kapalıysa (veya çekirdek ktrace olmadan derlendiyse) hiçbir şey yapmaz. Kesme bağlamından çağrılabilir.
+ * kind 1-63 olmalıdır; 0 (histogram biti) ve 64 ve üstü yok sayılır.
+ */
+void karnal_trace_event(uint16_t kind, uint64_t arg0, uint64_t arg1);
+
+
+// --- Mikro Ölçüm Takımı (kbench) ---
+// `kbench` özelliğiyle derlenen çekirdekler sıcak yolları mimarinin sayacıyla (amd64 TSC, armv9 CNTVCT,
+// rv64g cycle CSR) ölçer ve yüzdelikleri karnal://device/console'a "KBENCH 1" ile başlayan satırlarda
+// anahtar=değer olarak yazar (biçim: srcbench.rs). Kullanıcı alanı ölçümleri aynı biçimi kullanmalıdır.
+
+// Ölçüm seçimi (srcbench.rs kbench::BENCH_* ile EŞLEŞMELİDİR)
+#define KARNAL_BENCH_SYSCALL   (1u << 0) // Sistem çağrısı dağıtımı (tuzak girişi hariç)
+#define KARNAL_BENCH_MESSAGING (1u << 1) // karnal_messaging_send/receive gidiş-dönüşü
+#define KARNAL_BENCH_LOCK      (1u << 2) // karnal_sync_lock_*: çekişmesiz ve iki CPU çekişmeli
+#define KARNAL_BENCH_FRAME     (1u << 3) // kmem_phys_alloc_frame / kmem_phys_free_frame
+#define KARNAL_BENCH_MAP       (1u << 4) // kmem_virt_map_page + kmem_virt_unmap_page
+#define KARNAL_BENCH_SWITCH    (1u << 5) // Aynı CPU'da iki iş parçacığı arasında bağlam değişimi
+#define KARNAL_BENCH_ALL       0x3Fu
+
+/**
+ * Seçilen ölçümleri çalışan iş parçacığında çalıştırır; süresince iş parçacığı bulunduğu CPU'ya sabitlenir.
+ * Zamanlayıcı başladıktan sonra çağrılmalıdır. Aynı anda tek takım çalışır. Yalnızca çekirdek görevi ve
+ * çekirdek bağlamından açılan görevler (init) çalıştırabilir.
+ * @param mask KARNAL_BENCH_* bayrakları.
+ * @return Başarı durumunda 0; kbench olmadan derlenmişse KERROR_NOT_SUPPORTED, çağıran görev ayrıcalıklı
+ *         değilse KERROR_PERMISSION_DENIED, başka takım çalışıyorsa KERROR_BUSY, diğer hatalarda negatif
+ *         kerror_t döner.
+ */
+int64_t karnal_bench_run(uint32_t mask);
+
+
+// --- Güç Yönetimi: Pil Durumu ve Frekans/Boşta Seçimi ---
+// "karnal://power/battery" pil durumunu önbellekten verir; donanım yalnızca yakıt göstergesi sürücüsü
+// karnal_battery_publish çağırdığında okunur. Blok KARNAL_MAP_READ ile haritalanıp sistem çağrısı
+// yapmadan okunabilir (seq tekse veya okuma boyunca değiştiyse yeniden okunur), karnal_resource_read ile
+// kopyalanabilir veya KARNAL_BATTERY_CTL_SUBSCRIBE ile değişiklikler bir mesaj kanalına alınabilir.
+
+// Pil durumu (srcbatterystate.rs kbattery::STATUS_* ile EŞLEŞMELİDİR)
+#define KARNAL_BATTERY_STATUS_UNKNOWN      0u // Henüz yayın yok
+#define KARNAL_BATTERY_STATUS_CHARGING     1u
+#define KARNAL_BATTERY_STATUS_DISCHARGING  2u
+#define KARNAL_BATTERY_STATUS_FULL         3u
+#define KARNAL_BATTERY_STATUS_NOT_CHARGING 4u
+
+// KarnalBatteryEvent_t.changed bitleri
+#define KARNAL_BATTERY_CHANGED_STATUS       (1u << 0)
+#define KARNAL_BATTERY_CHANGED_CHARGE_LEVEL (1u << 1)
+#define KARNAL_BATTERY_CHANGED_HEALTH       (1u << 2)
+
+// karnal_resource_control istekleri (arg: mesaj kanalı handle'ı)
+#define KARNAL_BATTERY_CTL_SUBSCRIBE   1u
+#define KARNAL_BATTERY_CTL_UNSUBSCRIBE 2u
+
+/// "karnal://power/battery" bloğu (ofset 0; okuma en az sizeof kadar tampon ister)
+typedef struct {
+    volatile uint32_t seq;  // Yazım sırasında tek
+    uint32_t status;        // KARNAL_BATTERY_STATUS_*
+    uint32_t charge_level;  // Yüzde (0-100)
+    uint32_t health;        // Yüzde (0-100), tasarım kapasitesine göre
+    uint64_t updated_ns;    // Son yayının monoton zamanı
+} KarnalBatteryState_t;
+
+/// Abonelere gönderilen mesaj. Olay düşürülebilir; güncel değer her zaman bloktadır.
+typedef struct {
+    uint32_t changed;       // KARNAL_BATTERY_CHANGED_* bitleri
+    uint32_t status;
+    uint32_t charge_level;
+    uint32_t health;
+    uint64_t updated_ns;
+} KarnalBatteryEvent_t;
+
+/**
+ * Yakıt göstergesi sürücüsü için: yeni ölçümü bloğa yazar ve değiştiyse abonelere bildirir.
+ * Bildirim engellemeden gönderilir; kesmenin alt yarısından (kirq iş parçacığı) çağrılmalıdır.
+ * @return Başarı durumunda 0; geçersiz değerde KERROR_INVALID_ARGUMENT, blok yoksa KERROR_NOT_SUPPORTED.
+ */
+int64_t karnal_battery_publish(uint32_t status, uint32_t charge_level, uint32_t health);
+
+/// Mimari kodun kaydettiği derin boşta durumu (hlt/wfi dışında). Sığdan derine sıralı verilir.
+typedef struct {
+    uint32_t id;                  // low_level_cpu_idle_enter'a geçilen mimari numara
+    uint32_t reserved;
+    uint64_t exit_latency_ns;     // Uyanma gecikmesi
+    uint64_t target_residency_ns; // Girişin enerji kazandırdığı en kısa boşta süresi
+} KarnalIdleState_t;
+
+/**
+ * Boşta iş parçacığının seçebileceği durumları kaydeder (en fazla 8); önceki tabloyu değiştirir.
+ * Boşta CPU tahmin edilen boşta süresine sığan ve gecikme sınırını aşmayan en derin durumu seçer.
+ * @return Başarı durumunda 0; 8'den fazla durumda KERROR_INVALID_ARGUMENT.
+ */
+int64_t karnal_power_register_idle_states(const KarnalIdleState_t* states, size_t count);
+
+/// Kabul edilen en büyük boşta çıkış gecikmesi (ns, gerçek zamanlı iş yükleri için). UINT64_MAX: sınırsız.
+void karnal_power_set_latency_limit(uint64_t latency_ns);
+
 
 // TODO: Diğer yöneticiler için kayıt/etkileşim fonksiyonları
 // Örneğin, yeni bellek alanı türü kaydetme, yeni IPC mekanizması kaydetme vb.
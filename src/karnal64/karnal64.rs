@@ -35,6 +35,8 @@ pub enum KError {
     NotSupported = -38,
     /// Mesajlaşma için: Mesaj yok (non-blocking receive)
     NoMessage = -61,
+    /// İşlem zaman aşımına uğradı (süreli bekleme doldu)
+    TimedOut = -110,
     /// Dahili çekirdek hatası (normalde olmamalı)
     InternalError = -255,
     // İhtiyaç duyuldukça diğer çekirdek içi hata türleri eklenebilir
@@ -61,6 +63,23 @@ pub struct KThreadId(u64);
 #[repr(transparent)] // Şimdilik sadece u64'ü sarmalıyor gibi duralım
 pub struct KHandle(u64);
 
+/// Vektörel (scatter/gather) G/Ç segmenti. C tarafındaki `KarnalIoVec_t` ile aynı bellek düzenine sahiptir.
+/// `base` kullanıcı alanındaki bir tamponu gösterebilir; sistem çağrısı yolu diziyi kopyalayıp segmentleri
+/// provider'a vermeden önce doğrular (validate_iov).
+#[derive(Debug, Copy, Clone)]
+#[repr(C)]
+pub struct KIoVec {
+    pub base: *mut u8,
+    pub len: usize,
+    pub offset: u64,
+}
+
+/// Tek bir vektörel çağrıda kabul edilen en fazla segment sayısı (`KARNAL_IOV_MAX`).
+pub const KIOV_MAX: usize = 1024;
+
+/// karnal_resource_acquire'ın kabul ettiği en uzun kaynak ID'si (byte).
+pub const MAX_RESOURCE_ID_LEN: usize = 256;
+
 
 // --- Çekirdek Bileşenlerinin Implemente Edeceği Traitler (Karnal64 Arayüzü) ---
 // Bu traitler, farklı çekirdek modüllerinin (sürücüler, dosya sistemleri, IPC mekanizmaları vb.)
@@ -89,11 +108,105 @@ pub trait ResourceProvider {
     /// Komuta özel bir sonuç değeri veya KError döner.
     fn control(&self, request: u64, arg: u64) -> Result<i64, KError>;
 
-    // İhtiyaca göre başka kaynak işlemleri eklenebilir (seek, stat, mmap_frame vb.)
+    /// Kaynaktan birden çok segmente okur (scatter).
+    /// Varsayılan implementasyon segmentler üzerinde `read` çağırır; toplu okumayı
+    /// daha verimli yapabilen provider'lar bunu override edebilir.
+    fn readv(&self, iov: &[KIoVec]) -> Result<usize, KError> {
+        transfer_segments(iov, |seg| {
+            let buffer = unsafe { core::slice::from_raw_parts_mut(seg.base, seg.len) };
+            self.read(buffer, seg.offset)
+        })
+    }
+
+    /// Birden çok segmentteki veriyi kaynağa yazar (gather).
+    /// Varsayılan implementasyon segmentler üzerinde `write` çağırır.
+    fn writev(&self, iov: &[KIoVec]) -> Result<usize, KError> {
+        transfer_segments(iov, |seg| {
+            let buffer = unsafe { core::slice::from_raw_parts(seg.base as *const u8, seg.len) };
+            self.write(buffer, seg.offset)
+        })
+    }
+
+    /// Kaynağın `offset`'teki sayfasını tutan fiziksel frame'i döner (kopyalamadan eşleme).
+    /// `offset` sayfa hizalıdır. Frame, kaynak kayıtlı kaldıkça geçerli kalmalıdır.
+    /// - Pager (imaj sayfaları) `writable = false` ile çağırır; frame içeriği değişmemelidir.
+    /// - `karnal_resource_map` (srcresmap.rs) frame'i görevin adres alanına doğrudan verir; yazılabilir
+    ///   haritalama istenmiyorsa provider `writable = true`'yu PermissionDenied ile reddetmelidir.
+    /// Varsayılan implementasyon desteklemez; pager sayfayı `read` ile kendi frame'ine okur.
+    fn mmap_frame(&self, offset: u64, writable: bool) -> Result<u64, KError> {
+        let _ = (offset, writable);
+        Err(KError::NotSupported)
+    }
+
+    /// Provider bir senkron çağrı/yanıt uç noktasıysa (srcipc.rs) uç noktanın indeksini döner;
+    /// kmessaging uç nokta handle'larını bununla çözer. Diğer provider'lar varsayılanı kullanır.
+    fn ipc_endpoint(&self) -> Option<usize> {
+        None
+    }
+
+    /// Provider bir kilit, rwlock veya koşul değişkeniyse (srcmutex.rs) türünü (kmutex::SYNC_*) ve tablo
+    /// indeksini döner; karnal_sync_* handle'ları bununla çözer. Diğer provider'lar varsayılanı kullanır.
+    fn sync_object(&self) -> Option<(u32, usize)> {
+        None
+    }
+
+    // İhtiyaca göre başka kaynak işlemleri eklenebilir (seek, stat vb.)
      fn seek(&self, position: KseekFrom) -> Result<u64, KError>;
      fn get_status(&self) -> Result<KResourceStatus, KError>;
 }
 
+/// Segmentleri sırayla `op` ile aktarır ve toplam byte sayısını döner.
+/// Kısa aktarımda durur. İlk segmentte hata olursa hata, sonrakilerde hata olursa
+/// o ana kadar aktarılan byte sayısı döner (kısmi başarı).
+fn transfer_segments<F>(iov: &[KIoVec], mut op: F) -> Result<usize, KError>
+where
+    F: FnMut(&KIoVec) -> Result<usize, KError>,
+{
+    let mut total: usize = 0;
+    for seg in iov {
+        if seg.len == 0 {
+            continue;
+        }
+        match op(seg) {
+            Ok(n) => {
+                total += n;
+                if n < seg.len {
+                    break; // Kısa aktarım: sonraki segmentlere geçilmez
+                }
+            }
+            Err(err) if total == 0 => return Err(err),
+            Err(_) => break,
+        }
+    }
+    Ok(total)
+}
+
+/// Kullanıcıdan gelen segment dizisini çekirdek tamponuna kopyalar ve her segmenti çalışan görevin adres
+/// alanına göre doğrular (`write`: provider segmentlere yazacak, readv). Doğrulanan kopya provider'a verilir:
+/// görev diziyi kontrolden sonra değiştirse de provider'ın gördüğü base/len değişmez.
+fn validate_iov(iov_ptr: *const KIoVec, iov_count: usize, write: bool) -> Result<alloc::vec::Vec<KIoVec>, KError> {
+    if iov_ptr.is_null() && iov_count > 0 {
+        return Err(KError::InvalidArgument);
+    }
+    if iov_count > KIOV_MAX {
+        return Err(KError::InvalidArgument);
+    }
+    let mut iov = alloc::vec::Vec::new();
+    if iov_count == 0 {
+        return Ok(iov);
+    }
+    iov.try_reserve_exact(iov_count).map_err(|_| KError::OutOfMemory)?;
+    iov.resize(iov_count, KIoVec { base: core::ptr::null_mut(), len: 0, offset: 0 });
+    let bytes = unsafe {
+        core::slice::from_raw_parts_mut(iov.as_mut_ptr() as *mut u8, iov_count * core::mem::size_of::<KIoVec>())
+    };
+    kmemory::copy_from_user(bytes, iov_ptr as u64)?;
+    for seg in iov.iter() {
+        kmemory::validate_user_range(seg.base as u64, seg.len, write)?;
+    }
+    Ok(iov)
+}
+
 /// Kilitleme (Lock) mekanizmaları sağlayan çekirdek bileşenlerinin implemente edeceği trait.
 pub trait LockProvider {
     /// Kilidi almaya çalışır. Başka bir iş parçacığı/görev tutuyorsa bloklar.
@@ -114,7 +227,43 @@ pub trait LockProvider {
 // Kullanıcı alanından gelen ham argümanları alırlar, doğrulama yaparlar (pointerlar için),
 // Karnal64'ün dahili yöneticileriyle etkileşime girerler ve sonuçları (veya KError) dönerler.
 
-/// Karnal64 çekirdek API'sını başlatır. Çekirdek boot sürecinin başlarında çağrılır.
+// --- Başlatma Grafiği (bkz. srcboot.rs) ---
+// Dizinler INIT_STEPS'teki sıradır; bir adım yalnızca kendisinden önceki adımlara bağımlı olabilir.
+// Bağımlılığı olmayan adımlar açılan CPU'larda aynı anda çalışabilir.
+const STEP_RESOURCE: usize = 0;
+const STEP_MEMORY: usize = 1;
+const STEP_TASK: usize = 2;
+const STEP_SYNC: usize = 3;
+const STEP_MESSAGING: usize = 4;
+const STEP_RING: usize = 5;
+const STEP_TIMEPAGE: usize = 6;
+const STEP_IRQ: usize = 7;
+const STEP_CONSOLE: usize = 8;
+const STEP_TRACE: usize = 9;
+const STEP_CONSOLE_PROVIDER: usize = 10;
+const STEP_BATTERY: usize = 11;
+const STEP_DVFS: usize = 12;
+
+static INIT_STEPS: [kboot::Step; 13] = [
+    kboot::Step { name: "resource", deps: &[], run: kresource::init_manager },
+    kboot::Step { name: "memory", deps: &[], run: kmemory::init_manager },
+    kboot::Step { name: "task", deps: &[STEP_MEMORY], run: ktask::init_manager },
+    kboot::Step { name: "sync", deps: &[], run: ksync::init_manager },
+    kboot::Step { name: "messaging", deps: &[STEP_TASK], run: kmessaging::init_manager },
+    kboot::Step { name: "ring", deps: &[STEP_MEMORY, STEP_SYNC], run: kring::init_manager },
+    kboot::Step { name: "timepage", deps: &[STEP_MEMORY], run: ktimepage::init_manager },
+    kboot::Step { name: "irq", deps: &[], run: kirq::init_manager },
+    // Konsol TX kesmesini kirq ile kaydeder
+    kboot::Step { name: "console", deps: &[STEP_IRQ], run: kconsole::init_manager },
+    // karnal://trace ertelenir (register_lazy kayıt defterine bakar); provider ilk edinmede kaydedilir
+    kboot::Step { name: "trace", deps: &[STEP_RESOURCE], run: ktrace::init_manager },
+    kboot::Step { name: "console-provider", deps: &[STEP_RESOURCE], run: register_console },
+    kboot::Step { name: "battery", deps: &[STEP_RESOURCE, STEP_MEMORY], run: kbattery::init_manager },
+    kboot::Step { name: "dvfs", deps: &[STEP_BATTERY], run: kdvfs::init_manager },
+];
+
+/// Karnal64 çekirdek API'sını başlatır. Çekirdek boot sürecinin başlarında, yığın (heap) hazır olduktan
+/// sonra çağrılır. İkincil CPU'ları açar; alt sistemler bunlarla birlikte paralel başlatılır.
 pub fn init() {
     // TODO: Karnal64'ün iç veri yapılarını başlat:
     // - Kaynak Kayıt Yöneticisi (Resource Registry)
@@ -124,16 +273,23 @@ pub fn init() {
     // - Senkronizasyon Primitifleri Yöneticisi (Sync Primitives Manager)
     // - Mesajlaşma Yöneticisi (Messaging Manager)
 
-    kresource::init_manager();
-    ktask::init_manager();
-    kmemory::init_manager();
-    ksync::init_manager();
-    kmessaging::init_manager();
+    kboot::run(&INIT_STEPS).expect("Invalid init graph");
 
-    // TODO: Temel çekirdek kaynaklarını (konsol, null cihaz, boot diski, vb.)
-    //       ResourceProvider traitini implemente ederek Kaynak Kayıt Yöneticisine kaydet.
-    // Örnek: Dummy konsol kaynağını kaydetme (ResourceProvider trait implementasyonunu ve kayıt mekanizmasını gerektirir)
-     let console_provider = Box::new(kresource::implementations::DummyConsole); // 'alloc' veya statik yönetim gerekir
+    // CPU başına kurulum grafik dışında kalır (ikincil CPU'lar karnal_secondary_start'ta yapar)
+    ksyscall::init_manager();
+}
+
+#[no_mangle]
+pub extern "C" fn karnal_init() {
+    init();
+}
+
+// TODO: Temel çekirdek kaynaklarını (konsol, null cihaz, boot diski, vb.)
+//       ResourceProvider traitini implemente ederek Kaynak Kayıt Yöneticisine kaydet.
+// Açılışta gerekmeyenler kboot::register_lazy ile ertelenmelidir.
+// Örnek: Dummy konsol kaynağını kaydetme (ResourceProvider trait implementasyonunu ve kayıt mekanizmasını gerektirir)
+fn register_console() {
+     let console_provider = alloc::sync::Arc::new(kresource::implementations::DummyConsole); // 'alloc' veya statik yönetim gerekir
      kresource::register_provider("karnal://device/console", console_provider).expect("Failed to register console");
 }
 
@@ -143,39 +299,31 @@ pub fn init() {
 /// `resource_id_len`: Kaynak ID'sinin uzunluğu.
 /// `mode`: Talep edilen erişim modları bayrakları (ResourceProvider'ın anlayacağı formatta).
 /// Başarı durumunda bir KHandle, hata durumunda KError döner.
-/// Güvenlik Notu: Kullanıcı pointer'ları (resource_id_ptr gibi) sistem çağrısı işleyicide
-/// veya bu fonksiyonun başında çok dikkatli bir şekilde doğrulanmalıdır (kullanıcının
-/// adres alanında geçerli ve erişilebilir mi?).
+/// ID çekirdek tamponuna kopyalanarak okunur (en fazla MAX_RESOURCE_ID_LEN byte); erişilemeyen adreste BadAddress.
 pub fn resource_acquire(resource_id_ptr: *const u8, resource_id_len: usize, mode: u32) -> Result<KHandle, KError> {
-    // TODO: resource_id_ptr ve resource_id_len doğrulaması yap.
-    if resource_id_ptr.is_null() && resource_id_len > 0 {
+    if (resource_id_ptr.is_null() && resource_id_len > 0) || resource_id_len > MAX_RESOURCE_ID_LEN {
         return Err(KError::InvalidArgument);
     }
     // TODO: mode bayraklarını doğrula.
 
-    let id_slice = unsafe {
-        // Güvenlik: resource_id_ptr ve resource_id_len'in geçerli kullanıcı alanı pointer'ları
-        // olduğu varsayılır (veya bu satırdan önce doğrulanır).
-        core::slice::from_raw_parts(resource_id_ptr, resource_id_len)
-    };
+    // Kopya: kullanıcı ID'yi arama sırasında değiştiremez
+    let mut id_buf = [0u8; MAX_RESOURCE_ID_LEN];
+    let id_slice = &mut id_buf[..resource_id_len];
+    kmemory::copy_from_user(id_slice, resource_id_ptr as u64)?;
 
     // Kaynak ID slice'ını çekirdek içindeki bir ResourceProvider'a eşle.
     // Bu, Kaynak Kayıt Yöneticisi aracılığıyla yapılır.
     let resource_name = core::str::from_utf8(id_slice).map_err(|_| KError::InvalidArgument)?; // ID'nin UTF8 isim olduğunu varsayalım
 
-    // TODO: Kaynak Kayıt Yöneticisinde `resource_name` ile ResourceProvider'ı ara.
+    // Kaynak Kayıt Yöneticisinde `resource_name` ile ResourceProvider'ı ara (kilitsiz, bkz. srcregistry.rs).
      let provider = kresource::lookup_provider_by_name(resource_name)?;
 
     // TODO: Talep edilen `mode`'un, bulunan `provider` tarafından desteklenip desteklenmediğini kontrol et.
      if !provider.supports_mode(mode) { return Err(KError::PermissionDenied); }
 
-    // TODO: Provider için yeni bir çekirdek Handle'ı (KHandle) oluştur ve yöneticiye kaydet.
-    // Handle Yöneticisi, kullanıcıya verilen ham u64 değerini, çekirdek içindeki bu provider instance'ına eşler.
-     let k_handle = kresource::issue_handle(provider, mode);
-
-    // Yer Tutucu: Dummy bir handle ve başarı döndür
-    let dummy_handle_value = 123; // Bu değer Handle Yöneticisinden gelmeli
-    Ok(KHandle(dummy_handle_value))
+    // Provider için mevcut görevin handle tablosunda yeni bir handle aç (bkz. srchandle.rs).
+    // Handle değeri yuva indeksi ve nesli taşır; izinler ve ofset yuvada tutulur.
+    kresource::issue_handle(provider, mode)
 }
 
 /// Kullanıcı alanından gelen bir kaynak okuma (read) isteğini işler.
@@ -183,10 +331,8 @@ pub fn resource_acquire(resource_id_ptr: *const u8, resource_id_len: usize, mode
 /// `user_buffer_ptr`: Kullanıcı alanındaki okuma tamponu pointer'ı.
 /// `user_buffer_len`: Kullanıcı tamponunun uzunluğu.
 /// Başarı durumunda okunan byte sayısını, hata durumunda KError döner.
-/// Güvenlik Notu: `user_buffer_ptr` ve `user_buffer_len` çok dikkatli doğrulanmalıdır
-/// (geçerli kullanıcı alanı adresini gösteriyor mu? Yazılabilir mi? sınırlar içinde mi?).
+/// Tampon çalışan görevin adres alanında yazılabilir olmalıdır; değilse BadAddress.
 pub fn resource_read(k_handle_value: u64, user_buffer_ptr: *mut u8, user_buffer_len: usize) -> Result<usize, KError> {
-    // TODO: user_buffer_ptr ve user_buffer_len doğrulaması yap.
     if user_buffer_ptr.is_null() && user_buffer_len > 0 {
         return Err(KError::InvalidArgument);
     }
@@ -194,40 +340,18 @@ pub fn resource_read(k_handle_value: u64, user_buffer_ptr: *mut u8, user_buffer_
         return Ok(0); // Sıfır byte okumak geçerli
     }
 
-    // TODO: Ham handle değerini (k_handle_value) kullanarak Handle Yöneticisinden ilgili KHandle'ı ve ResourceProvider'ı çöz.
-    // let k_handle = KHandle(k_handle_value);
-     let provider = kresource::get_provider_by_handle(&k_handle)?;
-
-    // TODO: Handle'ın okuma iznine sahip olup olmadığını kontrol et.
-     if !kresource::handle_has_permission(&k_handle, kresource::MODE_READ) { return Err(KError::PermissionDenied); }
+    // Handle'ı çöz ve okuma iznini kontrol et: tek sınır kontrolü ve nesil karşılaştırması.
+    let handle = kresource::get_handle(k_handle_value, kresource::MODE_READ)?;
 
-    // Çekirdek içinde, kullanıcı tamponuna doğrudan erişecek bir slice oluştur.
-    // Bu, kullanıcı belleğine erişimin çekirdek tarafından yönetildiğini varsayar.
-    let user_buffer_slice = unsafe {
-        // Güvenlik: user_buffer_ptr ve user_buffer_len'in geçerli kullanıcı alanı adreslerini gösterdiği ve yazılabilir olduğu varsayılır (veya doğrulanır).
-        core::slice::from_raw_parts_mut(user_buffer_ptr, user_buffer_len)
-    };
+    // Sayfalar kurulduktan sonra provider kullanıcı tamponuna doğrudan yazabilir (bkz. validate_user_range).
+    kmemory::validate_user_range(user_buffer_ptr as u64, user_buffer_len, true)?;
+    let user_buffer_slice = unsafe { core::slice::from_raw_parts_mut(user_buffer_ptr, user_buffer_len) };
 
-    // TODO: ResourceProvider'ın `read` metodunu çağır.
-    // provider.read metodu çekirdek içi bir tampona okuma yapabilir,
-    // sonra bu tampon kullanıcı tamponuna kopyalanır VEYA,
-    // provider.read doğrudan kullanıcı tamponuna yazmak için user_buffer_slice'ı alabilir.
-    // İkinci yaklaşım daha direkt, ancak provider'ın kullanıcı belleğiyle etkileşimine dikkat etmek gerekir.
-    // Örnek olarak provider'ın doğrudan slice aldığını varsayalım:
-     let bytes_read = provider.read(user_buffer_slice, handle_current_offset)?; // Handle'ın güncel ofset bilgisi gerekiyorsa
-
-    // Yer Tutucu: Okuma işlemini simüle et
-    let simulated_read_bytes = core::cmp::min(user_buffer_len, 5); // 5 byte okuma simülasyonu
-    if simulated_read_bytes > 0 {
-        unsafe {
-            // Simüle edilmiş veri yaz (örn. 'K' harfi)
-            core::ptr::write_bytes(user_buffer_ptr, b'K', simulated_read_bytes);
-        }
-    }
-    let bytes_read = simulated_read_bytes;
+    // Provider doğrudan kullanıcı tamponuna okur; provider'ın kullanıcı belleğiyle etkileşimine dikkat etmek gerekir.
+    let bytes_read = handle.provider().read(user_buffer_slice, handle.offset())?;
 
-    // TODO: Handle'ın güncel ofsetini güncelle (kaynak seekable ise).
-     kresource::update_handle_offset(&k_handle, bytes_read);
+    // Handle'ın güncel ofsetini ilerlet (kaynak seekable değilse provider ofseti yok sayar).
+    handle.advance(bytes_read);
 
     Ok(bytes_read) // Başarı
 }
@@ -237,10 +361,8 @@ pub fn resource_read(k_handle_value: u64, user_buffer_ptr: *mut u8, user_buffer_
 /// `user_buffer_ptr`: Kullanıcı alanındaki yazma tamponu pointer'ı.
 /// `user_buffer_len`: Kullanıcı tamponunun uzunluğu.
 /// Başarı durumunda yazılan byte sayısını, hata durumunda KError döner.
-/// Güvenlik Notu: `user_buffer_ptr` ve `user_buffer_len` çok dikkatli doğrulanmalıdır
-/// (geçerli kullanıcı alanı adresini gösteriyor mu? Okunabilir mi? sınırlar içinde mi?).
+/// Tampon çalışan görevin adres alanında okunabilir olmalıdır; değilse BadAddress.
 pub fn resource_write(k_handle_value: u64, user_buffer_ptr: *const u8, user_buffer_len: usize) -> Result<usize, KError> {
-     // TODO: user_buffer_ptr ve user_buffer_len doğrulaması yap.
      if user_buffer_ptr.is_null() && user_buffer_len > 0 {
         return Err(KError::InvalidArgument);
     }
@@ -248,53 +370,130 @@ pub fn resource_write(k_handle_value: u64, user_buffer_ptr: *const u8, user_buff
         return Ok(0); // Sıfır byte yazmak geçerli
     }
 
-    // TODO: Ham handle değerini kullanarak KHandle'ı ve ResourceProvider'ı çöz.
-     let k_handle = KHandle(k_handle_value);
-     let provider = kresource::get_provider_by_handle(&k_handle)?;
+    // Handle'ı çöz ve yazma iznini kontrol et.
+    let handle = kresource::get_handle(k_handle_value, kresource::MODE_WRITE)?;
 
-    // TODO: Handle'ın yazma iznine sahip olup olmadığını kontrol et.
-     if !kresource::handle_has_permission(&k_handle, kresource::MODE_WRITE) { return Err(KError::PermissionDenied); }
+    kmemory::validate_user_range(user_buffer_ptr as u64, user_buffer_len, false)?;
+    let user_buffer_slice = unsafe { core::slice::from_raw_parts(user_buffer_ptr, user_buffer_len) };
 
-    let user_buffer_slice = unsafe {
-        // Güvenlik: user_buffer_ptr ve user_buffer_len'in geçerli kullanıcı alanı adreslerini gösterdiği ve okunabilir olduğu varsayılır (veya doğrulanır).
-        core::slice::from_raw_parts(user_buffer_ptr, user_buffer_len)
-    };
-
-    // TODO: ResourceProvider'ın `write` metodunu çağır.
     // provider.write metodu, kullanıcı tamponundaki veriyi alır ve kaynağa yazar.
-     let bytes_written = provider.write(user_buffer_slice, handle_current_offset)?; // Ofset bilgisi gerekiyorsa
+    let bytes_written = handle.provider().write(user_buffer_slice, handle.offset())?;
 
-    // Yer Tutucu: Yazma işlemini simüle et
-    let simulated_write_bytes = core::cmp::min(user_buffer_len, 5); // 5 byte yazma simülasyonu
-    // Gerçek senaryoda user_buffer_slice içeriği kullanılacaktır.
-    let bytes_written = simulated_write_bytes;
-
-    // TODO: Handle'ın güncel ofsetini güncelle.
-     kresource::update_handle_offset(&k_handle, bytes_written);
+    handle.advance(bytes_written);
 
     Ok(bytes_written) // Başarı
 }
 
+/// Belirli bir ofsetten okur (pread); handle'ın ofseti değişmez. Asenkron halka KARNAL_OP_RESOURCE_READ
+/// için kullanır (bkz. srcring.rs). Dönüş ve doğrulama resource_read ile aynıdır.
+pub fn resource_read_at(k_handle_value: u64, user_buffer_ptr: *mut u8, user_buffer_len: usize, offset: u64) -> Result<usize, KError> {
+    if user_buffer_ptr.is_null() && user_buffer_len > 0 {
+        return Err(KError::InvalidArgument);
+    }
+    if user_buffer_len == 0 {
+        return Ok(0);
+    }
+    let handle = kresource::get_handle(k_handle_value, kresource::MODE_READ)?;
+    kmemory::validate_user_range(user_buffer_ptr as u64, user_buffer_len, true)?;
+    let user_buffer_slice = unsafe { core::slice::from_raw_parts_mut(user_buffer_ptr, user_buffer_len) };
+    handle.provider().read(user_buffer_slice, offset)
+}
+
+/// Belirli bir ofsete yazar (pwrite); handle'ın ofseti değişmez.
+pub fn resource_write_at(k_handle_value: u64, user_buffer_ptr: *const u8, user_buffer_len: usize, offset: u64) -> Result<usize, KError> {
+    if user_buffer_ptr.is_null() && user_buffer_len > 0 {
+        return Err(KError::InvalidArgument);
+    }
+    if user_buffer_len == 0 {
+        return Ok(0);
+    }
+    let handle = kresource::get_handle(k_handle_value, kresource::MODE_WRITE)?;
+    kmemory::validate_user_range(user_buffer_ptr as u64, user_buffer_len, false)?;
+    let user_buffer_slice = unsafe { core::slice::from_raw_parts(user_buffer_ptr, user_buffer_len) };
+    handle.provider().write(user_buffer_slice, offset)
+}
+
+/// Kullanıcı alanından gelen vektörel okuma (readv) isteğini işler.
+/// Tüm segmentler tek bir sistem çağrısında doldurulur; böylece çok sayıda küçük okuma
+/// tek bir çekirdek geçişine indirgenir.
+/// Başarı durumunda okunan toplam byte sayısını, hata durumunda KError döner.
+pub fn resource_readv(k_handle_value: u64, iov_ptr: *const KIoVec, iov_count: usize) -> Result<usize, KError> {
+    let iov = validate_iov(iov_ptr, iov_count, true)?;
+    if iov.is_empty() {
+        return Ok(0);
+    }
+
+    // Handle bir kez çözülür ve okuma izni bir kez kontrol edilir; segment ofsetleri çağırandan gelir.
+    let handle = kresource::get_handle(k_handle_value, kresource::MODE_READ)?;
+    let bytes_read = handle.provider().readv(&iov)?;
+
+    Ok(bytes_read)
+}
+
+/// Kullanıcı alanından gelen vektörel yazma (writev) isteğini işler.
+/// Log/telemetri gibi çok sayıda küçük kaydı tek çağrıda boşaltmak için kullanılır.
+/// Başarı durumunda yazılan toplam byte sayısını, hata durumunda KError döner.
+pub fn resource_writev(k_handle_value: u64, iov_ptr: *const KIoVec, iov_count: usize) -> Result<usize, KError> {
+    let iov = validate_iov(iov_ptr, iov_count, false)?;
+    if iov.is_empty() {
+        return Ok(0);
+    }
+
+    let handle = kresource::get_handle(k_handle_value, kresource::MODE_WRITE)?;
+    let bytes_written = handle.provider().writev(&iov)?;
+
+    Ok(bytes_written)
+}
+
+
+/// Mevcut görev için asenkron çağrı halkası kurar (bkz. srcring.rs).
+/// `ring_addr_out`: Haritalanan halka başlığının kullanıcı alanı adresinin yazılacağı pointer.
+/// Başarı durumunda halka handle'ını, hata durumunda KError döner (yazılamayan `ring_addr_out`: BadAddress).
+pub fn ring_setup(entries: u32, flags: u32, ring_addr_out: *mut u64) -> Result<KHandle, KError> {
+    if ring_addr_out.is_null() {
+        return Err(KError::InvalidArgument);
+    }
+    // Halka kurulmadan önce: adres yazılamıyorsa kurulan halkayı geri almak gerekmez
+    kmemory::validate_user_range(ring_addr_out as u64, core::mem::size_of::<u64>(), true)?;
+    let (handle, user_addr) = kring::setup(entries, flags)?;
+    kmemory::copy_to_user(ring_addr_out as u64, &user_addr.to_ne_bytes())?;
+    Ok(handle)
+}
+
+/// Halkadaki bekleyen gönderimleri işler; istenirse tamamlanmaları bekler.
+/// Başarı durumunda işlenen gönderim sayısını, hata durumunda KError döner.
+pub fn ring_enter(ring_handle_value: u64, to_submit: u32, min_complete: u32, flags: u32) -> Result<u32, KError> {
+    kring::enter(ring_handle_value, to_submit, min_complete, flags)
+}
+
+/// Halkayı kaldırır ve kaynaklarını serbest bırakır.
+pub fn ring_destroy(ring_handle_value: u64) -> Result<(), KError> {
+    kring::destroy(ring_handle_value)
+}
+
 
 /// Kullanıcı alanından gelen bir kaynak handle'ını serbest bırakma isteğini işler.
 /// `k_handle_value`: Kullanıcıdan gelen ham handle değeri.
 /// Başarı veya KError döner.
 pub fn resource_release(k_handle_value: u64) -> Result<(), KError> {
-    // TODO: Ham handle değerini kullanarak Handle Yöneticisinden KHandle'ı çöz ve serbest bırak.
-    // Bu, Handle Yöneticisindeki ilgili kaydı geçersiz kılmalı ve gerekiyorsa
-    // alttaki ResourceProvider'a Handle'ın artık kullanılmadığı bilgisini iletmelidir.
-     let k_handle = KHandle(k_handle_value);
-     kresource::release_handle(&k_handle)?;
-
-    // Yer Tutucu: Serbest bırakmayı simüle et
-     if k_handle_value == 0 { // 0'ın geçersiz handle olduğunu varsayalım
-        Err(KError::BadHandle)
-    } else {
-         Ok(()) // Başarı
+    // Handle tablosundaki yuva geçersiz kılınır; provider, handle üzerinde süren işlemler bitince bırakılır.
+    // Kilit, rwlock ve koşul değişkeni handle'ları tutulurken kapatılamaz (Busy, bkz. srcmutex.rs)
+    if kmutex::is_sync_handle(k_handle_value) {
+        return kmutex::sync_destroy(k_handle_value);
     }
+    kresource::release_handle(k_handle_value)?;
+    // Son handle'ı kapanan kod kaynaklarının imaj önbelleğindeki sayfaları bırakılır (bkz. srcpager.rs).
+    // Handle değeri anahtar değildir: aynı değer başka görevlerde başka kaynakları gösterir.
+    kpager::release_dead_images();
+    Ok(())
 }
 
-// TODO: resource_control fonksiyonunu da benzer şekilde ResourceProvider'a dispatch edecek şekilde implemente et.
+/// Kullanıcı alanından gelen bir kaynak kontrol (ioctl benzeri) isteğini provider'a iletir.
+/// Handle'ın herhangi bir erişim izniyle açılmış olması yeterlidir; komut izinlerini provider denetler.
+pub fn resource_control(k_handle_value: u64, request: u64, arg: u64) -> Result<i64, KError> {
+    let handle = kresource::get_handle(k_handle_value, 0)?;
+    handle.provider().control(request, arg)
+}
 
 
 // TODO: memory_allocate, memory_release, shared_mem_create/map/unmap fonksiyonlarını implemente et.
@@ -353,51 +552,514 @@ mod kresource {
     pub const MODE_CREATE: u32 = 1 << 2;
     // TODO: Diğer modlar...
 
-    // TODO: Çekirdek bileşenlerinin ResourceProvider'larını kaydetmesi için fonksiyon:
-     pub fn register_provider(id: &str, provider: Box<dyn ResourceProvider>) -> Result<KHandle, KError> { ... }
+    // Kaynak isim kaydı: RCU ile okunan karma tablosu (srcregistry.rs). Aramalar kilit almaz.
+    pub fn register_provider(id: &str, provider: alloc::sync::Arc<dyn ResourceProvider>) -> Result<KHandle, KError> {
+        kregistry::register(id.as_bytes(), provider)
+    }
+
+    pub fn unregister_provider(id: &str) -> Result<(), KError> {
+        kregistry::unregister(id.as_bytes())
+    }
+
+    // Kayıtlı değilse ertelenmiş provider'lara bakılır; ilk edinme başlatıcıyı çalıştırır (srcboot.rs)
+    pub fn lookup_provider_by_name(id: &str) -> Result<alloc::sync::Arc<dyn ResourceProvider>, KError> {
+        match kregistry::lookup(id.as_bytes()) {
+            Err(KError::NotFound) => {
+                kboot::resolve_lazy(id.as_bytes())?;
+                kregistry::lookup(id.as_bytes())
+            }
+            result => result,
+        }
+    }
 
-    // TODO: Kullanıcı handle değerini çözerek provider'a erişim için fonksiyon:
-     pub fn get_provider_by_handle(handle: u64) -> Result<&'static dyn ResourceProvider, KError> { ... }
+    // Handle yönetimi: görev başına, nesil kontrollü yoğun tablo (srchandle.rs).
+    // get_handle çözme ve izin kontrolünü birlikte yapar; dönen referans provider'ı ve ofseti verir.
+    pub fn issue_handle(provider: alloc::sync::Arc<dyn ResourceProvider>, mode: u32) -> Result<KHandle, KError> {
+        khandle::issue(provider, mode)
+    }
 
-    // TODO: Handle durum yönetimi fonksiyonları:
-     pub fn issue_handle(provider: &dyn ResourceProvider, mode: u32) -> KHandle { ... }
-     pub fn handle_has_permission(handle: &KHandle, mode: u32) -> bool { ... }
-     pub fn release_handle(handle: u64) -> Result<(), KError> { ... }
+    pub fn get_handle(handle: u64, required_mode: u32) -> Result<khandle::HandleRef, KError> {
+        khandle::get(handle, required_mode)
+    }
+
+    pub fn release_handle(handle: u64) -> Result<(), KError> {
+        khandle::close(handle)
+    }
 
     // TODO: Dummy ResourceProvider implementasyonları (test veya çekirdek içi temel kaynaklar için)
+
+    /// C tarafındaki `KarnalResourceProviderC_t` yapısının Rust karşılığı.
+    /// `karnal_resource_register_c_provider` ile gelen yapı bu şekilde okunur.
+    #[repr(C)]
+    pub struct KarnalResourceProviderC {
+        pub read_fn: Option<extern "C" fn(*mut core::ffi::c_void, *mut u8, usize, u64) -> i64>,
+        pub write_fn: Option<extern "C" fn(*mut core::ffi::c_void, *const u8, usize, u64) -> i64>,
+        pub control_fn: Option<extern "C" fn(*mut core::ffi::c_void, u64, u64) -> i64>,
+        pub readv_fn: Option<extern "C" fn(*mut core::ffi::c_void, *const KIoVec, usize) -> i64>,
+        pub writev_fn: Option<extern "C" fn(*mut core::ffi::c_void, *const KIoVec, usize) -> i64>,
+        pub map_fn: Option<extern "C" fn(*mut core::ffi::c_void, u64, u32) -> i64>,
+        pub provider_data: *mut core::ffi::c_void,
+    }
+
+    /// C fonksiyon işaretçilerini ResourceProvider trait'ine sarmalar.
+    pub struct CResourceProvider {
+        pub fns: KarnalResourceProviderC,
+    }
+
+    /// C fonksiyonlarından dönen i64 sonucu (>=0 başarı, <0 KError) Result'a çevirir.
+    fn c_result(ret: i64) -> Result<usize, KError> {
+        if ret >= 0 {
+            Ok(ret as usize)
+        } else {
+            Err(kerror_from_i64(ret))
+        }
+    }
+
+    pub fn kerror_from_i64(code: i64) -> KError {
+        match code {
+            -1 => KError::PermissionDenied,
+            -2 => KError::NotFound,
+            -3 => KError::InvalidArgument,
+            -4 => KError::Interrupted,
+            -9 => KError::BadHandle,
+            -11 => KError::Busy,
+            -12 => KError::OutOfMemory,
+            -14 => KError::BadAddress,
+            -17 => KError::AlreadyExists,
+            -38 => KError::NotSupported,
+            -61 => KError::NoMessage,
+            -110 => KError::TimedOut,
+            _ => KError::InternalError,
+        }
+    }
+
+    /// C modüllerinin provider kaydı. Fonksiyon tablosu kopyalanır; çağıranın yapıyı tutması gerekmez.
+    #[no_mangle]
+    pub extern "C" fn karnal_resource_register_c_provider(id_ptr: *const u8, id_len: usize, provider_c_fns: *const KarnalResourceProviderC) -> i64 {
+        if id_ptr.is_null() || provider_c_fns.is_null() {
+            return KError::InvalidArgument as i64;
+        }
+        let id = unsafe { core::slice::from_raw_parts(id_ptr, id_len) };
+        let fns = unsafe { core::ptr::read(provider_c_fns) };
+        match kregistry::register(id, alloc::sync::Arc::new(CResourceProvider { fns })) {
+            Ok(handle) => handle.0 as i64,
+            Err(err) => err as i64,
+        }
+    }
+
+    /// C modüllerinin provider kaydını siler (sürücü kaldırılırken).
+    #[no_mangle]
+    pub extern "C" fn karnal_resource_unregister_provider(id_ptr: *const u8, id_len: usize) -> i64 {
+        if id_ptr.is_null() {
+            return KError::InvalidArgument as i64;
+        }
+        let id = unsafe { core::slice::from_raw_parts(id_ptr, id_len) };
+        match kregistry::unregister(id) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    impl ResourceProvider for CResourceProvider {
+        fn read(&self, buffer: &mut [u8], offset: u64) -> Result<usize, KError> {
+            let read_fn = self.fns.read_fn.ok_or(KError::NotSupported)?;
+            c_result(read_fn(self.fns.provider_data, buffer.as_mut_ptr(), buffer.len(), offset))
+        }
+
+        fn write(&self, buffer: &[u8], offset: u64) -> Result<usize, KError> {
+            let write_fn = self.fns.write_fn.ok_or(KError::NotSupported)?;
+            c_result(write_fn(self.fns.provider_data, buffer.as_ptr(), buffer.len(), offset))
+        }
+
+        fn control(&self, request: u64, arg: u64) -> Result<i64, KError> {
+            let control_fn = self.fns.control_fn.ok_or(KError::NotSupported)?;
+            let ret = control_fn(self.fns.provider_data, request, arg);
+            if ret >= 0 { Ok(ret) } else { Err(kerror_from_i64(ret)) }
+        }
+
+        fn readv(&self, iov: &[KIoVec]) -> Result<usize, KError> {
+            match self.fns.readv_fn {
+                Some(readv_fn) => c_result(readv_fn(self.fns.provider_data, iov.as_ptr(), iov.len())),
+                // Slot boşsa segmentler üzerinde read_fn ile döngü kurulur.
+                None => transfer_segments(iov, |seg| {
+                    let buffer = unsafe { core::slice::from_raw_parts_mut(seg.base, seg.len) };
+                    self.read(buffer, seg.offset)
+                }),
+            }
+        }
+
+        fn writev(&self, iov: &[KIoVec]) -> Result<usize, KError> {
+            match self.fns.writev_fn {
+                Some(writev_fn) => c_result(writev_fn(self.fns.provider_data, iov.as_ptr(), iov.len())),
+                // Slot boşsa segmentler üzerinde write_fn ile döngü kurulur.
+                None => transfer_segments(iov, |seg| {
+                    let buffer = unsafe { core::slice::from_raw_parts(seg.base as *const u8, seg.len) };
+                    self.write(buffer, seg.offset)
+                }),
+            }
+        }
+
+        fn mmap_frame(&self, offset: u64, writable: bool) -> Result<u64, KError> {
+            let map_fn = self.fns.map_fn.ok_or(KError::NotSupported)?;
+            let prot = if writable { kresmap::MAP_READ | kresmap::MAP_WRITE } else { kresmap::MAP_READ };
+            c_result(map_fn(self.fns.provider_data, offset, prot)).map(|frame| frame as u64)
+        }
+    }
 }
 
 mod ktask {
     use super::*;
-    // TODO: Görev (Task) ve İş Parçacığı (Thread) kontrol blokları, zamanlayıcı kuyrukları, bağlam değiştirme mantığı.
+    // TODO: Görev (Task) kontrol blokları.
+    // İş parçacıkları, çalışma kuyrukları, görev adres alanları ve bağlam değiştirme CPU başına zamanlayıcıdadır (srcsched.rs).
+
+    extern "C" {
+        fn kmem_virt_create_address_space() -> u64;
+        fn kmem_virt_destroy_address_space(address_space_id: u64);
+        fn kmem_virt_fault_in(vaddr: u64, write: u32) -> i64;
+        fn low_level_enter_user(entry: u64, user_sp: u64, arg0: u64, arg1: u64) -> !;
+    }
+
+    const PAGE_SIZE: u64 = 4096;
+    // Kullanıcı yığıtı zaman sayfasının (srctimepage.rs) altında tembel bir sıfır bölgesidir
+    const USER_STACK_TOP: u64 = 0x0000_7EFF_FFF0_0000;
+    const USER_STACK_SIZE: u64 = 1024 * 1024;
+
+    // İlk iş parçacığına bir frame'de verilir; argüman byte'ları başlığın hemen ardındadır
+    #[repr(C)]
+    struct SpawnStart {
+        entry: u64,
+        args_len: u64,
+    }
+
+    /// task_spawn'a verilebilecek en uzun argüman verisi
+    pub const MAX_SPAWN_ARGS: usize = PAGE_SIZE as usize - core::mem::size_of::<SpawnStart>();
 
     pub fn init_manager() {
         // Placeholder başlatma
          println!("Karnal64: Görev Yöneticisi Başlatıldı (Yer Tutucu)");
     }
-    // TODO: task/thread create, exit, schedule, sleep, yield, current_id implementasyonları
+
+    pub fn yield_now() -> Result<(), KError> {
+        ksched::yield_now()
+    }
+
+    pub fn task_sleep(milliseconds: u64) -> Result<(), KError> {
+        ksched::task_sleep(milliseconds)
+    }
+
+    pub fn task_sleep_ns(nanoseconds: u64, slack_ns: u64) -> Result<(), KError> {
+        ksched::task_sleep_ns(nanoseconds, slack_ns)
+    }
+
+    pub fn thread_create(entry_point: u64, stack_size: usize, arg: u64, cpu_mask: u64) -> Result<KThreadId, KError> {
+        ksched::thread_create(entry_point, stack_size, arg, cpu_mask)
+    }
+
+    pub fn thread_exit(code: i32) -> ! {
+        ksched::thread_exit(code)
+    }
+
+    /// Kod kaynağındaki ELF64 imajından yeni bir görev başlatır. Segmentler ve yığıt yeni adres alanına tembel
+    /// bölgeler olarak eklenir (bkz. srcpager.rs); hiçbir sayfa burada okunmaz. Kaynak çağıranın handle
+    /// tablosunda şimdi çözülür ve bölgelerde tutulur: handle sonradan kapansa da görev çalışmaya devam eder.
+    /// Argümanlar görevin yığıtının tepesine kopyalanır ve giriş noktasına (işaretçi, uzunluk) olarak verilir.
+    pub fn task_spawn(code_handle_value: u64, args_ptr: *const u8, args_len: usize) -> Result<KTaskId, KError> {
+        if (args_ptr.is_null() && args_len > 0) || args_len > MAX_SPAWN_ARGS {
+            return Err(KError::InvalidArgument);
+        }
+        kresource::get_handle(code_handle_value, kresource::MODE_READ)?;
+        ksched::reclaim_address_spaces();
+
+        // Argümanlar çağıranın adres alanından şimdi alınır; yeni adres alanına ilk iş parçacığı kopyalar
+        let start = kbuddy::kmem_phys_alloc_frame();
+        if start == 0 {
+            return Err(KError::OutOfMemory);
+        }
+        // Fiziksel bellek kimlik haritalı
+        unsafe { core::ptr::write(start as *mut SpawnStart, SpawnStart { entry: 0, args_len: args_len as u64 }) };
+        let args = unsafe {
+            core::slice::from_raw_parts_mut((start as *mut u8).add(core::mem::size_of::<SpawnStart>()), args_len)
+        };
+        if kmemory::copy_from_user(args, args_ptr as u64).is_err() {
+            kbuddy::kmem_phys_free_frame(start);
+            return Err(KError::BadAddress);
+        }
+
+        let root = unsafe { kmem_virt_create_address_space() };
+        let result = if root == 0 {
+            Err(KError::OutOfMemory)
+        } else {
+            kpager::load_image(root, code_handle_value)
+                .and_then(|entry| {
+                    unsafe { (*(start as *mut SpawnStart)).entry = entry };
+                    let prot = kpager::PROT_USER | kpager::PROT_READ | kpager::PROT_WRITE;
+                    kpager::add_region(root, USER_STACK_TOP - USER_STACK_SIZE, USER_STACK_SIZE, prot, kpager::Backing::Zero)
+                })
+                .and_then(|()| ksched::task_create(root, user_start as usize as u64, start))
+        };
+        match result {
+            Ok((task, _)) => Ok(KTaskId(task as u64)),
+            Err(err) => {
+                if root != 0 {
+                    unsafe { kmem_virt_destroy_address_space(root) };
+                }
+                kbuddy::kmem_phys_free_frame(start);
+                Err(err)
+            }
+        }
+    }
+
+    // Görevin ilk iş parçacığı. Zamanlayıcı görevin adres alanını yükleyerek başlatır; yığıt sayfaları
+    // argümanlar kopyalanmadan önce pager ile kurulur.
+    extern "C" fn user_start(start: u64) {
+        let (entry, len) = unsafe {
+            let header = &*(start as *const SpawnStart);
+            (header.entry, header.args_len)
+        };
+        let args = (USER_STACK_TOP - len) & !15;
+        let mut page = args & !(PAGE_SIZE - 1);
+        while page < USER_STACK_TOP {
+            let err = unsafe { kmem_virt_fault_in(page, 1) };
+            if err != 0 {
+                kbuddy::kmem_phys_free_frame(start);
+                ksched::thread_exit(err as i32);
+            }
+            page += PAGE_SIZE;
+        }
+        unsafe {
+            let src = (start as *const u8).add(core::mem::size_of::<SpawnStart>());
+            core::ptr::copy_nonoverlapping(src, args as *mut u8, len as usize);
+        }
+        kbuddy::kmem_phys_free_frame(start);
+        unsafe { low_level_enter_user(entry, args, args, len) }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_task_spawn(code_handle_value: u64, args_ptr: *const u8, args_len: usize) -> i64 {
+        match task_spawn(code_handle_value, args_ptr, args_len) {
+            Ok(tid) => tid.0 as i64,
+            Err(err) => err as i64,
+        }
+    }
+
+    /// Mevcut görevin ID'si (çalışan iş parçacığının görevi).
+    pub fn get_current_task_id() -> Result<KTaskId, KError> {
+        Ok(KTaskId(ksched::current_task() as u64))
+    }
+
+    /// Çağıran iş parçacığını sonlandırır. Görevin son iş parçacığı çıkınca görev durumu bırakılır
+    /// (bkz. ksched::thread_exit); diğer iş parçacıkları kendi çıkışlarına kadar çalışır.
+    pub fn task_exit(code: i32) -> ! {
+        ksched::thread_exit(code)
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_task_exit(code: i32) -> ! {
+        task_exit(code)
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_task_current_id() -> i64 {
+        match get_current_task_id() {
+            Ok(tid) => tid.0 as i64,
+            Err(err) => err as i64,
+        }
+    }
 }
 
 mod kmemory {
      use super::*;
     // TODO: Fiziksel bellek ayırıcı, sanal bellek yöneticisi, sayfa tabloları, kullanıcı alanı bellek haritaları.
 
+    extern "C" {
+        fn kmem_virt_fault_in(vaddr: u64, write: u32) -> i64;
+        fn kmem_virt_translate(vaddr: u64) -> u64;
+    }
+
+    /// Kullanıcı yarısının üst sınırı (hariç)
+    pub const USER_END: u64 = 0x0000_8000_0000_0000;
+    const PAGE_SIZE: u64 = 4096;
+
+    // --- Kullanıcı Belleğine Erişim ---
+    // Sistem çağrıları kullanıcı işaretçilerini buradan doğrular ve kopyalar. Her sayfa çalışan görevin adres
+    // alanında çözülür: pager bölgeleri (imaj, yığıt) hata yolundaki gibi kurulur (yazmada göreve özel frame);
+    // pager dışındaki pencereler doğrudan eşlenmiştir ve yalnızca heap (srctier.rs) ile dilim (srcslab.rs)
+    // pencereleri yazılabilirdir (kaynak haritaları ve zaman sayfası salt okunur olabilir). Kopyalar kullanıcı
+    // sanal adresine dokunmaz, frame'in kimlik haritalı fiziksel adresinden yapılır: eşlenmemiş adres
+    // çekirdekte sayfa hatası yerine BadAddress olur.
+
+    // Sayfanın frame'i (sayfa başı fiziksel adres)
+    fn user_frame(page: u64, write: bool) -> Result<u64, KError> {
+        match unsafe { kmem_virt_fault_in(page, write as u32) } {
+            0 => {}
+            err if err == KError::OutOfMemory as i64 => return Err(KError::OutOfMemory),
+            err if err == KError::BadAddress as i64 => {
+                if write && !ktier::is_heap_address(page) && !kslab::is_user_address(page) {
+                    return Err(KError::BadAddress);
+                }
+            }
+            _ => return Err(KError::BadAddress),
+        }
+        match unsafe { kmem_virt_translate(page) } {
+            0 => Err(KError::BadAddress),
+            frame => Ok(frame & !(PAGE_SIZE - 1)),
+        }
+    }
+
+    // Aralık kullanıcı yarısında ve taşmasız mı; aralığın sonunu döner
+    fn user_range_end(addr: u64, len: usize) -> Result<u64, KError> {
+        let end = addr.checked_add(len as u64).ok_or(KError::BadAddress)?;
+        if addr == 0 || end > USER_END {
+            return Err(KError::BadAddress);
+        }
+        Ok(end)
+    }
+
+    /// `[addr, addr + len)` çalışan görevin adres alanında erişilebilir mi (`write`: yazılabilir). Sayfalar
+    /// kurulur; provider'ın kullanıcı tamponuna doğrudan erişimi (readv/writev) bundan sonra hata vermez.
+    pub fn validate_user_range(addr: u64, len: usize, write: bool) -> Result<(), KError> {
+        if len == 0 {
+            return Ok(());
+        }
+        let end = user_range_end(addr, len)?;
+        let mut page = addr & !(PAGE_SIZE - 1);
+        while page < end {
+            user_frame(page, write)?;
+            page += PAGE_SIZE;
+        }
+        Ok(())
+    }
+
+    // Aralığı sayfa parçalarına böler: (frame içindeki fiziksel adres, parçanın tampondaki konumu, uzunluk)
+    fn for_each_user_chunk(addr: u64, len: usize, write: bool, mut op: impl FnMut(u64, usize, usize)) -> Result<(), KError> {
+        if len == 0 {
+            return Ok(());
+        }
+        user_range_end(addr, len)?;
+        let mut done = 0;
+        while done < len {
+            let vaddr = addr + done as u64;
+            let in_page = (vaddr & (PAGE_SIZE - 1)) as usize;
+            let chunk = (PAGE_SIZE as usize - in_page).min(len - done);
+            let frame = user_frame(vaddr & !(PAGE_SIZE - 1), write)?;
+            op(frame + in_page as u64, done, chunk);
+            done += chunk;
+        }
+        Ok(())
+    }
+
+    /// Kullanıcı belleğinden `dst`'yi doldurur. Erişilemeyen adreste BadAddress (kısmi kopya olabilir).
+    pub fn copy_from_user(dst: &mut [u8], src: u64) -> Result<(), KError> {
+        for_each_user_chunk(src, dst.len(), false, |phys, at, len| unsafe {
+            core::ptr::copy_nonoverlapping(phys as *const u8, dst.as_mut_ptr().add(at), len)
+        })
+    }
+
+    /// `src`'yi kullanıcı belleğine yazar. Yazılamayan adreste BadAddress (kısmi kopya olabilir).
+    pub fn copy_to_user(dst: u64, src: &[u8]) -> Result<(), KError> {
+        for_each_user_chunk(dst, src.len(), true, |phys, at, len| unsafe {
+            core::ptr::copy_nonoverlapping(src.as_ptr().add(at), phys as *mut u8, len)
+        })
+    }
+
     pub fn init_manager() {
         // Placeholder başlatma
          println!("Karnal64: Bellek Yöneticisi Başlatıldı (Yer Tutucu)");
     }
-    // TODO: allocate/free user memory, map/unmap shared memory implementasyonları
+
+    // Küçük DEFAULT tahsisler görevin dilim kümesinden (srcslab.rs), diğerleri katman/NUMA yerleşim
+    // katmanından (srctier.rs) ayrılır
+    pub fn allocate_user_memory(size: usize) -> Result<*mut u8, KError> {
+        allocate_user_memory_placed(size, ktier::HINT_DEFAULT)
+    }
+
+    pub fn allocate_user_memory_placed(size: usize, hint: u32) -> Result<*mut u8, KError> {
+        if hint == ktier::HINT_DEFAULT && size != 0 && size <= kslab::SLAB_MAX_SIZE {
+            return kslab::user_alloc(size).map(|addr| addr as *mut u8);
+        }
+        ktier::allocate_user(size, hint).map(|addr| addr as *mut u8)
+    }
+
+    pub fn free_user_memory(ptr: *mut u8, size: usize) -> Result<(), KError> {
+        // Yerleşim ipuçlu küçük tahsisler de heap penceresindedir; ayırıcı adrese göre seçilir
+        if size <= kslab::SLAB_MAX_SIZE && !ktier::is_heap_address(ptr as u64) {
+            return kslab::user_free(ptr as u64, size);
+        }
+        ktier::release_user(ptr as u64, size)
+    }
+    // TODO: map/unmap shared memory implementasyonları
 }
 
 mod ksync {
      use super::*;
-    // TODO: Dahili çekirdek kilitleri, semaforları, koşul değişkenleri gibi senkronizasyon primitiflerinin implementasyonu.
+    // TODO: Semaforlar gibi diğer senkronizasyon primitifleri.
+    // Kilitler uyarlanabilir (dön-sonra-bloklan) çekirdek kilitleri ve futex'lerdir (srcmutex.rs).
+    // Okuyucu-yazıcı kilitleri yazıcı önceliklidir; koşul değişkenleri kilit handle'larıyla birlikte kullanılır.
 
     pub fn init_manager() {
         // Placeholder başlatma
          println!("Karnal64: Senkronizasyon Yöneticisi Başlatıldı (Yer Tutucu)");
     }
-     // TODO: kilit create/acquire/release ve diğer primitifler implementasyonları
+
+    pub fn lock_create() -> Result<KHandle, KError> {
+        kmutex::lock_create()
+    }
+
+    pub fn lock_acquire(k_handle_value: u64) -> Result<(), KError> {
+        kmutex::lock_acquire(k_handle_value)
+    }
+
+    pub fn lock_release(k_handle_value: u64) -> Result<(), KError> {
+        kmutex::lock_release(k_handle_value)
+    }
+
+    pub fn rwlock_create() -> Result<KHandle, KError> {
+        kmutex::rwlock_create()
+    }
+
+    pub fn rwlock_read_acquire(k_handle_value: u64) -> Result<(), KError> {
+        kmutex::rwlock_read_acquire(k_handle_value)
+    }
+
+    pub fn rwlock_read_release(k_handle_value: u64) -> Result<(), KError> {
+        kmutex::rwlock_read_release(k_handle_value)
+    }
+
+    pub fn rwlock_write_acquire(k_handle_value: u64) -> Result<(), KError> {
+        kmutex::rwlock_write_acquire(k_handle_value)
+    }
+
+    pub fn rwlock_write_release(k_handle_value: u64) -> Result<(), KError> {
+        kmutex::rwlock_write_release(k_handle_value)
+    }
+
+    pub fn cond_create() -> Result<KHandle, KError> {
+        kmutex::cond_create()
+    }
+
+    pub fn cond_wait(cond_handle: u64, lock_handle: u64) -> Result<(), KError> {
+        kmutex::cond_wait(cond_handle, lock_handle)
+    }
+
+    pub fn cond_notify_one(cond_handle: u64) -> Result<(), KError> {
+        kmutex::cond_notify_one(cond_handle)
+    }
+
+    pub fn cond_notify_all(cond_handle: u64) -> Result<(), KError> {
+        kmutex::cond_notify_all(cond_handle)
+    }
+
+    pub fn futex_wait(addr: u64, expected: u32) -> Result<(), KError> {
+        kmutex::futex_wait(addr, expected)
+    }
+
+    pub fn futex_wait_timeout(addr: u64, expected: u32, timeout_ns: u64) -> Result<(), KError> {
+        kmutex::futex_wait_timeout(addr, expected, timeout_ns)
+    }
+
+    pub fn futex_wake(addr: u64, count: u32) -> Result<u32, KError> {
+        kmutex::futex_wake(addr, count)
+    }
 }
 
 mod kmessaging {
@@ -419,7 +1081,88 @@ mod kkernel {
          // Placeholder başlatma
           println!("Karnal64: Çekirdek Bilgisi Yöneticisi Başlatıldı (Yer Tutucu)");
     }
-     // TODO: get_info, get_time implementasyonları
+
+    pub fn get_info(info_type: u32) -> Result<u64, KError> {
+        // Dilim ayırıcı istatistikleri (KARNAL_INFO_SLAB_*, bkz. srcslab.rs)
+        if let Some(result) = kslab::get_info(info_type) {
+            return result;
+        }
+        // Toplu TLB geçersiz kılma istatistikleri (KARNAL_INFO_TLB_*, bkz. srctlb.rs)
+        if let Some(value) = ktlb::get_info(info_type) {
+            return Ok(value);
+        }
+        // Talep üzerine sayfalama istatistikleri (KARNAL_INFO_PAGER_*, bkz. srcpager.rs)
+        if let Some(value) = kpager::get_info(info_type) {
+            return Ok(value);
+        }
+        // Zamanlayıcı istatistikleri (KARNAL_INFO_SCHED_*, bkz. srcsched.rs)
+        if let Some(value) = ksched::get_info(info_type) {
+            return Ok(value);
+        }
+        // Uyarlanabilir kilit istatistikleri (KARNAL_INFO_LOCK_*, bkz. srcmutex.rs)
+        if let Some(value) = kmutex::get_info(info_type) {
+            return Ok(value);
+        }
+        // Handle tablosu istatistikleri (KARNAL_INFO_HANDLE_*, bkz. srchandle.rs)
+        if let Some(value) = khandle::get_info(info_type) {
+            return Ok(value);
+        }
+        // RCU ve kaynak kaydı istatistikleri (KARNAL_INFO_RCU_*, KARNAL_INFO_REGISTRY_*, bkz. srcrcu.rs, srcregistry.rs)
+        if let Some(value) = krcu::get_info(info_type) {
+            return Ok(value);
+        }
+        if let Some(value) = kregistry::get_info(info_type) {
+            return Ok(value);
+        }
+        // Zamanlayıcı kesmesi istatistikleri (KARNAL_INFO_TIMER_*, bkz. srctimer.rs)
+        if let Some(value) = ktimer::get_info(info_type) {
+            return Ok(value);
+        }
+        // Kesme dağıtımı istatistikleri (KARNAL_INFO_IRQ_*, bkz. srcirq.rs)
+        if let Some(value) = kirq::get_info(info_type) {
+            return Ok(value);
+        }
+        // Tamponlu konsol istatistikleri (KARNAL_INFO_CONSOLE_*, bkz. srcconsole.rs)
+        if let Some(value) = kconsole::get_info(info_type) {
+            return Ok(value);
+        }
+        // İzleme istatistikleri ve sistem çağrısı histogramları (KARNAL_INFO_TRACE_*, bkz. srctrace.rs)
+        if let Some(value) = ktrace::get_info(info_type) {
+            return Ok(value);
+        }
+        // Bellek katmanı kullanımı ve yerleşim istatistikleri (KARNAL_INFO_MEM_*, bkz. srctier.rs)
+        if let Some(value) = ktier::get_info(info_type) {
+            return Ok(value);
+        }
+        // Fiziksel frame ayırıcı hataları (KARNAL_INFO_PHYS_*, bkz. srcbuddy.rs)
+        if let Some(value) = kbuddy::get_info(info_type) {
+            return Ok(value);
+        }
+        // Açılış arşivi istatistikleri (KARNAL_INFO_INITRD_*, bkz. srcinitrdfs.rs)
+        if let Some(value) = kinitrd::get_info(info_type) {
+            return Ok(value);
+        }
+        // Açılış grafiği süreleri ve ertelenmiş provider sayısı (KARNAL_INFO_BOOT_*, bkz. srcboot.rs)
+        if let Some(value) = kboot::get_info(info_type) {
+            return Ok(value);
+        }
+        // Önbellekli pil durumu ve bildirimler (KARNAL_INFO_BATTERY_*, bkz. srcbatterystate.rs)
+        if let Some(value) = kbattery::get_info(info_type) {
+            return Ok(value);
+        }
+        // Frekans seviyeleri ve boşta durumları (KARNAL_INFO_DVFS_*, bkz. srcdvfs.rs)
+        if let Some(value) = kdvfs::get_info(info_type) {
+            return Ok(value);
+        }
+        // TODO: Versiyon, mimari, çalışma süresi gibi diğer bilgi türleri
+        Err(KError::NotSupported)
+    }
+
+    /// Gerçek zaman (Unix epoch'tan beri ns). Kullanıcı alanı aynı değeri paylaşımlı zaman sayfasından
+    /// sistem çağrısı yapmadan okuyabilir (bkz. srctimepage.rs).
+    pub fn get_time() -> Result<u64, KError> {
+        Ok(ktimepage::realtime_ns())
+    }
 }
 
 
@@ -446,91 +1189,12 @@ pub extern "C" fn handle_syscall(
     // kullanıcının bellek haritasına göre GEÇERLİ ve ERIŞILEBILIR (okunabilir/yazılabilir)
     // olduklarını doğrulamalıdır. Bu doğrulama, Karnal64 fonksiyonlarına geçirmeden önce yapılmalıdır.
 
-    let result: Result<u64, KError> = match number {
-        // Sistem Çağrısı Numaraları (Sahne64 arch::SYSCALL_* ile eşleşmeli)
-        1 => { // SYSCALL_MEMORY_ALLOCATE
-             let size = arg1 as usize;
-             // TODO: Bellek yöneticisinden kullanıcı alanı belleği tahsis et
-             kmemory::allocate_user_memory(size).map(|ptr| ptr as u64)
-        }
-        2 => { // SYSCALL_MEMORY_RELEASE
-             let ptr = arg1 as *mut u8;
-             let size = arg2 as usize;
-             // TODO: ptr'nin geçerli bir kullanıcı alanı pointer'ı olduğunu doğrula
-             // TODO: Bellek yöneticisine serbest bırakma isteği gönder
-             kmemory::free_user_memory(ptr, size).map(|_| 0) // Başarı genellikle 0 döndürür
-        }
-        3 => { // SYSCALL_TASK_SPAWN
-             let code_handle_value = arg1; // Çalıştırılacak kod kaynağının handle'ı
-             let args_ptr = arg2 as *const u8; // Argüman verisi pointer'ı
-             let args_len = arg3 as usize; // Argüman verisi uzunluğu
-             // TODO: args_ptr/len'in geçerli kullanıcı alanı pointer'ları olduğunu doğrula
-             // TODO: Görev yöneticisinden yeni görev başlatma isteği gönder
-             ktask::task_spawn(code_handle_value, args_ptr, args_len).map(|tid| tid.0)
-        }
-        4 => { // SYSCALL_TASK_EXIT
-             let code = arg1 as i32; // Çıkış kodu
-             // TODO: Görev yöneticisinden mevcut görevi sonlandırma isteği gönder
-             ktask::task_exit(code); // Bu fonksiyon geri dönmez, doğrudan bağlam değiştirir
-        }
-        5 => { // SYSCALL_RESOURCE_ACQUIRE
-             let id_ptr = arg1 as *const u8; // Kaynak ID pointer'ı
-             let id_len = arg2 as usize; // Kaynak ID uzunluğu
-             let mode = arg3 as u32; // Erişim modları
-             // TODO: id_ptr/len'in geçerli kullanıcı alanı pointer'ları olduğunu doğrula
-             // TODO: Kaynak yöneticisinden edinme isteği gönder
-             kresource::resource_acquire(id_ptr, id_len, mode).map(|handle| handle.0)
-        }
-        6 => { // SYSCALL_RESOURCE_READ
-             let handle_value = arg1; // Kullanıcı handle değeri
-             let user_buffer_ptr = arg2 as *mut u8; // Kullanıcı tamponu pointer'ı
-             let user_buffer_len = arg3 as usize; // Kullanıcı tamponu uzunluğu
-             // TODO: user_buffer_ptr/len'in geçerli kullanıcı alanı pointer'ları ve YAZILABİLİR olduğunu doğrula
-             // TODO: Kaynak yöneticisinden okuma isteği gönder
-             kresource::resource_read(handle_value, user_buffer_ptr, user_buffer_len).map(|bytes_read| bytes_read as u64)
-        }
-        7 => { // SYSCALL_RESOURCE_WRITE
-             let handle_value = arg1; // Kullanıcı handle değeri
-             let user_buffer_ptr = arg2 as *const u8; // Kullanıcı tamponu pointer'ı
-             let user_buffer_len = arg3 as usize; // Kullanıcı tamponu uzunluğu
-              // TODO: user_buffer_ptr/len'in geçerli kullanıcı alanı pointer'ları ve OKUNABİLİR olduğunu doğrula
-              // TODO: Kaynak yöneticisinden yazma isteği gönder
-             kresource::resource_write(handle_value, user_buffer_ptr, user_buffer_len).map(|bytes_written| bytes_written as u64)
-        }
-        8 => { // SYSCALL_RESOURCE_RELEASE
-             let handle_value = arg1; // Kullanıcı handle değeri
-             // TODO: Kaynak yöneticisinden serbest bırakma isteği gönder
-             kresource::resource_release(handle_value).map(|_| 0) // Başarı genellikle 0 döndürür
-        }
-        // TODO: Diğer tüm SYSCALL_ numaraları için eşleşmeleri ekle...
-         SYSCALL_GET_TASK_ID => ktask::get_current_task_id().map(|tid| tid.0)
-         SYSCALL_TASK_SLEEP => ktask::task_sleep(arg1).map(|_| 0)
-         SYSCALL_LOCK_CREATE => ksync::lock_create().map(|h| h.0)
-         SYSCALL_LOCK_ACQUIRE => ksync::lock_acquire(arg1).map(|_| 0)
-         SYSCALL_LOCK_RELEASE => ksync::lock_release(arg1).map(|_| 0)
-         SYSCALL_MESSAGE_SEND => kmessaging::send(arg1, arg2 as *const u8, arg3 as usize).map(|_| 0) // Pointer doğrulama gerekli!
-         SYSCALL_MESSAGE_RECEIVE => kmessaging::receive(arg1 as *mut u8, arg2 as usize).map(|n| n as u64) // Pointer doğrulama gerekli!
-         SYSCALL_GET_KERNEL_INFO => kkernel::get_info(arg1 as u32).map(|v| v as u64)
-         SYSCALL_TASK_YIELD => ktask::yield_now().map(|_| 0)
-
-
-        _ => {
-            // Bilinmeyen sistem çağrısı numarası
-            Err(KError::NotSupported) // Veya KError::UnknownSyscall gibi özel bir hata
-        }
-    };
-
-    // Karnal64 fonksiyonundan dönen sonucu (Result<u64, KError>) sistem çağrısının
-    // beklediği i64 formatına dönüştür.
-    // Başarı -> pozitif veya sıfır sonuç değeri
-    // Hata -> negatif hata kodu
-    match result {
-        Ok(value) => value as i64, // Başarı değeri (u64 -> i64 dönüşümü dikkatli yapılmalı, taşma?)
-        Err(err) => err as i64,    // Hata kodu (KError i64 olarak tanımlandı)
-    }
+    // Dağıtım numarayla indekslenen tablodan yapılır (bkz. srcsyscall.rs). Mimarilerin hızlı giriş yolu
+    // (SYSCALL/SVC) aynı tabloya karnal_syscall_fast üzerinden gelir; bu fonksiyon tam çerçeveli yavaş yoldur.
+    ksyscall::dispatch(number, arg1, arg2, arg3, arg4, arg5)
 }
 
-// Not: Buradaki sistem çağrısı numaraları (1, 2, 3, ...) ve KError değerleri (-1, -2, ...)
+// Not: Sistem çağrısı numaraları (ksyscall::SYSCALL_*, srcsyscall.rs) ve KError değerleri (-1, -2, ...)
 // Sahne64'teki `arch::SYSCALL_*` sabitleri ve `map_kernel_error` fonksiyonu tarafından
 // beklenen değerlerle KESİNLİKLE eşleşmelidir. Bu, kullanıcı alanı ile çekirdek
 // implementasyonu arasındaki ABI sözleşmesidir.
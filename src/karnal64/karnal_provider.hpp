@@ -0,0 +1,135 @@
+#ifndef KARNAL_PROVIDER_HPP
+#define KARNAL_PROVIDER_HPP
+
+#include "karnal.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// --- C++ ResourceProvider Bağdaştırıcısı ---
+// C++ sürücüleri KarnalResourceProviderC_t tablosunu ve provider_data'yı geri çeviren sarmalayıcıları elle
+// yazmak yerine ResourceProviderAdapter<T> kullanır. Tablo ve C thunk'ları derleme anında T'den üretilir:
+// - Her thunk T'nin metodunu nitelikli (T::Read) ve sanal olmayan şekilde çağırır; sınıf gövdesinde tanımlı
+//   metodlar thunk'a satır içi açılır. Karnal64'ten sürücüye tek bir dolaylı çağrı kalır.
+// - T'nin arayüzü concept'lerle denetlenir: eksik veya yanlış imzalı metod, tablo yanlış doldurulmadan
+//   derleme hatası verir.
+// - ReadV/WriteV isteğe bağlıdır. Tanımlı değilse slot NULL kalır ve Karnal64 Read/Write ile döngü kurar.
+// - Map isteğe bağlıdır. Tanımlı değilse map_fn NULL kalır ve karnal_resource_map desteklenmez.
+//
+// Beklenen arayüz (dönüş değerleri int64_t'ye dönüşmeli: >=0 başarı, <0 kerror_t):
+//   int64_t Read(uint8_t* buffer, size_t size, uint64_t offset);
+//   int64_t Write(const uint8_t* buffer, size_t size, uint64_t offset);
+//   int64_t Control(uint64_t request, uint64_t arg);
+//   int64_t ReadV(const KarnalIoVec_t* iov, size_t iov_count);   // isteğe bağlı
+//   int64_t WriteV(const KarnalIoVec_t* iov, size_t iov_count);  // isteğe bağlı
+//   int64_t Map(uint64_t offset, uint32_t prot);                  // isteğe bağlı: fiziksel frame
+//
+// Örnek:
+//   Kernel::KernelConsoleDevice g_console_device;
+//   int64_t handle = Karnal::ResourceProviderAdapter<Kernel::KernelConsoleDevice>::Register(
+//       "karnal://device/console", g_console_device);
+
+namespace Karnal {
+
+template <typename T>
+concept ReadableProvider = requires(T& provider, uint8_t* buffer, size_t size, uint64_t offset) {
+    static_cast<int64_t>(provider.Read(buffer, size, offset));
+};
+
+template <typename T>
+concept WritableProvider = requires(T& provider, const uint8_t* buffer, size_t size, uint64_t offset) {
+    static_cast<int64_t>(provider.Write(buffer, size, offset));
+};
+
+template <typename T>
+concept ControllableProvider = requires(T& provider, uint64_t request, uint64_t arg) {
+    static_cast<int64_t>(provider.Control(request, arg));
+};
+
+template <typename T>
+concept VectoredReadProvider = requires(T& provider, const KarnalIoVec_t* iov, size_t iov_count) {
+    static_cast<int64_t>(provider.ReadV(iov, iov_count));
+};
+
+template <typename T>
+concept VectoredWriteProvider = requires(T& provider, const KarnalIoVec_t* iov, size_t iov_count) {
+    static_cast<int64_t>(provider.WriteV(iov, iov_count));
+};
+
+template <typename T>
+concept MappableProvider = requires(T& provider, uint64_t offset, uint32_t prot) {
+    static_cast<int64_t>(provider.Map(offset, prot));
+};
+
+template <typename T>
+class ResourceProviderAdapter {
+    static_assert(ReadableProvider<T>, "T, int64_t Read(uint8_t*, size_t, uint64_t) sağlamalıdır");
+    static_assert(WritableProvider<T>, "T, int64_t Write(const uint8_t*, size_t, uint64_t) sağlamalıdır");
+    static_assert(ControllableProvider<T>, "T, int64_t Control(uint64_t, uint64_t) sağlamalıdır");
+
+    // Thunk'lar provider_data'yı T'ye geri çevirir ve metodu sanal dağıtım olmadan çağırır
+    static int64_t ReadThunk(void* data, uint8_t* buffer, size_t size, uint64_t offset) {
+        return static_cast<int64_t>(static_cast<T*>(data)->T::Read(buffer, size, offset));
+    }
+
+    static int64_t WriteThunk(void* data, const uint8_t* buffer, size_t size, uint64_t offset) {
+        return static_cast<int64_t>(static_cast<T*>(data)->T::Write(buffer, size, offset));
+    }
+
+    static int64_t ControlThunk(void* data, uint64_t request, uint64_t arg) {
+        return static_cast<int64_t>(static_cast<T*>(data)->T::Control(request, arg));
+    }
+
+    static int64_t ReadVThunk(void* data, const KarnalIoVec_t* iov, size_t iov_count) {
+        return static_cast<int64_t>(static_cast<T*>(data)->T::ReadV(iov, iov_count));
+    }
+
+    static int64_t WriteVThunk(void* data, const KarnalIoVec_t* iov, size_t iov_count) {
+        return static_cast<int64_t>(static_cast<T*>(data)->T::WriteV(iov, iov_count));
+    }
+
+    static int64_t MapThunk(void* data, uint64_t offset, uint32_t prot) {
+        return static_cast<int64_t>(static_cast<T*>(data)->T::Map(offset, prot));
+    }
+
+public:
+    ResourceProviderAdapter() = delete;
+
+    /// T için doldurulmuş fonksiyon tablosu. Karnal64 kayıtta tabloyu kopyalar; instance kayıt boyunca yaşamalıdır.
+    static constexpr KarnalResourceProviderC_t Table(T& instance) {
+        KarnalResourceProviderC_t table = {};
+        table.read_fn = &ReadThunk;
+        table.write_fn = &WriteThunk;
+        table.control_fn = &ControlThunk;
+        if constexpr (VectoredReadProvider<T>) {
+            table.readv_fn = &ReadVThunk;
+        }
+        if constexpr (VectoredWriteProvider<T>) {
+            table.writev_fn = &WriteVThunk;
+        }
+        if constexpr (MappableProvider<T>) {
+            table.map_fn = &MapThunk;
+        }
+        table.provider_data = &instance;
+        return table;
+    }
+
+    /**
+     * instance'ı `id` ile kaydeder.
+     * @return karnal_resource_register_c_provider ile aynı: dahili handle (>=0) veya negatif kerror_t.
+     */
+    static int64_t Register(const char* id, size_t id_len, T& instance) {
+        KarnalResourceProviderC_t table = Table(instance);
+        return karnal_resource_register_c_provider(reinterpret_cast<const uint8_t*>(id), id_len, &table);
+    }
+
+    /// Dizgi sabiti ID'si için: uzunluk derleme anında bilinir.
+    template <size_t N>
+    static int64_t Register(const char (&id)[N], T& instance) {
+        return Register(id, N - 1, instance);
+    }
+};
+
+} // namespace Karnal
+
+#endif // KARNAL_PROVIDER_HPP
@@ -19,6 +19,18 @@ extern "C" {
 // Çekirdek sanal adres alanı başlangıcı (Tasarımın belirlediği)
 #define KERNEL_VIRTUAL_BASE 0xFFFFFF0000000000ULL
 
+// kmem_virt_map_page için mimariden bağımsız sayfa izin bayrakları.
+// Her mimarinin MMU kodu bunları kendi PTE bitlerine çevirir.
+#define KMEM_PAGE_READ    (1u << 0) // Okunabilir
+#define KMEM_PAGE_WRITE   (1u << 1) // Yazılabilir
+#define KMEM_PAGE_EXEC    (1u << 2) // Yürütülebilir
+#define KMEM_PAGE_USER    (1u << 3) // Kullanıcı alanından erişilebilir
+#define KMEM_PAGE_NOCACHE (1u << 4) // Önbelleksiz (MMIO, DMA tamponları)
+
+// kmem_virt_map_range'in kullanabileceği büyük sayfa (yaprak) boyutları.
+#define KMEM_HUGE_PAGE_2M (2ULL * 1024 * 1024)
+#define KMEM_HUGE_PAGE_1G (1024ULL * 1024 * 1024)
+
 // Bellek bölgesi tanımı (Genel bir yapı)
 typedef struct MemoryRegion {
     vaddr_t start_vaddr; // Sanal başlangıç adresi
@@ -41,20 +53,114 @@ void low_level_memory_init(void);
 
 // --- Fiziksel Bellek Yönetimi ---
 // Çekirdek içindeki fiziksel sayfa/frame yönetimi için.
+// Buddy ayırıcı (srcbuddy.rs): bloklar 2^order frame uzunluğundadır ve kendi boyutlarına hizalıdır.
+
+// En büyük blok order'ı (2^10 frame = 4 MiB). Order 9 = 2 MiB büyük sayfa.
+#define KMEM_MAX_ORDER 10
+
+// Fiziksel bellek bölgeleri (zone). Kısıtlı cihazlar için alt bölgelerden tahsis yapılabilir.
+#define KMEM_ZONE_DMA    0 // 16 MiB altı (eski DMA denetleyicileri)
+#define KMEM_ZONE_DMA32  1 // 4 GiB altı (32-bit DMA yapabilen cihazlar)
+#define KMEM_ZONE_NORMAL 2 // Geri kalan tüm bellek
+
+/**
+ * Fiziksel bir bellek aralığını ayırıcıya ekler. Boot sırasında bellek haritasındaki
+ * her kullanılabilir bölge için çağrılır. Aralık sayfa sınırlarına kırpılır ve zone sınırlarında bölünür.
+ * Aralığın başından frame başına bir byte meta veri ayrılır.
+ * @param base Bölgenin fiziksel başlangıç adresi.
+ * @param size Bölgenin boyutu (byte).
+ */
+void kmem_phys_add_region(paddr_t base, size_t size);
+
+/**
+ * Fiziksel olarak bitişik 2^order frame tahsis eder.
+ * Dönen adres 2^order * KERNEL_PAGE_SIZE'a hizalıdır. Önce NORMAL zone denenir, sonra alt zone'lara düşülür.
+ * @param order Blok boyutunun 2 tabanında logaritması (0 .. KMEM_MAX_ORDER).
+ * @return Bloğun fiziksel başlangıç adresi, yetersiz bellek veya geçersiz order durumunda 0.
+ */
+paddr_t kmem_phys_alloc_frames(uint32_t order);
+
+/**
+ * kmem_phys_alloc_frames gibi çalışır, ancak yalnızca `zone` veya daha alt zone'lardan tahsis eder
+ * (örn. KMEM_ZONE_DMA32 ile 4 GiB altında bir DMA tamponu).
+ * @param order Blok boyutunun 2 tabanında logaritması (0 .. KMEM_MAX_ORDER).
+ * @param zone En yüksek izin verilen zone (KMEM_ZONE_*).
+ * @return Bloğun fiziksel başlangıç adresi, hata durumunda 0.
+ */
+paddr_t kmem_phys_alloc_frames_zone(uint32_t order, uint32_t zone);
+
+/**
+ * kmem_phys_alloc_frames ile tahsis edilmiş bir bloğu serbest bırakır. Eşi (buddy) boşsa bloklar birleştirilir.
+ * @param frame_addr Bloğun fiziksel başlangıç adresi.
+ * @param order Tahsiste kullanılan order.
+ * Farklı bir order, zaten boş bir blok veya ayırıcıya ait olmayan bir adres reddedilir, sayılır
+ * (KARNAL_INFO_PHYS_BAD_FREES) ve konsola bir uyarı yazılır. 0 adresi yok sayılır.
+ */
+void kmem_phys_free_frames(paddr_t frame_addr, uint32_t order);
 
 /**
  * Fiziksel bellekte boş bir sayfa (frame) tahsis eder.
+ * Order-0 hızlı yolu: CPU başına frame önbelleğinden karşılanır, zone kilidine yalnızca toplu dolum için gidilir.
  * @return Tahsis edilen fiziksel sayfanın adresi (paddr_t), hata durumunda özel bir değer (örn. 0 veya NULL_PADDR).
  */
 paddr_t kmem_phys_alloc_frame(void);
 
 /**
- * Tahsis edilmiş bir fiziksel sayfayı serbest bırakır.
+ * Tahsis edilmiş bir fiziksel sayfayı serbest bırakır (CPU başına önbelleğe, kesmeler kapalıyken).
+ * Zaten serbest bırakılmış (önbellekte veya zone'da) bir frame kmem_phys_free_frames gibi reddedilir.
  * @param frame_addr Serbest bırakılacak fiziksel sayfanın adresi.
  */
 void kmem_phys_free_frame(paddr_t frame_addr);
 
-// TODO: Çoklu frame tahsisi, belirli adrese yakın tahsis vb. fonksiyonlar.
+
+// --- Bellek Katmanları ve NUMA Düğümleri (srctier.rs) ---
+// Katmanı bilinen bellek genel zone'lara değil, (düğüm, katman) başına ayrı buddy havuzlarına eklenir.
+// Tahsisler karnal.h'deki KARNAL_MEM_HINT_* ipuçlarına göre katman ve düğüm sırasıyla yapılır.
+
+#define KMEM_TIER_DDR   0 // Genel amaçlı DDR
+#define KMEM_TIER_LPDDR 1 // Düşük güçlü LPDDR
+#define KMEM_TIER_HBM   2 // Yüksek bant genişlikli HBM (küçük kapasite)
+#define KMEM_TIER_GDDR  3 // GDDR (yüksek bant genişliği, yüksek gecikme)
+
+#define KMEM_MAX_NODES 8 // Desteklenen en fazla NUMA düğümü
+
+/**
+ * Katmanı ve düğümü bilinen bir fiziksel aralığı ekler (ACPI SRAT/HMAT, DTB `memory` düğümleri).
+ * Boot sırasında, kmem_phys_add_region yerine çağrılır. Aralık sayfa sınırlarına kırpılır;
+ * aralığın başından frame başına bir byte meta veri ayrılır.
+ * @param base Bölgenin fiziksel başlangıç adresi.
+ * @param size Bölgenin boyutu (byte).
+ * @param node NUMA düğümü (0 .. KMEM_MAX_NODES-1).
+ * @param tier Bellek katmanı (KMEM_TIER_*).
+ * @return Başarı durumunda 0, geçersiz argüman veya aralık tablosu doluysa negatif kerror_t.
+ */
+kerror_t kmem_phys_add_tier_region(paddr_t base, size_t size, uint32_t node, uint32_t tier);
+
+/**
+ * Bir CPU'nun bağlı olduğu NUMA düğümünü kaydeder. Kaydedilmeyen CPU'lar düğüm 0'da sayılır.
+ * @param cpu CPU'nun mantıksal numarası.
+ * @param node NUMA düğümü.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t.
+ */
+kerror_t kmem_phys_set_cpu_node(uint32_t cpu, uint32_t node);
+
+/**
+ * Yerleşim ipucuna göre fiziksel olarak bitişik 2^order frame tahsis eder. Çalışan CPU'nun düğümünden
+ * başlanır; ipucunun izin verdiği ölçüde diğer katmanlara, düğümlere ve en son genel zone'lara düşülür.
+ * @param order Blok boyutunun 2 tabanında logaritması (0 .. KMEM_MAX_ORDER).
+ * @param hint KARNAL_MEM_HINT_* ipucu ve bayrakları.
+ * @return Bloğun fiziksel başlangıç adresi, hata durumunda 0.
+ */
+paddr_t kmem_phys_alloc_frames_placed(uint32_t order, uint32_t hint);
+
+/**
+ * kmem_phys_alloc_frames_placed ile tahsis edilmiş bloğu ait olduğu havuza (katman havuzu veya genel zone) iade eder.
+ * @param frame_addr Bloğun fiziksel başlangıç adresi.
+ * @param order Tahsiste kullanılan order.
+ */
+void kmem_phys_free_frames_placed(paddr_t frame_addr, uint32_t order);
+
+// TODO: Belirli adrese yakın tahsis vb. fonksiyonlar.
 
 
 // --- Sanal Bellek Yönetimi / Sayfa Tabloları ---
@@ -78,6 +184,47 @@ kerror_t kmem_virt_map_page(vaddr_t vaddr, paddr_t paddr, uint32_t flags);
  */
 kerror_t kmem_virt_unmap_page(vaddr_t vaddr);
 
+/**
+ * Fiziksel olarak bitişik bir aralığı mevcut adres alanına eşler.
+ * Hizalama ve kalan boyut izin verdiğinde 1GB veya 2MB yapraklar, aksi halde 4KB sayfalar
+ * kullanılır; bu sayede büyük bölgeler çok daha az TLB girişi tüketir.
+ * 1GB yapraklar yalnızca CPU destekliyorsa seçilir.
+ * @param vaddr Başlangıç sanal adresi (sayfa hizalı).
+ * @param paddr Başlangıç fiziksel adresi (sayfa hizalı).
+ * @param size Eşlenecek boyut (byte, KERNEL_PAGE_SIZE'ın katı).
+ * @param flags KMEM_PAGE_* izin bayrakları.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t.
+ */
+kerror_t kmem_virt_map_range(vaddr_t vaddr, paddr_t paddr, size_t size, uint32_t flags);
+
+/**
+ * kmem_virt_map_range ile kurulmuş bir aralığın eşlemesini kaldırır. Fiziksel bellek serbest bırakılmaz.
+ * Aralık bir büyük sayfanın yalnızca bir kısmını kapsıyorsa eşleme parçalanmaz ve hata döner.
+ * TLB sayfa başına değil, işlem sonunda bir kez temizlenir (diğer CPU'lara tek bir birleştirilmiş IPI).
+ * @param vaddr Başlangıç sanal adresi (sayfa hizalı).
+ * @param size Boyut (byte, KERNEL_PAGE_SIZE'ın katı).
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t.
+ */
+kerror_t kmem_virt_unmap_range(vaddr_t vaddr, size_t size);
+
+/**
+ * Mevcut adres alanında bir sanal adresin eşlendiği fiziksel adresi bulur.
+ * @param vaddr Çevrilecek sanal adres.
+ * @return Eşlenen fiziksel adres (sayfa içi ofset dahil), eşleme yoksa 0.
+ */
+paddr_t kmem_virt_translate(vaddr_t vaddr);
+
+/**
+ * Mevcut adres alanında bir sayfayı, o erişim hata vermiş gibi pager ile önceden kurar.
+ * Yazma istenirse paylaşılan sıfır/COW sayfası yerine göreve özel bir frame eşlenir; bundan sonra
+ * kmem_virt_translate sayfa haritadan kaldırılana kadar aynı frame'i döner.
+ * @param vaddr Kurulacak sanal adres.
+ * @param write Sıfırdan farklıysa yazma erişimi.
+ * @return Başarı durumunda 0; adres pager bölgesinde değilse KERROR_BAD_ADDRESS, izin yoksa
+ *         KERROR_PERMISSION_DENIED, bellek yoksa KERROR_OUT_OF_MEMORY.
+ */
+kerror_t kmem_virt_fault_in(vaddr_t vaddr, uint32_t write);
+
 /**
  * Yeni bir boş sanal adres alanı (sayfa tablosu kökü) oluşturur.
  * Genellikle yeni bir görev (task) başlatılırken kullanılır.
@@ -87,10 +234,39 @@ paddr_t kmem_virt_create_address_space(void); // Genellikle page table root PADD
 
 /**
  * Belirli bir sanal adres alanını siler.
+ * Sayfa başına TLB temizliği yapılmaz; adres alanı hiçbir CPU'da etkin olmamalıdır.
+ * Tembel bölgelere ait frame'lerin referansları bırakılır; paylaşılan frame'ler son sahip bırakınca serbest kalır.
  * @param address_space_id Silinecek adres alanının tanımlayıcısı.
  */
 void kmem_virt_destroy_address_space(paddr_t address_space_id); // Adres alanı ID'si genellikle root PADDR'dır
 
+/**
+ * Bir adres alanında tembel sıfır doldurulan bir bölge ayırır (bss, yığın, heap). Fiziksel bellek ayrılmaz.
+ * Okumalar paylaşılan sıfır sayfasını görür; ilk yazmada sayfaya özel sıfırlanmış bir frame eşlenir.
+ * @param address_space_id Hedef adres alanı (sayfa tablosu kökünün fiziksel adresi).
+ * @param vaddr Başlangıç sanal adresi (sayfa hizalı).
+ * @param size Boyut (byte, KERNEL_PAGE_SIZE'ın katı).
+ * @param flags KMEM_PAGE_* izin bayrakları.
+ * @return Başarı durumunda 0, bölge çakışıyorsa veya tablo doluysa negatif kerror_t.
+ */
+kerror_t kmem_virt_reserve_zero(paddr_t address_space_id, vaddr_t vaddr, size_t size, uint32_t flags);
+
+/**
+ * Bir kod kaynağının içeriğini adres alanına tembel olarak eşler (program segmentleri).
+ * Sayfalar ilk erişimde okunur ve aynı handle'ı eşleyen tüm adres alanları arasında paylaşılır.
+ * Yazılabilir bölgelerde paylaşılan sayfa ilk yazmada kopyalanır (copy-on-write); file_size sonrası sıfırdır.
+ * @param address_space_id Hedef adres alanı (sayfa tablosu kökünün fiziksel adresi).
+ * @param vaddr Başlangıç sanal adresi (sayfa hizalı).
+ * @param size Bölge boyutu (byte, KERNEL_PAGE_SIZE'ın katı).
+ * @param code_handle Okunacak kod kaynağının handle değeri.
+ * @param file_offset Kaynak içindeki başlangıç ofseti (sayfa hizalı).
+ * @param file_size Kaynaktan okunacak byte sayısı (size'dan büyük olamaz).
+ * @param flags KMEM_PAGE_* izin bayrakları.
+ * @return Başarı durumunda 0, hata durumunda negatif kerror_t.
+ */
+kerror_t kmem_virt_map_image(paddr_t address_space_id, vaddr_t vaddr, size_t size, khandle_t code_handle,
+                             uint64_t file_offset, size_t file_size, uint32_t flags);
+
 /**
  * CPU'nun kullanacağı aktif sanal adres alanını değiştirir.
  * @param address_space_id Aktif hale getirilecek adres alanının tanımlayıcısı.
@@ -56,19 +56,36 @@ int64_t dummy_console_write(void* provider_data, const uint8_t* buffer, size_t s
     // donanıma (UART TX register vb.) yazar.
     // Offset konsol gibi stream kaynaklar için kullanılmaz.
 
-    // Yer Tutucu: Basit bir yazma simülasyonu (konsol çıktısı gibi)
-    // Normalde çekirdek içi düşük seviye çıktı fonksiyonu çağrılır.
     // Bu örnek C kodunda printf/fprintf kullanmamalıyız, zira bunlar kullanıcı alanı stdio'suna bağlıdır.
-    // Ancak kavramı göstermek için yorum olarak belirtelim:
-    
-    for (size_t i = 0; i < size; ++i) {
-        low_level_console_putc(buffer[i]); // Çekirdek içi düşük seviye çıktı fonksiyonu
-    }
+    // Çıktı CPU'nun konsol halkasına eklenir; UART arka planda boşaltır, çağıran beklemez.
+    int64_t written = karnal_console_write(buffer, size);
     state->dummy_status = 2; // Örnek durum güncelleme
 
-    printf("Karnal Console Write Sim: %.*s\n", (int)size, (const char*)buffer); // SADECE DEBUG AMAÇLI, KERNELDE YAPILMAZ
+    return written;
+}
 
-    return (int64_t)size; // Tüm byte'lar yazıldı varsayılır
+int64_t dummy_console_writev(void* provider_data, const KarnalIoVec_t* iov, size_t iov_count) {
+    // provider_data burada dummy_console_instance'ı işaret eder.
+    DummyConsoleState_t* state = (DummyConsoleState_t*)provider_data;
+
+    // Tüm segmentler tek provider çağrısında konsol halkasına aktarılır.
+    int64_t total = 0;
+    for (size_t i = 0; i < iov_count; ++i) {
+        if (iov[i].base == NULL && iov[i].len > 0) {
+            return total > 0 ? total : KERROR_INVALID_ARGUMENT;
+        }
+        int64_t written = karnal_console_write(iov[i].base, iov[i].len);
+        if (written < 0) {
+            return total > 0 ? total : written;
+        }
+        total += written;
+        if ((size_t)written < iov[i].len) {
+            break; // Segment halkaya sığmadı ve atıldı: kısa yazma, sonraki segmentler yazılmaz
+        }
+    }
+    state->dummy_status = 2; // Örnek durum güncelleme
+
+    return total;
 }
 
 int64_t dummy_console_control(void* provider_data, uint64_t request, uint64_t arg) {
@@ -87,6 +104,8 @@ KarnalResourceProviderC_t dummy_console_provider_fns = {
     .read_fn = dummy_console_read,
     .write_fn = dummy_console_write,
     .control_fn = dummy_console_control,
+    .readv_fn = NULL, // NULL: Karnal64 segmentler üzerinde read_fn ile döngü kurar
+    .writev_fn = dummy_console_writev,
     // ... diğer fonksiyonlar (eğer trait'e eklendiyse) ...
     .provider_data = &dummy_console_instance // Sürücünün durumunu işaret ediyor
 };
@@ -106,7 +125,8 @@ void main() {
      low_level_memory_init(); // Boot belleği, sayfa tabloları vb.
 
     // --- 2. Karnal64 API'sını Başlat ---
-    // Karnal64'ün iç veri yapılarını ve yöneticilerini hazırlar.
+    // Karnal64'ün iç veri yapılarını ve yöneticilerini hazırlar. İkincil CPU'lar burada açılır ve
+    // başlatmaya paralel katılır; dönüşte tüm alt sistemler hazırdır.
     karnal_init();
 
     // --- 3. Çekirdek Kaynaklarını Karnal64'e Kaydet ---
@@ -132,7 +152,17 @@ void main() {
     }
     console_handle = (khandle_t)reg_result; // Başarı durumunda dönen değer dahili handle'dır
 
-    // TODO: Diğer çekirdek kaynaklarını kaydet (örn. zamanlayıcı, rastgele sayı üreteci, ilk dosya sistemi kökü vb.)
+    // Açılış arşivinin dosyaları "karnal://bootfs/" altında, arşivden kopyalanmadan sunulur
+    paddr_t initrd_base;
+    uint64_t initrd_size;
+    if (low_level_boot_initrd(&initrd_base, &initrd_size) == 0) {
+        if (karnal_initrd_register(initrd_base, initrd_size) < 0) {
+             low_level_panic("Failed to index initrd!");
+            while(1);
+        }
+    }
+
+    // TODO: Diğer çekirdek kaynaklarını kaydet (örn. zamanlayıcı, rastgele sayı üreteci vb.)
 
 
     // --- 4. İlk Kullanıcı Alanı Görevini (Init Process) Başlat ---
@@ -140,15 +170,17 @@ void main() {
     // Bu görev çalıştırılabilir bir dosyadır, bu dosya çekirdek tarafından
     // bir ResourceProvider olarak erişilebilir hale getirilmelidir (örn. boot filesystem üzerinden).
 
-    khandle_t init_code_handle = 0; // Yer tutucu: Init kodunun handle'ı (çekirdeğin bunu bir şekilde edinmesi gerekir)
+    khandle_t init_code_handle; // Init kodunun handle'ı
     ktid_t init_task_id; // Başlatılacak init görevinin ID'si
 
-    // Gerçek senaryoda init_code_handle bir dosyadan okunur veya bootloader'dan alınır.
-    // Örneğin: init_code_handle = karnal_resource_acquire((const uint8_t*)"karnal://bootfs/init", strlen("karnal://bootfs/init"), KRESOURCE_MODE_READ);
-    // Basitlik için burada yer tutucu bir handle kullanıyoruz, ancak bu handle'ın
-    // Karnal64 Kaynak Yöneticisinde geçerli bir ResourceProvider'a (init kodunu içeren)
-    // karşılık geldiği varsayılmalıdır.
-    init_code_handle = 1; // Varsayımsal geçerli handle
+    // Init imajı açılış arşivinden gelir; sayfaları görev çalıştıkça arşivden doğrudan eşlenir
+    const char* init_resource_id = "karnal://bootfs/sbin/init";
+    int64_t acquire_result = karnal_resource_acquire((const uint8_t*)init_resource_id, strlen(init_resource_id), KARNAL_RESOURCE_MODE_READ);
+    if (acquire_result < 0) {
+         low_level_panic("Failed to find init in initrd!");
+        while(1);
+    }
+    init_code_handle = (khandle_t)acquire_result;
 
     // Init sürecine geçilecek argümanlar (örneğin boş)
     const uint8_t* init_args_ptr = NULL;
@@ -170,19 +202,12 @@ void main() {
     // Başlatma tamamlandıktan sonra çekirdek genellikle bir zamanlayıcı döngüsüne girer
     // ve görevleri çalıştırmaya başlar. Bu fonksiyon normalde buradan Geri DönMEZ.
 
-    // TODO: Zamanlayıcıyı başlat veya ana döngüye gir.
-     karnal_scheduler_start(); // Zamanlayıcıyı başlatan bir Karnal64 fonksiyonu olabilir
-
-    // Eğer zamanlayıcı ayrı bir thread ise veya main bir idle loop ise:
-    low_power_idle_loop(); // Veya basitçe:
-    while(1) {
-        // Çekirdek boşta döngüsü
-        // Olayları bekle (kesmeler, timer vb.)
-        // İşlemciyi duraklat (WFI - wait for interrupt)
-    }
+    // Bu bağlam önyükleme CPU'sunun boşta iş parçacığı olur: kuyruğunda iş yoksa diğer CPU'lardan
+    // iş çeker, o da yoksa bir kesmeye kadar bekler (WFI/HLT). İkincil CPU'lar da kendi
+    // başlatmalarının sonunda aynı fonksiyonu çağırır.
+    karnal_scheduler_start();
 
     // Buraya asla ulaşılmamalıdır.
-     return 0; // Kernel entry point genellikle int döndürmez, void veya noreturn'dür
 }
 
 // Not: Bu kod, gerçek bir çekirdeğin giriş noktasından çok daha basittir.
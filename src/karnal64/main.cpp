@@ -1,4 +1,5 @@
 #include "karnal.h"
+#include "karnal_provider.hpp" // ResourceProviderAdapter: C tablosu ve thunk'lar derleme anında üretilir
 
 // Çekirdek içinde ihtiyaç duyulabilecek diğer düşük seviye başlıklar
 #include "hardware_specific.h"
@@ -33,7 +34,8 @@ public:
     }
 
     // ResourceProvider arayüzüne karşılık gelen C++ metodları
-    // Bu metodlar, Karnal64 tarafından C fonksiyonları (aşağıdaki wrapper'lar) aracılığıyla çağrılır.
+    // Karnal64 bunları ResourceProviderAdapter'ın ürettiği thunk'lar üzerinden çağırır; metodlar thunk'lara
+    // satır içi açılır (bkz. karnal_provider.hpp).
 
     kerror_t Read(uint8_t* buffer, size_t size, uint64_t offset) {
         // Gerçek sürücü mantığı: donanımdan oku -> buffera kopyala
@@ -51,14 +53,11 @@ public:
         if (size == 0) return KSUCCESS;
         if (buffer == nullptr) return KERROR_INVALID_ARGUMENT;
 
-        // Yer Tutucu: Simülasyon (düşük seviye çıktı kullanmalıyız)
-        
-        for (size_t i = 0; i < size; ++i) {
-            low_level_console_putc(static_cast<char>(buffer[i]));
-        }
-        
+        // Çıktı CPU'nun konsol halkasına eklenir; UART arka planda boşaltır, çağıran beklemez.
+        int64_t written = karnal_console_write(buffer, size);
+
         internal_state = 3;
-        return static_cast<int64_t>(size); // Yazılan byte sayısı
+        return written; // Yazılan byte sayısı
     }
 
     kerror_t Control(uint64_t request, uint64_t arg) {
@@ -72,29 +71,6 @@ public:
 };
 
 
-// --- C++ Metodlarını C Fonksiyonlarına Sarmalayan Wrapper'lar ---
-// Karnal64'ün beklediği KarnalResourceProviderC_t yapısına uygun fonksiyonlar.
-// Bu fonksiyonlar Karnal64 tarafından çağrılır, onlar da C++ sınıfı metodlarını çağırır.
-
-int64_t kernel_console_read_wrapper(void* provider_data, uint8_t* buffer, size_t size, uint64_t offset) {
-    // provider_data'yı C++ sınıfı instance'ına geri cast et
-    KernelConsoleDevice* device = static_cast<KernelConsoleDevice*>(provider_data);
-    // C++ metodunu çağır ve sonucu döndür
-    return device->Read(buffer, size, offset);
-}
-
-int64_t kernel_console_write_wrapper(void* provider_data, const uint8_t* buffer, size_t size, uint64_t offset) {
-    KernelConsoleDevice* device = static_cast<KernelConsoleDevice*>(provider_data);
-    return device->Write(buffer, size, offset);
-}
-
-int64_t kernel_console_control_wrapper(void* provider_data, uint64_t request, uint64_t arg) {
-    KernelConsoleDevice* device = static_cast<KernelConsoleDevice*>(provider_data);
-    return device->Control(request, arg);
-}
-// TODO: Diğer wrapper fonksiyonları...
-
-
 // Statik olarak C++ sınıf instance'ını oluştur (çekirdek veri segmentinde yaşar)
 // Veya çekirdek içi bir new/delete operatörü varsa heap'te oluşturulabilir.
 KernelConsoleDevice g_console_device;
@@ -125,25 +101,13 @@ void main() {
 
     // --- 3. Çekirdek Bileşenlerini Karnal64'e Kaydet ---
     // KernelConsoleDevice sınıfı gibi C++ bileşenlerini Karnal64'e kaydet.
-    // C++ nesnesi için C wrapper fonksiyonlarını kullanmalıyız.
+    // Fonksiyon tablosu sınıfın metodlarından derleme anında üretilir; arayüz uymazsa derleme hatası verir.
 
-    const char* console_resource_id = "karnal://device/console";
     khandle_t console_handle;
 
-    // KarnalResourceProviderC_t yapısını doldur
-    KarnalResourceProviderC_t console_provider_fns = {
-        .read_fn = Kernel::kernel_console_read_wrapper,
-        .write_fn = Kernel::kernel_console_write_wrapper,
-        .control_fn = Kernel::kernel_console_control_wrapper,
-        // ...
-        .provider_data = &Kernel::g_console_device // C++ nesnesinin pointer'ı
-    };
-
-    // Karnal64'e kaydet
-    int64_t reg_result = karnal_resource_register_c_provider(
-        reinterpret_cast<const uint8_t*>(console_resource_id), // const char* to const uint8_t*
-        strlen(console_resource_id),
-        &console_provider_fns
+    int64_t reg_result = Karnal::ResourceProviderAdapter<Kernel::KernelConsoleDevice>::Register(
+        "karnal://device/console", // Uzunluk derleme anında bilinir
+        Kernel::g_console_device   // Kayıt boyunca yaşayan statik instance
     );
 
     if (reg_result < 0) {
@@ -173,11 +137,8 @@ void main() {
 
 
     // --- 5. Çekirdek Ana Döngüsü (Zamanlayıcı) ---
-     low_power_idle_loop(); // Veya
-    while(1) {
-        // Çekirdek boşta döngüsü (C++ stili)
-         std::this_thread::yield(); // Kernel thread yield gerektirir
-    }
+    // Bu bağlam önyükleme CPU'sunun boşta iş parçacığı olur (CPU başına kuyruklar, boşta CPU iş çeker).
+    karnal_scheduler_start();
 
     // Buraya asla ulaşılmamalı.
 }
@@ -0,0 +1,296 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::KError;
+
+// --- Adres Alanı Etiketleri (amd64 PCID / armv9 ASID / rv64g ASID) ---
+// Her adres alanına donanımın TLB girdilerini etiketlediği küçük bir numara (ASID) verilir.
+// Bağlam değişiminde sayfa tablosu kökü bu etiketle yüklenir ve TLB temizlenmez;
+// başka adres alanlarının girdileri TLB'de kalır ama etiketleri farklı olduğu için eşleşmez.
+//
+// ASID'ler nesil (generation) tabanlı dağıtılır:
+// - Bağlam değeri = (nesil << 16) | asid. Bağlamın nesli güncel nesille aynıysa ASID geçerlidir
+//   ve hızlı yol kilitsizdir (tek bir CAS).
+// - ASID alanı tükenince nesil artırılır, bit eşlemi sıfırlanır; o anda CPU'larda etkin olan
+//   ASID'ler korunur (reserved) ve her CPU bir sonraki geçişinde tüm TLB'sini bir kez temizler.
+// - Bir ASID aynı nesil içinde yalnızca bir adres alanına verilir. Yıkılan adres alanının
+//   ASID'i nesil dönene kadar yeniden kullanılmaz; eski girdileri bu yüzden zararsızdır.
+
+pub mod kasid {
+    use super::*;
+    use core::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+    use spin::Mutex;
+
+    /// ASID takibi yapılan en fazla CPU sayısı. Fazlası etiketsiz çalışır (her geçişte temizlik).
+    pub const MAX_CPUS: usize = 32;
+    /// Desteklenen en geniş ASID alanı (bit). amd64 PCID: 12, armv9: 8/16, rv64g: 0..16.
+    pub const MAX_ASID_BITS: u32 = 16;
+
+    const ASID_MASK: u64 = (1 << MAX_ASID_BITS) - 1;
+    const GEN_ONE: u64 = 1 << MAX_ASID_BITS;
+    const BITMAP_WORDS: usize = (1 << MAX_ASID_BITS) / 64;
+
+    /// Bir adres alanının ASID bağlamı. 0: henüz ASID atanmamış.
+    pub struct AsidContext(AtomicU64);
+
+    impl AsidContext {
+        pub const fn new() -> Self {
+            AsidContext(AtomicU64::new(0))
+        }
+
+        /// Son atanan ASID (nesli güncel olmayabilir; yalnızca TLB temizliği için ipucu).
+        pub fn asid(&self) -> u16 {
+            (self.0.load(Ordering::Relaxed) & ASID_MASK) as u16
+        }
+
+        fn reset(&self) {
+            self.0.store(0, Ordering::Relaxed);
+        }
+    }
+
+    /// Bağlam değişiminin sonucu.
+    pub struct AsidSwitch {
+        /// Sayfa tablosu köküyle birlikte yüklenecek ASID
+        pub asid: u16,
+        /// true ise bu CPU, kökü yükledikten sonra tüm ASID'lerin TLB girdilerini temizlemelidir
+        pub flush_all: bool,
+    }
+
+    struct AsidState {
+        bitmap: [u64; BITMAP_WORDS], // Güncel nesilde kullanılan ASID'ler
+        next: usize,                 // Aramanın başlayacağı ASID
+        reserved: [u64; MAX_CPUS],   // Nesil dönüşünde CPU'larda etkin olan bağlamlar
+    }
+
+    pub struct AsidAllocator {
+        bits: AtomicU32,
+        generation: AtomicU64,       // Güncel nesil (GEN_ONE katı)
+        active: [AtomicU64; MAX_CPUS], // CPU'nun yüklediği bağlam; nesil dönüşünde 0'lanır
+        flush_pending: AtomicU64,    // Bir sonraki geçişte tam temizlik yapması gereken CPU'lar
+        rollovers: AtomicU64,
+        state: Mutex<AsidState>,
+    }
+
+    const ACTIVE_INIT: AtomicU64 = AtomicU64::new(0);
+
+    impl AsidAllocator {
+        /// `bits`: donanımın desteklediği ASID genişliği. 0 ise etiketleme kapalıdır.
+        pub const fn new(bits: u32) -> Self {
+            AsidAllocator {
+                bits: AtomicU32::new(bits),
+                generation: AtomicU64::new(GEN_ONE),
+                active: [ACTIVE_INIT; MAX_CPUS],
+                flush_pending: AtomicU64::new(0),
+                rollovers: AtomicU64::new(0),
+                state: Mutex::new(AsidState { bitmap: [0; BITMAP_WORDS], next: 1, reserved: [0; MAX_CPUS] }),
+            }
+        }
+
+        /// Donanım yoklaması sonrası ASID genişliğini ayarlar. İlk bağlam değişiminden önce çağrılmalıdır.
+        pub fn set_bits(&self, bits: u32) {
+            self.bits.store(bits.min(MAX_ASID_BITS), Ordering::Relaxed);
+        }
+
+        /// Etiketleme etkin mi? En az MAX_CPUS + 2 ASID gerekir (0 ayrılmış, her CPU bir tane tutabilir).
+        pub fn enabled(&self) -> bool {
+            let bits = self.bits.load(Ordering::Relaxed);
+            bits != 0 && (1usize << bits) > MAX_CPUS + 1
+        }
+
+        /// Gerçekleşen nesil dönüşü sayısı.
+        pub fn rollovers(&self) -> u64 {
+            self.rollovers.load(Ordering::Relaxed)
+        }
+
+        /// `ctx` bağlamına sahip adres alanına geçen `cpu` için ASID'i döndürür.
+        /// Hızlı yol (nesil güncel) kilit almaz ve TLB temizliği gerektirmez.
+        pub fn switch_to(&self, ctx: &AsidContext, cpu: usize) -> AsidSwitch {
+            if !self.enabled() || cpu >= MAX_CPUS {
+                // Etiketsiz: ASID 0 ve her geçişte eski girdiler temizlenir.
+                return AsidSwitch { asid: 0, flush_all: true };
+            }
+
+            let generation = self.generation.load(Ordering::Relaxed);
+            let current = ctx.0.load(Ordering::Relaxed);
+            if current != 0 && (current & !ASID_MASK) == generation {
+                // Nesil dönüşü bu CPU'nun etkin değerini 0'lar; CAS bu durumda başarısız olur ve yavaş yola düşeriz.
+                let previous = self.active[cpu].load(Ordering::Relaxed);
+                if previous != 0
+                    && self.active[cpu].compare_exchange(previous, current, Ordering::Relaxed, Ordering::Relaxed).is_ok()
+                {
+                    return AsidSwitch { asid: (current & ASID_MASK) as u16, flush_all: false };
+                }
+            }
+
+            let mut state = self.state.lock();
+            let mut current = ctx.0.load(Ordering::Relaxed);
+            if current == 0 || (current & !ASID_MASK) != self.generation.load(Ordering::Relaxed) {
+                current = self.new_context(&mut state, current);
+                ctx.0.store(current, Ordering::Relaxed);
+            }
+
+            let bit = 1u64 << cpu;
+            let flush_all = self.flush_pending.fetch_and(!bit, Ordering::Relaxed) & bit != 0;
+            self.active[cpu].store(current, Ordering::Relaxed);
+            AsidSwitch { asid: (current & ASID_MASK) as u16, flush_all }
+        }
+
+        // Kilit altında: eski bağlamın ASID'ini güncel nesilde korumaya çalışır, olmazsa yenisini bulur.
+        fn new_context(&self, state: &mut AsidState, old: u64) -> u64 {
+            let limit = 1usize << self.bits.load(Ordering::Relaxed);
+            let generation = self.generation.load(Ordering::Relaxed);
+
+            if old != 0 {
+                let asid = (old & ASID_MASK) as usize;
+                // Nesil dönüşünde bir CPU'da etkindi: aynı ASID yeni nesilde de bu adres alanınındır.
+                let mut was_reserved = false;
+                for reserved in state.reserved.iter_mut() {
+                    if *reserved == old {
+                        *reserved = generation | asid as u64;
+                        was_reserved = true;
+                    }
+                }
+                if was_reserved {
+                    return generation | asid as u64;
+                }
+                // Güncel nesilde kimse almadıysa eski ASID'i geri al (TLB'deki girdileri hâlâ geçerli).
+                if asid < limit && !Self::test_and_set(&mut state.bitmap, asid) {
+                    return generation | asid as u64;
+                }
+            }
+
+            if let Some(asid) = Self::find_free(&mut state.bitmap, state.next, limit) {
+                state.next = asid + 1;
+                return generation | asid as u64;
+            }
+
+            // ASID alanı tükendi: yeni nesle geç
+            let generation = generation + GEN_ONE;
+            self.generation.store(generation, Ordering::Relaxed);
+            self.flush_context(state);
+            // Etkin ASID'ler en fazla MAX_CPUS tane olduğundan arama başarılı olur
+            let asid = Self::find_free(&mut state.bitmap, 1, limit).unwrap_or(0);
+            state.next = asid + 1;
+            generation | asid as u64
+        }
+
+        // Nesil dönüşü: bit eşlemini sıfırlar, CPU'larda etkin ASID'leri korur, tüm CPU'lara temizlik işaretler.
+        fn flush_context(&self, state: &mut AsidState) {
+            state.bitmap = [0; BITMAP_WORDS];
+            state.bitmap[0] |= 1; // ASID 0 ayrılmış (çekirdek / etiketsiz)
+            for cpu in 0..MAX_CPUS {
+                let mut ctx = self.active[cpu].swap(0, Ordering::Relaxed);
+                // 0 ise CPU önceki dönüşten beri geçiş yapmadı; hâlâ ayrılmış değeri kullanıyor.
+                if ctx == 0 {
+                    ctx = state.reserved[cpu];
+                }
+                if ctx != 0 {
+                    Self::test_and_set(&mut state.bitmap, (ctx & ASID_MASK) as usize);
+                }
+                state.reserved[cpu] = ctx;
+            }
+            self.flush_pending.store(u64::MAX, Ordering::Relaxed);
+            self.rollovers.fetch_add(1, Ordering::Relaxed);
+        }
+
+        fn test_and_set(bitmap: &mut [u64; BITMAP_WORDS], asid: usize) -> bool {
+            let (word, bit) = (asid / 64, 1u64 << (asid % 64));
+            let was_set = bitmap[word] & bit != 0;
+            bitmap[word] |= bit;
+            was_set
+        }
+
+        fn find_free(bitmap: &mut [u64; BITMAP_WORDS], from: usize, limit: usize) -> Option<usize> {
+            let start = if from == 0 || from >= limit { 1 } else { from };
+            (start..limit).chain(1..start).find(|&asid| !Self::test_and_set(bitmap, asid))
+        }
+    }
+
+    // --- Kök Adresi -> Bağlam Tablosu ---
+    // Adres alanları MMU API'sinde sayfa tablosu kökünün fiziksel adresiyle tanımlanır
+    // (bkz. kmem_virt_activate_address_space). Bu tablo kökten ASID bağlamına eşler.
+    // Okumalar kilitsizdir; ekleme/silme kilit altında yapılır.
+
+    /// Aynı anda var olabilecek en fazla adres alanı
+    pub const MAX_ADDRESS_SPACES: usize = 1024;
+
+    const EMPTY: u64 = 0;
+    const TOMBSTONE: u64 = u64::MAX;
+
+    pub struct AddressSpaceTable {
+        roots: [AtomicU64; MAX_ADDRESS_SPACES],
+        contexts: [AsidContext; MAX_ADDRESS_SPACES],
+        lock: Mutex<()>,
+    }
+
+    const ROOT_INIT: AtomicU64 = AtomicU64::new(EMPTY);
+    const CONTEXT_INIT: AsidContext = AsidContext::new();
+
+    impl AddressSpaceTable {
+        pub const fn new() -> Self {
+            AddressSpaceTable {
+                roots: [ROOT_INIT; MAX_ADDRESS_SPACES],
+                contexts: [CONTEXT_INIT; MAX_ADDRESS_SPACES],
+                lock: Mutex::new(()),
+            }
+        }
+
+        fn home_slot(root: u64) -> usize {
+            ((root >> 12).wrapping_mul(0x9E37_79B9_7F4A_7C15) >> 54) as usize % MAX_ADDRESS_SPACES
+        }
+
+        /// Yeni bir adres alanı kaydeder ve (ASID'siz) bağlamını döner.
+        pub fn register(&self, root: u64) -> Result<&AsidContext, KError> {
+            if root == EMPTY || root == TOMBSTONE {
+                return Err(KError::InvalidArgument);
+            }
+            let _guard = self.lock.lock();
+            if self.lookup(root).is_some() {
+                return Err(KError::AlreadyExists);
+            }
+            let home = Self::home_slot(root);
+            for i in 0..MAX_ADDRESS_SPACES {
+                let slot = (home + i) % MAX_ADDRESS_SPACES;
+                let current = self.roots[slot].load(Ordering::Relaxed);
+                if current == EMPTY || current == TOMBSTONE {
+                    self.contexts[slot].reset();
+                    self.roots[slot].store(root, Ordering::Release);
+                    return Ok(&self.contexts[slot]);
+                }
+            }
+            Err(KError::OutOfMemory)
+        }
+
+        /// Kökün bağlamını bulur. Kayıtlı değilse None (etiketsiz adres alanı).
+        pub fn lookup(&self, root: u64) -> Option<&AsidContext> {
+            let home = Self::home_slot(root);
+            for i in 0..MAX_ADDRESS_SPACES {
+                let slot = (home + i) % MAX_ADDRESS_SPACES;
+                match self.roots[slot].load(Ordering::Acquire) {
+                    EMPTY => return None,
+                    r if r == root => return Some(&self.contexts[slot]),
+                    _ => {}
+                }
+            }
+            None
+        }
+
+        /// Yıkılan adres alanının kaydını siler. ASID'i nesil dönene kadar yeniden dağıtılmaz.
+        pub fn unregister(&self, root: u64) {
+            let _guard = self.lock.lock();
+            let home = Self::home_slot(root);
+            for i in 0..MAX_ADDRESS_SPACES {
+                let slot = (home + i) % MAX_ADDRESS_SPACES;
+                match self.roots[slot].load(Ordering::Relaxed) {
+                    EMPTY => return,
+                    r if r == root => {
+                        self.roots[slot].store(TOMBSTONE, Ordering::Release);
+                        return;
+                    }
+                    _ => {}
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,287 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, ResourceProvider, kmessaging, kregistry, ktimer};
+
+// --- Önbelleğe Alınmış Pil Durumu ve Değişiklik Bildirimleri (karnal://power/battery) ---
+// Pil durumu her sorguda donanımdan okunmaz. Yakıt göstergesi sürücüsü kesmesinin alt yarısında (kirq
+// iş parçacığı) ölçümü `publish` ile bir kez yayınlar; çekirdek onu tek bir sayfadaki KarnalBatteryState_t
+// bloğuna seqlock ile yazar. Okuyucular:
+// - Sayfayı karnal_resource_map(handle, 0, 4096, KARNAL_MAP_READ) ile salt okunur haritalayıp sistem
+//   çağrısı yapmadan okur (seq tekse veya okuma boyunca değiştiyse yeniden dener).
+// - Haritalamadan karnal_resource_read ile tutarlı bir kopya alır (tek sistem çağrısı, donanım yok).
+// - KARNAL_BATTERY_CTL_SUBSCRIBE ile bir mesaj kanalı kaydeder; durum, şarj seviyesi veya sağlık
+//   değiştiğinde kanala KarnalBatteryEvent_t gönderilir. Güç servisi yoklamak yerine receive'de uyur.
+//
+// Bildirimler engellemeden gönderilir (kmessaging::try_send): kuyruğu dolu aboneye giden olay düşürülür
+// ve sayılır. En güncel değer her zaman bloktadır; olay yalnızca "bak" işaretidir. Kapanmış kanallar
+// ilk başarısız gönderimde abonelikten çıkarılır.
+
+pub mod kbattery {
+    use super::*;
+    use alloc::sync::Arc;
+    use core::sync::atomic::{fence, AtomicPtr, AtomicU32, AtomicU64, Ordering};
+    use spin::Mutex;
+
+    // --- ABI Sabitleri (karnal.h'deki KARNAL_BATTERY_* ile EŞLEŞMELİDİR) ---
+    pub const STATUS_UNKNOWN: u32 = 0; // Henüz yayın yok
+    pub const STATUS_CHARGING: u32 = 1;
+    pub const STATUS_DISCHARGING: u32 = 2;
+    pub const STATUS_FULL: u32 = 3;
+    pub const STATUS_NOT_CHARGING: u32 = 4;
+
+    // KarnalBatteryEvent_t.changed bitleri
+    pub const CHANGED_STATUS: u32 = 1 << 0;
+    pub const CHANGED_CHARGE_LEVEL: u32 = 1 << 1;
+    pub const CHANGED_HEALTH: u32 = 1 << 2;
+
+    // karnal_resource_control istekleri
+    pub const CTL_SUBSCRIBE: u64 = 1;   // arg: mesaj kanalı handle'ı
+    pub const CTL_UNSUBSCRIBE: u64 = 2; // arg: mesaj kanalı handle'ı
+
+    const RESOURCE_ID: &[u8] = b"karnal://power/battery";
+    const MAX_SUBSCRIBERS: usize = 16;
+    const PAGE_SIZE: usize = 4096;
+
+    extern "C" {
+        fn kmem_phys_alloc_frame() -> u64;
+    }
+
+    /// Paylaşımlı durum bloğu (KarnalBatteryState_t). Alanlar yalnızca `publish` tarafından yazılır.
+    #[repr(C)]
+    struct KBatteryPage {
+        seq: AtomicU32,
+        status: AtomicU32,
+        charge_level: AtomicU32, // Yüzde (0-100)
+        health: AtomicU32,       // Yüzde (0-100), tasarım kapasitesine göre
+        updated_ns: AtomicU64,   // Son yayının monoton zamanı
+    }
+
+    /// Bloğun tutarlı bir kopyası (KarnalBatteryState_t ile aynı düzen; seq çift)
+    #[repr(C)]
+    #[derive(Clone, Copy)]
+    pub struct BatteryState {
+        pub seq: u32,
+        pub status: u32,
+        pub charge_level: u32,
+        pub health: u32,
+        pub updated_ns: u64,
+    }
+
+    /// Abonelere giden olay (KarnalBatteryEvent_t)
+    #[repr(C)]
+    #[derive(Clone, Copy)]
+    struct BatteryEvent {
+        changed: u32,
+        status: u32,
+        charge_level: u32,
+        health: u32,
+        updated_ns: u64,
+    }
+
+    // Fiziksel bellek kimlik haritalı: frame adresi doğrudan blok olarak kullanılır
+    static PAGE: AtomicPtr<KBatteryPage> = AtomicPtr::new(core::ptr::null_mut());
+    static FRAME: AtomicU64 = AtomicU64::new(0);
+    // Yayıncıları sıralar; seqlock'un tek yazıcısı
+    static WRITER: Mutex<()> = Mutex::new(());
+
+    const NO_SUBSCRIBER: AtomicU64 = AtomicU64::new(0);
+    static SUBSCRIBERS: [AtomicU64; MAX_SUBSCRIBERS] = [NO_SUBSCRIBER; MAX_SUBSCRIBERS];
+
+    // İstatistikler: KARNAL_INFO_BATTERY_* ile dışarı verilir.
+    static UPDATES: AtomicU64 = AtomicU64::new(0);
+    static NOTIFICATIONS: AtomicU64 = AtomicU64::new(0);
+    static NOTIFY_DROPPED: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_BATTERY_* ile EŞLEŞMELİDİR)
+    pub const INFO_BATTERY_UPDATES: u32 = 0xF00;
+    pub const INFO_BATTERY_NOTIFICATIONS: u32 = 0xF01;
+    pub const INFO_BATTERY_NOTIFY_DROPPED: u32 = 0xF02;
+
+    /// `kkernel::get_info` için: pil istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_BATTERY_UPDATES => Some(UPDATES.load(Ordering::Relaxed)),
+            INFO_BATTERY_NOTIFICATIONS => Some(NOTIFICATIONS.load(Ordering::Relaxed)),
+            INFO_BATTERY_NOTIFY_DROPPED => Some(NOTIFY_DROPPED.load(Ordering::Relaxed)),
+            _ => None,
+        }
+    }
+
+    /// Blok sayfasını ayırır ve "karnal://power/battery"yi kaydeder. Yayın yapılana kadar durum UNKNOWN'dur.
+    pub fn init_manager() {
+        let frame = unsafe { kmem_phys_alloc_frame() };
+        if frame == 0 {
+            return; // Blok yok: publish NotSupported döner
+        }
+        unsafe { core::ptr::write_bytes(frame as *mut u8, 0, PAGE_SIZE) };
+        FRAME.store(frame, Ordering::Relaxed);
+        PAGE.store(frame as *mut KBatteryPage, Ordering::Release);
+        let _ = kregistry::register(RESOURCE_ID, Arc::new(BatteryProvider));
+    }
+
+    /// Bloğun tutarlı bir kopyası. Blok yoksa NotSupported döner.
+    pub fn snapshot() -> Result<BatteryState, KError> {
+        let page = PAGE.load(Ordering::Acquire);
+        if page.is_null() {
+            return Err(KError::NotSupported);
+        }
+        let page = unsafe { &*page };
+        loop {
+            let seq = page.seq.load(Ordering::Acquire);
+            if seq & 1 != 0 {
+                core::hint::spin_loop();
+                continue;
+            }
+            let state = BatteryState {
+                seq,
+                status: page.status.load(Ordering::Relaxed),
+                charge_level: page.charge_level.load(Ordering::Relaxed),
+                health: page.health.load(Ordering::Relaxed),
+                updated_ns: page.updated_ns.load(Ordering::Relaxed),
+            };
+            fence(Ordering::Acquire); // Alan okumaları seq yeniden okunmadan önce biter
+            if page.seq.load(Ordering::Relaxed) == seq {
+                return Ok(state);
+            }
+        }
+    }
+
+    /// Yakıt göstergesinin yeni ölçümünü yayınlar. Değer değiştiyse abonelere bildirir.
+    /// İş parçacığı bağlamından çağrılır (kesmenin alt yarısı); üst yarıda çağrılmamalıdır.
+    pub fn publish(status: u32, charge_level: u32, health: u32) -> Result<(), KError> {
+        if status > STATUS_NOT_CHARGING || charge_level > 100 || health > 100 {
+            return Err(KError::InvalidArgument);
+        }
+        let page = PAGE.load(Ordering::Acquire);
+        if page.is_null() {
+            return Err(KError::NotSupported);
+        }
+        let page = unsafe { &*page };
+        let now = ktimer::now_ns();
+
+        let _writer = WRITER.lock();
+        let mut changed = 0;
+        if page.status.load(Ordering::Relaxed) != status {
+            changed |= CHANGED_STATUS;
+        }
+        if page.charge_level.load(Ordering::Relaxed) != charge_level {
+            changed |= CHANGED_CHARGE_LEVEL;
+        }
+        if page.health.load(Ordering::Relaxed) != health {
+            changed |= CHANGED_HEALTH;
+        }
+        let seq = page.seq.load(Ordering::Relaxed);
+        page.seq.store(seq.wrapping_add(1), Ordering::Relaxed);
+        fence(Ordering::Release); // Tek seq, alan yazımlarından önce görünür
+        page.status.store(status, Ordering::Relaxed);
+        page.charge_level.store(charge_level, Ordering::Relaxed);
+        page.health.store(health, Ordering::Relaxed);
+        page.updated_ns.store(now, Ordering::Relaxed);
+        page.seq.store(seq.wrapping_add(2), Ordering::Release);
+        UPDATES.fetch_add(1, Ordering::Relaxed);
+
+        if changed != 0 {
+            notify(&BatteryEvent { changed, status, charge_level, health, updated_ns: now });
+        }
+        Ok(())
+    }
+
+    fn notify(event: &BatteryEvent) {
+        let bytes = unsafe {
+            core::slice::from_raw_parts(event as *const BatteryEvent as *const u8, core::mem::size_of::<BatteryEvent>())
+        };
+        for subscriber in SUBSCRIBERS.iter() {
+            let channel = subscriber.load(Ordering::Acquire);
+            if channel == 0 {
+                continue;
+            }
+            match kmessaging::try_send(channel, bytes) {
+                Ok(()) => {
+                    NOTIFICATIONS.fetch_add(1, Ordering::Relaxed);
+                }
+                Err(KError::Busy) => {
+                    NOTIFY_DROPPED.fetch_add(1, Ordering::Relaxed);
+                }
+                Err(_) => {
+                    // Kanal artık yok
+                    let _ = subscriber.compare_exchange(channel, 0, Ordering::AcqRel, Ordering::Relaxed);
+                }
+            }
+        }
+    }
+
+    fn subscribe(channel: u64) -> Result<(), KError> {
+        if channel == 0 {
+            return Err(KError::BadHandle);
+        }
+        if SUBSCRIBERS.iter().any(|s| s.load(Ordering::Acquire) == channel) {
+            return Err(KError::AlreadyExists);
+        }
+        SUBSCRIBERS
+            .iter()
+            .find(|s| s.compare_exchange(0, channel, Ordering::AcqRel, Ordering::Relaxed).is_ok())
+            .map(|_| ())
+            .ok_or(KError::Busy)
+    }
+
+    fn unsubscribe(channel: u64) -> Result<(), KError> {
+        SUBSCRIBERS
+            .iter()
+            .find(|s| s.compare_exchange(channel, 0, Ordering::AcqRel, Ordering::Relaxed).is_ok())
+            .map(|_| ())
+            .ok_or(KError::NotFound)
+    }
+
+    /// karnal://power/battery: salt okunur blok, abonelik kontrolleri
+    struct BatteryProvider;
+
+    impl ResourceProvider for BatteryProvider {
+        fn read(&self, buffer: &mut [u8], _offset: u64) -> Result<usize, KError> {
+            let size = core::mem::size_of::<BatteryState>();
+            if buffer.len() < size {
+                return Err(KError::InvalidArgument);
+            }
+            let state = snapshot()?;
+            let bytes = unsafe { core::slice::from_raw_parts(&state as *const BatteryState as *const u8, size) };
+            buffer[..size].copy_from_slice(bytes);
+            Ok(size)
+        }
+
+        fn write(&self, _buffer: &[u8], _offset: u64) -> Result<usize, KError> {
+            Err(KError::PermissionDenied)
+        }
+
+        fn control(&self, request: u64, arg: u64) -> Result<i64, KError> {
+            match request {
+                CTL_SUBSCRIBE => subscribe(arg).map(|_| 0),
+                CTL_UNSUBSCRIBE => unsubscribe(arg).map(|_| 0),
+                _ => Err(KError::NotSupported),
+            }
+        }
+
+        fn mmap_frame(&self, offset: u64, writable: bool) -> Result<u64, KError> {
+            if writable {
+                return Err(KError::PermissionDenied);
+            }
+            if offset != 0 {
+                return Err(KError::InvalidArgument);
+            }
+            match FRAME.load(Ordering::Relaxed) {
+                0 => Err(KError::NotSupported),
+                frame => Ok(frame),
+            }
+        }
+    }
+
+    // --- C API ---
+
+    #[no_mangle]
+    pub extern "C" fn karnal_battery_publish(status: u32, charge_level: u32, health: u32) -> i64 {
+        match publish(status, charge_level, health) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+}
@@ -0,0 +1,442 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, ResourceProvider, kmessaging, kresource, ksched, ksync, ksyscall, ktimer};
+
+// --- Çekirdek İçi Mikro Ölçüm Takımı (kbench) ---
+// Sıcak yolların maliyetini ölçer ve sonuçları karnal://device/console'a makine tarafından okunabilir
+// satırlar olarak yazar. Çekirdekler dağıtımdan önce aynı donanımda bu çıktıyla karşılaştırılır.
+//
+// Derleme anında seçilir: `kbench` özelliği olmadan derlenen çekirdekte karnal_bench_run NotSupported döner
+// ve örnek tamponları yer kaplamaz (ktrace ile aynı düzen).
+//
+// Ölçüm: her örnek `batch` işlemin toplam süresinin işlem başına ortalamasıdır; düşük çözünürlüklü
+// sayaçlarda (armv9 CNTVCT) tek işlem sayacın bir tikinden kısa sürebilir. Sayaç:
+// - amd64: rdtsc (lfence ile sıralı), armv9: CNTVCT_EL0 (isb ile), rv64g: cycle CSR (rdcycle)
+// - diğer mimariler: ktimer::now_ns (birim ns)
+// Sayaç frekansı takım boyunca ktimer ile kalibre edilip başlık satırında verilir.
+//
+// Çıktı biçimi (sürüm 1, her satır "KBENCH 1" ile başlar, alanlar boşlukla ayrılmış anahtar=değer):
+//   KBENCH 1 arch=<mimari> counter=<sayaç> cpus=<çevrimiçi CPU>
+//   KBENCH 1 bench=<ad> batch=<n> samples=<n> min=<v> p50=<v> p90=<v> p99=<v> max=<v>
+//   KBENCH 1 bench=<ad> skipped=<kerror>
+//   KBENCH 1 end hz=<sayaç frekansı>
+//
+// Ölçümler çalışan iş parçacığında yapılır (zamanlayıcı başlamış olmalıdır); eş iş parçacıkları
+// ksched::thread_create ile açılır ve ölçüm bitince kendiliğinden çıkar. Çekirdek içi sistem çağrısı
+// ölçümü yalnızca dağıtımı (tablo + izleme) kapsar; kullanıcı/çekirdek geçişi kullanıcı alanı istemcisi
+// srcsyscallbench.rs ile aynı satır biçiminde ölçülür (bench=syscall_trap; mesajlaşma, kilit, bellek,
+// haritalama ve yield yollarının sistem çağrısı üzerinden tek iş parçacıklı karşılıkları dahil).
+
+pub mod kbench {
+    use super::*;
+    use core::cell::Cell;
+    use core::fmt::Write;
+    use core::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+    use spin::Mutex;
+
+    /// Ölçüm takımı bu çekirdekte derlendi mi
+    pub const COMPILED: bool = cfg!(feature = "kbench");
+
+    // Ölçüm seçimi (karnal.h'deki KARNAL_BENCH_* ile EŞLEŞMELİDİR)
+    pub const BENCH_SYSCALL: u32 = 1 << 0;    // ksyscall::dispatch (GET_KERNEL_INFO)
+    pub const BENCH_MESSAGING: u32 = 1 << 1;  // kmessaging::send/receive gidiş-dönüş (eş iş parçacığı)
+    pub const BENCH_LOCK: u32 = 1 << 2;       // ksync::lock_acquire/release: çekişmesiz ve iki CPU çekişmeli
+    pub const BENCH_FRAME: u32 = 1 << 3;      // kmem_phys_alloc_frame / kmem_phys_free_frame
+    pub const BENCH_MAP: u32 = 1 << 4;        // kmem_virt_map_page / kmem_virt_unmap_page
+    pub const BENCH_SWITCH: u32 = 1 << 5;     // Aynı CPU'da iki iş parçacığı arasında yield gidiş-dönüşü
+    pub const BENCH_ALL: u32 = 0x3F;
+
+    const SAMPLES: usize = if COMPILED { 512 } else { 1 };
+    const MAX_BATCH: usize = 32;
+
+    // Haritalama ölçümünün sanal adresi: karnal_resource_map penceresinin hemen üstü, her ölçümde boşaltılır
+    const SCRATCH_VA: u64 = 0x0000_7E00_0000_0000;
+    const KMEM_PAGE_READ: u32 = 1 << 0;
+    const KMEM_PAGE_WRITE: u32 = 1 << 1;
+
+    const INFO_PROBE: u64 = 0x400; // Ucuz bir karnal_kernel_get_info türü (zamanlayıcı)
+
+    extern "C" {
+        fn low_level_cpu_id() -> u32;
+        fn kmem_phys_alloc_frame() -> u64;
+        fn kmem_phys_free_frame(frame_addr: u64);
+        fn kmem_virt_map_page(vaddr: u64, paddr: u64, flags: u32) -> i64;
+        fn kmem_virt_unmap_page(vaddr: u64) -> i64;
+    }
+
+    // Aynı anda tek takım çalışır; örnekler yığıtta değil burada tutulur
+    static RUNNING: AtomicBool = AtomicBool::new(false);
+    static SAMPLE_BUF: Mutex<[u64; SAMPLES]> = Mutex::new([0; SAMPLES]);
+
+    // Eş iş parçacığı eşgüdümü
+    static STOP: AtomicBool = AtomicBool::new(false);
+    static PARTNER_READY: AtomicBool = AtomicBool::new(false);
+    static PARTNER_DONE: AtomicBool = AtomicBool::new(false);
+
+    // Takımlar arasında yeniden kullanılan nesneler (kanallar ve kilitler silinemez); 0: henüz yok
+    static PING_CHANNEL: AtomicU64 = AtomicU64::new(0);
+    static PONG_CHANNEL: AtomicU64 = AtomicU64::new(0);
+    static BENCH_LOCK_HANDLE: AtomicU64 = AtomicU64::new(0);
+
+    #[cfg(target_arch = "x86_64")]
+    const ARCH: &str = "amd64";
+    #[cfg(target_arch = "aarch64")]
+    const ARCH: &str = "armv9";
+    #[cfg(target_arch = "riscv64")]
+    const ARCH: &str = "rv64g";
+    #[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64", target_arch = "riscv64")))]
+    const ARCH: &str = "other";
+
+    #[cfg(target_arch = "x86_64")]
+    const COUNTER: &str = "tsc";
+    #[cfg(target_arch = "aarch64")]
+    const COUNTER: &str = "cntvct";
+    #[cfg(target_arch = "riscv64")]
+    const COUNTER: &str = "cycle";
+    #[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64", target_arch = "riscv64")))]
+    const COUNTER: &str = "ns";
+
+    /// Mimarinin sayacını okur. Önceki komutlar bitmeden okunmaz.
+    #[inline(always)]
+    fn read_counter() -> u64 {
+        #[cfg(target_arch = "x86_64")]
+        unsafe {
+            core::arch::x86_64::_mm_lfence();
+            core::arch::x86_64::_rdtsc()
+        }
+        #[cfg(target_arch = "aarch64")]
+        {
+            let count: u64;
+            unsafe { core::arch::asm!("isb", "mrs {}, cntvct_el0", out(reg) count) };
+            count
+        }
+        #[cfg(target_arch = "riscv64")]
+        {
+            let count: u64;
+            unsafe { core::arch::asm!("rdcycle {}", out(reg) count) };
+            count
+        }
+        #[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64", target_arch = "riscv64")))]
+        {
+            ktimer::now_ns()
+        }
+    }
+
+    // --- Çıktı ---
+
+    /// Tek bir çıktı satırı; taşan kısım kesilir.
+    struct Line {
+        buf: [u8; 192],
+        len: usize,
+    }
+
+    impl Write for Line {
+        fn write_str(&mut self, s: &str) -> core::fmt::Result {
+            let count = s.len().min(self.buf.len() - self.len);
+            self.buf[self.len..self.len + count].copy_from_slice(&s.as_bytes()[..count]);
+            self.len += count;
+            Ok(())
+        }
+    }
+
+    fn emit(console: &dyn ResourceProvider, args: core::fmt::Arguments) {
+        let mut line = Line { buf: [0; 192], len: 0 };
+        let _ = line.write_str("KBENCH 1 ");
+        let _ = line.write_fmt(args);
+        let _ = line.write_str("\n");
+        let _ = console.write(&line.buf[..line.len], 0);
+    }
+
+    /// Sıralanmış örneklerden yüzdelik (en yakın sıra yöntemi).
+    fn percentile(sorted: &[u64], pct: usize) -> u64 {
+        let rank = (sorted.len() * pct + 99) / 100;
+        sorted[rank.max(1) - 1]
+    }
+
+    /// Her örnekte `op`'u `batch` kez çalıştırır ve sonucu yazar. `reset` her örnekten sonra süre dışında
+    /// çalışır (ör. ayrılanları geri vermek için). `op` hata dönerse ölçüm atlanır.
+    fn measure(
+        console: &dyn ResourceProvider,
+        name: &str,
+        batch: usize,
+        mut op: impl FnMut() -> Result<(), KError>,
+        mut reset: impl FnMut(),
+    ) {
+        let mut samples = SAMPLE_BUF.lock();
+        // Isınma: önbellekler ve dal tahmini
+        for _ in 0..batch {
+            if let Err(err) = op() {
+                reset();
+                emit(console, format_args!("bench={} skipped={}", name, err as i64));
+                return;
+            }
+        }
+        reset();
+        for sample in samples.iter_mut() {
+            let start = read_counter();
+            for _ in 0..batch {
+                if let Err(err) = op() {
+                    reset();
+                    emit(console, format_args!("bench={} skipped={}", name, err as i64));
+                    return;
+                }
+            }
+            *sample = read_counter().wrapping_sub(start) / batch as u64;
+            reset();
+        }
+        samples.sort_unstable();
+        emit(console, format_args!(
+            "bench={} batch={} samples={} min={} p50={} p90={} p99={} max={}",
+            name, batch, SAMPLES, samples[0], percentile(&samples[..], 50), percentile(&samples[..], 90),
+            percentile(&samples[..], 99), samples[SAMPLES - 1],
+        ));
+    }
+
+    // --- Eş İş Parçacıkları ---
+
+    fn start_partner(entry: extern "C" fn(u64), arg: u64, affinity: u64) -> Result<(), KError> {
+        STOP.store(false, Ordering::Relaxed);
+        PARTNER_READY.store(false, Ordering::Relaxed);
+        PARTNER_DONE.store(false, Ordering::Relaxed);
+        ksched::thread_create(entry as usize as u64, 0, arg, affinity)?;
+        while !PARTNER_READY.load(Ordering::Acquire) {
+            ksched::yield_now()?;
+        }
+        Ok(())
+    }
+
+    /// Eşi durdurur ve çıkmasını bekler. `wake` bloklu bir eşi bir kez uyandırır.
+    fn stop_partner(wake: impl FnOnce()) {
+        STOP.store(true, Ordering::Release);
+        wake();
+        while !PARTNER_DONE.load(Ordering::Acquire) {
+            let _ = ksched::yield_now();
+        }
+    }
+
+    // Gelen her mesajı diğer kanaldan geri gönderir
+    extern "C" fn echo_partner(_arg: u64) {
+        let ping = PING_CHANNEL.load(Ordering::Relaxed);
+        let pong = PONG_CHANNEL.load(Ordering::Relaxed);
+        let mut message = [0u8; 8];
+        PARTNER_READY.store(true, Ordering::Release);
+        while kmessaging::receive(ping, message.as_mut_ptr(), message.len()).is_ok() && !STOP.load(Ordering::Acquire) {
+            if kmessaging::send(pong, message.as_ptr(), message.len()).is_err() {
+                break;
+            }
+        }
+        PARTNER_DONE.store(true, Ordering::Release);
+    }
+
+    // Durdurulana kadar kilidi alıp bırakır (başka CPU'da)
+    extern "C" fn lock_partner(lock: u64) {
+        PARTNER_READY.store(true, Ordering::Release);
+        while !STOP.load(Ordering::Acquire) {
+            if ksync::lock_acquire(lock).is_err() {
+                break;
+            }
+            let _ = ksync::lock_release(lock);
+        }
+        PARTNER_DONE.store(true, Ordering::Release);
+    }
+
+    // Durdurulana kadar CPU'yu geri verir (aynı CPU'da)
+    extern "C" fn yield_partner(_arg: u64) {
+        PARTNER_READY.store(true, Ordering::Release);
+        while !STOP.load(Ordering::Acquire) {
+            let _ = ksched::yield_now();
+        }
+        PARTNER_DONE.store(true, Ordering::Release);
+    }
+
+    fn cached(slot: &AtomicU64, create: impl FnOnce() -> Result<u64, KError>) -> Result<u64, KError> {
+        match slot.load(Ordering::Acquire) {
+            0 => {
+                let handle = create()?;
+                slot.store(handle, Ordering::Release);
+                Ok(handle)
+            }
+            handle => Ok(handle),
+        }
+    }
+
+    // --- Ölçümler ---
+
+    fn bench_messaging(console: &dyn ResourceProvider) {
+        let channels = cached(&PING_CHANNEL, || kmessaging::create_channel().map(|h| h.0))
+            .and_then(|ping| cached(&PONG_CHANNEL, || kmessaging::create_channel().map(|h| h.0)).map(|pong| (ping, pong)));
+        let (ping, pong) = match channels.and_then(|c| start_partner(echo_partner, 0, 0).map(|_| c)) {
+            Ok(c) => c,
+            Err(err) => {
+                emit(console, format_args!("bench=messaging_roundtrip skipped={}", err as i64));
+                return;
+            }
+        };
+        let mut message = [0u8; 8];
+        measure(console, "messaging_roundtrip", 1, || {
+            kmessaging::send(ping, message.as_ptr(), message.len())?;
+            kmessaging::receive(pong, message.as_mut_ptr(), message.len()).map(|_| ())
+        }, || {});
+        // Eş receive'de bloklu: son mesaj onu uyandırır, STOP'u görüp yanıtlamadan çıkar
+        stop_partner(|| { let _ = kmessaging::send(ping, message.as_ptr(), message.len()); });
+    }
+
+    fn bench_lock(console: &dyn ResourceProvider, cpu: u32) {
+        let lock = match cached(&BENCH_LOCK_HANDLE, || ksync::lock_create().map(|h| h.0)) {
+            Ok(lock) => lock,
+            Err(err) => {
+                emit(console, format_args!("bench=lock_uncontended skipped={}", err as i64));
+                return;
+            }
+        };
+        let op = || {
+            ksync::lock_acquire(lock)?;
+            ksync::lock_release(lock)
+        };
+        measure(console, "lock_uncontended", MAX_BATCH, op, || {});
+
+        // Eş, çalışan CPU dışındaki ilk çevrimiçi CPU'ya sabitlenir
+        let others = ksched::online_cpus() & !(1u64 << cpu);
+        if others == 0 {
+            emit(console, format_args!("bench=lock_contended skipped={}", KError::NotSupported as i64));
+            return;
+        }
+        if let Err(err) = start_partner(lock_partner, lock, 1u64 << others.trailing_zeros()) {
+            emit(console, format_args!("bench=lock_contended skipped={}", err as i64));
+            return;
+        }
+        measure(console, "lock_contended", MAX_BATCH, op, || {});
+        stop_partner(|| {});
+    }
+
+    fn bench_frame(console: &dyn ResourceProvider) {
+        let mut frames = [0u64; MAX_BATCH];
+        let frames = Cell::from_mut(&mut frames[..]).as_slice_of_cells();
+        let next = Cell::new(0usize);
+        // Ayırma ölçülür; örnek başına ayrılan frame'ler süre dışında geri verilir
+        measure(console, "frame_alloc", MAX_BATCH, || {
+            let frame = unsafe { kmem_phys_alloc_frame() };
+            if frame == 0 {
+                return Err(KError::OutOfMemory);
+            }
+            frames[next.get()].set(frame);
+            next.set(next.get() + 1);
+            Ok(())
+        }, || {
+            for frame in frames[..next.get()].iter() {
+                unsafe { kmem_phys_free_frame(frame.get()) };
+            }
+            next.set(0);
+        });
+        measure(console, "frame_alloc_free", MAX_BATCH, || {
+            let frame = unsafe { kmem_phys_alloc_frame() };
+            if frame == 0 {
+                return Err(KError::OutOfMemory);
+            }
+            unsafe { kmem_phys_free_frame(frame) };
+            Ok(())
+        }, || {});
+    }
+
+    fn bench_map(console: &dyn ResourceProvider) {
+        let frame = unsafe { kmem_phys_alloc_frame() };
+        if frame == 0 {
+            emit(console, format_args!("bench=map_unmap_page skipped={}", KError::OutOfMemory as i64));
+            return;
+        }
+        // Eşleme + kaldırma (TLB geçersizleştirme dahil) birlikte ölçülür: adres her turda yeniden kullanılır
+        measure(console, "map_unmap_page", 1, || {
+            if unsafe { kmem_virt_map_page(SCRATCH_VA, frame, KMEM_PAGE_READ | KMEM_PAGE_WRITE) } != 0 {
+                return Err(KError::OutOfMemory);
+            }
+            if unsafe { kmem_virt_unmap_page(SCRATCH_VA) } != 0 {
+                return Err(KError::InternalError);
+            }
+            Ok(())
+        }, || {});
+        unsafe { kmem_phys_free_frame(frame) };
+    }
+
+    fn bench_switch(console: &dyn ResourceProvider, cpu: u32) {
+        // Eş ile aynı CPU: her yield_now diğerine geçip geri gelir (iki bağlam değişimi)
+        if let Err(err) = start_partner(yield_partner, 0, 1u64 << cpu) {
+            emit(console, format_args!("bench=switch_roundtrip skipped={}", err as i64));
+            return;
+        }
+        measure(console, "switch_roundtrip", 1, ksched::yield_now, || {});
+        stop_partner(|| {});
+    }
+
+    /// `mask` ile seçilen ölçümleri çalıştırır ve sonuçları konsola yazar. Ölçüm süresince çalışan iş
+    /// parçacığı bulunduğu CPU'ya sabitlenir. Takım CPU'yu uzun süre tutar ve çekirdek nesneleri ayırır;
+    /// yalnızca ayrıcalıklı görevler (ksched::current_task_privileged) çalıştırabilir.
+    pub fn run(mask: u32) -> Result<(), KError> {
+        if !COMPILED {
+            return Err(KError::NotSupported);
+        }
+        if !ksched::current_task_privileged() {
+            return Err(KError::PermissionDenied);
+        }
+        if mask == 0 || mask & !BENCH_ALL != 0 {
+            return Err(KError::InvalidArgument);
+        }
+        let me = ksched::current_thread()?;
+        let console = kresource::lookup_provider_by_name("karnal://device/console")?;
+        if RUNNING.swap(true, Ordering::Acquire) {
+            return Err(KError::Busy);
+        }
+        let cpu = unsafe { low_level_cpu_id() };
+        let _ = ksched::set_affinity(me, 1u64 << cpu);
+        let _ = ksched::yield_now(); // Sabitleme bir sonraki kuyruğa girişte geçerli olur
+
+        let console = &*console;
+        let start_counter = read_counter();
+        let start_ns = ktimer::now_ns();
+        emit(console, format_args!("arch={} counter={} cpus={}", ARCH, COUNTER, ksched::online_cpus().count_ones()));
+
+        if mask & BENCH_SYSCALL != 0 {
+            measure(console, "syscall_dispatch", MAX_BATCH, || {
+                if ksyscall::dispatch(ksyscall::SYSCALL_GET_KERNEL_INFO, INFO_PROBE, 0, 0, 0, 0) < 0 {
+                    return Err(KError::InternalError);
+                }
+                Ok(())
+            }, || {});
+        }
+        if mask & BENCH_MESSAGING != 0 {
+            bench_messaging(console);
+        }
+        if mask & BENCH_LOCK != 0 {
+            bench_lock(console, cpu);
+        }
+        if mask & BENCH_FRAME != 0 {
+            bench_frame(console);
+        }
+        if mask & BENCH_MAP != 0 {
+            bench_map(console);
+        }
+        if mask & BENCH_SWITCH != 0 {
+            bench_switch(console, cpu);
+        }
+
+        let elapsed_ns = ktimer::now_ns().saturating_sub(start_ns).max(1);
+        let ticks = read_counter().wrapping_sub(start_counter);
+        let hz = (ticks as u128 * 1_000_000_000 / elapsed_ns as u128) as u64;
+        emit(console, format_args!("end hz={}", hz));
+
+        let _ = ksched::set_affinity(me, 0);
+        RUNNING.store(false, Ordering::Release);
+        Ok(())
+    }
+
+    // --- C API ---
+
+    #[no_mangle]
+    pub extern "C" fn karnal_bench_run(mask: u32) -> i64 {
+        match run(mask) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+}
@@ -0,0 +1,305 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, kregistry, kresource, ksched, ktimer, ktlb};
+
+// --- Paralel SMP Açılışı ve Ertelenmiş Provider Başlatma ---
+// Alt sistem başlatması (karnal_init) sıralı bir çağrı listesi yerine küçük bir bağımlılık grafiğidir:
+// her adım, bağımlı olduğu adımlar bitince hazır olur. Önyükleme CPU'su ikincil CPU'ları grafiği
+// çalıştırmadan hemen önce açar; açılan her CPU zamanlayıcıya katılmadan önce grafiğe yardım eder.
+// - Hazır bir adımı ilk sahiplenen CPU (CLAIMED maskesinde atomik bit) çalıştırır, bitince DONE'a işaretler.
+// - Önyükleme CPU'su tüm adımlar bitene kadar karnal_init'ten dönmez; dönüşte sıra (provider kaydı,
+//   init görevi) eskisi gibidir. İkincil CPU yoksa grafik önyükleme CPU'sunda bağımlılık sırasıyla çalışır.
+// - Adımlar CPU'ya özel durum kurmamalıdır (hangi CPU'da çalışacağı belli değildir); CPU başına kurulum
+//   (sistem çağrısı girişi vb.) her CPU'nun kendi açılış yolunda yapılır.
+//
+// Açılışta gerekmeyen provider'lar kaydedilmek yerine ertelenir (register_lazy): isim ilk
+// karnal_resource_acquire'da kayıt defterinde bulunamazsa başlatma fonksiyonu bir kez çalışır, provider'ı
+// kaydeder ve arama tekrarlanır. Aynı anda gelen diğer edinenler başlatmanın bitmesini bekler.
+
+pub mod kboot {
+    use super::*;
+    use core::sync::atomic::{AtomicPtr, AtomicU32, AtomicU64, AtomicU8, AtomicUsize, Ordering};
+    use spin::Mutex;
+
+    /// Grafikte en fazla adım (CLAIMED/DONE maskelerinin genişliği)
+    pub const MAX_STEPS: usize = 64;
+    /// En fazla ertelenmiş provider
+    pub const MAX_LAZY: usize = 64;
+
+    extern "C" {
+        fn low_level_start_secondary_cpus() -> u32;
+        fn low_level_syscall_init();
+        fn low_level_mmu_cpu_init();
+        fn low_level_ipi_init();
+    }
+
+    /// Başlatma grafiğinin bir adımı. `deps` aynı tablodaki adımların dizinleridir.
+    pub struct Step {
+        pub name: &'static str,
+        pub deps: &'static [usize],
+        pub run: fn(),
+    }
+
+    static STEPS: AtomicPtr<Step> = AtomicPtr::new(core::ptr::null_mut());
+    static STEP_COUNT: AtomicUsize = AtomicUsize::new(0);
+    // Adımların bağımlılık maskeleri (run içinde bir kez hesaplanır)
+    static DEP_MASKS: [AtomicU64; MAX_STEPS] = [const { AtomicU64::new(0) }; MAX_STEPS];
+    static CLAIMED: AtomicU64 = AtomicU64::new(0);
+    static DONE: AtomicU64 = AtomicU64::new(0);
+
+    // İstatistikler: KARNAL_INFO_BOOT_* ile dışarı verilir.
+    static GRAPH_NS: AtomicU64 = AtomicU64::new(0);
+    static STEP_NS: [AtomicU64; MAX_STEPS] = [const { AtomicU64::new(0) }; MAX_STEPS];
+    static CPUS_JOINED: AtomicU64 = AtomicU64::new(0);
+    static LAZY_INITS: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_BOOT_* ile EŞLEŞMELİDİR)
+    pub const INFO_BOOT_GRAPH_NS: u32 = 0xE00;
+    pub const INFO_BOOT_CPUS_JOINED: u32 = 0xE01;
+    pub const INFO_BOOT_LAZY_INITS: u32 = 0xE02;
+    // 0xE40 | adım dizini
+    pub const INFO_BOOT_STEP_NS_BASE: u32 = 0xE40;
+
+    /// `kkernel::get_info` için: açılış istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_BOOT_GRAPH_NS => Some(GRAPH_NS.load(Ordering::Relaxed)),
+            INFO_BOOT_CPUS_JOINED => Some(CPUS_JOINED.load(Ordering::Relaxed)),
+            INFO_BOOT_LAZY_INITS => Some(LAZY_INITS.load(Ordering::Relaxed)),
+            t if t >= INFO_BOOT_STEP_NS_BASE && t < INFO_BOOT_STEP_NS_BASE + MAX_STEPS as u32 => {
+                Some(STEP_NS[(t - INFO_BOOT_STEP_NS_BASE) as usize].load(Ordering::Relaxed))
+            }
+            _ => None,
+        }
+    }
+
+    fn steps() -> &'static [Step] {
+        let ptr = STEPS.load(Ordering::Acquire);
+        if ptr.is_null() {
+            return &[];
+        }
+        unsafe { core::slice::from_raw_parts(ptr, STEP_COUNT.load(Ordering::Relaxed)) }
+    }
+
+    fn all_mask(count: usize) -> u64 {
+        if count == MAX_STEPS { u64::MAX } else { (1u64 << count) - 1 }
+    }
+
+    /// Grafik bitene kadar hazır adımları sahiplenip çalıştırır. Grafik yayınlanmadıysa veya bittiyse hemen döner.
+    pub fn participate() {
+        let steps = steps();
+        let all = all_mask(steps.len());
+        CPUS_JOINED.fetch_add(1, Ordering::Relaxed);
+        loop {
+            // Acquire: biten adımların yazdıkları, onlara bağımlı adımı çalıştıran CPU'ya görünür
+            let done = DONE.load(Ordering::Acquire);
+            if done & all == all {
+                return;
+            }
+            let claimed = CLAIMED.load(Ordering::Relaxed);
+            let ready = (0..steps.len()).find(|&i| {
+                claimed & (1 << i) == 0 && DEP_MASKS[i].load(Ordering::Relaxed) & !done == 0
+            });
+            let index = match ready {
+                Some(index) => index,
+                None => {
+                    // Kalan adımlar diğer CPU'larda çalışıyor veya onları bekliyor. Kesmeler kapalı
+                    // olduğundan bu CPU'yu hedefleyen shootdown'lar burada uygulanır.
+                    ktlb::service_pending();
+                    core::hint::spin_loop();
+                    continue;
+                }
+            };
+            if CLAIMED.fetch_or(1 << index, Ordering::AcqRel) & (1 << index) != 0 {
+                continue; // Başka bir CPU önce sahiplendi
+            }
+            let start = ktimer::now_ns();
+            (steps[index].run)();
+            STEP_NS[index].store(ktimer::now_ns() - start, Ordering::Relaxed);
+            DONE.fetch_or(1 << index, Ordering::Release);
+        }
+    }
+
+    /// Grafiği yayınlar, ikincil CPU'ları açar ve tüm adımlar bitene kadar çalışmaya katılır.
+    /// Önyükleme CPU'sunda, yığın (heap) hazır olduktan sonra bir kez çağrılır.
+    pub fn run(steps: &'static [Step]) -> Result<(), KError> {
+        if steps.len() > MAX_STEPS {
+            return Err(KError::InvalidArgument);
+        }
+        for (i, step) in steps.iter().enumerate() {
+            let mut mask = 0u64;
+            for &dep in step.deps {
+                // Yalnızca önceki adımlara bağımlılık: döngü kurulamaz
+                if dep >= i {
+                    return Err(KError::InvalidArgument);
+                }
+                mask |= 1 << dep;
+            }
+            DEP_MASKS[i].store(mask, Ordering::Relaxed);
+        }
+        STEP_COUNT.store(steps.len(), Ordering::Relaxed);
+        // Release: maskeler ve adım sayısı işaretçiyi gören CPU'ya görünür
+        STEPS.store(steps.as_ptr() as *mut Step, Ordering::Release);
+
+        let start = ktimer::now_ns();
+        ksched::fpu_cpu_init();
+        unsafe { low_level_start_secondary_cpus() };
+        participate();
+        GRAPH_NS.store(ktimer::now_ns() - start, Ordering::Relaxed);
+        Ok(())
+    }
+
+    /// İkincil CPU girişi (hardware_specific.h). Mimari kod CPU'nun kendi yığıtını, MMU'sunu ve kesme
+    /// denetleyicisinin CPU'ya özel kısmını kurduktan sonra, kesmeler kapalıyken çağırır. Geri dönmez.
+    #[no_mangle]
+    pub extern "C" fn karnal_secondary_start(cpu: u32) -> ! {
+        // PCID gibi CPU'ya özel MMU ayarları önyükleme CPU'suyla aynı olmalı: adım çalıştırmadan önce
+        unsafe { low_level_mmu_cpu_init() };
+        unsafe { low_level_syscall_init() };
+        // Adımlar ve zamanlayıcı FPU alan boyutunu ve kapalı FPU'yu varsayar
+        ksched::fpu_cpu_init();
+        // IPI vektörü bu CPU'da kurulmadan açık işaretlenirse shootdown'lar yanıtsız kalır ve
+        // TlbBatch::flush sonsuza dek bekler.
+        unsafe { low_level_ipi_init() };
+        // Bu noktadan sonra TLB shootdown IPI'ları bu CPU'ya da gönderilir
+        ktlb::set_cpu_online(cpu);
+        participate();
+        ksched::karnal_scheduler_start()
+    }
+
+    // --- Ertelenmiş Provider'lar ---
+
+    /// Ertelenmiş provider'ın başlatıcısı: provider'ı `kregistry::register` ile aynı isimle kaydetmelidir.
+    #[derive(Copy, Clone)]
+    enum LazyInit {
+        Rust(fn() -> Result<(), KError>),
+        C(extern "C" fn(*mut core::ffi::c_void) -> i64, *mut core::ffi::c_void),
+    }
+
+    impl LazyInit {
+        fn call(self) -> Result<(), KError> {
+            match self {
+                LazyInit::Rust(init) => init(),
+                LazyInit::C(init, data) => {
+                    let ret = init(data);
+                    if ret >= 0 { Ok(()) } else { Err(kresource::kerror_from_i64(ret)) }
+                }
+            }
+        }
+    }
+
+    const LAZY_EMPTY: u8 = 0;
+    const LAZY_PENDING: u8 = 1;
+    const LAZY_RUNNING: u8 = 2;
+    const LAZY_DONE: u8 = 3;
+
+    #[derive(Copy, Clone)]
+    struct LazyEntry {
+        // İsim kayıt süresince geçerli kalır (statik dizgi)
+        name: *const u8,
+        name_len: usize,
+        init: Option<LazyInit>,
+    }
+
+    struct LazyTable {
+        entries: [LazyEntry; MAX_LAZY],
+    }
+
+    // Ham işaretçiler yalnızca tablo kilidi altında okunur
+    unsafe impl Send for LazyTable {}
+
+    static LAZY: Mutex<LazyTable> = Mutex::new(LazyTable {
+        entries: [LazyEntry { name: core::ptr::null(), name_len: 0, init: None }; MAX_LAZY],
+    });
+    static LAZY_STATE: [AtomicU8; MAX_LAZY] = [const { AtomicU8::new(LAZY_EMPTY) }; MAX_LAZY];
+    static LAZY_COUNT: AtomicU32 = AtomicU32::new(0);
+
+    impl LazyEntry {
+        fn name(&self) -> &'static [u8] {
+            unsafe { core::slice::from_raw_parts(self.name, self.name_len) }
+        }
+    }
+
+    fn add_lazy(name: &'static [u8], init: LazyInit) -> Result<(), KError> {
+        if name.is_empty() {
+            return Err(KError::InvalidArgument);
+        }
+        if kregistry::lookup(name).is_ok() {
+            return Err(KError::AlreadyExists);
+        }
+        let mut table = LAZY.lock();
+        let count = LAZY_COUNT.load(Ordering::Relaxed) as usize;
+        if table.entries[..count].iter().any(|e| e.name() == name) {
+            return Err(KError::AlreadyExists);
+        }
+        if count == MAX_LAZY {
+            return Err(KError::OutOfMemory);
+        }
+        table.entries[count] = LazyEntry { name: name.as_ptr(), name_len: name.len(), init: Some(init) };
+        LAZY_STATE[count].store(LAZY_PENDING, Ordering::Relaxed);
+        LAZY_COUNT.store(count as u32 + 1, Ordering::Release);
+        Ok(())
+    }
+
+    /// `name`'i ilk edinmede `init` ile kaydedilecek şekilde erteler.
+    pub fn register_lazy(name: &'static [u8], init: fn() -> Result<(), KError>) -> Result<(), KError> {
+        add_lazy(name, LazyInit::Rust(init))
+    }
+
+    /// Kayıt defterinde bulunamayan `name` ertelenmişse başlatıcısını (bir kez) çalıştırır.
+    /// Başlatma başka bir iş parçacığında sürüyorsa bitmesini bekler. Ertelenmiş değilse NotFound döner;
+    /// başlatıcı başarısız olursa kayıt bekler durumda kalır ve sonraki edinme yeniden dener.
+    pub fn resolve_lazy(name: &[u8]) -> Result<(), KError> {
+        if LAZY_COUNT.load(Ordering::Acquire) == 0 {
+            return Err(KError::NotFound);
+        }
+        loop {
+            let (index, init) = {
+                let table = LAZY.lock();
+                let count = LAZY_COUNT.load(Ordering::Relaxed) as usize;
+                let index = table.entries[..count].iter().position(|e| e.name() == name).ok_or(KError::NotFound)?;
+                (index, table.entries[index].init)
+            };
+            let state = &LAZY_STATE[index];
+            match state.compare_exchange(LAZY_PENDING, LAZY_RUNNING, Ordering::Acquire, Ordering::Acquire) {
+                Ok(_) => {
+                    let result = init.ok_or(KError::InternalError).and_then(LazyInit::call);
+                    // Release: kayıt defterine eklenen provider, DONE'ı gören bekleyene görünür
+                    state.store(if result.is_ok() { LAZY_DONE } else { LAZY_PENDING }, Ordering::Release);
+                    if result.is_ok() {
+                        LAZY_INITS.fetch_add(1, Ordering::Relaxed);
+                    }
+                    return result;
+                }
+                Err(LAZY_DONE) => return Ok(()),
+                Err(_) => {
+                    // Başka bir iş parçacığı başlatıyor (başlatıcı uyuyabilir)
+                    let _ = ksched::yield_now();
+                }
+            }
+        }
+    }
+
+    // --- C API ---
+
+    #[no_mangle]
+    pub extern "C" fn karnal_resource_register_lazy(
+        id_ptr: *const u8,
+        id_len: usize,
+        init_fn: Option<extern "C" fn(*mut core::ffi::c_void) -> i64>,
+        data: *mut core::ffi::c_void,
+    ) -> i64 {
+        let init_fn = match init_fn {
+            Some(init_fn) if !id_ptr.is_null() => init_fn,
+            _ => return KError::InvalidArgument as i64,
+        };
+        // Kimlik çağıranın statik belleğindedir (karnal.h)
+        let name: &'static [u8] = unsafe { core::slice::from_raw_parts(id_ptr, id_len) };
+        match add_lazy(name, LazyInit::C(init_fn, data)) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+}
@@ -0,0 +1,471 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli modüller
+use super::kconsole;
+
+// --- Buddy Fiziksel Frame Ayırıcı ---
+// kernel_memory.h'deki kmem_phys_* fonksiyonlarının implementasyonu.
+// Fiziksel bellek boot sırasında kmem_phys_add_region ile bölgeler halinde eklenir.
+// Bölgeler zone sınırlarında (DMA < 16 MiB, DMA32 < 4 GiB, NORMAL) bölünür.
+// Her zone'un her order için ayrı bir boş blok listesi vardır. Bir order-k blok 2^k frame uzunluğundadır
+// ve fiziksel olarak 2^k frame'e hizalıdır. Bu yüzden bloğun eşi (buddy) pfn ^ 2^k ile bulunur.
+// Bölme (split) ve birleştirme (merge) en fazla MAX_ORDER adım sürer: O(log n).
+//
+// Boş bloklar, ilk frame'lerine yazılan düğümlerle çift yönlü listeye bağlanır
+// (fiziksel bellek kimlik haritalı olduğu varsayılır). Her frame için bir byte meta veri tutulur.
+// Meta veri dizisi bölgenin başından ayrılır.
+//
+// Tek frame tahsisleri (order 0) CPU başına küçük bir frame önbelleğinden karşılanır.
+// Zone kilidine yalnızca önbellek boşaldığında veya dolduğunda, PCP_BATCH frame'lik gruplar halinde gidilir.
+// Önbellek kesmeler kapalıyken kilitlenir (kesme bağlamındaki bir tahsis aynı CPU'da kilidi beklemesin).
+// Önbellekteki frame'lerin meta veri byte'ı META_CACHED'dir: önbelleğe bırakma zone kilidi almadan
+// META_ALLOCATED -> META_CACHED geçişini yapar, böylece çift serbest bırakma önbellekte de yakalanır.
+// Geçersiz veya çift serbest bırakmalar reddedilir, sayılır (KARNAL_INFO_PHYS_BAD_FREES) ve konsola yazılır.
+
+pub mod kbuddy {
+    use super::*;
+    use core::ptr;
+    use core::sync::atomic::{AtomicU64, AtomicU8, AtomicUsize, Ordering};
+    use spin::Mutex;
+
+    /// En büyük blok: 2^MAX_ORDER frame (4 MiB). Order 9 = 2 MiB büyük sayfa.
+    pub const MAX_ORDER: usize = 10;
+
+    // Zone numaraları (kernel_memory.h'deki KMEM_ZONE_* ile EŞLEŞMELİDİR)
+    pub const ZONE_DMA: u32 = 0;
+    pub const ZONE_DMA32: u32 = 1;
+    pub const ZONE_NORMAL: u32 = 2;
+    const NUM_ZONES: usize = 3;
+    // Zone'ların üst sınırları (hariç)
+    const ZONE_LIMITS: [u64; NUM_ZONES] = [16 << 20, 4 << 30, u64::MAX];
+
+    const PAGE_SHIFT: u32 = 12;
+    const PAGE_SIZE: u64 = 1 << PAGE_SHIFT; // KERNEL_PAGE_SIZE
+    // Zone başına en fazla bölge sayısı
+    const MAX_REGIONS: usize = 16;
+    // CPU başına frame önbelleği tutulan en fazla CPU sayısı
+    const MAX_CPUS: usize = 32;
+    // CPU önbelleği ile zone arasında bir seferde taşınan frame sayısı
+    const PCP_BATCH: usize = 16;
+    const PCP_HIGH: usize = 2 * PCP_BATCH;
+
+    // Frame meta veri byte'ı
+    const META_FREE: u8 = 0x80;      // Boş bir bloğun ilk frame'i
+    const META_ALLOCATED: u8 = 0x40; // Tahsis edilmiş bir bloğun ilk frame'i
+    const META_CACHED: u8 = 0x20;    // CPU önbelleğinde bekleyen order-0 frame
+    const META_ORDER_MASK: u8 = 0x1F;
+
+    const NIL: u64 = u64::MAX;
+
+    extern "C" {
+        fn low_level_cpu_id() -> u32;
+        fn low_level_interrupt_save() -> u64;
+        fn low_level_interrupt_restore(state: u64);
+    }
+
+    // İstatistikler: KARNAL_INFO_PHYS_* ile dışarı verilir.
+    static BAD_FREES: AtomicU64 = AtomicU64::new(0);
+    static LAST_BAD_FREE: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_PHYS_* ile EŞLEŞMELİDİR)
+    pub const INFO_PHYS_BAD_FREES: u32 = 0xC30;
+    pub const INFO_PHYS_LAST_BAD_FREE: u32 = 0xC31;
+
+    /// `kkernel::get_info` için: frame ayırıcı istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_PHYS_BAD_FREES => Some(BAD_FREES.load(Ordering::Relaxed)),
+            INFO_PHYS_LAST_BAD_FREE => Some(LAST_BAD_FREE.load(Ordering::Relaxed)),
+            _ => None,
+        }
+    }
+
+    // Boş bloğun ilk frame'ine yazılan liste düğümü (pfn değerleri tutar)
+    #[repr(C)]
+    struct FreeNode {
+        next: u64,
+        prev: u64,
+    }
+
+    #[inline]
+    fn node(pfn: u64) -> *mut FreeNode {
+        (pfn << PAGE_SHIFT) as *mut FreeNode
+    }
+
+    #[derive(Clone, Copy)]
+    struct Region {
+        start_pfn: u64, // İlk kullanılabilir frame (meta veri sayfalarından sonra)
+        end_pfn: u64,   // Hariç
+        meta: u64,      // Meta veri dizisinin adresi (frame başına bir byte)
+    }
+
+    impl Region {
+        const EMPTY: Region = Region { start_pfn: 0, end_pfn: 0, meta: 0 };
+
+        fn contains(&self, pfn: u64, order: usize) -> bool {
+            pfn >= self.start_pfn && pfn + (1u64 << order) <= self.end_pfn
+        }
+
+        // Meta veri byte'ları atomik erişilir: CPU önbelleği yolu onları zone kilidi almadan değiştirir.
+        unsafe fn meta(&self, pfn: u64) -> &'static AtomicU8 {
+            &*((self.meta + (pfn - self.start_pfn)) as *const AtomicU8)
+        }
+    }
+
+    struct Zone {
+        free_heads: [u64; MAX_ORDER + 1],
+        free_frames: u64,
+        regions: [Region; MAX_REGIONS],
+        region_count: usize,
+    }
+
+    impl Zone {
+        const EMPTY: Zone = Zone {
+            free_heads: [NIL; MAX_ORDER + 1],
+            free_frames: 0,
+            regions: [Region::EMPTY; MAX_REGIONS],
+            region_count: 0,
+        };
+
+        fn region_of(&self, pfn: u64, order: usize) -> Option<Region> {
+            self.regions[..self.region_count].iter().copied().find(|r| r.contains(pfn, order))
+        }
+
+        unsafe fn push(&mut self, region: &Region, pfn: u64, order: usize) {
+            let head = self.free_heads[order];
+            ptr::write(node(pfn), FreeNode { next: head, prev: NIL });
+            if head != NIL {
+                (*node(head)).prev = pfn;
+            }
+            self.free_heads[order] = pfn;
+            region.meta(pfn).store(META_FREE | order as u8, Ordering::Relaxed);
+            self.free_frames += 1 << order;
+        }
+
+        unsafe fn remove(&mut self, region: &Region, pfn: u64, order: usize) {
+            let FreeNode { next, prev } = ptr::read(node(pfn));
+            if prev != NIL { (*node(prev)).next = next; } else { self.free_heads[order] = next; }
+            if next != NIL { (*node(next)).prev = prev; }
+            region.meta(pfn).store(0, Ordering::Relaxed);
+            self.free_frames -= 1 << order;
+        }
+
+        /// Order-`order` bir blok tahsis eder; gerekirse daha büyük bir bloğu ikiye bölerek.
+        unsafe fn alloc(&mut self, order: usize) -> Option<u64> {
+            let found = (order..=MAX_ORDER).find(|&o| self.free_heads[o] != NIL)?;
+            let pfn = self.free_heads[found];
+            let region = self.region_of(pfn, found)?;
+            self.remove(&region, pfn, found);
+
+            // Fazla yarıları daha küçük listelere geri koy
+            for split in (order..found).rev() {
+                self.push(&region, pfn + (1u64 << split), split);
+            }
+            region.meta(pfn).store(META_ALLOCATED | order as u8, Ordering::Relaxed);
+            Some(pfn)
+        }
+
+        /// Bloğu serbest bırakır ve eşi boş oldukça birleştirir.
+        unsafe fn free(&mut self, pfn: u64, order: usize) -> bool {
+            let region = match self.region_of(pfn, order) {
+                Some(region) => region,
+                None => return false,
+            };
+            // Çift serbest bırakma veya yanlış order'a karşı koruma
+            if region.meta(pfn).load(Ordering::Relaxed) != META_ALLOCATED | order as u8 {
+                return false;
+            }
+            region.meta(pfn).store(0, Ordering::Relaxed);
+
+            let mut pfn = pfn;
+            let mut order = order;
+            while order < MAX_ORDER {
+                let buddy = pfn ^ (1u64 << order);
+                if !region.contains(buddy, order) || region.meta(buddy).load(Ordering::Relaxed) != META_FREE | order as u8 {
+                    break;
+                }
+                self.remove(&region, buddy, order);
+                pfn = pfn.min(buddy);
+                order += 1;
+            }
+            self.push(&region, pfn, order);
+            true
+        }
+
+        /// [start_pfn, end_pfn) aralığını zone'a ekler. Aralık tek bir zone içinde olmalıdır.
+        /// Eklenen bölgeyi döner; bölge tablosu dolduysa veya aralık meta veriye yetmiyorsa None.
+        unsafe fn add_range(&mut self, start_pfn: u64, end_pfn: u64) -> Option<Region> {
+            if self.region_count == MAX_REGIONS { return None; }
+
+            // Her frame için bir byte meta veri, aralığın başından ayrılır
+            let frames = end_pfn - start_pfn;
+            let meta_pages = (frames + PAGE_SIZE - 1) / PAGE_SIZE;
+            if frames <= meta_pages { return None; }
+            let region = Region { start_pfn: start_pfn + meta_pages, end_pfn, meta: start_pfn << PAGE_SHIFT };
+            ptr::write_bytes(region.meta as *mut u8, 0, (region.end_pfn - region.start_pfn) as usize);
+            self.regions[self.region_count] = region;
+            self.region_count += 1;
+
+            // Aralığı en büyük hizalı bloklara ayırarak listelere koy
+            let mut pfn = region.start_pfn;
+            while pfn < region.end_pfn {
+                let mut order = MAX_ORDER;
+                while order > 0 && (pfn & ((1u64 << order) - 1) != 0 || pfn + (1u64 << order) > region.end_pfn) {
+                    order -= 1;
+                }
+                self.push(&region, pfn, order);
+                pfn += 1u64 << order;
+            }
+            Some(region)
+        }
+    }
+
+    static ZONES: [Mutex<Zone>; NUM_ZONES] = [Mutex::new(Zone::EMPTY), Mutex::new(Zone::EMPTY), Mutex::new(Zone::EMPTY)];
+
+    // CPU başına order-0 frame önbelleği
+    #[repr(C, align(64))]
+    struct PcpCache {
+        frames: [u64; PCP_HIGH],
+        count: usize,
+    }
+
+    const PCP_INIT: Mutex<PcpCache> = Mutex::new(PcpCache { frames: [0; PCP_HIGH], count: 0 });
+    static PCP: [Mutex<PcpCache>; MAX_CPUS] = [PCP_INIT; MAX_CPUS];
+
+    // Genel zone bölgelerinin kilitsiz okunan kopyası: önbellek yolu frame'in meta veri byte'ına zone
+    // kilidi almadan ulaşır. Bölgeler yalnızca eklenir; sayaç girdi yazıldıktan sonra Release ile artırılır.
+    struct PublishedRegion {
+        start_pfn: AtomicU64,
+        end_pfn: AtomicU64,
+        meta: AtomicU64,
+    }
+
+    const MAX_PUBLISHED: usize = NUM_ZONES * MAX_REGIONS;
+    const PUBLISHED_INIT: PublishedRegion =
+        PublishedRegion { start_pfn: AtomicU64::new(0), end_pfn: AtomicU64::new(0), meta: AtomicU64::new(0) };
+    static PUBLISHED: [PublishedRegion; MAX_PUBLISHED] = [PUBLISHED_INIT; MAX_PUBLISHED];
+    static PUBLISHED_COUNT: AtomicUsize = AtomicUsize::new(0);
+    static PUBLISH_LOCK: Mutex<()> = Mutex::new(());
+
+    fn publish_region(region: &Region) {
+        let _guard = PUBLISH_LOCK.lock();
+        let index = PUBLISHED_COUNT.load(Ordering::Relaxed);
+        if index == MAX_PUBLISHED { return; }
+        let entry = &PUBLISHED[index];
+        entry.start_pfn.store(region.start_pfn, Ordering::Relaxed);
+        entry.end_pfn.store(region.end_pfn, Ordering::Relaxed);
+        entry.meta.store(region.meta, Ordering::Relaxed);
+        PUBLISHED_COUNT.store(index + 1, Ordering::Release);
+    }
+
+    // Genel zone'lardaki bir frame'in meta veri byte'ı; frame hiçbir bölgede değilse None.
+    fn frame_meta(addr: u64) -> Option<&'static AtomicU8> {
+        let pfn = addr >> PAGE_SHIFT;
+        PUBLISHED[..PUBLISHED_COUNT.load(Ordering::Acquire)].iter().find_map(|entry| {
+            let region = Region {
+                start_pfn: entry.start_pfn.load(Ordering::Relaxed),
+                end_pfn: entry.end_pfn.load(Ordering::Relaxed),
+                meta: entry.meta.load(Ordering::Relaxed),
+            };
+            if region.contains(pfn, 0) { Some(unsafe { region.meta(pfn) }) } else { None }
+        })
+    }
+
+    // Reddedilen serbest bırakmayı sayar ve konsola bir uyarı satırı yazar.
+    fn report_bad_free(addr: u64, order: usize) {
+        BAD_FREES.fetch_add(1, Ordering::Relaxed);
+        LAST_BAD_FREE.store(addr, Ordering::Relaxed);
+        let mut line = *b"kbuddy: gecersiz veya cift serbest birakma 0x0000000000000000 order 00\n";
+        let digits = b"0123456789abcdef";
+        let addr_at = line.len() - 26;
+        for i in 0..16 {
+            line[addr_at + i] = digits[(addr >> (60 - 4 * i)) as usize & 0xF];
+        }
+        let order_at = line.len() - 3;
+        line[order_at] = b'0' + (order / 10 % 10) as u8;
+        line[order_at + 1] = b'0' + (order % 10) as u8;
+        kconsole::write(&line);
+    }
+
+    fn zone_of(addr: u64) -> usize {
+        ZONE_LIMITS.iter().position(|&limit| addr < limit).unwrap_or(NUM_ZONES - 1)
+    }
+
+    /// `zone` veya altındaki zone'lardan (daha kısıtlı bellekten) order-`order` blok tahsis eder.
+    fn alloc_in_zone(order: usize, zone: usize) -> u64 {
+        if order > MAX_ORDER { return 0; }
+        for z in (0..=zone.min(NUM_ZONES - 1)).rev() {
+            if let Some(pfn) = unsafe { ZONES[z].lock().alloc(order) } {
+                return pfn << PAGE_SHIFT;
+            }
+        }
+        0
+    }
+
+    fn free_block(addr: u64, order: usize) {
+        if addr == 0 { return; }
+        let freed = addr % PAGE_SIZE == 0 && order <= MAX_ORDER
+            && unsafe { ZONES[zone_of(addr)].lock().free(addr >> PAGE_SHIFT, order) };
+        if !freed {
+            report_bad_free(addr, order);
+        }
+    }
+
+    // --- C Arayüzü (kernel_memory.h) ---
+
+    #[no_mangle]
+    pub extern "C" fn kmem_phys_add_region(base: u64, size: usize) {
+        let mut start = (base + PAGE_SIZE - 1) & !(PAGE_SIZE - 1);
+        let end = (base + size as u64) & !(PAGE_SIZE - 1);
+
+        // Bölgeyi zone sınırlarında parçala
+        while start < end {
+            let zone = zone_of(start);
+            let piece_end = end.min(ZONE_LIMITS[zone]);
+            let mut zone = ZONES[zone].lock();
+            if let Some(region) = unsafe { zone.add_range(start >> PAGE_SHIFT, piece_end >> PAGE_SHIFT) } {
+                publish_region(&region);
+            }
+            drop(zone);
+            start = piece_end;
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn kmem_phys_alloc_frames(order: u32) -> u64 {
+        alloc_in_zone(order as usize, ZONE_NORMAL as usize)
+    }
+
+    #[no_mangle]
+    pub extern "C" fn kmem_phys_alloc_frames_zone(order: u32, zone: u32) -> u64 {
+        if zone as usize >= NUM_ZONES { return 0; }
+        alloc_in_zone(order as usize, zone as usize)
+    }
+
+    #[no_mangle]
+    pub extern "C" fn kmem_phys_free_frames(addr: u64, order: u32) {
+        free_block(addr, order as usize);
+    }
+
+    #[no_mangle]
+    pub extern "C" fn kmem_phys_alloc_frame() -> u64 {
+        // Kesmeler kapalı: CPU değişmez ve aynı CPU'daki kesme önbellek kilidini beklemez
+        let irq = unsafe { low_level_interrupt_save() };
+        let cpu = (unsafe { low_level_cpu_id() } as usize).min(MAX_CPUS - 1);
+        let mut pcp = PCP[cpu].lock();
+
+        if pcp.count == 0 {
+            // Önbelleği tek bir zone kilidi altında toplu doldur
+            let mut zone = ZONES[ZONE_NORMAL as usize].lock();
+            while pcp.count < PCP_BATCH {
+                match unsafe { zone.alloc(0) } {
+                    Some(pfn) => {
+                        let addr = pfn << PAGE_SHIFT;
+                        if let Some(meta) = frame_meta(addr) {
+                            meta.store(META_CACHED, Ordering::Relaxed);
+                        }
+                        let n = pcp.count;
+                        pcp.frames[n] = addr;
+                        pcp.count += 1;
+                    }
+                    None => break,
+                }
+            }
+            drop(zone);
+            if pcp.count == 0 {
+                drop(pcp);
+                unsafe { low_level_interrupt_restore(irq) };
+                return alloc_in_zone(0, ZONE_DMA32 as usize); // NORMAL tükendi, alt zone'lara düş
+            }
+        }
+
+        pcp.count -= 1;
+        let addr = pcp.frames[pcp.count];
+        if let Some(meta) = frame_meta(addr) {
+            meta.store(META_ALLOCATED, Ordering::Relaxed);
+        }
+        drop(pcp);
+        unsafe { low_level_interrupt_restore(irq) };
+        addr
+    }
+
+    #[no_mangle]
+    pub extern "C" fn kmem_phys_free_frame(frame_addr: u64) {
+        if frame_addr == 0 { return; }
+        // Yalnızca tahsis edilmiş bir order-0 frame önbelleğe girer; önbellekteki veya boş bir frame reddedilir.
+        let cached = frame_addr % PAGE_SIZE == 0
+            && frame_meta(frame_addr).map_or(false, |meta| {
+                meta.compare_exchange(META_ALLOCATED, META_CACHED, Ordering::Relaxed, Ordering::Relaxed).is_ok()
+            });
+        if !cached {
+            report_bad_free(frame_addr, 0);
+            return;
+        }
+        let irq = unsafe { low_level_interrupt_save() };
+        let cpu = (unsafe { low_level_cpu_id() } as usize).min(MAX_CPUS - 1);
+        let mut pcp = PCP[cpu].lock();
+
+        if pcp.count == PCP_HIGH {
+            // Önbelleğin yarısını zone'lara iade et (birleştirme şansı için en eskiler)
+            for i in 0..PCP_BATCH {
+                let addr = pcp.frames[i];
+                if let Some(meta) = frame_meta(addr) {
+                    meta.store(META_ALLOCATED, Ordering::Relaxed);
+                }
+                free_block(addr, 0);
+            }
+            pcp.frames.copy_within(PCP_BATCH..PCP_HIGH, 0);
+            pcp.count -= PCP_BATCH;
+        }
+        let n = pcp.count;
+        pcp.frames[n] = frame_addr;
+        pcp.count += 1;
+        drop(pcp);
+        unsafe { low_level_interrupt_restore(irq) };
+    }
+
+    /// Zone'daki boş frame sayısı (tanılama için). CPU önbelleklerindeki frame'ler dahil değildir.
+    pub fn free_frames(zone: u32) -> u64 {
+        ZONES.get(zone as usize).map_or(0, |z| z.lock().free_frames)
+    }
+
+    /// Genel zone'lardan bağımsız bir buddy havuzu. Bellek katmanı yerleşimi (srctier.rs) her
+    /// (düğüm, katman) çifti için bir havuz tutar; havuza eklenen bellek kmem_phys_alloc_* ile tahsis edilmez.
+    /// Havuzda CPU önbelleği yoktur: tüm tahsisler havuz kilidinden geçer.
+    pub struct Pool {
+        zone: Mutex<Zone>,
+    }
+
+    impl Pool {
+        pub const EMPTY: Pool = Pool { zone: Mutex::new(Zone::EMPTY) };
+
+        /// [base, base + size) aralığını havuza ekler (sayfa sınırlarına kırpılır).
+        /// Eklenen boş frame sayısını döner; meta veri sayfaları veya bölge tablosu dolduysa 0.
+        pub fn add_region(&self, base: u64, size: u64) -> u64 {
+            let start = (base + PAGE_SIZE - 1) & !(PAGE_SIZE - 1);
+            let end = (base + size) & !(PAGE_SIZE - 1);
+            if end <= start { return 0; }
+            let mut zone = self.zone.lock();
+            let before = zone.free_frames;
+            unsafe { zone.add_range(start >> PAGE_SHIFT, end >> PAGE_SHIFT); }
+            zone.free_frames - before
+        }
+
+        /// Order-`order` blok tahsis eder. Yetersiz bellek veya geçersiz order durumunda 0.
+        pub fn alloc(&self, order: u32) -> u64 {
+            if order as usize > MAX_ORDER { return 0; }
+            unsafe { self.zone.lock().alloc(order as usize) }.map_or(0, |pfn| pfn << PAGE_SHIFT)
+        }
+
+        /// Havuzdan tahsis edilmiş bloğu serbest bırakır. Blok bu havuza ait değilse veya zaten boşsa false.
+        pub fn free(&self, addr: u64, order: u32) -> bool {
+            if addr == 0 || addr % PAGE_SIZE != 0 || order as usize > MAX_ORDER { return false; }
+            unsafe { self.zone.lock().free(addr >> PAGE_SHIFT, order as usize) }
+        }
+
+        pub fn free_frames(&self) -> u64 {
+            self.zone.lock().free_frames
+        }
+    }
+}
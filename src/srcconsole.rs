@@ -1,265 +1,266 @@
-use super::karnal64::{
-    // Karnal64 API'sından ihtiyaç duyulan tipleri içe aktar
-    KError,
-    ResourceProvider, // Implemente edeceğimiz trait
-    Result,           // Result<T, KError> kısayolu
-    KHandle,          // Sadece kayıt sırasında gerekebilir, provider kendisi handle ile çalışmaz
-};
+#![no_std]
+#![allow(dead_code)]
 
-// Karnal64 kresource modülünden gelmesi gereken tipler ve sabitler
-// Normalde bunlar kresource içinde tanımlanır ve oradan import edilir.
-// Şimdilik burada kendi dummy tanımlarımızı kullanıyoruz.
-// Kernel geliştirdikçe bu tipler kresource modülüne taşınmalıdır.
-#[derive(Debug, Copy, Clone, PartialEq, Eq)]
-pub enum KseekFrom {
-    Start(u64),
-    Current(i64),
-    End(i64),
-}
-
-#[derive(Debug, Copy, Clone, PartialEq, Eq)]
-pub struct KResourceStatus {
-    // Örnek alanlar, kaynağa göre değişir
-    pub readable: bool,
-    pub writable: bool,
-    pub seekable: bool,
-    pub size: Option<u64>, // Dosya boyutu gibi, konsol için None olabilir
-    // Diğer durum bilgileri eklenebilir
-}
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, kirq, ksched};
 
-// Karnal64 kresource modülünden gelmesi gereken mode sabitleri
-// Normalde kresource içinde tanımlanır.
-pub const MODE_READ: u32 = 1 << 0;
-pub const MODE_WRITE: u32 = 1 << 1;
-// TODO: Diğer modlar...
+// --- Tamponlu Çekirdek Konsolu (karnal_console_write) ---
+// Konsol sürücüleri (main.c/main.cpp'deki konsol provider'ları) baytları UART'a tek tek, eşzamanlı yazmak
+// yerine buraya bırakır. Her CPU'nun kendi halka tamponu vardır:
+// - Yazıcı mesajın tamamını yalnızca kendi CPU'sunun halkasına, kesmeler kapalıyken ekler: tek üretici,
+//   kilit yok, O(1). Yazıcı UART'ı hiçbir durumda beklemez (kesme bağlamından da çağrılabilir): halkaya
+//   sığmayan mesaj eklenmeden atılır ve KARNAL_INFO_CONSOLE_DROPPED'a sayılır.
+// - Boşaltıcı tektir (DRAINING bayrağı). UART FIFO'sunda yer olduğu kadar bayt yazar ve TX-boş kesmesini
+//   açık bırakır; kesme geldikçe boşaltma kesme bağlamında sürer. Bir halkaya başlanınca halka boşalana
+//   kadar ona devam edilir, böylece bir CPU'nun satırı diğerininkiyle karışmaz (CPU'lar arası sıra korunmaz).
+// - Acil yol (panik): kesmeleri kapatır, halkaları ve mesajı low_level_console_putc ile eşzamanlı basar.
+//   Panikten sonra tüm yazmalar eşzamanlıdır.
+//
+// Mimari UART kesmesi sunmuyorsa (low_level_console_irq 0xFFFFFFFF dönerse) yazmalar eski eşzamanlı
+// yola döner.
 
-// İçerideki kaynak yöneticisi fonksiyonları için yer tutucular
-// Gerçek implementasyonlar kresource modülünde olmalı.
-mod kresource_internal_placeholders {
+pub mod kconsole {
     use super::*;
+    use core::cell::UnsafeCell;
+    use core::sync::atomic::{AtomicBool, AtomicU32, AtomicU64, AtomicUsize, Ordering};
 
-    // Dummy Kaynak Kayıt Yöneticisi fonksiyonu
-    // Gerçek versiyon provider'ı bir tabloya kaydeder.
-    pub fn register_provider(id: &str, provider: Box<dyn ResourceProvider>) -> Result<KHandle, KError> {
-        // Bu gerçek bir kayıt yapmaz, sadece simüle eder
-        println!("Karnal64: Dummy olarak Kaynak Sağlayıcı kaydedildi: {}", id);
-        // Gerçek implementasyonda bir handle oluşturup provider ile eşlemeli
-        Ok(KHandle(id.as_bytes()[0] as u64)) // Basit bir dummy handle
+    /// CPU başına halka boyutu (ikinin kuvveti olmalı)
+    pub const RING_SIZE: usize = 8192;
+    const MAX_CPUS: usize = ksched::MAX_CPUS;
+
+    // low_level_console_irq'nun "kesme yok" dönüşü (hardware_specific.h ile EŞLEŞMELİDİR)
+    const NO_IRQ: u32 = u32::MAX;
+
+    extern "C" {
+        fn low_level_interrupt_save() -> u64;
+        fn low_level_interrupt_restore(state: u64);
+        fn low_level_cpu_id() -> u32;
+        fn low_level_console_putc(c: u8);
+        fn low_level_console_tx_room() -> u32;
+        fn low_level_console_tx_irq_enable(enable: u32);
+        fn low_level_console_irq() -> u32;
     }
 
-     // Handle izin kontrolü için dummy fonksiyon
-     pub fn handle_has_permission(handle: &KHandle, mode: u32) -> bool {
-         // Dummy: Her handle için yazma izni olduğunu varsayalım
-         (mode & MODE_WRITE) != 0
-     }
+    // Tek üreticili (sahibi CPU), tek tüketicili (DRAINING sahibi) halka. `head` ve `tail` serbest
+    // koşan sayaçlardır; dizin `& (RING_SIZE - 1)` ile bulunur.
+    struct Ring {
+        head: AtomicU64,
+        tail: AtomicU64,
+        data: UnsafeCell<[u8; RING_SIZE]>,
+    }
 
-     // Provider lookup için dummy fonksiyon
-     pub fn lookup_provider_by_name(name: &str) -> Result<&'static dyn ResourceProvider, KError> {
-         // Bu dummy implementasyon sadece "karnal://device/console" için
-         // statik bir dummy provider döndürür. Gerçekte kayıtlı sağlayıcılara bakılır.
-         println!("Karnal64: Dummy olarak provider '{}' arandı.", name);
-         if name == "karnal://device/console" {
-             // Statik bir provider instance'ı döndürmek karmaşıktır.
-             // Genellikle provider'lar dynamic dispatch (Box<dyn>) veya statik kaydedilmiş
-             // referanslar üzerinden yönetilir. Burada basitleştirilmiş bir senaryo.
-             // NOTE: 'static lifetime burada tehlikelidir, gerçek implementasyonda
-             // sağlayıcıların ömrü dikkatlice yönetilmelidir.
-             struct DummyConsoleProvider; // Yerel dummy struct
-             impl ResourceProvider for DummyConsoleProvider {
-                fn read(&self, _buffer: &mut [u8], _offset: u64) -> Result<usize, KError> { Err(KError::NotSupported) }
-                fn write(&self, buffer: &[u8], _offset: u64) -> Result<usize, KError> {
-                    // Gerçekte konsola yazacak kod burada olurdu (örn: VGA buffer, serial port)
-                    // Şimdilik sadece debug çıktısı verelim veya simüle edelim.
-                    // Güvenli kernel çıktı mekanizması kullanılmalı.
-                    #[cfg(feature = "debug_console_print")] // Özellik bayrağı ile kontrol
-                    {
-                        let s = core::str::from_utf8(buffer).unwrap_or("<invalid utf8>");
-                        // Varsayımsal kernel debug print fonksiyonu
-                         kernel_debug::print!("{}", s); // Gerçekte böyle bir şey kullanılabilir
-                        println!("(Konsol Çıktısı Simülasyonu) {}", s);
-                    }
-                    Ok(buffer.len())
-                }
-                fn control(&self, request: u64, arg: u64) -> Result<i64, KError> { Err(KError::NotSupported) }
-                fn seek(&self, position: KseekFrom) -> Result<u64, KError> { Err(KError::NotSupported) }
-                fn get_status(&self) -> Result<KResourceStatus, KError> {
-                    Ok(KResourceStatus { readable: false, writable: true, seekable: false, size: None })
-                }
-             }
-             // Bu unsafe veya static bir referans döndürmeyi gerektirir.
-             // Gerçek Resource Manager, bu nesnelerin yaşam döngüsünü yönetir.
-             // Burada sadece kavramsal olarak provider'a erişildiği gösteriliyor.
-             Err(KError::NotFound) // Dummy lookup başarısız
-         } else {
-             Err(KError::NotFound)
-         }
-     }
+    // Veri baytlarına yalnızca yukarıdaki protokolle erişilir
+    unsafe impl Sync for Ring {}
+
+    impl Ring {
+        const INIT: Ring = Ring { head: AtomicU64::new(0), tail: AtomicU64::new(0), data: UnsafeCell::new([0; RING_SIZE]) };
 
-    // Handle yönetimi için dummy fonksiyon
-    pub fn issue_handle(_provider: &dyn ResourceProvider, mode: u32) -> KHandle {
-        // Gerçek Handle Manager yeni bir handle değeri üretir ve durumu kaydeder.
-        println!("Karnal64: Dummy handle üretildi.");
-        KHandle(1001) // Rastgele dummy handle
+        fn pending(&self) -> u64 {
+            self.head.load(Ordering::Acquire) - self.tail.load(Ordering::Relaxed)
+        }
     }
 
-     pub fn release_handle(handle: u64) -> Result<(), KError> {
-         // Gerçek Handle Manager handle'ı geçersiz kılar ve kaynağa bilgi verebilir.
-         println!("Karnal64: Dummy handle {} serbest bırakıldı.", handle);
-         if handle == 0 { Err(KError::BadHandle) } else { Ok(()) }
-     }
-}
+    static RINGS: [Ring; MAX_CPUS] = [Ring::INIT; MAX_CPUS];
+    // Boşaltıcının sürdürdüğü halka
+    static CURRENT: AtomicUsize = AtomicUsize::new(0);
+    static DRAINING: AtomicBool = AtomicBool::new(false);
+    // Halkalar yalnızca UART kesmesi kurulduktan sonra kullanılır
+    static BUFFERED: AtomicBool = AtomicBool::new(false);
+    static PANICKED: AtomicBool = AtomicBool::new(false);
+    static IRQ: AtomicU32 = AtomicU32::new(NO_IRQ);
 
-// Karnal64 tarafından kullanılan iç resource fonksiyonlarını taklit et
-use kresource_internal_placeholders::{
-    register_provider,
-     lookup_provider_by_name, // Bu fonksiyon Karnal64 API'sı (karnal64.rs) tarafından kullanılır, burada değil
-     issue_handle, // Bu fonksiyon Karnal64 API'sı (karnal64.rs) tarafından kullanılır, burada değil
-     release_handle, // Bu fonksiyon Karnal64 API'sı (karnal64.rs) tarafından kullanılır, burada değil
-};
+    // İstatistikler: KARNAL_INFO_CONSOLE_* ile dışarı verilir.
+    static BYTES: AtomicU64 = AtomicU64::new(0);
+    static DROPPED: AtomicU64 = AtomicU64::new(0);
 
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_CONSOLE_* ile EŞLEŞMELİDİR)
+    pub const INFO_CONSOLE_BYTES: u32 = 0xA00;
+    pub const INFO_CONSOLE_DROPPED: u32 = 0xA01;
 
-/// Sistem konsolu için Karnal64 Kaynak Sağlayıcısı (ResourceProvider) implementasyonu.
-pub struct KernelConsole;
+    /// `kkernel::get_info` için: konsol istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_CONSOLE_BYTES => Some(BYTES.load(Ordering::Relaxed)),
+            INFO_CONSOLE_DROPPED => Some(DROPPED.load(Ordering::Relaxed)),
+            _ => None,
+        }
+    }
 
-// TODO: Konsola yazmak için donanıma özgü veya simüle edilmiş düşük seviyeli fonksiyon
- #[cfg(feature = "vga_text_mode")]
- fn write_to_vga(byte: u8);
- #[cfg(feature = "serial_port")]
- fn write_to_serial(byte: u8);
+    /// UART kesmesini bağlar ve tamponlu yolu açar. Kesme yönetimi hazır olduktan sonra bir kez çağrılır.
+    pub fn init_manager() {
+        let irq = unsafe { low_level_console_irq() };
+        if irq == NO_IRQ {
+            return; // Eşzamanlı yol kalır
+        }
+        if kirq::request(irq, Some(tx_interrupt), None, 0, 0).is_err() {
+            return;
+        }
+        IRQ.store(irq, Ordering::Relaxed);
+        BUFFERED.store(true, Ordering::Release);
+    }
 
-// Basit bir placeholder/simülasyon fonksiyonu
-fn kernel_console_write_byte(byte: u8) {
-    // Gerçekte burası VGA metin moduna veya seri porta yazardı.
-    // Şimdilik bir debug çıktı mekanizması (varsa) veya basit bir simülasyon yapabiliriz.
-    // Örneğin, QEMU veya başka bir emülatörün debug portuna yazmak.
-    #[cfg(feature = "debug_console_sim")]
-    {
-       // Varsayımsal bir debug çıktı fonksiyonu
-       extern "C" { fn debug_print_byte(byte: u8); }
-       unsafe { debug_print_byte(byte); }
+    fn write_sync(bytes: &[u8]) {
+        for &b in bytes {
+            unsafe { low_level_console_putc(b) };
+        }
+    }
+
+    fn this_ring() -> &'static Ring {
+        &RINGS[(unsafe { low_level_cpu_id() } as usize).min(MAX_CPUS - 1)]
+    }
+
+    // `bytes`'ı çalışan CPU'nun halkasına ekler. Mesaj boş yere sığmıyorsa hiçbir bayt eklenmez ve false döner.
+    fn append(bytes: &[u8]) -> bool {
+        // Kesmeler kapalı: aynı CPU'daki kesme işleyicisi halkaya ekleme ortasında giremez
+        let irq = unsafe { low_level_interrupt_save() };
+        let ring = this_ring();
+        let head = ring.head.load(Ordering::Relaxed);
+        let free = RING_SIZE as u64 - (head - ring.tail.load(Ordering::Acquire));
+        let fits = bytes.len() as u64 <= free;
+        if fits {
+            let data = ring.data.get() as *mut u8;
+            for (i, &b) in bytes.iter().enumerate() {
+                unsafe { *data.add((head as usize + i) & (RING_SIZE - 1)) = b };
+            }
+            // Release: baytlar `head`'i gören boşaltıcıya görünür
+            ring.head.store(head + bytes.len() as u64, Ordering::Release);
+        }
+        unsafe { low_level_interrupt_restore(irq) };
+        fits
     }
-    // Veya çok basit bir derleme zamanı uyarısı/mesajı
-     const _ : () = {
-         core::panic!("KernelConsole::write_byte called with {}", byte as char);
-     };
-}
 
+    /// `bytes`'ı çalışan CPU'nun halkasına ekler ve boşaltmayı tetikler; UART'ı beklemez.
+    /// Mesaj halkanın boş yerine sığmazsa (RING_SIZE'dan uzun mesajlar hiç sığmaz) tamamı atılır ve
+    /// DROPPED'a sayılır; 0 döner. Aksi halde mesajın uzunluğu döner.
+    pub fn write(bytes: &[u8]) -> usize {
+        if bytes.is_empty() {
+            return 0;
+        }
+        if !BUFFERED.load(Ordering::Acquire) || PANICKED.load(Ordering::Relaxed) {
+            write_sync(bytes);
+            BYTES.fetch_add(bytes.len() as u64, Ordering::Relaxed);
+            return bytes.len();
+        }
 
-impl ResourceProvider for KernelConsole {
-    /// Konsoldan okuma işlemi (çoğunlukla desteklenmez veya farklı bir mekanizma kullanır).
-    /// Temel implementasyonda okunamaz olduğunu belirtiyoruz.
-    fn read(&self, buffer: &mut [u8], offset: u64) -> Result<usize, KError> {
-        // Konsol okumaları genellikle satır tamponlama, kesmeler ve senkronizasyon gerektirir.
-        // Bu temel implementasyonda desteklenmiyor olarak işaretleniyor.
-        Err(KError::NotSupported)
-        // Alternatif: Eğer non-blocking ise 0 döndür, blocking ise blokla veya hata ver.
-         Err(KError::Busy) // Kaynak meşgul (şimdilik okunacak veri yok gibi)
+        if !append(bytes) {
+            DROPPED.fetch_add(bytes.len() as u64, Ordering::Relaxed);
+            pump(); // Halka doluysa boşaltıcı çalışmıyor olabilir
+            return 0;
+        }
+        pump();
+        BYTES.fetch_add(bytes.len() as u64, Ordering::Relaxed);
+        bytes.len()
     }
 
-    /// Konsola yazma işlemi.
-    /// buffer: Yazılacak veriyi içeren çekirdek alanı tamponu (kernel tarafından kullanıcı tamponundan kopyalanmış/doğrulanmış olmalı).
-    /// offset: Konsol gibi akış tabanlı cihazlarda genellikle göz ardı edilir.
-    fn write(&self, buffer: &[u8], offset: u64) -> Result<usize, KError> {
-        // Offset'i konsolda genellikle görmezden geliriz.
-        let mut bytes_written = 0;
-        for &byte in buffer {
-            // Çoğu terminal \n aldığında sadece satır atlar, \r\n bekler.
-            // Donanım katmanımız bunu otomatik yapmıyorsa biz ekleyebiliriz.
-            if byte == b'\n' {
-                kernel_console_write_byte(b'\r');
+    // UART FIFO'sunda yer olduğu kadar bayt yazar. Halkalarda veri kalırsa true döner. DRAINING tutulurken çağrılır.
+    fn drain_fifo() -> bool {
+        let mut room = unsafe { low_level_console_tx_room() };
+        let mut cpu = CURRENT.load(Ordering::Relaxed);
+        for _ in 0..=MAX_CPUS {
+            let ring = &RINGS[cpu];
+            let data = ring.data.get() as *const u8;
+            let mut tail = ring.tail.load(Ordering::Relaxed);
+            let head = ring.head.load(Ordering::Acquire);
+            while tail != head && room > 0 {
+                unsafe { low_level_console_putc(*data.add(tail as usize & (RING_SIZE - 1))) };
+                tail += 1;
+                room -= 1;
+            }
+            // Release: yazıcı boşalan yeri ancak baytlar okunduktan sonra yeniden kullanır
+            ring.tail.store(tail, Ordering::Release);
+            if tail != head {
+                CURRENT.store(cpu, Ordering::Relaxed);
+                return true; // FIFO doldu; bu halkaya sonraki kesmede devam edilir
             }
-            kernel_console_write_byte(byte);
-            bytes_written += 1;
+            cpu = (cpu + 1) % MAX_CPUS;
         }
-        Ok(bytes_written)
+        CURRENT.store(cpu, Ordering::Relaxed);
+        RINGS.iter().any(|ring| ring.pending() != 0)
     }
 
-    /// Konsola özel kontrol komutları gönderir.
-    /// request: Komut kodu (örn: ekranı temizle, imleci ayarla - eğer destekleniyorsa)
-    /// arg: Komut argümanı
-    fn control(&self, request: u64, arg: u64) -> Result<i64, KError> {
-        // TODO: Konsola özgü kontrol komutları tanımla ve burada işle.
-        // Örnek dummy komutlar:
-        match request {
-             1 => // CLEAR_SCREEN
-             2 => // SET_CURSOR_POS (arg = y << 32 | x)
-            _ => {
-                println!("Karnal64::KernelConsole: Desteklenmeyen kontrol isteği: {}", request);
-                Err(KError::NotSupported)
+    // Boşaltmayı tek boşaltıcı olarak çalıştırır; başkası boşaltıyorsa hemen döner.
+    fn pump() {
+        loop {
+            if DRAINING.swap(true, Ordering::Acquire) {
+                return; // Sahibi bayrağı bırakmadan önce halkaları yeniden kontrol eder
+            }
+            let more = drain_fifo();
+            unsafe { low_level_console_tx_irq_enable(more as u32) };
+            DRAINING.store(false, Ordering::Release);
+            // Bayrak tutulurken eklenen ve `pump`'tan erken dönen yazıcının verisi kaybolmasın
+            if more || RINGS.iter().all(|ring| ring.pending() == 0) {
+                return;
             }
         }
     }
 
-    /// Konsol seekable bir kaynak değildir.
-    fn seek(&self, position: KseekFrom) -> Result<u64, KError> {
-        Err(KError::NotSupported)
+    // UART TX-boş kesmesinin üst yarısı
+    extern "C" fn tx_interrupt(_irq: u32, _context: u64) -> u32 {
+        pump();
+        kirq::IRQ_HANDLED
     }
 
-    /// Konsolun durumunu (okunabilir/yazılabilir vb.) döndürür.
-    fn get_status(&self) -> Result<KResourceStatus, KError> {
-        Ok(KResourceStatus {
-            readable: false, // Temel konsol okumayı desteklemez
-            writable: true,  // Yazılabilir
-            seekable: false, // Seekable değil
-            size: None,      // Boyutu yok
-        })
+    /// Halkalar boşalana kadar bekleyerek eşzamanlı boşaltır (kapanış, yeniden başlatma öncesi).
+    pub fn flush() {
+        while RINGS.iter().any(|ring| ring.pending() != 0) {
+            if DRAINING.swap(true, Ordering::Acquire) {
+                core::hint::spin_loop();
+                continue;
+            }
+            let more = drain_fifo();
+            DRAINING.store(false, Ordering::Release);
+            if more {
+                core::hint::spin_loop();
+            }
+        }
     }
-}
 
-/// Konsol kaynağını başlatan ve Karnal64'e kaydeden fonksiyon.
-/// Kernel başlangıcında Karnal64'ün init fonksiyonu tarafından çağrılmalıdır.
-pub fn init() {
-    // KarnalConsole instance'ını oluştur.
-    let console_provider = KernelConsole;
+    /// Panik yolu: kesmeleri kapatır, bekleyen halkaları ve `bytes`'ı doğrudan UART'a yazar.
+    /// Boşaltıcı bayrağı yok sayılır (bayrağı tutan CPU durmuş olabilir). Sonraki yazmalar eşzamanlıdır.
+    pub fn emergency_write(bytes: &[u8]) {
+        let _irq = unsafe { low_level_interrupt_save() }; // Geri yüklenmez: panik dönmez
+        if !PANICKED.swap(true, Ordering::AcqRel) {
+            let irq = IRQ.load(Ordering::Relaxed);
+            if irq != NO_IRQ {
+                unsafe { low_level_console_tx_irq_enable(0) };
+            }
+            for ring in RINGS.iter() {
+                let data = ring.data.get() as *const u8;
+                let head = ring.head.load(Ordering::Acquire);
+                let mut tail = ring.tail.load(Ordering::Relaxed);
+                while tail != head {
+                    unsafe { low_level_console_putc(*data.add(tail as usize & (RING_SIZE - 1))) };
+                    tail += 1;
+                }
+                ring.tail.store(tail, Ordering::Release);
+            }
+        }
+        write_sync(bytes);
+    }
 
-    // ResourceProvider trait object'e çevirmek için Box kullan
-    // Box kullanabilmek için 'alloc' crate'inin kullanılabilir ve başlatılmış olması gerekir.
-    let boxed_provider: Box<dyn ResourceProvider> = Box::new(console_provider);
+    // --- C API ---
 
-    // Kaynak sağlayıcıyı Karnal64 kaynak yöneticisine kaydet.
-    // Çekirdek içindeki bilinen bir isimle ("karnal://device/console") kaydediyoruz.
-    // Kullanıcı alanı bu isimle resource_acquire çağrısı yapacak.
-    match register_provider("karnal://device/console", boxed_provider) {
-        Ok(_handle) => {
-            // Başarıyla kaydedildi. Döndürülen handle burada doğrudan kullanılmayabilir,
-            // handle Karnal64'ün iç yönetimindedir.
-            println!("Karnal64::KernelConsole: Konsol kaynağı başarıyla kaydedildi.");
+    #[no_mangle]
+    pub extern "C" fn karnal_console_write(buffer: *const u8, size: usize) -> i64 {
+        if size == 0 {
+            return 0;
         }
-        Err(err) => {
-            // Kayıt başarısız olursa çekirdek başlangıcında kritik bir hata olabilir.
-            println!("Karnal64::KernelConsole: Konsol kaynağı kaydı başarısız oldu: {:?}", err);
-            // TODO: Hata yönetimi
+        if buffer.is_null() {
+            return KError::InvalidArgument as i64;
         }
+        let bytes = unsafe { core::slice::from_raw_parts(buffer, size) };
+        write(bytes) as i64
     }
-}
 
-// --- Kernel Tarafında Kullanım Örneği (Gerçek kod değil, kavramsal) ---
-
-// Başka bir kernel modülünden (örn: init görevi) konsola yazmak için:
-// Not: Kernel içinden Karnal64 API'sını çağırmak, kullanıcı alanının
-// sistem çağrısı yapmasından farklıdır. Kernel modülleri genellikle
-// ResourceProvider traitini implemente eden struct'ların doğrudan
-// referanslarına (eğer singleton iseler) veya Karnal64'ün iç
-// provider lookup mekanizmalarına erişebilir. Ancak Karnal64'ün
-// kendi iç mimarisine bağlıdır bu. Basitlik için, provider'ın
-// statik bir referansını alıp write metodunu çağırdığımızı varsayalım.
-
-fn kernel_write_to_console(message: &str) {
-    // Bu sadece konsepttir. Gerçekte konsol sağlayıcısına güvenli bir
-    // referans almak karmaşıktır (Global statik Mutex korumalı struct gibi).
-    // let console_provider = kresource::get_console_provider_singleton(); // Varsayımsal fonksiyon
-
-    // Alternatif olarak, eğer konsolun bir KHandle'ı kernel içinde biliniyorsa:
-     let console_handle = kresource::get_known_handle("karnal://device/console"); // Varsayımsal
-     let provider = kresource::get_provider_by_handle(&console_handle).expect("Console not found");
-
-    // En basiti: Provider'ın kendi statik fonksiyonları veya singleton deseni varsa
-     KernelConsole::write_message(message); // Eğer KernelConsole::write gibi statik bir methodu varsa
+    #[no_mangle]
+    pub extern "C" fn karnal_console_emergency_write(buffer: *const u8, size: usize) {
+        // NULL/0 yalnızca halkaları boşaltır ve eşzamanlı kipe geçer
+        let bytes: &[u8] = if buffer.is_null() { &[] } else { unsafe { core::slice::from_raw_parts(buffer, size) } };
+        emergency_write(bytes);
+    }
 
-    // En yakın simülasyon: Dummy provider implementasyonunu doğrudan kullanmak
-    #[cfg(feature = "debug_console_print")]
-    {
-         // Güvenli kernel çıktı mekanizması kullanılmalı.
-         println!("(Kernel İçinden Konsola Yazma Simülasyonu) {}", message);
+    #[no_mangle]
+    pub extern "C" fn karnal_console_flush() {
+        flush();
     }
 }
@@ -0,0 +1,292 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, KThreadId, kbattery, ksched, ktimer};
+
+// --- Zamanlayıcı Yüküne Göre Frekans (DVFS) ve Boşta Durumu Seçimi ---
+// Boşta iş parçacığı (srcsched.rs) beklemeyi `idle_wait` ile yapar. Burada CPU başına boşta süresi
+// tutulur ve hangi boşta durumuna girileceği seçilir:
+// - Durum tahmini: son boşta sürelerinin üssel ortalaması (1/8 ağırlık). Hedef yerleşim süresi tahmini
+//   aşmayan ve çıkış gecikmesi sınırı (set_latency_limit) içinde kalan en derin durum seçilir; uygun
+//   durum yoksa low_level_cpu_idle_wait (hlt/wfi). Durum tablosunu mimari kod kaydeder.
+// - Frekans: bir düzenleyici iş parçacığı SAMPLE_NS'de bir her çevrimiçi CPU'nun meşguliyetini (pencere
+//   süresi - boşta süresi) ölçer. Gereken seviye = mevcut seviye * meşguliyet * 1.25 (pay); meşguliyet
+//   %90'ı aşarsa doğrudan en yükseğe çıkılır. Seviye 0-1024 ölçeğinde bir kapasite isteğidir;
+//   low_level_cpu_set_performance onu mimarinin P-state/OPP'sine çevirir.
+// - Pil: boşalırken şarj LOW_BATTERY_LEVEL'in altına inerse en yüksek seviye LOW_BATTERY_CAP ile sınırlanır.
+//
+// Periyodik tik yoktur: tüm CPU'lar boştaysa ve en düşük seviyedeyse düzenleyici kendini park eder,
+// herhangi bir CPU'nun boşta durumundan çıkışı onu yeniden uyandırır. Mimari frekans değiştirmeyi
+// desteklemiyorsa (NotSupported) düzenleyici çıkar; boşta durumu seçimi yine çalışır.
+
+pub mod kdvfs {
+    use super::*;
+    use core::sync::atomic::{AtomicBool, AtomicU32, AtomicU64, Ordering};
+    use spin::Mutex;
+
+    /// Performans seviyesi ölçeği (1024: en yüksek frekans)
+    pub const LEVEL_MAX: u32 = 1024;
+    const LEVEL_MIN: u32 = 64;
+
+    // Düzenleyici örnekleme aralığı ve boşta sistem için esneklik
+    const SAMPLE_NS: u64 = 20_000_000;
+    const SAMPLE_SLACK_NS: u64 = 5_000_000;
+    // Meşguliyet eşikleri (1024 ölçeğinde)
+    const UP_THRESHOLD: u64 = 922; // %90
+    const IDLE_THRESHOLD: u64 = 51; // %5
+
+    const LOW_BATTERY_LEVEL: u32 = 15;
+    const LOW_BATTERY_CAP: u32 = 768;
+
+    /// Kaydedilebilecek en fazla derin boşta durumu (hlt/wfi dışında)
+    pub const MAX_IDLE_STATES: usize = 8;
+
+    extern "C" {
+        fn low_level_interrupt_save() -> u64;
+        fn low_level_interrupt_restore(state: u64);
+        fn low_level_cpu_idle_wait();
+        fn low_level_cpu_idle_enter(state: u32);
+        fn low_level_cpu_set_performance(cpu: u32, level: u32) -> i64;
+    }
+
+    /// Mimari kodun kaydettiği boşta durumu (KarnalIdleState_t). Sığdan derine sıralı verilir.
+    #[repr(C)]
+    #[derive(Clone, Copy)]
+    pub struct IdleState {
+        pub id: u32,                  // low_level_cpu_idle_enter'a geçilen mimari numara
+        pub reserved: u32,
+        pub exit_latency_ns: u64,     // Uyanma gecikmesi
+        pub target_residency_ns: u64, // Girişin enerji kazandırdığı en kısa boşta süresi
+    }
+
+    struct CpuLoad {
+        idle_ns: AtomicU64,      // Toplam boşta süresi
+        idle_since: AtomicU64,   // Sürmekte olan bekleyişin başlangıcı (0: boşta değil)
+        predicted_ns: AtomicU64, // Boşta süresi tahmini (üssel ortalama)
+        window_start: AtomicU64, // Düzenleyicinin son örneği
+        window_idle: AtomicU64,  // Son örnekteki toplam boşta süresi
+        level: AtomicU32,        // İstenen son performans seviyesi
+    }
+
+    impl CpuLoad {
+        const INIT: CpuLoad = CpuLoad {
+            idle_ns: AtomicU64::new(0),
+            idle_since: AtomicU64::new(0),
+            predicted_ns: AtomicU64::new(0),
+            window_start: AtomicU64::new(0),
+            window_idle: AtomicU64::new(0),
+            level: AtomicU32::new(LEVEL_MAX), // Ürün yazılımı en yüksek frekansla açar
+        };
+    }
+
+    static CPUS: [CpuLoad; ksched::MAX_CPUS] = [CpuLoad::INIT; ksched::MAX_CPUS];
+
+    // Boşta durumu tablosu: boşta yolunda kilitsiz okunur, yalnızca kayıt yazar
+    const NO_STATE: IdleState = IdleState { id: 0, reserved: 0, exit_latency_ns: 0, target_residency_ns: 0 };
+    static IDLE_STATES: Mutex<[IdleState; MAX_IDLE_STATES]> = Mutex::new([NO_STATE; MAX_IDLE_STATES]);
+    static IDLE_STATE_COUNT: AtomicU32 = AtomicU32::new(0);
+    static LATENCY_LIMIT_NS: AtomicU64 = AtomicU64::new(u64::MAX);
+
+    // Düzenleyici iş parçacığı (KThreadId, 0: yok) ve park durumu
+    static GOVERNOR: AtomicU64 = AtomicU64::new(0);
+    static PARKED: AtomicBool = AtomicBool::new(false);
+
+    // İstatistikler: KARNAL_INFO_DVFS_* ile dışarı verilir.
+    static LEVEL_CHANGES: AtomicU64 = AtomicU64::new(0);
+    static DEEP_IDLE_ENTRIES: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_DVFS_* ile EŞLEŞMELİDİR)
+    pub const INFO_DVFS_LEVEL_CHANGES: u32 = 0xF10;
+    pub const INFO_DVFS_DEEP_IDLE_ENTRIES: u32 = 0xF11;
+    // 0xF40 + cpu: CPU'nun istenen seviyesi; 0xF60 + cpu: CPU'nun toplam boşta süresi (ns)
+    pub const INFO_DVFS_CPU_LEVEL_BASE: u32 = 0xF40;
+    pub const INFO_DVFS_CPU_IDLE_NS_BASE: u32 = 0xF60;
+
+    /// `kkernel::get_info` için: DVFS/boşta istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        let level_end = INFO_DVFS_CPU_LEVEL_BASE + ksched::MAX_CPUS as u32;
+        let idle_end = INFO_DVFS_CPU_IDLE_NS_BASE + ksched::MAX_CPUS as u32;
+        match info_type {
+            INFO_DVFS_LEVEL_CHANGES => Some(LEVEL_CHANGES.load(Ordering::Relaxed)),
+            INFO_DVFS_DEEP_IDLE_ENTRIES => Some(DEEP_IDLE_ENTRIES.load(Ordering::Relaxed)),
+            t if (INFO_DVFS_CPU_LEVEL_BASE..level_end).contains(&t) => {
+                Some(CPUS[(t - INFO_DVFS_CPU_LEVEL_BASE) as usize].level.load(Ordering::Relaxed) as u64)
+            }
+            t if (INFO_DVFS_CPU_IDLE_NS_BASE..idle_end).contains(&t) => {
+                Some(CPUS[(t - INFO_DVFS_CPU_IDLE_NS_BASE) as usize].idle_ns.load(Ordering::Relaxed))
+            }
+            _ => None,
+        }
+    }
+
+    /// Düzenleyici iş parçacığını oluşturur. Zamanlayıcı başladığında çalışmaya başlar.
+    pub fn init_manager() {
+        let now = ktimer::now_ns();
+        for cpu in CPUS.iter() {
+            cpu.window_start.store(now, Ordering::Relaxed);
+        }
+        if let Ok(tid) = ksched::thread_create(governor as usize as u64, 0, 0, 0) {
+            GOVERNOR.store(tid.0, Ordering::Release);
+        }
+    }
+
+    // --- Boşta Yolu ---
+
+    fn select_idle_state(predicted_ns: u64) -> Option<u32> {
+        let count = IDLE_STATE_COUNT.load(Ordering::Acquire) as usize;
+        if count == 0 {
+            return None;
+        }
+        // Boşta yolu dönmez: tablo kayıt sırasında tutuluyorsa sığ beklemeyle devam edilir
+        let states = IDLE_STATES.try_lock()?;
+        let limit = LATENCY_LIMIT_NS.load(Ordering::Relaxed);
+        states[..count]
+            .iter()
+            .rev()
+            .find(|s| s.target_residency_ns <= predicted_ns && s.exit_latency_ns <= limit)
+            .map(|s| s.id)
+    }
+
+    /// Boşta iş parçacığının beklemesi (kesmeler kapalı çağrılır, kapalı döner). Bir boşta durumu seçer,
+    /// bekler ve boşta süresini hesaba katar.
+    pub fn idle_wait(cpu: usize) {
+        let load = &CPUS[cpu.min(ksched::MAX_CPUS - 1)];
+        let start = ktimer::now_ns();
+        let state = select_idle_state(load.predicted_ns.load(Ordering::Relaxed));
+        load.idle_since.store(start, Ordering::Release);
+        match state {
+            Some(id) => {
+                DEEP_IDLE_ENTRIES.fetch_add(1, Ordering::Relaxed);
+                unsafe { low_level_cpu_idle_enter(id) };
+            }
+            None => unsafe { low_level_cpu_idle_wait() },
+        }
+        let slept = ktimer::now_ns().saturating_sub(start);
+        load.idle_ns.fetch_add(slept, Ordering::Relaxed);
+        load.idle_since.store(0, Ordering::Release);
+        let predicted = load.predicted_ns.load(Ordering::Relaxed);
+        load.predicted_ns.store(predicted - predicted / 8 + slept / 8, Ordering::Relaxed);
+
+        // Uyanan CPU iş bulmuş olabilir: park etmiş düzenleyici yeniden örneklemeye başlar
+        if PARKED.swap(false, Ordering::AcqRel) {
+            let _ = ksched::wake(KThreadId(GOVERNOR.load(Ordering::Acquire)));
+        }
+    }
+
+    // --- Frekans Düzenleyici ---
+
+    fn level_cap() -> u32 {
+        match kbattery::snapshot() {
+            Ok(s) if s.status == kbattery::STATUS_DISCHARGING && s.charge_level <= LOW_BATTERY_LEVEL => LOW_BATTERY_CAP,
+            _ => LEVEL_MAX,
+        }
+    }
+
+    /// Her çevrimiçi CPU için seviyeyi yeniden hesaplar. Mimari desteklemiyorsa Err, sistem boşta ve en
+    /// düşük seviyedeyse Ok(false) döner.
+    fn evaluate() -> Result<bool, KError> {
+        let now = ktimer::now_ns();
+        let cap = level_cap();
+        let online = ksched::online_cpus();
+        let mut active = false;
+        for cpu in 0..ksched::MAX_CPUS {
+            if online & (1 << cpu) == 0 {
+                continue;
+            }
+            let load = &CPUS[cpu];
+            let since = load.idle_since.load(Ordering::Acquire);
+            let idle_total = load.idle_ns.load(Ordering::Relaxed) + if since != 0 { now.saturating_sub(since) } else { 0 };
+            let elapsed = now.saturating_sub(load.window_start.swap(now, Ordering::Relaxed)).max(1);
+            let idle = idle_total.saturating_sub(load.window_idle.swap(idle_total, Ordering::Relaxed)).min(elapsed);
+            let busy = (elapsed - idle) * 1024 / elapsed;
+
+            let current = load.level.load(Ordering::Relaxed);
+            let next = if busy >= UP_THRESHOLD {
+                cap
+            } else {
+                ((current as u64 * busy / 1024) * 5 / 4).clamp(LEVEL_MIN as u64, cap as u64) as u32
+            };
+            if next != current {
+                let ret = unsafe { low_level_cpu_set_performance(cpu as u32, next) };
+                if ret == KError::NotSupported as i64 {
+                    return Err(KError::NotSupported);
+                }
+                if ret == 0 {
+                    load.level.store(next, Ordering::Relaxed);
+                    LEVEL_CHANGES.fetch_add(1, Ordering::Relaxed);
+                }
+            }
+            if busy > IDLE_THRESHOLD || load.level.load(Ordering::Relaxed) > LEVEL_MIN {
+                active = true;
+            }
+        }
+        Ok(active)
+    }
+
+    extern "C" fn governor(_arg: u64) {
+        loop {
+            let _ = ksched::task_sleep_ns(SAMPLE_NS, SAMPLE_SLACK_NS);
+            match evaluate() {
+                Ok(true) => {}
+                Ok(false) => {
+                    // Park: bir CPU'nun boşta çıkışı (idle_wait) uyandırır. Araya giren uyandırma kaybolmaz.
+                    let irq = unsafe { low_level_interrupt_save() };
+                    ksched::prepare_block();
+                    PARKED.store(true, Ordering::Release);
+                    ksched::block();
+                    unsafe { low_level_interrupt_restore(irq) };
+                    PARKED.store(false, Ordering::Relaxed);
+                    // Park süresi örnek penceresine sayılmasın
+                    let now = ktimer::now_ns();
+                    for load in CPUS.iter() {
+                        load.window_start.store(now, Ordering::Relaxed);
+                        let since = load.idle_since.load(Ordering::Acquire);
+                        let idle_total = load.idle_ns.load(Ordering::Relaxed) + if since != 0 { now.saturating_sub(since) } else { 0 };
+                        load.window_idle.store(idle_total, Ordering::Relaxed);
+                    }
+                }
+                Err(_) => break, // Frekans değiştirilemiyor
+            }
+        }
+        GOVERNOR.store(0, Ordering::Release);
+    }
+
+    // --- Kayıt ve Ayarlar ---
+
+    /// Mimarinin derin boşta durumlarını kaydeder (sığdan derine). Önceki tabloyu değiştirir.
+    pub fn register_idle_states(states: &[IdleState]) -> Result<(), KError> {
+        if states.len() > MAX_IDLE_STATES {
+            return Err(KError::InvalidArgument);
+        }
+        let mut table = IDLE_STATES.lock();
+        IDLE_STATE_COUNT.store(0, Ordering::Release);
+        table[..states.len()].copy_from_slice(states);
+        IDLE_STATE_COUNT.store(states.len() as u32, Ordering::Release);
+        Ok(())
+    }
+
+    /// Kabul edilen en büyük boşta çıkış gecikmesi (gerçek zamanlı iş yükleri için). u64::MAX: sınırsız.
+    pub fn set_latency_limit(latency_ns: u64) {
+        LATENCY_LIMIT_NS.store(latency_ns, Ordering::Relaxed);
+    }
+
+    // --- C API ---
+
+    #[no_mangle]
+    pub extern "C" fn karnal_power_register_idle_states(states: *const IdleState, count: usize) -> i64 {
+        if states.is_null() && count != 0 {
+            return KError::InvalidArgument as i64;
+        }
+        let states = if count == 0 { &[][..] } else { unsafe { core::slice::from_raw_parts(states, count) } };
+        match register_idle_states(states) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_power_set_latency_limit(latency_ns: u64) {
+        set_latency_limit(latency_ns);
+    }
+}
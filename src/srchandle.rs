@@ -0,0 +1,320 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, KHandle, ResourceProvider, ksched};
+
+// --- Görev Başına Kaynak Handle Tablosu ---
+// Her görevin yoğun, indeksle erişilen bir handle tablosu vardır. khandle_t yuva indeksini ve yuvanın
+// neslini taşır:
+//   bit 0..15  : yuva indeksi + 1 (0 hiçbir yuvaya karşılık gelmez)
+//   bit 16..47 : nesil (yuva her kapatıldığında artar, 0 atlanır)
+//   bit 48..63 : 0 (etiketli handle'lardan, örn. srcregistry.rs'deki 'KP', ayrılır)
+// Doğrulama tek sınır kontrolü ve tek nesil karşılaştırmasıdır; kapatılmış bir handle'ın eski değeri
+// yuva yeniden kullanılsa bile nesil farkından reddedilir. İzinler ve ofset yuvada tutulur.
+//
+// Yuva durumu (nesil << 32 | referans) tek bir atomik kelimedir. Tablo açık bir yuvada bir referans
+// tutar; her `get` bir referans daha alır ve HandleRef düşürülünce bırakır. Kapatma nesli hemen
+// artırır (yeni `get`'ler başarısız olur) ve tablonun referansını bırakır; son referansı bırakan
+// provider'ı düşürür ve yuvayı boş listeye iade eder. Böylece kapatma, aynı handle üzerinde süren bir
+// okuma/yazma ile yarışsa bile provider kullanım sırasında serbest bırakılmaz.
+
+pub mod khandle {
+    use super::*;
+    use alloc::boxed::Box;
+    use alloc::sync::Arc;
+    use alloc::vec::Vec;
+    use core::cell::UnsafeCell;
+    use core::sync::atomic::{AtomicPtr, AtomicU32, AtomicU64, Ordering};
+    use spin::Mutex;
+
+    /// Görev başına en fazla açık handle
+    pub const MAX_HANDLES: usize = 1024;
+
+    const INDEX_MASK: u64 = 0xFFFF;
+    const GENERATION_SHIFT: u32 = 16;
+    const TAG_MASK: u64 = 0xFFFF << 48;
+    const NO_SLOT: u32 = u32::MAX;
+
+    struct Slot {
+        state: AtomicU64, // nesil << 32 | referans sayısı; referans 0 ise yuva boştur
+        mode: AtomicU32,
+        offset: AtomicU64,
+        next_free: AtomicU32, // Yalnızca boş liste kilidi altında
+        // Referans > 0 iken değişmez; yalnızca yuvayı alan (issue) ve son referansı bırakan yazar.
+        provider: UnsafeCell<Option<Arc<dyn ResourceProvider>>>,
+    }
+
+    unsafe impl Sync for Slot {}
+
+    impl Slot {
+        fn new() -> Slot {
+            Slot {
+                state: AtomicU64::new(1 << 32), // Nesil 1'den başlar: küçük sabit değerler asla geçerli değil
+                mode: AtomicU32::new(0),
+                offset: AtomicU64::new(0),
+                next_free: AtomicU32::new(NO_SLOT),
+                provider: UnsafeCell::new(None),
+            }
+        }
+    }
+
+    struct FreeList {
+        head: u32, // Kapatılıp iade edilmiş yuvalar (LIFO)
+        high: u32, // Hiç kullanılmamış ilk yuva; tablo en düşük indekslerden doldurulur
+    }
+
+    struct HandleTable {
+        slots: Box<[Slot]>,
+        free: Mutex<FreeList>,
+        open: AtomicU32,
+    }
+
+    impl HandleTable {
+        fn new() -> Box<HandleTable> {
+            let mut slots = Vec::with_capacity(MAX_HANDLES);
+            slots.resize_with(MAX_HANDLES, Slot::new);
+            Box::new(HandleTable {
+                slots: slots.into_boxed_slice(),
+                free: Mutex::new(FreeList { head: NO_SLOT, high: 0 }),
+                open: AtomicU32::new(0),
+            })
+        }
+    }
+
+    // Görev tabloları ilk handle verildiğinde oluşturulur.
+    static TABLES: [AtomicPtr<HandleTable>; ksched::MAX_TASKS] = {
+        const EMPTY: AtomicPtr<HandleTable> = AtomicPtr::new(core::ptr::null_mut());
+        [EMPTY; ksched::MAX_TASKS]
+    };
+
+    // İstatistikler: KARNAL_INFO_HANDLE_* ile dışarı verilir.
+    static OPEN_HANDLES: AtomicU64 = AtomicU64::new(0);
+    static STALE_REJECTS: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_HANDLE_* ile EŞLEŞMELİDİR)
+    pub const INFO_HANDLE_OPEN: u32 = 0x700;
+    pub const INFO_HANDLE_STALE_REJECTS: u32 = 0x701;
+
+    /// `kkernel::get_info` için: handle istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_HANDLE_OPEN => Some(OPEN_HANDLES.load(Ordering::Relaxed)),
+            INFO_HANDLE_STALE_REJECTS => Some(STALE_REJECTS.load(Ordering::Relaxed)),
+            _ => None,
+        }
+    }
+
+    fn table_of(task: u32) -> Option<&'static HandleTable> {
+        let table = TABLES.get(task as usize)?.load(Ordering::Acquire);
+        if table.is_null() { None } else { Some(unsafe { &*table }) }
+    }
+
+    fn table_or_create(task: u32) -> Result<&'static HandleTable, KError> {
+        let cell = TABLES.get(task as usize).ok_or(KError::InternalError)?;
+        if let Some(table) = table_of(task) {
+            return Ok(table);
+        }
+        let fresh = Box::into_raw(HandleTable::new());
+        match cell.compare_exchange(core::ptr::null_mut(), fresh, Ordering::AcqRel, Ordering::Acquire) {
+            Ok(_) => Ok(unsafe { &*fresh }),
+            Err(existing) => {
+                drop(unsafe { Box::from_raw(fresh) }); // Yarışı başka bir iş parçacığı kazandı
+                Ok(unsafe { &*existing })
+            }
+        }
+    }
+
+    fn next_generation(generation: u32) -> u32 {
+        match generation.wrapping_add(1) {
+            0 => 1,
+            next => next,
+        }
+    }
+
+    fn encode(index: usize, generation: u32) -> KHandle {
+        KHandle(((generation as u64) << GENERATION_SHIFT) | (index as u64 + 1))
+    }
+
+    /// Değer bu tablonun biçiminde mi (etiketli handle'ları ve 0'ı ayırmak için).
+    pub fn is_resource_handle(handle_value: u64) -> bool {
+        handle_value & TAG_MASK == 0 && handle_value & INDEX_MASK != 0
+    }
+
+    // Son referans bırakıldı: provider'ı düşür ve yuvayı iade et. Nesil kapatmada zaten artırıldı.
+    fn reclaim(table: &HandleTable, index: usize) {
+        let slot = &table.slots[index];
+        let provider = unsafe { (*slot.provider.get()).take() };
+        let mut free = table.free.lock();
+        slot.next_free.store(free.head, Ordering::Relaxed);
+        free.head = index as u32;
+        drop(free);
+        table.open.fetch_sub(1, Ordering::Relaxed);
+        OPEN_HANDLES.fetch_sub(1, Ordering::Relaxed);
+        drop(provider); // Kilit dışında: provider'ın Drop'u uzun sürebilir
+    }
+
+    fn put(table: &HandleTable, index: usize) {
+        let prev = table.slots[index].state.fetch_sub(1, Ordering::AcqRel);
+        if prev & 0xFFFF_FFFF == 1 {
+            reclaim(table, index);
+        }
+    }
+
+    /// Çözülmüş bir handle. Yaşadığı sürece provider serbest bırakılmaz.
+    pub struct HandleRef {
+        table: &'static HandleTable,
+        index: usize,
+    }
+
+    impl HandleRef {
+        fn slot(&self) -> &Slot {
+            &self.table.slots[self.index]
+        }
+
+        pub fn provider(&self) -> &dyn ResourceProvider {
+            // Referans tutulduğu sürece provider alanı değişmez
+            unsafe { (*self.slot().provider.get()).as_deref().unwrap_unchecked() }
+        }
+
+        /// Provider'ın paylaşılan referansı; handle kapatıldıktan sonra da tutulacaksa (imaj önbelleği).
+        pub fn provider_arc(&self) -> Arc<dyn ResourceProvider> {
+            unsafe { (*self.slot().provider.get()).clone().unwrap_unchecked() }
+        }
+
+        pub fn mode(&self) -> u32 {
+            self.slot().mode.load(Ordering::Relaxed)
+        }
+
+        pub fn offset(&self) -> u64 {
+            self.slot().offset.load(Ordering::Relaxed)
+        }
+
+        /// Handle'ın ofsetini `bytes` kadar ilerletir (sıralı okuma/yazma sonrası).
+        pub fn advance(&self, bytes: usize) {
+            self.slot().offset.fetch_add(bytes as u64, Ordering::Relaxed);
+        }
+
+        pub fn set_offset(&self, offset: u64) {
+            self.slot().offset.store(offset, Ordering::Relaxed);
+        }
+    }
+
+    impl Drop for HandleRef {
+        fn drop(&mut self) {
+            put(self.table, self.index);
+        }
+    }
+
+    /// Mevcut görevin tablosunda `provider` için `mode` izinli yeni bir handle açar.
+    pub fn issue(provider: Arc<dyn ResourceProvider>, mode: u32) -> Result<KHandle, KError> {
+        let table = table_or_create(ksched::current_task())?;
+        let index = {
+            let mut free = table.free.lock();
+            if free.head != NO_SLOT {
+                let index = free.head;
+                free.head = table.slots[index as usize].next_free.load(Ordering::Relaxed);
+                index as usize
+            } else if (free.high as usize) < MAX_HANDLES {
+                free.high += 1;
+                free.high as usize - 1
+            } else {
+                return Err(KError::OutOfMemory);
+            }
+        };
+
+        let slot = &table.slots[index];
+        unsafe { *slot.provider.get() = Some(provider) };
+        slot.mode.store(mode, Ordering::Relaxed);
+        slot.offset.store(0, Ordering::Relaxed);
+        // Release: provider ve izinler, referansı 1 gören `get`'lere görünür
+        let generation = (slot.state.load(Ordering::Relaxed) >> 32) as u32;
+        slot.state.store((generation as u64) << 32 | 1, Ordering::Release);
+        table.open.fetch_add(1, Ordering::Relaxed);
+        OPEN_HANDLES.fetch_add(1, Ordering::Relaxed);
+        Ok(encode(index, generation))
+    }
+
+    /// Mevcut görevin handle'ını çözer ve `required_mode` izinlerini kontrol eder.
+    /// Tanınmayan, kapatılmış veya başka bir görevin handle'ı BadHandle döner.
+    pub fn get(handle_value: u64, required_mode: u32) -> Result<HandleRef, KError> {
+        let index = (handle_value & INDEX_MASK) as usize;
+        if handle_value & TAG_MASK != 0 || index == 0 || index > MAX_HANDLES {
+            return Err(KError::BadHandle);
+        }
+        let index = index - 1;
+        let generation = (handle_value >> GENERATION_SHIFT) as u32;
+        let table = table_of(ksched::current_task()).ok_or(KError::BadHandle)?;
+        let slot = &table.slots[index];
+
+        let mut state = slot.state.load(Ordering::Acquire);
+        loop {
+            if (state >> 32) as u32 != generation || state & 0xFFFF_FFFF == 0 {
+                STALE_REJECTS.fetch_add(1, Ordering::Relaxed);
+                return Err(KError::BadHandle);
+            }
+            match slot.state.compare_exchange_weak(state, state + 1, Ordering::Acquire, Ordering::Acquire) {
+                Ok(_) => break,
+                Err(current) => state = current,
+            }
+        }
+        let handle = HandleRef { table, index };
+        if handle.mode() & required_mode != required_mode {
+            return Err(KError::PermissionDenied); // HandleRef düşerken referans bırakılır
+        }
+        Ok(handle)
+    }
+
+    /// Handle'ı kapatır. Değer hemen geçersizleşir; provider, süren işlemler bitince bırakılır.
+    pub fn close(handle_value: u64) -> Result<(), KError> {
+        let index = (handle_value & INDEX_MASK) as usize;
+        if handle_value & TAG_MASK != 0 || index == 0 || index > MAX_HANDLES {
+            return Err(KError::BadHandle);
+        }
+        let index = index - 1;
+        let generation = (handle_value >> GENERATION_SHIFT) as u32;
+        let table = table_of(ksched::current_task()).ok_or(KError::BadHandle)?;
+        close_in(table, index, generation).map_err(|err| {
+            STALE_REJECTS.fetch_add(1, Ordering::Relaxed);
+            err
+        })
+    }
+
+    /// Görevin tüm açık handle'larını kapatır (görev sonlanırken). Tablo yeniden kullanılmak üzere kalır.
+    pub fn release_task(task: u32) {
+        let table = match table_of(task) {
+            Some(table) => table,
+            None => return,
+        };
+        for (index, slot) in table.slots.iter().enumerate() {
+            let state = slot.state.load(Ordering::Acquire);
+            if state & 0xFFFF_FFFF != 0 {
+                let generation = (state >> 32) as u32;
+                // Çakışan bir kapatma kazanırsa BadHandle döner; yuva zaten kapanmıştır.
+                let _ = close_in(table, index, generation);
+            }
+        }
+    }
+
+    fn close_in(table: &'static HandleTable, index: usize, generation: u32) -> Result<(), KError> {
+        let slot = &table.slots[index];
+        let mut state = slot.state.load(Ordering::Acquire);
+        loop {
+            let refs = state & 0xFFFF_FFFF;
+            if (state >> 32) as u32 != generation || refs == 0 {
+                return Err(KError::BadHandle);
+            }
+            // Tablonun referansını bırak ve nesli ilerlet (tek atomik adımda)
+            let next = (next_generation(generation) as u64) << 32 | (refs - 1);
+            match slot.state.compare_exchange_weak(state, next, Ordering::AcqRel, Ordering::Acquire) {
+                Ok(_) => {
+                    if refs == 1 {
+                        reclaim(table, index);
+                    }
+                    return Ok(());
+                }
+                Err(current) => state = current,
+            }
+        }
+    }
+}
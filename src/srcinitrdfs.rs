@@ -0,0 +1,334 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, ResourceProvider, kpager, kregistry};
+
+// --- Açılış Arşivi (initrd) Dosyaları: Yerinde İndeks, Kopyasız Eşleme ---
+// Önyükleyicinin belleğe yüklediği cpio "newc" arşivi açılışta bir kez, yerinde taranır. Arşiv açılmaz ve
+// dosyalar başka bir yere kopyalanmaz: her normal dosya, verisinin arşiv içindeki fiziksel adresini ve
+// boyutunu tutan bir provider olarak "karnal://bootfs/<yol>" adıyla kaydedilir.
+// - read: veriyi kimlik haritalı arşivden doğrudan çağıranın tamponuna kopyalar (ara tampon yok).
+// - mmap_frame: verisi sayfa hizalı dosyaların sayfaları arşivdeki frame'in kendisidir. Arşiv pager'a
+//   sabit aralık olarak verildiği için "/sbin/init" gibi imajlar önbelleğe okunmadan eşlenir, yazılabilir
+//   sayfalar ilk yazmada kopyalanır. Hizasız dosyalar (newc verileri 4 byte hizalıdır) read ile kopyalanır;
+//   kopyasız eşleme için arşiv veriler sayfaya hizalanarak üretilmelidir.
+//
+// Arşiv belleği fiziksel ayırıcıya verilmemiş olmalıdır ve çekirdek ömrü boyunca yerinde kalır.
+// Arşivin yerini mimari low_level_boot_initrd önyükleyicinin bıraktığı yapıdan bulur; cihaz ağacı (DTB)
+// ve multiboot2 okuyucuları burada ortaktır.
+
+pub mod kinitrd {
+    use super::*;
+    use alloc::sync::Arc;
+    use core::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+
+    const PAGE_SIZE: u64 = kpager::PAGE_SIZE;
+
+    // newc başlığı: 6 byte sihirli değer + 13 adet 8 haneli onaltılık alan
+    const HEADER_SIZE: usize = 110;
+    const MAGIC_NEWC: &[u8; 6] = b"070701";
+    const MAGIC_CRC: &[u8; 6] = b"070702";
+    const TRAILER: &[u8] = b"TRAILER!!!";
+    // Alan sırası: ino, mode, uid, gid, nlink, mtime, filesize, devmajor, devminor, rdevmajor, rdevminor, namesize, check
+    const FIELD_MODE: usize = 1;
+    const FIELD_FILESIZE: usize = 6;
+    const FIELD_NAMESIZE: usize = 11;
+
+    const S_IFMT: u64 = 0o170000;
+    const S_IFREG: u64 = 0o100000;
+
+    const ID_PREFIX: &[u8] = b"karnal://bootfs/";
+    const MAX_ID_LEN: usize = 256;
+
+    static REGISTERED: AtomicBool = AtomicBool::new(false);
+
+    // İstatistikler: KARNAL_INFO_INITRD_* ile dışarı verilir.
+    static FILES: AtomicU64 = AtomicU64::new(0);
+    static BYTES: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_INITRD_* ile EŞLEŞMELİDİR)
+    pub const INFO_INITRD_FILES: u32 = 0xD00;
+    pub const INFO_INITRD_BYTES: u32 = 0xD01;
+
+    /// `kkernel::get_info` için: initrd istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_INITRD_FILES => Some(FILES.load(Ordering::Relaxed)),
+            INFO_INITRD_BYTES => Some(BYTES.load(Ordering::Relaxed)),
+            _ => None,
+        }
+    }
+
+    /// Arşivdeki tek bir dosya: verinin fiziksel adresi ve boyutu. Salt okunurdur.
+    struct InitrdFile {
+        data: u64,
+        size: u64,
+    }
+
+    impl ResourceProvider for InitrdFile {
+        fn read(&self, buffer: &mut [u8], offset: u64) -> Result<usize, KError> {
+            if offset >= self.size {
+                return Ok(0);
+            }
+            let count = (self.size - offset).min(buffer.len() as u64) as usize;
+            // Fiziksel bellek kimlik haritalı
+            unsafe { core::ptr::copy_nonoverlapping((self.data + offset) as *const u8, buffer.as_mut_ptr(), count); }
+            Ok(count)
+        }
+
+        fn write(&self, _buffer: &[u8], _offset: u64) -> Result<usize, KError> {
+            Err(KError::PermissionDenied)
+        }
+
+        fn control(&self, _request: u64, _arg: u64) -> Result<i64, KError> {
+            Err(KError::NotSupported)
+        }
+
+        fn mmap_frame(&self, offset: u64, writable: bool) -> Result<u64, KError> {
+            if writable {
+                return Err(KError::PermissionDenied);
+            }
+            let addr = self.data + offset;
+            // Son yarım sayfa arşivdeki sonraki başlığı içerir; pager onu read ile sıfır kuyruklu okur
+            if addr % PAGE_SIZE != 0 || offset.checked_add(PAGE_SIZE).map_or(true, |end| end > self.size) {
+                return Err(KError::NotSupported);
+            }
+            Ok(addr)
+        }
+    }
+
+    fn parse_hex(field: &[u8]) -> Result<u64, KError> {
+        field.iter().try_fold(0u64, |value, &c| {
+            let digit = match c {
+                b'0'..=b'9' => c - b'0',
+                b'a'..=b'f' => c - b'a' + 10,
+                b'A'..=b'F' => c - b'A' + 10,
+                _ => return Err(KError::InvalidArgument),
+            };
+            Ok((value << 4) | digit as u64)
+        })
+    }
+
+    fn align4(value: u64) -> u64 {
+        (value + 3) & !3
+    }
+
+    /// Arşivi yerinde tarar; her normal dosya için `f(yol, veri_ofseti, boyut)` çağırır.
+    /// Ofsetler arşivin başına göredir. Bozuk arşivde InvalidArgument döner.
+    fn for_each_file(archive: &[u8], mut f: impl FnMut(&[u8], u64, u64)) -> Result<(), KError> {
+        let len = archive.len() as u64;
+        let mut pos = 0u64;
+        loop {
+            if pos + HEADER_SIZE as u64 > len {
+                return Err(KError::InvalidArgument); // Bitiş kaydı yok
+            }
+            let header = &archive[pos as usize..pos as usize + HEADER_SIZE];
+            if &header[..6] != MAGIC_NEWC && &header[..6] != MAGIC_CRC {
+                return Err(KError::InvalidArgument);
+            }
+            let field = |i: usize| parse_hex(&header[6 + i * 8..6 + (i + 1) * 8]);
+            let mode = field(FIELD_MODE)?;
+            let file_size = field(FIELD_FILESIZE)?;
+            let name_size = field(FIELD_NAMESIZE)?;
+
+            // İsim NUL ile biter; başlık + isim, veri de 4 byte'a doldurulur
+            let name_start = pos + HEADER_SIZE as u64;
+            let data_start = align4(name_start + name_size);
+            let data_end = data_start.checked_add(file_size).ok_or(KError::InvalidArgument)?;
+            if name_size == 0 || data_end > len {
+                return Err(KError::InvalidArgument);
+            }
+            let name = &archive[name_start as usize..(name_start + name_size - 1) as usize];
+            if name == TRAILER {
+                return Ok(());
+            }
+            if mode & S_IFMT == S_IFREG {
+                f(name, data_start, file_size);
+            }
+            pos = align4(data_end);
+        }
+    }
+
+    /// `[phys_base, phys_base + size)`'daki arşivin dosyalarını kaydeder ve kaydedilen dosya sayısını döner.
+    /// Bir kez çağrılır; arşiv belleği bundan sonra çekirdeğe aittir.
+    pub fn register(phys_base: u64, size: u64) -> Result<usize, KError> {
+        if phys_base == 0 || size < HEADER_SIZE as u64 {
+            return Err(KError::InvalidArgument);
+        }
+        if REGISTERED.swap(true, Ordering::AcqRel) {
+            return Err(KError::AlreadyExists);
+        }
+        // Arşiv kimlik haritalı ve değişmez
+        let archive = unsafe { core::slice::from_raw_parts(phys_base as *const u8, size as usize) };
+
+        // Önce yalnızca doğrula: bozuk arşivden yarım kayıt kalmasın
+        if let Err(e) = for_each_file(archive, |_, _, _| {}) {
+            REGISTERED.store(false, Ordering::Release);
+            return Err(e);
+        }
+
+        // Arşivin tam sayfaları pager'a sabit aralık olarak verilir: doğrudan eşlenir, hiç iade edilmez
+        let first_page = (phys_base + PAGE_SIZE - 1) & !(PAGE_SIZE - 1);
+        let last_page = (phys_base + size) & !(PAGE_SIZE - 1);
+        // Aralık kurulamazsa (tablo dolu) pager mmap_frame'in döndüğü frame'leri kullanmaz, sayfaları read ile kopyalar
+        if last_page > first_page {
+            let _ = kpager::add_fixed_range(first_page, last_page - first_page);
+        }
+
+        let mut count = 0usize;
+        let mut id = [0u8; MAX_ID_LEN];
+        id[..ID_PREFIX.len()].copy_from_slice(ID_PREFIX);
+        let result = for_each_file(archive, |name, data_offset, file_size| {
+            // "./sbin/init" ve "/sbin/init" -> "sbin/init"
+            let path = name.strip_prefix(b"./").or_else(|| name.strip_prefix(b"/")).unwrap_or(name);
+            if path.is_empty() || ID_PREFIX.len() + path.len() > MAX_ID_LEN {
+                return;
+            }
+            let id_len = ID_PREFIX.len() + path.len();
+            id[ID_PREFIX.len()..id_len].copy_from_slice(path);
+            let file = Arc::new(InitrdFile { data: phys_base + data_offset, size: file_size });
+            if kregistry::register(&id[..id_len], file).is_ok() {
+                count += 1;
+                FILES.fetch_add(1, Ordering::Relaxed);
+                BYTES.fetch_add(file_size, Ordering::Relaxed);
+            }
+        });
+        result.map(|_| count)
+    }
+
+    // --- Önyükleyici Bilgisi ---
+    // Yapılar kimlik haritalı fiziksel bellektedir. Okuyucular yalnızca yapının kendi boyut alanıyla sınırlı
+    // aralığa bakar; bozuk yapıda None döner (arşiv yok sayılır).
+
+    const FDT_MAGIC: u32 = 0xD00D_FEED;
+    const FDT_HEADER_SIZE: usize = 40;
+    const FDT_MAX_SIZE: usize = 2 * 1024 * 1024;
+    const FDT_BEGIN_NODE: u32 = 1;
+    const FDT_END_NODE: u32 = 2;
+    const FDT_PROP: u32 = 3;
+    const FDT_NOP: u32 = 4;
+
+    const MB2_HEADER_SIZE: usize = 8;
+    const MB2_MAX_SIZE: usize = 1024 * 1024;
+    const MB2_TAG_END: u32 = 0;
+    const MB2_TAG_MODULE: u32 = 3;
+
+    fn be32(b: &[u8], at: usize) -> Option<u32> {
+        b.get(at..at.checked_add(4)?).map(|v| u32::from_be_bytes([v[0], v[1], v[2], v[3]]))
+    }
+
+    fn le32(b: &[u8], at: usize) -> Option<u32> {
+        b.get(at..at.checked_add(4)?).map(|v| u32::from_le_bytes([v[0], v[1], v[2], v[3]]))
+    }
+
+    // NUL ile biten dizgi (NUL hariç)
+    fn c_string(b: &[u8], at: usize) -> Option<&[u8]> {
+        let tail = b.get(at..)?;
+        tail.iter().position(|&c| c == 0).map(|len| &tail[..len])
+    }
+
+    // Özellik değeri: #address-cells 1 veya 2 (büyük endian)
+    fn fdt_cells(value: &[u8]) -> Option<u64> {
+        match value.len() {
+            4 => be32(value, 0).map(u64::from),
+            8 => Some((u64::from(be32(value, 0)?) << 32) | u64::from(be32(value, 4)?)),
+            _ => None,
+        }
+    }
+
+    /// Düzleştirilmiş cihaz ağacının /chosen düğümündeki "linux,initrd-start" ve "linux,initrd-end"
+    /// özelliklerinden arşivin (taban, boyut) değerini döner.
+    pub fn find_in_fdt(dtb: u64) -> Option<(u64, u64)> {
+        if dtb == 0 {
+            return None;
+        }
+        let header = unsafe { core::slice::from_raw_parts(dtb as *const u8, FDT_HEADER_SIZE) };
+        let total = be32(header, 4)? as usize;
+        if be32(header, 0)? != FDT_MAGIC || total < FDT_HEADER_SIZE || total > FDT_MAX_SIZE {
+            return None;
+        }
+        let blob = unsafe { core::slice::from_raw_parts(dtb as *const u8, total) };
+        let strings = be32(blob, 12)? as usize;
+
+        let (mut start, mut end) = (None, None);
+        let mut depth = 0u32; // Kök düğüm 1, /chosen 2
+        let mut in_chosen = false;
+        let mut at = be32(blob, 8)? as usize;
+        loop {
+            let token = be32(blob, at)?;
+            at += 4;
+            match token {
+                FDT_BEGIN_NODE => {
+                    let name = c_string(blob, at)?;
+                    depth += 1;
+                    in_chosen |= depth == 2 && name == b"chosen";
+                    at = (at + name.len() + 1 + 3) & !3;
+                }
+                FDT_END_NODE => {
+                    if in_chosen && depth == 2 {
+                        break;
+                    }
+                    depth = depth.checked_sub(1)?;
+                }
+                FDT_PROP => {
+                    let len = be32(blob, at)? as usize;
+                    let name_offset = be32(blob, at + 4)? as usize;
+                    let value = blob.get(at + 8..(at + 8).checked_add(len)?)?;
+                    if in_chosen && depth == 2 {
+                        match c_string(blob, strings.checked_add(name_offset)?)? {
+                            b"linux,initrd-start" => start = fdt_cells(value),
+                            b"linux,initrd-end" => end = fdt_cells(value),
+                            _ => {}
+                        }
+                    }
+                    at = (at + 8 + len + 3) & !3;
+                }
+                FDT_NOP => {}
+                _ => break, // FDT_END
+            }
+        }
+        match (start, end) {
+            (Some(start), Some(end)) if end > start => Some((start, end - start)),
+            _ => None,
+        }
+    }
+
+    /// Multiboot2 bilgi yapısındaki ilk modülün (taban, boyut) değerini döner; arşiv önyükleyiciye
+    /// modül olarak verilir.
+    pub fn find_in_multiboot2(info: u64) -> Option<(u64, u64)> {
+        if info == 0 {
+            return None;
+        }
+        let total = unsafe { core::ptr::read_unaligned(info as *const u32) } as usize;
+        if total < MB2_HEADER_SIZE || total > MB2_MAX_SIZE {
+            return None;
+        }
+        let blob = unsafe { core::slice::from_raw_parts(info as *const u8, total) };
+        // Etiketler: (tür, boyut) + veri, 8 byte hizalı
+        let mut at = MB2_HEADER_SIZE;
+        loop {
+            let kind = le32(blob, at)?;
+            let size = le32(blob, at + 4)? as usize;
+            if kind == MB2_TAG_END || size < 8 {
+                return None;
+            }
+            if kind == MB2_TAG_MODULE {
+                let start = u64::from(le32(blob, at + 8)?);
+                let end = u64::from(le32(blob, at + 12)?);
+                return if end > start { Some((start, end - start)) } else { None };
+            }
+            at = (at + size + 7) & !7;
+        }
+    }
+
+    // --- C API ---
+
+    #[no_mangle]
+    pub extern "C" fn karnal_initrd_register(phys_base: u64, size: u64) -> i64 {
+        match register(phys_base, size) {
+            Ok(count) => count as i64,
+            Err(err) => err as i64,
+        }
+    }
+}
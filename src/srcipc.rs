@@ -5,9 +5,15 @@ use super::{
     KError,
     KHandle,
     KTaskId,
+    ResourceProvider,
+    khandle,   // Endpoint handles (HandleRef)
+    kregistry, // Named endpoints
     kresource, // Assuming IPC channels might be managed via resource handles
     ksync,     // For synchronization (blocking send/receive)
     kmemory,   // For safe user buffer access and copying
+    kmsgqueue, // Lock-free bounded message queue (src/srcmsgqueue.rs)
+    ksched,    // Direct handoff for synchronous call/reply
+    kpager,    // Frame reference counts for page-transfer messages
     // Add other necessary imports from super:: if needed (like KThreadId)
 };
 
@@ -19,14 +25,48 @@ use super::{
 #[cfg(feature = "alloc")] // If alloc feature is enabled
 struct Message {
     sender_task: KTaskId, // Optional: Keep track of the sender
-    data: alloc::vec::Vec<u8>,
+    data: MessageData,
 }
 
+// Message payload. Small messages are copied into a kernel buffer; large messages
+// sent with send_pages carry the sender's physical frames and are remapped on receive.
+#[cfg(feature = "alloc")]
+enum MessageData {
+    // Payloads up to IPC_INLINE_MESSAGE_SIZE live in the queue slot itself, no allocation
+    Inline { bytes: [u8; IPC_INLINE_MESSAGE_SIZE], len: u8 },
+    Copied(alloc::vec::Vec<u8>),
+    Pages {
+        frames: alloc::vec::Vec<u64>, // Physical frames, one per KERNEL_PAGE_SIZE page, owned by the message
+        len: usize,                   // Payload length in bytes (the last page may be partial)
+    },
+}
+
+// Must match KERNEL_PAGE_SIZE in kernel_memory.h
+const IPC_PAGE_SIZE: usize = 4096;
+// Upper bound on a single page-transfer message (16 MiB), keeps the frame list bounded
+const IPC_MAX_TRANSFER_PAGES: usize = 4096;
+// Largest payload stored inline in a queue slot (a Message then fits one cache line with its slot header)
+const IPC_INLINE_MESSAGE_SIZE: usize = 32;
+// Queue slots preallocated by create_channel() when the caller does not pick a capacity
+const IPC_DEFAULT_CHANNEL_CAPACITY: usize = 256;
+
 // Represents a message channel/queue.
 struct IpcChannel {
-    // Messages waiting to be received
+    // Messages waiting to be received. Slots are preallocated at channel creation;
+    // send and receive only touch the queue's atomics on the fast path.
+    #[cfg(feature = "alloc")]
+    message_queue: kmsgqueue::MsgQueue<Message>,
+    // Claimed for the duration of a receive (the queue has a single consumer)
+    #[cfg(feature = "alloc")]
+    receiver_busy: core::sync::atomic::AtomicBool,
+    // Claimed for the duration of a send on Spsc channels (the queue has a single producer)
+    #[cfg(feature = "alloc")]
+    sender_busy: core::sync::atomic::AtomicBool,
+    // Number of tasks parked on the wait queues; lets the fast path skip the lock when nobody sleeps
+    #[cfg(feature = "alloc")]
+    parked_senders: core::sync::atomic::AtomicUsize,
     #[cfg(feature = "alloc")]
-    message_queue: alloc::collections::VecDeque<Message>, // Or a linked list, fixed array, etc.
+    parked_receivers: core::sync::atomic::AtomicUsize,
     #[cfg(not(feature = "alloc"))]
     // Placeholder for fixed-size queue if no_std with alloc is not used
     message_queue: [u8; 1024], // Example fixed buffer
@@ -44,7 +84,8 @@ struct IpcChannel {
     // Tasks waiting to receive (queue is empty)
     waiting_receivers: ksync::WaitQueue, // Assuming ksync provides a WaitQueue struct
 
-    // Mutex to protect access to the channel data
+    // Mutex to protect access to the channel data.
+    // With alloc it only serializes parking/waking on the wait queues, never the queue itself.
     lock: ksync::Mutex, // Assuming ksync provides a Mutex
 }
 
@@ -76,8 +117,10 @@ pub mod kmessaging {
     use core::ptr; // For pointer operations
     #[cfg(feature = "alloc")]
     use alloc::boxed::Box; // For dynamic allocation if alloc feature is used
+    use core::sync::atomic::{AtomicBool, Ordering};
     #[cfg(feature = "alloc")]
-    use alloc::collections::VecDeque; // For message queue
+    use core::sync::atomic::AtomicUsize;
+    use alloc::sync::Arc;
 
 
     // Initialize the IPC manager. Called by karnal64::init().
@@ -113,26 +156,7 @@ pub mod kmessaging {
     // A proper implementation would integrate with the kresource resource acquisition flow.
     pub fn create_channel() -> Result<KHandle, KError> {
         #[cfg(feature = "alloc")]
-        unsafe {
-            let manager = IPC_MANAGER.as_mut().ok_or(KError::InternalError)?; // Get mutable ref to manager
-
-            // Create a new channel instance
-            let new_channel = Box::new(super::IpcChannel {
-                message_queue: VecDeque::new(),
-                waiting_senders: ksync::WaitQueue::new(),
-                waiting_receivers: ksync::WaitQueue::new(),
-                lock: ksync::Mutex::new(),
-            });
-
-            // Generate a unique handle value
-            let handle_value = manager.next_handle_value;
-            manager.next_handle_value += 1;
-
-            // Store the channel and associate it with the handle
-            manager.channels.insert(handle_value, new_channel);
-
-            Ok(KHandle(handle_value))
-        }
+        return create_channel_with(IPC_DEFAULT_CHANNEL_CAPACITY, kmsgqueue::QueueKind::Mpsc);
         #[cfg(not(feature = "alloc"))]
         unsafe {
              let _lock = IPC_MANAGER_LOCK.lock(); // Acquire lock
@@ -155,6 +179,115 @@ pub mod kmessaging {
         }
     }
 
+    /// Create a new IPC channel with `capacity` preallocated message slots.
+    /// `kind` selects single-producer (Spsc) or multi-producer (Mpsc) sending; both have one receiver.
+    /// `capacity` is rounded up to a power of two.
+    /// Returns a KHandle for the new channel.
+    #[cfg(feature = "alloc")]
+    pub fn create_channel_with(capacity: usize, kind: kmsgqueue::QueueKind) -> Result<KHandle, KError> {
+        // Allocate the slots before touching the manager, so a failure leaves no trace.
+        let queue = kmsgqueue::MsgQueue::new(capacity, kind)?;
+        unsafe {
+            let manager = IPC_MANAGER.as_mut().ok_or(KError::InternalError)?; // Get mutable ref to manager
+
+            // Create a new channel instance
+            let new_channel = Box::new(super::IpcChannel {
+                message_queue: queue,
+                receiver_busy: AtomicBool::new(false),
+                sender_busy: AtomicBool::new(false),
+                parked_senders: AtomicUsize::new(0),
+                parked_receivers: AtomicUsize::new(0),
+                waiting_senders: ksync::WaitQueue::new(),
+                waiting_receivers: ksync::WaitQueue::new(),
+                lock: ksync::Mutex::new(),
+            });
+
+            // Generate a unique handle value
+            let handle_value = manager.next_handle_value;
+            manager.next_handle_value += 1;
+
+            // Store the channel and associate it with the handle
+            manager.channels.insert(handle_value, new_channel);
+
+            Ok(KHandle(handle_value))
+        }
+    }
+
+    // Clears a busy claim on drop, so every return path of send/receive/reply_and_wait releases it.
+    struct Claim<'a>(&'a AtomicBool);
+    impl<'a> Claim<'a> {
+        fn acquire(flag: &'a AtomicBool) -> Result<Self, KError> {
+            if flag.swap(true, Ordering::Acquire) { Err(KError::Busy) } else { Ok(Claim(flag)) }
+        }
+    }
+    impl<'a> Drop for Claim<'a> {
+        fn drop(&mut self) { self.0.store(false, Ordering::Release); }
+    }
+
+    // Push a message, parking on waiting_senders while the queue is full.
+    // Only takes the channel lock on the slow path (full queue) or when a receiver is parked.
+    // Hands the message back if another task is already sending on an Spsc channel (KError::Busy).
+    #[cfg(feature = "alloc")]
+    fn enqueue(channel: &IpcChannel, mut message: Message) -> Result<(), Message> {
+        let _producer = match channel.message_queue.kind() {
+            kmsgqueue::QueueKind::Spsc => match Claim::acquire(&channel.sender_busy) {
+                Ok(claim) => Some(claim),
+                Err(_) => return Err(message),
+            },
+            kmsgqueue::QueueKind::Mpsc => None,
+        };
+
+        loop {
+            match channel.message_queue.push(message) {
+                Ok(()) => break,
+                Err(returned) => message = returned,
+            }
+            // Announce the park first, then re-check under the lock: a receiver that pops after
+            // our check sees parked_senders != 0 and wakes us, so the wakeup cannot be lost.
+            channel.parked_senders.fetch_add(1, Ordering::SeqCst);
+            let _channel_lock = channel.lock.lock();
+            if channel.message_queue.is_full() {
+                channel.lock.unlock();
+                channel.waiting_senders.wait(&_channel_lock); // Wait and re-acquire lock on wake
+            }
+            channel.lock.unlock();
+            channel.parked_senders.fetch_sub(1, Ordering::SeqCst);
+        }
+
+        if channel.parked_receivers.load(Ordering::SeqCst) != 0 {
+            let _channel_lock = channel.lock.lock();
+            channel.waiting_receivers.wake_one();
+            channel.lock.unlock();
+        }
+        Ok(())
+    }
+
+    // Pop a message, parking on waiting_receivers while the queue is empty.
+    // The caller must hold the channel's receiver claim.
+    #[cfg(feature = "alloc")]
+    fn dequeue(channel: &IpcChannel) -> Message {
+        let message = loop {
+            if let Some(message) = unsafe { channel.message_queue.pop() } {
+                break message;
+            }
+            channel.parked_receivers.fetch_add(1, Ordering::SeqCst);
+            let _channel_lock = channel.lock.lock();
+            if channel.message_queue.is_empty() {
+                channel.lock.unlock();
+                channel.waiting_receivers.wait(&_channel_lock); // Wait and re-acquire lock
+            }
+            channel.lock.unlock();
+            channel.parked_receivers.fetch_sub(1, Ordering::SeqCst);
+        };
+
+        if channel.parked_senders.load(Ordering::SeqCst) != 0 {
+            let _channel_lock = channel.lock.lock();
+            channel.waiting_senders.wake_one();
+            channel.lock.unlock();
+        }
+        message
+    }
+
     /// Send a message to an IPC channel.
     /// `handle_value`: The handle of the destination channel.
     /// `user_buffer_ptr`: Pointer to the user-space buffer containing the message data.
@@ -189,12 +322,12 @@ pub mod kmessaging {
         };
 
 
-        // 3. Acquire the channel's internal lock
+        // 3. Acquire the channel's internal lock (fixed buffer only, the alloc queue is lock-free)
+        #[cfg(not(feature = "alloc"))]
         let _channel_lock = channel.lock.lock(); // Assuming Mutex::lock blocks and returns a guard
 
-        // 4. Check if the queue is full (if applicable) and wait if needed
-        // For simplicity in this example, let's assume an unbounded queue if alloc is used,
-        // or handle the fixed-size queue case.
+        // 4. Check if the queue is full and wait if needed
+        // With alloc, enqueue() below waits for a free slot itself.
         #[cfg(not(feature = "alloc"))]
         while channel.count == channel.capacity {
             // Queue is full, task needs to wait
@@ -207,20 +340,28 @@ pub mod kmessaging {
         // 5. Copy data from user buffer to kernel buffer/message structure
         #[cfg(feature = "alloc")]
         {
-            // Create a kernel buffer and copy data from user space
-            let mut kernel_buffer = alloc::vec::Vec::with_capacity(user_buffer_len);
-            unsafe {
+            // Small messages are copied straight into the slot; larger ones get a kernel buffer
+            let data = if user_buffer_len <= IPC_INLINE_MESSAGE_SIZE {
+                let mut bytes = [0u8; IPC_INLINE_MESSAGE_SIZE];
                 // Security: This assumes kmemory::copy_from_user is safe and validates!
-                kmemory::copy_from_user(kernel_buffer.as_mut_ptr(), user_buffer_ptr, user_buffer_len)?;
-                kernel_buffer.set_len(user_buffer_len); // Set the actual length after copy
-            }
+                kmemory::copy_from_user(bytes.as_mut_ptr(), user_buffer_ptr, user_buffer_len)?;
+                super::MessageData::Inline { bytes, len: user_buffer_len as u8 }
+            } else {
+                let mut kernel_buffer = alloc::vec::Vec::with_capacity(user_buffer_len);
+                unsafe {
+                    // Security: This assumes kmemory::copy_from_user is safe and validates!
+                    kmemory::copy_from_user(kernel_buffer.as_mut_ptr(), user_buffer_ptr, user_buffer_len)?;
+                    kernel_buffer.set_len(user_buffer_len); // Set the actual length after copy
+                }
+                super::MessageData::Copied(kernel_buffer)
+            };
 
-            // Create a message and add to the queue
+            // Create a message and add to the queue (6./7. wake-up is done by enqueue)
             let message = super::Message {
                 sender_task: ktask::current_task_id(), // Get current task ID (placeholder)
-                data: kernel_buffer,
+                data,
             };
-            channel.message_queue.push_back(message);
+            enqueue(channel, message).map_err(|_| KError::Busy)?;
              super::kkernel::println!("IPC: Message sent to handle {}. Size: {}", handle_value, user_buffer_len);
 
         }
@@ -244,14 +385,61 @@ pub mod kmessaging {
 
 
         // 6. Wake up any waiting receivers
+        #[cfg(not(feature = "alloc"))]
         channel.waiting_receivers.wake_one(); // Wake one receiver
 
         // 7. Release the channel's internal lock
+        #[cfg(not(feature = "alloc"))]
         channel.lock.unlock();
 
         Ok(()) // Success
     }
 
+    /// Send a small kernel-originated message (notifications) without ever blocking.
+    /// `payload` is a kernel buffer of at most IPC_INLINE_MESSAGE_SIZE bytes.
+    /// Returns KError::Busy if the queue is full (or another sender holds an Spsc channel); the
+    /// message is dropped and the caller decides whether that matters. Safe to call from any thread.
+    pub fn try_send(handle_value: u64, payload: &[u8]) -> Result<(), KError> {
+        if payload.len() > IPC_INLINE_MESSAGE_SIZE {
+            return Err(KError::InvalidArgument);
+        }
+        if handle_value == 0 { return Err(KError::BadHandle); }
+
+        #[cfg(feature = "alloc")]
+        {
+            let channel = unsafe {
+                IPC_MANAGER.as_ref()
+                    .ok_or(KError::InternalError)?
+                    .channels.get(&handle_value)
+                    .ok_or(KError::BadHandle)?
+                    .as_ref()
+            };
+            let _producer = match channel.message_queue.kind() {
+                kmsgqueue::QueueKind::Spsc => Some(Claim::acquire(&channel.sender_busy)?),
+                kmsgqueue::QueueKind::Mpsc => None,
+            };
+            let mut bytes = [0u8; IPC_INLINE_MESSAGE_SIZE];
+            bytes[..payload.len()].copy_from_slice(payload);
+            let message = super::Message {
+                sender_task: ktask::current_task_id(),
+                data: super::MessageData::Inline { bytes, len: payload.len() as u8 },
+            };
+            // Single attempt: unlike enqueue() we never park on waiting_senders
+            channel.message_queue.push(message).map_err(|_| KError::Busy)?;
+            if channel.parked_receivers.load(Ordering::SeqCst) != 0 {
+                let _channel_lock = channel.lock.lock();
+                channel.waiting_receivers.wake_one();
+                channel.lock.unlock();
+            }
+            Ok(())
+        }
+        #[cfg(not(feature = "alloc"))]
+        {
+            // The fixed byte buffer has no message boundaries to drop at; notifications need the alloc queue
+            Err(KError::NotSupported)
+        }
+    }
+
     /// Receive a message from an IPC channel.
     /// `handle_value`: The handle of the source channel.
     /// `user_buffer_ptr`: Pointer to the user-space buffer where the message data will be copied.
@@ -283,18 +471,14 @@ pub mod kmessaging {
             IPC_CHANNELS[index].as_ref().ok_or(KError::BadHandle)?
          };
 
-        // 3. Acquire the channel's internal lock
+        // 3. Acquire the channel's internal lock (fixed buffer), or the receiver claim (alloc queue)
+        // A channel has a single receiver; a concurrent receive on the same channel gets Busy.
+        #[cfg(feature = "alloc")]
+        let _receiver = Claim::acquire(&channel.receiver_busy)?;
+        #[cfg(not(feature = "alloc"))]
         let _channel_lock = channel.lock.lock();
 
-        // 4. Check if the queue is empty and wait if needed
-        #[cfg(feature = "alloc")]
-        while channel.message_queue.is_empty() {
-            // Queue is empty, task needs to wait
-            // Release channel lock before waiting!
-            channel.lock.unlock(); // Explicit unlock
-            channel.waiting_receivers.wait(&_channel_lock); // Wait and re-acquire lock
-            // Re-acquire channel lock after waking
-        }
+        // 4. Check if the queue is empty and wait if needed (alloc: dequeue() waits itself)
          #[cfg(not(feature = "alloc"))]
          while channel.count == 0 {
              // Queue is empty, task needs to wait
@@ -306,23 +490,31 @@ pub mod kmessaging {
         // 5. Get the next message from the queue and copy data to user buffer
         #[cfg(feature = "alloc")]
         {
-            let message = channel.message_queue.pop_front().ok_or(KError::InternalError)?; // Should not fail due to while loop check
-
-            let bytes_to_copy = core::cmp::min(user_buffer_len, message.data.len());
-            unsafe {
-                // Security: This assumes kmemory::copy_to_user is safe and validates!
-                kmemory::copy_to_user(user_buffer_ptr, message.data.as_ptr(), bytes_to_copy)?;
-            }
+            // Waits for a message and wakes a parked sender (6./7. below)
+            let message = dequeue(channel);
+
+            let bytes_to_copy = match message.data {
+                super::MessageData::Inline { bytes, len } => {
+                    let bytes_to_copy = core::cmp::min(user_buffer_len, len as usize);
+                    kmemory::copy_to_user(user_buffer_ptr, bytes.as_ptr(), bytes_to_copy)?;
+                    bytes_to_copy
+                }
+                super::MessageData::Copied(data) => {
+                    let bytes_to_copy = core::cmp::min(user_buffer_len, data.len());
+                    unsafe {
+                        // Security: This assumes kmemory::copy_to_user is safe and validates!
+                        kmemory::copy_to_user(user_buffer_ptr, data.as_ptr(), bytes_to_copy)?;
+                    }
+                    bytes_to_copy
+                }
+                super::MessageData::Pages { frames, len } => {
+                    receive_pages(user_buffer_ptr, user_buffer_len, frames, len)?
+                }
+            };
             super::kkernel::println!("IPC: Message received from handle {}. Size: {}", handle_value, bytes_to_copy);
             // Optional: Handle case where user buffer is too small (truncate or return error)
             // For now, we truncate by only copying `bytes_to_copy`. User needs to check return size.
 
-            // 6. Wake up any waiting senders (if queue was full)
-            channel.waiting_senders.wake_one();
-
-            // 7. Release the channel's internal lock
-            channel.lock.unlock();
-
             Ok(bytes_to_copy) // Return number of bytes received
         }
         #[cfg(not(feature = "alloc"))]
@@ -359,6 +551,522 @@ pub mod kmessaging {
 
     }
 
+    /// Send a message by transferring its pages instead of copying them.
+    /// `user_buffer_ptr` must be IPC_PAGE_SIZE aligned. The covered pages are unmapped from the
+    /// sender and their frames travel with the message, so the sender must not touch the range afterwards.
+    /// Returns Ok(()) on success, KError on failure.
+    #[cfg(feature = "alloc")]
+    pub fn send_pages(handle_value: u64, user_buffer_ptr: *const u8, user_buffer_len: usize) -> Result<(), KError> {
+        if user_buffer_len == 0 || (user_buffer_ptr as usize) % IPC_PAGE_SIZE != 0 {
+            return Err(KError::InvalidArgument);
+        }
+        let page_count = (user_buffer_len + IPC_PAGE_SIZE - 1) / IPC_PAGE_SIZE;
+        if page_count > IPC_MAX_TRANSFER_PAGES {
+            return Err(KError::InvalidArgument);
+        }
+        if !kmemory::is_user_buffer_valid_and_readable(user_buffer_ptr, page_count * IPC_PAGE_SIZE) {
+            return Err(KError::BadAddress);
+        }
+        if handle_value == 0 { return Err(KError::BadHandle); }
+
+        let channel = unsafe {
+            IPC_MANAGER.as_ref()
+                .ok_or(KError::InternalError)?
+                .channels.get(&handle_value)
+                .ok_or(KError::BadHandle)?
+                .as_ref()
+        };
+
+        // Resolve every frame before unmapping anything, so a hole in the range leaves the sender intact.
+        let base = user_buffer_ptr as u64;
+        let mut frames = alloc::vec::Vec::with_capacity(page_count);
+        for i in 0..page_count {
+            let frame = kmemory::translate_user_page(base + (i * IPC_PAGE_SIZE) as u64).ok_or(KError::BadAddress)?;
+            frames.push(frame);
+        }
+        // One range unmap: a single batched TLB flush/shootdown instead of one per page.
+        kmemory::unmap_user_range(base, page_count * IPC_PAGE_SIZE)?;
+
+        // Frames are already unmapped from the sender; a failure here must hand them back.
+        let message = super::Message {
+            sender_task: ktask::current_task_id(),
+            data: super::MessageData::Pages { frames, len: user_buffer_len },
+        };
+        if let Err(returned) = enqueue(channel, message) {
+            if let super::MessageData::Pages { frames, .. } = returned.data {
+                for (i, &frame) in frames.iter().enumerate() {
+                    let _ = kmemory::map_user_page(base + (i * IPC_PAGE_SIZE) as u64, frame);
+                }
+            }
+            return Err(KError::Busy);
+        }
+        super::kkernel::println!("IPC: {} pages transferred to handle {}. Size: {}", page_count, handle_value, user_buffer_len);
+
+        Ok(())
+    }
+
+    /// Deliver a page-transfer message to the receiver.
+    /// If the receive buffer is page aligned and large enough, the frames are mapped in place
+    /// (the receiver's old frames under that range are released). Otherwise the payload is copied
+    /// out of the frames. Every frame the receiver does not end up mapping is released through the
+    /// pager, on success and on error. Returns the number of bytes delivered.
+    #[cfg(feature = "alloc")]
+    fn receive_pages(user_buffer_ptr: *mut u8, user_buffer_len: usize, mut frames: alloc::vec::Vec<u64>, len: usize) -> Result<usize, KError> {
+        let base = user_buffer_ptr as u64;
+        let fits = (user_buffer_ptr as usize) % IPC_PAGE_SIZE == 0 && user_buffer_len >= frames.len() * IPC_PAGE_SIZE;
+
+        if fits {
+            // A frame the sender still shares (COW, zero frame) must not become writable here: take a private copy.
+            for i in 0..frames.len() {
+                match kpager::make_exclusive(frames[i]) {
+                    Some(frame) => frames[i] = frame,
+                    None => {
+                        release_frames(&frames);
+                        return Err(KError::OutOfMemory);
+                    }
+                }
+            }
+            for (i, &frame) in frames.iter().enumerate() {
+                if let Err(e) = replace_user_page(base + (i * IPC_PAGE_SIZE) as u64, frame) {
+                    // frames[..i] are mapped and now belong to the receiver's address space
+                    release_frames(&frames[i..]);
+                    return Err(e);
+                }
+            }
+            return Ok(len);
+        }
+
+        // Fallback: copy page by page out of the frames (kernel reaches frames through the identity map).
+        let bytes_to_copy = core::cmp::min(user_buffer_len, len);
+        let mut copied = 0;
+        let mut result = Ok(bytes_to_copy);
+        for &frame in frames.iter() {
+            if copied < bytes_to_copy && result.is_ok() {
+                let chunk = core::cmp::min(IPC_PAGE_SIZE, bytes_to_copy - copied);
+                if let Err(e) = kmemory::copy_to_user(unsafe { user_buffer_ptr.add(copied) }, frame as *const u8, chunk) {
+                    result = Err(e);
+                }
+                copied += chunk;
+            }
+        }
+        release_frames(&frames);
+        result
+    }
+
+    /// Map `frame` at `vaddr` in the receiver, dropping whatever was mapped there through the pager's refcount
+    /// (the old page may still be shared with another address space, or be the zero frame).
+    #[cfg(feature = "alloc")]
+    fn replace_user_page(vaddr: u64, frame: u64) -> Result<(), KError> {
+        if let Some(old_frame) = kmemory::translate_user_page(vaddr) {
+            kmemory::unmap_user_page(vaddr)?;
+            kmemory::release_frame(old_frame);
+        }
+        kmemory::map_user_page(vaddr, frame)
+    }
+
+    #[cfg(feature = "alloc")]
+    fn release_frames(frames: &[u64]) {
+        for &frame in frames {
+            kmemory::release_frame(frame);
+        }
+    }
+
+    // --- Synchronous call/reply endpoints ---
+    // L4-style RPC without the channel queue: a caller blocks in `call` until the server answers, and the
+    // server answers and waits for the next request in a single `reply_and_wait`. When the other side is
+    // already parked, the CPU is handed to it directly (ksched::block_and_handoff), skipping the run queue,
+    // so a round trip is two syscalls and two switches on the same CPU.
+    //
+    // Messages are at most IPC_CALL_MAX_SIZE bytes and travel in a CallFrame on the caller's kernel stack,
+    // the in-kernel analogue of message registers: nothing is allocated or queued, the request is copied
+    // from the caller once and to the server once (and the reply likewise). Callers that arrive while the
+    // server is busy are linked through their frames in FIFO order. Larger payloads should use send_pages.
+    //
+    // Each endpoint has a single server thread at a time; a concurrent reply_and_wait gets Busy.
+    //
+    // Endpoints are resource providers (EndpointProvider) and are only reached through khandle: a handle
+    // resolves to an endpoint through the provider it holds, so a value cannot be forged or carried into
+    // another task. An endpoint created with a name is also published in the registry, and clients in
+    // other tasks take their own handle with resource_acquire. The owner ends the endpoint with
+    // destroy_endpoint, or implicitly by exiting (release_task): pending and later calls and the parked
+    // server fail with BadHandle. The slot is reused once the last handle to the provider is gone.
+
+    /// Largest request or reply carried by call/reply_and_wait (must match KARNAL_IPC_CALL_MAX_SIZE)
+    pub const IPC_CALL_MAX_SIZE: usize = 128;
+    /// Longest registry name an endpoint can be published under (must match KARNAL_IPC_ENDPOINT_NAME_MAX)
+    pub const IPC_ENDPOINT_NAME_MAX: usize = 64;
+    const MAX_ENDPOINTS: usize = 64;
+
+    // Lives on the caller's kernel stack for the duration of the call.
+    struct CallFrame {
+        request: [u8; IPC_CALL_MAX_SIZE],
+        request_len: usize,
+        reply: [u8; IPC_CALL_MAX_SIZE],
+        reply_len: usize,
+        caller_slot: u32,
+        caller_seq: u32,
+        done: bool,
+        failed: bool, // Endpoint destroyed before a reply
+        next: *mut CallFrame,
+    }
+
+    // Lives on the server's kernel stack while it is parked waiting for a request.
+    struct ServerWait {
+        slot: u32,
+        seq: u32,
+        frame: *mut CallFrame, // Filled in by the caller that wakes the server; stays null if the endpoint is destroyed
+    }
+
+    struct EndpointState {
+        in_use: bool,          // Slot allocated; cleared when the last handle to the provider is dropped
+        dead: bool,            // Destroyed: no new calls or waits
+        owner_task: u32,
+        name: [u8; IPC_ENDPOINT_NAME_MAX],
+        name_len: usize,       // 0: not published in the registry
+        server: *mut ServerWait,   // Parked server, or null
+        replying: *mut CallFrame,  // Caller whose request the server holds and still owes a reply
+        callers_head: *mut CallFrame,
+        callers_tail: *mut CallFrame,
+    }
+
+    // Raw pointers only ever point into blocked threads' stacks and are used under the endpoint lock
+    unsafe impl Send for EndpointState {}
+
+    struct Endpoint {
+        state: spin::Mutex<EndpointState>,
+        server_busy: AtomicBool,
+    }
+
+    impl Endpoint {
+        const INIT: Endpoint = Endpoint {
+            state: spin::Mutex::new(EndpointState {
+                in_use: false,
+                dead: false,
+                owner_task: 0,
+                name: [0; IPC_ENDPOINT_NAME_MAX],
+                name_len: 0,
+                server: ptr::null_mut(),
+                replying: ptr::null_mut(),
+                callers_head: ptr::null_mut(),
+                callers_tail: ptr::null_mut(),
+            }),
+            server_busy: AtomicBool::new(false),
+        };
+    }
+
+    static ENDPOINTS: [Endpoint; MAX_ENDPOINTS] = [Endpoint::INIT; MAX_ENDPOINTS];
+
+    extern "C" {
+        fn low_level_interrupt_save() -> u64;
+        fn low_level_interrupt_restore(state: u64);
+    }
+
+    // The handle-facing side of an endpoint. Holds its slot for as long as any handle (or the registry) does.
+    struct EndpointProvider {
+        index: usize,
+    }
+
+    impl ResourceProvider for EndpointProvider {
+        fn read(&self, _buffer: &mut [u8], _offset: u64) -> Result<usize, KError> {
+            Err(KError::NotSupported) // Use call/reply_and_wait
+        }
+
+        fn write(&self, _buffer: &[u8], _offset: u64) -> Result<usize, KError> {
+            Err(KError::NotSupported)
+        }
+
+        fn control(&self, _request: u64, _arg: u64) -> Result<i64, KError> {
+            Err(KError::NotSupported)
+        }
+
+        fn ipc_endpoint(&self) -> Option<usize> {
+            Some(self.index)
+        }
+    }
+
+    impl Drop for EndpointProvider {
+        fn drop(&mut self) {
+            let endpoint = &ENDPOINTS[self.index];
+            // An unnamed endpoint whose owner closed its only handle was never destroyed explicitly
+            shutdown(endpoint);
+            with_state(endpoint, |state| state.in_use = false);
+        }
+    }
+
+    // Endpoint locks are taken with interrupts off (call/reply_and_wait hold them across prepare_block)
+    fn with_state<R>(endpoint: &Endpoint, f: impl FnOnce(&mut EndpointState) -> R) -> R {
+        let irq = unsafe { low_level_interrupt_save() };
+        let result = f(&mut endpoint.state.lock());
+        unsafe { low_level_interrupt_restore(irq) };
+        result
+    }
+
+    // Resolve an endpoint handle. The returned reference keeps the endpoint's slot allocated while held.
+    fn endpoint_of(handle_value: u64) -> Result<(khandle::HandleRef, &'static Endpoint), KError> {
+        let handle = kresource::get_handle(handle_value, 0)?;
+        let index = handle.provider().ipc_endpoint().ok_or(KError::BadHandle)?;
+        let endpoint = ENDPOINTS.get(index).ok_or(KError::BadHandle)?;
+        Ok((handle, endpoint))
+    }
+
+    /// Create a call/reply endpoint owned by the current task and return its handle. A non-empty name
+    /// (user pointer, at most IPC_ENDPOINT_NAME_MAX bytes) also publishes it in the resource registry.
+    pub fn create_endpoint(name_ptr: *const u8, name_len: usize) -> Result<KHandle, KError> {
+        if name_len > IPC_ENDPOINT_NAME_MAX {
+            return Err(KError::InvalidArgument);
+        }
+        let mut name = [0u8; IPC_ENDPOINT_NAME_MAX];
+        if name_len > 0 {
+            if !kmemory::is_user_buffer_valid_and_readable(name_ptr, name_len) {
+                return Err(KError::BadAddress);
+            }
+            kmemory::copy_from_user(name.as_mut_ptr(), name_ptr, name_len)?;
+        }
+
+        let owner_task = ksched::current_task();
+        let index = ENDPOINTS.iter().position(|endpoint| with_state(endpoint, |state| {
+            let free = !state.in_use;
+            if free {
+                state.in_use = true;
+                state.dead = false;
+                state.owner_task = owner_task;
+                state.name = name;
+                state.name_len = name_len;
+            }
+            free
+        })).ok_or(KError::OutOfMemory)?;
+
+        // From here on the provider owns the slot: dropping it on an error path frees it again
+        let provider: Arc<dyn ResourceProvider> = Arc::new(EndpointProvider { index });
+        if name_len > 0 {
+            kregistry::register(&name[..name_len], provider.clone())?;
+        }
+        kresource::issue_handle(provider, kresource::MODE_READ | kresource::MODE_WRITE).map_err(|e| {
+            if name_len > 0 {
+                let _ = kregistry::unregister(&name[..name_len]);
+            }
+            e
+        })
+    }
+
+    /// Destroy an endpoint created by the current task and close `handle_value`. Callers waiting on it
+    /// and its parked server return BadHandle; the name, if any, is removed from the registry.
+    pub fn destroy_endpoint(handle_value: u64) -> Result<(), KError> {
+        let (handle, endpoint) = endpoint_of(handle_value)?;
+        if with_state(endpoint, |state| state.owner_task) != ksched::current_task() {
+            return Err(KError::PermissionDenied);
+        }
+        destroy(endpoint);
+        drop(handle);
+        kresource::release_handle(handle_value)
+    }
+
+    /// Destroy every endpoint `task` created (called when the task's last thread exits).
+    pub fn release_task(task: u32) {
+        for endpoint in ENDPOINTS.iter() {
+            if with_state(endpoint, |state| state.in_use && !state.dead && state.owner_task == task) {
+                destroy(endpoint);
+            }
+        }
+    }
+
+    fn destroy(endpoint: &Endpoint) {
+        let (name, name_len) = with_state(endpoint, |state| (state.name, core::mem::replace(&mut state.name_len, 0)));
+        shutdown(endpoint);
+        // Dropping the registry's reference may free the slot (EndpointProvider::drop), so it comes last.
+        // The registry waits for readers here; interrupts are enabled.
+        if name_len > 0 {
+            let _ = kregistry::unregister(&name[..name_len]);
+        }
+    }
+
+    // Mark the endpoint dead and fail everyone blocked on it.
+    fn shutdown(endpoint: &Endpoint) {
+        let irq = unsafe { low_level_interrupt_save() };
+        let mut state = endpoint.state.lock();
+        state.dead = true;
+        let server = core::mem::replace(&mut state.server, ptr::null_mut());
+        let replying = core::mem::replace(&mut state.replying, ptr::null_mut());
+        let mut caller = core::mem::replace(&mut state.callers_head, ptr::null_mut());
+        state.callers_tail = ptr::null_mut();
+        drop(state);
+
+        // Unlinked frames belong to threads that only we can wake now, so they stay valid until woken
+        if !replying.is_null() {
+            let (slot, seq) = unsafe {
+                (*replying).failed = true;
+                ((*replying).caller_slot, (*replying).caller_seq)
+            };
+            ksched::wake_waiter(slot, seq);
+        }
+        while !caller.is_null() {
+            let (slot, seq, next) = unsafe {
+                (*caller).failed = true;
+                ((*caller).caller_slot, (*caller).caller_seq, (*caller).next)
+            };
+            ksched::wake_waiter(slot, seq);
+            caller = next;
+        }
+        if !server.is_null() {
+            let (slot, seq) = unsafe { ((*server).slot, (*server).seq) };
+            ksched::wake_waiter(slot, seq);
+        }
+        unsafe { low_level_interrupt_restore(irq) };
+    }
+
+    /// Send a request to the endpoint's server and block until it replies.
+    /// Returns the number of reply bytes copied to `reply_ptr` (truncated to `reply_cap`).
+    pub fn call(handle_value: u64, request_ptr: *const u8, request_len: usize, reply_ptr: *mut u8, reply_cap: usize) -> Result<usize, KError> {
+        if request_len > IPC_CALL_MAX_SIZE {
+            return Err(KError::InvalidArgument);
+        }
+        if request_len > 0 && !kmemory::is_user_buffer_valid_and_readable(request_ptr, request_len) {
+            return Err(KError::BadAddress);
+        }
+        if reply_cap > 0 && !kmemory::is_user_buffer_valid_and_writable(reply_ptr, reply_cap) {
+            return Err(KError::BadAddress);
+        }
+        let (_handle, endpoint) = endpoint_of(handle_value)?;
+        let caller_slot = ksched::current_slot().ok_or(KError::NotSupported)?;
+
+        let mut frame = CallFrame {
+            request: [0; IPC_CALL_MAX_SIZE],
+            request_len,
+            reply: [0; IPC_CALL_MAX_SIZE],
+            reply_len: 0,
+            caller_slot,
+            caller_seq: 0,
+            done: false,
+            failed: false,
+            next: ptr::null_mut(),
+        };
+        kmemory::copy_from_user(frame.request.as_mut_ptr(), request_ptr, request_len)?;
+
+        // Interrupts stay off from prepare_block until we are switched back (ksched contract)
+        let irq = unsafe { low_level_interrupt_save() };
+        frame.caller_seq = ksched::prepare_block();
+        let mut state = endpoint.state.lock();
+        if state.dead {
+            drop(state);
+            ksched::cancel_block();
+            unsafe { low_level_interrupt_restore(irq) };
+            return Err(KError::BadHandle);
+        }
+        let server = state.server;
+        if !server.is_null() {
+            // Server is parked: give it our frame and run it right here
+            state.server = ptr::null_mut();
+            state.replying = &mut frame;
+            let (slot, seq) = unsafe {
+                (*server).frame = &mut frame;
+                ((*server).slot, (*server).seq)
+            };
+            drop(state);
+            ksched::block_and_handoff(slot, seq);
+        } else {
+            if state.callers_tail.is_null() {
+                state.callers_head = &mut frame;
+            } else {
+                unsafe { (*state.callers_tail).next = &mut frame };
+            }
+            state.callers_tail = &mut frame;
+            drop(state);
+            ksched::block();
+        }
+        unsafe { low_level_interrupt_restore(irq) };
+
+        // Only the server's reply or the endpoint's shutdown wakes this block (the wake carries our seq)
+        if frame.failed {
+            return Err(KError::BadHandle);
+        }
+        debug_assert!(frame.done);
+        let bytes_to_copy = core::cmp::min(reply_cap, frame.reply_len);
+        kmemory::copy_to_user(reply_ptr, frame.reply.as_ptr(), bytes_to_copy)?;
+        Ok(bytes_to_copy)
+    }
+
+    /// Reply to the current caller (if any) and wait for the next request on the endpoint.
+    /// The first call of a server passes an empty reply. Returns the request length copied to
+    /// `recv_ptr` (truncated to `recv_cap`).
+    pub fn reply_and_wait(handle_value: u64, reply_ptr: *const u8, reply_len: usize, recv_ptr: *mut u8, recv_cap: usize) -> Result<usize, KError> {
+        if reply_len > IPC_CALL_MAX_SIZE {
+            return Err(KError::InvalidArgument);
+        }
+        if reply_len > 0 && !kmemory::is_user_buffer_valid_and_readable(reply_ptr, reply_len) {
+            return Err(KError::BadAddress);
+        }
+        if recv_cap > 0 && !kmemory::is_user_buffer_valid_and_writable(recv_ptr, recv_cap) {
+            return Err(KError::BadAddress);
+        }
+        let (_handle, endpoint) = endpoint_of(handle_value)?;
+        let server_slot = ksched::current_slot().ok_or(KError::NotSupported)?;
+        let _server = Claim::acquire(&endpoint.server_busy)?;
+
+        // Copy the reply in before touching the endpoint (a fault here must not strand the caller)
+        let mut reply = [0u8; IPC_CALL_MAX_SIZE];
+        kmemory::copy_from_user(reply.as_mut_ptr(), reply_ptr, reply_len)?;
+
+        let mut wait = ServerWait { slot: server_slot, seq: 0, frame: ptr::null_mut() };
+        let irq = unsafe { low_level_interrupt_save() };
+        let mut state = endpoint.state.lock();
+        if state.dead {
+            // shutdown already failed the caller we owed a reply
+            drop(state);
+            unsafe { low_level_interrupt_restore(irq) };
+            return Err(KError::BadHandle);
+        }
+
+        // Complete the previous call. The caller stays blocked until we wake it below, so its frame is live.
+        let mut replied = None;
+        if !state.replying.is_null() {
+            let frame = unsafe { &mut *state.replying };
+            frame.reply[..reply_len].copy_from_slice(&reply[..reply_len]);
+            frame.reply_len = reply_len;
+            frame.done = true;
+            replied = Some((frame.caller_slot, frame.caller_seq));
+            state.replying = ptr::null_mut();
+        }
+
+        let frame = if !state.callers_head.is_null() {
+            // A caller is already waiting: take it, wake the replied caller normally and keep running
+            let frame = state.callers_head;
+            state.callers_head = unsafe { (*frame).next };
+            if state.callers_head.is_null() {
+                state.callers_tail = ptr::null_mut();
+            }
+            state.replying = frame;
+            drop(state);
+            if let Some((slot, seq)) = replied {
+                ksched::wake_waiter(slot, seq);
+            }
+            frame
+        } else {
+            // Park, and hand the CPU straight back to the caller we just answered
+            wait.seq = ksched::prepare_block();
+            state.server = &mut wait;
+            drop(state);
+            match replied {
+                Some((slot, seq)) => ksched::block_and_handoff(slot, seq),
+                None => ksched::block(),
+            }
+            if wait.frame.is_null() {
+                // Woken by shutdown: the endpoint was destroyed while we were parked
+                unsafe { low_level_interrupt_restore(irq) };
+                return Err(KError::BadHandle);
+            }
+            wait.frame // Set by the caller that woke us; it also made itself `replying`
+        };
+        // The caller is blocked until our next reply_and_wait, so its frame stays valid
+        let request_len = unsafe { (*frame).request_len };
+        let mut request = [0u8; IPC_CALL_MAX_SIZE];
+        request[..request_len].copy_from_slice(unsafe { &(*frame).request[..request_len] });
+        unsafe { low_level_interrupt_restore(irq) };
+
+        let bytes_to_copy = core::cmp::min(recv_cap, request_len);
+        kmemory::copy_to_user(recv_ptr, request.as_ptr(), bytes_to_copy)?;
+        Ok(bytes_to_copy)
+    }
+
     // TODO: Add a close_channel function to release the channel handle and resources.
     // This should likely be tied to the kresource::resource_release mechanism for IPC handles.
 
@@ -412,27 +1120,22 @@ pub mod kmessaging {
          }
 
 
-         // Basic Mutex - Placeholder, needs scheduler interaction for blocking
-         // Should integrate with WaitQueue
+         // Channel mutex backed by the kernel's adaptive lock (src/srcmutex.rs): spins while the
+         // owner runs on another CPU, parks on the futex wait queue otherwise.
          pub struct Mutex<T: ?Sized> {
-             locked: AtomicBool, // Simple state
+             raw: crate::kmutex::AdaptiveMutex,
              data: UnsafeCell<T>, // The protected data (not used in IpcChannel's lock)
-             // Need a wait queue here!
          }
 
          impl<T> Mutex<T> {
              pub const fn new(data: T) -> Self {
                  Mutex {
-                     locked: AtomicBool::new(false),
+                     raw: crate::kmutex::AdaptiveMutex::new(),
                      data: UnsafeCell::new(data),
                  }
              }
              pub fn lock(&self) -> MutexGuard<T> {
-                 while self.locked.swap(true, Ordering::Acquire) {
-                    // In a real kernel, this would involve waiting on a WaitQueue,
-                    // yielding to the scheduler. Busy waiting is bad!
-                     core::hint::spin_loop();
-                 }
+                 self.raw.lock();
                  MutexGuard(self)
              }
              // Unlock is usually handled by the MutexGuard Drop impl
@@ -441,7 +1144,8 @@ pub mod kmessaging {
          pub struct MutexGuard<'a, T: ?Sized>(&'a Mutex<T>);
          impl<'a, T: ?Sized> Drop for MutexGuard<'a, T> {
              fn drop(&mut self) {
-                 self.0.locked.store(false, Ordering::Release);
+                 // The guard proves ownership, so unlock cannot fail
+                 let _ = self.0.raw.unlock();
              }
          }
 
@@ -478,6 +1182,38 @@ pub mod kmessaging {
              !ptr.is_null() || len == 0
          }
 
+         // Page-level helpers for page-transfer messages, backed by kernel_memory.h
+         extern "C" {
+             fn kmem_virt_translate(vaddr: u64) -> u64;
+             fn kmem_virt_map_page(vaddr: u64, paddr: u64, flags: u32) -> i64;
+             fn kmem_virt_unmap_page(vaddr: u64) -> i64;
+             fn kmem_virt_unmap_range(vaddr: u64, size: usize) -> i64;
+         }
+         // KMEM_PAGE_READ | KMEM_PAGE_WRITE | KMEM_PAGE_USER
+         const USER_RW_FLAGS: u32 = (1 << 0) | (1 << 1) | (1 << 3);
+
+         pub fn translate_user_page(vaddr: u64) -> Option<u64> {
+             let paddr = unsafe { kmem_virt_translate(vaddr) };
+             if paddr == 0 { None } else { Some(paddr) }
+         }
+
+         pub fn map_user_page(vaddr: u64, paddr: u64) -> Result<(), KError> {
+             if unsafe { kmem_virt_map_page(vaddr, paddr, USER_RW_FLAGS) } < 0 { Err(KError::BadAddress) } else { Ok(()) }
+         }
+
+         pub fn unmap_user_page(vaddr: u64) -> Result<(), KError> {
+             if unsafe { kmem_virt_unmap_page(vaddr) } < 0 { Err(KError::BadAddress) } else { Ok(()) }
+         }
+
+         pub fn unmap_user_range(vaddr: u64, size: usize) -> Result<(), KError> {
+             if unsafe { kmem_virt_unmap_range(vaddr, size) } < 0 { Err(KError::BadAddress) } else { Ok(()) }
+         }
+
+         // Drops one reference; the frame returns to the allocator only when no other mapping shares it.
+         pub fn release_frame(paddr: u64) {
+             kpager::release_frame(paddr)
+         }
+
          // WARNING: This is an INSECURE placeholder!
          // Real implementation MUST handle page faults and ensure the source buffer is mapped and readable.
          pub fn copy_from_user(dest: *mut u8, src: *const u8, len: usize) -> Result<(), KError> {
@@ -624,7 +1360,7 @@ pub mod kmessaging {
     impl<T> ksync::Mutex<T> {
          pub const fn new(data: T) -> Self {
              ksync::Mutex {
-                 locked: core::sync::atomic::AtomicBool::new(false),
+                 raw: crate::kmutex::AdaptiveMutex::new(),
                  data: core::cell::UnsafeCell::new(data),
              }
          }
@@ -0,0 +1,533 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, KThreadId, krcu, ksched, ktrace};
+
+// --- Vektör Başına Kesmeler, İş Parçacıklı Alt Yarılar ve MSI Yönlendirme ---
+// Her kesme numarası (interrupt_id_t, mimarinin mantıksal numarası) ayrı bir tanımlayıcıya sahiptir:
+// - Üst yarı kesme bağlamında, kesmeler kapalı çalışır; yalnızca cihazı susturur ve IRQ_WAKE_THREAD dönerek
+//   işi alt yarıya bırakır.
+// - Alt yarı vektöre ait bir çekirdek iş parçacığında, kesmeler açık çalışır ve bloklanabilir. İş parçacığı
+//   kesmenin hedef CPU'suna bağlanır; uzun işlemler böylece kesmeleri genel olarak kapalı tutmaz.
+// - IRQ_FLAG_ONESHOT hat alt yarı bitene kadar maskeli tutulur (seviye tetiklemeli hatlar için).
+//
+// Maskeleme tembeldir: `mask` yalnızca tanımlayıcıyı işaretler. Maskeliyken kesme gelirse bekliyor diye
+// kaydedilir, hat ancak o zaman donanımda maskelenir ve `unmask` kesmeyi yeniden oynatır. Sık maskelenip
+// açılan hatlar için denetleyiciye gidilmez.
+//
+// MSI/MSI-X: sürücü `msi_setup` ile mesajı cihaza yazan bir geri çağırma verir. Çekirdek mesajı hedef CPU
+// için mimari kancasıyla oluşturur; `set_affinity` mesajı yeniden oluşturup yazarak kesmeyi taşır.
+// `msi_alloc` boş bir vektörü en az kesme atanmış çevrimiçi CPU'ya yönlendirerek yükü çekirdeklere yayar.
+//
+// Kaldırma (`free`) çalışan üst yarıları RCU ile bekler: dağıtım okuma bölümünde yapılır.
+//
+// Mimarinin kirq'i atlayarak doğrudan işlediği numaralar (IPI vektörleri, SGI'ler) `reserve` ile ayrılır;
+// bunlara kayıt ve MSI ayırma yapılamaz.
+
+pub mod kirq {
+    use super::*;
+    use core::sync::atomic::{AtomicBool, AtomicU32, AtomicU64, Ordering};
+    use spin::Mutex;
+
+    /// Mantıksal kesme numarası sınırı (amd64: 256 IDT vektörü; armv9: 1020 GIC INTID + 256 LPI)
+    pub const MAX_IRQS: usize = 1280;
+
+    // Üst yarı dönüş değerleri (karnal.h'deki KARNAL_IRQ_* ile EŞLEŞMELİDİR)
+    pub const IRQ_NONE: u32 = 0;
+    pub const IRQ_HANDLED: u32 = 1;
+    pub const IRQ_WAKE_THREAD: u32 = 2;
+
+    /// Alt yarı bitene kadar hat maskeli kalır
+    pub const IRQ_FLAG_ONESHOT: u32 = 1 << 0;
+
+    const NO_CPU: u32 = u32::MAX;
+    const IRQ_THREAD_STACK_SIZE: usize = 16 * 1024;
+
+    /// Üst yarı: kesme bağlamında çalışır, IRQ_* döner.
+    pub type IrqHandler = extern "C" fn(irq: u32, context: u64) -> u32;
+    /// Alt yarı: vektörün iş parçacığında çalışır.
+    pub type IrqThreadFn = extern "C" fn(irq: u32, context: u64);
+    /// MSI mesajını cihaza (MSI yetenek yapısı veya MSI-X tablo girdisi) yazar.
+    pub type MsiWriteFn = extern "C" fn(irq: u32, context: u64, address: u64, data: u32);
+
+    extern "C" {
+        fn low_level_interrupt_save() -> u64;
+        fn low_level_interrupt_restore(state: u64);
+        fn low_level_irq_mask(irq: u32);
+        fn low_level_irq_unmask(irq: u32);
+        fn low_level_irq_set_affinity(irq: u32, cpu: u32) -> i64;
+        fn low_level_irq_msi_range(first: *mut u32, count: *mut u32);
+        fn low_level_msi_compose(irq: u32, cpu: u32, address: *mut u64, data: *mut u32) -> i64;
+    }
+
+    struct IrqDesc {
+        handler: AtomicU64, // IrqHandler; 0: kayıtsız
+        thread_fn: AtomicU64,
+        context: AtomicU64,
+        flags: AtomicU32,
+        cpu: AtomicU32,     // Hedef CPU; NO_CPU: mimarinin varsayılanı
+        thread: AtomicU64,  // Alt yarı iş parçacığı (KThreadId); 0: yok
+        msi_write: AtomicU64,
+        msi_context: AtomicU64,
+        disabled: AtomicU32, // İç içe mask derinliği
+        pending: AtomicBool, // Maskeliyken gelen kesme
+        hw_masked: AtomicBool,
+        thread_pending: AtomicBool,
+        stop: AtomicBool,
+        reserved: AtomicBool, // Mimariye ayrılmış (reserve); kayıt yapılamaz
+        count: AtomicU64,
+    }
+
+    impl IrqDesc {
+        const INIT: IrqDesc = IrqDesc {
+            handler: AtomicU64::new(0),
+            thread_fn: AtomicU64::new(0),
+            context: AtomicU64::new(0),
+            flags: AtomicU32::new(0),
+            cpu: AtomicU32::new(NO_CPU),
+            thread: AtomicU64::new(0),
+            msi_write: AtomicU64::new(0),
+            msi_context: AtomicU64::new(0),
+            disabled: AtomicU32::new(0),
+            pending: AtomicBool::new(false),
+            hw_masked: AtomicBool::new(false),
+            thread_pending: AtomicBool::new(false),
+            stop: AtomicBool::new(false),
+            reserved: AtomicBool::new(false),
+            count: AtomicU64::new(0),
+        };
+    }
+
+    static DESCS: [IrqDesc; MAX_IRQS] = [IrqDesc::INIT; MAX_IRQS];
+    // Kayıt/kaldırma/yönlendirme işlemlerini sıralar; dağıtım yolu almaz
+    static SETUP: Mutex<()> = Mutex::new(());
+    // CPU başına atanmış kesme sayısı (msi_alloc yük dengesi için)
+    static ASSIGNED: [AtomicU32; ksched::MAX_CPUS] = {
+        const ZERO: AtomicU32 = AtomicU32::new(0);
+        [ZERO; ksched::MAX_CPUS]
+    };
+
+    // Mimarinin MSI vektör aralığı (init_manager bir kez okur)
+    static MSI_FIRST: AtomicU32 = AtomicU32::new(0);
+    static MSI_COUNT: AtomicU32 = AtomicU32::new(0);
+
+    // İstatistikler: KARNAL_INFO_IRQ_* ile dışarı verilir.
+    static HANDLED: AtomicU64 = AtomicU64::new(0);
+    static THREAD_WAKEUPS: AtomicU64 = AtomicU64::new(0);
+    static SPURIOUS: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_IRQ_* ile EŞLEŞMELİDİR)
+    pub const INFO_IRQ_HANDLED: u32 = 0x900;
+    pub const INFO_IRQ_THREAD_WAKEUPS: u32 = 0x901;
+    pub const INFO_IRQ_SPURIOUS: u32 = 0x902;
+
+    /// `kkernel::get_info` için: kesme istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_IRQ_HANDLED => Some(HANDLED.load(Ordering::Relaxed)),
+            INFO_IRQ_THREAD_WAKEUPS => Some(THREAD_WAKEUPS.load(Ordering::Relaxed)),
+            INFO_IRQ_SPURIOUS => Some(SPURIOUS.load(Ordering::Relaxed)),
+            _ => None,
+        }
+    }
+
+    /// Başlatma grafiğinin "irq" adımı: mimarinin MSI aralığını okur. Kesme kaydeden adımlar (konsol)
+    /// buna bağımlıdır; aralık okunmadan `msi_alloc` Busy döner.
+    pub fn init_manager() {
+        let (mut first, mut count) = (0u32, 0u32);
+        unsafe { low_level_irq_msi_range(&mut first, &mut count) };
+        MSI_FIRST.store(first, Ordering::Relaxed);
+        MSI_COUNT.store(count, Ordering::Release);
+    }
+
+    fn desc_of(irq: u32) -> Result<&'static IrqDesc, KError> {
+        DESCS.get(irq as usize).ok_or(KError::InvalidArgument)
+    }
+
+    // Yalnızca alt yarısı olan kayıtlar için üst yarı
+    extern "C" fn wake_thread_handler(_irq: u32, _context: u64) -> u32 {
+        IRQ_WAKE_THREAD
+    }
+
+    // --- Dağıtım (kesme bağlamı) ---
+
+    fn run_top_half(irq: u32, desc: &IrqDesc, handler: u64) {
+        desc.count.fetch_add(1, Ordering::Relaxed);
+        HANDLED.fetch_add(1, Ordering::Relaxed);
+        let handler: IrqHandler = unsafe { core::mem::transmute(handler as usize) };
+        if handler(irq, desc.context.load(Ordering::Relaxed)) != IRQ_WAKE_THREAD {
+            return;
+        }
+        if desc.flags.load(Ordering::Relaxed) & IRQ_FLAG_ONESHOT != 0 {
+            // Alt yarı `enable` çağırana kadar hat kapalı; seviye tetiklemeli hat kesme fırtınası üretmez
+            desc.disabled.fetch_add(1, Ordering::AcqRel);
+            if !desc.hw_masked.swap(true, Ordering::AcqRel) {
+                unsafe { low_level_irq_mask(irq) };
+            }
+        }
+        desc.thread_pending.store(true, Ordering::Release);
+        let thread = desc.thread.load(Ordering::Acquire);
+        if thread != 0 {
+            let _ = ksched::wake(KThreadId(thread));
+            THREAD_WAKEUPS.fetch_add(1, Ordering::Relaxed);
+        }
+    }
+
+    /// Mimari kesme girişi, denetleyiciden kesmeyi aldıktan (acknowledge) sonra ve kesmeler kapalıyken
+    /// çağırır. EOI'yi dönüşte mimari kod gönderir.
+    #[no_mangle]
+    pub extern "C" fn kirq_dispatch(irq: u32) {
+        ktrace::record(ktrace::EV_IRQ_ENTER, irq as u64, 0);
+        dispatch(irq);
+        ktrace::record(ktrace::EV_IRQ_EXIT, irq as u64, 0);
+    }
+
+    fn dispatch(irq: u32) {
+        let desc = match DESCS.get(irq as usize) {
+            Some(desc) => desc,
+            None => {
+                SPURIOUS.fetch_add(1, Ordering::Relaxed);
+                return;
+            }
+        };
+        let _rcu = krcu::read_lock();
+        let handler = desc.handler.load(Ordering::Acquire);
+        if handler == 0 {
+            // Kayıtsız hat: tekrar gelmesin
+            SPURIOUS.fetch_add(1, Ordering::Relaxed);
+            unsafe { low_level_irq_mask(irq) };
+            return;
+        }
+        if desc.disabled.load(Ordering::Acquire) != 0 {
+            desc.pending.store(true, Ordering::Release);
+            if !desc.hw_masked.swap(true, Ordering::AcqRel) {
+                unsafe { low_level_irq_mask(irq) };
+            }
+            // Bu arada başka bir CPU `enable` yaptıysa kesmeyi beklemede bırakma
+            if desc.disabled.load(Ordering::Acquire) != 0 || !desc.pending.swap(false, Ordering::AcqRel) {
+                return;
+            }
+            if desc.hw_masked.swap(false, Ordering::AcqRel) {
+                unsafe { low_level_irq_unmask(irq) };
+            }
+        }
+        run_top_half(irq, desc, handler);
+    }
+
+    // --- Alt Yarı İş Parçacığı ---
+
+    extern "C" fn irq_thread(irq: u64) {
+        let irq = irq as u32;
+        let desc = &DESCS[irq as usize];
+        loop {
+            let state = unsafe { low_level_interrupt_save() };
+            ksched::prepare_block();
+            if desc.stop.load(Ordering::Acquire) {
+                ksched::cancel_block();
+                unsafe { low_level_interrupt_restore(state) };
+                break;
+            }
+            if !desc.thread_pending.swap(false, Ordering::AcqRel) {
+                ksched::block(); // run_top_half uyandırır
+                unsafe { low_level_interrupt_restore(state) };
+                continue;
+            }
+            ksched::cancel_block();
+            unsafe { low_level_interrupt_restore(state) };
+
+            let thread_fn = desc.thread_fn.load(Ordering::Acquire);
+            if thread_fn != 0 {
+                let thread_fn: IrqThreadFn = unsafe { core::mem::transmute(thread_fn as usize) };
+                thread_fn(irq, desc.context.load(Ordering::Relaxed));
+            }
+            if desc.flags.load(Ordering::Relaxed) & IRQ_FLAG_ONESHOT != 0 {
+                enable(desc, irq);
+            }
+        }
+        // `free` bu alanın sıfırlanmasını bekler
+        desc.thread.store(0, Ordering::Release);
+    }
+
+    fn cpu_mask(cpu: u32) -> u64 {
+        if cpu == NO_CPU { 0 } else { 1 << cpu }
+    }
+
+    // --- Kayıt ---
+
+    /// `irq` için üst yarı ve isteğe bağlı alt yarı kaydeder ve hattı açar. `handler` None ise üst yarı
+    /// yalnızca alt yarıyı uyandırır. Hat zaten kayıtlıysa AlreadyExists döner.
+    pub fn request(irq: u32, handler: Option<IrqHandler>, thread_fn: Option<IrqThreadFn>, context: u64, flags: u32) -> Result<(), KError> {
+        let desc = desc_of(irq)?;
+        if handler.is_none() && thread_fn.is_none() {
+            return Err(KError::InvalidArgument);
+        }
+        // ONESHOT hattı alt yarı açar; alt yarısız kayıt hattı kalıcı olarak kapatırdı
+        if flags & !IRQ_FLAG_ONESHOT != 0 || (flags & IRQ_FLAG_ONESHOT != 0 && thread_fn.is_none()) {
+            return Err(KError::InvalidArgument);
+        }
+        let _setup = SETUP.lock();
+        if desc.reserved.load(Ordering::Relaxed) {
+            return Err(KError::PermissionDenied);
+        }
+        if desc.handler.load(Ordering::Relaxed) != 0 {
+            return Err(KError::AlreadyExists);
+        }
+        desc.context.store(context, Ordering::Relaxed);
+        desc.flags.store(flags, Ordering::Relaxed);
+        desc.thread_fn.store(thread_fn.map_or(0, |f| f as usize as u64), Ordering::Relaxed);
+        desc.disabled.store(0, Ordering::Relaxed);
+        desc.pending.store(false, Ordering::Relaxed);
+        desc.thread_pending.store(false, Ordering::Relaxed);
+        desc.stop.store(false, Ordering::Relaxed);
+
+        if thread_fn.is_some() {
+            let cpu = desc.cpu.load(Ordering::Relaxed);
+            let tid = ksched::thread_create(irq_thread as usize as u64, IRQ_THREAD_STACK_SIZE, irq as u64, cpu_mask(cpu))?;
+            let _ = ksched::set_thread_task(tid, 0); // Alt yarılar çekirdek görevine aittir
+            desc.thread.store(tid.0, Ordering::Release);
+        }
+
+        let handler = handler.unwrap_or(wake_thread_handler);
+        desc.handler.store(handler as usize as u64, Ordering::Release);
+        desc.hw_masked.store(false, Ordering::Relaxed);
+        unsafe { low_level_irq_unmask(irq) };
+        Ok(())
+    }
+
+    /// Kaydı kaldırır. `msi_alloc` ile ayrılıp hiç kaydedilmemiş bir vektörde yalnızca ayırma geri verilir.
+    /// Dönüşte hiçbir CPU'da üst yarı veya alt yarı çalışmıyordur; kesme bağlamından ve o kesmenin alt
+    /// yarısından çağrılmamalıdır.
+    pub fn free(irq: u32) -> Result<(), KError> {
+        let desc = desc_of(irq)?;
+        let _setup = SETUP.lock();
+        if desc.handler.load(Ordering::Relaxed) == 0 {
+            if desc.reserved.load(Ordering::Relaxed) || desc.cpu.load(Ordering::Relaxed) == NO_CPU {
+                return Err(KError::NotFound);
+            }
+            release_vector(desc);
+            return Ok(());
+        }
+        unsafe { low_level_irq_mask(irq) };
+        desc.handler.store(0, Ordering::Release);
+        krcu::synchronize(); // Devam eden üst yarılar bitti
+
+        desc.stop.store(true, Ordering::Release);
+        let thread = desc.thread.load(Ordering::Acquire);
+        if thread != 0 {
+            let _ = ksched::wake(KThreadId(thread));
+            while desc.thread.load(Ordering::Acquire) != 0 {
+                let _ = ksched::yield_now();
+            }
+        }
+        desc.thread_fn.store(0, Ordering::Relaxed);
+        release_vector(desc);
+        Ok(())
+    }
+
+    // Yönlendirmeyi geri verir; vektör yeniden msi_alloc ile ayrılabilir. SETUP kilidi altında çağrılır.
+    fn release_vector(desc: &IrqDesc) {
+        desc.msi_write.store(0, Ordering::Relaxed);
+        let cpu = desc.cpu.swap(NO_CPU, Ordering::Relaxed);
+        if cpu != NO_CPU {
+            ASSIGNED[cpu as usize].fetch_sub(1, Ordering::Relaxed);
+        }
+    }
+
+    /// Mimarinin kirq_dispatch dışında işlediği bir numarayı (IPI vektörü, SGI) ayırır: bu numaraya
+    /// `request` PermissionDenied döner ve `msi_alloc` onu vermez. Tekrar çağrılabilir (her CPU'nun açılışı).
+    pub fn reserve(irq: u32) -> Result<(), KError> {
+        let desc = desc_of(irq)?;
+        let _setup = SETUP.lock();
+        if desc.handler.load(Ordering::Relaxed) != 0 || desc.cpu.load(Ordering::Relaxed) != NO_CPU {
+            return Err(KError::Busy);
+        }
+        desc.reserved.store(true, Ordering::Relaxed);
+        Ok(())
+    }
+
+    /// Hattı maskeler (iç içe çağrılabilir). Dönüşte başka bir CPU'da bu hattın üst yarısı çalışmıyordur;
+    /// kesme bağlamından çağrılmamalıdır.
+    pub fn mask(irq: u32) -> Result<(), KError> {
+        let desc = desc_of(irq)?;
+        desc.disabled.fetch_add(1, Ordering::AcqRel);
+        krcu::synchronize();
+        Ok(())
+    }
+
+    /// `mask`'ı geri alır. Maskeliyken gelen kesme varsa şimdi işlenir.
+    pub fn unmask(irq: u32) -> Result<(), KError> {
+        let desc = desc_of(irq)?;
+        if desc.disabled.load(Ordering::Acquire) == 0 {
+            return Err(KError::InvalidArgument);
+        }
+        enable(desc, irq);
+        Ok(())
+    }
+
+    fn enable(desc: &IrqDesc, irq: u32) {
+        if desc.disabled.fetch_sub(1, Ordering::AcqRel) != 1 {
+            return;
+        }
+        let state = unsafe { low_level_interrupt_save() };
+        if desc.hw_masked.swap(false, Ordering::AcqRel) {
+            unsafe { low_level_irq_unmask(irq) };
+        }
+        if desc.pending.swap(false, Ordering::AcqRel) {
+            let _rcu = krcu::read_lock();
+            let handler = desc.handler.load(Ordering::Acquire);
+            if handler != 0 {
+                run_top_half(irq, desc, handler);
+            }
+        }
+        unsafe { low_level_interrupt_restore(state) };
+    }
+
+    // --- Yönlendirme ---
+
+    fn write_msi(desc: &IrqDesc, irq: u32, cpu: u32) -> Result<(), KError> {
+        let write = desc.msi_write.load(Ordering::Acquire);
+        let mut address = 0u64;
+        let mut data = 0u32;
+        if unsafe { low_level_msi_compose(irq, cpu, &mut address, &mut data) } < 0 {
+            return Err(KError::NotSupported);
+        }
+        let write: MsiWriteFn = unsafe { core::mem::transmute(write as usize) };
+        write(irq, desc.msi_context.load(Ordering::Relaxed), address, data);
+        Ok(())
+    }
+
+    fn assign_cpu(desc: &IrqDesc, cpu: u32) {
+        let old = desc.cpu.swap(cpu, Ordering::Relaxed);
+        if old != NO_CPU {
+            ASSIGNED[old as usize].fetch_sub(1, Ordering::Relaxed);
+        }
+        ASSIGNED[cpu as usize].fetch_add(1, Ordering::Relaxed);
+        let thread = desc.thread.load(Ordering::Acquire);
+        if thread != 0 {
+            // Alt yarı, cihazın verisi sıcakken aynı CPU'da çalışsın
+            let _ = ksched::set_affinity(KThreadId(thread), cpu_mask(cpu));
+        }
+    }
+
+    /// Kesmeyi `cpu`'ya yönlendirir. MSI hatlarında mesaj yeniden yazılır, diğerlerinde denetleyici
+    /// (IOAPIC, GIC dağıtıcısı) yeniden programlanır. Alt yarı iş parçacığı da aynı CPU'ya taşınır.
+    pub fn set_affinity(irq: u32, cpu: u32) -> Result<(), KError> {
+        let desc = desc_of(irq)?;
+        if cpu as usize >= ksched::MAX_CPUS || ksched::online_cpus() & (1 << cpu) == 0 {
+            return Err(KError::InvalidArgument);
+        }
+        let _setup = SETUP.lock();
+        if desc.msi_write.load(Ordering::Relaxed) != 0 {
+            write_msi(desc, irq, cpu)?;
+        } else {
+            // Hat yönlendirilemiyorsa (örn. sabit hedefli eski PIC hattı) mimari negatif döner
+            if unsafe { low_level_irq_set_affinity(irq, cpu) } < 0 {
+                return Err(KError::NotSupported);
+            }
+        }
+        assign_cpu(desc, cpu);
+        Ok(())
+    }
+
+    /// Mimarinin MSI vektör aralığından boş bir kesme numarası ayırır ve en az kesme atanmış çevrimiçi
+    /// CPU'yu hedef seçer. Numara `request` ve `msi_setup` ile kullanılır.
+    pub fn msi_alloc() -> Result<u32, KError> {
+        let count = MSI_COUNT.load(Ordering::Acquire);
+        let first = MSI_FIRST.load(Ordering::Relaxed);
+        let _setup = SETUP.lock();
+        let end = (first as usize + count as usize).min(MAX_IRQS);
+        for irq in first as usize..end {
+            let desc = &DESCS[irq];
+            if desc.handler.load(Ordering::Relaxed) != 0
+                || desc.cpu.load(Ordering::Relaxed) != NO_CPU
+                || desc.reserved.load(Ordering::Relaxed)
+            {
+                continue;
+            }
+            let online = ksched::online_cpus();
+            let cpu = (0..ksched::MAX_CPUS as u32)
+                .filter(|&cpu| online & (1 << cpu) != 0)
+                .min_by_key(|&cpu| ASSIGNED[cpu as usize].load(Ordering::Relaxed))
+                .unwrap_or(0);
+            assign_cpu(desc, cpu);
+            return Ok(irq as u32);
+        }
+        Err(KError::Busy)
+    }
+
+    /// MSI/MSI-X hattı için mesaj yazma geri çağırmasını kaydeder ve mesajı hedef CPU için hemen yazar.
+    pub fn msi_setup(irq: u32, write: MsiWriteFn, context: u64) -> Result<(), KError> {
+        let desc = desc_of(irq)?;
+        let _setup = SETUP.lock();
+        if desc.reserved.load(Ordering::Relaxed) {
+            return Err(KError::PermissionDenied);
+        }
+        let mut cpu = desc.cpu.load(Ordering::Relaxed);
+        if cpu == NO_CPU {
+            cpu = 0;
+            assign_cpu(desc, cpu);
+        }
+        desc.msi_context.store(context, Ordering::Relaxed);
+        desc.msi_write.store(write as usize as u64, Ordering::Release);
+        write_msi(desc, irq, cpu)
+    }
+
+    // --- C API ---
+
+    #[no_mangle]
+    pub extern "C" fn karnal_irq_request(irq: u32, handler: Option<IrqHandler>, thread_fn: Option<IrqThreadFn>, context: u64, flags: u32) -> i64 {
+        match request(irq, handler, thread_fn, context, flags) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_irq_free(irq: u32) -> i64 {
+        match free(irq) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_irq_mask(irq: u32) -> i64 {
+        match mask(irq) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_irq_unmask(irq: u32) -> i64 {
+        match unmask(irq) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_irq_set_affinity(irq: u32, cpu: u32) -> i64 {
+        match set_affinity(irq, cpu) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_irq_msi_alloc() -> i64 {
+        match msi_alloc() {
+            Ok(irq) => irq as i64,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_irq_msi_setup(irq: u32, write: MsiWriteFn, context: u64) -> i64 {
+        match msi_setup(irq, write, context) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+}
@@ -0,0 +1,185 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Necessary types from the parent karnal64 module
+use super::KError;
+
+// --- Bounded Lock-Free Message Queue ---
+// Backing store for IpcChannel (see srcipc.rs). Slots are allocated once when the channel is
+// created; send/receive never allocate and never take the channel lock on the fast path.
+// The algorithm is a bounded sequence-numbered ring: every slot carries a sequence counter that
+// tells producers and the consumer whether the slot is free for position `pos` or holds its value.
+//
+// Two flavors:
+// - Spsc: one producer, one consumer. The producer publishes its tail with a plain store.
+// - Mpsc: many producers, one consumer. Producers claim positions with a CAS on the tail.
+// In both flavors the consumer side is single-threaded; callers must serialize pop() themselves.
+
+pub mod kmsgqueue {
+    use super::*;
+    use core::cell::UnsafeCell;
+    use core::mem::MaybeUninit;
+    use core::sync::atomic::{AtomicUsize, Ordering};
+    use alloc::boxed::Box;
+    use alloc::vec::Vec;
+
+    /// Cache line size assumed for padding. 64 bytes on all supported targets.
+    pub const CACHE_LINE_SIZE: usize = 64;
+    /// Largest allowed slot count per queue.
+    pub const MAX_CAPACITY: usize = 1 << 16;
+
+    /// Keeps `T` on its own cache line so that producer and consumer counters do not false-share.
+    #[repr(C, align(64))]
+    pub struct CachePadded<T>(pub T);
+
+    /// Producer model of a queue. Values must match KARNAL_CHANNEL_SPSC / KARNAL_CHANNEL_MPSC in karnal.h.
+    #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+    #[repr(u32)]
+    pub enum QueueKind {
+        Spsc = 0,
+        Mpsc = 1,
+    }
+
+    impl QueueKind {
+        /// Maps a C flag value to a queue kind.
+        pub fn from_flags(flags: u32) -> Result<Self, KError> {
+            match flags {
+                0 => Ok(QueueKind::Spsc),
+                1 => Ok(QueueKind::Mpsc),
+                _ => Err(KError::InvalidArgument),
+            }
+        }
+    }
+
+    // One slot per cache line: neighbouring producers writing adjacent slots do not contend.
+    #[repr(C, align(64))]
+    struct Slot<T> {
+        // == pos      : free, the producer of position `pos` may write it
+        // == pos + 1  : holds the value of position `pos`, the consumer may read it
+        seq: AtomicUsize,
+        value: UnsafeCell<MaybeUninit<T>>,
+    }
+
+    pub struct MsgQueue<T> {
+        head: CachePadded<AtomicUsize>, // Next position to pop (written by the consumer only)
+        tail: CachePadded<AtomicUsize>, // Next position to push
+        slots: Box<[Slot<T>]>,
+        mask: usize,
+        kind: QueueKind,
+    }
+
+    unsafe impl<T: Send> Send for MsgQueue<T> {}
+    unsafe impl<T: Send> Sync for MsgQueue<T> {}
+
+    impl<T> MsgQueue<T> {
+        /// Creates a queue with `capacity` preallocated slots.
+        /// `capacity` is rounded up to a power of two (minimum 2, maximum MAX_CAPACITY).
+        pub fn new(capacity: usize, kind: QueueKind) -> Result<Self, KError> {
+            if capacity == 0 || capacity > MAX_CAPACITY {
+                return Err(KError::InvalidArgument);
+            }
+            let capacity = capacity.max(2).next_power_of_two();
+
+            let mut slots = Vec::new();
+            slots.try_reserve_exact(capacity).map_err(|_| KError::OutOfMemory)?;
+            for i in 0..capacity {
+                slots.push(Slot {
+                    seq: AtomicUsize::new(i),
+                    value: UnsafeCell::new(MaybeUninit::uninit()),
+                });
+            }
+
+            Ok(MsgQueue {
+                head: CachePadded(AtomicUsize::new(0)),
+                tail: CachePadded(AtomicUsize::new(0)),
+                slots: slots.into_boxed_slice(),
+                mask: capacity - 1,
+                kind,
+            })
+        }
+
+        pub fn capacity(&self) -> usize {
+            self.mask + 1
+        }
+
+        pub fn kind(&self) -> QueueKind {
+            self.kind
+        }
+
+        /// Appends `value`. Returns it back in `Err` if the queue is full.
+        /// For Spsc queues only one task may push at a time.
+        pub fn push(&self, value: T) -> Result<(), T> {
+            let mut pos = self.tail.0.load(Ordering::Relaxed);
+            let slot = loop {
+                let slot = &self.slots[pos & self.mask];
+                let seq = slot.seq.load(Ordering::Acquire);
+                let diff = seq as isize - pos as isize;
+
+                if diff == 0 {
+                    match self.kind {
+                        QueueKind::Spsc => {
+                            self.tail.0.store(pos + 1, Ordering::Relaxed);
+                            break slot;
+                        }
+                        QueueKind::Mpsc => {
+                            match self.tail.0.compare_exchange_weak(pos, pos + 1, Ordering::Relaxed, Ordering::Relaxed) {
+                                Ok(_) => break slot,
+                                Err(current) => pos = current,
+                            }
+                        }
+                    }
+                } else if diff < 0 {
+                    // The slot still holds the value from one lap ago: full.
+                    return Err(value);
+                } else {
+                    // Another producer claimed this position, reload the tail.
+                    pos = self.tail.0.load(Ordering::Relaxed);
+                }
+            };
+
+            unsafe { (*slot.value.get()).write(value); }
+            slot.seq.store(pos + 1, Ordering::Release);
+            Ok(())
+        }
+
+        /// Removes the oldest value, or returns None if the queue is empty.
+        ///
+        /// # Safety
+        /// Only one task may pop at a time. IpcChannel guarantees this with its receiver claim.
+        pub unsafe fn pop(&self) -> Option<T> {
+            let pos = self.head.0.load(Ordering::Relaxed);
+            let slot = &self.slots[pos & self.mask];
+            if slot.seq.load(Ordering::Acquire) != pos + 1 {
+                return None;
+            }
+
+            let value = (*slot.value.get()).assume_init_read();
+            // Free the slot for the producer one lap ahead.
+            slot.seq.store(pos + self.mask + 1, Ordering::Release);
+            self.head.0.store(pos + 1, Ordering::Relaxed);
+            Some(value)
+        }
+
+        /// Approximate number of queued values (exact when no push/pop is in flight).
+        pub fn len(&self) -> usize {
+            let tail = self.tail.0.load(Ordering::Acquire);
+            let head = self.head.0.load(Ordering::Acquire);
+            tail.wrapping_sub(head).min(self.capacity())
+        }
+
+        pub fn is_empty(&self) -> bool {
+            self.len() == 0
+        }
+
+        pub fn is_full(&self) -> bool {
+            self.len() == self.capacity()
+        }
+    }
+
+    impl<T> Drop for MsgQueue<T> {
+        fn drop(&mut self) {
+            // &mut self: no other producer or consumer can exist, so draining is safe.
+            while unsafe { self.pop() }.is_some() {}
+        }
+    }
+}
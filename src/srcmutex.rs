@@ -0,0 +1,838 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, KHandle, ResourceProvider, khandle, ksched, ktimer};
+
+// --- Uyarlanabilir (Spin-Then-Block) Kilitler ve Futex Bekleme Kuyrukları ---
+// AdaptiveMutex sahibini (iş parçacığı yuvası) tutar. Kilit meşgulken:
+// - Sahip başka bir CPU'da çalışıyorsa dönülür: kısa kritik bölgeler bağlam değiştirmeden biter.
+// - Sahip çalışmıyorsa (bloklandı veya kesildi) ya da dönme sınırı aşıldıysa bekleme kuyruğunda park edilir.
+// Serbest bırakma bekleyen varsa tek birini uyandırır; uyanan kilidi yeniden yarışarak alır.
+//
+// Bekleme kuyrukları adrese göre anahtarlanan ortak bir karma tablosudur (futex). Çekirdek kilitleri kendi
+// adresleriyle (kimlik haritalı), kullanıcı futex'leri kelimenin fiziksel adresiyle anahtarlanır; böylece
+// paylaşılan bellekteki bir kilit farklı adres alanlarından beklenebilir.
+// Okuyucu-yazıcı kilitleri ve koşul değişkenleri de aynı bekleme kuyruklarını kullanır.
+// Kullanıcı alanı kilitleri (karnal.h'deki KarnalUserLock) yarışma yokken çekirdeğe hiç girmez;
+// yalnızca bekleme ve uyandırma için karnal_futex_wait/karnal_futex_wake çağrılır.
+
+pub mod kmutex {
+    use super::*;
+    use alloc::sync::Arc;
+    use core::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+    use spin::Mutex;
+
+    const WAIT_BUCKETS: usize = 256;
+    /// Tür başına (kilit, rwlock, koşul değişkeni) oluşturulabilecek en fazla nesne
+    pub const MAX_LOCKS: usize = 256;
+    // Sahibi çalışırken en fazla bu kadar tur dönülür; uzun kritik bölgelerde yine park edilir.
+    const MAX_SPIN: u32 = 1 << 14;
+    const NO_WAITER: u32 = u32::MAX;
+
+    // Kilit sahibi: 0 boş, yuva + 1 veya bloklanamayan bağlamlar (önyükleme/boşta) için ANON_OWNER
+    const UNOWNED: u32 = 0;
+    const ANON_OWNER: u32 = u32::MAX;
+
+    extern "C" {
+        fn low_level_interrupt_save() -> u64;
+        fn low_level_interrupt_restore(state: u64);
+        fn kmem_virt_translate(vaddr: u64) -> u64;
+        fn kmem_virt_fault_in(vaddr: u64, write: u32) -> i64;
+    }
+
+    // İstatistikler: KARNAL_INFO_LOCK_* ile dışarı verilir.
+    static SPIN_ACQUIRES: AtomicU64 = AtomicU64::new(0);
+    static BLOCKS: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_LOCK_* ile EŞLEŞMELİDİR)
+    pub const INFO_LOCK_SPIN_ACQUIRES: u32 = 0x500;
+    pub const INFO_LOCK_BLOCKS: u32 = 0x501;
+
+    /// `kkernel::get_info` için: kilit istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_LOCK_SPIN_ACQUIRES => Some(SPIN_ACQUIRES.load(Ordering::Relaxed)),
+            INFO_LOCK_BLOCKS => Some(BLOCKS.load(Ordering::Relaxed)),
+            _ => None,
+        }
+    }
+
+    // --- Bekleme Kuyrukları ---
+
+    // Bir iş parçacığı aynı anda en fazla bir anahtarda bekler; bağlantılar yuva ile indekslenir ve
+    // yalnızca kova kilidi altında değiştirilir.
+    struct WaitLink {
+        key: AtomicU64,
+        seq: AtomicU32,
+        next: AtomicU32,
+    }
+
+    impl WaitLink {
+        const INIT: WaitLink = WaitLink { key: AtomicU64::new(0), seq: AtomicU32::new(0), next: AtomicU32::new(NO_WAITER) };
+    }
+
+    static LINKS: [WaitLink; ksched::MAX_THREADS] = [WaitLink::INIT; ksched::MAX_THREADS];
+
+    // FIFO: uyandırma en eski bekleyenden başlar.
+    struct Bucket {
+        head: u32,
+        tail: u32,
+    }
+
+    static BUCKETS: [Mutex<Bucket>; WAIT_BUCKETS] = {
+        const EMPTY: Mutex<Bucket> = Mutex::new(Bucket { head: NO_WAITER, tail: NO_WAITER });
+        [EMPTY; WAIT_BUCKETS]
+    };
+
+    fn bucket_of(key: u64) -> &'static Mutex<Bucket> {
+        let hash = (key >> 2).wrapping_mul(0x9E37_79B9_7F4A_7C15) >> 56;
+        &BUCKETS[hash as usize % WAIT_BUCKETS]
+    }
+
+    // `should_wait` kova kilidi altında değerlendirilir; true dönerse çağıran kuyruğa eklenip bloklanır.
+    // Koşulu değiştiren taraf uyandırmadan önce aynı kova kilidini aldığından uyandırma kaybolmaz.
+    // Dönüş: beklendiyse true, koşul sağlanmadığı için beklenmediyse false.
+    fn wait_on<F: FnOnce() -> bool>(key: u64, should_wait: F) -> Result<bool, KError> {
+        wait_on_until(key, ktimer::NO_DEADLINE, should_wait)
+    }
+
+    // `wait_on` gibi, ancak `deadline_ns` (ktimer::now_ns zamanı) geçince uyandırılmadan döner ve
+    // TimedOut verir. Zamanlayıcı kurulamazsa (CPU'nun zamanlayıcı tablosu dolu) Busy döner.
+    fn wait_on_until<F: FnOnce() -> bool>(key: u64, deadline_ns: u64, should_wait: F) -> Result<bool, KError> {
+        let slot = ksched::current_slot().ok_or(KError::NotSupported)?;
+        let irq = unsafe { low_level_interrupt_save() };
+        let timer;
+        {
+            let mut bucket = bucket_of(key).lock();
+            if !should_wait() {
+                drop(bucket);
+                unsafe { low_level_interrupt_restore(irq) };
+                return Ok(false);
+            }
+            let seq = ksched::prepare_block();
+            timer = if deadline_ns == ktimer::NO_DEADLINE {
+                None
+            } else {
+                // Kova kilidi -> zamanlayıcı kuyruğu kilidi sırası; zamanlayıcı kesmesi uyandırmadan önce
+                // kendi kilidini bırakır.
+                match ktimer::arm_wakeup(deadline_ns, 0, slot, seq) {
+                    Ok(timer) => Some(timer),
+                    Err(err) => {
+                        drop(bucket);
+                        ksched::cancel_block();
+                        unsafe { low_level_interrupt_restore(irq) };
+                        return Err(err);
+                    }
+                }
+            };
+            let link = &LINKS[slot as usize];
+            link.key.store(key, Ordering::Relaxed);
+            link.seq.store(seq, Ordering::Relaxed);
+            link.next.store(NO_WAITER, Ordering::Relaxed);
+            if bucket.tail == NO_WAITER {
+                bucket.head = slot;
+            } else {
+                LINKS[bucket.tail as usize].next.store(slot, Ordering::Relaxed);
+            }
+            bucket.tail = slot;
+        }
+        BLOCKS.fetch_add(1, Ordering::Relaxed);
+        ksched::block();
+
+        let mut result = Ok(true);
+        if let Some(timer) = timer {
+            ktimer::cancel(timer);
+            // wake_key kuyruktan çıkarırken anahtarı sıfırlar; hâlâ kuyruktaysak zamanlayıcı uyandırdı.
+            let mut bucket = bucket_of(key).lock();
+            if LINKS[slot as usize].key.load(Ordering::Relaxed) == key {
+                unlink(&mut bucket, slot);
+                if ktimer::now_ns() >= deadline_ns {
+                    result = Err(KError::TimedOut);
+                }
+            }
+        }
+        unsafe { low_level_interrupt_restore(irq) };
+        result
+    }
+
+    // Belirli bir bekleyeni kuyruktan çıkarır (zaman aşımı). Kova kilidi altında çağrılır.
+    fn unlink(bucket: &mut Bucket, slot: u32) {
+        let mut prev = NO_WAITER;
+        let mut cursor = bucket.head;
+        while cursor != NO_WAITER {
+            let next = LINKS[cursor as usize].next.load(Ordering::Relaxed);
+            if cursor == slot {
+                if prev == NO_WAITER {
+                    bucket.head = next;
+                } else {
+                    LINKS[prev as usize].next.store(next, Ordering::Relaxed);
+                }
+                if bucket.tail == cursor {
+                    bucket.tail = prev;
+                }
+                break;
+            }
+            prev = cursor;
+            cursor = next;
+        }
+        LINKS[slot as usize].key.store(0, Ordering::Relaxed);
+    }
+
+    // `key` üzerinde bekleyen en fazla `count` iş parçacığını kuyruktan çıkarıp uyandırır.
+    fn wake_key(key: u64, count: u32) -> u32 {
+        let mut woken = 0;
+        let irq = unsafe { low_level_interrupt_save() };
+        {
+            let mut bucket = bucket_of(key).lock();
+            let mut prev = NO_WAITER;
+            let mut cursor = bucket.head;
+            while cursor != NO_WAITER && woken < count {
+                let link = &LINKS[cursor as usize];
+                let next = link.next.load(Ordering::Relaxed);
+                if link.key.load(Ordering::Relaxed) == key {
+                    if prev == NO_WAITER {
+                        bucket.head = next;
+                    } else {
+                        LINKS[prev as usize].next.store(next, Ordering::Relaxed);
+                    }
+                    if bucket.tail == cursor {
+                        bucket.tail = prev;
+                    }
+                    link.key.store(0, Ordering::Relaxed);
+                    // Kova kilidi -> çalışma kuyruğu kilidi sırası; ters sırada alan yol yoktur.
+                    ksched::wake_waiter(cursor, link.seq.load(Ordering::Relaxed));
+                    woken += 1;
+                } else {
+                    prev = cursor;
+                }
+                cursor = next;
+            }
+        }
+        unsafe { low_level_interrupt_restore(irq) };
+        woken
+    }
+
+    // --- Uyarlanabilir Kilit ---
+
+    /// Dön-sonra-bloklan çekirdek kilidi. Kesme bağlamında kullanılamaz (bloklanabilir).
+    pub struct AdaptiveMutex {
+        owner: AtomicU32,
+        waiters: AtomicU32, // Bu kilidin kuyruktaki bekleyen sayısı (kova kilidi altında artar)
+    }
+
+    fn owner_token() -> u32 {
+        match ksched::current_slot() {
+            Some(slot) => slot + 1,
+            None => ANON_OWNER,
+        }
+    }
+
+    impl AdaptiveMutex {
+        pub const fn new() -> Self {
+            AdaptiveMutex { owner: AtomicU32::new(UNOWNED), waiters: AtomicU32::new(0) }
+        }
+
+        fn key(&self) -> u64 {
+            self as *const Self as u64
+        }
+
+        pub fn try_lock(&self) -> bool {
+            self.owner
+                .compare_exchange(UNOWNED, owner_token(), Ordering::Acquire, Ordering::Relaxed)
+                .is_ok()
+        }
+
+        pub fn lock(&self) {
+            let me = owner_token();
+            if self.owner.compare_exchange(UNOWNED, me, Ordering::Acquire, Ordering::Relaxed).is_ok() {
+                return;
+            }
+            loop {
+                // 1. Sahip bir CPU'da çalıştığı sürece dön
+                let mut spins = 0;
+                loop {
+                    let owner = self.owner.load(Ordering::Relaxed);
+                    if owner == UNOWNED {
+                        if self.owner.compare_exchange(UNOWNED, me, Ordering::Acquire, Ordering::Relaxed).is_ok() {
+                            SPIN_ACQUIRES.fetch_add(1, Ordering::Relaxed);
+                            return;
+                        }
+                        continue;
+                    }
+                    // Bloklanamayan bağlamlar (sahip veya bekleyen) her zaman döner
+                    let owner_running = owner == ANON_OWNER || ksched::is_on_cpu(owner - 1);
+                    if me != ANON_OWNER && (!owner_running || spins >= MAX_SPIN) {
+                        break;
+                    }
+                    spins += 1;
+                    core::hint::spin_loop();
+                }
+
+                // 2. Park et. Bekleyen sayısı kova kilidi altında artırılır ve sahip yeniden kontrol edilir;
+                // unlock sahibi sıfırlayıp sayacı okuduğundan (SeqCst) ikisinden biri diğerini görür.
+                let _ = wait_on(self.key(), || {
+                    self.waiters.fetch_add(1, Ordering::SeqCst);
+                    if self.owner.load(Ordering::SeqCst) == UNOWNED {
+                        self.waiters.fetch_sub(1, Ordering::Relaxed);
+                        false
+                    } else {
+                        true
+                    }
+                });
+            }
+        }
+
+        /// Kilidi bırakır. Çağıran sahip değilse PermissionDenied döner.
+        pub fn unlock(&self) -> Result<(), KError> {
+            let me = owner_token();
+            if self.owner.load(Ordering::Relaxed) != me {
+                return Err(KError::PermissionDenied);
+            }
+            self.owner.store(UNOWNED, Ordering::SeqCst);
+            if self.waiters.load(Ordering::SeqCst) != 0 {
+                let woken = wake_key(self.key(), 1);
+                self.waiters.fetch_sub(woken, Ordering::Relaxed);
+            }
+            Ok(())
+        }
+
+        pub fn is_locked(&self) -> bool {
+            self.owner.load(Ordering::Relaxed) != UNOWNED
+        }
+    }
+
+    // --- Okuyucu-Yazıcı Kilidi ---
+
+    /// Yazıcı öncelikli okuyucu-yazıcı kilidi. Bekleyen bir yazıcı varken yeni okuyucular girmez, bu yüzden
+    /// sürekli okuma yükü yazıcıları aç bırakamaz. Son okuyucu veya çıkan yazıcı sıradaki yazıcıyı uyandırır;
+    /// bekleyen yazıcı kalmadığında tüm okuyucular birlikte uyandırılır.
+    pub struct RwLock {
+        state: AtomicU32,           // Alt bitler okuyucu sayısı, WRITE_LOCKED yazıcı
+        writers_waiting: AtomicU32, // Kilidi isteyip henüz almamış yazıcılar
+        writer: AtomicU32,          // Yazma kilidini tutan (owner_token), tutulmuyorsa UNOWNED
+    }
+
+    const WRITE_LOCKED: u32 = 1 << 31;
+
+    impl RwLock {
+        pub const fn new() -> Self {
+            RwLock { state: AtomicU32::new(0), writers_waiting: AtomicU32::new(0), writer: AtomicU32::new(UNOWNED) }
+        }
+
+        // Okuyucular ve yazıcılar ayrı anahtarlarda bekler; yazıcı uyandırması okuyucuları dolaşmaz.
+        fn reader_key(&self) -> u64 {
+            self as *const Self as u64
+        }
+
+        fn writer_key(&self) -> u64 {
+            self as *const Self as u64 + 4
+        }
+
+        fn readers_blocked(&self) -> bool {
+            self.state.load(Ordering::SeqCst) & WRITE_LOCKED != 0 || self.writers_waiting.load(Ordering::SeqCst) != 0
+        }
+
+        pub fn read_lock(&self) {
+            loop {
+                let state = self.state.load(Ordering::Relaxed);
+                if state & WRITE_LOCKED == 0 && self.writers_waiting.load(Ordering::SeqCst) == 0 {
+                    if self.state.compare_exchange(state, state + 1, Ordering::Acquire, Ordering::Relaxed).is_ok() {
+                        return;
+                    }
+                    continue;
+                }
+                if wait_on(self.reader_key(), || self.readers_blocked()).is_err() {
+                    core::hint::spin_loop(); // Bloklanamayan bağlam
+                }
+            }
+        }
+
+        /// Okuma kilidini bırakır. Kilit okuma için tutulmuyorsa PermissionDenied döner; sayaç sıfırın altına inmez.
+        pub fn read_unlock(&self) -> Result<(), KError> {
+            let mut state = self.state.load(Ordering::Relaxed);
+            loop {
+                if state & WRITE_LOCKED != 0 || state == 0 {
+                    return Err(KError::PermissionDenied);
+                }
+                match self.state.compare_exchange_weak(state, state - 1, Ordering::SeqCst, Ordering::Relaxed) {
+                    Ok(_) => break,
+                    Err(current) => state = current,
+                }
+            }
+            if state == 1 && self.writers_waiting.load(Ordering::SeqCst) != 0 {
+                wake_key(self.writer_key(), 1);
+            }
+            Ok(())
+        }
+
+        pub fn write_lock(&self) {
+            self.writers_waiting.fetch_add(1, Ordering::SeqCst);
+            loop {
+                if self.state.compare_exchange(0, WRITE_LOCKED, Ordering::Acquire, Ordering::Relaxed).is_ok() {
+                    self.writer.store(owner_token(), Ordering::Relaxed);
+                    self.writers_waiting.fetch_sub(1, Ordering::SeqCst);
+                    return;
+                }
+                if wait_on(self.writer_key(), || self.state.load(Ordering::SeqCst) != 0).is_err() {
+                    core::hint::spin_loop();
+                }
+            }
+        }
+
+        /// Yazma kilidini bırakır. Çağıran yazma kilidini tutmuyorsa PermissionDenied döner.
+        pub fn write_unlock(&self) -> Result<(), KError> {
+            if self.state.load(Ordering::Relaxed) != WRITE_LOCKED || self.writer.load(Ordering::Relaxed) != owner_token() {
+                return Err(KError::PermissionDenied);
+            }
+            self.writer.store(UNOWNED, Ordering::Relaxed);
+            self.state.store(0, Ordering::SeqCst);
+            if self.writers_waiting.load(Ordering::SeqCst) != 0 {
+                wake_key(self.writer_key(), 1);
+            } else {
+                wake_key(self.reader_key(), u32::MAX);
+            }
+            Ok(())
+        }
+
+        pub fn is_locked(&self) -> bool {
+            self.state.load(Ordering::Relaxed) != 0
+        }
+    }
+
+    // --- Koşul Değişkeni ---
+
+    /// AdaptiveMutex ile kullanılan koşul değişkeni. Her bildirim sırayı artırır; bekleyen, kilidi bırakmadan
+    /// önce okuduğu sıra değişmişse bloklanmaz, böylece kilidin bırakılması ile park arasındaki bildirim kaybolmaz.
+    /// Uyanma koşulun sağlandığını garanti etmez; çağıran koşulu döngüde yeniden kontrol etmelidir.
+    pub struct Condvar {
+        seq: AtomicU32,
+    }
+
+    impl Condvar {
+        pub const fn new() -> Self {
+            Condvar { seq: AtomicU32::new(0) }
+        }
+
+        fn key(&self) -> u64 {
+            self as *const Self as u64
+        }
+
+        /// `mutex`'i bırakır, bildirim gelene kadar bekler ve dönmeden önce `mutex`'i yeniden alır.
+        pub fn wait(&self, mutex: &AdaptiveMutex) -> Result<(), KError> {
+            let seq = self.seq.load(Ordering::SeqCst);
+            mutex.unlock()?;
+            let waited = wait_on(self.key(), || self.seq.load(Ordering::SeqCst) == seq);
+            mutex.lock();
+            waited.map(|_| ())
+        }
+
+        pub fn notify_one(&self) {
+            self.seq.fetch_add(1, Ordering::SeqCst);
+            wake_key(self.key(), 1);
+        }
+
+        pub fn notify_all(&self) {
+            self.seq.fetch_add(1, Ordering::SeqCst);
+            wake_key(self.key(), u32::MAX);
+        }
+    }
+
+    // --- Handle Tabanlı Nesneler (karnal_sync_*) ---
+    // Kilit, rwlock ve koşul değişkeni nesneleri statik tablolarda durur. Handle'ları ise görev başına,
+    // nesil kontrollü handle tablosundan (srchandle.rs) verilir: başka bir görev aynı değeri tahmin etse
+    // bile kendi tablosunda çözemez, kapatılmış bir handle'ın eski değeri de reddedilir. Handle'ın provider'ı
+    // (SyncProvider) nesnenin türünü ve tablo indeksini taşır ve yaşadığı sürece yuvayı ayırır; son handle
+    // kapanınca yuva boşa çıkar ve bir sonraki oluşturmada sıfırlanır.
+    //
+    // Bırakma yalnızca kilidi tutan iş parçacığından kabul edilir (PermissionDenied). Handle tabanlı
+    // rwlock'larda okuma kilidini tutan iş parçacıkları bir yuva bitmap'inde izlenir; bir iş parçacığı
+    // aynı rwlock'u aynı anda bir kez okuma için tutabilir.
+
+    // SyncProvider türleri (`ResourceProvider::sync_object`)
+    pub const SYNC_LOCK: u32 = 1;
+    pub const SYNC_RWLOCK: u32 = 2;
+    pub const SYNC_COND: u32 = 3;
+
+    struct ObjectSlot<T> {
+        in_use: AtomicU32,
+        object: T,
+    }
+
+    static LOCKS: [ObjectSlot<AdaptiveMutex>; MAX_LOCKS] = {
+        const FREE: ObjectSlot<AdaptiveMutex> = ObjectSlot { in_use: AtomicU32::new(0), object: AdaptiveMutex::new() };
+        [FREE; MAX_LOCKS]
+    };
+
+    static RWLOCKS: [ObjectSlot<RwLock>; MAX_LOCKS] = {
+        const FREE: ObjectSlot<RwLock> = ObjectSlot { in_use: AtomicU32::new(0), object: RwLock::new() };
+        [FREE; MAX_LOCKS]
+    };
+
+    static CONDVARS: [ObjectSlot<Condvar>; MAX_LOCKS] = {
+        const FREE: ObjectSlot<Condvar> = ObjectSlot { in_use: AtomicU32::new(0), object: Condvar::new() };
+        [FREE; MAX_LOCKS]
+    };
+
+    // Handle tabanlı rwlock başına okuma kilidini tutan iş parçacığı yuvaları. Bir bit yalnızca kendi
+    // iş parçacığınca değiştirilir; yuva boşa çıkarken (hiç okuyucu kalmamışken) sıfırlanır.
+    const READER_WORDS: usize = ksched::MAX_THREADS / 64;
+    static READERS: [[AtomicU64; READER_WORDS]; MAX_LOCKS] = {
+        const WORD: AtomicU64 = AtomicU64::new(0);
+        const ROW: [AtomicU64; READER_WORDS] = [WORD; READER_WORDS];
+        [ROW; MAX_LOCKS]
+    };
+
+    // Bir senkronizasyon nesnesi handle'ının provider'ı. Okuma/yazma desteklenmez.
+    struct SyncProvider {
+        kind: u32,
+        index: usize,
+    }
+
+    impl ResourceProvider for SyncProvider {
+        fn read(&self, _buffer: &mut [u8], _offset: u64) -> Result<usize, KError> {
+            Err(KError::NotSupported) // karnal_sync_* kullanılır
+        }
+
+        fn write(&self, _buffer: &[u8], _offset: u64) -> Result<usize, KError> {
+            Err(KError::NotSupported)
+        }
+
+        fn control(&self, _request: u64, _arg: u64) -> Result<i64, KError> {
+            Err(KError::NotSupported)
+        }
+
+        fn sync_object(&self) -> Option<(u32, usize)> {
+            Some((self.kind, self.index))
+        }
+    }
+
+    impl Drop for SyncProvider {
+        fn drop(&mut self) {
+            match self.kind {
+                SYNC_LOCK => LOCKS[self.index].in_use.store(0, Ordering::Release),
+                SYNC_RWLOCK => RWLOCKS[self.index].in_use.store(0, Ordering::Release),
+                _ => {
+                    // Son handle'ı kapanan koşul değişkeninde kimse bekleyemez; yine de kimse uyumakta kalmasın
+                    CONDVARS[self.index].object.notify_all();
+                    CONDVARS[self.index].in_use.store(0, Ordering::Release);
+                }
+            }
+        }
+    }
+
+    // Boş bir yuvayı ayırır, nesneyi `reset` ile sıfırlar ve mevcut görevin tablosunda handle'ını açar.
+    // Handle açılamazsa provider düşerken yuva geri bırakılır.
+    fn create_in<T>(table: &[ObjectSlot<T>], kind: u32, reset: impl FnOnce(&T, usize)) -> Result<KHandle, KError> {
+        for (index, slot) in table.iter().enumerate() {
+            if slot.in_use.compare_exchange(0, 1, Ordering::AcqRel, Ordering::Relaxed).is_ok() {
+                reset(&slot.object, index);
+                return khandle::issue(Arc::new(SyncProvider { kind, index }), 0);
+            }
+        }
+        Err(KError::OutOfMemory)
+    }
+
+    // Handle'ı mevcut görevin tablosunda çözer ve `kind` türündeyse tablo indeksini döner.
+    // Dönen referans tutulduğu sürece (örn. bloklanan bir acquire boyunca) yuva boşa çıkmaz.
+    fn resolve(kind: u32, handle_value: u64) -> Result<(khandle::HandleRef, usize), KError> {
+        let handle = khandle::get(handle_value, 0)?;
+        match handle.provider().sync_object() {
+            Some((object_kind, index)) if object_kind == kind && index < MAX_LOCKS => Ok((handle, index)),
+            _ => Err(KError::BadHandle),
+        }
+    }
+
+    // Çalışan iş parçacığının `index` rwlock'undaki okuyucu biti. Bloklanamayan bağlam okuyucu olamaz.
+    fn reader_bit(index: usize) -> Result<(&'static AtomicU64, u64), KError> {
+        let slot = ksched::current_slot().ok_or(KError::NotSupported)? as usize;
+        Ok((&READERS[index][slot / 64], 1 << (slot % 64)))
+    }
+
+    /// Handle mevcut görevde bir senkronizasyon nesnesine mi ait (resource_release yönlendirmesi için).
+    pub fn is_sync_handle(handle_value: u64) -> bool {
+        khandle::get(handle_value, 0).map_or(false, |handle| handle.provider().sync_object().is_some())
+    }
+
+    /// Kilit, rwlock veya koşul değişkeni handle'ını kapatır. Tutulan veya yazıcı bekleyen bir kilit
+    /// kapatılamaz (Busy); koşul değişkeninde bekleyenler uyandırılır.
+    pub fn sync_destroy(handle_value: u64) -> Result<(), KError> {
+        {
+            let handle = khandle::get(handle_value, 0)?;
+            let busy = match handle.provider().sync_object() {
+                Some((SYNC_LOCK, index)) => LOCKS[index].object.is_locked(),
+                Some((SYNC_RWLOCK, index)) => {
+                    let rw = &RWLOCKS[index].object;
+                    rw.is_locked() || rw.writers_waiting.load(Ordering::Relaxed) != 0
+                }
+                Some((SYNC_COND, index)) => {
+                    CONDVARS[index].object.notify_all();
+                    false
+                }
+                _ => return Err(KError::BadHandle),
+            };
+            if busy {
+                return Err(KError::Busy);
+            }
+        }
+        khandle::close(handle_value)
+    }
+
+    pub fn lock_create() -> Result<KHandle, KError> {
+        create_in(&LOCKS, SYNC_LOCK, |mutex, _| {
+            mutex.owner.store(UNOWNED, Ordering::Relaxed);
+            mutex.waiters.store(0, Ordering::Relaxed);
+        })
+    }
+
+    pub fn lock_acquire(handle_value: u64) -> Result<(), KError> {
+        let (_handle, index) = resolve(SYNC_LOCK, handle_value)?;
+        LOCKS[index].object.lock();
+        Ok(())
+    }
+
+    /// Kilidi bırakır. Çağıran iş parçacığı kilidi tutmuyorsa PermissionDenied döner.
+    pub fn lock_release(handle_value: u64) -> Result<(), KError> {
+        let (_handle, index) = resolve(SYNC_LOCK, handle_value)?;
+        LOCKS[index].object.unlock()
+    }
+
+    pub fn rwlock_create() -> Result<KHandle, KError> {
+        create_in(&RWLOCKS, SYNC_RWLOCK, |rw, index| {
+            rw.state.store(0, Ordering::Relaxed);
+            rw.writers_waiting.store(0, Ordering::Relaxed);
+            rw.writer.store(UNOWNED, Ordering::Relaxed);
+            for word in READERS[index].iter() {
+                word.store(0, Ordering::Relaxed);
+            }
+        })
+    }
+
+    /// Okuma kilidini alır. Çağıran bu rwlock'u zaten okuma için tutuyorsa Busy döner.
+    pub fn rwlock_read_acquire(handle_value: u64) -> Result<(), KError> {
+        let (_handle, index) = resolve(SYNC_RWLOCK, handle_value)?;
+        let (word, bit) = reader_bit(index)?;
+        if word.load(Ordering::Relaxed) & bit != 0 {
+            return Err(KError::Busy);
+        }
+        RWLOCKS[index].object.read_lock();
+        word.fetch_or(bit, Ordering::Relaxed);
+        Ok(())
+    }
+
+    /// Okuma kilidini bırakır. Çağıran iş parçacığı kilidi okuma için tutmuyorsa PermissionDenied döner.
+    pub fn rwlock_read_release(handle_value: u64) -> Result<(), KError> {
+        let (_handle, index) = resolve(SYNC_RWLOCK, handle_value)?;
+        let (word, bit) = reader_bit(index).map_err(|_| KError::PermissionDenied)?;
+        if word.fetch_and(!bit, Ordering::Relaxed) & bit == 0 {
+            return Err(KError::PermissionDenied);
+        }
+        RWLOCKS[index].object.read_unlock()
+    }
+
+    pub fn rwlock_write_acquire(handle_value: u64) -> Result<(), KError> {
+        let (_handle, index) = resolve(SYNC_RWLOCK, handle_value)?;
+        RWLOCKS[index].object.write_lock();
+        Ok(())
+    }
+
+    /// Yazma kilidini bırakır. Çağıran iş parçacığı kilidi yazma için tutmuyorsa PermissionDenied döner.
+    pub fn rwlock_write_release(handle_value: u64) -> Result<(), KError> {
+        let (_handle, index) = resolve(SYNC_RWLOCK, handle_value)?;
+        RWLOCKS[index].object.write_unlock()
+    }
+
+    pub fn cond_create() -> Result<KHandle, KError> {
+        create_in(&CONDVARS, SYNC_COND, |_, _| {})
+    }
+
+    /// Çağıranın tuttuğu `lock_handle`'ı bırakıp bildirim bekler, dönmeden önce kilidi yeniden alır.
+    pub fn cond_wait(cond_handle: u64, lock_handle: u64) -> Result<(), KError> {
+        let (_cond, cond_index) = resolve(SYNC_COND, cond_handle)?;
+        let (_lock, lock_index) = resolve(SYNC_LOCK, lock_handle)?;
+        CONDVARS[cond_index].object.wait(&LOCKS[lock_index].object)
+    }
+
+    pub fn cond_notify_one(cond_handle: u64) -> Result<(), KError> {
+        let (_handle, index) = resolve(SYNC_COND, cond_handle)?;
+        CONDVARS[index].object.notify_one();
+        Ok(())
+    }
+
+    pub fn cond_notify_all(cond_handle: u64) -> Result<(), KError> {
+        let (_handle, index) = resolve(SYNC_COND, cond_handle)?;
+        CONDVARS[index].object.notify_all();
+        Ok(())
+    }
+
+    // --- Futex ---
+
+    fn futex_word<'a>(addr: u64) -> Result<&'a AtomicU32, KError> {
+        if addr == 0 || addr % 4 != 0 {
+            return Err(KError::InvalidArgument);
+        }
+        // TODO: addr'nin kullanıcı adres alanında geçerli olduğunu doğrula
+        Ok(unsafe { &*(addr as *const AtomicU32) })
+    }
+
+    // Anahtar kelimenin fiziksel adresidir. Sayfa önce yazma için kurulur: okumayla kurulan paylaşılan
+    // sıfır/COW sayfasının frame'i ilk yazmada değişir ve eski anahtarda bekleyen hiç uyandırılmaz.
+    // Pager dışındaki eşlemeler (halka, dilim) zaten özeldir; salt okunur bölgede frame değişmez.
+    fn futex_key(addr: u64) -> Result<u64, KError> {
+        if unsafe { kmem_virt_fault_in(addr, 1) } == KError::OutOfMemory as i64 {
+            return Err(KError::OutOfMemory);
+        }
+        let paddr = unsafe { kmem_virt_translate(addr) };
+        if paddr == 0 { Err(KError::BadAddress) } else { Ok(paddr) }
+    }
+
+    /// `*addr == expected` ise çağıranı `futex_wake` gelene kadar bloklar. Değer farklıysa hemen Busy döner;
+    /// çağıran kelimeyi yeniden okuyup tekrar dener. Uyanma, kelimenin değiştiğini garanti etmez.
+    pub fn futex_wait(addr: u64, expected: u32) -> Result<(), KError> {
+        let word = futex_word(addr)?;
+        if word.load(Ordering::SeqCst) != expected {
+            return Err(KError::Busy);
+        }
+        let key = futex_key(addr)?;
+        if wait_on(key, || word.load(Ordering::SeqCst) == expected)? { Ok(()) } else { Err(KError::Busy) }
+    }
+
+    /// `futex_wait` gibi, ancak en fazla `timeout_ns` bekler; süre dolarsa TimedOut döner.
+    pub fn futex_wait_timeout(addr: u64, expected: u32, timeout_ns: u64) -> Result<(), KError> {
+        let word = futex_word(addr)?;
+        if word.load(Ordering::SeqCst) != expected {
+            return Err(KError::Busy);
+        }
+        let key = futex_key(addr)?;
+        let deadline = ktimer::now_ns().saturating_add(timeout_ns);
+        if wait_on_until(key, deadline, || word.load(Ordering::SeqCst) == expected)? { Ok(()) } else { Err(KError::Busy) }
+    }
+
+    /// `addr` üzerinde bekleyen en fazla `count` iş parçacığını uyandırır ve uyandırılan sayıyı döner.
+    pub fn futex_wake(addr: u64, count: u32) -> Result<u32, KError> {
+        futex_word(addr)?;
+        Ok(wake_key(futex_key(addr)?, count))
+    }
+
+    // --- C API ---
+
+    #[no_mangle]
+    pub extern "C" fn karnal_sync_lock_create() -> i64 {
+        match lock_create() {
+            Ok(handle) => handle.0 as i64,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_sync_lock_acquire(handle_value: u64) -> i64 {
+        match lock_acquire(handle_value) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_sync_lock_release(handle_value: u64) -> i64 {
+        match lock_release(handle_value) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_sync_rwlock_create() -> i64 {
+        match rwlock_create() {
+            Ok(handle) => handle.0 as i64,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_sync_rwlock_read_acquire(handle_value: u64) -> i64 {
+        match rwlock_read_acquire(handle_value) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_sync_rwlock_read_release(handle_value: u64) -> i64 {
+        match rwlock_read_release(handle_value) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_sync_rwlock_write_acquire(handle_value: u64) -> i64 {
+        match rwlock_write_acquire(handle_value) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_sync_rwlock_write_release(handle_value: u64) -> i64 {
+        match rwlock_write_release(handle_value) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_sync_cond_create() -> i64 {
+        match cond_create() {
+            Ok(handle) => handle.0 as i64,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_sync_cond_wait(cond_handle: u64, lock_handle: u64) -> i64 {
+        match cond_wait(cond_handle, lock_handle) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_sync_cond_notify_one(cond_handle: u64) -> i64 {
+        match cond_notify_one(cond_handle) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_sync_cond_notify_all(cond_handle: u64) -> i64 {
+        match cond_notify_all(cond_handle) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_futex_wait(addr: *const u32, expected: u32) -> i64 {
+        match futex_wait(addr as u64, expected) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_futex_wait_timeout(addr: *const u32, expected: u32, timeout_ns: u64) -> i64 {
+        match futex_wait_timeout(addr as u64, expected, timeout_ns) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_futex_wake(addr: *const u32, count: u32) -> i64 {
+        match futex_wake(addr as u64, count) {
+            Ok(woken) => woken as i64,
+            Err(err) => err as i64,
+        }
+    }
+}
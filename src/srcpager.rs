@@ -0,0 +1,799 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, ResourceProvider, kresource};
+
+// --- İstek Üzerine Sayfalama: Tembel Sıfır Doldurma ve Yazmada Kopyalama (COW) ---
+// Görev başlatılırken sayfalar önceden doldurulmaz; adres alanına yalnızca bölge (region) kayıtları eklenir.
+// Sayfalar ilk erişimdeki sayfa hatasında (mimari istisna işleyicisi -> handle_fault) kurulur:
+// - Sıfır bölgeleri (bss/heap/stack): okuma, paylaşılan tek sıfır frame'ini salt okunur eşler.
+//   İlk yazma kendi sıfırlı frame'ini alır.
+// - İmaj bölgeleri (kod/salt okunur veri/veri): sayfa, kaynağın kimliği (provider'ın Arc adresi) ve dosya
+//   ofsetiyle anahtarlanan imaj önbelleğinden gelir. Aynı kod kaynağından başlatılan görevler, handle
+//   değerleri farklı olsa da aynı fiziksel frame'leri paylaşır. Kaynak bölge eklenirken çözülür ve bölgede
+//   tutulur: hata anında handle tablosuna bakılmaz, çünkü handle kapanmış veya hata başka bir görevin
+//   bağlamında (çekirdeğin kullanıcı belleğine erişimi) çözülüyor olabilir.
+//   Yazılabilir imaj sayfaları salt okunur eşlenir ve ilk yazmada kopyalanır (COW).
+//   Kaynak sayfayı zaten bellekte tutuyorsa (initrd gibi, ResourceProvider::mmap_frame) ve frame sabit bir
+//   aralıktaysa (add_fixed_range) o frame önbelleğe okunmadan doğrudan eşlenir.
+//
+// Paylaşılan frame'lerin referans sayıları SHARE tablosunda tutulur. Tabloda olmayan bir frame'in tek sahibi
+// vardır. Bu yüzden tek sahibi kalan bir COW sayfası kopyalanmadan yazılabilir yapılır.
+// Bölge tablosunun kilidi aynı adres alanındaki hataları sıralar (mmap kilidi gibi);
+// farklı adres alanlarının hataları yalnızca kısa süreli SHARE/önbellek kilitlerinde karşılaşır.
+
+pub mod kpager {
+    use super::*;
+    use crate::kbuddy;
+    use alloc::sync::{Arc, Weak};
+    use core::sync::atomic::{AtomicU64, Ordering};
+    use spin::Mutex;
+
+    pub const PAGE_SIZE: u64 = 4096;
+
+    // kernel_memory.h'deki KMEM_PAGE_* bayrakları
+    pub const PROT_READ: u32 = 1 << 0;
+    pub const PROT_WRITE: u32 = 1 << 1;
+    pub const PROT_EXEC: u32 = 1 << 2;
+    pub const PROT_USER: u32 = 1 << 3;
+
+    /// Bölge tablosu tutulan en fazla adres alanı
+    pub const MAX_ADDRESS_SPACES: usize = 256;
+    /// Adres alanı başına en fazla bölge (kod, rodata, veri, bss, heap, yığıt + yedek)
+    pub const MAX_REGIONS: usize = 8;
+    // Paylaşılan frame referans tablosu ve imaj önbelleği yuvaları
+    const SHARE_SLOTS: usize = 4096;
+    const IMAGE_CACHE_SLOTS: usize = 2048;
+    // Önbellekte sayfası bulunabilen en fazla kod kaynağı
+    const IMAGE_OWNERS: usize = 64;
+
+    const EMPTY: u64 = 0;
+    const TOMBSTONE: u64 = u64::MAX;
+
+    /// Hataya neden olan erişim türü (mimari hata kodundan çıkarılır)
+    #[derive(Debug, Copy, Clone, PartialEq, Eq)]
+    pub enum Access {
+        Read,
+        Write,
+        Execute,
+    }
+
+    /// Bir bölgenin sayfalarının nereden geldiği
+    #[derive(Clone)]
+    pub enum Backing {
+        /// İlk erişimde sıfır dolu sayfa (bss/heap/yığıt)
+        Zero,
+        /// Kod kaynağından: bölgenin ilk sayfası `file_offset`'ten okunur, `file_size` ötesi sıfırdır.
+        /// Bölge yaşadıkça kaynağı (ve önbellekteki sayfalarını) ayakta tutar.
+        Image { provider: Arc<dyn ResourceProvider>, file_offset: u64, file_size: u64 },
+    }
+
+    #[derive(Clone)]
+    pub struct Region {
+        pub start: u64,
+        pub end: u64,   // Hariç
+        pub prot: u32,  // KMEM_PAGE_*
+        pub backing: Backing,
+    }
+
+    /// Mimariye özel sayfa tablosu işlemleri. Her mimarinin MMU modülü hata işleyicisi için sağlar.
+    pub trait FaultMmu {
+        /// `vaddr`'daki 4K yaprak: haritalıysa (frame, yazılabilir mi).
+        fn lookup(&self, vaddr: u64) -> Option<(u64, bool)>;
+        /// Yaprağı kurar veya (`replace`) değiştirir. Değiştirmede eski girdinin TLB temizliği
+        /// (diğer CPU'lar dahil) bu çağrı dönmeden tamamlanmalıdır.
+        fn install(&self, vaddr: u64, frame: u64, prot: u32, replace: bool) -> Result<(), KError>;
+    }
+
+    // --- İstatistikler (KARNAL_INFO_PAGER_*) ---
+    pub const INFO_PAGER_ZERO_FILLS: u32 = 0x300;
+    pub const INFO_PAGER_COW_COPIES: u32 = 0x301;
+    pub const INFO_PAGER_SHARED_MAPS: u32 = 0x302;
+    pub const INFO_PAGER_IMAGE_READS: u32 = 0x303;
+    pub const INFO_PAGER_DIRECT_MAPS: u32 = 0x304;
+
+    static ZERO_FILLS: AtomicU64 = AtomicU64::new(0);
+    static COW_COPIES: AtomicU64 = AtomicU64::new(0);
+    static SHARED_MAPS: AtomicU64 = AtomicU64::new(0);
+    static IMAGE_READS: AtomicU64 = AtomicU64::new(0);
+    static DIRECT_MAPS: AtomicU64 = AtomicU64::new(0);
+
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        let counter = match info_type {
+            INFO_PAGER_ZERO_FILLS => &ZERO_FILLS,
+            INFO_PAGER_COW_COPIES => &COW_COPIES,
+            INFO_PAGER_SHARED_MAPS => &SHARED_MAPS,
+            INFO_PAGER_IMAGE_READS => &IMAGE_READS,
+            INFO_PAGER_DIRECT_MAPS => &DIRECT_MAPS,
+            _ => return None,
+        };
+        Some(counter.load(Ordering::Relaxed))
+    }
+
+    // --- Frame'ler ---
+
+    // Tüm sıfır bölgelerinin okumalarında paylaşılan frame. Hiç iade edilmez.
+    static ZERO_FRAME: AtomicU64 = AtomicU64::new(0);
+
+    fn zero_frame() -> Option<u64> {
+        let frame = ZERO_FRAME.load(Ordering::Acquire);
+        if frame != 0 {
+            return Some(frame);
+        }
+        let new = alloc_zeroed()?;
+        match ZERO_FRAME.compare_exchange(0, new, Ordering::AcqRel, Ordering::Acquire) {
+            Ok(_) => Some(new),
+            Err(existing) => {
+                kbuddy::kmem_phys_free_frame(new);
+                Some(existing)
+            }
+        }
+    }
+
+    fn alloc_zeroed() -> Option<u64> {
+        let frame = kbuddy::kmem_phys_alloc_frame();
+        if frame == 0 {
+            return None;
+        }
+        // Fiziksel bellek kimlik haritalı
+        unsafe { core::ptr::write_bytes(frame as *mut u8, 0, PAGE_SIZE as usize); }
+        Some(frame)
+    }
+
+    fn alloc_copy(src: u64) -> Option<u64> {
+        let frame = kbuddy::kmem_phys_alloc_frame();
+        if frame == 0 {
+            return None;
+        }
+        unsafe { core::ptr::copy_nonoverlapping(src as *const u8, frame as *mut u8, PAGE_SIZE as usize); }
+        Some(frame)
+    }
+
+    // Paylaşılan frame'lerin referans sayıları (açık adresleme). Kayıt yoksa frame'in tek sahibi vardır.
+    struct ShareTable {
+        frames: [u64; SHARE_SLOTS],
+        counts: [u32; SHARE_SLOTS],
+    }
+
+    static SHARES: Mutex<ShareTable> = Mutex::new(ShareTable {
+        frames: [EMPTY; SHARE_SLOTS],
+        counts: [0; SHARE_SLOTS],
+    });
+
+    impl ShareTable {
+        fn home_slot(frame: u64) -> usize {
+            ((frame >> 12).wrapping_mul(0x9E37_79B9_7F4A_7C15) >> 52) as usize % SHARE_SLOTS
+        }
+
+        fn find(&self, frame: u64) -> Option<usize> {
+            let home = Self::home_slot(frame);
+            for i in 0..SHARE_SLOTS {
+                let slot = (home + i) % SHARE_SLOTS;
+                match self.frames[slot] {
+                    EMPTY => return None,
+                    f if f == frame => return Some(slot),
+                    _ => {}
+                }
+            }
+            None
+        }
+
+        /// Frame'e bir sahip ekler. Tablo doluysa false döner; çağıran paylaşmak yerine kopyalamalıdır.
+        fn share(&mut self, frame: u64) -> bool {
+            if let Some(slot) = self.find(frame) {
+                self.counts[slot] += 1;
+                return true;
+            }
+            let home = Self::home_slot(frame);
+            for i in 0..SHARE_SLOTS {
+                let slot = (home + i) % SHARE_SLOTS;
+                if self.frames[slot] == EMPTY || self.frames[slot] == TOMBSTONE {
+                    self.frames[slot] = frame;
+                    self.counts[slot] = 2;
+                    return true;
+                }
+            }
+            false
+        }
+
+        /// Bir sahibi düşürür. Son sahip düştüyse true döner (frame iade edilmelidir).
+        fn release(&mut self, frame: u64) -> bool {
+            match self.find(frame) {
+                Some(slot) => {
+                    self.counts[slot] -= 1;
+                    if self.counts[slot] == 1 {
+                        self.frames[slot] = TOMBSTONE;
+                        self.counts[slot] = 0;
+                    }
+                    false
+                }
+                None => true,
+            }
+        }
+
+        fn is_shared(&self, frame: u64) -> bool {
+            self.find(frame).is_some()
+        }
+    }
+
+    // --- Sabit Aralıklar ---
+    // Pager'ın sahibi olmadığı, kaynakların doğrudan eşlettiği fiziksel bellek (initrd arşivi gibi).
+    // Bu frame'ler hiç iade edilmez ve yerinde yazılabilir yapılmaz; yazma her zaman kopyalar.
+    // Aralıklar açılışta eklenir ve silinmez, bu yüzden okuma kilit almaz.
+    const MAX_FIXED_RANGES: usize = 8;
+
+    static FIXED_BASES: [AtomicU64; MAX_FIXED_RANGES] = [const { AtomicU64::new(0) }; MAX_FIXED_RANGES];
+    static FIXED_ENDS: [AtomicU64; MAX_FIXED_RANGES] = [const { AtomicU64::new(0) }; MAX_FIXED_RANGES];
+    static FIXED_COUNT: AtomicU64 = AtomicU64::new(0);
+    static FIXED_LOCK: Mutex<()> = Mutex::new(());
+
+    /// `[base, base + size)` aralığını sabit olarak işaretler. Aralık buddy ayırıcıya hiç verilmemiş olmalıdır.
+    pub fn add_fixed_range(base: u64, size: u64) -> Result<(), KError> {
+        if base % PAGE_SIZE != 0 || size == 0 {
+            return Err(KError::InvalidArgument);
+        }
+        let end = base.checked_add(size).ok_or(KError::InvalidArgument)?;
+        let _guard = FIXED_LOCK.lock();
+        let count = FIXED_COUNT.load(Ordering::Relaxed) as usize;
+        if count == MAX_FIXED_RANGES {
+            return Err(KError::OutOfMemory);
+        }
+        FIXED_BASES[count].store(base, Ordering::Relaxed);
+        FIXED_ENDS[count].store(end, Ordering::Relaxed);
+        // Release: sayacı gören okuyucu aralığın sınırlarını da görür
+        FIXED_COUNT.store(count as u64 + 1, Ordering::Release);
+        Ok(())
+    }
+
+    fn is_fixed(frame: u64) -> bool {
+        let count = FIXED_COUNT.load(Ordering::Acquire) as usize;
+        (0..count).any(|i| {
+            frame >= FIXED_BASES[i].load(Ordering::Relaxed) && frame + PAGE_SIZE <= FIXED_ENDS[i].load(Ordering::Relaxed)
+        })
+    }
+
+    /// Pager'ın kurduğu bir yaprak frame'ini bırakır (adres alanı yıkımı, unmap).
+    /// Son sahipse frame buddy ayırıcıya döner. Çağıran, frame'in TLB girdilerini önceden temizlemiş olmalıdır.
+    pub fn release_frame(frame: u64) {
+        if frame == 0 || frame == ZERO_FRAME.load(Ordering::Relaxed) || is_fixed(frame) {
+            return;
+        }
+        if SHARES.lock().release(frame) {
+            kbuddy::kmem_phys_free_frame(frame);
+        }
+    }
+
+    /// İleti ile taşınan bir frame'in alıcıda yazılabilir eşlenebilecek tek sahipli hâlini döner.
+    /// Paylaşılan (COW), sıfır veya sabit frame kopyalanır ve bir referansı bırakılır; tek sahipli frame aynen döner.
+    /// Kopya için bellek yoksa None döner ve `frame` çağıranda kalır.
+    pub fn make_exclusive(frame: u64) -> Option<u64> {
+        let shared = frame == ZERO_FRAME.load(Ordering::Relaxed) || is_fixed(frame) || SHARES.lock().is_shared(frame);
+        if !shared {
+            return Some(frame);
+        }
+        let copy = alloc_copy(frame)?;
+        release_frame(frame);
+        COW_COPIES.fetch_add(1, Ordering::Relaxed);
+        Some(copy)
+    }
+
+    // --- İmaj Önbelleği ---
+    // (kaynak anahtarı, dosya sayfası) -> frame. Önbellek her frame'de bir referans tutar.
+    // Anahtar provider'ın Arc adresidir: handle değerleri görevler arasında çakışır, kaynağın kendisi değil.
+    // Sahip tablosundaki Weak, provider düşse bile ayırmayı ayakta tutar; böylece girdileri silinmeden
+    // aynı adres başka bir kaynağa verilemez.
+    struct ImageCache {
+        owners: [u64; IMAGE_CACHE_SLOTS],
+        pages: [u64; IMAGE_CACHE_SLOTS],
+        frames: [u64; IMAGE_CACHE_SLOTS],
+    }
+
+    static IMAGE_CACHE: Mutex<ImageCache> = Mutex::new(ImageCache {
+        owners: [EMPTY; IMAGE_CACHE_SLOTS],
+        pages: [0; IMAGE_CACHE_SLOTS],
+        frames: [0; IMAGE_CACHE_SLOTS],
+    });
+
+    static OWNERS: Mutex<[Option<Weak<dyn ResourceProvider>>; IMAGE_OWNERS]> = Mutex::new([const { None }; IMAGE_OWNERS]);
+
+    fn provider_key(provider: &Arc<dyn ResourceProvider>) -> u64 {
+        Arc::as_ptr(provider) as *const u8 as u64
+    }
+
+    // Kaynağı sahip tablosuna kaydeder. Tablo doluysa false: sayfası önbelleğe girmez, özel kalır.
+    fn track_owner(provider: &Arc<dyn ResourceProvider>) -> bool {
+        let key = provider_key(provider);
+        let mut owners = OWNERS.lock();
+        if owners.iter().flatten().any(|w| w.as_ptr() as *const u8 as u64 == key) {
+            return true;
+        }
+        match owners.iter_mut().find(|w| w.is_none()) {
+            Some(free) => {
+                *free = Some(Arc::downgrade(provider));
+                true
+            }
+            None => false,
+        }
+    }
+
+    impl ImageCache {
+        fn home_slot(owner: u64, page: u64) -> usize {
+            ((owner ^ page.rotate_left(32)).wrapping_mul(0x9E37_79B9_7F4A_7C15) >> 53) as usize % IMAGE_CACHE_SLOTS
+        }
+
+        fn find(&self, owner: u64, page: u64) -> Option<usize> {
+            let home = Self::home_slot(owner, page);
+            for i in 0..IMAGE_CACHE_SLOTS {
+                let slot = (home + i) % IMAGE_CACHE_SLOTS;
+                match self.owners[slot] {
+                    EMPTY => return None,
+                    o if o == owner && self.pages[slot] == page => return Some(slot),
+                    _ => {}
+                }
+            }
+            None
+        }
+
+        fn insert(&mut self, owner: u64, page: u64, frame: u64) -> bool {
+            let home = Self::home_slot(owner, page);
+            for i in 0..IMAGE_CACHE_SLOTS {
+                let slot = (home + i) % IMAGE_CACHE_SLOTS;
+                if self.owners[slot] == EMPTY || self.owners[slot] == TOMBSTONE {
+                    self.owners[slot] = owner;
+                    self.pages[slot] = page;
+                    self.frames[slot] = frame;
+                    return true;
+                }
+            }
+            false
+        }
+    }
+
+    // Dosya ofsetindeki sayfayı yeni bir frame'e okur; `valid` byte'tan sonrası sıfırdır.
+    fn read_image_page(provider: &dyn ResourceProvider, offset: u64, valid: usize) -> Result<u64, KError> {
+        let frame = alloc_zeroed().ok_or(KError::OutOfMemory)?;
+        let buffer = unsafe { core::slice::from_raw_parts_mut(frame as *mut u8, valid) };
+        match provider.read(buffer, offset) {
+            Ok(_) => {
+                // Kısa okuma: kalan kısım zaten sıfır
+                IMAGE_READS.fetch_add(1, Ordering::Relaxed);
+                Ok(frame)
+            }
+            Err(e) => {
+                kbuddy::kmem_phys_free_frame(frame);
+                Err(e)
+            }
+        }
+    }
+
+    /// Dosya ofsetindeki tam sayfanın paylaşılan frame'ini döner; çağırana bir referans verilir.
+    /// Önbellek, sahip tablosu veya SHARE tablosu doluysa özel (paylaşılmayan) bir kopya döner.
+    fn image_frame(provider: &Arc<dyn ResourceProvider>, offset: u64) -> Result<u64, KError> {
+        // Kaynağın kendi frame'i sabit aralıktaysa referans sayımı gerekmez; önbelleğe de girmez
+        if let Ok(frame) = provider.mmap_frame(offset, false) {
+            if is_fixed(frame) {
+                DIRECT_MAPS.fetch_add(1, Ordering::Relaxed);
+                return Ok(frame);
+            }
+        }
+
+        let owner = provider_key(provider);
+        let page = offset / PAGE_SIZE;
+        {
+            let cache = IMAGE_CACHE.lock();
+            if let Some(slot) = cache.find(owner, page) {
+                let frame = cache.frames[slot];
+                if SHARES.lock().share(frame) {
+                    SHARED_MAPS.fetch_add(1, Ordering::Relaxed);
+                    return Ok(frame);
+                }
+                // Kopya önbellek kilidi altında alınır; release_image frame'i bu arada bırakamaz
+                return alloc_copy(frame).ok_or(KError::OutOfMemory);
+            }
+        }
+
+        // Okuma kilit dışında yapılır; aynı sayfayı eşzamanlı okuyan kaybeder ve kendi frame'ini bırakır.
+        let frame = read_image_page(&**provider, offset, PAGE_SIZE as usize)?;
+        if !track_owner(provider) {
+            return Ok(frame);
+        }
+        let mut cache = IMAGE_CACHE.lock();
+        if let Some(slot) = cache.find(owner, page) {
+            let existing = cache.frames[slot];
+            if SHARES.lock().share(existing) {
+                drop(cache);
+                kbuddy::kmem_phys_free_frame(frame);
+                SHARED_MAPS.fetch_add(1, Ordering::Relaxed);
+                return Ok(existing);
+            }
+            return Ok(frame);
+        }
+        // Önbellek referansı + çağıranın referansı
+        if SHARES.lock().share(frame) {
+            if cache.insert(owner, page, frame) {
+                return Ok(frame);
+            }
+            SHARES.lock().release(frame);
+        }
+        Ok(frame)
+    }
+
+    // Kaynağın önbellekteki sayfalarını bırakır. Eşli sayfalar haritalı kaldıkça yaşar.
+    fn release_image(owner: u64) {
+        let mut released = [0u64; 64];
+        loop {
+            let mut count = 0;
+            {
+                let mut cache = IMAGE_CACHE.lock();
+                for slot in 0..IMAGE_CACHE_SLOTS {
+                    if cache.owners[slot] == owner {
+                        cache.owners[slot] = TOMBSTONE;
+                        released[count] = cache.frames[slot];
+                        count += 1;
+                        if count == released.len() {
+                            break;
+                        }
+                    }
+                }
+            }
+            for &frame in &released[..count] {
+                release_frame(frame);
+            }
+            if count < released.len() {
+                return;
+            }
+        }
+    }
+
+    /// Son referansı bırakılmış kod kaynaklarının önbellekteki sayfalarını bırakır. Handle kapatıldığında,
+    /// görev sonlandığında ve adres alanı yıkıldığında çağrılır; hâlâ açık, kayıtlı veya bir bölgede eşli
+    /// kaynakların sayfaları önbellekte kalır.
+    pub fn release_dead_images() {
+        loop {
+            let dead = {
+                let mut owners = OWNERS.lock();
+                match owners.iter_mut().find(|w| w.as_ref().map_or(false, |w| w.strong_count() == 0)) {
+                    Some(slot) => slot.take(),
+                    None => return,
+                }
+            };
+            // Girdiler Weak düşmeden silinir: adres ancak bundan sonra yeniden kullanılabilir
+            if let Some(weak) = dead {
+                release_image(weak.as_ptr() as *const u8 as u64);
+            }
+        }
+    }
+
+    // --- Adres Alanı Bölge Tabloları ---
+
+    struct SpaceSlot {
+        root: AtomicU64,
+        regions: Mutex<[Option<Region>; MAX_REGIONS]>,
+    }
+
+    const SLOT_INIT: SpaceSlot = SpaceSlot { root: AtomicU64::new(EMPTY), regions: Mutex::new([const { None }; MAX_REGIONS]) };
+    static SPACES: [SpaceSlot; MAX_ADDRESS_SPACES] = [SLOT_INIT; MAX_ADDRESS_SPACES];
+    static SPACES_LOCK: Mutex<()> = Mutex::new(());
+
+    fn home_slot(root: u64) -> usize {
+        ((root >> 12).wrapping_mul(0x9E37_79B9_7F4A_7C15) >> 56) as usize % MAX_ADDRESS_SPACES
+    }
+
+    fn find_space(root: u64) -> Option<&'static SpaceSlot> {
+        let home = home_slot(root);
+        for i in 0..MAX_ADDRESS_SPACES {
+            let slot = &SPACES[(home + i) % MAX_ADDRESS_SPACES];
+            match slot.root.load(Ordering::Acquire) {
+                EMPTY => return None,
+                r if r == root => return Some(slot),
+                _ => {}
+            }
+        }
+        None
+    }
+
+    fn find_or_create_space(root: u64) -> Result<&'static SpaceSlot, KError> {
+        if root == EMPTY || root == TOMBSTONE {
+            return Err(KError::InvalidArgument);
+        }
+        if let Some(slot) = find_space(root) {
+            return Ok(slot);
+        }
+        let _guard = SPACES_LOCK.lock();
+        if let Some(slot) = find_space(root) {
+            return Ok(slot);
+        }
+        let home = home_slot(root);
+        for i in 0..MAX_ADDRESS_SPACES {
+            let slot = &SPACES[(home + i) % MAX_ADDRESS_SPACES];
+            let current = slot.root.load(Ordering::Relaxed);
+            if current == EMPTY || current == TOMBSTONE {
+                *slot.regions.lock() = [const { None }; MAX_REGIONS];
+                slot.root.store(root, Ordering::Release);
+                return Ok(slot);
+            }
+        }
+        Err(KError::OutOfMemory)
+    }
+
+    /// Adres alanına tembel bir bölge ekler. Hiçbir sayfa tahsis edilmez veya haritalanmaz.
+    /// `start`/`size` sayfa hizalı olmalıdır; imaj bölgelerinde `file_offset` da sayfa hizalı olmalıdır.
+    pub fn add_region(root: u64, start: u64, size: u64, prot: u32, backing: Backing) -> Result<(), KError> {
+        if size == 0 || start % PAGE_SIZE != 0 || size % PAGE_SIZE != 0 {
+            return Err(KError::InvalidArgument);
+        }
+        if let Backing::Image { file_offset, .. } = &backing {
+            if file_offset % PAGE_SIZE != 0 {
+                return Err(KError::InvalidArgument);
+            }
+        }
+        let end = start.checked_add(size).ok_or(KError::InvalidArgument)?;
+        let space = find_or_create_space(root)?;
+        let mut regions = space.regions.lock();
+        if regions.iter().flatten().any(|r| start < r.end && r.start < end) {
+            return Err(KError::AlreadyExists);
+        }
+        let free = regions.iter_mut().find(|r| r.is_none()).ok_or(KError::OutOfMemory)?;
+        *free = Some(Region { start, end, prot, backing });
+        Ok(())
+    }
+
+    // --- ELF64 Yükleyici ---
+    // task_spawn, kod kaynağının PT_LOAD segmentlerini imaj bölgeleri olarak ekler; hiçbir sayfa okunmaz.
+    // Yalnızca konumu sabit (ET_EXEC) küçük sonlu ELF64 imajları desteklenir. Segmentler kullanıcı
+    // yarısının imaj penceresinde olmalıdır (üstü dilim/heap/haritalama pencereleri ve yığıt içindir).
+    // Segmentin ilk ve son sayfası dosyada komşu byte'ları da görür; komşu segmentle aynı sayfayı
+    // paylaşan imajlar (sayfa hizasız bağlanmış) AlreadyExists ile reddedilir.
+
+    /// İmaj segmentlerinin yerleşebileceği en yüksek adres (hariç)
+    pub const USER_IMAGE_END: u64 = 0x0000_5F00_0000_0000;
+
+    const ELF_HEADER_SIZE: usize = 64;
+    const ELF_PHDR_SIZE: usize = 56;
+    const ELF_MAX_PHDRS: usize = 64;
+    const ET_EXEC: u16 = 2;
+    const PT_LOAD: u32 = 1;
+    const PF_X: u32 = 1 << 0;
+    const PF_W: u32 = 1 << 1;
+    #[cfg(target_arch = "x86_64")]
+    const EM_HOST: u16 = 62;
+    #[cfg(target_arch = "aarch64")]
+    const EM_HOST: u16 = 183;
+    #[cfg(target_arch = "riscv64")]
+    const EM_HOST: u16 = 243;
+    #[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64", target_arch = "riscv64")))]
+    const EM_HOST: u16 = 0;
+
+    fn le16(b: &[u8], at: usize) -> u16 {
+        u16::from_le_bytes([b[at], b[at + 1]])
+    }
+
+    fn le32(b: &[u8], at: usize) -> u32 {
+        u32::from_le_bytes([b[at], b[at + 1], b[at + 2], b[at + 3]])
+    }
+
+    fn le64(b: &[u8], at: usize) -> u64 {
+        let mut bytes = [0u8; 8];
+        bytes.copy_from_slice(&b[at..at + 8]);
+        u64::from_le_bytes(bytes)
+    }
+
+    /// Kod kaynağındaki ELF64 imajının yüklenebilir segmentlerini `root` adres alanına tembel bölgeler olarak
+    /// ekler ve giriş noktasını döner. Segmentler kmem_virt_map_image ile aynı yoldan (map_image) eşlenir.
+    /// Hata durumunda eklenmiş bölgeler kalır; çağıran adres alanını yıkar.
+    pub fn load_image(root: u64, code_handle: u64) -> Result<u64, KError> {
+        let handle = kresource::get_handle(code_handle, kresource::MODE_READ)?;
+        let provider = handle.provider();
+        let mut header = [0u8; ELF_HEADER_SIZE];
+        if provider.read(&mut header, 0)? < ELF_HEADER_SIZE {
+            return Err(KError::InvalidArgument);
+        }
+        // ELFCLASS64, ELFDATA2LSB
+        if header[0..4] != *b"\x7fELF" || header[4] != 2 || header[5] != 1 {
+            return Err(KError::InvalidArgument);
+        }
+        if le16(&header, 16) != ET_EXEC || le16(&header, 18) != EM_HOST {
+            return Err(KError::NotSupported);
+        }
+        let entry = le64(&header, 24);
+        let phoff = le64(&header, 32);
+        let phentsize = le16(&header, 54) as usize;
+        let phnum = le16(&header, 56) as usize;
+        if phentsize < ELF_PHDR_SIZE || phnum > ELF_MAX_PHDRS {
+            return Err(KError::InvalidArgument);
+        }
+
+        let mut entry_mapped = false;
+        for i in 0..phnum {
+            let mut phdr = [0u8; ELF_PHDR_SIZE];
+            let at = phoff.checked_add((i * phentsize) as u64).ok_or(KError::InvalidArgument)?;
+            if provider.read(&mut phdr, at)? < ELF_PHDR_SIZE {
+                return Err(KError::InvalidArgument);
+            }
+            if le32(&phdr, 0) != PT_LOAD {
+                continue;
+            }
+            let flags = le32(&phdr, 4);
+            let offset = le64(&phdr, 8);
+            let vaddr = le64(&phdr, 16);
+            let file_size = le64(&phdr, 32);
+            let mem_size = le64(&phdr, 40);
+            if mem_size == 0 {
+                continue;
+            }
+            // Bellek ve dosya ofseti aynı sayfa içi konumda olmalıdır (sayfa dosyadan olduğu gibi eşlenir)
+            if file_size > mem_size || vaddr % PAGE_SIZE != offset % PAGE_SIZE || vaddr < PAGE_SIZE {
+                return Err(KError::InvalidArgument);
+            }
+            let end = vaddr.checked_add(mem_size).filter(|&end| end <= USER_IMAGE_END).ok_or(KError::InvalidArgument)?;
+            let start = vaddr & !(PAGE_SIZE - 1);
+            let lead = vaddr - start;
+            let size = ((end - start) + PAGE_SIZE - 1) & !(PAGE_SIZE - 1);
+
+            let mut prot = PROT_USER | PROT_READ;
+            if flags & PF_W != 0 {
+                prot |= PROT_WRITE;
+            }
+            if flags & PF_X != 0 {
+                prot |= PROT_EXEC;
+                entry_mapped |= entry >= vaddr && entry < end;
+            }
+            map_image(root, start, size, code_handle, offset - lead, file_size + lead, prot)?;
+        }
+        if !entry_mapped {
+            return Err(KError::InvalidArgument);
+        }
+        Ok(entry)
+    }
+
+    /// kmem_virt_map_image ve load_image'ın ortak yolu. Handle çağıranın tablosunda şimdi çözülür;
+    /// bölge handle kapansa da kaynağı tutar.
+    pub fn map_image(root: u64, vaddr: u64, size: u64, code_handle: u64, file_offset: u64, file_size: u64,
+                     flags: u32) -> Result<(), KError> {
+        if file_size > size {
+            return Err(KError::InvalidArgument);
+        }
+        let provider = kresource::get_handle(code_handle, kresource::MODE_READ)?.provider_arc();
+        add_region(root, vaddr, size, flags, Backing::Image { provider, file_offset, file_size })
+    }
+
+    /// `vaddr` pager'ın yönettiği bir bölgede mi? Yıkımda hangi yaprak frame'lerinin
+    /// release_frame ile bırakılacağını belirlemek için kullanılır.
+    pub fn owns(root: u64, vaddr: u64) -> bool {
+        find_space(root).map_or(false, |space| {
+            space.regions.lock().iter().flatten().any(|r| r.start <= vaddr && vaddr < r.end)
+        })
+    }
+
+    /// Adres alanının bölge kayıtlarını siler. Yaprak frame'leri mimari yıkım kodu release_frame ile bırakır.
+    pub fn release_space(root: u64) {
+        let regions = {
+            let _guard = SPACES_LOCK.lock();
+            match find_space(root) {
+                Some(space) => {
+                    let regions = core::mem::take(&mut *space.regions.lock());
+                    space.root.store(TOMBSTONE, Ordering::Release);
+                    regions
+                }
+                None => return,
+            }
+        };
+        // Bölgelerin kaynak referansları kilitler dışında düşer; son kullanıcıysa önbellekteki sayfaları da bırakılır
+        drop(regions);
+        release_dead_images();
+    }
+
+    /// Sayfa hatasını çözer. Ok: erişim yeniden denenebilir. Err: adres bölge dışında veya izin yok
+    /// (BadAddress / PermissionDenied) ya da bellek tükendi; mimari işleyici görevi sonlandırır.
+    pub fn handle_fault(root: u64, vaddr: u64, access: Access, mmu: &dyn FaultMmu) -> Result<(), KError> {
+        let space = find_space(root).ok_or(KError::BadAddress)?;
+        // Bölge kilidi bu adres alanının hatalarını sıralar
+        let regions = space.regions.lock();
+        let region = regions.iter().flatten().find(|r| r.start <= vaddr && vaddr < r.end).ok_or(KError::BadAddress)?;
+
+        match access {
+            Access::Write if region.prot & PROT_WRITE == 0 => return Err(KError::PermissionDenied),
+            Access::Execute if region.prot & PROT_EXEC == 0 => return Err(KError::PermissionDenied),
+            _ => {}
+        }
+
+        let page = vaddr & !(PAGE_SIZE - 1);
+        match mmu.lookup(page) {
+            Some((_, true)) => Ok(()), // Başka bir CPU çözmüş veya eski TLB girdisi
+            Some((frame, false)) => {
+                if access != Access::Write {
+                    return Ok(());
+                }
+                break_cow(page, frame, region.prot, mmu)
+            }
+            None => populate(page, region, access, mmu),
+        }
+    }
+
+    // Salt okunur eşlenmiş paylaşılan sayfaya yazma: tek sahip kaldıysa yerinde yazılabilir yap, değilse kopyala.
+    fn break_cow(page: u64, frame: u64, prot: u32, mmu: &dyn FaultMmu) -> Result<(), KError> {
+        let zero = ZERO_FRAME.load(Ordering::Relaxed);
+        if frame != zero && !is_fixed(frame) && !SHARES.lock().is_shared(frame) {
+            return mmu.install(page, frame, prot, true);
+        }
+        let new = if frame == zero {
+            ZERO_FILLS.fetch_add(1, Ordering::Relaxed);
+            alloc_zeroed()
+        } else {
+            COW_COPIES.fetch_add(1, Ordering::Relaxed);
+            alloc_copy(frame)
+        }.ok_or(KError::OutOfMemory)?;
+        if let Err(e) = mmu.install(page, new, prot, true) {
+            kbuddy::kmem_phys_free_frame(new);
+            return Err(e);
+        }
+        // Eski girdi install içinde her CPU'dan temizlendi
+        release_frame(frame);
+        Ok(())
+    }
+
+    // Haritalanmamış sayfayı bölgenin kaynağından kurar.
+    fn populate(page: u64, region: &Region, access: Access, mmu: &dyn FaultMmu) -> Result<(), KError> {
+        let index = page - region.start;
+        let (frame, prot) = match &region.backing {
+            Backing::Image { provider, file_offset, file_size } if index < *file_size => {
+                let offset = file_offset + index;
+                let valid = (file_size - index).min(PAGE_SIZE) as usize;
+                if valid < PAGE_SIZE as usize {
+                    // Dosya sonunun sıfır kuyruklu (bss başlangıcı) sayfası göreve özeldir
+                    (read_image_page(&**provider, offset, valid)?, region.prot)
+                } else {
+                    let shared = image_frame(provider, offset)?;
+                    if region.prot & PROT_WRITE == 0 {
+                        (shared, region.prot)
+                    } else if access == Access::Write {
+                        // İlk erişim zaten yazma: salt okunur eşleyip hemen kopyalamak yerine doğrudan kopyala
+                        COW_COPIES.fetch_add(1, Ordering::Relaxed);
+                        let copy = alloc_copy(shared);
+                        release_frame(shared);
+                        (copy.ok_or(KError::OutOfMemory)?, region.prot)
+                    } else {
+                        (shared, region.prot & !PROT_WRITE)
+                    }
+                }
+            }
+            // Sıfır bölgesi veya imajın dosya dışı kısmı
+            _ => {
+                if access == Access::Write {
+                    ZERO_FILLS.fetch_add(1, Ordering::Relaxed);
+                    (alloc_zeroed().ok_or(KError::OutOfMemory)?, region.prot)
+                } else {
+                    (zero_frame().ok_or(KError::OutOfMemory)?, region.prot & !PROT_WRITE)
+                }
+            }
+        };
+        if let Err(e) = mmu.install(page, frame, prot, false) {
+            release_frame(frame);
+            return Err(e);
+        }
+        Ok(())
+    }
+
+    // --- C Arayüzü (kernel_memory.h) ---
+
+    /// Adres alanına tembel sıfır dolu bir bölge ekler (bss, heap, yığıt).
+    #[no_mangle]
+    pub extern "C" fn kmem_virt_reserve_zero(address_space_id: u64, vaddr: u64, size: usize, flags: u32) -> i64 {
+        match add_region(address_space_id, vaddr, size as u64, flags, Backing::Zero) {
+            Ok(()) => 0,
+            Err(e) => e as i64,
+        }
+    }
+
+    /// Adres alanına kod kaynağından tembel doldurulan bir bölge ekler.
+    /// Aynı kod kaynağını eşleyen görevler tam dosya sayfalarını paylaşır; yazılabilir bölgeler COW'dur.
+    #[no_mangle]
+    pub extern "C" fn kmem_virt_map_image(address_space_id: u64, vaddr: u64, size: usize, code_handle: u64,
+                                          file_offset: u64, file_size: usize, flags: u32) -> i64 {
+        match map_image(address_space_id, vaddr, size as u64, code_handle, file_offset, file_size as u64, flags) {
+            Ok(()) => 0,
+            Err(e) => e as i64,
+        }
+    }
+}
@@ -2,6 +2,8 @@
 #![allow(dead_code)]
 #![allow(unused_variables)]
 
+use core::sync::atomic::{fence, AtomicU64, AtomicU8, Ordering};
+
 // --- Güç Yönetimi Standartları Enum'u ---
 #[derive(Debug, Copy, Clone, PartialEq, Eq)]
 pub enum BatteryStandard {
@@ -30,15 +32,174 @@ pub const SYSCALL_RESOURCE_ACQUIRE: u64 = 5;
 pub const SYSCALL_RESOURCE_RELEASE: u64 = 8;
 pub const SYSCALL_RESOURCE_READ: u64 = 6;
 pub const SYSCALL_RESOURCE_WRITE: u64 = 7;
+pub const SYSCALL_RESOURCE_CONTROL: u64 = 9;
+pub const SYSCALL_MESSAGE_RECEIVE: u64 = 29;
+pub const SYSCALL_RESOURCE_MAP: u64 = 46;
 
-// --- Kaynak Adı ---
+// --- Kaynak Adları ---
+// Önbellekli durum bloğu (çekirdek srcbatterystate.rs); yoksa eski komut tabanlı kaynak kullanılır.
+const RESOURCE_BATTERY_STATE: &[u8] = b"karnal://power/battery";
 const RESOURCE_BATTERY: &[u8] = b"karnal://battery";
 
+// karnal.h ile aynı değerler
+const RESOURCE_MODE_READ: u32 = 1 << 0;
+const MAP_READ: u64 = 1 << 0;
+const PAGE_SIZE: u64 = 4096;
+const BATTERY_CTL_SUBSCRIBE: u64 = 1;
+const BATTERY_CTL_UNSUBSCRIBE: u64 = 2;
+const ERROR_NOT_FOUND: i64 = -2;
+
+/// Çekirdeğin pil durumu bloğu (KarnalBatteryState_t)
+#[repr(C)]
+#[derive(Debug, Copy, Clone, Default)]
+pub struct BatteryState {
+    pub seq: u32,
+    pub status: u32,       // KARNAL_BATTERY_STATUS_*
+    pub charge_level: u32, // Yüzde
+    pub health: u32,       // Yüzde
+    pub updated_ns: u64,
+}
+
+/// Abonelik kanalına gelen olay (KarnalBatteryEvent_t)
+#[repr(C)]
+#[derive(Debug, Copy, Clone, Default)]
+pub struct BatteryEvent {
+    pub changed: u32, // KARNAL_BATTERY_CHANGED_* bitleri
+    pub status: u32,
+    pub charge_level: u32,
+    pub health: u32,
+    pub updated_ns: u64,
+}
+
+// Süreç başına tek handle ve haritalı blok: sorgular kaynağı her seferinde edinip bırakmaz.
+const STATE_UNOPENED: u8 = 0;
+const STATE_MAPPED: u8 = 1;   // Blok haritalı: sorgu sistem çağrısı yapmaz
+const STATE_READABLE: u8 = 2; // Haritalama yok: sorgu başına bir okuma
+const STATE_LEGACY: u8 = 3;   // Çekirdekte önbellekli blok yok: eski komut yolu
+static STATE: AtomicU8 = AtomicU8::new(STATE_UNOPENED);
+static STATE_HANDLE: AtomicU64 = AtomicU64::new(0);
+static STATE_BLOCK: AtomicU64 = AtomicU64::new(0);
+
 // --- BMS Pil Yöneticisi ---
 pub struct BmsBatteryManager;
 
 impl BmsBatteryManager {
+    /// Tek bir değeri sorgular. Yakıt göstergesi sürücüsü henüz yayın yapmadıysa (updated_ns == 0) blok
+    /// UNKNOWN/0 taşır; bu durumda eski komut yolu denenir, o da yoksa bloktaki değer döner.
     pub fn query(&self, query: BatteryQuery) -> Result<u32, BatteryError> {
+        if self.open()? == STATE_LEGACY {
+            return Self::query_legacy(query);
+        }
+        let state = self.state()?;
+        if state.updated_ns == 0 {
+            if let Ok(value) = Self::query_legacy(query) {
+                return Ok(value);
+            }
+        }
+        Ok(match query {
+            BatteryQuery::Status => state.status,
+            BatteryQuery::ChargeLevel => state.charge_level,
+            BatteryQuery::Health => state.health,
+        })
+    }
+
+    /// Durum bloğunun tutarlı bir kopyası. Blok haritalıysa sistem çağrısı yapılmaz.
+    pub fn state(&self) -> Result<BatteryState, BatteryError> {
+        match self.open()? {
+            STATE_MAPPED => Ok(Self::read_mapped(STATE_BLOCK.load(Ordering::Acquire) as *const BatteryState)),
+            STATE_READABLE => {
+                let mut state = BatteryState::default();
+                let size = core::mem::size_of::<BatteryState>();
+                match sys_resource_read(STATE_HANDLE.load(Ordering::Acquire), &mut state as *mut BatteryState as *mut u8, size) {
+                    Ok(n) if n == size => Ok(state),
+                    Ok(_) | Err(_) => Err(BatteryError::InternalError),
+                }
+            }
+            _ => Err(BatteryError::NotSupported),
+        }
+    }
+
+    /// `channel` mesaj kanalını değişiklik bildirimlerine abone eder. Olaylar `wait_for_change` ile alınır;
+    /// kuyruk dolarsa olay düşer, güncel değer her zaman `state` ile okunur.
+    pub fn subscribe(&self, channel: u64) -> Result<(), BatteryError> {
+        self.control(BATTERY_CTL_SUBSCRIBE, channel)
+    }
+
+    pub fn unsubscribe(&self, channel: u64) -> Result<(), BatteryError> {
+        self.control(BATTERY_CTL_UNSUBSCRIBE, channel)
+    }
+
+    /// `subscribe` ile kaydedilen `channel` kanalındaki sıradaki bildirimi bekler (yoklama yerine receive'de uyur).
+    pub fn wait_for_change(&self, channel: u64) -> Result<BatteryEvent, BatteryError> {
+        let mut event = BatteryEvent::default();
+        let size = core::mem::size_of::<BatteryEvent>();
+        let ret = sys_call4(SYSCALL_MESSAGE_RECEIVE, channel, &mut event as *mut BatteryEvent as u64, size as u64, 0);
+        if ret as usize == size { Ok(event) } else { Err(BatteryError::InternalError) }
+    }
+
+    fn control(&self, request: u64, arg: u64) -> Result<(), BatteryError> {
+        if self.open()? == STATE_LEGACY {
+            return Err(BatteryError::NotSupported);
+        }
+        match sys_call4(SYSCALL_RESOURCE_CONTROL, STATE_HANDLE.load(Ordering::Acquire), request, arg, 0) {
+            ret if ret < 0 => Err(BatteryError::InternalError),
+            _ => Ok(()),
+        }
+    }
+
+    // Bloğu ilk kullanımda bir kez edinir ve haritalamayı dener.
+    fn open(&self) -> Result<u8, BatteryError> {
+        let state = STATE.load(Ordering::Acquire);
+        if state != STATE_UNOPENED {
+            return Ok(state);
+        }
+        let id = RESOURCE_BATTERY_STATE;
+        let handle = sys_call4(SYSCALL_RESOURCE_ACQUIRE, id.as_ptr() as u64, id.len() as u64, RESOURCE_MODE_READ as u64, 0);
+        let opened = if handle == ERROR_NOT_FOUND {
+            STATE_LEGACY
+        } else if handle < 0 {
+            return Err(BatteryError::InternalError);
+        } else {
+            STATE_HANDLE.store(handle as u64, Ordering::Relaxed);
+            let block = sys_call4(SYSCALL_RESOURCE_MAP, handle as u64, 0, PAGE_SIZE, MAP_READ);
+            if block > 0 {
+                STATE_BLOCK.store(block as u64, Ordering::Relaxed);
+                STATE_MAPPED
+            } else {
+                STATE_READABLE
+            }
+        };
+        // Yarışı kaybeden kendi handle'ını bırakır (haritalaması süreç ömrü boyunca kalır)
+        match STATE.compare_exchange(STATE_UNOPENED, opened, Ordering::AcqRel, Ordering::Acquire) {
+            Ok(_) => Ok(opened),
+            Err(winner) => {
+                if handle >= 0 {
+                    let _ = sys_resource_release(handle as u64);
+                }
+                Ok(winner)
+            }
+        }
+    }
+
+    // Seqlock okuması: yazım sürerken (tek seq) veya okuma boyunca değiştiyse yeniden dener.
+    fn read_mapped(block: *const BatteryState) -> BatteryState {
+        loop {
+            let seq = unsafe { core::ptr::read_volatile(&(*block).seq) };
+            if seq & 1 != 0 {
+                core::hint::spin_loop();
+                continue;
+            }
+            fence(Ordering::Acquire);
+            let state = unsafe { core::ptr::read_volatile(block) };
+            fence(Ordering::Acquire);
+            if unsafe { core::ptr::read_volatile(&(*block).seq) } == seq {
+                return BatteryState { seq, ..state };
+            }
+        }
+    }
+
+    // Eski çekirdekler: komut yaz, u32 oku (her sorguda edin/bırak)
+    fn query_legacy(query: BatteryQuery) -> Result<u32, BatteryError> {
         let handle = sys_resource_acquire(RESOURCE_BATTERY, 0)?;
         let cmd = match query {
             BatteryQuery::Status => b"bms_status" as &[u8],
@@ -174,6 +335,25 @@ fn sys_resource_release(handle: u64) -> Result<(), BatteryError> {
     }
 }
 
+// Dört argümanlı genel çağrı (x86-64: rdi, rsi, rdx, r10; syscall rcx ve r11'i bozar). Ham sonucu döner.
+fn sys_call4(number: u64, arg1: u64, arg2: u64, arg3: u64, arg4: u64) -> i64 {
+    let ret: i64;
+    unsafe {
+        core::arch::asm!(
+            "syscall",
+            inlateout("rax") number as i64 => ret,
+            in("rdi") arg1,
+            in("rsi") arg2,
+            in("rdx") arg3,
+            in("r10") arg4,
+            out("rcx") _,
+            out("r11") _,
+            options(nostack)
+        );
+    }
+    ret
+}
+
 // --- Kullanım örneği ---
 pub fn get_battery_status() -> Result<u32, BatteryError> {
     let mgr = BmsBatteryManager;
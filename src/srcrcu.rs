@@ -0,0 +1,102 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::ksched;
+
+// --- RCU (Read-Copy-Update) ---
+// Okuyucular hiçbir kilit almaz ve paylaşılan bir önbellek satırına yazmaz: okuma bölümü yalnızca
+// kendi CPU'sunun sayacını artırır. Yazıcılar yeni veriyi yayınlar (Release), eski veriyi bağlantıdan
+// çıkarır ve `synchronize` ile o anda okuma bölümünde olan tüm CPU'ların bölümden çıkmasını bekledikten
+// sonra eski veriyi serbest bırakır.
+//
+// Okuma bölümü kesmeleri kapatır; bu yüzden iş parçacığı bölüm içinde CPU değiştiremez ve bloklanmamalıdır.
+// Bölümler iç içe olabilir. `synchronize` okuma bölümü içinden çağrılmamalıdır (kendi CPU'sunu bekler).
+
+pub mod krcu {
+    use super::*;
+    use core::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+
+    extern "C" {
+        fn low_level_cpu_id() -> u32;
+        fn low_level_interrupt_save() -> u64;
+        fn low_level_interrupt_restore(state: u64);
+    }
+
+    // CPU başına okuyucu durumu. Yalnızca sahibi CPU kesmeler kapalıyken yazar.
+    // seq tek ise CPU okuma bölümündedir. Her durum kendi önbellek satırındadır: komşu CPU'ların
+    // okuma bölümleri aynı satırı CPU'lar arasında gidip getirmez.
+    #[repr(C, align(64))]
+    struct ReaderState {
+        seq: AtomicU64,
+        depth: AtomicU32,
+        irq_state: AtomicU64,
+    }
+
+    impl ReaderState {
+        const INIT: ReaderState = ReaderState { seq: AtomicU64::new(0), depth: AtomicU32::new(0), irq_state: AtomicU64::new(0) };
+    }
+
+    static READERS: [ReaderState; ksched::MAX_CPUS] = [ReaderState::INIT; ksched::MAX_CPUS];
+
+    // İstatistikler: KARNAL_INFO_RCU_* ile dışarı verilir.
+    static GRACE_PERIODS: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_RCU_* ile EŞLEŞMELİDİR)
+    pub const INFO_RCU_GRACE_PERIODS: u32 = 0x600;
+
+    /// `kkernel::get_info` için: RCU istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_RCU_GRACE_PERIODS => Some(GRACE_PERIODS.load(Ordering::Relaxed)),
+            _ => None,
+        }
+    }
+
+    /// Okuma bölümü; düşürüldüğünde bölüm kapanır.
+    pub struct ReadGuard {
+        cpu: usize,
+    }
+
+    /// Okuma bölümüne girer. Bölüm süresince okunan RCU korumalı işaretçiler geçerli kalır.
+    pub fn read_lock() -> ReadGuard {
+        let irq_state = unsafe { low_level_interrupt_save() };
+        let cpu = unsafe { low_level_cpu_id() } as usize % ksched::MAX_CPUS;
+        let reader = &READERS[cpu];
+        if reader.depth.fetch_add(1, Ordering::Relaxed) == 0 {
+            reader.irq_state.store(irq_state, Ordering::Relaxed);
+            // SeqCst: sonraki işaretçi okumaları sayacın tek olduğu görülmeden önceye taşınamaz
+            reader.seq.fetch_add(1, Ordering::SeqCst);
+        } else {
+            unsafe { low_level_interrupt_restore(irq_state) }; // Dış bölüm kesmeleri zaten kapattı
+        }
+        ReadGuard { cpu }
+    }
+
+    impl Drop for ReadGuard {
+        fn drop(&mut self) {
+            let reader = &READERS[self.cpu];
+            if reader.depth.fetch_sub(1, Ordering::Relaxed) == 1 {
+                reader.seq.fetch_add(1, Ordering::SeqCst);
+                unsafe { low_level_interrupt_restore(reader.irq_state.load(Ordering::Relaxed)) };
+            }
+        }
+    }
+
+    /// Çağrı anında okuma bölümünde olan tüm CPU'lar bölümden çıkana kadar bekler (grace period).
+    /// Dönüşte, çağrıdan önce bağlantıdan çıkarılmış veriyi gören okuyucu kalmamıştır.
+    pub fn synchronize() {
+        // Yazıcının yayınlama/bağlantıdan çıkarma işlemleri sayaçlar okunmadan önce görünür olmalı
+        core::sync::atomic::fence(Ordering::SeqCst);
+        for reader in READERS.iter() {
+            let snapshot = reader.seq.load(Ordering::SeqCst);
+            if snapshot & 1 == 0 {
+                continue; // Bölüm dışında; sonraki bölümler yeni veriyi görür
+            }
+            while reader.seq.load(Ordering::SeqCst) == snapshot {
+                core::hint::spin_loop();
+            }
+        }
+        GRACE_PERIODS.fetch_add(1, Ordering::Relaxed);
+    }
+}
@@ -0,0 +1,225 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, KHandle, ResourceProvider, krcu};
+
+// --- Kaynak İsim Kaydı (karnal_resource_acquire için) ---
+// "karnal://device/console" gibi kaynak ID'lerini ResourceProvider'lara eşleyen açık adreslemeli karma
+// tablosu. İsmin 64 bit FNV-1a karması kayıt sırasında bir kez hesaplanıp girdide saklanır; arama kovayı
+// karmayla bulur ve isim yalnızca karma eşleştiğinde (normalde tek girdide) karşılaştırılır.
+//
+// Aramalar RCU okuma bölümünde yapılır ve kilit almaz. Kayıt/silme tek bir yazıcı kilidiyle sıralanır:
+// - Ekleme girdiyi boş veya silinmiş bir yuvaya tek bir atomik yazmayla yayınlar.
+// - Silme yuvayı mezar taşıyla değiştirir, grace period bekler ve girdiyi sonra serbest bırakır.
+// - Tablo dolduğunda yeni boyutta yeniden kurulur, atomik olarak değiştirilir; eski tablo grace period
+//   sonrasında serbest bırakılır. Girdiler iki tablo arasında paylaşılır, kopyalanmaz.
+// Bulunan provider Arc ile döner; provider kaydı silinse bile açık handle'lar onu ayakta tutar.
+
+pub mod kregistry {
+    use super::*;
+    use alloc::boxed::Box;
+    use alloc::sync::Arc;
+    use alloc::vec::Vec;
+    use core::sync::atomic::{AtomicPtr, AtomicU64, Ordering};
+    use spin::Mutex;
+
+    // İkinin kuvveti olmalı
+    const INITIAL_CAPACITY: usize = 64;
+    // Dolu + mezar taşı yuvalar kapasitenin 3/4'ünü aşarsa tablo yeniden kurulur
+    const LOAD_NUM: usize = 3;
+    const LOAD_DEN: usize = 4;
+
+    // Silinmiş yuva: arama devam eder, ekleme yeniden kullanabilir. Hiçbir zaman çözülmez.
+    const TOMBSTONE: usize = 1;
+
+    // Kayıt handle'ları: üst 16 bit 'KP' etiketi, alt bitler kayıt sıra numarası
+    const PROVIDER_HANDLE_TAG: u64 = 0x4B50 << 48;
+
+    struct Entry {
+        hash: u64,
+        name: Box<[u8]>,
+        provider: Arc<dyn ResourceProvider>,
+    }
+
+    struct Table {
+        mask: usize,
+        slots: Box<[AtomicPtr<Entry>]>,
+    }
+
+    impl Table {
+        fn new(capacity: usize) -> Box<Table> {
+            let mut slots = Vec::with_capacity(capacity);
+            slots.resize_with(capacity, || AtomicPtr::new(core::ptr::null_mut()));
+            Box::new(Table { mask: capacity - 1, slots: slots.into_boxed_slice() })
+        }
+    }
+
+    // Yalnızca yazıcı kilidi altında değişen sayımlar
+    struct Writer {
+        live: usize, // Kayıtlı provider
+        used: usize, // Kayıtlı + mezar taşı yuvalar
+        next_id: u64,
+    }
+
+    static TABLE: AtomicPtr<Table> = AtomicPtr::new(core::ptr::null_mut());
+    static WRITER: Mutex<Writer> = Mutex::new(Writer { live: 0, used: 0, next_id: 1 });
+
+    // İstatistikler: KARNAL_INFO_REGISTRY_* ile dışarı verilir.
+    static PROVIDERS: AtomicU64 = AtomicU64::new(0);
+    static REBUILDS: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_REGISTRY_* ile EŞLEŞMELİDİR)
+    pub const INFO_REGISTRY_PROVIDERS: u32 = 0x610;
+    pub const INFO_REGISTRY_REBUILDS: u32 = 0x611;
+
+    /// `kkernel::get_info` için: kayıt istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_REGISTRY_PROVIDERS => Some(PROVIDERS.load(Ordering::Relaxed)),
+            INFO_REGISTRY_REBUILDS => Some(REBUILDS.load(Ordering::Relaxed)),
+            _ => None,
+        }
+    }
+
+    /// Kaynak ID'sinin karması (64 bit FNV-1a). `const` olduğundan statik ID'ler için derleme anında
+    /// hesaplanıp `lookup_hashed` ile kullanılabilir.
+    pub const fn name_hash(name: &[u8]) -> u64 {
+        let mut hash: u64 = 0xcbf2_9ce4_8422_2325;
+        let mut i = 0;
+        while i < name.len() {
+            hash ^= name[i] as u64;
+            hash = hash.wrapping_mul(0x0000_0100_0000_01b3);
+            i += 1;
+        }
+        hash
+    }
+
+    // Tablodaki eşleşen yuvayı ve o an yüklenen girdiyi arar. Okuyucular RCU bölümünde, yazıcı kilit
+    // altında çağırır. Okuyucu yuvayı yeniden yüklememeli: arada silinirse mezar taşını görür.
+    fn find(table: &Table, hash: u64, name: &[u8]) -> Option<(usize, *mut Entry)> {
+        let mut index = hash as usize & table.mask;
+        for _ in 0..=table.mask {
+            let entry = table.slots[index].load(Ordering::Acquire);
+            if entry.is_null() {
+                return None;
+            }
+            if entry as usize != TOMBSTONE {
+                let found = unsafe { &*entry };
+                if found.hash == hash && &*found.name == name {
+                    return Some((index, entry));
+                }
+            }
+            index = (index + 1) & table.mask;
+        }
+        None
+    }
+
+    /// Karması önceden hesaplanmış ID ile provider'ı arar. Kilit almaz.
+    pub fn lookup_hashed(hash: u64, name: &[u8]) -> Result<Arc<dyn ResourceProvider>, KError> {
+        let _rcu = krcu::read_lock();
+        let table = TABLE.load(Ordering::Acquire);
+        if table.is_null() {
+            return Err(KError::NotFound);
+        }
+        let table = unsafe { &*table };
+        let (_, entry) = find(table, hash, name).ok_or(KError::NotFound)?;
+        // Girdi en az bu okuma bölümü boyunca serbest bırakılmaz
+        let entry = unsafe { &*entry };
+        Ok(entry.provider.clone())
+    }
+
+    /// Kaynak ID'si ile provider'ı arar. Kilit almaz.
+    pub fn lookup(name: &[u8]) -> Result<Arc<dyn ResourceProvider>, KError> {
+        lookup_hashed(name_hash(name), name)
+    }
+
+    // Kayıtlı girdileri `capacity` yuvalı yeni bir tabloya taşır ve eskisini grace period sonrası bırakır.
+    fn rebuild(writer: &mut Writer, capacity: usize) {
+        let new_table = Table::new(capacity);
+        let old = TABLE.load(Ordering::Relaxed);
+        if !old.is_null() {
+            for slot in unsafe { (*old).slots.iter() } {
+                let entry = slot.load(Ordering::Relaxed);
+                if entry.is_null() || entry as usize == TOMBSTONE {
+                    continue;
+                }
+                let mut index = unsafe { (*entry).hash } as usize & new_table.mask;
+                while !new_table.slots[index].load(Ordering::Relaxed).is_null() {
+                    index = (index + 1) & new_table.mask;
+                }
+                new_table.slots[index].store(entry, Ordering::Relaxed);
+            }
+        }
+        TABLE.store(Box::into_raw(new_table), Ordering::Release);
+        writer.used = writer.live;
+        if !old.is_null() {
+            krcu::synchronize();
+            drop(unsafe { Box::from_raw(old) }); // Yalnızca yuva dizisi; girdiler yeni tabloda
+            REBUILDS.fetch_add(1, Ordering::Relaxed);
+        }
+    }
+
+    /// `name` ID'si ile provider kaydeder. Aynı ID zaten kayıtlıysa AlreadyExists döner.
+    pub fn register(name: &[u8], provider: Arc<dyn ResourceProvider>) -> Result<KHandle, KError> {
+        if name.is_empty() {
+            return Err(KError::InvalidArgument);
+        }
+        let hash = name_hash(name);
+        let mut writer = WRITER.lock();
+
+        let table = TABLE.load(Ordering::Relaxed);
+        let capacity = if table.is_null() { 0 } else { unsafe { (*table).mask + 1 } };
+        if (writer.used + 1) * LOAD_DEN > capacity * LOAD_NUM {
+            // Mezar taşları çoğunluktaysa aynı boyutta temizlemek yeter
+            let grow = (writer.live + 1) * 2 > capacity;
+            let new_capacity = if capacity == 0 { INITIAL_CAPACITY } else if grow { capacity * 2 } else { capacity };
+            rebuild(&mut writer, new_capacity);
+        }
+        let table = unsafe { &*TABLE.load(Ordering::Relaxed) };
+        if find(table, hash, name).is_some() {
+            return Err(KError::AlreadyExists);
+        }
+
+        let mut index = hash as usize & table.mask;
+        loop {
+            let current = table.slots[index].load(Ordering::Relaxed);
+            if current.is_null() || current as usize == TOMBSTONE {
+                if current.is_null() {
+                    writer.used += 1;
+                }
+                break;
+            }
+            index = (index + 1) & table.mask;
+        }
+        let entry = Box::new(Entry { hash, name: name.into(), provider });
+        // Release: girdi alanları yuvayı gören okuyuculara görünür
+        table.slots[index].store(Box::into_raw(entry), Ordering::Release);
+
+        writer.live += 1;
+        PROVIDERS.fetch_add(1, Ordering::Relaxed);
+        let id = writer.next_id;
+        writer.next_id += 1;
+        Ok(KHandle(PROVIDER_HANDLE_TAG | (id & !(0xFFFF << 48))))
+    }
+
+    /// `name` kaydını siler. Devam eden aramalar bitene kadar bekler; dönüşte kayıt artık bulunamaz.
+    /// Provider'a önceden alınmış referanslar (açık handle'lar) geçerli kalır.
+    pub fn unregister(name: &[u8]) -> Result<(), KError> {
+        let hash = name_hash(name);
+        let mut writer = WRITER.lock();
+        let table = TABLE.load(Ordering::Relaxed);
+        if table.is_null() {
+            return Err(KError::NotFound);
+        }
+        let table = unsafe { &*table };
+        let (index, _) = find(table, hash, name).ok_or(KError::NotFound)?;
+        let entry = table.slots[index].swap(TOMBSTONE as *mut Entry, Ordering::AcqRel);
+        writer.live -= 1;
+        PROVIDERS.fetch_sub(1, Ordering::Relaxed);
+
+        krcu::synchronize();
+        drop(unsafe { Box::from_raw(entry) });
+        Ok(())
+    }
+}
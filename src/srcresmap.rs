@@ -0,0 +1,161 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, ResourceProvider, kresource, ksched};
+
+// --- Kaynakların Doğrudan Haritalanması (karnal_resource_map) ---
+// Çerçeve tamponu, GPU belleği veya ses tamponu gibi bellekte duran kaynaklar, verilerini read/write ile
+// kopyalamak yerine fiziksel frame'lerini çağıran görevin adres alanına verebilir. Provider her sayfa için
+// ResourceProvider::mmap_frame (C tarafında map_fn) ile frame'i döner; frame'ler görevin haritalama
+// penceresine hemen (tembel değil) haritalanır.
+//
+// Haritalanan frame'lerin sahibi provider'dır: pager bölgesi olmadıkları için adres alanı yıkımında ve
+// karnal_resource_unmap'te yalnızca yapraklar silinir, frame'ler iade edilmez. Provider frame'leri
+// haritalı kaldıkları sürece geçerli tutmalıdır. Sanal adresler yeniden kullanılmaz (heap ile aynı).
+//
+// Her haritalama provider'a bir referans tutar: handle kapansa veya kaynak kayıt defterinden çıksa da
+// provider (ve frame'leri) haritalama kaldırılana kadar yaşar. Referans, aralığın tamamını kapsayan
+// karnal_resource_unmap'te veya görevin son iş parçacığı çıkarken (release_task) bırakılır. Görev
+// sonlandığında sayfalar adres alanı yıkılana kadar kalabilir (ksched ertelenmiş yıkım); o adres alanında
+// artık çalışan iş parçacığı olmadığından frame'lere erişilmez.
+
+pub mod kresmap {
+    use super::*;
+    use alloc::sync::Arc;
+    use alloc::vec::Vec;
+    use core::sync::atomic::{AtomicU64, Ordering};
+    use spin::Mutex;
+
+    const PAGE_SIZE: u64 = 4096;
+
+    // Haritalama penceresi (heap penceresinin üstü, zaman sayfası ve halka pencerelerinin altı)
+    const USER_MAP_BASE: u64 = 0x0000_7000_0000_0000;
+    const USER_MAP_END: u64 = 0x0000_7E00_0000_0000;
+
+    // karnal.h'deki KARNAL_MAP_* bayrakları (kernel_memory.h KMEM_PAGE_* ile aynı bitler)
+    pub const MAP_READ: u32 = 1 << 0;
+    pub const MAP_WRITE: u32 = 1 << 1;
+    pub const MAP_NOCACHE: u32 = 1 << 4;
+    const KMEM_PAGE_USER: u32 = 1 << 3;
+
+    extern "C" {
+        fn kmem_virt_map_page(vaddr: u64, paddr: u64, flags: u32) -> i64;
+        fn kmem_virt_unmap_range(vaddr: u64, size: usize) -> i64;
+    }
+
+    const ZERO_U64: AtomicU64 = AtomicU64::new(0);
+    // Görev başına pencere imleci (0: henüz haritalama yok)
+    static MAP_NEXT: [AtomicU64; ksched::MAX_TASKS] = [ZERO_U64; ksched::MAX_TASKS];
+
+    struct Mapping {
+        start: u64,
+        end: u64,
+        _provider: Arc<dyn ResourceProvider>,
+    }
+
+    // Görev başına canlı haritalamalar; provider referansları kilit dışında bırakılır
+    static MAPPINGS: [Mutex<Vec<Mapping>>; ksched::MAX_TASKS] = [const { Mutex::new(Vec::new()) }; ksched::MAX_TASKS];
+
+    /// `handle` kaynağının `[offset, offset + len)` aralığını çalışan görevin adres alanına haritalar ve
+    /// kullanıcı adresini döner. `offset` sayfa hizalı olmalıdır; `len` sayfaya yuvarlanır.
+    /// Yazılabilir haritalama handle'ın yazma izni olmasını gerektirir.
+    pub fn map(handle: u64, offset: u64, len: u64, prot: u32) -> Result<u64, KError> {
+        if len == 0 || offset % PAGE_SIZE != 0 || prot & !(MAP_READ | MAP_WRITE | MAP_NOCACHE) != 0 {
+            return Err(KError::InvalidArgument);
+        }
+        let writable = prot & MAP_WRITE != 0;
+        let mode = if writable { kresource::MODE_READ | kresource::MODE_WRITE } else { kresource::MODE_READ };
+        let provider = kresource::get_handle(handle, mode)?.provider_arc();
+
+        let pages = len.checked_add(PAGE_SIZE - 1).ok_or(KError::InvalidArgument)? / PAGE_SIZE;
+        offset.checked_add(pages * PAGE_SIZE).ok_or(KError::InvalidArgument)?;
+        let task = ksched::current_task() as usize;
+        if task >= ksched::MAX_TASKS {
+            return Err(KError::InternalError);
+        }
+        let bytes = pages * PAGE_SIZE;
+        let mut start = 0;
+        MAP_NEXT[task]
+            .fetch_update(Ordering::Relaxed, Ordering::Relaxed, |next| {
+                start = if next == 0 { USER_MAP_BASE } else { next };
+                if bytes > USER_MAP_END - start { None } else { Some(start + bytes) }
+            })
+            .map_err(|_| KError::OutOfMemory)?;
+
+        // Yürütme izni verilmez; okuma her zaman açıktır
+        let flags = (prot | MAP_READ) | KMEM_PAGE_USER;
+        for page in 0..pages {
+            let mapped = provider.mmap_frame(offset + page * PAGE_SIZE, writable).and_then(|frame| {
+                if unsafe { kmem_virt_map_page(start + page * PAGE_SIZE, frame, flags) } != 0 {
+                    return Err(KError::OutOfMemory);
+                }
+                Ok(())
+            });
+            if let Err(err) = mapped {
+                if page > 0 {
+                    unsafe { kmem_virt_unmap_range(start, (page * PAGE_SIZE) as usize) };
+                }
+                return Err(err);
+            }
+        }
+        MAPPINGS[task].lock().push(Mapping { start, end: start + bytes, _provider: provider });
+        Ok(start)
+    }
+
+    /// map ile kurulmuş bir aralığı kaldırır. Frame'ler provider'da kalır.
+    pub fn unmap(addr: u64, len: u64) -> Result<(), KError> {
+        if len == 0 || addr % PAGE_SIZE != 0 || addr < USER_MAP_BASE {
+            return Err(KError::InvalidArgument);
+        }
+        let bytes = len.checked_add(PAGE_SIZE - 1).ok_or(KError::InvalidArgument)? & !(PAGE_SIZE - 1);
+        if bytes > USER_MAP_END - addr.min(USER_MAP_END) {
+            return Err(KError::InvalidArgument);
+        }
+        if unsafe { kmem_virt_unmap_range(addr, bytes as usize) } != 0 {
+            return Err(KError::BadAddress);
+        }
+        // Kısmen kaldırılan haritalamanın provider'ı görev sonuna kadar tutulur
+        let task = ksched::current_task() as usize;
+        if let Some(mappings) = MAPPINGS.get(task) {
+            let end = addr + bytes;
+            let released: Vec<Mapping> = {
+                let mut mappings = mappings.lock();
+                let (released, kept) = core::mem::take(&mut *mappings).into_iter()
+                    .partition(|m| m.start >= addr && m.end <= end);
+                *mappings = kept;
+                released
+            };
+            drop(released);
+        }
+        Ok(())
+    }
+
+    /// Görev sonlanırken pencere imlecini sıfırlar ve haritalamaların provider referanslarını bırakır
+    /// (sayfalar adres alanıyla birlikte gider).
+    pub fn release_task(task: u32) {
+        if (task as usize) < ksched::MAX_TASKS {
+            let released = core::mem::take(&mut *MAPPINGS[task as usize].lock());
+            drop(released);
+            MAP_NEXT[task as usize].store(0, Ordering::Relaxed);
+        }
+    }
+
+    // --- C API ---
+
+    #[no_mangle]
+    pub extern "C" fn karnal_resource_map(handle: u64, offset: u64, len: u64, prot: u32) -> i64 {
+        match map(handle, offset, len, prot) {
+            Ok(addr) => addr as i64,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_resource_unmap(addr: u64, len: u64) -> i64 {
+        match unmap(addr, len) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+}
@@ -0,0 +1,665 @@
+#![no_std]
+#![allow(dead_code)]
+#![allow(unused_variables)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{
+    KError,
+    KHandle,
+    KIoVec,
+    KThreadId,
+    resource_read_at,
+    resource_write_at,
+    resource_readv,
+    resource_writev,
+    resource_control,
+    ksched,     // Mevcut görev, SQPOLL yoklayıcısı ve bekleyenlerin bloklanması için
+    ktimer,     // Tamamlanma beklerken en yakın uyku kaydı için zamanlayıcı
+    kmessaging, // KARNAL_OP_MESSAGING_SEND için
+};
+
+// --- Asenkron Çağrı Halkası (Submission/Completion Ring) ---
+// karnal.h'deki KarnalSqe_t / KarnalCqe_t / KarnalRingHeader_t yapılarının çekirdek tarafı.
+// Halka bölgesi fiziksel frame'lerden oluşturulur ve iki kez haritalanır:
+// bir kez görevin kullanıcı alanına, bir kez de çekirdeğin erişebileceği bir pencereye.
+// Böylece çekirdek işlemleri kullanıcı belleğine kopyalama yapmadan okur/yazar.
+// Başlıktaki maske ve boyutlar kullanıcı tarafından yazılabilir; çekirdek yalnızca KRing'deki kopyalarını
+// kullanır ve kullanıcının yazdığı tail'i halka boyutuyla sınırlar.
+//
+// RINGS kilidi yalnızca halka sayaçları okunup yazılırken tutulur: SQE'ler kilit altında yerel bir diziye
+// kopyalanır, kilit bırakılıp dağıtılır (kaynak ve mesajlaşma çağrıları bloklanabilir) ve CQE'ler kilit
+// yeniden alınarak yazılır. enter(ENTER_GETEVENTS) halkanın bekleme listesinde bloklanır; post_cqe yeterli
+// girdi birikince bekleyeni uyandırır, bekleyen bir uyku kaydı varsa en yakın son tarihe zamanlayıcı kurulur.
+//
+// Her SQPOLL halkasını kurulumda halkanın görevinde oluşturulan bir yoklayıcı iş parçacığı boşaltır; SQE'lerdeki
+// handle'lar ve kullanıcı adresleri böylece halkayı kuran görevin tablosunda/adres alanında çözülür. Halka
+// uykuya (SQ_NEED_WAKEUP) geçince yoklayıcı bloklanır; enter(ENTER_SQ_WAKEUP) onu uyandırır. Halka yok
+// edilince yoklayıcı çıkar.
+
+pub mod kring {
+    use super::*;
+    use core::ptr;
+    use core::sync::atomic::{AtomicBool, AtomicU32, AtomicU64, Ordering};
+    use spin::Mutex;
+
+    // --- ABI Sabitleri (karnal.h ile EŞLEŞMELİDİR) ---
+    pub const OP_NOP: u8 = 0;
+    pub const OP_RESOURCE_READ: u8 = 1;
+    pub const OP_RESOURCE_WRITE: u8 = 2;
+    pub const OP_RESOURCE_READV: u8 = 3;
+    pub const OP_RESOURCE_WRITEV: u8 = 4;
+    pub const OP_RESOURCE_CONTROL: u8 = 5;
+    pub const OP_MESSAGING_SEND: u8 = 6;
+    pub const OP_TASK_SLEEP: u8 = 7;
+
+    pub const SETUP_SQPOLL: u32 = 1 << 0;
+    pub const SQ_NEED_WAKEUP: u32 = 1 << 0;
+    pub const ENTER_GETEVENTS: u32 = 1 << 0;
+    pub const ENTER_SQ_WAKEUP: u32 = 1 << 1;
+
+    pub const MAX_ENTRIES: u32 = 4096;
+
+    // kernel_memory.h'deki KMEM_PAGE_* bayrakları
+    const KMEM_PAGE_READ: u32 = 1 << 0;
+    const KMEM_PAGE_WRITE: u32 = 1 << 1;
+    const KMEM_PAGE_USER: u32 = 1 << 3;
+
+    const PAGE_SIZE: u64 = 4096; // KERNEL_PAGE_SIZE
+
+    // Aynı anda kurulabilecek en fazla halka sayısı
+    const MAX_RINGS: usize = 64;
+    // Bir halkanın kaplayabileceği en fazla frame sayısı (4096 SQE + 8192 CQE ~ 81 sayfa)
+    const MAX_RING_FRAMES: usize = 96;
+    // Halka başına aynı anda bekleyebilecek KARNAL_OP_TASK_SLEEP sayısı
+    const MAX_PENDING_TIMEOUTS: usize = 32;
+    // SQPOLL yoklayıcısının uykuya geçmeden önce boş geçireceği tur sayısı
+    const SQPOLL_IDLE_ROUNDS: u32 = 1024;
+    // Bir turda kilit altında kopyalanıp kilitsiz dağıtılan en fazla SQE sayısı
+    const SUBMIT_BATCH: usize = 32;
+    // Halka başına aynı anda tamamlanma bekleyebilecek iş parçacığı sayısı
+    const MAX_CQ_WAITERS: usize = 16;
+
+    // Halka pencereleri: her slot için sabit bir sanal aralık ayrılır.
+    const RING_REGION_STRIDE: u64 = MAX_RING_FRAMES as u64 * PAGE_SIZE;
+    const RING_USER_BASE: u64 = 0x0000_7F00_0000_0000;
+    const RING_KERNEL_BASE: u64 = 0xFFFF_FF80_0000_0000; // KERNEL_VIRTUAL_BASE + 0x80_0000_0000
+
+    // Başlıktan sonra SQE dizisinin başladığı ofset (önbellek satırı hizalı)
+    const SQE_OFFSET: u32 = 64;
+
+    // kernel_memory.h ve karnal.h'deki C arayüzü
+    extern "C" {
+        fn kmem_phys_alloc_frame() -> u64;
+        fn kmem_phys_free_frame(frame_addr: u64);
+        fn kmem_virt_map_page(vaddr: u64, paddr: u64, flags: u32) -> i64;
+        fn kmem_virt_unmap_page(vaddr: u64) -> i64;
+        fn karnal_timer_now_ns() -> u64;
+        fn low_level_interrupt_save() -> u64;
+        fn low_level_interrupt_restore(state: u64);
+    }
+
+    /// Gönderim halkası girdisi (KarnalSqe_t).
+    #[derive(Debug, Copy, Clone, Default)]
+    #[repr(C)]
+    pub struct KSqe {
+        pub opcode: u8,
+        pub flags: u8,
+        pub reserved0: u16,
+        pub reserved1: u32,
+        pub handle: u64,
+        pub addr: u64,
+        pub len: u64,
+        pub offset: u64,
+        pub user_data: u64,
+    }
+
+    /// Tamamlanma halkası girdisi (KarnalCqe_t).
+    #[derive(Debug, Copy, Clone)]
+    #[repr(C)]
+    pub struct KCqe {
+        pub user_data: u64,
+        pub result: i64,
+    }
+
+    /// Paylaşımlı halka başlığı (KarnalRingHeader_t).
+    /// Kullanıcı ile çekirdek arasında paylaşılan sayaçlar atomik olarak erişilir.
+    #[repr(C)]
+    pub struct KRingHeader {
+        pub sq_head: AtomicU32,
+        pub sq_tail: AtomicU32,
+        pub sq_mask: u32,
+        pub sq_entries: u32,
+        pub sq_flags: AtomicU32,
+        pub sqe_off: u32,
+        pub cq_head: AtomicU32,
+        pub cq_tail: AtomicU32,
+        pub cq_mask: u32,
+        pub cq_entries: u32,
+        pub cq_overflow: AtomicU32,
+        pub cqe_off: u32,
+    }
+
+    /// Süresi dolunca tamamlanacak bir KARNAL_OP_TASK_SLEEP kaydı.
+    #[derive(Debug, Copy, Clone)]
+    struct PendingTimeout {
+        deadline_ns: u64,
+        user_data: u64,
+    }
+
+    /// enter(ENTER_GETEVENTS) ile bloklanmış bir iş parçacığı.
+    #[derive(Debug, Copy, Clone)]
+    struct CqWaiter {
+        thread_slot: u32,
+        block_seq: u32,
+        min_complete: u32,
+    }
+
+    /// Çekirdek tarafındaki halka durumu.
+    struct KRing {
+        owner: u32, // Halkayı kuran görev (ksched::current_task)
+        flags: u32,
+        header: *mut KRingHeader, // Çekirdek penceresindeki başlık
+        sqes: *const KSqe,
+        cqes: *mut KCqe,
+        user_base: u64,
+        kernel_base: u64,
+        sq_entries: u32, // Başlıktaki değerlerin çekirdek kopyaları (kullanıcı başlığı değiştirebilir)
+        cq_entries: u32,
+        frames: [u64; MAX_RING_FRAMES],
+        frame_count: usize,
+        timeouts: [Option<PendingTimeout>; MAX_PENDING_TIMEOUTS],
+        waiters: [Option<CqWaiter>; MAX_CQ_WAITERS],
+        idle_rounds: u32,
+        seq: u64, // Kurulum sırası: yuva yeniden kullanılınca eski yoklayıcı kendini tanır ve çıkar
+    }
+
+    // Halka pointer'ları yalnızca RINGS kilidi altında kullanılır.
+    unsafe impl Send for KRing {}
+
+    static RINGS: Mutex<[Option<KRing>; MAX_RINGS]> = Mutex::new([const { None }; MAX_RINGS]);
+
+    // Yuva başına SQPOLL yoklayıcısı (KThreadId, 0: yok) ve bloklanmış olup olmadığı
+    const NO_POLLER: AtomicU64 = AtomicU64::new(0);
+    const NOT_PARKED: AtomicBool = AtomicBool::new(false);
+    static POLLERS: [AtomicU64; MAX_RINGS] = [NO_POLLER; MAX_RINGS];
+    static POLLER_PARKED: [AtomicBool; MAX_RINGS] = [NOT_PARKED; MAX_RINGS];
+    static NEXT_SEQ: AtomicU64 = AtomicU64::new(1);
+
+    pub fn init_manager() {
+        // Statik tablo derleme zamanında boş başlatılır.
+    }
+
+    // Son tarihler monoton saate göredir; gerçek zaman ayarlanınca kaymaz.
+    fn now_ns() -> u64 {
+        unsafe { karnal_timer_now_ns() }
+    }
+
+    /// Bölge boyutunu hesaplar: başlık + SQE dizisi + CQE dizisi, sayfa hizalı.
+    fn ring_layout(sq_entries: u32) -> (u32, usize) {
+        let cq_entries = sq_entries * 2;
+        let sqe_bytes = sq_entries as usize * core::mem::size_of::<KSqe>();
+        let cqe_off = SQE_OFFSET + sqe_bytes as u32;
+        let total = cqe_off as usize + cq_entries as usize * core::mem::size_of::<KCqe>();
+        let pages = (total + PAGE_SIZE as usize - 1) / PAGE_SIZE as usize;
+        (cqe_off, pages)
+    }
+
+    /// Mevcut görev için yeni bir halka kurar.
+    /// Başarı durumunda halka handle'ını ve kullanıcı alanındaki başlık adresini döner.
+    pub fn setup(entries: u32, flags: u32) -> Result<(KHandle, u64), KError> {
+        if entries == 0 || entries > MAX_ENTRIES {
+            return Err(KError::InvalidArgument);
+        }
+        if flags & !SETUP_SQPOLL != 0 {
+            return Err(KError::InvalidArgument);
+        }
+        let sq_entries = entries.next_power_of_two();
+        let (cqe_off, pages) = ring_layout(sq_entries);
+        if pages > MAX_RING_FRAMES {
+            return Err(KError::InvalidArgument);
+        }
+
+        let mut rings = RINGS.lock();
+        let slot = rings.iter().position(|r| r.is_none()).ok_or(KError::OutOfMemory)?;
+        let seq = NEXT_SEQ.fetch_add(1, Ordering::Relaxed);
+        let user_base = RING_USER_BASE + slot as u64 * RING_REGION_STRIDE;
+        let kernel_base = RING_KERNEL_BASE + slot as u64 * RING_REGION_STRIDE;
+
+        let mut frames = [0u64; MAX_RING_FRAMES];
+        for i in 0..pages {
+            let frame = unsafe { kmem_phys_alloc_frame() };
+            if frame == 0 {
+                unsafe { release_region(&frames[..i], user_base, kernel_base) };
+                return Err(KError::OutOfMemory);
+            }
+            frames[i] = frame;
+            let offset = i as u64 * PAGE_SIZE;
+            let mapped = unsafe {
+                kmem_virt_map_page(kernel_base + offset, frame, KMEM_PAGE_READ | KMEM_PAGE_WRITE) == 0
+                    && kmem_virt_map_page(user_base + offset, frame, KMEM_PAGE_READ | KMEM_PAGE_WRITE | KMEM_PAGE_USER) == 0
+            };
+            if !mapped {
+                unsafe { release_region(&frames[..=i], user_base, kernel_base) };
+                return Err(KError::OutOfMemory);
+            }
+        }
+
+        unsafe {
+            // Eski içeriğin kullanıcıya sızmaması için bölge sıfırlanır.
+            ptr::write_bytes(kernel_base as *mut u8, 0, pages * PAGE_SIZE as usize);
+            let header = kernel_base as *mut KRingHeader;
+            (*header).sq_mask = sq_entries - 1;
+            (*header).sq_entries = sq_entries;
+            (*header).sqe_off = SQE_OFFSET;
+            (*header).cq_mask = sq_entries * 2 - 1;
+            (*header).cq_entries = sq_entries * 2;
+            (*header).cqe_off = cqe_off;
+        }
+
+        rings[slot] = Some(KRing {
+            owner: ksched::current_task(),
+            flags,
+            header: kernel_base as *mut KRingHeader,
+            sqes: (kernel_base + SQE_OFFSET as u64) as *const KSqe,
+            cqes: (kernel_base + cqe_off as u64) as *mut KCqe,
+            user_base,
+            kernel_base,
+            sq_entries,
+            cq_entries: sq_entries * 2,
+            frames,
+            frame_count: pages,
+            timeouts: [None; MAX_PENDING_TIMEOUTS],
+            waiters: [None; MAX_CQ_WAITERS],
+            idle_rounds: 0,
+            seq,
+        });
+        drop(rings);
+
+        if flags & SETUP_SQPOLL != 0 {
+            // Yoklayıcı çağıranın görevinde oluşturulur (ksched::thread_create)
+            match ksched::thread_create(poller as usize as u64, 0, seq << 8 | slot as u64, 0) {
+                Ok(tid) => POLLERS[slot].store(tid.0, Ordering::Release),
+                Err(err) => {
+                    let _ = destroy(slot as u64 + 1);
+                    return Err(err);
+                }
+            }
+        }
+        Ok((KHandle(slot as u64 + 1), user_base))
+    }
+
+    fn wake_poller(slot: usize) {
+        if POLLER_PARKED[slot].swap(false, Ordering::AcqRel) {
+            let _ = ksched::wake(KThreadId(POLLERS[slot].load(Ordering::Acquire)));
+        }
+    }
+
+    // Halka hâlâ bu yoklayıcınınsa ve uyanıksa (SQ_NEED_WAKEUP kurulmamış) Some(true) döner.
+    fn ring_awake(slot: usize, seq: u64) -> Option<bool> {
+        let rings = RINGS.lock();
+        let ring = rings[slot].as_ref().filter(|ring| ring.seq == seq)?;
+        Some(ring.header().sq_flags.load(Ordering::SeqCst) & SQ_NEED_WAKEUP == 0)
+    }
+
+    // SQPOLL yoklayıcısı. `arg` = seq << 8 | yuva.
+    extern "C" fn poller(arg: u64) {
+        let slot = (arg & 0xFF) as usize;
+        let seq = arg >> 8;
+        if let Ok(tid) = ksched::current_thread() {
+            POLLERS[slot].store(tid.0, Ordering::Release); // thread_create dönmeden bloklanabilir
+        }
+        loop {
+            match poll_ring(slot, seq) {
+                None => break, // Halka yok edildi
+                Some(true) => continue,
+                Some(false) => {}
+            }
+            match ring_awake(slot, seq) {
+                None => break,
+                Some(true) => {
+                    // Boş tur: halka uykuya geçene kadar CPU diğer iş parçacıklarıyla paylaşılır
+                    let _ = ksched::yield_now();
+                    continue;
+                }
+                Some(false) => {}
+            }
+            // Halka uykuda. Bayrak kontrolden önce kurulur: araya giren wake_poller kaybolmaz.
+            let irq = unsafe { low_level_interrupt_save() };
+            ksched::prepare_block();
+            POLLER_PARKED[slot].store(true, Ordering::SeqCst);
+            if ring_awake(slot, seq) != Some(false) && POLLER_PARKED[slot].swap(false, Ordering::AcqRel) {
+                ksched::cancel_block();
+            } else {
+                ksched::block();
+            }
+            unsafe { low_level_interrupt_restore(irq) };
+        }
+        let _ = POLLERS[slot].compare_exchange(
+            ksched::current_thread().map(|tid| tid.0).unwrap_or(0),
+            0,
+            Ordering::AcqRel,
+            Ordering::Relaxed,
+        );
+    }
+
+    /// Haritalamaları kaldırır ve frame'leri iade eder.
+    unsafe fn release_region(frames: &[u64], user_base: u64, kernel_base: u64) {
+        for (i, &frame) in frames.iter().enumerate() {
+            let offset = i as u64 * PAGE_SIZE;
+            let _ = kmem_virt_unmap_page(user_base + offset);
+            let _ = kmem_virt_unmap_page(kernel_base + offset);
+            kmem_phys_free_frame(frame);
+        }
+    }
+
+    fn slot_of(handle_value: u64) -> Result<usize, KError> {
+        if handle_value == 0 || handle_value as usize > MAX_RINGS {
+            return Err(KError::BadHandle);
+        }
+        Ok(handle_value as usize - 1)
+    }
+
+    /// Halkayı yok eder. Yalnızca halkayı kuran görev çağırabilir.
+    pub fn destroy(handle_value: u64) -> Result<(), KError> {
+        let slot = slot_of(handle_value)?;
+        let mut rings = RINGS.lock();
+        let ring = rings[slot].as_mut().ok_or(KError::BadHandle)?;
+        if ring.owner != ksched::current_task() {
+            return Err(KError::PermissionDenied);
+        }
+        unsafe { release_region(&ring.frames[..ring.frame_count], ring.user_base, ring.kernel_base) };
+        ring.wake_waiters(true); // Halkayı bulamayınca BadHandle ile döner
+        let sqpoll = ring.flags & SETUP_SQPOLL != 0;
+        rings[slot] = None;
+        drop(rings);
+        if sqpoll {
+            wake_poller(slot); // Halkayı bulamayınca çıkar
+        }
+        Ok(())
+    }
+
+    /// Bekleyen SQE'leri işler ve isteğe bağlı olarak tamamlanmaları bekler.
+    pub fn enter(handle_value: u64, to_submit: u32, min_complete: u32, flags: u32) -> Result<u32, KError> {
+        let slot = slot_of(handle_value)?;
+        let (seq, sqpoll) = {
+            let mut rings = RINGS.lock();
+            let ring = rings[slot].as_mut().ok_or(KError::BadHandle)?;
+            if ring.owner != ksched::current_task() {
+                return Err(KError::PermissionDenied);
+            }
+            if ring.flags & SETUP_SQPOLL != 0 && flags & ENTER_SQ_WAKEUP != 0 {
+                ring.idle_rounds = 0;
+                ring.header().sq_flags.fetch_and(!SQ_NEED_WAKEUP, Ordering::SeqCst);
+            }
+            (ring.seq, ring.flags & SETUP_SQPOLL != 0)
+        };
+        // SQPOLL halkasında gönderimleri yoklayıcı işler; burada yalnızca uyandırma yapılır.
+        let submitted = if sqpoll { 0 } else { submit(slot, seq, to_submit)? };
+        if flags & ENTER_SQ_WAKEUP != 0 {
+            wake_poller(slot);
+        }
+
+        if flags & ENTER_GETEVENTS != 0 {
+            wait_completions(slot, seq, min_complete)?;
+        }
+
+        Ok(submitted)
+    }
+
+    /// En fazla `limit` SQE işler ve işlenen sayıyı döner. SQE'ler RINGS kilidi altında kopyalanır,
+    /// kilitsiz dağıtılır ve sonuçlar kilit yeniden alınarak yazılır. Halka bu arada yok edildiyse
+    /// (yuva başka bir halkanın olduysa) sonuçlar atılır.
+    fn submit(slot: usize, seq: u64, limit: u32) -> Result<u32, KError> {
+        let mut remaining = limit;
+        let mut count = 0;
+        let mut first = true;
+        while remaining > 0 {
+            let mut batch = [KSqe::default(); SUBMIT_BATCH];
+            let taken = {
+                let mut rings = RINGS.lock();
+                let ring = rings[slot].as_mut().filter(|ring| ring.seq == seq).ok_or(KError::BadHandle)?;
+                if first {
+                    // Kullanıcının tur sırasında eklediği girdiler bir sonraki çağrıya kalır.
+                    remaining = remaining.min(ring.sq_pending());
+                    first = false;
+                }
+                ring.take_sqes(&mut batch[..remaining.min(SUBMIT_BATCH as u32) as usize])
+            };
+            if taken == 0 {
+                break;
+            }
+            let mut results = [None; SUBMIT_BATCH];
+            for (sqe, result) in batch[..taken].iter().zip(results.iter_mut()) {
+                *result = dispatch(sqe);
+            }
+            count += taken as u32;
+            remaining -= taken as u32;
+
+            let mut rings = RINGS.lock();
+            let ring = match rings[slot].as_mut().filter(|ring| ring.seq == seq) {
+                Some(ring) => ring,
+                None => break,
+            };
+            for (sqe, result) in batch[..taken].iter().zip(results.iter()) {
+                match *result {
+                    Some(result) => ring.post_cqe(sqe.user_data, result),
+                    None => ring.add_timeout(sqe),
+                }
+            }
+        }
+        Ok(count)
+    }
+
+    /// Tek bir SQE'yi ilgili senkron Karnal64 çağrısına yönlendirir (RINGS kilidi tutulmadan).
+    /// Halka durumuna bağlı işlemler (uyku) için None döner; bunlar sonuç yazılırken kaydedilir.
+    fn dispatch(sqe: &KSqe) -> Option<i64> {
+        let result: Result<u64, KError> = match sqe.opcode {
+            OP_NOP => Ok(0),
+            OP_RESOURCE_READ => resource_read_at(sqe.handle, sqe.addr as *mut u8, sqe.len as usize, sqe.offset)
+                .map(|n| n as u64),
+            OP_RESOURCE_WRITE => resource_write_at(sqe.handle, sqe.addr as *const u8, sqe.len as usize, sqe.offset)
+                .map(|n| n as u64),
+            OP_RESOURCE_READV => resource_readv(sqe.handle, sqe.addr as *const KIoVec, sqe.len as usize)
+                .map(|n| n as u64),
+            OP_RESOURCE_WRITEV => resource_writev(sqe.handle, sqe.addr as *const KIoVec, sqe.len as usize)
+                .map(|n| n as u64),
+            OP_RESOURCE_CONTROL => resource_control(sqe.handle, sqe.addr, sqe.offset).map(|v| v as u64),
+            OP_MESSAGING_SEND => kmessaging::send(sqe.handle, sqe.addr as *const u8, sqe.len as usize)
+                .map(|_| 0),
+            OP_TASK_SLEEP => return None,
+            _ => Err(KError::InvalidArgument),
+        };
+        Some(match result {
+            Ok(value) => value as i64,
+            Err(err) => err as i64,
+        })
+    }
+
+    /// Tamamlanma halkasında en az `min_complete` girdi birikene kadar bekler. Çağıran halkanın bekleme
+    /// listesine eklenip bloklanır; post_cqe yeterli girdi yazınca uyandırır. Bekleyen uyku kaydı varsa
+    /// en yakın son tarihe zamanlayıcı kurulur ve süresi dolan kayıtlar uyanınca tamamlanır.
+    fn wait_completions(slot: usize, seq: u64, min_complete: u32) -> Result<(), KError> {
+        let thread_slot = ksched::current_slot().ok_or(KError::NotSupported)?;
+        loop {
+            // Kesmeler prepare_block'tan block dönene kadar kapalı tutulur.
+            let irq = unsafe { low_level_interrupt_save() };
+            let mut rings = RINGS.lock();
+            let ring = match rings[slot].as_mut().filter(|ring| ring.seq == seq) {
+                Some(ring) => ring,
+                None => {
+                    drop(rings);
+                    unsafe { low_level_interrupt_restore(irq) };
+                    return Err(KError::BadHandle);
+                }
+            };
+            // Zamanlayıcıyla uyandıysak kayıt hâlâ listededir.
+            for waiter in ring.waiters.iter_mut() {
+                if waiter.map_or(false, |w| w.thread_slot == thread_slot) {
+                    *waiter = None;
+                }
+            }
+            ring.expire_timeouts(now_ns());
+            let free = ring.waiters.iter().position(|w| w.is_none());
+            let index = match free {
+                Some(index) if ring.cq_ready() < min_complete => index,
+                _ => {
+                    let ready = ring.cq_ready() >= min_complete;
+                    drop(rings);
+                    unsafe { low_level_interrupt_restore(irq) };
+                    return if ready { Ok(()) } else { Err(KError::Busy) };
+                }
+            };
+            let block_seq = ksched::prepare_block();
+            let deadline = ring.next_deadline();
+            let timer = if deadline == ktimer::NO_DEADLINE {
+                None
+            } else {
+                // RINGS -> zamanlayıcı kuyruğu kilidi sırası; zamanlayıcı kesmesi RINGS'i almaz.
+                match ktimer::arm_wakeup(deadline, 0, thread_slot, block_seq) {
+                    Ok(timer) => Some(timer),
+                    Err(err) => {
+                        drop(rings);
+                        ksched::cancel_block();
+                        unsafe { low_level_interrupt_restore(irq) };
+                        return Err(err);
+                    }
+                }
+            };
+            ring.waiters[index] = Some(CqWaiter { thread_slot, block_seq, min_complete });
+            drop(rings);
+            ksched::block();
+            if let Some(timer) = timer {
+                ktimer::cancel(timer);
+            }
+            unsafe { low_level_interrupt_restore(irq) };
+        }
+    }
+
+    /// Bir SQPOLL halkasını bir tur yoklar (yoklayıcı iş parçacığı döngüsü). İş yapıldıysa Some(true),
+    /// halka yok edildiyse (veya yuva başka bir halkanınsa) None döner.
+    fn poll_ring(slot: usize, seq: u64) -> Option<bool> {
+        {
+            let mut rings = RINGS.lock();
+            let ring = rings[slot].as_mut().filter(|ring| ring.seq == seq)?;
+            ring.expire_timeouts(now_ns());
+            if ring.header().sq_flags.load(Ordering::Acquire) & SQ_NEED_WAKEUP != 0 {
+                return Some(false); // Uykuda; enter(ENTER_SQ_WAKEUP) ile uyandırılır
+            }
+        }
+        let submitted = submit(slot, seq, u32::MAX).ok()?;
+        let mut rings = RINGS.lock();
+        let ring = rings[slot].as_mut().filter(|ring| ring.seq == seq)?;
+        if submitted > 0 {
+            ring.idle_rounds = 0;
+            return Some(true);
+        }
+        ring.idle_rounds += 1;
+        if ring.idle_rounds >= SQPOLL_IDLE_ROUNDS {
+            let header = ring.header();
+            header.sq_flags.fetch_or(SQ_NEED_WAKEUP, Ordering::SeqCst);
+            // Bayrak kurulduktan sonra gelen gönderim kaçırılmasın diye tail yeniden okunur.
+            if header.sq_tail.load(Ordering::SeqCst) != header.sq_head.load(Ordering::Relaxed) {
+                header.sq_flags.fetch_and(!SQ_NEED_WAKEUP, Ordering::Release);
+                ring.idle_rounds = 0;
+            }
+        }
+        Some(false)
+    }
+
+    impl KRing {
+        /// Başlık, halka yok edilene kadar çekirdek penceresinde geçerlidir;
+        /// ömrü `self` ödüncünden bağımsız tutulur ki sayaçlar güncellenirken halka değiştirilebilsin.
+        fn header<'a>(&self) -> &'a KRingHeader {
+            unsafe { &*self.header }
+        }
+
+        /// Tamamlanma halkasında kullanıcının henüz toplamadığı girdi sayısı.
+        fn cq_ready(&self) -> u32 {
+            let header = self.header();
+            let ready = header.cq_tail.load(Ordering::Relaxed).wrapping_sub(header.cq_head.load(Ordering::Acquire));
+            ready.min(self.cq_entries)
+        }
+
+        /// Gönderim halkasında bekleyen girdi sayısı.
+        /// Kullanıcının yazdığı tail, head'den en fazla halka boyutu kadar ileride sayılır.
+        fn sq_pending(&self) -> u32 {
+            let header = self.header();
+            let head = header.sq_head.load(Ordering::Relaxed);
+            header.sq_tail.load(Ordering::Acquire).wrapping_sub(head).min(self.sq_entries)
+        }
+
+        /// En fazla `out.len()` SQE'yi yerel diziye kopyalar, head'i ilerletir ve kopyalanan sayıyı döner.
+        fn take_sqes(&mut self, out: &mut [KSqe]) -> usize {
+            let header = self.header();
+            let mask = self.sq_entries - 1;
+            let mut head = header.sq_head.load(Ordering::Relaxed);
+            let count = (self.sq_pending() as usize).min(out.len());
+            for sqe in out[..count].iter_mut() {
+                // Kullanıcı girdiyi değiştirebileceği için dağıtım yalnızca bu kopyayı kullanır.
+                *sqe = unsafe { ptr::read_volatile(self.sqes.add((head & mask) as usize)) };
+                head = head.wrapping_add(1);
+            }
+            header.sq_head.store(head, Ordering::Release);
+            count
+        }
+
+        /// Bir KARNAL_OP_TASK_SLEEP kaydı ekler (`offset` ms). Kayıt tablosu doluysa Busy ile tamamlanır.
+        fn add_timeout(&mut self, sqe: &KSqe) {
+            let deadline_ns = now_ns().saturating_add(sqe.offset.saturating_mul(1_000_000));
+            match self.timeouts.iter_mut().find(|t| t.is_none()) {
+                Some(entry) => {
+                    *entry = Some(PendingTimeout { deadline_ns, user_data: sqe.user_data });
+                    // Bekleyenler zamanlayıcılarını yeni son tarihe göre yeniden kurar.
+                    self.wake_waiters(true);
+                }
+                None => self.post_cqe(sqe.user_data, KError::Busy as i64),
+            }
+        }
+
+        /// En yakın uyku kaydının son tarihi; kayıt yoksa ktimer::NO_DEADLINE.
+        fn next_deadline(&self) -> u64 {
+            self.timeouts.iter().flatten().map(|t| t.deadline_ns).min().unwrap_or(ktimer::NO_DEADLINE)
+        }
+
+        /// Süresi dolan uyku kayıtlarını tamamlar.
+        fn expire_timeouts(&mut self, now: u64) {
+            for i in 0..MAX_PENDING_TIMEOUTS {
+                if let Some(t) = self.timeouts[i] {
+                    if t.deadline_ns <= now {
+                        self.timeouts[i] = None;
+                        self.post_cqe(t.user_data, 0);
+                    }
+                }
+            }
+        }
+
+        /// Yeterli tamamlanması biriken (`all` ise tüm) bekleyenleri listeden çıkarıp uyandırır.
+        fn wake_waiters(&mut self, all: bool) {
+            let ready = self.cq_ready();
+            for entry in self.waiters.iter_mut() {
+                if let Some(waiter) = *entry {
+                    if all || ready >= waiter.min_complete {
+                        *entry = None;
+                        ksched::wake_waiter(waiter.thread_slot, waiter.block_seq);
+                    }
+                }
+            }
+        }
+
+        /// Tamamlanma halkasına bir girdi yazar. Halka doluysa taşma sayacı artırılır.
+        fn post_cqe(&mut self, user_data: u64, result: i64) {
+            let header = self.header();
+            let tail = header.cq_tail.load(Ordering::Relaxed);
+            let head = header.cq_head.load(Ordering::Acquire);
+            if tail.wrapping_sub(head) >= self.cq_entries {
+                header.cq_overflow.fetch_add(1, Ordering::Relaxed);
+                return;
+            }
+            unsafe {
+                ptr::write_volatile(self.cqes.add((tail & (self.cq_entries - 1)) as usize), KCqe { user_data, result });
+            }
+            header.cq_tail.store(tail.wrapping_add(1), Ordering::Release);
+            self.wake_waiters(false);
+        }
+    }
+}
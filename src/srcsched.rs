@@ -0,0 +1,1023 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, KThreadId, kdvfs, khandle, kmessaging, kpager, kresmap, kslab, ktier, ktimepage, ktimer, ktrace};
+
+// --- CPU Başına Çalışma Kuyrukları ve İş Çalma (Work Stealing) Zamanlayıcısı ---
+// Her CPU'nun kendi çalışma kuyruğu ve kilidi vardır; global bir zamanlayıcı kilidi yoktur.
+// - yield/preempt: çalışan iş parçacığı kendi CPU'sunun kuyruğunun sonuna eklenir (round-robin).
+// - Uyandırma/oluşturma: iş parçacığı en son çalıştığı CPU'ya (önbellek sıcaklığı) konur. Kuyrukta iş
+//   bekliyorsa boştaki uygun bir CPU'ya reschedule IPI gönderilir; o CPU işi kendisi çeker.
+// - Kuyruğu boşalan CPU diğer CPU'ların kuyruklarının yarısını çalar. Çalma sırasında yalnızca kurban
+//   kuyruğunun kilidi tutulur, iki kuyruk kilidi asla birlikte alınmaz.
+// İlgi maskesi (affinity) bir ipucudur: maskede açık CPU yoksa tüm CPU'lar kullanılır. Maske sağlanabildiği
+// sürece çalma da dahil hiçbir yol iş parçacığını maske dışındaki bir CPU'ya taşımaz.
+//
+// Kuyruk kilitleri kesme bağlamında da alınır (uyandırma), bu yüzden kesmeler kapalıyken tutulur.
+// Bağlam değiştirme sırasında önceki iş parçacığının yığıtı `on_cpu` bayrağı temizlenene kadar kullanımdadır;
+// başka bir CPU onu bu arada kuyruktan alırsa bayrak inene kadar bekler.
+// Periyodik tik yoktur: uykular ve zaman dilimi sonu tiksiz zamanlayıcıya (srctimer.rs) kurulur;
+// boşta iş parçacığı çalışırken zaman dilimi kurulmaz.
+//
+// FPU/SIMD durumu tembel yönetilir: geçişte FPU kapalı bırakılır ve durum yalnızca zaman diliminde FPU'yu
+// açmış (`fpu_active`) iş parçacığı için kaydedilir; yalnızca tamsayı kullanan iş parçacıkları hiç
+// kaydetme/yükleme yapmaz. İlk FPU komutu ksched_fpu_trap'e düşer; iş parçacığının son durumu hâlâ bu
+// CPU'nun yazmaçlarındaysa (kimse üzerine yüklemediyse) yükleme de atlanır. Durum geçişte kaydedildiği için
+// iş parçacığı başka bir CPU'ya taşınabilir; başka CPU'dan kaydetme istenmez.
+//
+// Kullanıcı görevlerinin adres alanı geçişte yüklenir; çekirdek görevinin iş parçacıkları CPU'da yüklü olanı
+// kullanır (çekirdek yarısı her adres alanında aynıdır). Bu yüzden görevi biten bir adres alanı bir CPU'da
+// yüklü kalabilir: yıkım, o CPU başka bir kullanıcı görevine geçene kadar ertelenir (DEAD_ROOTS).
+
+pub mod ksched {
+    use super::*;
+    use core::sync::atomic::{AtomicBool, AtomicU32, AtomicU64, Ordering};
+    use spin::Mutex;
+
+    /// Zamanlayıcının yönettiği en fazla CPU sayısı (CPU maskesi bit genişliği)
+    pub const MAX_CPUS: usize = 32;
+    /// Aynı anda var olabilecek en fazla iş parçacığı (CPU başına boşta iş parçacıkları dahil)
+    pub const MAX_THREADS: usize = 1024;
+    /// Herhangi bir CPU'da çalışabilir (karnal.h'deki KARNAL_CPU_ANY)
+    pub const CPU_ANY: u64 = u64::MAX;
+    /// Görev (adres alanı) tablosu boyutu; 0 çekirdek görevidir
+    pub const MAX_TASKS: usize = 64;
+
+    // Zaman dilimi: bu süre dolduğunda kuyrukta bekleyen varsa çalışan iş parçacığı kesilir.
+    const TIME_SLICE_NS: u64 = 10_000_000;
+    // stack_size 0 verilirse kullanılan yığıt boyutu ve izin verilen en büyük yığıt (2^8 sayfa = 1MB)
+    const DEFAULT_STACK_SIZE: usize = 16 * 1024;
+    const MAX_STACK_ORDER: u32 = 8;
+    const PAGE_SIZE: usize = 4096;
+    // Tek bir çalma işleminde alınan en fazla iş parçacığı
+    const STEAL_BATCH: usize = 16;
+
+    const NO_THREAD: u32 = u32::MAX;
+    const NO_CPU: u32 = u32::MAX;
+
+    // İş parçacığı durumları
+    const FREE: u32 = 0;
+    const RESERVED: u32 = 1; // Oluşturuluyor
+    const READY: u32 = 2;
+    const RUNNING: u32 = 3;
+    const BLOCKED: u32 = 4;
+    const EXITED: u32 = 5;
+
+    extern "C" {
+        fn low_level_cpu_id() -> u32;
+        fn low_level_interrupt_save() -> u64;
+        fn low_level_interrupt_restore(state: u64);
+        fn low_level_interrupt_enable();
+        fn low_level_cpu_idle_wait();
+        fn low_level_thread_stack_init(stack_top: u64, entry: u64, arg: u64) -> u64;
+        fn low_level_context_switch(prev_sp: *mut u64, next_sp: u64);
+        fn low_level_send_reschedule_ipi(cpu: u32);
+        fn low_level_set_kernel_stack(stack_top: u64);
+        fn kmem_phys_alloc_frames(order: u32) -> u64;
+        fn kmem_virt_activate_address_space(address_space_id: u64);
+        fn kmem_virt_destroy_address_space(address_space_id: u64);
+        fn kmem_phys_free_frames(frame_addr: u64, order: u32);
+        fn low_level_fpu_cpu_init() -> u64;
+        fn low_level_fpu_enable();
+        fn low_level_fpu_disable();
+        fn low_level_fpu_area_init(area: u64);
+        fn low_level_fpu_save(area: u64);
+        fn low_level_fpu_restore(area: u64);
+    }
+
+    // --- İş Parçacığı Tablosu ---
+
+    struct Thread {
+        state: AtomicU32,
+        generation: AtomicU32,  // Yuva yeniden kullanılınca artar; eski KThreadId'ler geçersizleşir
+        affinity: AtomicU64,
+        last_cpu: AtomicU32,
+        on_cpu: AtomicBool,     // Bağlamı henüz kaydedilmedi (yığıt bir CPU'da kullanımda)
+        saved_sp: AtomicU64,    // low_level_context_switch'in kaydettiği yığıt işaretçisi
+        block_seq: AtomicU32,   // Her bloklanmada artar; eski uyku kayıtlarının uyandırmasını ayıklar
+        entry: AtomicU64,
+        arg: AtomicU64,
+        stack_base: AtomicU64,  // 0: yığıtı zamanlayıcıya ait değil (CPU'nun önyükleme yığıtı)
+        stack_order: AtomicU32,
+        task: AtomicU32,        // Ait olduğu görev (handle tablosu vb. görev başına durum için)
+        fpu_area: AtomicU64,    // FPU/SIMD durum alanı; 0: iş parçacığı henüz FPU kullanmadı
+        fpu_active: AtomicBool, // Bu zaman diliminde FPU açıldı; durum yazmaçlarda, geçişte kaydedilir
+        fpu_cpu: AtomicU32,     // Yazmaçlarında bu iş parçacığının son durumu bulunabilecek CPU
+    }
+
+    impl Thread {
+        const INIT: Thread = Thread {
+            state: AtomicU32::new(FREE),
+            generation: AtomicU32::new(0),
+            affinity: AtomicU64::new(CPU_ANY),
+            last_cpu: AtomicU32::new(0),
+            on_cpu: AtomicBool::new(false),
+            saved_sp: AtomicU64::new(0),
+            block_seq: AtomicU32::new(0),
+            entry: AtomicU64::new(0),
+            arg: AtomicU64::new(0),
+            stack_base: AtomicU64::new(0),
+            stack_order: AtomicU32::new(0),
+            task: AtomicU32::new(0),
+            fpu_area: AtomicU64::new(0),
+            fpu_active: AtomicBool::new(false),
+            fpu_cpu: AtomicU32::new(NO_CPU),
+        };
+    }
+
+    static THREADS: [Thread; MAX_THREADS] = [Thread::INIT; MAX_THREADS];
+    // Görev başına var olan iş parçacığı sayısı; son iş parçacığı çıkınca görev başına durum bırakılır.
+    static TASK_THREADS: [AtomicU32; MAX_TASKS] = [const { AtomicU32::new(0) }; MAX_TASKS];
+    // Görev başına adres alanı kökü; 0: çekirdek görevi veya boş yuva. Sıfırdan farklı kök yuvayı ayırır.
+    static TASK_ROOTS: [AtomicU64; MAX_TASKS] = [const { AtomicU64::new(0) }; MAX_TASKS];
+    // Görevi çekirdek bağlamı açtı (init); yuva her task_create'te yeniden yazılır. Çekirdek görevi (0) hep ayrıcalıklıdır.
+    static TASK_PRIVILEGED: [AtomicBool; MAX_TASKS] = [const { AtomicBool::new(false) }; MAX_TASKS];
+    // Görevi bitmiş, yıkımı bekleyen adres alanları (0: boş). Her CPU'da en fazla biri yüklü kalır.
+    static DEAD_ROOTS: Mutex<[u64; MAX_TASKS]> = Mutex::new([0; MAX_TASKS]);
+    // Boş yuva aramasının başlangıç noktası (yalnızca ipucu)
+    static NEXT_SLOT: AtomicU32 = AtomicU32::new(0);
+
+    // KThreadId = (nesil << 32) | (yuva + 1); 0 hiçbir iş parçacığına karşılık gelmez.
+    fn thread_id(slot: u32) -> KThreadId {
+        let generation = THREADS[slot as usize].generation.load(Ordering::Relaxed) as u64;
+        KThreadId((generation << 32) | (slot as u64 + 1))
+    }
+
+    fn resolve(tid: KThreadId) -> Result<u32, KError> {
+        let low = (tid.0 & 0xFFFF_FFFF) as usize;
+        if low == 0 || low > MAX_THREADS {
+            return Err(KError::BadHandle);
+        }
+        let slot = low - 1;
+        let thread = &THREADS[slot];
+        if thread.generation.load(Ordering::Acquire) as u64 != tid.0 >> 32
+            || thread.state.load(Ordering::Acquire) == FREE
+        {
+            return Err(KError::NotFound);
+        }
+        Ok(slot as u32)
+    }
+
+    fn alloc_slot() -> Option<u32> {
+        let start = NEXT_SLOT.fetch_add(1, Ordering::Relaxed) as usize;
+        for i in 0..MAX_THREADS {
+            let slot = (start + i) % MAX_THREADS;
+            if THREADS[slot]
+                .state
+                .compare_exchange(FREE, RESERVED, Ordering::Acquire, Ordering::Relaxed)
+                .is_ok()
+            {
+                return Some(slot as u32);
+            }
+        }
+        None
+    }
+
+    // İş parçacığı görevinden ayrılır. Görevin son iş parçacığıysa görev başına durum (handle tablosu,
+    // dilim kümesi, haritalama kayıtları) bırakılır; görev yuvası yeniden kullanılabilir.
+    // Çıkan iş parçacığının kendi bağlamında çağrılır: handle kapatma provider'ı düşürebilir, bu yüzden
+    // zamanlayıcı kilitleri altında çalışan reap'e bırakılmaz.
+    fn leave_task(task: u32) {
+        if TASK_THREADS[task as usize].fetch_sub(1, Ordering::AcqRel) != 1 || task == 0 {
+            return;
+        }
+        // Görevin uç noktaları kapanır: başka görevlerde bekleyen istemciler BadHandle ile döner
+        kmessaging::release_task(task);
+        khandle::release_task(task);
+        kresmap::release_task(task);
+        ktimepage::release_task(task);
+        kslab::release_task(task);
+        ktier::release_task(task);
+        // Kapanan handle'lar bir kod kaynağının son referansı olabilir
+        kpager::release_dead_images();
+        // Adres alanı bu CPU'da hâlâ yüklü; yuva kök bırakıldıktan sonra yeniden verilebilir
+        let root = TASK_ROOTS[task as usize].load(Ordering::Relaxed);
+        if root != 0 {
+            retire_address_space(root);
+            TASK_ROOTS[task as usize].store(0, Ordering::Release);
+        }
+    }
+
+    fn retire_address_space(root: u64) {
+        {
+            let mut dead = DEAD_ROOTS.lock();
+            // Yüklü kalan kökler CPU sayısıyla sınırlı olduğundan tablo dolmaz
+            if let Some(free) = dead.iter_mut().find(|r| **r == 0) {
+                *free = root;
+            }
+        }
+        reclaim_address_spaces();
+    }
+
+    /// Görevi bitmiş ve hiçbir CPU'da yüklü olmayan adres alanlarını yıkar. Görevin son iş parçacığı
+    /// çıkarken ve yeni görev açılırken çağrılır.
+    pub fn reclaim_address_spaces() {
+        loop {
+            let root = {
+                let mut dead = DEAD_ROOTS.lock();
+                let loaded = |root: u64| CPUS.iter().any(|cpu| cpu.root.load(Ordering::Acquire) == root);
+                match dead.iter_mut().find(|r| **r != 0 && !loaded(**r)) {
+                    Some(slot) => core::mem::replace(slot, 0),
+                    None => return,
+                }
+            };
+            // Yıkım bölgelerin kaynak referanslarını düşürür; kilit dışında yapılır
+            unsafe { kmem_virt_destroy_address_space(root) };
+        }
+    }
+
+    // Çıkmış bir iş parçacığının yığıtını ve yuvasını iade eder. Yığıtı artık hiçbir CPU'da kullanımda değildir.
+    fn reap(slot: u32) {
+        let thread = &THREADS[slot as usize];
+        let base = thread.stack_base.swap(0, Ordering::Relaxed);
+        if base != 0 {
+            unsafe { kmem_phys_free_frames(base, thread.stack_order.load(Ordering::Relaxed)) };
+        }
+        let fpu_area = thread.fpu_area.swap(0, Ordering::Relaxed);
+        if fpu_area != 0 {
+            unsafe { kmem_phys_free_frames(fpu_area, fpu_area_order()) };
+        }
+        // CPU'ların fpu_owner'ı bu yuvayı gösterebilir; yeni iş parçacığı ilk kullanımda mutlaka yükler
+        thread.fpu_cpu.store(NO_CPU, Ordering::Relaxed);
+        thread.generation.fetch_add(1, Ordering::Relaxed);
+        thread.state.store(FREE, Ordering::Release);
+    }
+
+    // --- CPU Başına Çalışma Kuyrukları ---
+
+    // Kapasite MAX_THREADS: bir iş parçacığı aynı anda en fazla bir kuyrukta olduğundan ekleme asla taşmaz.
+    struct Ring {
+        slots: [u32; MAX_THREADS],
+        head: usize,
+        count: usize,
+    }
+
+    impl Ring {
+        fn push(&mut self, slot: u32) {
+            debug_assert!(self.count < MAX_THREADS);
+            self.slots[(self.head + self.count) % MAX_THREADS] = slot;
+            self.count += 1;
+        }
+
+        fn pop(&mut self) -> Option<u32> {
+            if self.count == 0 {
+                return None;
+            }
+            let slot = self.slots[self.head];
+            self.head = (self.head + 1) % MAX_THREADS;
+            self.count -= 1;
+            Some(slot)
+        }
+    }
+
+    struct RunQueue {
+        ring: Mutex<Ring>,
+        len: AtomicU32, // Kilitsiz okunan yaklaşık uzunluk (yer seçimi ve kurban seçimi için)
+    }
+
+    impl RunQueue {
+        const INIT: RunQueue = RunQueue {
+            ring: Mutex::new(Ring { slots: [0; MAX_THREADS], head: 0, count: 0 }),
+            len: AtomicU32::new(0),
+        };
+
+        fn push(&self, slot: u32) {
+            let mut ring = self.ring.lock();
+            ring.push(slot);
+            self.len.store(ring.count as u32, Ordering::Relaxed);
+        }
+
+        fn pop(&self) -> Option<u32> {
+            if self.len.load(Ordering::Relaxed) == 0 {
+                return None;
+            }
+            let mut ring = self.ring.lock();
+            let slot = ring.pop();
+            self.len.store(ring.count as u32, Ordering::Relaxed);
+            slot
+        }
+
+        fn len(&self) -> u32 {
+            self.len.load(Ordering::Relaxed)
+        }
+    }
+
+    struct Cpu {
+        current: AtomicU32,      // Bu CPU'da çalışan iş parçacığı
+        idle: AtomicU32,         // Bu CPU'nun boşta iş parçacığı (karnal_scheduler_start'ı çağıran bağlam)
+        prev: AtomicU32,         // Bağlam değiştirme sonrası `on_cpu`'su indirilecek iş parçacığı
+        need_resched: AtomicBool,
+        fpu_owner: AtomicU32,    // FPU yazmaçlarına durumunu en son yükleyen iş parçacığı
+        root: AtomicU64,         // Yüklü kullanıcı adres alanı (0: önyükleme adres alanı)
+    }
+
+    impl Cpu {
+        const INIT: Cpu = Cpu {
+            current: AtomicU32::new(NO_THREAD),
+            idle: AtomicU32::new(NO_THREAD),
+            prev: AtomicU32::new(NO_THREAD),
+            need_resched: AtomicBool::new(false),
+            fpu_owner: AtomicU32::new(NO_THREAD),
+            root: AtomicU64::new(0),
+        };
+    }
+
+    static RUN_QUEUES: [RunQueue; MAX_CPUS] = [RunQueue::INIT; MAX_CPUS];
+    static CPUS: [Cpu; MAX_CPUS] = [Cpu::INIT; MAX_CPUS];
+    // Zamanlayıcıya katılmış CPU'lar ve şu anda boşta bekleyenler (bit n = CPU n)
+    static ONLINE: AtomicU64 = AtomicU64::new(0);
+    static IDLE: AtomicU64 = AtomicU64::new(0);
+
+    // İstatistikler: KARNAL_INFO_SCHED_* ile dışarı verilir.
+    static CONTEXT_SWITCHES: AtomicU64 = AtomicU64::new(0);
+    static STOLEN_THREADS: AtomicU64 = AtomicU64::new(0);
+    static DIRECT_HANDOFFS: AtomicU64 = AtomicU64::new(0);
+    static RESCHEDULE_IPIS: AtomicU64 = AtomicU64::new(0);
+    static FPU_TRAPS: AtomicU64 = AtomicU64::new(0);
+    static FPU_SAVES: AtomicU64 = AtomicU64::new(0);
+    static FPU_RESTORES_SKIPPED: AtomicU64 = AtomicU64::new(0);
+
+    // İş parçacığı başına FPU durum alanı boyutu (low_level_fpu_cpu_init); 0: tembel FPU yok
+    static FPU_AREA_SIZE: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_SCHED_* ile EŞLEŞMELİDİR)
+    pub const INFO_SCHED_CONTEXT_SWITCHES: u32 = 0x400;
+    pub const INFO_SCHED_STOLEN_THREADS: u32 = 0x401;
+    pub const INFO_SCHED_RESCHEDULE_IPIS: u32 = 0x402;
+    pub const INFO_SCHED_DIRECT_HANDOFFS: u32 = 0x403;
+    pub const INFO_SCHED_FPU_TRAPS: u32 = 0x404;
+    pub const INFO_SCHED_FPU_SAVES: u32 = 0x405;
+    pub const INFO_SCHED_FPU_RESTORES_SKIPPED: u32 = 0x406;
+
+    /// `kkernel::get_info` için: zamanlayıcı istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_SCHED_CONTEXT_SWITCHES => Some(CONTEXT_SWITCHES.load(Ordering::Relaxed)),
+            INFO_SCHED_STOLEN_THREADS => Some(STOLEN_THREADS.load(Ordering::Relaxed)),
+            INFO_SCHED_RESCHEDULE_IPIS => Some(RESCHEDULE_IPIS.load(Ordering::Relaxed)),
+            INFO_SCHED_DIRECT_HANDOFFS => Some(DIRECT_HANDOFFS.load(Ordering::Relaxed)),
+            INFO_SCHED_FPU_TRAPS => Some(FPU_TRAPS.load(Ordering::Relaxed)),
+            INFO_SCHED_FPU_SAVES => Some(FPU_SAVES.load(Ordering::Relaxed)),
+            INFO_SCHED_FPU_RESTORES_SKIPPED => Some(FPU_RESTORES_SKIPPED.load(Ordering::Relaxed)),
+            _ => None,
+        }
+    }
+
+    fn current_cpu() -> usize {
+        (unsafe { low_level_cpu_id() } as usize).min(MAX_CPUS - 1)
+    }
+
+    fn fpu_area_order() -> u32 {
+        let pages = (FPU_AREA_SIZE.load(Ordering::Relaxed) as usize + PAGE_SIZE - 1) / PAGE_SIZE;
+        pages.next_power_of_two().trailing_zeros()
+    }
+
+    // Maskeyi açık CPU'larla keser; sonuç boşsa ipucu yok sayılır.
+    fn allowed_cpus(affinity: u64) -> u64 {
+        let online = ONLINE.load(Ordering::Acquire);
+        let allowed = affinity & online;
+        if allowed != 0 { allowed } else { online }
+    }
+
+    fn kick(cpu: usize) {
+        RESCHEDULE_IPIS.fetch_add(1, Ordering::Relaxed);
+        CPUS[cpu].need_resched.store(true, Ordering::Release);
+        unsafe { low_level_send_reschedule_ipi(cpu as u32) };
+    }
+
+    // Hazır bir iş parçacığını bir CPU kuyruğuna koyar. Kesmeler kapalı çağrılmalıdır.
+    fn enqueue(slot: u32) {
+        let thread = &THREADS[slot as usize];
+        let allowed = allowed_cpus(thread.affinity.load(Ordering::Relaxed));
+        let this_cpu = current_cpu();
+        let last = thread.last_cpu.load(Ordering::Relaxed) as usize;
+
+        let target = if allowed == 0 {
+            // Zamanlayıcı henüz başlamadı: önyükleme CPU'su karnal_scheduler_start'ta alır.
+            0
+        } else if allowed & (1 << last) != 0 {
+            last
+        } else if allowed & (1 << this_cpu) != 0 {
+            this_cpu
+        } else {
+            // Maske içinde en kısa kuyruğu seç
+            let mut best = allowed.trailing_zeros() as usize;
+            for cpu in 0..MAX_CPUS {
+                if allowed & (1 << cpu) != 0 && RUN_QUEUES[cpu].len() < RUN_QUEUES[best].len() {
+                    best = cpu;
+                }
+            }
+            best
+        };
+        RUN_QUEUES[target].push(slot);
+
+        // Hedef boştaysa onu uyandır; değilse iş bekliyor demektir, boştaki uygun bir CPU çalsın.
+        let idle = IDLE.load(Ordering::Acquire);
+        if target != this_cpu && idle & (1 << target) != 0 {
+            kick(target);
+        } else if let Some(thief) = lowest_bit(idle & allowed & !(1 << target) & !(1 << this_cpu)) {
+            kick(thief);
+        }
+    }
+
+    fn lowest_bit(mask: u64) -> Option<usize> {
+        if mask == 0 { None } else { Some(mask.trailing_zeros() as usize) }
+    }
+
+    // Diğer CPU'lardan iş çalar: maske uygun iş parçacıklarının yarısını alır, birini döner, kalanını
+    // kendi kuyruğuna koyar. Kesmeler kapalı çağrılmalıdır.
+    fn steal(cpu: usize) -> Option<u32> {
+        let online = ONLINE.load(Ordering::Acquire);
+        let mut stolen = [0u32; STEAL_BATCH];
+        let mut taken = 0;
+
+        for offset in 1..MAX_CPUS {
+            let victim = (cpu + offset) % MAX_CPUS;
+            if online & (1 << victim) == 0 || RUN_QUEUES[victim].len() == 0 {
+                continue;
+            }
+            {
+                let queue = &RUN_QUEUES[victim];
+                let mut ring = queue.ring.lock();
+                let quota = ((ring.count + 1) / 2).min(STEAL_BATCH);
+                // Kuyruk sırası korunarak bir tur döndürülür; uygun olanlar alınır, diğerleri geri konur.
+                for _ in 0..ring.count {
+                    let slot = match ring.pop() {
+                        Some(slot) => slot,
+                        None => break,
+                    };
+                    let allowed = allowed_cpus(THREADS[slot as usize].affinity.load(Ordering::Relaxed));
+                    if taken < quota && allowed & (1 << cpu) != 0 {
+                        stolen[taken] = slot;
+                        taken += 1;
+                    } else {
+                        ring.push(slot);
+                    }
+                }
+                queue.len.store(ring.count as u32, Ordering::Relaxed);
+            }
+            if taken != 0 {
+                break;
+            }
+        }
+
+        if taken == 0 {
+            return None;
+        }
+        STOLEN_THREADS.fetch_add(taken as u64, Ordering::Relaxed);
+        for &slot in &stolen[1..taken] {
+            THREADS[slot as usize].last_cpu.store(cpu as u32, Ordering::Relaxed);
+            RUN_QUEUES[cpu].push(slot);
+        }
+        Some(stolen[0])
+    }
+
+    #[derive(Copy, Clone, PartialEq, Eq)]
+    enum Switch {
+        Yield, // Çalışan iş parçacığı hazır kalır ve kuyruğa döner
+        Block, // Çağıran durumu BLOCKED yaptı; uyandıran kuyruğa koyar
+        Exit,  // Çağıran durumu EXITED yaptı; yığıtı geçişten sonra iade edilir
+    }
+
+    // Sıradaki iş parçacığını seçip ona geçer. Çağıran iş parçacığı yeniden seçildiğinde döner
+    // (başka bir CPU'da olabilir).
+    fn schedule(reason: Switch) {
+        schedule_to(reason, None);
+    }
+
+    // `direct` verilmişse kuyruğa bakmadan ona geçer (çağıran onu READY yapmış ve kuyruğa koymamıştır).
+    fn schedule_to(reason: Switch, direct: Option<u32>) {
+        let irq = unsafe { low_level_interrupt_save() };
+        let cpu = current_cpu();
+        let this = &CPUS[cpu];
+        this.need_resched.store(false, Ordering::Relaxed);
+
+        let prev = this.current.load(Ordering::Relaxed);
+        let idle = this.idle.load(Ordering::Relaxed);
+        if prev == NO_THREAD {
+            // karnal_scheduler_start öncesi: bağlam değiştirilecek bir iş parçacığı yok
+            unsafe { low_level_interrupt_restore(irq) };
+            return;
+        }
+        let prev_thread = &THREADS[prev as usize];
+        if reason == Switch::Yield && prev != idle {
+            prev_thread.state.store(READY, Ordering::Relaxed);
+            RUN_QUEUES[cpu].push(prev);
+        }
+
+        let next = match direct {
+            Some(slot) => slot,
+            None => RUN_QUEUES[cpu].pop().or_else(|| steal(cpu)).unwrap_or(idle),
+        };
+        let next_thread = &THREADS[next as usize];
+        // Boşta iş parçacığı için zaman dilimi kurulmaz: boştaki CPU zaman dilimi için uyandırılmaz.
+        ktimer::set_slice_deadline(if next == idle { ktimer::NO_DEADLINE } else { ktimer::now_ns().saturating_add(TIME_SLICE_NS) });
+        if next == prev {
+            prev_thread.state.store(RUNNING, Ordering::Relaxed);
+            unsafe { low_level_interrupt_restore(irq) };
+            return;
+        }
+
+        // Başka bir CPU'dan yeni alındıysa o CPU'nun bağlamı kaydetmesini bekle.
+        while next_thread.on_cpu.load(Ordering::Acquire) {
+            core::hint::spin_loop();
+        }
+        next_thread.on_cpu.store(true, Ordering::Relaxed);
+        next_thread.state.store(RUNNING, Ordering::Relaxed);
+        next_thread.last_cpu.store(cpu as u32, Ordering::Relaxed);
+        this.current.store(next, Ordering::Relaxed);
+        this.prev.store(prev, Ordering::Relaxed);
+        CONTEXT_SWITCHES.fetch_add(1, Ordering::Relaxed);
+        ktrace::record(ktrace::EV_SWITCH, prev as u64, next as u64);
+        // FPU'yu bu zaman diliminde kullanmadıysa yazmaçlar önceki kayıtla aynıdır ve FPU zaten kapalıdır.
+        // Kayıt, `on_cpu` inip başka bir CPU iş parçacığını (ve durumunu) alabilmeden önce biter.
+        if prev_thread.fpu_active.swap(false, Ordering::Relaxed) {
+            if prev_thread.state.load(Ordering::Relaxed) != EXITED {
+                unsafe { low_level_fpu_save(prev_thread.fpu_area.load(Ordering::Relaxed)) };
+                FPU_SAVES.fetch_add(1, Ordering::Relaxed);
+            }
+            unsafe { low_level_fpu_disable() };
+        }
+        // Kullanıcı modundan gelen sistem çağrıları ve kesmeler yeni iş parçacığının yığıtına girsin
+        // (boşta/önyükleme bağlamlarının zamanlayıcıya ait bir yığıtı yoktur ve kullanıcı moduna geçmezler)
+        let stack = next_thread.stack_base.load(Ordering::Relaxed);
+        if stack != 0 {
+            let top = stack + ((PAGE_SIZE as u64) << next_thread.stack_order.load(Ordering::Relaxed));
+            unsafe { low_level_set_kernel_stack(top) };
+        }
+        let root = TASK_ROOTS[next_thread.task.load(Ordering::Relaxed) as usize].load(Ordering::Relaxed);
+        if root != 0 && this.root.load(Ordering::Relaxed) != root {
+            unsafe { kmem_virt_activate_address_space(root) };
+            // Geçiş bittikten sonra yayımlanır: reclaim_address_spaces eski kökü ancak bundan sonra yıkar
+            this.root.store(root, Ordering::Release);
+        }
+
+        unsafe {
+            low_level_context_switch(prev_thread.saved_sp.as_ptr(), next_thread.saved_sp.load(Ordering::Relaxed));
+        }
+        // Yeniden seçildik; önceki iş parçacığını serbest bırak.
+        finish_switch();
+        unsafe { low_level_interrupt_restore(irq) };
+    }
+
+    // Geçişten sonra, yeni iş parçacığının bağlamında çalışır.
+    fn finish_switch() {
+        let this = &CPUS[current_cpu()];
+        let prev = this.prev.swap(NO_THREAD, Ordering::Relaxed);
+        if prev == NO_THREAD {
+            return;
+        }
+        let thread = &THREADS[prev as usize];
+        let exited = thread.state.load(Ordering::Relaxed) == EXITED;
+        thread.on_cpu.store(false, Ordering::Release);
+        if exited {
+            reap(prev);
+        }
+    }
+
+    // Yeni iş parçacıklarının ilk çalıştığı yer (low_level_thread_stack_init ile kurulur).
+    extern "C" fn thread_start(slot: u64) -> ! {
+        finish_switch();
+        unsafe { low_level_interrupt_enable() };
+        let thread = &THREADS[slot as usize];
+        let entry: extern "C" fn(u64) = unsafe { core::mem::transmute(thread.entry.load(Ordering::Relaxed) as usize) };
+        entry(thread.arg.load(Ordering::Relaxed));
+        thread_exit(0)
+    }
+
+    // --- Dışarıya Açık Zamanlayıcı Arayüzü ---
+
+    /// Yeni bir çekirdek iş parçacığı oluşturur ve bir çalışma kuyruğuna koyar.
+    /// `entry` bir `extern "C" fn(u64)` adresidir; dönerse iş parçacığı 0 koduyla çıkar.
+    /// `affinity` izin verilen CPU'ların maskesidir (0 veya CPU_ANY: hepsi).
+    pub fn thread_create(entry: u64, stack_size: usize, arg: u64, affinity: u64) -> Result<KThreadId, KError> {
+        create_thread(entry, stack_size, arg, affinity, current_task()) // Yeni iş parçacığı oluşturanın görevinde
+    }
+
+    /// Yeni bir kullanıcı görevi açar: `root` adres alanını boş bir görev yuvasına bağlar ve görevin ilk
+    /// iş parçacığını oluşturur (`entry(arg)` çekirdekte başlar, bkz. thread_create). Başarıda adres alanı
+    /// görevindir ve son iş parçacığı çıkınca yıkılır; hata durumunda çağırana kalır.
+    pub fn task_create(root: u64, entry: u64, arg: u64) -> Result<(u32, KThreadId), KError> {
+        if root == 0 {
+            return Err(KError::InvalidArgument);
+        }
+        let task = (1..MAX_TASKS)
+            .find(|&t| {
+                TASK_THREADS[t].load(Ordering::Acquire) == 0
+                    && TASK_ROOTS[t].compare_exchange(0, root, Ordering::AcqRel, Ordering::Relaxed).is_ok()
+            })
+            .ok_or(KError::OutOfMemory)? as u32;
+        TASK_PRIVILEGED[task as usize].store(current_task() == 0, Ordering::Relaxed);
+        match create_thread(entry, 0, arg, CPU_ANY, task) {
+            Ok(tid) => Ok((task, tid)),
+            Err(err) => {
+                TASK_ROOTS[task as usize].store(0, Ordering::Release);
+                Err(err)
+            }
+        }
+    }
+
+    fn create_thread(entry: u64, stack_size: usize, arg: u64, affinity: u64, task: u32) -> Result<KThreadId, KError> {
+        if entry == 0 {
+            return Err(KError::InvalidArgument);
+        }
+        let size = if stack_size == 0 { DEFAULT_STACK_SIZE } else { stack_size };
+        let pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+        let order = pages.next_power_of_two().trailing_zeros();
+        if order > MAX_STACK_ORDER {
+            return Err(KError::InvalidArgument);
+        }
+
+        let slot = alloc_slot().ok_or(KError::OutOfMemory)?;
+        let thread = &THREADS[slot as usize];
+        // Fiziksel bellek kimlik haritalı: frame adresi doğrudan çekirdek yığıtı olarak kullanılır.
+        let stack = unsafe { kmem_phys_alloc_frames(order) };
+        if stack == 0 {
+            thread.state.store(FREE, Ordering::Release);
+            return Err(KError::OutOfMemory);
+        }
+        let stack_top = stack + ((PAGE_SIZE as u64) << order);
+
+        thread.affinity.store(if affinity == 0 { CPU_ANY } else { affinity }, Ordering::Relaxed);
+        thread.last_cpu.store(current_cpu() as u32, Ordering::Relaxed);
+        thread.entry.store(entry, Ordering::Relaxed);
+        thread.arg.store(arg, Ordering::Relaxed);
+        thread.stack_base.store(stack, Ordering::Relaxed);
+        thread.stack_order.store(order, Ordering::Relaxed);
+        TASK_THREADS[task as usize].fetch_add(1, Ordering::Relaxed);
+        thread.task.store(task, Ordering::Relaxed);
+        thread.on_cpu.store(false, Ordering::Relaxed);
+        let sp = unsafe { low_level_thread_stack_init(stack_top, thread_start as usize as u64, slot as u64) };
+        thread.saved_sp.store(sp, Ordering::Relaxed);
+        let tid = thread_id(slot);
+
+        let irq = unsafe { low_level_interrupt_save() };
+        thread.state.store(READY, Ordering::Release);
+        enqueue(slot);
+        unsafe { low_level_interrupt_restore(irq) };
+        Ok(tid)
+    }
+
+    /// Bir iş parçacığının izin verilen CPU maskesini değiştirir. Çalışan iş parçacığı bir sonraki
+    /// kuyruğa girişinde yeni maskeye göre yerleştirilir.
+    pub fn set_affinity(tid: KThreadId, affinity: u64) -> Result<(), KError> {
+        let slot = resolve(tid)?;
+        THREADS[slot as usize].affinity.store(if affinity == 0 { CPU_ANY } else { affinity }, Ordering::Relaxed);
+        Ok(())
+    }
+
+    /// Zamanlayıcıya katılmış CPU'lar (bit n = CPU n).
+    pub fn online_cpus() -> u64 {
+        ONLINE.load(Ordering::Acquire)
+    }
+
+    /// Çalışan iş parçacığının kimliği. Zamanlayıcı başlamadan önce NotFound döner.
+    pub fn current_thread() -> Result<KThreadId, KError> {
+        let slot = CPUS[current_cpu()].current.load(Ordering::Relaxed);
+        if slot == NO_THREAD { Err(KError::NotFound) } else { Ok(thread_id(slot)) }
+    }
+
+    /// CPU'yu kuyrukta bekleyen bir iş parçacığına bırakır. Bekleyen yoksa hemen döner.
+    pub fn yield_now() -> Result<(), KError> {
+        schedule(Switch::Yield);
+        Ok(())
+    }
+
+    /// Çalışan iş parçacığını sonlandırır. Yığıtı bir sonraki iş parçacığına geçildikten sonra iade edilir.
+    pub fn thread_exit(code: i32) -> ! {
+        if let Some(slot) = current_slot() {
+            leave_task(THREADS[slot as usize].task.load(Ordering::Relaxed));
+        }
+        let slot = CPUS[current_cpu()].current.load(Ordering::Relaxed);
+        unsafe { low_level_interrupt_save() };
+        if slot != NO_THREAD {
+            THREADS[slot as usize].state.store(EXITED, Ordering::Relaxed);
+            schedule(Switch::Exit);
+        }
+        loop {
+            unsafe { low_level_cpu_idle_wait() };
+        }
+    }
+
+    /// Bloklanmaya hazırlanır: çalışan iş parçacığı BLOCKED olur ve bir bloklanma sırası döner.
+    /// Çağıran bekleme koşulunu yeniden kontrol eder ve gerekiyorsa `block` çağırır. Bu arada gelen
+    /// `wake` kaybolmaz: iş parçacığı kuyruğa konur ve `block` hemen geri döner.
+    /// Kesmeler `block` dönene kadar kapalı tutulmalıdır (dönen değer kesme durumunu içermez).
+    pub fn prepare_block() -> u32 {
+        let slot = CPUS[current_cpu()].current.load(Ordering::Relaxed);
+        let thread = &THREADS[slot as usize];
+        let seq = thread.block_seq.fetch_add(1, Ordering::Relaxed) + 1;
+        thread.state.store(BLOCKED, Ordering::Release);
+        seq
+    }
+
+    /// `prepare_block` sonrası bloklanmaktan vazgeçer (bekleme kurulamadıysa). Kesmeler kapalı çağrılır.
+    pub fn cancel_block() {
+        let slot = CPUS[current_cpu()].current.load(Ordering::Relaxed);
+        let thread = &THREADS[slot as usize];
+        thread.block_seq.fetch_add(1, Ordering::Relaxed);
+        if thread.state.compare_exchange(BLOCKED, RUNNING, Ordering::AcqRel, Ordering::Relaxed).is_err() {
+            // Araya giren bir uyandırma iş parçacığını zaten kuyruğa koydu; o kayıttan devam edilir.
+            block();
+        }
+    }
+
+    /// `prepare_block` sonrası CPU'yu bırakır; `wake` çağrılana kadar dönmez.
+    pub fn block() {
+        schedule(Switch::Block);
+    }
+
+    /// `prepare_block` sonrası CPU'yu çalışma kuyruğunu atlayarak doğrudan `slot`'taki iş parçacığına
+    /// bırakır (senkron IPC'de istemciden sunucuya ve geri). Hedef hâlâ `seq` bloklanmasında olmalıdır.
+    /// Hedef bu CPU'da çalışamıyorsa veya bu arada uyandırıldıysa normal uyandırma ve `block` yapılır.
+    /// Kesmeler kapalı çağrılır; çağıran uyandırılınca döner.
+    pub fn block_and_handoff(slot: u32, seq: u32) {
+        let cpu = current_cpu();
+        let thread = &THREADS[slot as usize];
+        if thread.block_seq.load(Ordering::Relaxed) == seq
+            && allowed_cpus(thread.affinity.load(Ordering::Relaxed)) & (1 << cpu) != 0
+            && thread.state.compare_exchange(BLOCKED, READY, Ordering::AcqRel, Ordering::Relaxed).is_ok()
+        {
+            DIRECT_HANDOFFS.fetch_add(1, Ordering::Relaxed);
+            schedule_to(Switch::Block, Some(slot));
+        } else {
+            wake_slot(slot, Some(seq));
+            block();
+        }
+    }
+
+    /// Bloklanmış bir iş parçacığını hazır yapar. Bloklanmamışsa etkisizdir.
+    pub fn wake(tid: KThreadId) -> Result<(), KError> {
+        wake_slot(resolve(tid)?, None);
+        Ok(())
+    }
+
+    /// Çalışan iş parçacığının yuva numarası (bekleme kuyrukları için). Zamanlayıcı başlamadıysa veya
+    /// çağıran boşta iş parçacığıysa None döner; bu bağlamlar bloklanamaz.
+    pub fn current_slot() -> Option<u32> {
+        let this = &CPUS[current_cpu()];
+        let slot = this.current.load(Ordering::Relaxed);
+        if slot == NO_THREAD || slot == this.idle.load(Ordering::Relaxed) { None } else { Some(slot) }
+    }
+
+    /// Çalışan iş parçacığının görevi. Boşta/önyükleme bağlamı çekirdek görevindedir (0).
+    pub fn current_task() -> u32 {
+        match current_slot() {
+            Some(slot) => THREADS[slot as usize].task.load(Ordering::Relaxed),
+            None => 0,
+        }
+    }
+
+    /// Çalışan görev ayrıcalıklı mı: çekirdek görevi veya çekirdek bağlamından açılan görev (init).
+    /// Kullanıcı görevlerinin açtığı görevler ayrıcalığı devralmaz.
+    pub fn current_task_privileged() -> bool {
+        let task = current_task();
+        task == 0 || TASK_PRIVILEGED[task as usize].load(Ordering::Relaxed)
+    }
+
+    /// İş parçacığını başka bir göreve taşır (görev oluşturulurken ilk iş parçacığı için).
+    pub fn set_thread_task(tid: KThreadId, task: u32) -> Result<(), KError> {
+        if task as usize >= MAX_TASKS {
+            return Err(KError::InvalidArgument);
+        }
+        let slot = resolve(tid)?;
+        TASK_THREADS[task as usize].fetch_add(1, Ordering::Relaxed);
+        let old = THREADS[slot as usize].task.swap(task, Ordering::Relaxed);
+        leave_task(old);
+        Ok(())
+    }
+
+    /// Yuvadaki iş parçacığı şu anda bir CPU'da çalışıyor mu (uyarlanabilir kilitlerin dönme kararı için).
+    pub fn is_on_cpu(slot: u32) -> bool {
+        let thread = &THREADS[slot as usize];
+        thread.state.load(Ordering::Relaxed) == RUNNING && thread.on_cpu.load(Ordering::Relaxed)
+    }
+
+    /// `prepare_block`'un döndüğü `seq` ile kayıtlı bir bekleyeni uyandırır. İş parçacığı o zamandan beri
+    /// başka bir nedenle bloklandıysa etkisizdir.
+    pub fn wake_waiter(slot: u32, seq: u32) {
+        wake_slot(slot, Some(seq));
+    }
+
+    // `seq` verilmişse yalnızca o bloklanma hâlâ sürüyorsa uyandırır.
+    fn wake_slot(slot: u32, seq: Option<u32>) {
+        let thread = &THREADS[slot as usize];
+        if let Some(seq) = seq {
+            if thread.block_seq.load(Ordering::Relaxed) != seq {
+                return;
+            }
+        }
+        if thread.state.compare_exchange(BLOCKED, READY, Ordering::AcqRel, Ordering::Relaxed).is_ok() {
+            let irq = unsafe { low_level_interrupt_save() };
+            enqueue(slot);
+            unsafe { low_level_interrupt_restore(irq) };
+        }
+    }
+
+    // --- Uyku ---
+
+    /// Çalışan iş parçacığını en az `milliseconds` süre uyutur. 0 yield ile aynıdır.
+    pub fn task_sleep(milliseconds: u64) -> Result<(), KError> {
+        let nanoseconds = milliseconds.saturating_mul(1_000_000);
+        task_sleep_ns(nanoseconds, ktimer::default_slack(nanoseconds))
+    }
+
+    /// Çalışan iş parçacığını en az `nanoseconds`, en fazla yaklaşık `nanoseconds + slack_ns` süre uyutur.
+    /// Esneklik yakın uyanmaların tek kesmede birleştirilmesine izin verir; gecikmeye duyarlı çağıranlar
+    /// 0 verebilir. Zamanlayıcı çağıranın CPU'sunda kurulur.
+    pub fn task_sleep_ns(nanoseconds: u64, slack_ns: u64) -> Result<(), KError> {
+        if nanoseconds == 0 {
+            return yield_now();
+        }
+        let irq = unsafe { low_level_interrupt_save() };
+        let cpu = current_cpu();
+        let slot = CPUS[cpu].current.load(Ordering::Relaxed);
+        if slot == NO_THREAD || slot == CPUS[cpu].idle.load(Ordering::Relaxed) {
+            unsafe { low_level_interrupt_restore(irq) };
+            return Err(KError::NotSupported); // Boşta iş parçacığı uyuyamaz
+        }
+        let deadline = ktimer::now_ns().saturating_add(nanoseconds);
+        let seq = prepare_block();
+        // Kesmeler kapalı: zamanlayıcı bu CPU'da kurulduğundan block()'tan önce dolamaz.
+        let timer = match ktimer::arm_wakeup(deadline, slack_ns, slot, seq) {
+            Ok(timer) => timer,
+            Err(err) => {
+                cancel_block();
+                unsafe { low_level_interrupt_restore(irq) };
+                return Err(err);
+            }
+        };
+        block();
+        ktimer::cancel(timer); // Erken uyandırıldıysa (wake) yuvayı hemen geri ver
+        unsafe { low_level_interrupt_restore(irq) };
+        Ok(())
+    }
+
+    // --- Mimari/Platform Kancaları (hardware_specific.h) ---
+
+    /// Çalışan iş parçacığının zaman dilimi doldu (ktimer_interrupt, kesme bağlamı).
+    /// Kuyrukta bekleyen varsa yeniden zamanlama istenir; yoksa iş parçacığı yeni bir dilimle devam eder.
+    pub fn slice_expired() {
+        let cpu = current_cpu();
+        if RUN_QUEUES[cpu].len() != 0 {
+            CPUS[cpu].need_resched.store(true, Ordering::Relaxed);
+        } else {
+            ktimer::set_slice_deadline(ktimer::now_ns().saturating_add(TIME_SLICE_NS));
+        }
+    }
+
+    /// Reschedule IPI işleyicisi. Hedef CPU'nun kuyruğuna iş kondu veya çalınacak iş var.
+    #[no_mangle]
+    pub extern "C" fn ksched_handle_reschedule_ipi() {
+        CPUS[current_cpu()].need_resched.store(true, Ordering::Relaxed);
+    }
+
+    /// FPU/SIMD erişim tuzağı: çalışan iş parçacığının durumunu yükler (ilk kullanımda alanını ayırır) ve
+    /// FPU'yu zaman diliminin sonuna kadar açar. Dönüşte tuzağa düşen komut yeniden çalışır.
+    #[no_mangle]
+    pub extern "C" fn ksched_fpu_trap() {
+        let size = FPU_AREA_SIZE.load(Ordering::Relaxed);
+        let slot = match current_slot() {
+            Some(slot) if size != 0 => slot,
+            _ => return, // Boşta/önyükleme bağlamı FPU kullanmaz
+        };
+        let thread = &THREADS[slot as usize];
+        FPU_TRAPS.fetch_add(1, Ordering::Relaxed);
+
+        let mut area = thread.fpu_area.load(Ordering::Relaxed);
+        if area == 0 {
+            area = unsafe { kmem_phys_alloc_frames(fpu_area_order()) };
+            if area == 0 {
+                // Durumu tutulamayan iş parçacığı FPU komutunu çalıştıramaz
+                thread_exit(KError::OutOfMemory as i32);
+            }
+            unsafe {
+                core::ptr::write_bytes(area as *mut u8, 0, size as usize);
+                low_level_fpu_area_init(area);
+            }
+            thread.fpu_area.store(area, Ordering::Relaxed);
+        }
+
+        let irq = unsafe { low_level_interrupt_save() };
+        let cpu = current_cpu();
+        let this = &CPUS[cpu];
+        unsafe { low_level_fpu_enable() };
+        if this.fpu_owner.load(Ordering::Relaxed) == slot && thread.fpu_cpu.load(Ordering::Relaxed) == cpu as u32 {
+            // Son kayıttan beri bu CPU'da kimse durum yüklemedi: yazmaçlar hâlâ geçerli
+            FPU_RESTORES_SKIPPED.fetch_add(1, Ordering::Relaxed);
+        } else {
+            unsafe { low_level_fpu_restore(area) };
+            this.fpu_owner.store(slot, Ordering::Relaxed);
+            thread.fpu_cpu.store(cpu as u32, Ordering::Relaxed);
+        }
+        thread.fpu_active.store(true, Ordering::Relaxed);
+        unsafe { low_level_interrupt_restore(irq) };
+    }
+
+    /// Mimari kesme kodu kullanıcı moduna dönmeden hemen önce çağırır; istenmişse iş parçacığını değiştirir.
+    /// Çekirdek içi kesme dönüşlerinde çağrılmamalıdır (kesilen kod bir kilit tutuyor olabilir).
+    #[no_mangle]
+    pub extern "C" fn ksched_preempt_point() {
+        if CPUS[current_cpu()].need_resched.load(Ordering::Relaxed) {
+            schedule(Switch::Yield);
+        }
+    }
+
+    /// Çalışan CPU'nun FPU/SIMD kurulumunu yapar; FPU kapalı başlar, kayıt alanı boyutu tüm CPU'larda
+    /// aynıdır. Her CPU başlatma grafiğine katılmadan önce bir kez çağırır (kboot).
+    pub fn fpu_cpu_init() {
+        FPU_AREA_SIZE.store(unsafe { low_level_fpu_cpu_init() }, Ordering::Relaxed);
+    }
+
+    // --- C API ---
+
+    /// Çağıran CPU'yu zamanlayıcıya katar ve boşta döngüsüne girer. Geri dönmez.
+    /// Çağıran bağlam (önyükleme yığıtı) bu CPU'nun boşta iş parçacığı olur; kuyruk boşken
+    /// diğer CPU'lardan iş çalar, çalacak iş de yoksa bir kesmeye kadar bekler.
+    /// Önyükleme CPU'su ve SMP ile açılan her CPU bunu bir kez çağırır.
+    #[no_mangle]
+    pub extern "C" fn karnal_scheduler_start() -> ! {
+        unsafe { low_level_interrupt_save() };
+        let cpu = current_cpu();
+        let bit = 1u64 << cpu;
+        let slot = match alloc_slot() {
+            Some(slot) => slot,
+            None => loop {
+                unsafe { low_level_cpu_idle_wait() };
+            },
+        };
+        let idle = &THREADS[slot as usize];
+        idle.affinity.store(bit, Ordering::Relaxed);
+        idle.last_cpu.store(cpu as u32, Ordering::Relaxed);
+        idle.on_cpu.store(true, Ordering::Relaxed);
+        idle.state.store(RUNNING, Ordering::Relaxed);
+        CPUS[cpu].idle.store(slot, Ordering::Relaxed);
+        CPUS[cpu].current.store(slot, Ordering::Relaxed);
+        ONLINE.fetch_or(bit, Ordering::AcqRel);
+
+        // Zamanlayıcı başlamadan oluşturulan iş parçacıkları önyükleme CPU'sunun kuyruğunda bekler.
+        loop {
+            schedule(Switch::Yield);
+
+            // Çalışacak iş yok. IDLE bitini kesmeler kapalıyken koy ve kuyruğu yeniden kontrol et;
+            // araya giren bir enqueue ya kuyrukta görünür ya da IPI'ı bekleme sırasında gelir.
+            unsafe { low_level_interrupt_save() };
+            IDLE.fetch_or(bit, Ordering::AcqRel);
+            if RUN_QUEUES[cpu].len() == 0 && !CPUS[cpu].need_resched.load(Ordering::Acquire) {
+                kdvfs::idle_wait(cpu); // Boşta durumu seçimi ve boşta süresi hesabı
+            }
+            IDLE.fetch_and(!bit, Ordering::AcqRel);
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_task_yield() -> i64 {
+        match yield_now() {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_task_sleep(milliseconds: u64) -> i64 {
+        match task_sleep(milliseconds) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_task_sleep_ns(nanoseconds: u64, slack_ns: u64) -> i64 {
+        match task_sleep_ns(nanoseconds, slack_ns) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_thread_create(entry_point: u64, stack_size: usize, arg: u64) -> i64 {
+        karnal_thread_create_affine(entry_point, stack_size, arg, CPU_ANY)
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_thread_create_affine(entry_point: u64, stack_size: usize, arg: u64, cpu_mask: u64) -> i64 {
+        match thread_create(entry_point, stack_size, arg, cpu_mask) {
+            Ok(tid) => tid.0 as i64,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_thread_set_affinity(thread_id: u64, cpu_mask: u64) -> i64 {
+        match set_affinity(KThreadId(thread_id), cpu_mask) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_thread_exit(code: i32) -> ! {
+        thread_exit(code)
+    }
+}
@@ -0,0 +1,497 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, ksched};
+
+// --- Dilim (Slab) Ayırıcı: Boyut Sınıfları, CPU Magazinleri ve Depo ---
+// Küçük nesne tahsisleri üç katmandan karşılanır (magazin modeli):
+// 1. CPU önbelleği: her CPU'nun her sınıf için bir 'loaded' ve bir 'previous' magazini vardır.
+//    Hızlı yol yalnızca bu katmana dokunur. Kilidi o CPU'ya özeldir, diğer CPU'larla çekişmez.
+// 2. Depo: sınıf başına paylaşılan dolu magazin yığını. CPU magazinleri tükenince/dolunca
+//    depoyla bütün bir magazin takas edilir (nesne başına değil, MAGAZINE_SIZE nesnede bir kez).
+// 3. Dilim katmanı: PageSource'tan alınan sayfalar sınıf boyutunda nesnelere bölünür.
+//    Frame ayırıcıya (ve gerekiyorsa MMU'ya) yalnızca bu katman, yeni bir sayfa gerektiğinde gider.
+//
+// Boş nesne listeleri nesnelerin içine yazılmaz (sayfa başına bit eşlemi tutulur).
+// Böylece aynı kod, çekirdek tarafından doğrudan erişilemeyen kullanıcı alanı sayfaları için de çalışır.
+//
+// Kümenin boyutları (CPU önbelleği, sınıf başına dilim sayfası ve depo magazini sayısı) tip parametresidir.
+// Çekirdek kümesi ~200 KiB tutar; görev başına kullanıcı kümeleri (aşağıda) bunun yaklaşık sekizde biridir.
+
+pub mod kslab {
+    use super::*;
+    use core::sync::atomic::{AtomicU64, Ordering};
+    use core::alloc::{GlobalAlloc, Layout};
+    use spin::Mutex;
+
+    /// Boyut sınıfları (byte). Nesneler kendi boyutlarına hizalıdır.
+    pub const SIZE_CLASSES: [usize; NUM_CLASSES] = [16, 32, 64, 128, 256, 512, 1024, 2048];
+    pub const NUM_CLASSES: usize = 8;
+    /// Dilim ayırıcının karşıladığı en büyük tahsis boyutu
+    pub const SLAB_MAX_SIZE: usize = 2048;
+    /// CPU başına önbellek tutulan en fazla CPU sayısı (fazlası son önbelleği paylaşır)
+    pub const MAX_CPUS: usize = 32;
+
+    const PAGE_SIZE: usize = 4096; // KERNEL_PAGE_SIZE
+    // Bir magazindeki nesne sayısı
+    const MAGAZINE_SIZE: usize = 16;
+    // Sınıf başına depoda tutulabilecek dolu magazin sayısı
+    const DEPOT_MAGAZINES: usize = 16;
+    // Sınıf başına en fazla dilim sayfası
+    const MAX_SLAB_PAGES: usize = 256;
+    // Bit eşlemi kelime sayısı: 4096 / 16 = 256 nesne = 4 x u64
+    const BITMAP_WORDS: usize = PAGE_SIZE / 16 / 64;
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_SLAB_* ile EŞLEŞMELİDİR)
+    pub const INFO_SLAB_CLASS_COUNT: u32 = 0x100;
+    pub const INFO_SLAB_CLASS_SIZE: u32 = 0x110;
+    pub const INFO_SLAB_HITS: u32 = 0x120;
+    pub const INFO_SLAB_MISSES: u32 = 0x130;
+
+    extern "C" {
+        fn kmem_phys_alloc_frame() -> u64;
+        fn kmem_phys_free_frame(frame_addr: u64);
+        fn kmem_phys_alloc_frames(order: u32) -> u64;
+        fn kmem_phys_free_frames(frame_addr: u64, order: u32);
+        fn low_level_cpu_id() -> u32;
+    }
+
+    /// Dilim sayfalarının kaynağı.
+    /// Dönen adres, nesnelerin tahsis edenlere verileceği adres alanındaki sayfa başlangıcıdır.
+    pub trait PageSource {
+        fn alloc_page(&self) -> Option<usize>;
+    }
+
+    // kernel_memory.h'deki KMEM_PAGE_* bayrakları
+    const KMEM_PAGE_READ: u32 = 1 << 0;
+    const KMEM_PAGE_WRITE: u32 = 1 << 1;
+    const KMEM_PAGE_USER: u32 = 1 << 3;
+
+    extern "C" {
+        fn kmem_virt_map_page(vaddr: u64, paddr: u64, flags: u32) -> i64;
+    }
+
+    /// Çekirdek nesneleri için sayfa kaynağı. Fiziksel bellek kimlik haritalı olduğundan
+    /// frame adresi doğrudan çekirdek sanal adresi olarak kullanılır, MMU'ya gidilmez.
+    pub struct KernelPages;
+
+    impl PageSource for KernelPages {
+        fn alloc_page(&self) -> Option<usize> {
+            let frame = unsafe { kmem_phys_alloc_frame() };
+            if frame == 0 { None } else { Some(frame as usize) }
+        }
+    }
+
+    /// Çekirdeğin genel dilim kümesi.
+    pub static KERNEL_SLABS: SlabSet<KernelPages> = SlabSet::new(KernelPages);
+
+    // --- Magazin ---
+
+    #[derive(Clone, Copy)]
+    struct Magazine {
+        count: usize,
+        objects: [usize; MAGAZINE_SIZE],
+    }
+
+    impl Magazine {
+        const EMPTY: Magazine = Magazine { count: 0, objects: [0; MAGAZINE_SIZE] };
+
+        fn is_empty(&self) -> bool { self.count == 0 }
+        fn is_full(&self) -> bool { self.count == MAGAZINE_SIZE }
+
+        fn pop(&mut self) -> Option<usize> {
+            if self.count == 0 { return None; }
+            self.count -= 1;
+            Some(self.objects[self.count])
+        }
+
+        fn push(&mut self, object: usize) -> bool {
+            if self.is_full() { return false; }
+            self.objects[self.count] = object;
+            self.count += 1;
+            true
+        }
+    }
+
+    struct CpuMagazines {
+        loaded: Magazine,
+        previous: Magazine,
+    }
+
+    // Her CPU önbelleği kendi önbellek satırında başlar (CPU'lar arası yanlış paylaşımı önler).
+    // Kilit yalnızca görev işlem ortasında başka CPU'ya göçerse çekişir.
+    // Kesme işleyicileri bu ayırıcıyı kullanmamalıdır (aynı CPU'da kilit yeniden alınamaz).
+    #[repr(C, align(64))]
+    struct CpuCache {
+        magazines: Mutex<CpuMagazines>,
+        hits: AtomicU64,   // Magazinden karşılanan alloc/free
+        misses: AtomicU64, // Depoya veya dilim katmanına inen alloc/free
+    }
+
+    impl CpuCache {
+        const INIT: CpuCache = CpuCache {
+            magazines: Mutex::new(CpuMagazines { loaded: Magazine::EMPTY, previous: Magazine::EMPTY }),
+            hits: AtomicU64::new(0),
+            misses: AtomicU64::new(0),
+        };
+    }
+
+    // --- Depo ---
+
+    struct Depot<const N: usize> {
+        full: [Magazine; N],
+        count: usize,
+    }
+
+    impl<const N: usize> Depot<N> {
+        fn take_full(&mut self) -> Option<Magazine> {
+            if self.count == 0 { return None; }
+            self.count -= 1;
+            Some(self.full[self.count])
+        }
+
+        /// Depo doluysa magazini geri verir.
+        fn put_full(&mut self, magazine: Magazine) -> Result<(), Magazine> {
+            if self.count == N { return Err(magazine); }
+            self.full[self.count] = magazine;
+            self.count += 1;
+            Ok(())
+        }
+    }
+
+    // --- Dilim Katmanı ---
+
+    #[derive(Clone, Copy)]
+    struct SlabPage {
+        base: usize,
+        free: [u64; BITMAP_WORDS], // 1 = boş nesne
+        free_count: u16,
+    }
+
+    const EMPTY_PAGE: SlabPage = SlabPage { base: 0, free: [0; BITMAP_WORDS], free_count: 0 };
+
+    struct SlabLayer<const N: usize> {
+        pages: [SlabPage; N],
+        count: usize,
+    }
+
+    impl<const N: usize> SlabLayer<N> {
+
+        /// Magazini `target` nesneye kadar doldurur. Sayfa kalmadıysa eksik kalabilir.
+        fn refill<P: PageSource>(&mut self, magazine: &mut Magazine, target: usize, object_size: usize, source: &P) {
+            while magazine.count < target {
+                let index = match (0..self.count).find(|&i| self.pages[i].free_count > 0) {
+                    Some(index) => index,
+                    None => match self.grow(object_size, source) {
+                        Some(index) => index,
+                        None => return,
+                    },
+                };
+                let page = &mut self.pages[index];
+                let word = page.free.iter().position(|&w| w != 0).unwrap_or(0);
+                let bit = page.free[word].trailing_zeros() as usize;
+                page.free[word] &= !(1u64 << bit);
+                page.free_count -= 1;
+                magazine.push(page.base + (word * 64 + bit) * object_size);
+            }
+        }
+
+        /// Magazindeki tüm nesneleri sayfalarına geri koyar.
+        fn drain(&mut self, magazine: &Magazine, object_size: usize) {
+            for &object in &magazine.objects[..magazine.count] {
+                let base = object & !(PAGE_SIZE - 1);
+                if let Some(page) = self.pages[..self.count].iter_mut().find(|p| p.base == base) {
+                    let slot = (object - base) / object_size;
+                    page.free[slot / 64] |= 1u64 << (slot % 64);
+                    page.free_count += 1;
+                }
+            }
+            // TODO: Bellek baskısı altında tamamen boş sayfaları PageSource'a iade et.
+        }
+
+        fn grow<P: PageSource>(&mut self, object_size: usize, source: &P) -> Option<usize> {
+            if self.count == N { return None; }
+            let base = source.alloc_page()?;
+            let objects = PAGE_SIZE / object_size;
+
+            let mut page = SlabPage { base, free: [0; BITMAP_WORDS], free_count: objects as u16 };
+            for slot in 0..objects {
+                page.free[slot / 64] |= 1u64 << (slot % 64);
+            }
+            self.pages[self.count] = page;
+            self.count += 1;
+            Some(self.count - 1)
+        }
+    }
+
+    // --- Boyut Sınıfı ve Küme ---
+
+    struct SizeClass<const CPUS: usize, const PAGES: usize, const DEPOT: usize> {
+        object_size: usize,
+        cpus: [CpuCache; CPUS],
+        depot: Mutex<Depot<DEPOT>>,
+        slabs: Mutex<SlabLayer<PAGES>>,
+    }
+
+    impl<const CPUS: usize, const PAGES: usize, const DEPOT: usize> SizeClass<CPUS, PAGES, DEPOT> {
+        const fn new(object_size: usize) -> Self {
+            SizeClass {
+                object_size,
+                cpus: [CpuCache::INIT; CPUS],
+                depot: Mutex::new(Depot { full: [Magazine::EMPTY; DEPOT], count: 0 }),
+                slabs: Mutex::new(SlabLayer { pages: [EMPTY_PAGE; PAGES], count: 0 }),
+            }
+        }
+    }
+
+    /// Bir adres alanı için tüm boyut sınıflarını içeren dilim kümesi.
+    /// `CPUS`: CPU önbelleği sayısı (fazla CPU'lar önbellekleri paylaşır), `PAGES`: sınıf başına en fazla
+    /// dilim sayfası, `DEPOT`: sınıf başına depoda tutulan dolu magazin sayısı.
+    pub struct SlabSet<P: PageSource, const CPUS: usize = MAX_CPUS, const PAGES: usize = MAX_SLAB_PAGES,
+                       const DEPOT: usize = DEPOT_MAGAZINES> {
+        classes: [SizeClass<CPUS, PAGES, DEPOT>; NUM_CLASSES],
+        source: P,
+    }
+
+    /// `size` için uygun sınıf indeksi. SLAB_MAX_SIZE'dan büyükse None.
+    pub fn class_index(size: usize) -> Option<usize> {
+        SIZE_CLASSES.iter().position(|&class_size| size <= class_size)
+    }
+
+    fn current_cpu() -> usize {
+        unsafe { low_level_cpu_id() as usize }
+    }
+
+    impl<P: PageSource, const CPUS: usize, const PAGES: usize, const DEPOT: usize> SlabSet<P, CPUS, PAGES, DEPOT> {
+        pub const fn new(source: P) -> Self {
+            SlabSet {
+                classes: [
+                    SizeClass::new(16), SizeClass::new(32), SizeClass::new(64), SizeClass::new(128),
+                    SizeClass::new(256), SizeClass::new(512), SizeClass::new(1024), SizeClass::new(2048),
+                ],
+                source,
+            }
+        }
+
+        /// `size` byte'lık bir nesne tahsis eder. Başarı durumunda nesne adresi, bellek yoksa None döner.
+        pub fn alloc(&self, size: usize) -> Option<usize> {
+            let class = &self.classes[class_index(size.max(1))?];
+            let cpu = &class.cpus[current_cpu() % CPUS];
+            let mut guard = cpu.magazines.lock();
+            let magazines = &mut *guard;
+
+            // Hızlı yol: CPU magazinleri
+            if magazines.loaded.is_empty() && !magazines.previous.is_empty() {
+                core::mem::swap(&mut magazines.loaded, &mut magazines.previous);
+            }
+            if let Some(object) = magazines.loaded.pop() {
+                cpu.hits.fetch_add(1, Ordering::Relaxed);
+                return Some(object);
+            }
+
+            // Yavaş yol: önce depodan dolu bir magazin, yoksa dilim katmanından yarım magazin
+            cpu.misses.fetch_add(1, Ordering::Relaxed);
+            if let Some(full) = class.depot.lock().take_full() {
+                magazines.loaded = full;
+            } else {
+                class.slabs.lock().refill(&mut magazines.loaded, MAGAZINE_SIZE / 2, class.object_size, &self.source);
+            }
+            magazines.loaded.pop()
+        }
+
+        /// `alloc(size)` ile alınmış bir nesneyi serbest bırakır. `size` tahsisteki boyutla aynı sınıfa düşmelidir.
+        pub fn free(&self, object: usize, size: usize) -> Result<(), KError> {
+            let class = &self.classes[class_index(size.max(1)).ok_or(KError::InvalidArgument)?];
+            if object % class.object_size != 0 {
+                return Err(KError::InvalidArgument);
+            }
+            let cpu = &class.cpus[current_cpu() % CPUS];
+            let mut guard = cpu.magazines.lock();
+            let magazines = &mut *guard;
+
+            // Hızlı yol: CPU magazinleri
+            if magazines.loaded.is_full() && magazines.previous.is_empty() {
+                core::mem::swap(&mut magazines.loaded, &mut magazines.previous);
+            }
+            if magazines.loaded.push(object) {
+                cpu.hits.fetch_add(1, Ordering::Relaxed);
+                return Ok(());
+            }
+
+            // Yavaş yol: iki magazin de dolu. 'previous' depoya gider, 'loaded' onun yerini alır.
+            cpu.misses.fetch_add(1, Ordering::Relaxed);
+            let full = core::mem::replace(&mut magazines.previous, magazines.loaded);
+            magazines.loaded = Magazine::EMPTY;
+            magazines.loaded.push(object);
+            if let Err(full) = class.depot.lock().put_full(full) {
+                class.slabs.lock().drain(&full, class.object_size);
+            }
+            Ok(())
+        }
+
+        /// Sınıfın tüm CPU'lardaki isabet (hit) ve ıska (miss) sayaçlarının toplamı.
+        pub fn class_stats(&self, class: usize) -> Option<(u64, u64)> {
+            let class = self.classes.get(class)?;
+            let hits = class.cpus.iter().map(|c| c.hits.load(Ordering::Relaxed)).sum();
+            let misses = class.cpus.iter().map(|c| c.misses.load(Ordering::Relaxed)).sum();
+            Some((hits, misses))
+        }
+
+        pub fn source(&self) -> &P {
+            &self.source
+        }
+
+        /// Kümeyi boşaltır: magazinler, depo ve dilim sayfası kayıtları unutulur. Sayfalar kaynağa iade
+        /// edilmez; sahipleri (örn. yıkılan adres alanı) onları ayrıca serbest bırakmış olmalıdır.
+        /// Küme başka bir iş parçacığı tarafından kullanılmazken çağrılır.
+        pub fn reset(&self) {
+            for class in &self.classes {
+                for cpu in &class.cpus {
+                    let mut magazines = cpu.magazines.lock();
+                    magazines.loaded = Magazine::EMPTY;
+                    magazines.previous = Magazine::EMPTY;
+                }
+                class.depot.lock().count = 0;
+                class.slabs.lock().count = 0;
+            }
+        }
+    }
+
+    // --- Kullanıcı Dilim Kümeleri ---
+    // Görevin küçük tahsisleri (karnal_memory_allocate, <= SLAB_MAX_SIZE) görev yuvasının kümesinden
+    // karşılanır. Dilim sayfaları o sırada çalışan görevin adres alanındaki dilim penceresine bir kez eşlenir;
+    // nesneler daha sonra frame ayırıcıya ve MMU'ya gidilmeden dağıtılır. Kümeler statik tablodadır
+    // (görev başına ~27 KiB: 4 CPU önbelleği, sınıf başına 32 sayfa ve 4 depo magazini) ve görev yuvası
+    // boşalınca sıfırlanır; sayfaların kendisi adres alanıyla birlikte yıkılır.
+
+    pub const USER_CACHE_CPUS: usize = 4;
+    pub const USER_SLAB_PAGES: usize = 32;
+    const USER_DEPOT_MAGAZINES: usize = 4;
+    // Dilim penceresi (heap penceresinin altı); her sınıfın tüm sayfalarına yeter
+    const USER_SLAB_WINDOW_BASE: u64 = 0x0000_5F00_0000_0000;
+    const USER_SLAB_WINDOW_END: u64 = USER_SLAB_WINDOW_BASE + (NUM_CLASSES * USER_SLAB_PAGES * PAGE_SIZE) as u64;
+
+    pub type UserSlabSet = SlabSet<UserPages, USER_CACHE_CPUS, USER_SLAB_PAGES, USER_DEPOT_MAGAZINES>;
+
+    /// Görevin dilim penceresinden sayfa veren kaynak. Pencere yalnızca ilerler.
+    pub struct UserPages {
+        next_vaddr: AtomicU64, // Penceredeki sıradaki eşlenmemiş sayfa
+    }
+
+    impl UserPages {
+        const fn new() -> Self {
+            UserPages { next_vaddr: AtomicU64::new(USER_SLAB_WINDOW_BASE) }
+        }
+
+        /// `addr` bu kaynağın şimdiye kadar eşlediği pencere aralığında mı
+        fn contains(&self, addr: u64) -> bool {
+            addr >= USER_SLAB_WINDOW_BASE && addr < self.next_vaddr.load(Ordering::Relaxed).min(USER_SLAB_WINDOW_END)
+        }
+
+        fn reset(&self) {
+            self.next_vaddr.store(USER_SLAB_WINDOW_BASE, Ordering::Relaxed);
+        }
+    }
+
+    impl PageSource for UserPages {
+        fn alloc_page(&self) -> Option<usize> {
+            let frame = unsafe { kmem_phys_alloc_frame() };
+            if frame == 0 {
+                return None;
+            }
+            let vaddr = self.next_vaddr.fetch_add(PAGE_SIZE as u64, Ordering::Relaxed);
+            // Fiziksel bellek kimlik haritalı; sayfa kullanıcıya önceki sahibinin verisiyle gitmez
+            unsafe { core::ptr::write_bytes(frame as *mut u8, 0, PAGE_SIZE) };
+            let flags = KMEM_PAGE_READ | KMEM_PAGE_WRITE | KMEM_PAGE_USER;
+            if vaddr >= USER_SLAB_WINDOW_END || unsafe { kmem_virt_map_page(vaddr, frame, flags) } != 0 {
+                unsafe { kmem_phys_free_frame(frame) };
+                return None;
+            }
+            Some(vaddr as usize)
+        }
+    }
+
+    static USER_SLABS: [UserSlabSet; ksched::MAX_TASKS] = [const { SlabSet::new(UserPages::new()) }; ksched::MAX_TASKS];
+
+    fn current_user_slabs() -> Result<&'static UserSlabSet, KError> {
+        USER_SLABS.get(ksched::current_task() as usize).ok_or(KError::InternalError)
+    }
+
+    /// Çalışan görev için `size` (1..=SLAB_MAX_SIZE) byte'lık kullanıcı nesnesi tahsis eder, kullanıcı adresini döner.
+    pub fn user_alloc(size: usize) -> Result<u64, KError> {
+        if size == 0 || size > SLAB_MAX_SIZE {
+            return Err(KError::InvalidArgument);
+        }
+        current_user_slabs()?.alloc(size).map(|addr| addr as u64).ok_or(KError::OutOfMemory)
+    }
+
+    /// `user_alloc(size)` ile alınmış nesneyi serbest bırakır. Görevin penceresi dışındaki adresler reddedilir;
+    /// böylece sahte bir adres sonraki bir tahsiste dağıtılmaz.
+    pub fn user_free(addr: u64, size: usize) -> Result<(), KError> {
+        let slabs = current_user_slabs()?;
+        if !slabs.source().contains(addr) {
+            return Err(KError::InvalidArgument);
+        }
+        slabs.free(addr as usize, size)
+    }
+
+    /// `addr` çalışan görevin dilim penceresinin eşlenmiş kısmında mı (kullanıcı kopyalarının yazma kontrolü)
+    pub fn is_user_address(addr: u64) -> bool {
+        current_user_slabs().map_or(false, |slabs| slabs.source().contains(addr))
+    }
+
+    /// Görev yuvası boşalırken (son iş parçacığı çıktığında) çağrılır; yuvanın kümesini sıfırlar.
+    pub fn release_task(task: u32) {
+        if let Some(slabs) = USER_SLABS.get(task as usize) {
+            slabs.reset();
+            slabs.source().reset();
+        }
+    }
+
+    /// Çekirdek yığın (heap) ayırıcısı olarak kullanım: küçük düzenler dilim kümesinden,
+    /// tek sayfaya sığanlar doğrudan frame ayırıcıdan, daha büyükleri bitişik buddy bloklarından karşılanır.
+    unsafe impl GlobalAlloc for SlabSet<KernelPages> {
+        unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+            let size = layout.size().max(layout.align());
+            if size <= SLAB_MAX_SIZE {
+                return SlabSet::alloc(self, size).map_or(core::ptr::null_mut(), |a| a as *mut u8);
+            }
+            if size <= PAGE_SIZE {
+                return self.source.alloc_page().map_or(core::ptr::null_mut(), |a| a as *mut u8);
+            }
+            let frame = kmem_phys_alloc_frames(page_order(size));
+            if frame == 0 { core::ptr::null_mut() } else { frame as *mut u8 }
+        }
+
+        unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+            let size = layout.size().max(layout.align());
+            if size <= SLAB_MAX_SIZE {
+                let _ = SlabSet::free(self, ptr as usize, size);
+            } else if size <= PAGE_SIZE {
+                kmem_phys_free_frame(ptr as u64);
+            } else {
+                kmem_phys_free_frames(ptr as u64, page_order(size));
+            }
+        }
+    }
+
+    // `size` byte'ı kapsayan en küçük buddy order'ı
+    fn page_order(size: usize) -> u32 {
+        let pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+        pages.next_power_of_two().trailing_zeros()
+    }
+
+    /// karnal_kernel_get_info için dilim istatistikleri. Bilgi türü bu modüle ait değilse None döner.
+    pub fn get_info(info_type: u32) -> Option<Result<u64, KError>> {
+        let class = (info_type & 0xF) as usize;
+        let value = match info_type & !0xF {
+            INFO_SLAB_CLASS_COUNT if class == 0 => Some(NUM_CLASSES as u64),
+            INFO_SLAB_CLASS_SIZE => SIZE_CLASSES.get(class).map(|&s| s as u64),
+            INFO_SLAB_HITS => KERNEL_SLABS.class_stats(class).map(|(hits, _)| hits),
+            INFO_SLAB_MISSES => KERNEL_SLABS.class_stats(class).map(|(_, misses)| misses),
+            _ => return None,
+        };
+        Some(value.ok_or(KError::InvalidArgument))
+    }
+}
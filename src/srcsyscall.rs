@@ -0,0 +1,189 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{
+    KError, KIoVec, kbench, kkernel, kmemory, kmessaging, kmsgqueue, kresmap, kresource, ksched, ksync, ktask, ktimepage, ktrace,
+    resource_control, resource_readv, resource_writev, ring_destroy, ring_enter, ring_setup,
+};
+
+// --- Sistem Çağrısı Dağıtım Tablosu ---
+// Sistem çağrıları numarayla indekslenen düz bir fonksiyon işaretçisi tablosundan dağıtılır: sınır kontrolü,
+// bir yükleme ve dolaylı çağrı. Numaralar Sahne64 arch::SYSCALL_* ile EŞLEŞMELİDİR (ABI sözleşmesi).
+//
+// İki giriş yolu aynı tabloya gelir:
+// - Hızlı yol (karnal_syscall_fast): amd64 SYSCALL/SYSRET, armv9 SVC. Mimari stub yalnızca dönüş için
+//   gerekenleri (dönüş adresi, bayraklar, kullanıcı yığıtı) ve çağrının bozabileceği caller-saved yazmaçları
+//   çekirdek yığıtına kaydeder; callee-saved yazmaçları Rust ABI'si korur. Tam yazmaç çerçevesi kurulmaz.
+// - Yavaş yol (handle_syscall): tam çerçeve kaydeden genel tuzak işleyicileri (int 0x80, eski vektörler).
+//
+// İş parçacığı değişimi hızlı yolda da güvenlidir: kullanıcı durumu iş parçacığının kendi çekirdek yığıtındadır
+// ve low_level_context_switch callee-saved yazmaçları kaydeder. Kullanıcı moduna dönmeden önce bekleyen
+// yeniden zamanlama (ksched_preempt_point) yalnızca istenmişse yapılır.
+
+pub mod ksyscall {
+    use super::*;
+
+    extern "C" {
+        fn low_level_syscall_init();
+    }
+
+    // Sistem çağrısı numaraları (Sahne64 arch::SYSCALL_* ile EŞLEŞMELİDİR)
+    pub const SYSCALL_MEMORY_ALLOCATE: u64 = 1;
+    pub const SYSCALL_MEMORY_RELEASE: u64 = 2;
+    pub const SYSCALL_TASK_SPAWN: u64 = 3;
+    pub const SYSCALL_TASK_EXIT: u64 = 4;
+    pub const SYSCALL_RESOURCE_ACQUIRE: u64 = 5;
+    pub const SYSCALL_RESOURCE_READ: u64 = 6;
+    pub const SYSCALL_RESOURCE_WRITE: u64 = 7;
+    pub const SYSCALL_RESOURCE_RELEASE: u64 = 8;
+    pub const SYSCALL_RESOURCE_CONTROL: u64 = 9;
+    pub const SYSCALL_GET_TASK_ID: u64 = 10;
+    pub const SYSCALL_TASK_SLEEP: u64 = 11;
+    pub const SYSCALL_TASK_SLEEP_NS: u64 = 12;
+    pub const SYSCALL_LOCK_CREATE: u64 = 13;
+    pub const SYSCALL_LOCK_ACQUIRE: u64 = 14;
+    pub const SYSCALL_LOCK_RELEASE: u64 = 15;
+    pub const SYSCALL_FUTEX_WAIT: u64 = 16;
+    pub const SYSCALL_FUTEX_WAIT_TIMEOUT: u64 = 17;
+    pub const SYSCALL_FUTEX_WAKE: u64 = 18;
+    pub const SYSCALL_RWLOCK_CREATE: u64 = 19;
+    pub const SYSCALL_RWLOCK_READ_ACQUIRE: u64 = 20;
+    pub const SYSCALL_RWLOCK_READ_RELEASE: u64 = 21;
+    pub const SYSCALL_RWLOCK_WRITE_ACQUIRE: u64 = 22;
+    pub const SYSCALL_RWLOCK_WRITE_RELEASE: u64 = 23;
+    pub const SYSCALL_COND_CREATE: u64 = 24;
+    pub const SYSCALL_COND_WAIT: u64 = 25;
+    pub const SYSCALL_COND_NOTIFY_ONE: u64 = 26;
+    pub const SYSCALL_COND_NOTIFY_ALL: u64 = 27;
+    pub const SYSCALL_MESSAGE_SEND: u64 = 28;
+    pub const SYSCALL_MESSAGE_RECEIVE: u64 = 29;
+    pub const SYSCALL_MESSAGE_SEND_PAGES: u64 = 30;
+    pub const SYSCALL_MESSAGE_CHANNEL_CREATE: u64 = 31;
+    pub const SYSCALL_MESSAGE_ENDPOINT_CREATE: u64 = 32;
+    pub const SYSCALL_MESSAGE_CALL: u64 = 33;
+    pub const SYSCALL_MESSAGE_REPLY_AND_WAIT: u64 = 34;
+    pub const SYSCALL_GET_KERNEL_INFO: u64 = 35;
+    pub const SYSCALL_GET_KERNEL_TIME: u64 = 36;
+    pub const SYSCALL_TIME_PAGE_MAP: u64 = 37;
+    pub const SYSCALL_TASK_YIELD: u64 = 38;
+    pub const SYSCALL_THREAD_CREATE: u64 = 39;
+    pub const SYSCALL_RESOURCE_READV: u64 = 40;
+    pub const SYSCALL_RESOURCE_WRITEV: u64 = 41;
+    pub const SYSCALL_RING_SETUP: u64 = 42;
+    pub const SYSCALL_RING_ENTER: u64 = 43;
+    pub const SYSCALL_RING_DESTROY: u64 = 44;
+    pub const SYSCALL_MEMORY_ALLOCATE_PLACED: u64 = 45;
+    pub const SYSCALL_RESOURCE_MAP: u64 = 46;
+    pub const SYSCALL_RESOURCE_UNMAP: u64 = 47;
+    pub const SYSCALL_BENCH_RUN: u64 = 48;
+    pub const SYSCALL_MESSAGE_ENDPOINT_DESTROY: u64 = 49;
+
+    /// Tablo boyutu (ikinin kuvveti). Bu sayıdan büyük numaralar NotSupported döner.
+    pub const SYSCALL_COUNT: usize = 64;
+
+    /// Tablo girişi: ham kullanıcı argümanları (arg1..arg5) -> sonuç.
+    pub type SyscallFn = fn(u64, u64, u64, u64, u64) -> Result<u64, KError>;
+
+    fn not_supported(_: u64, _: u64, _: u64, _: u64, _: u64) -> Result<u64, KError> {
+        Err(KError::NotSupported)
+    }
+
+    // Girişler ham argümanları dönüştürür; pointer argümanlarını çağrılan fonksiyon her çağrıda çalışan görevin
+    // adres alanına göre doğrular (kmemory::validate_user_range, copy_from_user, copy_to_user).
+    static TABLE: [SyscallFn; SYSCALL_COUNT] = {
+        let mut t = [not_supported as SyscallFn; SYSCALL_COUNT];
+        t[SYSCALL_MEMORY_ALLOCATE as usize] = |size, _, _, _, _| kmemory::allocate_user_memory(size as usize).map(|ptr| ptr as u64);
+        t[SYSCALL_MEMORY_RELEASE as usize] = |ptr, size, _, _, _| kmemory::free_user_memory(ptr as *mut u8, size as usize).map(|_| 0);
+        t[SYSCALL_TASK_SPAWN as usize] = |code, args, len, _, _| ktask::task_spawn(code, args as *const u8, len as usize).map(|tid| tid.0);
+        t[SYSCALL_TASK_EXIT as usize] = |code, _, _, _, _| ktask::task_exit(code as i32);
+        t[SYSCALL_RESOURCE_ACQUIRE as usize] = |id, len, mode, _, _| kresource::resource_acquire(id as *const u8, len as usize, mode as u32).map(|h| h.0);
+        t[SYSCALL_RESOURCE_READ as usize] = |h, buf, len, _, _| kresource::resource_read(h, buf as *mut u8, len as usize).map(|n| n as u64);
+        t[SYSCALL_RESOURCE_WRITE as usize] = |h, buf, len, _, _| kresource::resource_write(h, buf as *const u8, len as usize).map(|n| n as u64);
+        t[SYSCALL_RESOURCE_RELEASE as usize] = |h, _, _, _, _| kresource::resource_release(h).map(|_| 0);
+        t[SYSCALL_RESOURCE_CONTROL as usize] = |h, request, arg, _, _| resource_control(h, request, arg).map(|v| v as u64);
+        t[SYSCALL_GET_TASK_ID as usize] = |_, _, _, _, _| ktask::get_current_task_id().map(|tid| tid.0);
+        t[SYSCALL_TASK_SLEEP as usize] = |ms, _, _, _, _| ktask::task_sleep(ms).map(|_| 0);
+        t[SYSCALL_TASK_SLEEP_NS as usize] = |ns, slack, _, _, _| ktask::task_sleep_ns(ns, slack).map(|_| 0);
+        t[SYSCALL_LOCK_CREATE as usize] = |_, _, _, _, _| ksync::lock_create().map(|h| h.0);
+        t[SYSCALL_LOCK_ACQUIRE as usize] = |h, _, _, _, _| ksync::lock_acquire(h).map(|_| 0);
+        t[SYSCALL_LOCK_RELEASE as usize] = |h, _, _, _, _| ksync::lock_release(h).map(|_| 0);
+        t[SYSCALL_FUTEX_WAIT as usize] = |addr, expected, _, _, _| ksync::futex_wait(addr, expected as u32).map(|_| 0);
+        t[SYSCALL_FUTEX_WAIT_TIMEOUT as usize] = |addr, expected, timeout, _, _| ksync::futex_wait_timeout(addr, expected as u32, timeout).map(|_| 0);
+        t[SYSCALL_FUTEX_WAKE as usize] = |addr, count, _, _, _| ksync::futex_wake(addr, count as u32).map(|n| n as u64);
+        t[SYSCALL_RWLOCK_CREATE as usize] = |_, _, _, _, _| ksync::rwlock_create().map(|h| h.0);
+        t[SYSCALL_RWLOCK_READ_ACQUIRE as usize] = |h, _, _, _, _| ksync::rwlock_read_acquire(h).map(|_| 0);
+        t[SYSCALL_RWLOCK_READ_RELEASE as usize] = |h, _, _, _, _| ksync::rwlock_read_release(h).map(|_| 0);
+        t[SYSCALL_RWLOCK_WRITE_ACQUIRE as usize] = |h, _, _, _, _| ksync::rwlock_write_acquire(h).map(|_| 0);
+        t[SYSCALL_RWLOCK_WRITE_RELEASE as usize] = |h, _, _, _, _| ksync::rwlock_write_release(h).map(|_| 0);
+        t[SYSCALL_COND_CREATE as usize] = |_, _, _, _, _| ksync::cond_create().map(|h| h.0);
+        t[SYSCALL_COND_WAIT as usize] = |cond, lock, _, _, _| ksync::cond_wait(cond, lock).map(|_| 0);
+        t[SYSCALL_COND_NOTIFY_ONE as usize] = |cond, _, _, _, _| ksync::cond_notify_one(cond).map(|_| 0);
+        t[SYSCALL_COND_NOTIFY_ALL as usize] = |cond, _, _, _, _| ksync::cond_notify_all(cond).map(|_| 0);
+        t[SYSCALL_MESSAGE_SEND as usize] = |h, buf, len, _, _| kmessaging::send(h, buf as *const u8, len as usize).map(|_| 0);
+        t[SYSCALL_MESSAGE_RECEIVE as usize] = |h, buf, len, _, _| kmessaging::receive(h, buf as *mut u8, len as usize).map(|n| n as u64);
+        t[SYSCALL_MESSAGE_SEND_PAGES as usize] = |h, buf, len, _, _| kmessaging::send_pages(h, buf as *const u8, len as usize).map(|_| 0);
+        t[SYSCALL_MESSAGE_CHANNEL_CREATE as usize] = |capacity, flags, _, _, _| {
+            kmsgqueue::QueueKind::from_flags(flags as u32).and_then(|kind| kmessaging::create_channel_with(capacity as usize, kind)).map(|h| h.0)
+        };
+        t[SYSCALL_MESSAGE_ENDPOINT_CREATE as usize] = |name, len, _, _, _| kmessaging::create_endpoint(name as *const u8, len as usize).map(|h| h.0);
+        t[SYSCALL_MESSAGE_ENDPOINT_DESTROY as usize] = |h, _, _, _, _| kmessaging::destroy_endpoint(h).map(|_| 0);
+        t[SYSCALL_MESSAGE_CALL as usize] = |h, req, req_len, reply, reply_len| {
+            kmessaging::call(h, req as *const u8, req_len as usize, reply as *mut u8, reply_len as usize).map(|n| n as u64)
+        };
+        t[SYSCALL_MESSAGE_REPLY_AND_WAIT as usize] = |h, reply, reply_len, buf, buf_len| {
+            kmessaging::reply_and_wait(h, reply as *const u8, reply_len as usize, buf as *mut u8, buf_len as usize).map(|n| n as u64)
+        };
+        t[SYSCALL_GET_KERNEL_INFO as usize] = |info, _, _, _, _| kkernel::get_info(info as u32);
+        t[SYSCALL_GET_KERNEL_TIME as usize] = |_, _, _, _, _| kkernel::get_time();
+        t[SYSCALL_TIME_PAGE_MAP as usize] = |_, _, _, _, _| ktimepage::map_current();
+        t[SYSCALL_TASK_YIELD as usize] = |_, _, _, _, _| ktask::yield_now().map(|_| 0);
+        // arg4: CPU ilgi maskesi (0: hepsi)
+        t[SYSCALL_THREAD_CREATE as usize] = |entry, stack, arg, mask, _| ktask::thread_create(entry, stack as usize, arg, mask).map(|tid| tid.0);
+        t[SYSCALL_RESOURCE_READV as usize] = |h, iov, count, _, _| resource_readv(h, iov as *const KIoVec, count as usize).map(|n| n as u64);
+        t[SYSCALL_RESOURCE_WRITEV as usize] = |h, iov, count, _, _| resource_writev(h, iov as *const KIoVec, count as usize).map(|n| n as u64);
+        t[SYSCALL_RING_SETUP as usize] = |entries, flags, out, _, _| ring_setup(entries as u32, flags as u32, out as *mut u64).map(|h| h.0);
+        t[SYSCALL_RING_ENTER as usize] = |h, submit, min, flags, _| ring_enter(h, submit as u32, min as u32, flags as u32).map(|n| n as u64);
+        t[SYSCALL_RING_DESTROY as usize] = |h, _, _, _, _| ring_destroy(h).map(|_| 0);
+        // arg2: KARNAL_MEM_HINT_*
+        t[SYSCALL_MEMORY_ALLOCATE_PLACED as usize] = |size, hint, _, _, _| {
+            kmemory::allocate_user_memory_placed(size as usize, hint as u32).map(|ptr| ptr as u64)
+        };
+        // arg4: KARNAL_MAP_*
+        t[SYSCALL_RESOURCE_MAP as usize] = |h, offset, len, prot, _| kresmap::map(h, offset, len, prot as u32);
+        t[SYSCALL_RESOURCE_UNMAP as usize] = |addr, len, _, _, _| kresmap::unmap(addr, len).map(|_| 0);
+        // arg1: KARNAL_BENCH_* (kbench özelliği olmadan NotSupported, ayrıcalıksız görevden PermissionDenied)
+        t[SYSCALL_BENCH_RUN as usize] = |mask, _, _, _, _| kbench::run(mask as u32).map(|_| 0);
+        t
+    };
+
+    /// Boot CPU'sunun hızlı giriş yolunu kurar (amd64: STAR/LSTAR/FMASK, EFER.SCE). İkincil CPU'lar
+    /// low_level_syscall_init'i kendi başlangıçlarında çağırır.
+    pub fn init_manager() {
+        unsafe { low_level_syscall_init() };
+    }
+
+    /// Sistem çağrısını tablodan çalıştırır ve sonucu kullanıcı alanının beklediği i64'e çevirir
+    /// (başarı >= 0, hata negatif KError).
+    #[inline(always)]
+    pub fn dispatch(number: u64, arg1: u64, arg2: u64, arg3: u64, arg4: u64, arg5: u64) -> i64 {
+        // İzleme: giriş/çıkış kaydı ve çağrı başına gecikme histogramı (ktrace derlenmediyse boştur)
+        let trace_start = ktrace::syscall_enter(number, arg1);
+        let handler = TABLE.get(number as usize).copied().unwrap_or(not_supported);
+        let result = match handler(arg1, arg2, arg3, arg4, arg5) {
+            Ok(value) => value as i64,
+            Err(err) => err as i64,
+        };
+        ktrace::syscall_exit(trace_start, number, result);
+        result
+    }
+
+    /// Hızlı giriş yolu: mimari stub'ı argümanları C ABI'sinin ilk beş yazmacında, numarayı altıncıda verir.
+    /// Kesmeler açık ve çekirdek yığıtındayken çağrılır; dönüşte kullanıcı moduna geçilir.
+    #[no_mangle]
+    pub extern "C" fn karnal_syscall_fast(arg1: u64, arg2: u64, arg3: u64, arg4: u64, arg5: u64, number: u64) -> i64 {
+        let result = dispatch(number, arg1, arg2, arg3, arg4, arg5);
+        ksched::ksched_preempt_point();
+        result
+    }
+}
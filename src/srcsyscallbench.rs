@@ -0,0 +1,392 @@
+#![no_std]
+#![allow(dead_code)]
+
+use core::fmt::Write;
+use core::sync::atomic::{fence, AtomicU32, Ordering};
+
+// --- Kullanıcı Alanı Sistem Çağrısı Ölçümü ---
+// Çekirdek içi kbench (srcbench.rs) sıcak yolları çekirdekte ölçer. Bu istemci aynı yolları kullanıcı
+// alanından ölçer: süreye kullanıcı/çekirdek geçişi (amd64 SYSCALL/SYSRET, armv9 SVC, rv64g ECALL), hızlı
+// giriş stub'ı ve dönüşteki ksched_preempt_point dahildir. kbench ile aynı adlı satırların farkı tuzak
+// yolunun maliyetidir. Sayaç: amd64 rdtsc (lfence ile), armv9 CNTVCT_EL0 (isb ile), rv64g time CSR (rdtime;
+// cycle CSR kullanıcı modunda kapalı olabilir).
+//
+// Ölçümler (tek iş parçacığı): syscall_trap (GET_TASK_ID), messaging_send_receive (kendi kanalına gönderip
+// geri alma), lock_uncontended, memory_alloc_free, resource_map_unmap (karnal://power/battery sayfası) ve
+// thread_yield. Eş iş parçacığı gerektiren lock_contended skipped=NotSupported yazar: karnal_thread_create
+// girişi çekirdek kipinde başlatır, kullanıcı alanında eş açılamaz (kbench ölçer).
+//
+// Sonuçlar karnal://device/console'a kbench ile aynı "KBENCH 1" satırlarıyla yazılır (biçim: srcbench.rs).
+// Sayaç frekansı ölçüm boyunca zaman sayfasının monoton saatiyle kalibre edilir; sayfa yoksa gerçek zaman
+// saatine (GET_KERNEL_TIME) döner. Ölçüm ayrıcalık istemez; karnal_bench_run'dan bağımsızdır.
+
+#[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64", target_arch = "riscv64")))]
+compile_error!("srcsyscallbench: yalnızca amd64, armv9 ve rv64g desteklenir");
+
+#[derive(Debug, Copy, Clone, PartialEq, Eq)]
+#[repr(i64)]
+pub enum BenchError {
+    ConsoleUnavailable = -1,
+    SyscallFailed = -2,
+}
+
+// --- Karnal64 Sistem Çağrı Numaraları (çekirdek ile uyumlu olmalı) ---
+pub const SYSCALL_MEMORY_ALLOCATE: u64 = 1;
+pub const SYSCALL_MEMORY_RELEASE: u64 = 2;
+pub const SYSCALL_RESOURCE_ACQUIRE: u64 = 5;
+pub const SYSCALL_RESOURCE_WRITE: u64 = 7;
+pub const SYSCALL_RESOURCE_RELEASE: u64 = 8;
+pub const SYSCALL_GET_TASK_ID: u64 = 10;
+pub const SYSCALL_LOCK_CREATE: u64 = 13;
+pub const SYSCALL_LOCK_ACQUIRE: u64 = 14;
+pub const SYSCALL_LOCK_RELEASE: u64 = 15;
+pub const SYSCALL_MESSAGE_SEND: u64 = 28;
+pub const SYSCALL_MESSAGE_RECEIVE: u64 = 29;
+pub const SYSCALL_MESSAGE_CHANNEL_CREATE: u64 = 31;
+pub const SYSCALL_GET_KERNEL_INFO: u64 = 35;
+pub const SYSCALL_GET_KERNEL_TIME: u64 = 36;
+pub const SYSCALL_TIME_PAGE_MAP: u64 = 37;
+pub const SYSCALL_TASK_YIELD: u64 = 38;
+pub const SYSCALL_RESOURCE_MAP: u64 = 46;
+pub const SYSCALL_RESOURCE_UNMAP: u64 = 47;
+
+// karnal.h ile aynı değerler
+const RESOURCE_MODE_READ: u32 = 1 << 0;
+const RESOURCE_MODE_WRITE: u32 = 1 << 1;
+const MAP_READ: u32 = 1 << 0;
+const CLOCK_NONE: u32 = 0;
+const INFO_BOOT_CPUS_JOINED: u64 = 0xE01;
+const KERROR_NOT_SUPPORTED: i64 = -38;
+
+const RESOURCE_CONSOLE: &[u8] = b"karnal://device/console";
+const RESOURCE_BATTERY: &[u8] = b"karnal://power/battery"; // Salt okunur, tek sayfalık haritalanabilir blok
+
+const PAGE_SIZE: u64 = 4096;
+const ALLOC_SIZE: u64 = 64; // Görevin dilim kümesinden (srcslab.rs) karşılanan küçük tahsis
+
+// kbench ile aynı örnekleme: her örnek `batch` çağrının ortalaması
+const SAMPLES: usize = 512;
+const MAX_BATCH: usize = 32;
+
+#[cfg(target_arch = "x86_64")]
+const ARCH: &str = "amd64";
+#[cfg(target_arch = "aarch64")]
+const ARCH: &str = "armv9";
+#[cfg(target_arch = "riscv64")]
+const ARCH: &str = "rv64g";
+
+#[cfg(target_arch = "x86_64")]
+const COUNTER: &str = "tsc";
+#[cfg(target_arch = "aarch64")]
+const COUNTER: &str = "cntvct";
+#[cfg(target_arch = "riscv64")]
+const COUNTER: &str = "time";
+
+/// Paylaşımlı zaman sayfası (karnal.h KarnalTimePage_t, salt okunur).
+#[repr(C)]
+struct TimePage {
+    seq: AtomicU32,
+    clock_source: u32,
+    counter_base: u64,
+    mono_base_ns: u64,
+    mult: u64,
+    shift: u32,
+    reserved: u32,
+    realtime_offset_ns: u64,
+}
+
+/// Ölçümleri çalıştırır ve sonuçları konsola yazar.
+pub fn run() -> Result<(), BenchError> {
+    let console = sys_call4(SYSCALL_RESOURCE_ACQUIRE, RESOURCE_CONSOLE.as_ptr() as u64, RESOURCE_CONSOLE.len() as u64, RESOURCE_MODE_WRITE as u64, 0);
+    if console < 0 {
+        return Err(BenchError::ConsoleUnavailable);
+    }
+    let console = console as u64;
+    let result = run_on(console);
+    let _ = sys_call4(SYSCALL_RESOURCE_RELEASE, console, 0, 0, 0);
+    result
+}
+
+fn run_on(console: u64) -> Result<(), BenchError> {
+    let page = match sys_call4(SYSCALL_TIME_PAGE_MAP, 0, 0, 0, 0) {
+        addr if addr > 0 => Some(unsafe { &*(addr as u64 as *const TimePage) }),
+        _ => None,
+    };
+    let start_counter = read_counter();
+    let start_ns = clock_ns(page);
+    let cpus = sys_call4(SYSCALL_GET_KERNEL_INFO, INFO_BOOT_CPUS_JOINED, 0, 0, 0);
+    emit(console, format_args!("arch={} counter={} cpus={}", ARCH, COUNTER, cpus.max(1)));
+
+    let mut samples = [0u64; SAMPLES];
+    // Boş çağrı çalışmıyorsa diğer ölçümler de anlamsızdır
+    if !measure(console, &mut samples, "syscall_trap", MAX_BATCH, || check(sys_call4(SYSCALL_GET_TASK_ID, 0, 0, 0, 0)), || {}) {
+        return Err(BenchError::SyscallFailed);
+    }
+    bench_messaging(console, &mut samples);
+    bench_lock(console, &mut samples);
+    bench_memory(console, &mut samples);
+    bench_map(console, &mut samples);
+    measure(console, &mut samples, "thread_yield", MAX_BATCH, || check(sys_call4(SYSCALL_TASK_YIELD, 0, 0, 0, 0)), || {});
+
+    let elapsed_ns = clock_ns(page).saturating_sub(start_ns).max(1);
+    let ticks = read_counter().wrapping_sub(start_counter);
+    let hz = (ticks as u128 * 1_000_000_000 / elapsed_ns as u128) as u64;
+    emit(console, format_args!("end hz={}", hz));
+    Ok(())
+}
+
+// --- Ölçümler ---
+
+fn bench_messaging(console: u64, samples: &mut [u64; SAMPLES]) {
+    // Tek üretici/tek tüketici kanalı (flags 0); mesaj kuyrukta beklediği için receive bloklamaz
+    let channel = sys_call4(SYSCALL_MESSAGE_CHANNEL_CREATE, 4, 0, 0, 0);
+    if channel < 0 {
+        emit(console, format_args!("bench=messaging_send_receive skipped={}", channel));
+        return;
+    }
+    let channel = channel as u64;
+    let mut message = [0u8; 8];
+    let buf = message.as_mut_ptr() as u64;
+    measure(console, samples, "messaging_send_receive", MAX_BATCH, || {
+        check(sys_call4(SYSCALL_MESSAGE_SEND, channel, buf, 8, 0))?;
+        check(sys_call4(SYSCALL_MESSAGE_RECEIVE, channel, buf, 8, 0))
+    }, || {});
+    let _ = sys_call4(SYSCALL_RESOURCE_RELEASE, channel, 0, 0, 0);
+}
+
+fn bench_lock(console: u64, samples: &mut [u64; SAMPLES]) {
+    let lock = sys_call4(SYSCALL_LOCK_CREATE, 0, 0, 0, 0);
+    if lock < 0 {
+        emit(console, format_args!("bench=lock_uncontended skipped={}", lock));
+    } else {
+        let lock = lock as u64;
+        measure(console, samples, "lock_uncontended", MAX_BATCH, || {
+            check(sys_call4(SYSCALL_LOCK_ACQUIRE, lock, 0, 0, 0))?;
+            check(sys_call4(SYSCALL_LOCK_RELEASE, lock, 0, 0, 0))
+        }, || {});
+        let _ = sys_call4(SYSCALL_RESOURCE_RELEASE, lock, 0, 0, 0);
+    }
+    emit(console, format_args!("bench=lock_contended skipped={}", KERROR_NOT_SUPPORTED));
+}
+
+fn bench_memory(console: u64, samples: &mut [u64; SAMPLES]) {
+    measure(console, samples, "memory_alloc_free", MAX_BATCH, || {
+        let ptr = check_value(sys_call4(SYSCALL_MEMORY_ALLOCATE, ALLOC_SIZE, 0, 0, 0))?;
+        check(sys_call4(SYSCALL_MEMORY_RELEASE, ptr, ALLOC_SIZE, 0, 0))
+    }, || {});
+}
+
+fn bench_map(console: u64, samples: &mut [u64; SAMPLES]) {
+    let resource = sys_call4(SYSCALL_RESOURCE_ACQUIRE, RESOURCE_BATTERY.as_ptr() as u64, RESOURCE_BATTERY.len() as u64, RESOURCE_MODE_READ as u64, 0);
+    if resource < 0 {
+        emit(console, format_args!("bench=resource_map_unmap skipped={}", resource));
+        return;
+    }
+    let resource = resource as u64;
+    // Eşleme + kaldırma (TLB geçersizleştirme dahil) birlikte ölçülür; sanal adresler yeniden kullanılmaz,
+    // takım pencerenin yalnızca küçük bir kısmını tüketir
+    measure(console, samples, "resource_map_unmap", 1, || {
+        let addr = check_value(sys_call4(SYSCALL_RESOURCE_MAP, resource, 0, PAGE_SIZE, MAP_READ as u64))?;
+        check(sys_call4(SYSCALL_RESOURCE_UNMAP, addr, PAGE_SIZE, 0, 0))
+    }, || {});
+    let _ = sys_call4(SYSCALL_RESOURCE_RELEASE, resource, 0, 0, 0);
+}
+
+/// Her örnekte `op`'u `batch` kez çalıştırır ve sonucu yazar (kbench measure ile aynı). `reset` her
+/// örnekten sonra süre dışında çalışır. `op` hata dönerse ölçüm atlanır ve false döner.
+fn measure(
+    console: u64,
+    samples: &mut [u64; SAMPLES],
+    name: &str,
+    batch: usize,
+    mut op: impl FnMut() -> Result<(), i64>,
+    mut reset: impl FnMut(),
+) -> bool {
+    // Isınma: önbellekler ve dal tahmini
+    for _ in 0..batch {
+        if let Err(err) = op() {
+            reset();
+            emit(console, format_args!("bench={} skipped={}", name, err));
+            return false;
+        }
+    }
+    reset();
+    for sample in samples.iter_mut() {
+        let start = read_counter();
+        for _ in 0..batch {
+            if let Err(err) = op() {
+                reset();
+                emit(console, format_args!("bench={} skipped={}", name, err));
+                return false;
+            }
+        }
+        *sample = read_counter().wrapping_sub(start) / batch as u64;
+        reset();
+    }
+    samples.sort_unstable();
+    emit(console, format_args!(
+        "bench={} batch={} samples={} min={} p50={} p90={} p99={} max={}",
+        name, batch, SAMPLES, samples[0], percentile(&samples[..], 50), percentile(&samples[..], 90),
+        percentile(&samples[..], 99), samples[SAMPLES - 1],
+    ));
+    true
+}
+
+fn check(ret: i64) -> Result<(), i64> {
+    check_value(ret).map(|_| ())
+}
+
+fn check_value(ret: i64) -> Result<u64, i64> {
+    if ret < 0 { Err(ret) } else { Ok(ret as u64) }
+}
+
+/// Sıralanmış örneklerden yüzdelik (en yakın sıra yöntemi, kbench ile aynı).
+fn percentile(sorted: &[u64], pct: usize) -> u64 {
+    let rank = (sorted.len() * pct + 99) / 100;
+    sorted[rank.max(1) - 1]
+}
+
+// --- Saat ---
+
+/// Kalibrasyon saati (ns): zaman sayfasının monoton saati, sayfa yoksa gerçek zaman saati.
+fn clock_ns(page: Option<&TimePage>) -> u64 {
+    page.and_then(monotonic_ns)
+        .unwrap_or_else(|| sys_call4(SYSCALL_GET_KERNEL_TIME, 0, 0, 0, 0).max(0) as u64)
+}
+
+/// Monoton süreyi sayfadan okur (karnal.h karnal_time_page_read ile aynı seqlock). Sayfanın saat kaynağı
+/// bu mimarinin sayacıdır; kaynak yoksa None.
+fn monotonic_ns(page: &TimePage) -> Option<u64> {
+    loop {
+        let seq = page.seq.load(Ordering::Acquire);
+        if seq & 1 != 0 {
+            continue; // Güncelleniyor
+        }
+        let (source, counter_base, mono_base_ns, mult, shift) = unsafe {
+            (
+                core::ptr::read_volatile(&page.clock_source),
+                core::ptr::read_volatile(&page.counter_base),
+                core::ptr::read_volatile(&page.mono_base_ns),
+                core::ptr::read_volatile(&page.mult),
+                core::ptr::read_volatile(&page.shift),
+            )
+        };
+        let counter = read_counter();
+        fence(Ordering::Acquire);
+        if page.seq.load(Ordering::Relaxed) != seq {
+            continue;
+        }
+        if source == CLOCK_NONE {
+            return None;
+        }
+        return Some(mono_base_ns + ((counter.wrapping_sub(counter_base) as u128 * mult as u128) >> shift) as u64);
+    }
+}
+
+/// Mimarinin sayacını okur. Önceki komutlar bitmeden okunmaz.
+#[inline(always)]
+fn read_counter() -> u64 {
+    #[cfg(target_arch = "x86_64")]
+    unsafe {
+        core::arch::x86_64::_mm_lfence();
+        core::arch::x86_64::_rdtsc()
+    }
+    #[cfg(target_arch = "aarch64")]
+    {
+        let count: u64;
+        unsafe { core::arch::asm!("isb", "mrs {}, cntvct_el0", out(reg) count, options(nostack)) };
+        count
+    }
+    #[cfg(target_arch = "riscv64")]
+    {
+        let count: u64;
+        // Sıralama: önceki yüklemeler sayaçtan önce tamamlansın
+        unsafe { core::arch::asm!("fence iorw, iorw", "rdtime {}", out(reg) count, options(nostack)) };
+        count
+    }
+}
+
+// --- Çıktı ---
+
+/// Tek bir çıktı satırı; taşan kısım kesilir.
+struct Line {
+    buf: [u8; 192],
+    len: usize,
+}
+
+impl Write for Line {
+    fn write_str(&mut self, s: &str) -> core::fmt::Result {
+        let count = s.len().min(self.buf.len() - self.len);
+        self.buf[self.len..self.len + count].copy_from_slice(&s.as_bytes()[..count]);
+        self.len += count;
+        Ok(())
+    }
+}
+
+fn emit(console: u64, args: core::fmt::Arguments) {
+    let mut line = Line { buf: [0; 192], len: 0 };
+    let _ = line.write_str("KBENCH 1 ");
+    let _ = line.write_fmt(args);
+    let _ = line.write_str("\n");
+    let _ = sys_call4(SYSCALL_RESOURCE_WRITE, console, line.buf.as_ptr() as u64, line.len as u64, 0);
+}
+
+// Dört argümanlı genel çağrı. Ham sonucu döner.
+// x86-64: numara rax, argümanlar rdi, rsi, rdx, r10; syscall rcx ve r11'i bozar.
+#[cfg(target_arch = "x86_64")]
+#[inline(always)]
+fn sys_call4(number: u64, arg1: u64, arg2: u64, arg3: u64, arg4: u64) -> i64 {
+    let ret: i64;
+    unsafe {
+        core::arch::asm!(
+            "syscall",
+            inlateout("rax") number as i64 => ret,
+            in("rdi") arg1,
+            in("rsi") arg2,
+            in("rdx") arg3,
+            in("r10") arg4,
+            out("rcx") _,
+            out("r11") _,
+            options(nostack)
+        );
+    }
+    ret
+}
+
+// AArch64: numara x8, argümanlar x0-x3, sonuç x0 (svc #0).
+#[cfg(target_arch = "aarch64")]
+#[inline(always)]
+fn sys_call4(number: u64, arg1: u64, arg2: u64, arg3: u64, arg4: u64) -> i64 {
+    let ret: i64;
+    unsafe {
+        core::arch::asm!(
+            "svc #0",
+            in("x8") number,
+            inlateout("x0") arg1 as i64 => ret,
+            in("x1") arg2,
+            in("x2") arg3,
+            in("x3") arg4,
+            options(nostack)
+        );
+    }
+    ret
+}
+
+// RISC-V: numara a7, argümanlar a0-a3, sonuç a0 (ecall).
+#[cfg(target_arch = "riscv64")]
+#[inline(always)]
+fn sys_call4(number: u64, arg1: u64, arg2: u64, arg3: u64, arg4: u64) -> i64 {
+    let ret: i64;
+    unsafe {
+        core::arch::asm!(
+            "ecall",
+            in("a7") number,
+            inlateout("a0") arg1 as i64 => ret,
+            in("a1") arg2,
+            in("a2") arg3,
+            in("a3") arg4,
+            options(nostack)
+        );
+    }
+    ret
+}
@@ -0,0 +1,475 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, kbuddy, ksched};
+
+// --- Bellek Katmanları ve NUMA Yerleşimi (karnal_memory_allocate_placed) ---
+// Önyükleme kodu, katmanı bilinen bellek aralıklarını (ACPI SRAT/HMAT, DTB `memory` düğümleri) düğüm ve
+// katman bilgisiyle kmem_phys_add_tier_region ile ekler. Her (düğüm, katman) çiftinin kendi buddy havuzu
+// vardır (kbuddy::Pool); bu bellek genel zone'lara girmez, böylece kıt HBM/GDDR çekirdek tahsislerinde
+// tükenmez. Katmanı bilinmeyen bellek eskisi gibi kmem_phys_add_region ile genel zone'lara gider.
+//
+// Tahsis, yerleşim ipucunun katman sırasını izler ve çalışan CPU'nun düğümünden başlar:
+// - BANDWIDTH: HBM, GDDR, DDR, LPDDR      - LATENCY:   DDR, LPDDR, HBM, GDDR (önce tüm yerel katmanlar)
+// - CAPACITY:  en çok boş belleği olan katmandan başlayarak   - LOW_POWER: LPDDR, DDR, GDDR, HBM
+// - DEFAULT:   önce genel zone'lar, sonra DDR, LPDDR, GDDR, HBM
+// LATENCY dışındaki ipuçları bir katmanı tüm düğümlerde denemeden sonrakine geçmez. Katman havuzları
+// tükenince genel zone'lara düşülür. STRICT başka katmana, LOCAL_NODE başka düğüme düşmeyi yasaklar.
+//
+// Kullanıcı belleği (karnal_memory_allocate) azalan order'lı bitişik bloklardan kurulur ve görevin heap
+// penceresine kmem_virt_map_range ile eşlenir; 2 MiB hizalı bloklar büyük sayfalarla eşlenebilir.
+// Her tahsis görevin kayıt tablosuna yazılır; serbest bırakma yalnızca kayıtlı tahsisleri kabul eder ve
+// görev çıkarken kalanlar iade edilir. SLAB_MAX_SIZE'a kadar olan DEFAULT tahsisler buraya gelmez,
+// görevin dilim kümesinden karşılanır (kslab::user_alloc).
+
+pub mod ktier {
+    use super::*;
+    use core::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+    use kbuddy::Pool;
+    use spin::Mutex;
+
+    // Katmanlar (kernel_memory.h'deki KMEM_TIER_* ile EŞLEŞMELİDİR)
+    pub const TIER_DDR: u32 = 0;
+    pub const TIER_LPDDR: u32 = 1;
+    pub const TIER_HBM: u32 = 2;
+    pub const TIER_GDDR: u32 = 3;
+    pub const NUM_TIERS: usize = 4;
+
+    /// Desteklenen en fazla NUMA düğümü
+    pub const MAX_NODES: usize = 8;
+    // Katman aralığı tablosunun boyutu (serbest bırakmada adresin havuzunu bulmak için)
+    const MAX_RANGES: usize = 32;
+    const MAX_CPUS: usize = ksched::MAX_CPUS;
+
+    // Yerleşim ipuçları (karnal.h'deki KARNAL_MEM_HINT_* ile EŞLEŞMELİDİR)
+    pub const HINT_DEFAULT: u32 = 0;
+    pub const HINT_BANDWIDTH: u32 = 1;
+    pub const HINT_LATENCY: u32 = 2;
+    pub const HINT_CAPACITY: u32 = 3;
+    pub const HINT_LOW_POWER: u32 = 4;
+    const HINT_KIND_MASK: u32 = 0xFF;
+    /// Tercih edilen ilk katman dışına düşme
+    pub const HINT_STRICT: u32 = 1 << 8;
+    /// Yalnızca çalışan CPU'nun düğümünden tahsis et
+    pub const HINT_LOCAL_NODE: u32 = 1 << 9;
+    const HINT_FLAGS: u32 = HINT_STRICT | HINT_LOCAL_NODE;
+
+    // İpucu başına katman sırası (CAPACITY çalışma anında boş belleğe göre sıralanır)
+    const TIER_ORDER: [[u32; NUM_TIERS]; 5] = [
+        [TIER_DDR, TIER_LPDDR, TIER_GDDR, TIER_HBM],  // DEFAULT
+        [TIER_HBM, TIER_GDDR, TIER_DDR, TIER_LPDDR],  // BANDWIDTH
+        [TIER_DDR, TIER_LPDDR, TIER_HBM, TIER_GDDR],  // LATENCY
+        [TIER_DDR, TIER_LPDDR, TIER_GDDR, TIER_HBM],  // CAPACITY
+        [TIER_LPDDR, TIER_DDR, TIER_GDDR, TIER_HBM],  // LOW_POWER
+    ];
+
+    const PAGE_SHIFT: u32 = 12;
+    const PAGE_SIZE: u64 = 1 << PAGE_SHIFT; // KERNEL_PAGE_SIZE
+    const MAX_ORDER: u32 = kbuddy::MAX_ORDER as u32;
+
+    // Kullanıcı heap penceresi (halka ve zaman sayfası pencerelerinin altı)
+    const USER_HEAP_BASE: u64 = 0x0000_6000_0000_0000;
+    const USER_HEAP_END: u64 = 0x0000_7000_0000_0000;
+
+    // kernel_memory.h'deki KMEM_PAGE_* bayrakları
+    const KMEM_PAGE_READ: u32 = 1 << 0;
+    const KMEM_PAGE_WRITE: u32 = 1 << 1;
+    const KMEM_PAGE_USER: u32 = 1 << 3;
+
+    extern "C" {
+        fn low_level_cpu_id() -> u32;
+        fn kmem_phys_alloc_frames(order: u32) -> u64;
+        fn kmem_phys_free_frames(addr: u64, order: u32);
+        fn kmem_virt_map_range(vaddr: u64, paddr: u64, size: usize, flags: u32) -> i64;
+        fn kmem_virt_unmap_range(vaddr: u64, size: usize) -> i64;
+        fn kmem_virt_translate(vaddr: u64) -> u64;
+    }
+
+    const POOL_ROW: [Pool; NUM_TIERS] = [Pool::EMPTY, Pool::EMPTY, Pool::EMPTY, Pool::EMPTY];
+    static POOLS: [[Pool; NUM_TIERS]; MAX_NODES] = [POOL_ROW; MAX_NODES];
+
+    #[derive(Clone, Copy)]
+    struct Range {
+        start: u64,
+        end: u64, // Hariç
+        node: u8,
+        tier: u8,
+    }
+
+    struct Ranges {
+        entries: [Range; MAX_RANGES],
+        count: usize,
+    }
+
+    static RANGES: Mutex<Ranges> = Mutex::new(Ranges {
+        entries: [Range { start: 0, end: 0, node: 0, tier: 0 }; MAX_RANGES],
+        count: 0,
+    });
+    // Kayıtlı düğüm sayısı (en büyük düğüm numarası + 1)
+    static NODES: AtomicU32 = AtomicU32::new(1);
+
+    const ZERO_U32: AtomicU32 = AtomicU32::new(0);
+    static CPU_NODE: [AtomicU32; MAX_CPUS] = [ZERO_U32; MAX_CPUS];
+
+    const ZERO_U64: AtomicU64 = AtomicU64::new(0);
+    // Görev başına heap imleci (0: henüz tahsis yok). Sanal adresler yeniden kullanılmaz.
+    static HEAP_NEXT: [AtomicU64; ksched::MAX_TASKS] = [ZERO_U64; ksched::MAX_TASKS];
+
+    // Görev başına canlı heap tahsisi sayısı üst sınırı
+    const MAX_EXTENTS: usize = 64;
+
+    // Bir heap tahsisinin kaydı. Serbest bırakma yalnızca tam olarak kaydedilmiş (adres, sayfa sayısı)
+    // çiftini kabul eder; böylece kullanıcı başka bir eşlemenin frame'lerini iade ettiremez.
+    #[derive(Clone, Copy)]
+    struct Extent {
+        start: u64, // 0: yer ayrıldı, henüz eşlenmedi
+        pages: u64, // 0: boş girdi
+    }
+
+    const NO_EXTENT: Extent = Extent { start: 0, pages: 0 };
+    static EXTENTS: [Mutex<[Extent; MAX_EXTENTS]>; ksched::MAX_TASKS] =
+        [const { Mutex::new([NO_EXTENT; MAX_EXTENTS]) }; ksched::MAX_TASKS];
+
+    // İstatistikler: KARNAL_INFO_MEM_* ile dışarı verilir (frame cinsinden tutulur, byte olarak verilir).
+    static TOTAL_FRAMES: [AtomicU64; NUM_TIERS] = [ZERO_U64; NUM_TIERS];
+    static USED_FRAMES: [AtomicU64; NUM_TIERS] = [ZERO_U64; NUM_TIERS];
+    static FALLBACKS: AtomicU64 = AtomicU64::new(0);
+    static REMOTE: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_MEM_* ile EŞLEŞMELİDİR)
+    pub const INFO_MEM_TIER_TOTAL: u32 = 0xC00; // | katman
+    pub const INFO_MEM_TIER_USED: u32 = 0xC10;  // | katman
+    pub const INFO_MEM_FALLBACKS: u32 = 0xC20;
+    pub const INFO_MEM_REMOTE: u32 = 0xC21;
+
+    /// `kkernel::get_info` için: bellek katmanı istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        let tier = (info_type & 0xF) as usize;
+        match info_type {
+            INFO_MEM_FALLBACKS => Some(FALLBACKS.load(Ordering::Relaxed)),
+            INFO_MEM_REMOTE => Some(REMOTE.load(Ordering::Relaxed)),
+            _ if tier < NUM_TIERS && info_type & !0xF == INFO_MEM_TIER_TOTAL => {
+                Some(TOTAL_FRAMES[tier].load(Ordering::Relaxed) << PAGE_SHIFT)
+            }
+            _ if tier < NUM_TIERS && info_type & !0xF == INFO_MEM_TIER_USED => {
+                Some(USED_FRAMES[tier].load(Ordering::Relaxed) << PAGE_SHIFT)
+            }
+            _ => None,
+        }
+    }
+
+    /// Katmanı ve düğümü bilinen bir fiziksel aralığı ekler. Önyüklemede, SMP başlamadan çağrılır.
+    pub fn add_region(base: u64, size: u64, node: u32, tier: u32) -> Result<(), KError> {
+        if node as usize >= MAX_NODES || tier as usize >= NUM_TIERS || size == 0 {
+            return Err(KError::InvalidArgument);
+        }
+        let mut ranges = RANGES.lock();
+        if ranges.count == MAX_RANGES {
+            return Err(KError::OutOfMemory);
+        }
+        let end = base.checked_add(size).ok_or(KError::InvalidArgument)?;
+        let frames = POOLS[node as usize][tier as usize].add_region(base, size);
+        if frames == 0 {
+            return Err(KError::InvalidArgument); // Sayfa sınırlarına kırpılınca boş kaldı
+        }
+        let n = ranges.count;
+        ranges.entries[n] = Range { start: base, end, node: node as u8, tier: tier as u8 };
+        ranges.count += 1;
+        TOTAL_FRAMES[tier as usize].fetch_add(frames, Ordering::Relaxed);
+        NODES.fetch_max(node + 1, Ordering::Relaxed);
+        Ok(())
+    }
+
+    /// CPU'nun bağlı olduğu düğümü kaydeder (SRAT/DTB `numa-node-id`). Kaydedilmeyen CPU'lar düğüm 0'dadır.
+    pub fn set_cpu_node(cpu: u32, node: u32) -> Result<(), KError> {
+        if cpu as usize >= MAX_CPUS || node as usize >= MAX_NODES {
+            return Err(KError::InvalidArgument);
+        }
+        CPU_NODE[cpu as usize].store(node, Ordering::Relaxed);
+        Ok(())
+    }
+
+    fn current_node() -> usize {
+        let cpu = (unsafe { low_level_cpu_id() } as usize).min(MAX_CPUS - 1);
+        CPU_NODE[cpu].load(Ordering::Relaxed) as usize
+    }
+
+    // İpucunun katman sırası. CAPACITY için katmanlar boş frame sayısına göre azalan sıralanır.
+    fn tier_order(kind: u32) -> [u32; NUM_TIERS] {
+        let mut order = TIER_ORDER[kind as usize];
+        if kind == HINT_CAPACITY {
+            let free = |tier: u32| TOTAL_FRAMES[tier as usize].load(Ordering::Relaxed)
+                - USED_FRAMES[tier as usize].load(Ordering::Relaxed);
+            // Kararlı sıralama: eşitlikte tablo sırası korunur
+            for i in 1..NUM_TIERS {
+                let mut j = i;
+                while j > 0 && free(order[j]) > free(order[j - 1]) {
+                    order.swap(j, j - 1);
+                    j -= 1;
+                }
+            }
+        }
+        order
+    }
+
+    fn try_pool(order: u32, node: usize, tier: u32) -> u64 {
+        let addr = POOLS[node][tier as usize].alloc(order);
+        if addr != 0 {
+            USED_FRAMES[tier as usize].fetch_add(1 << order, Ordering::Relaxed);
+        }
+        addr
+    }
+
+    /// İpucuna göre fiziksel olarak bitişik 2^order frame tahsis eder.
+    pub fn alloc_frames(order: u32, hint: u32) -> Result<u64, KError> {
+        let kind = hint & HINT_KIND_MASK;
+        if kind > HINT_LOW_POWER || hint & !(HINT_KIND_MASK | HINT_FLAGS) != 0 || order > MAX_ORDER {
+            return Err(KError::InvalidArgument);
+        }
+        let strict = hint & HINT_STRICT != 0;
+        if kind == HINT_DEFAULT {
+            let addr = unsafe { kmem_phys_alloc_frames(order) };
+            if addr != 0 || strict {
+                return if addr != 0 { Ok(addr) } else { Err(KError::OutOfMemory) };
+            }
+        }
+
+        let local = current_node();
+        // Düğüm numaraları yerel düğümden başlayarak dolaşılır
+        let total = (NODES.load(Ordering::Relaxed) as usize).max(local + 1);
+        let nodes = if hint & HINT_LOCAL_NODE != 0 { 1 } else { total };
+        let tiers = tier_order(kind);
+        let tier_count = if strict { 1 } else { NUM_TIERS };
+        // LATENCY yerel düğümü katmandan önce tutar; diğerleri katmanı düğümden önce
+        let node_major = kind == HINT_LATENCY;
+        let (outer, inner) = if node_major { (nodes, tier_count) } else { (tier_count, nodes) };
+        for i in 0..outer {
+            for j in 0..inner {
+                let (n, t) = if node_major { (i, j) } else { (j, i) };
+                let node = (local + n) % total;
+                let addr = try_pool(order, node, tiers[t]);
+                if addr != 0 {
+                    if t != 0 {
+                        FALLBACKS.fetch_add(1, Ordering::Relaxed);
+                    }
+                    if n != 0 {
+                        REMOTE.fetch_add(1, Ordering::Relaxed);
+                    }
+                    return Ok(addr);
+                }
+            }
+        }
+
+        if strict || kind == HINT_DEFAULT {
+            return Err(KError::OutOfMemory);
+        }
+        // Katman havuzları tükendi: genel zone'lar
+        let addr = unsafe { kmem_phys_alloc_frames(order) };
+        if addr == 0 {
+            return Err(KError::OutOfMemory);
+        }
+        FALLBACKS.fetch_add(1, Ordering::Relaxed);
+        Ok(addr)
+    }
+
+    /// `alloc_frames` ile tahsis edilmiş bloğu ait olduğu havuza (katman havuzu veya genel zone'lar) iade eder.
+    pub fn free_frames(addr: u64, order: u32) {
+        let range = {
+            let ranges = RANGES.lock();
+            ranges.entries[..ranges.count].iter().copied().find(|r| addr >= r.start && addr < r.end)
+        };
+        match range {
+            Some(r) => {
+                if POOLS[r.node as usize][r.tier as usize].free(addr, order) {
+                    USED_FRAMES[r.tier as usize].fetch_sub(1 << order, Ordering::Relaxed);
+                }
+            }
+            None => unsafe { kmem_phys_free_frames(addr, order) },
+        }
+    }
+
+    // Kalan sayfaların bir sonraki bloğu: önce MAX_ORDER bloklar, sonra kalanın ikili basamakları (azalan).
+    // Tahsis ve serbest bırakma aynı ayrıştırmayı izler; kayıtlı bir tahsisin blokları sayfa sayısından çıkar.
+    fn next_order(remaining: u64) -> u32 {
+        if remaining >= 1 << MAX_ORDER { MAX_ORDER } else { 63 - remaining.leading_zeros() }
+    }
+
+    // `size` byte'ı kapsayan sayfa sayısı; taşan boyutlar reddedilir
+    fn page_count(size: usize) -> Result<u64, KError> {
+        match (size as u64).checked_add(PAGE_SIZE - 1) {
+            Some(end) if size != 0 => Ok(end >> PAGE_SHIFT),
+            _ => Err(KError::InvalidArgument),
+        }
+    }
+
+    // [vaddr, vaddr + ilk `pages` sayfa) aralığındaki blokların eşlemesini kaldırır ve frame'leri iade eder.
+    // Yalnızca bu modülün eşlediği aralıklar için çağrılır (kayıtlı tahsisler veya yarım kalmış bir tahsis).
+    fn release_blocks(vaddr: u64, pages: u64) -> Result<(), KError> {
+        let mut va = vaddr;
+        let mut remaining = pages;
+        while remaining > 0 {
+            let order = next_order(remaining);
+            let bytes = PAGE_SIZE << order;
+            let paddr = unsafe { kmem_virt_translate(va) };
+            if paddr == 0 {
+                return Err(KError::BadAddress);
+            }
+            if unsafe { kmem_virt_unmap_range(va, bytes as usize) } != 0 {
+                return Err(KError::BadAddress);
+            }
+            free_frames(paddr, order);
+            va += bytes;
+            remaining -= 1 << order;
+        }
+        Ok(())
+    }
+
+    /// Çalışan görev için ipucuna göre yerleştirilmiş, sıfırlanmış kullanıcı belleği tahsis eder
+    /// ve kullanıcı adresini döner.
+    pub fn allocate_user(size: usize, hint: u32) -> Result<u64, KError> {
+        let pages = page_count(size)?;
+        if pages > (USER_HEAP_END - USER_HEAP_BASE) >> PAGE_SHIFT {
+            return Err(KError::OutOfMemory);
+        }
+        let task = ksched::current_task() as usize;
+        if task >= ksched::MAX_TASKS {
+            return Err(KError::InternalError);
+        }
+
+        // Kayıt yeri eşlemeden önce ayrılır: tablo doluysa hiçbir frame tahsis edilmez
+        let slot = {
+            let mut extents = EXTENTS[task].lock();
+            let slot = extents.iter().position(|e| e.pages == 0).ok_or(KError::OutOfMemory)?;
+            extents[slot] = Extent { start: 0, pages };
+            slot
+        };
+        let result = map_user(task, pages, hint);
+        let mut extents = EXTENTS[task].lock();
+        match result {
+            Ok(start) => extents[slot].start = start,
+            Err(_) => extents[slot] = NO_EXTENT,
+        }
+        result
+    }
+
+    // Görevin heap penceresinde `pages` sayfalık aralık ayırır, sıfırlanmış bloklarla eşler ve adresini döner.
+    fn map_user(task: usize, pages: u64, hint: u32) -> Result<u64, KError> {
+        // Pencereyi ilk (en büyük) bloğun boyutuna hizala: sonraki bloklar da kendi boyutlarına hizalı kalır
+        let align = PAGE_SIZE << next_order(pages);
+        let bytes = pages << PAGE_SHIFT;
+        let mut start = 0;
+        HEAP_NEXT[task]
+            .fetch_update(Ordering::Relaxed, Ordering::Relaxed, |next| {
+                let base = if next == 0 { USER_HEAP_BASE } else { next };
+                start = (base + align - 1) & !(align - 1);
+                start.checked_add(bytes).filter(|&end| end <= USER_HEAP_END)
+            })
+            .map_err(|_| KError::OutOfMemory)?;
+
+        let mut va = start;
+        let mut remaining = pages;
+        while remaining > 0 {
+            let order = next_order(remaining);
+            let block = PAGE_SIZE << order;
+            let mapped = alloc_frames(order, hint).and_then(|paddr| {
+                // Fiziksel bellek kimlik haritalıdır (kbuddy ile aynı varsayım)
+                unsafe { core::ptr::write_bytes(paddr as *mut u8, 0, block as usize) };
+                let flags = KMEM_PAGE_READ | KMEM_PAGE_WRITE | KMEM_PAGE_USER;
+                if unsafe { kmem_virt_map_range(va, paddr, block as usize, flags) } != 0 {
+                    free_frames(paddr, order);
+                    return Err(KError::OutOfMemory);
+                }
+                Ok(())
+            });
+            if let Err(err) = mapped {
+                let _ = release_blocks(start, pages - remaining);
+                return Err(err);
+            }
+            va += block;
+            remaining -= 1 << order;
+        }
+        Ok(start)
+    }
+
+    /// `allocate_user` ile tahsis edilmiş belleği serbest bırakır. `addr` ve `size` çalışan görevin kayıtlı
+    /// bir tahsisiyle tam olarak eşleşmelidir; aksi halde InvalidArgument döner ve hiçbir şey iade edilmez.
+    pub fn release_user(addr: u64, size: usize) -> Result<(), KError> {
+        let pages = page_count(size)?;
+        if addr == 0 || addr % PAGE_SIZE != 0 {
+            return Err(KError::InvalidArgument);
+        }
+        let task = ksched::current_task() as usize;
+        let extents = EXTENTS.get(task).ok_or(KError::InternalError)?;
+        {
+            let mut extents = extents.lock();
+            let slot = extents
+                .iter()
+                .position(|e| e.start == addr && e.pages == pages)
+                .ok_or(KError::InvalidArgument)?;
+            // Kayıt kilit altında silinir: aynı tahsisi iki iş parçacığı birlikte iade edemez
+            extents[slot] = NO_EXTENT;
+        }
+        // TODO: Boşalan sanal aralığın yeniden kullanılması (şimdilik imleç yalnızca ilerler)
+        release_blocks(addr, pages)
+    }
+
+    /// Adres görevlerin heap penceresinde mi (karnal_memory_release'in isteği doğru ayırıcıya yönlendirmesi için)
+    pub fn is_heap_address(addr: u64) -> bool {
+        addr >= USER_HEAP_BASE && addr < USER_HEAP_END
+    }
+
+    /// Görev yuvası boşalırken (son iş parçacığı çıktığında, görevin adres alanında) çağrılır: kalan heap
+    /// tahsislerinin frame'lerini ait oldukları havuzlara iade eder ve imleci sıfırlar.
+    pub fn release_task(task: u32) {
+        let task = task as usize;
+        if task >= ksched::MAX_TASKS {
+            return;
+        }
+        let live = core::mem::replace(&mut *EXTENTS[task].lock(), [NO_EXTENT; MAX_EXTENTS]);
+        for extent in live.iter().filter(|e| e.pages != 0 && e.start != 0) {
+            let _ = release_blocks(extent.start, extent.pages);
+        }
+        HEAP_NEXT[task].store(0, Ordering::Relaxed);
+    }
+
+    // --- C Arayüzü (kernel_memory.h) ---
+
+    #[no_mangle]
+    pub extern "C" fn kmem_phys_add_tier_region(base: u64, size: usize, node: u32, tier: u32) -> i64 {
+        match add_region(base, size as u64, node, tier) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn kmem_phys_set_cpu_node(cpu: u32, node: u32) -> i64 {
+        match set_cpu_node(cpu, node) {
+            Ok(()) => 0,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn kmem_phys_alloc_frames_placed(order: u32, hint: u32) -> u64 {
+        alloc_frames(order, hint).unwrap_or(0)
+    }
+
+    #[no_mangle]
+    pub extern "C" fn kmem_phys_free_frames_placed(addr: u64, order: u32) {
+        if addr != 0 {
+            free_frames(addr, order);
+        }
+    }
+
+    // --- C API (karnal.h) ---
+
+    #[no_mangle]
+    pub extern "C" fn karnal_memory_allocate_placed(size: usize, hint: u32) -> i64 {
+        match allocate_user(size, hint) {
+            Ok(addr) => addr as i64,
+            Err(err) => err as i64,
+        }
+    }
+}
@@ -0,0 +1,188 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, ksched, ktimer};
+
+// --- Paylaşımlı Zaman Sayfası (vDSO benzeri, karnal_kernel_get_time için) ---
+// Önyüklemede bir frame ayrılır ve saat kaynağının kalibrasyonu (karnal.h'deki KarnalTimePage_t) yazılır.
+// Görevler sayfayı karnal_time_page_map ile salt okunur haritalar; karnal_time_page_monotonic_ns /
+// karnal_time_page_realtime_ns donanım sayacını kullanıcı modunda okuyup çekirdeğe girmeden
+// nanosaniyeye çevirir:
+//     ns = mono_base_ns + ((sayaç - counter_base) * mult) >> shift     (128 bit çarpım)
+//
+// Sayfa bir seqlock ile korunur: yazıcı `seq`'i tek yapar, alanları yazar ve `seq`'i yeniden çift yapar.
+// Okuyucu `seq` tekse veya okuma boyunca değiştiyse yeniden dener. Sayfa yalnızca kalibrasyon veya
+// gerçek zaman değiştiğinde yazılır (tik yoktur); 128 bit çarpım sayesinde taban güncellenmeden
+// sayaç istediği kadar ilerleyebilir.
+//
+// Sayaç, kullanıcı modundan okunabilmelidir (amd64 TSC, armv9 CNTVCT_EL0, rv64g `time` CSR). Mimari
+// okunabilir bir sayaç sunmuyorsa clock_source KARNAL_CLOCK_NONE olur ve yardımcılar sistem çağrısına döner.
+
+pub mod ktimepage {
+    use super::*;
+    use core::sync::atomic::{fence, AtomicPtr, AtomicU32, AtomicU64, Ordering};
+    use spin::Mutex;
+
+    // --- ABI Sabitleri (karnal.h ile EŞLEŞMELİDİR) ---
+    pub const CLOCK_NONE: u32 = 0;
+    pub const CLOCK_TSC: u32 = 1;
+    pub const CLOCK_ARM_CNTVCT: u32 = 2;
+    pub const CLOCK_RISCV_TIME: u32 = 3;
+
+    /// KarnalTimePage_t'nin her görevde haritalandığı sabit kullanıcı adresi
+    pub const TIME_PAGE_USER_ADDR: u64 = 0x0000_7EFF_FFFF_F000;
+    // Çekirdeğin sayfaya yazdığı pencere (KERNEL_VIRTUAL_BASE + 0x7F_FFFF_F000, halka pencerelerinin altı)
+    const TIME_PAGE_KERNEL_ADDR: u64 = 0xFFFF_FF7F_FFFF_F000;
+
+    // Sayaç farkı ile çarpılan sabit noktalı katsayının kesir bit sayısı
+    const MULT_SHIFT: u32 = 32;
+
+    // kernel_memory.h'deki KMEM_PAGE_* bayrakları
+    const KMEM_PAGE_READ: u32 = 1 << 0;
+    const KMEM_PAGE_WRITE: u32 = 1 << 1;
+    const KMEM_PAGE_USER: u32 = 1 << 3;
+
+    const PAGE_SIZE: usize = 4096; // KERNEL_PAGE_SIZE
+
+    extern "C" {
+        fn kmem_phys_alloc_frame() -> u64;
+        fn kmem_virt_map_page(vaddr: u64, paddr: u64, flags: u32) -> i64;
+        fn low_level_interrupt_save() -> u64;
+        fn low_level_interrupt_restore(state: u64);
+        fn low_level_clock_source() -> u32;
+        fn low_level_clock_frequency() -> u64;
+        fn low_level_clock_read() -> u64;
+    }
+
+    /// Paylaşımlı zaman sayfası (KarnalTimePage_t). Alanlar yalnızca `publish` tarafından yazılır.
+    #[repr(C)]
+    pub struct KTimePage {
+        pub seq: AtomicU32,
+        pub clock_source: AtomicU32,
+        pub counter_base: AtomicU64,
+        pub mono_base_ns: AtomicU64,
+        pub mult: AtomicU64,
+        pub shift: AtomicU32,
+        pub reserved: AtomicU32,
+        pub realtime_offset_ns: AtomicU64,
+    }
+
+    static PAGE: AtomicPtr<KTimePage> = AtomicPtr::new(core::ptr::null_mut());
+    static FRAME: AtomicU64 = AtomicU64::new(0);
+    // Gerçek zaman = monoton zaman + bu fark. Çekirdek kendi okumalarında sayfaya değil buna bakar.
+    static REALTIME_OFFSET_NS: AtomicU64 = AtomicU64::new(0);
+    // Yazıcıları sıralar; görev başına haritalama bit maskesini de korur
+    static WRITER: Mutex<u64> = Mutex::new(0);
+
+    /// Sayfayı ayırır, çekirdek penceresine haritalar ve ilk kalibrasyonu yayınlar.
+    /// Mimari saat kaynağı (low_level_timer_init) başlatıldıktan sonra bir kez çağrılır.
+    pub fn init_manager() {
+        let frame = unsafe { kmem_phys_alloc_frame() };
+        if frame == 0 {
+            return; // Sayfa yok: karnal_time_page_map NotSupported döner, sistem çağrısı yolu çalışır
+        }
+        if unsafe { kmem_virt_map_page(TIME_PAGE_KERNEL_ADDR, frame, KMEM_PAGE_READ | KMEM_PAGE_WRITE) } != 0 {
+            return;
+        }
+        unsafe { core::ptr::write_bytes(TIME_PAGE_KERNEL_ADDR as *mut u8, 0, PAGE_SIZE) };
+        FRAME.store(frame, Ordering::Relaxed);
+        PAGE.store(TIME_PAGE_KERNEL_ADDR as *mut KTimePage, Ordering::Release);
+        publish();
+    }
+
+    // Seqlock yazma bölümü. WRITER tutulurken çağrılır.
+    fn write_page(page: &KTimePage, update: impl FnOnce(&KTimePage)) {
+        let seq = page.seq.load(Ordering::Relaxed);
+        page.seq.store(seq.wrapping_add(1), Ordering::Relaxed);
+        fence(Ordering::Release); // Tek seq, alan yazımlarından önce görünür
+        update(page);
+        page.seq.store(seq.wrapping_add(2), Ordering::Release);
+    }
+
+    /// Saat kaynağının kalibrasyonunu (yeniden) yayınlar. Mimari kod sayaç frekansını yeniden ölçtüğünde
+    /// (örn. TSC kalibrasyonu) çağırır; taban, yayın anındaki monoton zamana bağlanır.
+    pub fn publish() {
+        let page = PAGE.load(Ordering::Acquire);
+        if page.is_null() {
+            return;
+        }
+        let _writer = WRITER.lock();
+        let source = unsafe { low_level_clock_source() };
+        let frequency = unsafe { low_level_clock_frequency() };
+        // Sayaç ve monoton zaman aynı anda örneklenmeli: arada kesme gelirse taban kayar
+        let irq = unsafe { low_level_interrupt_save() };
+        let counter = unsafe { low_level_clock_read() };
+        let mono = ktimer::now_ns();
+        unsafe { low_level_interrupt_restore(irq) };
+
+        let usable = source != CLOCK_NONE && frequency != 0;
+        let mult = if usable { ((1_000_000_000u128 << MULT_SHIFT) / frequency as u128) as u64 } else { 0 };
+        write_page(unsafe { &*page }, |page| {
+            page.clock_source.store(if usable { source } else { CLOCK_NONE }, Ordering::Relaxed);
+            page.counter_base.store(counter, Ordering::Relaxed);
+            page.mono_base_ns.store(mono, Ordering::Relaxed);
+            page.mult.store(mult, Ordering::Relaxed);
+            page.shift.store(MULT_SHIFT, Ordering::Relaxed);
+            page.realtime_offset_ns.store(REALTIME_OFFSET_NS.load(Ordering::Relaxed), Ordering::Relaxed);
+        });
+    }
+
+    /// Gerçek zamanı (Unix epoch'tan beri ns) ayarlar. RTC sürücüsü veya zaman eşitleme çağırır.
+    pub fn set_realtime(realtime_ns: u64) {
+        let offset = realtime_ns.wrapping_sub(ktimer::now_ns());
+        let _writer = WRITER.lock();
+        REALTIME_OFFSET_NS.store(offset, Ordering::Relaxed);
+        let page = PAGE.load(Ordering::Acquire);
+        if !page.is_null() {
+            write_page(unsafe { &*page }, |page| page.realtime_offset_ns.store(offset, Ordering::Relaxed));
+        }
+    }
+
+    /// Gerçek zaman (Unix epoch'tan beri ns). Ayarlanmadıysa önyüklemeden beri geçen süredir.
+    pub fn realtime_ns() -> u64 {
+        ktimer::now_ns().wrapping_add(REALTIME_OFFSET_NS.load(Ordering::Relaxed))
+    }
+
+    /// Sayfayı çalışan görevin adres alanına salt okunur haritalar ve kullanıcı adresini döner.
+    /// Aynı görevde tekrar çağrılırsa aynı adresi döner.
+    pub fn map_current() -> Result<u64, KError> {
+        let frame = FRAME.load(Ordering::Relaxed);
+        if PAGE.load(Ordering::Acquire).is_null() || frame == 0 {
+            return Err(KError::NotSupported);
+        }
+        let task = ksched::current_task() as usize;
+        let mut mapped = WRITER.lock();
+        if *mapped & (1 << task) != 0 {
+            return Ok(TIME_PAGE_USER_ADDR);
+        }
+        // Yazma izni yok: kullanıcı sayfayı yalnızca okuyabilir
+        if unsafe { kmem_virt_map_page(TIME_PAGE_USER_ADDR, frame, KMEM_PAGE_READ | KMEM_PAGE_USER) } != 0 {
+            return Err(KError::OutOfMemory);
+        }
+        *mapped |= 1 << task;
+        Ok(TIME_PAGE_USER_ADDR)
+    }
+
+    /// Görevin haritalama kaydını siler (görev sonlanırken; adres alanı ile birlikte haritalama da gider).
+    pub fn release_task(task: u32) {
+        if (task as usize) < ksched::MAX_TASKS {
+            *WRITER.lock() &= !(1u64 << task);
+        }
+    }
+
+    // --- C API ---
+
+    #[no_mangle]
+    pub extern "C" fn karnal_time_page_map() -> i64 {
+        match map_current() {
+            Ok(addr) => addr as i64,
+            Err(err) => err as i64,
+        }
+    }
+
+    #[no_mangle]
+    pub extern "C" fn karnal_kernel_get_time() -> i64 {
+        realtime_ns() as i64
+    }
+}
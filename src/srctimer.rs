@@ -0,0 +1,336 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, ksched};
+
+// --- Tiksiz (One-Shot) Zamanlayıcı Çekirdeği ---
+// Periyodik tik yoktur. Her CPU'nun bekleyen son tarihleri (uyku, zaman aşımı) bir min-yığında tutulur ve
+// donanım zamanlayıcısı yalnızca en yakın son tarihe (veya çalışan iş parçacığının zaman dilimi sonuna)
+// programlanır. Boştaki bir CPU, bekleyen bir son tarih yoksa hiç uyandırılmaz.
+//
+// Zaman nanosaniye cinsindendir (low_level_timer_now_ns). Birleştirme (coalescing): her zamanlayıcı bir
+// esneklik (slack) ile kurulur; dolma anı `deadline`'dan sonraki, esneklikten büyük olmayan en büyük ikinin
+// kuvveti sınırına yuvarlanır. Yakın son tarihli zamanlayıcılar böylece aynı ana düşer ve tek kesmede
+// işlenir. Kesmede EXPIRY_MARGIN_NS içinde dolacak olanlar da hemen işlenir (yeniden programlama
+// maliyetinden kısa aralıklar için ayrı kesme alınmaz).
+//
+// Zamanlayıcı kuran CPU'nun kuyruğuna girer ve o CPU'nun kesmesinde dolar. Tek eylem bir bekleyeni
+// (iş parçacığı yuvası + bloklanma sırası) uyandırmaktır; uyku ve zaman aşımlı beklemeler bunu kullanır.
+
+pub mod ktimer {
+    use super::*;
+    use core::sync::atomic::{AtomicU64, Ordering};
+    use spin::Mutex;
+
+    /// CPU başına aynı anda kurulu olabilecek en fazla zamanlayıcı
+    pub const TIMERS_PER_CPU: usize = 256;
+    /// Son tarih yok (donanım zamanlayıcısı kapalı)
+    pub const NO_DEADLINE: u64 = u64::MAX;
+    /// Çağıran esneklik belirtmezse kullanılan üst sınır; kısa sürelerde süre/16 kullanılır
+    pub const DEFAULT_SLACK_NS: u64 = 50_000;
+    // Bu kadar yakında dolacak zamanlayıcılar mevcut kesmede işlenir
+    const EXPIRY_MARGIN_NS: u64 = 2_000;
+    // Tek kesmede uyandırılan en fazla bekleyen; kalanlar hemen ardından gelen kesmede işlenir
+    const EXPIRE_BATCH: usize = 32;
+    const NO_NODE: u16 = u16::MAX;
+
+    extern "C" {
+        fn low_level_cpu_id() -> u32;
+        fn low_level_interrupt_save() -> u64;
+        fn low_level_interrupt_restore(state: u64);
+        fn low_level_timer_now_ns() -> u64;
+        fn low_level_timer_program(deadline_ns: u64);
+    }
+
+    #[derive(Copy, Clone)]
+    struct Node {
+        expiry: u64,
+        slot: u32,
+        seq: u32,
+        generation: u32, // Düğüm her boşaldığında artar; eski TimerId'ler etkisiz kalır
+        heap_pos: u16,   // NO_NODE: yığında değil
+        next_free: u16,
+    }
+
+    const EMPTY_NODE: Node = Node { expiry: 0, slot: 0, seq: 0, generation: 0, heap_pos: NO_NODE, next_free: NO_NODE };
+
+    struct TimerQueue {
+        nodes: [Node; TIMERS_PER_CPU],
+        heap: [u16; TIMERS_PER_CPU], // Dolma anına göre min-yığın (düğüm indeksleri)
+        len: usize,
+        free_head: u16,
+        high: u16,           // Hiç kullanılmamış ilk düğüm
+        programmed: u64,     // Donanıma son yazılan son tarih
+        slice_deadline: u64, // Çalışan iş parçacığının zaman dilimi sonu (ksched)
+    }
+
+    static QUEUES: [Mutex<TimerQueue>; ksched::MAX_CPUS] = {
+        const EMPTY: Mutex<TimerQueue> = Mutex::new(TimerQueue {
+            nodes: [EMPTY_NODE; TIMERS_PER_CPU],
+            heap: [0; TIMERS_PER_CPU],
+            len: 0,
+            free_head: NO_NODE,
+            high: 0,
+            programmed: NO_DEADLINE,
+            slice_deadline: NO_DEADLINE,
+        });
+        [EMPTY; ksched::MAX_CPUS]
+    };
+
+    // İstatistikler: KARNAL_INFO_TIMER_* ile dışarı verilir.
+    static INTERRUPTS: AtomicU64 = AtomicU64::new(0);
+    static EXPIRED: AtomicU64 = AtomicU64::new(0);
+    static COALESCED: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_TIMER_* ile EŞLEŞMELİDİR)
+    pub const INFO_TIMER_INTERRUPTS: u32 = 0x800;
+    pub const INFO_TIMER_EXPIRED: u32 = 0x801;
+    pub const INFO_TIMER_COALESCED: u32 = 0x802;
+
+    /// `kkernel::get_info` için: zamanlayıcı istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_TIMER_INTERRUPTS => Some(INTERRUPTS.load(Ordering::Relaxed)),
+            INFO_TIMER_EXPIRED => Some(EXPIRED.load(Ordering::Relaxed)),
+            INFO_TIMER_COALESCED => Some(COALESCED.load(Ordering::Relaxed)),
+            _ => None,
+        }
+    }
+
+    /// Kurulu bir zamanlayıcı; `cancel` ile iptal edilir.
+    #[derive(Copy, Clone, Debug, PartialEq, Eq)]
+    pub struct TimerId {
+        cpu: u16,
+        index: u16,
+        generation: u32,
+    }
+
+    fn current_cpu() -> usize {
+        (unsafe { low_level_cpu_id() } as usize).min(ksched::MAX_CPUS - 1)
+    }
+
+    /// Önyüklemeden beri geçen monoton süre (ns).
+    pub fn now_ns() -> u64 {
+        unsafe { low_level_timer_now_ns() }
+    }
+
+    /// `duration_ns` süreli bir bekleme için varsayılan esneklik: kısa beklemeler hassas kalır.
+    pub fn default_slack(duration_ns: u64) -> u64 {
+        (duration_ns >> 4).min(DEFAULT_SLACK_NS)
+    }
+
+    // Dolma anını `slack`tan büyük olmayan en büyük ikinin kuvveti sınırına yuvarlar (deadline <= sonuç <= deadline + slack).
+    fn coalesce(deadline: u64, slack: u64) -> u64 {
+        if slack == 0 {
+            return deadline;
+        }
+        let align = 1u64 << (63 - slack.leading_zeros());
+        match deadline.checked_add(align - 1) {
+            Some(rounded) => rounded & !(align - 1),
+            None => deadline,
+        }
+    }
+
+    impl TimerQueue {
+        fn expiry_at(&self, pos: usize) -> u64 {
+            self.nodes[self.heap[pos] as usize].expiry
+        }
+
+        fn place(&mut self, pos: usize, index: u16) {
+            self.heap[pos] = index;
+            self.nodes[index as usize].heap_pos = pos as u16;
+        }
+
+        fn sift_up(&mut self, mut pos: usize) {
+            let index = self.heap[pos];
+            let expiry = self.nodes[index as usize].expiry;
+            while pos > 0 {
+                let parent = (pos - 1) / 2;
+                if self.expiry_at(parent) <= expiry {
+                    break;
+                }
+                let moved = self.heap[parent];
+                self.place(pos, moved);
+                pos = parent;
+            }
+            self.place(pos, index);
+        }
+
+        fn sift_down(&mut self, mut pos: usize) {
+            let index = self.heap[pos];
+            let expiry = self.nodes[index as usize].expiry;
+            loop {
+                let left = 2 * pos + 1;
+                if left >= self.len {
+                    break;
+                }
+                let right = left + 1;
+                let child = if right < self.len && self.expiry_at(right) < self.expiry_at(left) { right } else { left };
+                if self.expiry_at(child) >= expiry {
+                    break;
+                }
+                let moved = self.heap[child];
+                self.place(pos, moved);
+                pos = child;
+            }
+            self.place(pos, index);
+        }
+
+        fn remove_at(&mut self, pos: usize) -> u16 {
+            let index = self.heap[pos];
+            self.len -= 1;
+            if pos != self.len {
+                let last = self.heap[self.len];
+                self.place(pos, last);
+                self.sift_down(pos);
+                self.sift_up(self.nodes[last as usize].heap_pos as usize);
+            }
+            self.nodes[index as usize].heap_pos = NO_NODE;
+            index
+        }
+
+        fn alloc_node(&mut self) -> Option<u16> {
+            if self.free_head != NO_NODE {
+                let index = self.free_head;
+                self.free_head = self.nodes[index as usize].next_free;
+                Some(index)
+            } else if (self.high as usize) < TIMERS_PER_CPU {
+                self.high += 1;
+                Some(self.high - 1)
+            } else {
+                None
+            }
+        }
+
+        fn free_node(&mut self, index: u16) {
+            let node = &mut self.nodes[index as usize];
+            node.generation = node.generation.wrapping_add(1);
+            node.next_free = self.free_head;
+            self.free_head = index;
+        }
+
+        fn next_event(&self) -> u64 {
+            let first = if self.len == 0 { NO_DEADLINE } else { self.expiry_at(0) };
+            first.min(self.slice_deadline)
+        }
+
+        // Donanımı yalnızca daha erken bir olay gerektiğinde yeniden programlar. Ertelenen/iptal edilen
+        // olaylar için erken gelen kesme zararsızdır; kesme işleyicisi bir sonrakini programlar.
+        fn program_if_earlier(&mut self) {
+            let next = self.next_event();
+            if next < self.programmed {
+                self.programmed = next;
+                unsafe { low_level_timer_program(next) };
+            }
+        }
+    }
+
+    /// `deadline_ns` anında (en geç `deadline_ns + slack_ns`) `slot` yuvasındaki iş parçacığını, hâlâ
+    /// `seq` bloklanmasındaysa uyandıran bir zamanlayıcı kurar. Çağıranın CPU'sunda kurulur.
+    /// CPU'nun zamanlayıcı tablosu doluysa Busy döner.
+    pub fn arm_wakeup(deadline_ns: u64, slack_ns: u64, slot: u32, seq: u32) -> Result<TimerId, KError> {
+        let irq = unsafe { low_level_interrupt_save() };
+        let cpu = current_cpu();
+        let result = {
+            let mut queue = QUEUES[cpu].lock();
+            match queue.alloc_node() {
+                Some(index) => {
+                    let expiry = coalesce(deadline_ns, slack_ns);
+                    let generation = {
+                        let node = &mut queue.nodes[index as usize];
+                        node.expiry = expiry;
+                        node.slot = slot;
+                        node.seq = seq;
+                        node.generation
+                    };
+                    let pos = queue.len;
+                    queue.len += 1;
+                    queue.place(pos, index);
+                    queue.sift_up(pos);
+                    queue.program_if_earlier();
+                    Ok(TimerId { cpu: cpu as u16, index, generation })
+                }
+                None => Err(KError::Busy),
+            }
+        };
+        unsafe { low_level_interrupt_restore(irq) };
+        result
+    }
+
+    /// Zamanlayıcıyı iptal eder. Henüz dolmadıysa true döner; dolmuş veya iptal edilmişse etkisizdir.
+    pub fn cancel(id: TimerId) -> bool {
+        let irq = unsafe { low_level_interrupt_save() };
+        let pending = {
+            let mut queue = QUEUES[id.cpu as usize].lock();
+            let node = queue.nodes[id.index as usize];
+            if node.generation == id.generation && node.heap_pos != NO_NODE {
+                queue.remove_at(node.heap_pos as usize);
+                queue.free_node(id.index);
+                true
+            } else {
+                false
+            }
+        };
+        unsafe { low_level_interrupt_restore(irq) };
+        pending
+    }
+
+    /// Çağıran CPU'da çalışan iş parçacığının zaman dilimi sonunu ayarlar (NO_DEADLINE: zaman dilimi yok).
+    /// ksched bağlam değiştirirken kesmeler kapalıyken çağırır.
+    pub fn set_slice_deadline(deadline_ns: u64) {
+        let mut queue = QUEUES[current_cpu()].lock();
+        queue.slice_deadline = deadline_ns;
+        queue.program_if_earlier();
+    }
+
+    // --- Mimari/Platform Kancaları (hardware_specific.h) ---
+
+    /// CPU'nun one-shot zamanlayıcı kesmesi. Mimari kod kesme bağlamında çağırır; donanım kesmesini
+    /// kendisi onaylar, yeniden programlamayı bu fonksiyon low_level_timer_program ile yapar.
+    #[no_mangle]
+    pub extern "C" fn ktimer_interrupt() {
+        INTERRUPTS.fetch_add(1, Ordering::Relaxed);
+        let cpu = current_cpu();
+        let now = now_ns();
+        let limit = now.saturating_add(EXPIRY_MARGIN_NS);
+        let mut expired = [(0u32, 0u32); EXPIRE_BATCH];
+        let mut count = 0;
+        let mut slice_expired = false;
+        {
+            let mut queue = QUEUES[cpu].lock();
+            queue.programmed = NO_DEADLINE; // Donanım tetiklendi; one-shot artık kurulu değil
+            while queue.len != 0 && queue.expiry_at(0) <= limit && count < EXPIRE_BATCH {
+                let index = queue.remove_at(0);
+                let node = queue.nodes[index as usize];
+                expired[count] = (node.slot, node.seq);
+                count += 1;
+                queue.free_node(index);
+            }
+            if queue.slice_deadline <= limit {
+                queue.slice_deadline = NO_DEADLINE;
+                slice_expired = true;
+            }
+            queue.program_if_earlier();
+        }
+        // Uyandırma çalışma kuyruğu kilidini alır; zamanlayıcı kilidi bırakıldıktan sonra yapılır.
+        for &(slot, seq) in &expired[..count] {
+            ksched::wake_waiter(slot, seq);
+        }
+        if count != 0 {
+            EXPIRED.fetch_add(count as u64, Ordering::Relaxed);
+            COALESCED.fetch_add(count as u64 - 1, Ordering::Relaxed);
+        }
+        if slice_expired {
+            ksched::slice_expired();
+        }
+    }
+
+    // --- C API ---
+
+    /// Önyüklemeden beri geçen monoton süre (ns).
+    #[no_mangle]
+    pub extern "C" fn karnal_timer_now_ns() -> u64 {
+        now_ns()
+    }
+}
@@ -0,0 +1,313 @@
+#![no_std]
+#![allow(dead_code)]
+
+// --- Toplu TLB Geçersiz Kılma ve Ertelenmiş CPU'lar Arası Temizleme (Shootdown) ---
+// Sayfa tablosu değişiklikleri tek tek TLB temizliği yapmak yerine bir TlbBatch içinde toplanır.
+// İşlem sonunda (flush) tek bir toplu temizlik yapılır:
+// - TLB_BATCH_MAX sayfaya kadar: her adres için tek sayfa geçersiz kılma (invlpg / tlbi / sfence.vma)
+// - Daha fazlası veya adres alanının tamamı: tek bir tam TLB temizliği
+// Diğer CPU'lara giden istekler de aynı şekilde birleştirilir: hedef CPU'nun posta kutusunda
+// bekleyen bir istek varsa yeni adresler ona eklenir ve ikinci bir IPI gönderilmez.
+//
+// Etiketli TLB'lerde (PCID/ASID, bkz. srcasid.rs) her küme tek bir adres alanının ASID'ine aittir;
+// hedef CPU o adres alanını şu an çalıştırmasa bile girdileri o ASID ile temizlenir.
+// ASID 0 etiketsiz/çekirdek eşlemeleri demektir ve tüm adres alanlarında temizlenir.
+//
+// Önemli: Haritası kaldırılan fiziksel frame'ler ancak flush() döndükten sonra iade edilmelidir;
+// aksi halde başka bir CPU eski TLB girdisi üzerinden yeniden kullanılan frame'e erişebilir.
+
+pub mod ktlb {
+    use core::sync::atomic::{AtomicU64, Ordering};
+    use spin::Mutex;
+
+    /// Bir toplu işlemde tek tek geçersiz kılınacak en fazla sayfa. Fazlası tam temizliğe dönüşür.
+    pub const TLB_BATCH_MAX: usize = 32;
+    /// Shootdown hedeflenebilecek en fazla CPU sayısı (CPU maskesi bit genişliği)
+    pub const MAX_CPUS: usize = 32;
+
+    extern "C" {
+        fn low_level_cpu_id() -> u32;
+        fn low_level_tlb_flush_page(vaddr: u64, asid: u16);
+        fn low_level_tlb_flush_asid(asid: u16);
+        fn low_level_tlb_flush_all();
+        fn low_level_send_tlb_shootdown_ipi(cpu: u32);
+    }
+
+    // Açık olan CPU'ların maskesi. Önyükleme CPU'su (0) baştan açıktır.
+    static ONLINE_CPUS: AtomicU64 = AtomicU64::new(1);
+
+    /// SMP başlatma kodu, bir CPU TLB shootdown IPI'larını almaya hazır olduğunda (IPI vektörü
+    /// low_level_ipi_init ile kurulduktan sonra) o CPU'da çağırır.
+    pub fn set_cpu_online(cpu: u32) {
+        if (cpu as usize) < MAX_CPUS {
+            ONLINE_CPUS.fetch_or(1 << cpu, Ordering::Release);
+            // Bit görünür olmadan yapılan değişiklikler bu CPU'ya IPI göndermedi: yerel TLB'yi bir kez
+            // tamamen temizle. Bundan sonraki değişiklikler posta kutusu üzerinden gelir.
+            unsafe { low_level_tlb_flush_all() };
+        }
+    }
+
+    /// Bu CPU'ya kuyruklanmış shootdown isteklerini hemen uygular. Kesmeler kapalıyken uzun süre
+    /// dönen kod (ör. önyükleme grafiğinde adım bekleyen CPU) IPI'ı alamayacağı için bunu çağırır.
+    pub fn service_pending() {
+        let cpu = current_cpu();
+        if cpu < MAX_CPUS {
+            service_mailbox(&MAILBOXES[cpu]);
+        }
+    }
+
+    /// Açık CPU'ların maskesi (bit n = CPU n).
+    pub fn online_cpus() -> u64 {
+        ONLINE_CPUS.load(Ordering::Acquire)
+    }
+
+    // Geçersiz kılınacak adres kümesi. Taşarsa tam temizliğe düşer.
+    #[derive(Clone, Copy)]
+    struct FlushSet {
+        addrs: [u64; TLB_BATCH_MAX],
+        count: usize,
+        full: bool,      // `asid`'in tüm girdileri
+        all_asids: bool, // Tüm adres alanlarının girdileri (farklı ASID'ler birleşince)
+        asid: u16,
+    }
+
+    impl FlushSet {
+        const EMPTY: FlushSet = FlushSet { addrs: [0; TLB_BATCH_MAX], count: 0, full: false, all_asids: false, asid: 0 };
+
+        fn is_empty(&self) -> bool {
+            self.count == 0 && !self.full
+        }
+
+        fn add(&mut self, vaddr: u64) {
+            if self.full {
+                return;
+            }
+            if self.count == TLB_BATCH_MAX {
+                self.full = true;
+                self.count = 0;
+                return;
+            }
+            self.addrs[self.count] = vaddr;
+            self.count += 1;
+        }
+
+        fn merge(&mut self, other: &FlushSet) {
+            if self.is_empty() {
+                *self = *other;
+                return;
+            }
+            if other.asid != self.asid || other.all_asids {
+                // Farklı adres alanları tek kümede ifade edilemez: hepsini temizle.
+                self.all_asids = true;
+                self.full = true;
+                self.count = 0;
+                return;
+            }
+            if other.full {
+                self.full = true;
+                self.count = 0;
+                return;
+            }
+            for &vaddr in &other.addrs[..other.count] {
+                self.add(vaddr);
+            }
+        }
+
+        // Kümeyi mevcut CPU'nun TLB'sine uygular.
+        fn apply_local(&self) {
+            unsafe {
+                if self.all_asids {
+                    low_level_tlb_flush_all();
+                } else if self.full {
+                    low_level_tlb_flush_asid(self.asid);
+                } else {
+                    for &vaddr in &self.addrs[..self.count] {
+                        low_level_tlb_flush_page(vaddr, self.asid);
+                    }
+                }
+            }
+        }
+    }
+
+    // CPU başına shootdown posta kutusu.
+    // `requested`: bu CPU'ya kuyruklanmış son isteğin sıra numarası
+    // `completed`: bu CPU'nun uyguladığı son isteğin sıra numarası
+    #[repr(C, align(64))]
+    struct Mailbox {
+        pending: Mutex<FlushSet>,
+        requested: AtomicU64,
+        completed: AtomicU64,
+    }
+
+    impl Mailbox {
+        const INIT: Mailbox = Mailbox {
+            pending: Mutex::new(FlushSet::EMPTY),
+            requested: AtomicU64::new(0),
+            completed: AtomicU64::new(0),
+        };
+    }
+
+    static MAILBOXES: [Mailbox; MAX_CPUS] = [Mailbox::INIT; MAX_CPUS];
+
+    // İstatistikler: KARNAL_INFO_TLB_* ile dışarı verilir.
+    static PAGE_FLUSHES: AtomicU64 = AtomicU64::new(0);
+    static FULL_FLUSHES: AtomicU64 = AtomicU64::new(0);
+    static SHOOTDOWN_IPIS: AtomicU64 = AtomicU64::new(0);
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_TLB_* ile EŞLEŞMELİDİR)
+    pub const INFO_TLB_PAGE_FLUSHES: u32 = 0x200;
+    pub const INFO_TLB_FULL_FLUSHES: u32 = 0x201;
+    pub const INFO_TLB_SHOOTDOWN_IPIS: u32 = 0x202;
+
+    /// `kkernel::get_info` için: TLB istatistiği ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_TLB_PAGE_FLUSHES => Some(PAGE_FLUSHES.load(Ordering::Relaxed)),
+            INFO_TLB_FULL_FLUSHES => Some(FULL_FLUSHES.load(Ordering::Relaxed)),
+            INFO_TLB_SHOOTDOWN_IPIS => Some(SHOOTDOWN_IPIS.load(Ordering::Relaxed)),
+            _ => None,
+        }
+    }
+
+    fn current_cpu() -> usize {
+        (unsafe { low_level_cpu_id() }) as usize
+    }
+
+    /// TLB shootdown IPI işleyicisi. Mimari kesme kodu IPI geldiğinde bunu çağırır.
+    /// Bekleyen tüm istekleri tek seferde uygular (birleştirilmiş istekler dahil).
+    #[no_mangle]
+    pub extern "C" fn ktlb_handle_shootdown_ipi() {
+        let cpu = current_cpu();
+        if cpu >= MAX_CPUS {
+            return;
+        }
+        service_mailbox(&MAILBOXES[cpu]);
+    }
+
+    fn service_mailbox(mailbox: &Mailbox) {
+        let (set, seq) = {
+            let mut pending = mailbox.pending.lock();
+            if pending.is_empty() {
+                return;
+            }
+            let set = *pending;
+            *pending = FlushSet::EMPTY;
+            // Aynı kilit altında okunur: bu sıraya kadarki tüm istekler `set` içindedir.
+            (set, mailbox.requested.load(Ordering::Relaxed))
+        };
+        set.apply_local();
+        // IPI, servis döngüsünün ortasında gelip daha yeni bir sırayı yazmış olabilir; geri gitme.
+        mailbox.completed.fetch_max(seq, Ordering::Release);
+    }
+
+    /// Ertelenmiş TLB geçersiz kılma kümesi.
+    /// Sayfa tablosu girdilerini değiştiren kod her değişen yaprak için `add_page` çağırır,
+    /// işlem sonunda bir kez `flush` yapar. Drop edilirse bekleyen temizlik yine yapılır.
+    pub struct TlbBatch {
+        set: FlushSet,
+        targets: u64, // Adres alanının etkin olabileceği CPU'lar
+    }
+
+    impl TlbBatch {
+        /// `targets`: değişen adres alanını TLB'sinde tutuyor olabilecek CPU'ların maskesi.
+        pub const fn new(targets: u64) -> Self {
+            TlbBatch { set: FlushSet::EMPTY, targets }
+        }
+
+        /// Tüm açık CPU'ları hedefleyen bir küme (çekirdek eşlemeleri veya CPU takibi olmayan adres alanları).
+        pub fn all_cpus() -> Self {
+            Self::new(online_cpus())
+        }
+
+        /// `asid` etiketli bir adres alanı için küme. Hedef CPU'lar o adres alanını çalıştırmıyor olsa da
+        /// TLB'lerinde kalmış girdiler bu ASID ile temizlenir.
+        pub fn for_asid(targets: u64, asid: u16) -> Self {
+            let mut batch = Self::new(targets);
+            batch.set.asid = asid;
+            batch
+        }
+
+        /// Bir yaprak girdinin (4KB sayfa veya büyük sayfa) geçersiz kılınmasını kuyruklar.
+        /// Büyük sayfalar için başlangıç adresi yeterlidir; tek girdiyle tamamı temizlenir.
+        pub fn add_page(&mut self, vaddr: u64) {
+            self.set.add(vaddr);
+        }
+
+        /// Adres alanının tamamının temizlenmesini ister (ör. adres alanı yıkımı).
+        pub fn add_all(&mut self) {
+            self.set.full = true;
+            self.set.count = 0;
+        }
+
+        pub fn is_empty(&self) -> bool {
+            self.set.is_empty()
+        }
+
+        /// Kuyruklanmış geçersiz kılmaları uygular: yerel CPU'da hemen, diğer hedef CPU'larda
+        /// birleştirilmiş IPI ile. Tüm hedef CPU'lar temizliği bitirene kadar döner.
+        pub fn flush(&mut self) {
+            if self.set.is_empty() {
+                return;
+            }
+            let set = self.set;
+            self.set = FlushSet { asid: set.asid, ..FlushSet::EMPTY };
+
+            if set.full {
+                FULL_FLUSHES.fetch_add(1, Ordering::Relaxed);
+            } else {
+                PAGE_FLUSHES.fetch_add(set.count as u64, Ordering::Relaxed);
+            }
+
+            let this_cpu = current_cpu();
+            if self.targets & (1 << this_cpu.min(63)) != 0 || this_cpu >= MAX_CPUS {
+                set.apply_local();
+            }
+
+            let remote = self.targets & online_cpus() & !(1u64 << this_cpu.min(63));
+            if remote == 0 {
+                return;
+            }
+
+            // 1. Tüm hedeflere isteği bırak; boş posta kutusu olanlara IPI gönder
+            let mut waits = [0u64; MAX_CPUS];
+            for cpu in 0..MAX_CPUS {
+                if remote & (1 << cpu) == 0 {
+                    continue;
+                }
+                let mailbox = &MAILBOXES[cpu];
+                let needs_ipi = {
+                    let mut pending = mailbox.pending.lock();
+                    let was_empty = pending.is_empty();
+                    pending.merge(&set);
+                    waits[cpu] = mailbox.requested.fetch_add(1, Ordering::Relaxed) + 1;
+                    was_empty
+                };
+                // Posta kutusu zaten doluysa IPI yolda: hedef aynı kilit altında bizim adreslerimizi de alacak.
+                if needs_ipi {
+                    SHOOTDOWN_IPIS.fetch_add(1, Ordering::Relaxed);
+                    unsafe { low_level_send_tlb_shootdown_ipi(cpu as u32) };
+                }
+            }
+
+            // 2. Tamamlanmayı bekle. Beklerken kendi posta kutumuza gelen istekleri de işle;
+            // iki CPU aynı anda birbirini hedeflerse kilitlenme olmaz.
+            for cpu in 0..MAX_CPUS {
+                if remote & (1 << cpu) == 0 {
+                    continue;
+                }
+                while MAILBOXES[cpu].completed.load(Ordering::Acquire) < waits[cpu] {
+                    if this_cpu < MAX_CPUS {
+                        service_mailbox(&MAILBOXES[this_cpu]);
+                    }
+                    core::hint::spin_loop();
+                }
+            }
+        }
+    }
+
+    impl Drop for TlbBatch {
+        fn drop(&mut self) {
+            self.flush();
+        }
+    }
+}
@@ -0,0 +1,276 @@
+#![no_std]
+#![allow(dead_code)]
+
+// Karnal64 üst modülünden gerekli tipler
+use super::{KError, ResourceProvider, kboot, kregistry, ksched, ktimer};
+
+// --- Çekirdek İzleme Halkası ve Sistem Çağrısı Gecikme Histogramları (karnal://trace) ---
+// Her CPU'nun ikili bir izleme halkası vardır. Olaylar (sistem çağrısı giriş/çıkış, bağlam değiştirme,
+// sayfa hatası, kesme giriş/çıkış) o CPU'nun halkasına kesmeler kapalıyken, kilitsiz yazılır. Halka
+// doluysa en eski kayıt ezilir (uçuş kaydedici); okuyucu ezilen kayıtları atlar ve sayar.
+//
+// Derleme anında seçilir: `ktrace` özelliği olmadan derlenen çekirdekte izleme noktaları sabit `false`
+// denetimine iner ve halkalar/histogramlar yer kaplamaz. Özellikle derlenen çekirdekte olay türleri
+// çalışma anında karnal://trace üzerinden (KARNAL_TRACE_CTL_SET_MASK) açılıp kapatılır; kapalı bir
+// olayın maliyeti tek bir atomik okumadır.
+//
+// Sistem çağrısı gecikmeleri çağrı numarası başına log2 histogramlarda tutulur (kova b: [2^b, 2^(b+1)) ns)
+// ve karnal_kernel_get_info(KARNAL_INFO_TRACE_SYSCALL_HIST(numara, kova)) ile okunur.
+//
+// Bir kaydın yazılması yarıda kesilemez (kesmeler kapalı), ama okuyucu başka CPU'dadır: her yuvanın
+// `seq` alanı kayıt tamamlandıktan sonra yazılır; okuyucu kopyadan önce ve sonra aynı `seq`'i görmezse
+// kaydı yırtık sayıp atar.
+
+pub mod ktrace {
+    use super::*;
+    use alloc::sync::Arc;
+    use core::cell::UnsafeCell;
+    use core::sync::atomic::{AtomicU64, Ordering};
+    use spin::Mutex;
+
+    /// İzleme noktaları bu çekirdekte derlendi mi
+    pub const COMPILED: bool = cfg!(feature = "ktrace");
+
+    // Olay türleri (karnal.h'deki KARNAL_TRACE_* ile EŞLEŞMELİDİR)
+    pub const EV_SYSCALL_ENTER: u16 = 1; // arg0: çağrı numarası, arg1: ilk argüman
+    pub const EV_SYSCALL_EXIT: u16 = 2;  // arg0: çağrı numarası, arg1: sonuç
+    pub const EV_SWITCH: u16 = 3;        // arg0: önceki iş parçacığı yuvası, arg1: sonraki
+    pub const EV_PAGE_FAULT: u16 = 4;    // arg0: hata adresi, arg1: mimariye özel hata kodu
+    pub const EV_IRQ_ENTER: u16 = 5;     // arg0: kesme numarası
+    pub const EV_IRQ_EXIT: u16 = 6;      // arg0: kesme numarası
+
+    /// Olay maskesinde histogram biti (olay türleri 1 << tür bitlerini kullanır)
+    pub const MASK_HISTOGRAM: u64 = 1 << 0;
+    pub const MASK_ALL: u64 = MASK_HISTOGRAM | 0x7E;
+
+    // karnal://trace kontrol komutları (karnal.h'deki KARNAL_TRACE_CTL_* ile EŞLEŞMELİDİR)
+    pub const CTL_SET_MASK: u64 = 1;
+    pub const CTL_GET_MASK: u64 = 2;
+    pub const CTL_RESET_HISTOGRAMS: u64 = 3;
+
+    /// Histogram tutulan sistem çağrısı numarası sınırı
+    pub const MAX_TRACED_SYSCALLS: usize = 128;
+    pub const HIST_BUCKETS: usize = 64;
+
+    // karnal_kernel_get_info bilgi türleri (karnal.h'deki KARNAL_INFO_TRACE_* ile EŞLEŞMELİDİR)
+    pub const INFO_TRACE_RECORDS: u32 = 0xB00;
+    pub const INFO_TRACE_LOST: u32 = 0xB01;
+    // 0x10000 | (numara << 6) | kova
+    pub const INFO_TRACE_SYSCALL_HIST_BASE: u32 = 0x1_0000;
+
+    const RING_ENTRIES: usize = if COMPILED { 1024 } else { 1 }; // İkinin kuvveti
+    const HIST_SLOTS: usize = if COMPILED { MAX_TRACED_SYSCALLS * HIST_BUCKETS } else { 1 };
+
+    const NO_THREAD: u32 = u32::MAX;
+
+    extern "C" {
+        fn low_level_interrupt_save() -> u64;
+        fn low_level_interrupt_restore(state: u64);
+        fn low_level_cpu_id() -> u32;
+    }
+
+    /// karnal://trace'ten okunan kayıt (KarnalTraceRecord_t)
+    #[repr(C)]
+    #[derive(Clone, Copy)]
+    pub struct TraceRecord {
+        pub timestamp_ns: u64,
+        pub kind: u16,
+        pub cpu: u16,
+        pub thread: u32,
+        pub arg0: u64,
+        pub arg1: u64,
+    }
+
+    const RECORD_SIZE: usize = core::mem::size_of::<TraceRecord>();
+
+    struct Slot {
+        seq: AtomicU64, // Kaydın konumu + 1; 0: boş
+        record: UnsafeCell<TraceRecord>,
+    }
+
+    struct Ring {
+        head: AtomicU64, // Yalnızca sahibi CPU yazar
+        slots: [Slot; RING_ENTRIES],
+    }
+
+    // Kayıt alanlarına yalnızca yukarıdaki `seq` protokolüyle erişilir
+    unsafe impl Sync for Ring {}
+
+    impl Ring {
+        const INIT: Ring = {
+            const SLOT: Slot = Slot {
+                seq: AtomicU64::new(0),
+                record: UnsafeCell::new(TraceRecord { timestamp_ns: 0, kind: 0, cpu: 0, thread: 0, arg0: 0, arg1: 0 }),
+            };
+            Ring { head: AtomicU64::new(0), slots: [SLOT; RING_ENTRIES] }
+        };
+    }
+
+    static RINGS: [Ring; ksched::MAX_CPUS] = [Ring::INIT; ksched::MAX_CPUS];
+    static MASK: AtomicU64 = AtomicU64::new(MASK_HISTOGRAM);
+    static HISTOGRAMS: [AtomicU64; HIST_SLOTS] = {
+        const ZERO: AtomicU64 = AtomicU64::new(0);
+        [ZERO; HIST_SLOTS]
+    };
+    // Okuyucunun CPU başına konumu. Okuyucular bu kilitle sıralanır (yazıcılar almaz).
+    static READER: Mutex<[u64; ksched::MAX_CPUS]> = Mutex::new([0; ksched::MAX_CPUS]);
+
+    // İstatistikler: KARNAL_INFO_TRACE_* ile dışarı verilir.
+    static RECORDS: AtomicU64 = AtomicU64::new(0);
+    static LOST: AtomicU64 = AtomicU64::new(0);
+
+    /// `kkernel::get_info` için: izleme istatistiği veya histogram kovası ise değeri döner, değilse None.
+    pub fn get_info(info_type: u32) -> Option<u64> {
+        match info_type {
+            INFO_TRACE_RECORDS => Some(RECORDS.load(Ordering::Relaxed)),
+            INFO_TRACE_LOST => Some(LOST.load(Ordering::Relaxed)),
+            _ if info_type >= INFO_TRACE_SYSCALL_HIST_BASE
+                && ((info_type - INFO_TRACE_SYSCALL_HIST_BASE) as usize) < MAX_TRACED_SYSCALLS * HIST_BUCKETS =>
+            {
+                let index = (info_type - INFO_TRACE_SYSCALL_HIST_BASE) as usize;
+                Some(HISTOGRAMS.get(index).map_or(0, |bucket| bucket.load(Ordering::Relaxed)))
+            }
+            _ => None,
+        }
+    }
+
+    /// karnal://trace kaynağını kaydeder. Kayıt yöneticisi hazır olduktan sonra bir kez çağrılır.
+    // Kaynak açılışta gerekmez: ilk karnal://trace edinmesinde kaydedilir
+    pub fn init_manager() {
+        if COMPILED {
+            let _ = kboot::register_lazy(b"karnal://trace", register_provider);
+        }
+    }
+
+    fn register_provider() -> Result<(), KError> {
+        kregistry::register(b"karnal://trace", Arc::new(TraceProvider)).map(|_| ())
+    }
+
+    #[inline(always)]
+    fn enabled(bit: u64) -> bool {
+        COMPILED && MASK.load(Ordering::Relaxed) & bit != 0
+    }
+
+    /// Olay türü `kind` açıksa çalışan CPU'nun halkasına bir kayıt ekler. Kesme bağlamından çağrılabilir.
+    /// Maskede biti olmayan türler (0: histogram biti, 64 ve üstü) yok sayılır.
+    #[inline(always)]
+    pub fn record(kind: u16, arg0: u64, arg1: u64) {
+        if kind != 0 && kind < 64 && enabled(1 << kind) {
+            record_slow(kind, arg0, arg1);
+        }
+    }
+
+    #[inline(never)]
+    fn record_slow(kind: u16, arg0: u64, arg1: u64) {
+        let irq = unsafe { low_level_interrupt_save() };
+        let cpu = (unsafe { low_level_cpu_id() } as usize).min(ksched::MAX_CPUS - 1);
+        let ring = &RINGS[cpu];
+        let pos = ring.head.load(Ordering::Relaxed);
+        let slot = &ring.slots[pos as usize & (RING_ENTRIES - 1)];
+        // Okuyucu yuvayı yazım boyunca geçersiz görür
+        slot.seq.store(0, Ordering::Relaxed);
+        core::sync::atomic::fence(Ordering::Release);
+        unsafe {
+            *slot.record.get() = TraceRecord {
+                timestamp_ns: ktimer::now_ns(),
+                kind,
+                cpu: cpu as u16,
+                thread: ksched::current_slot().unwrap_or(NO_THREAD),
+                arg0,
+                arg1,
+            };
+        }
+        slot.seq.store(pos + 1, Ordering::Release);
+        ring.head.store(pos + 1, Ordering::Release);
+        RECORDS.fetch_add(1, Ordering::Relaxed);
+        unsafe { low_level_interrupt_restore(irq) };
+    }
+
+    /// Sistem çağrısı girişi. Dönen değer `syscall_exit`'e verilir (histogram kapalıysa 0).
+    #[inline(always)]
+    pub fn syscall_enter(number: u64, arg1: u64) -> u64 {
+        record(EV_SYSCALL_ENTER, number, arg1);
+        if enabled(MASK_HISTOGRAM) { ktimer::now_ns() } else { 0 }
+    }
+
+    /// Sistem çağrısı çıkışı: kaydı ekler ve gecikmeyi çağrının histogramına işler.
+    #[inline(always)]
+    pub fn syscall_exit(start_ns: u64, number: u64, result: i64) {
+        record(EV_SYSCALL_EXIT, number, result as u64);
+        if start_ns != 0 && (number as usize) < MAX_TRACED_SYSCALLS {
+            let elapsed = ktimer::now_ns().saturating_sub(start_ns);
+            let bucket = (63 - elapsed.max(1).leading_zeros()) as usize;
+            HISTOGRAMS[number as usize * HIST_BUCKETS + bucket].fetch_add(1, Ordering::Relaxed);
+        }
+    }
+
+    // Halkalardan `buffer`'a sığdığı kadar bütün kayıt kopyalar. Ezilen ve yırtık kayıtlar atlanır.
+    fn read_records(buffer: &mut [u8]) -> usize {
+        let capacity = buffer.len() / RECORD_SIZE;
+        let mut copied = 0;
+        let mut reader = READER.lock();
+        for (cpu, ring) in RINGS.iter().enumerate() {
+            let head = ring.head.load(Ordering::Acquire);
+            let mut pos = reader[cpu];
+            if head - pos > RING_ENTRIES as u64 {
+                LOST.fetch_add(head - pos - RING_ENTRIES as u64, Ordering::Relaxed);
+                pos = head - RING_ENTRIES as u64;
+            }
+            while pos != head && copied < capacity {
+                let slot = &ring.slots[pos as usize & (RING_ENTRIES - 1)];
+                let before = slot.seq.load(Ordering::Acquire);
+                let record = unsafe { core::ptr::read_volatile(slot.record.get()) };
+                core::sync::atomic::fence(Ordering::Acquire);
+                if before == pos + 1 && slot.seq.load(Ordering::Relaxed) == before {
+                    unsafe {
+                        core::ptr::write_unaligned(buffer.as_mut_ptr().add(copied * RECORD_SIZE) as *mut TraceRecord, record);
+                    }
+                    copied += 1;
+                } else {
+                    LOST.fetch_add(1, Ordering::Relaxed); // Okurken ezildi
+                }
+                pos += 1;
+            }
+            reader[cpu] = pos;
+        }
+        copied * RECORD_SIZE
+    }
+
+    // karnal://trace: okuma bekleyen kayıtları tüketir (ofset yok sayılır), kontrol olay maskesini yönetir.
+    struct TraceProvider;
+
+    impl ResourceProvider for TraceProvider {
+        fn read(&self, buffer: &mut [u8], _offset: u64) -> Result<usize, KError> {
+            if buffer.len() < RECORD_SIZE {
+                return Err(KError::InvalidArgument);
+            }
+            Ok(read_records(buffer))
+        }
+
+        fn write(&self, _buffer: &[u8], _offset: u64) -> Result<usize, KError> {
+            Err(KError::PermissionDenied)
+        }
+
+        fn control(&self, request: u64, arg: u64) -> Result<i64, KError> {
+            match request {
+                CTL_SET_MASK => Ok(MASK.swap(arg & MASK_ALL, Ordering::Relaxed) as i64),
+                CTL_GET_MASK => Ok(MASK.load(Ordering::Relaxed) as i64),
+                CTL_RESET_HISTOGRAMS => {
+                    for bucket in HISTOGRAMS.iter() {
+                        bucket.store(0, Ordering::Relaxed);
+                    }
+                    Ok(0)
+                }
+                _ => Err(KError::NotSupported),
+            }
+        }
+    }
+
+    // --- C API ---
+
+    /// Mimari kodun (sayfa hatası işleyicileri vb.) olay eklemesi için.
+    #[no_mangle]
+    pub extern "C" fn karnal_trace_event(kind: u16, arg0: u64, arg1: u64) {
+        record(kind, arg0, arg1);
+    }
+}